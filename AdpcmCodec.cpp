@@ -0,0 +1,1022 @@
+#include "AdpcmCodec.h"
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ADPCM_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// As in MixKernels.cpp: AVX2 code is compiled whatever the build target and only used once
+// isMixKernelAvailable() has checked the CPU
+#if defined(ADPCM_HAS_SSE2) && defined(_MSC_VER) && _MSC_VER >= 1800
+#define ADPCM_HAS_AVX2 1
+#define ADPCM_TARGET_AVX2
+#include <immintrin.h>
+#elif defined(ADPCM_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ADPCM_HAS_AVX2 1
+#define ADPCM_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+// IMA step sizes, indexed by the step index
+static const INT32 imaSteps[ADPCM_IMA_MAX_INDEX + 1] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+	107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+	876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+	4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+	22385, 24623, 27086, 29794, 32767 };
+
+// how the step index moves for each code, the sign bit doesn't matter
+static const INT32 imaIndexAdjust[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// MS ADPCM delta adaptation, indexed by the unsigned code
+static const INT32 msAdapt[16] = { 230, 230, 230, 230, 307, 409, 512, 614, 768, 614, 512, 409, 307, 230, 230, 230 };
+
+// the seven predictors every MS ADPCM file carries
+static const INT16 msCoef1[7] = { 256, 512, 0, 192, 240, 460, 392 };
+static const INT16 msCoef2[7] = { 0, -256, 0, 64, 0, -208, -232 };
+
+static inline INT16 readS16(const BYTE* p)
+{
+	return (INT16)(p[0] | (p[1] << 8));
+}
+
+static inline void writeS16(BYTE* p, INT32 v)
+{
+	p[0] = (BYTE)v;
+	p[1] = (BYTE)(v >> 8);
+}
+
+static inline INT32 clamp16(INT32 v)
+{
+	return (v > 32767) ? 32767 : ((v < -32768) ? -32768 : v);
+}
+
+static inline INT32 clampIndex(INT32 index)
+{
+	return (index < 0) ? 0 : ((index > ADPCM_IMA_MAX_INDEX) ? ADPCM_IMA_MAX_INDEX : index);
+}
+
+static inline INT32 clampDelta(INT32 delta)
+{
+	return (delta < ADPCM_MS_MIN_DELTA) ? ADPCM_MS_MIN_DELTA : ((delta > ADPCM_MS_MAX_DELTA) ? ADPCM_MS_MAX_DELTA : delta);
+}
+
+/**
+ * @fn	static inline INT32 imaStep(INT32 code, INT32* pPred, INT32* pIndex)
+ *
+ * @brief	Decodes one IMA code, the way the reference decoder does it: the difference is built from the
+ * 			step shifted by each code bit, so that encoder and decoder agree exactly.
+ *
+ * @date	10/17/2026
+ */
+static inline INT32 imaStep(INT32 code, INT32* pPred, INT32* pIndex)
+{
+	INT32 step = imaSteps[*pIndex];
+	INT32 diff = step >> 3;
+	if(code & 1)
+		diff += step >> 2;
+	if(code & 2)
+		diff += step >> 1;
+	if(code & 4)
+		diff += step;
+	if(code & 8)
+		diff = -diff;
+	*pPred = clamp16(*pPred + diff);
+	*pIndex = clampIndex(*pIndex + imaIndexAdjust[code]);
+	return *pPred;
+}
+
+/**
+ * @fn	static inline INT32 msStep(INT32 code, INT32 c1, INT32 c2, INT32* pS1, INT32* pS2, INT32* pDelta)
+ *
+ * @brief	Decodes one MS ADPCM code: the prediction from the last two samples, plus the signed code times
+ * 			delta, then delta adapts to the size of the code.
+ *
+ * @date	10/17/2026
+ */
+static inline INT32 msStep(INT32 code, INT32 c1, INT32 c2, INT32* pS1, INT32* pS2, INT32* pDelta)
+{
+	// summed with wraparound, as pmaddwd does, for coefficient tables that can overflow
+	INT32 predicted = (INT32)((UINT32)(*pS1 * c1) + (UINT32)(*pS2 * c2)) >> 8;
+	INT32 signedCode = (code & 8) ? code - 16 : code;
+	INT32 sample = clamp16(predicted + signedCode * *pDelta);
+	*pS2 = *pS1;
+	*pS1 = sample;
+	*pDelta = clampDelta((msAdapt[code] * *pDelta) >> 8);
+	return sample;
+}
+
+static inline void getMsCoefs(const AdpcmFormat* f, BYTE predictor, INT32* pC1, INT32* pC2)
+{
+	// a predictor past the table is a damaged block, decode it as if it used the first one
+	UINT32 i = (predictor < f->coefCount) ? predictor : 0;
+	*pC1 = f->coef1[i];
+	*pC2 = f->coef2[i];
+}
+
+/**
+ * @fn	static void decodeImaBlock(const AdpcmFormat* f, const BYTE* pIn, UINT32 frames, INT16* pOut)
+ *
+ * @brief	Reference decoder for one block, or the first frames of one. Each channel has a 4 byte header
+ * 			(the first sample and the step index), then the channels take turns with 4 bytes, 8 codes, each,
+ * 			low nibble first.
+ *
+ * @date	10/17/2026
+ */
+static void decodeImaBlock(const AdpcmFormat* f, const BYTE* pIn, UINT32 frames, INT16* pOut)
+{
+	UINT32 ch = f->channels;
+	for(UINT32 c = 0; c < ch; ++c){
+		const BYTE* pHeader = pIn + 4 * c;
+		INT32 pred = readS16(pHeader);
+		INT32 index = clampIndex(pHeader[2]);
+		INT16* pChannel = pOut + c;
+		pChannel[0] = (INT16)pred;
+		for(UINT32 k = 0; k + 1 < frames; ++k){
+			BYTE b = pIn[4 * ch + ((k >> 3) * ch + c) * 4 + ((k & 7) >> 1)];
+			INT32 code = (k & 1) ? (b >> 4) : (b & 15);
+			pChannel[(k + 1) * ch] = (INT16)imaStep(code, &pred, &index);
+		}
+	}
+}
+
+/**
+ * @fn	static void decodeMsBlock(const AdpcmFormat* f, const BYTE* pIn, UINT32 frames, INT16* pOut)
+ *
+ * @brief	Reference decoder for one MS ADPCM block, or the first frames of one. The header holds, for each
+ * 			channel in turn, the predictor, the starting delta and the two most recent samples, which are
+ * 			also the first two frames, oldest first. Then come the codes, frame by frame, high nibble first.
+ *
+ * @date	10/17/2026
+ */
+static void decodeMsBlock(const AdpcmFormat* f, const BYTE* pIn, UINT32 frames, INT16* pOut)
+{
+	UINT32 ch = f->channels;
+	const BYTE* pData = pIn + 7 * ch;
+	for(UINT32 c = 0; c < ch; ++c){
+		INT32 c1, c2;
+		getMsCoefs(f, pIn[c], &c1, &c2);
+		INT32 delta = clampDelta(readS16(pIn + ch + 2 * c));
+		INT32 s1 = readS16(pIn + 3 * ch + 2 * c);
+		INT32 s2 = readS16(pIn + 5 * ch + 2 * c);
+		INT16* pChannel = pOut + c;
+		pChannel[0] = (INT16)s2;
+		if(frames > 1)
+			pChannel[ch] = (INT16)s1;
+		for(UINT32 k = 0; k + 2 < frames; ++k){
+			UINT32 j = k * ch + c;
+			BYTE b = pData[j >> 1];
+			INT32 code = (j & 1) ? (b & 15) : (b >> 4);
+			pChannel[(k + 2) * ch] = (INT16)msStep(code, c1, c2, &s1, &s2, &delta);
+		}
+	}
+}
+
+static void decodeImaScalar(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		decodeImaBlock(f, pIn + (size_t)i * f->blockBytes, f->samplesPerBlock, pOut + (size_t)i * f->samplesPerBlock * f->channels);
+	}
+}
+
+static void decodeMsScalar(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		decodeMsBlock(f, pIn + (size_t)i * f->blockBytes, f->samplesPerBlock, pOut + (size_t)i * f->samplesPerBlock * f->channels);
+	}
+}
+
+/**
+ * @struct	AdpcmLanes
+ *
+ * @brief	The scalar side of the SIMD decoders: which block and channel each lane decodes, where its codes
+ * 			are and where its output goes. Lane l decodes channel l % channels of block l / channels of the
+ * 			group, so a group is lanes / channels consecutive blocks.
+ */
+template<UINT32 lanes>
+struct AdpcmLanes
+{
+	const BYTE* pBlock[lanes];
+	UINT32 channel[lanes];
+	INT16* pOut[lanes];       // the lane's channel in the first frame of its block
+	INT32 codes[8 * lanes];   // [code][lane], eight codes at a time
+	INT32 decoded[8 * lanes]; // [code][lane]
+
+	void setup(const AdpcmFormat* f, const BYTE* pGroup, INT16* pGroupOut){
+		for(UINT32 l = 0; l < lanes; ++l){
+			UINT32 b = l / f->channels;
+			channel[l] = l % f->channels;
+			pBlock[l] = pGroup + (size_t)b * f->blockBytes;
+			pOut[l] = pGroupOut + (size_t)b * f->samplesPerBlock * f->channels + channel[l];
+		}
+	};
+
+	// codes first to first + count - 1 of each lane, IMA layout
+	void unpackIma(const AdpcmFormat* f, UINT32 chunk){
+		UINT32 ch = f->channels;
+		for(UINT32 l = 0; l < lanes; ++l){
+			const BYTE* p = pBlock[l] + 4 * ch + (chunk * ch + channel[l]) * 4;
+			for(UINT32 i = 0; i < 4; ++i){
+				codes[(2 * i) * lanes + l] = p[i] & 15;
+				codes[(2 * i + 1) * lanes + l] = p[i] >> 4;
+			}
+		}
+	};
+
+	void unpackMs(const AdpcmFormat* f, UINT32 first, UINT32 count){
+		UINT32 ch = f->channels;
+		for(UINT32 l = 0; l < lanes; ++l){
+			const BYTE* pData = pBlock[l] + 7 * ch;
+			for(UINT32 i = 0; i < count; ++i){
+				UINT32 j = (first + i) * ch + channel[l];
+				BYTE b = pData[j >> 1];
+				codes[i * lanes + l] = (j & 1) ? (b & 15) : (b >> 4);
+			}
+		}
+	};
+
+	void store(UINT32 firstFrame, UINT32 count, UINT32 ch){
+		for(UINT32 l = 0; l < lanes; ++l){
+			INT16* p = pOut[l] + (size_t)firstFrame * ch;
+			for(UINT32 i = 0; i < count; ++i){
+				p[(size_t)i * ch] = (INT16)decoded[i * lanes + l];
+			}
+		}
+	};
+};
+
+#ifdef ADPCM_HAS_SSE2
+
+// low 32 bits of each lane's product, SSE2 has no pmulld
+static inline __m128i mullo32(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// lane = a > b ? a : b, and the like, SSE2 has no pmaxsd
+static inline __m128i selectMask(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// saturate to 16 bits through the packing instruction, then sign extend back
+static inline __m128i saturate16(__m128i v)
+{
+	__m128i packed = _mm_packs_epi32(v, v);
+	return _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+}
+
+static inline __m128i bitSet(__m128i code, INT32 bit)
+{
+	__m128i b = _mm_set1_epi32(bit);
+	return _mm_cmpeq_epi32(_mm_and_si128(code, b), b);
+}
+
+/**
+ * @fn	static void decodeImaSSE2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+ *
+ * @brief	Four block channels at a time. The step table has to be read a lane at a time (there is no
+ * 			gather before AVX2), the rest is the reference arithmetic with masks in place of the branches.
+ *
+ * @date	10/17/2026
+ */
+static void decodeImaSSE2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+{
+	UINT32 ch = f->channels;
+	UINT32 spb = f->samplesPerBlock;
+	UINT32 perGroup = (4 % ch == 0) ? 4 / ch : 0;
+	UINT32 groups = (perGroup > 0) ? count / perGroup : 0;
+	AdpcmLanes<4> lanes;
+	INT32 pred[4], index[4];
+
+	for(UINT32 g = 0; g < groups; ++g){
+		lanes.setup(f, pIn + (size_t)g * perGroup * f->blockBytes, pOut + (size_t)g * perGroup * spb * ch);
+		for(UINT32 l = 0; l < 4; ++l){
+			const BYTE* pHeader = lanes.pBlock[l] + 4 * lanes.channel[l];
+			pred[l] = readS16(pHeader);
+			index[l] = clampIndex(pHeader[2]);
+			lanes.pOut[l][0] = (INT16)pred[l];
+		}
+		__m128i vPred = _mm_loadu_si128((const __m128i*)pred);
+		__m128i vIndex = _mm_loadu_si128((const __m128i*)index);
+		const __m128i vMaxIndex = _mm_set1_epi32(ADPCM_IMA_MAX_INDEX);
+		const __m128i vZero = _mm_setzero_si128();
+
+		for(UINT32 chunk = 0; chunk < (spb - 1) / 8; ++chunk){
+			lanes.unpackIma(f, chunk);
+			for(UINT32 i = 0; i < 8; ++i){
+				__m128i code = _mm_loadu_si128((const __m128i*)&lanes.codes[i * 4]);
+				_mm_storeu_si128((__m128i*)index, vIndex);
+				__m128i step = _mm_setr_epi32(imaSteps[index[0]], imaSteps[index[1]], imaSteps[index[2]], imaSteps[index[3]]);
+
+				__m128i diff = _mm_srai_epi32(step, 3);
+				diff = _mm_add_epi32(diff, _mm_and_si128(bitSet(code, 1), _mm_srai_epi32(step, 2)));
+				diff = _mm_add_epi32(diff, _mm_and_si128(bitSet(code, 2), _mm_srai_epi32(step, 1)));
+				diff = _mm_add_epi32(diff, _mm_and_si128(bitSet(code, 4), step));
+				__m128i negative = bitSet(code, 8);
+				diff = _mm_sub_epi32(_mm_xor_si128(diff, negative), negative);
+				vPred = saturate16(_mm_add_epi32(vPred, diff));
+				_mm_storeu_si128((__m128i*)&lanes.decoded[i * 4], vPred);
+
+				// index += -1 for codes 0-3, else 2 * (code - 3), ignoring the sign bit
+				__m128i magnitude = _mm_and_si128(code, _mm_set1_epi32(7));
+				__m128i up = _mm_slli_epi32(_mm_sub_epi32(magnitude, _mm_set1_epi32(3)), 1);
+				__m128i lowCode = _mm_cmplt_epi32(magnitude, _mm_set1_epi32(4));
+				vIndex = _mm_add_epi32(vIndex, selectMask(lowCode, _mm_set1_epi32(-1), up));
+				vIndex = selectMask(_mm_cmplt_epi32(vIndex, vZero), vZero, vIndex);
+				vIndex = selectMask(_mm_cmpgt_epi32(vIndex, vMaxIndex), vMaxIndex, vIndex);
+			}
+			lanes.store(1 + chunk * 8, 8, ch);
+		}
+	}
+	UINT32 done = groups * perGroup;
+	decodeImaScalar(f, pIn + (size_t)done * f->blockBytes, count - done, pOut + (size_t)done * spb * ch);
+}
+
+/**
+ * @fn	static inline __m128i msStepSSE2(__m128i code, __m128i coefs, __m128i* pS1, __m128i* pS2,
+ * 		__m128i* pDelta)
+ *
+ * @brief	msStep() for four lanes. The prediction s1 * c1 + s2 * c2 is a single pmaddwd on the two samples
+ * 			and the two coefficients packed as 16 bit pairs.
+ *
+ * @date	10/17/2026
+ */
+static inline __m128i msStepSSE2(__m128i code, __m128i coefs, __m128i* pS1, __m128i* pS2, __m128i* pDelta)
+{
+	const __m128i vMinDelta = _mm_set1_epi32(ADPCM_MS_MIN_DELTA);
+	const __m128i vMaxDelta = _mm_set1_epi32(ADPCM_MS_MAX_DELTA);
+	INT32 adapt[4];
+
+	__m128i samples = _mm_or_si128(_mm_and_si128(*pS1, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(*pS2, 16));
+	__m128i predicted = _mm_srai_epi32(_mm_madd_epi16(samples, coefs), 8);
+	__m128i signedCode = _mm_srai_epi32(_mm_slli_epi32(code, 28), 28);
+	__m128i sample = saturate16(_mm_add_epi32(predicted, mullo32(signedCode, *pDelta)));
+	*pS2 = *pS1;
+	*pS1 = sample;
+
+	_mm_storeu_si128((__m128i*)adapt, code);
+	__m128i factor = _mm_setr_epi32(msAdapt[adapt[0]], msAdapt[adapt[1]], msAdapt[adapt[2]], msAdapt[adapt[3]]);
+	__m128i delta = _mm_srai_epi32(mullo32(factor, *pDelta), 8);
+	delta = selectMask(_mm_cmplt_epi32(delta, vMinDelta), vMinDelta, delta);
+	*pDelta = selectMask(_mm_cmpgt_epi32(delta, vMaxDelta), vMaxDelta, delta);
+	return sample;
+}
+
+/**
+ * @fn	static void decodeMsSSE2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+ *
+ * @brief	Eight block channels at a time, as two sets of four. Each lane's samples form one long chain of
+ * 			multiplies, and with SSE2 having to emulate 32 bit multiplies a single set of four spends most
+ * 			of its time waiting on it, so two independent sets are interleaved.
+ *
+ * @date	10/17/2026
+ */
+static void decodeMsSSE2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+{
+	UINT32 ch = f->channels;
+	UINT32 spb = f->samplesPerBlock;
+	UINT32 perGroup = (8 % ch == 0) ? 8 / ch : 0;
+	UINT32 groups = (perGroup > 0) ? count / perGroup : 0;
+	AdpcmLanes<8> lanes;
+	INT32 s1[8], s2[8], delta[8], coefs[8];
+
+	for(UINT32 g = 0; g < groups; ++g){
+		lanes.setup(f, pIn + (size_t)g * perGroup * f->blockBytes, pOut + (size_t)g * perGroup * spb * ch);
+		for(UINT32 l = 0; l < 8; ++l){
+			const BYTE* pBlock = lanes.pBlock[l];
+			UINT32 c = lanes.channel[l];
+			INT32 c1, c2;
+			getMsCoefs(f, pBlock[c], &c1, &c2);
+			coefs[l] = (INT32)((c1 & 0xFFFF) | ((UINT32)c2 << 16));
+			delta[l] = clampDelta(readS16(pBlock + ch + 2 * c));
+			s1[l] = readS16(pBlock + 3 * ch + 2 * c);
+			s2[l] = readS16(pBlock + 5 * ch + 2 * c);
+			lanes.pOut[l][0] = (INT16)s2[l];
+			lanes.pOut[l][ch] = (INT16)s1[l];
+		}
+		__m128i vS1a = _mm_loadu_si128((const __m128i*)s1);
+		__m128i vS1b = _mm_loadu_si128((const __m128i*)(s1 + 4));
+		__m128i vS2a = _mm_loadu_si128((const __m128i*)s2);
+		__m128i vS2b = _mm_loadu_si128((const __m128i*)(s2 + 4));
+		__m128i vDeltaA = _mm_loadu_si128((const __m128i*)delta);
+		__m128i vDeltaB = _mm_loadu_si128((const __m128i*)(delta + 4));
+		const __m128i vCoefsA = _mm_loadu_si128((const __m128i*)coefs);
+		const __m128i vCoefsB = _mm_loadu_si128((const __m128i*)(coefs + 4));
+
+		for(UINT32 first = 0; first + 2 < spb; first += 8){
+			UINT32 n = (spb - 2 - first < 8) ? spb - 2 - first : 8;
+			lanes.unpackMs(f, first, n);
+			for(UINT32 i = 0; i < n; ++i){
+				__m128i codeA = _mm_loadu_si128((const __m128i*)&lanes.codes[i * 8]);
+				__m128i codeB = _mm_loadu_si128((const __m128i*)&lanes.codes[i * 8 + 4]);
+				_mm_storeu_si128((__m128i*)&lanes.decoded[i * 8], msStepSSE2(codeA, vCoefsA, &vS1a, &vS2a, &vDeltaA));
+				_mm_storeu_si128((__m128i*)&lanes.decoded[i * 8 + 4], msStepSSE2(codeB, vCoefsB, &vS1b, &vS2b, &vDeltaB));
+			}
+			lanes.store(2 + first, n, ch);
+		}
+	}
+	UINT32 done = groups * perGroup;
+	decodeMsScalar(f, pIn + (size_t)done * f->blockBytes, count - done, pOut + (size_t)done * spb * ch);
+}
+
+#endif // ADPCM_HAS_SSE2
+
+#ifdef ADPCM_HAS_AVX2
+
+ADPCM_TARGET_AVX2 static inline __m256i bitSetAVX2(__m256i code, INT32 bit)
+{
+	__m256i b = _mm256_set1_epi32(bit);
+	return _mm256_cmpeq_epi32(_mm256_and_si256(code, b), b);
+}
+
+/**
+ * @fn	static void decodeImaAVX2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+ *
+ * @brief	Eight block channels at a time, with the step table read by a gather.
+ *
+ * @date	10/17/2026
+ */
+ADPCM_TARGET_AVX2 static void decodeImaAVX2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+{
+	UINT32 ch = f->channels;
+	UINT32 spb = f->samplesPerBlock;
+	UINT32 perGroup = (8 % ch == 0) ? 8 / ch : 0;
+	UINT32 groups = (perGroup > 0) ? count / perGroup : 0;
+	AdpcmLanes<8> lanes;
+	INT32 pred[8], index[8];
+
+	for(UINT32 g = 0; g < groups; ++g){
+		lanes.setup(f, pIn + (size_t)g * perGroup * f->blockBytes, pOut + (size_t)g * perGroup * spb * ch);
+		for(UINT32 l = 0; l < 8; ++l){
+			const BYTE* pHeader = lanes.pBlock[l] + 4 * lanes.channel[l];
+			pred[l] = readS16(pHeader);
+			index[l] = clampIndex(pHeader[2]);
+			lanes.pOut[l][0] = (INT16)pred[l];
+		}
+		__m256i vPred = _mm256_loadu_si256((const __m256i*)pred);
+		__m256i vIndex = _mm256_loadu_si256((const __m256i*)index);
+		const __m256i vMaxIndex = _mm256_set1_epi32(ADPCM_IMA_MAX_INDEX);
+		const __m256i vZero = _mm256_setzero_si256();
+		const __m256i vMin16 = _mm256_set1_epi32(-32768);
+		const __m256i vMax16 = _mm256_set1_epi32(32767);
+		const __m256i vAdjust = _mm256_setr_epi32(-1, -1, -1, -1, 2, 4, 6, 8);
+
+		for(UINT32 chunk = 0; chunk < (spb - 1) / 8; ++chunk){
+			lanes.unpackIma(f, chunk);
+			for(UINT32 i = 0; i < 8; ++i){
+				__m256i code = _mm256_loadu_si256((const __m256i*)&lanes.codes[i * 8]);
+				__m256i step = _mm256_i32gather_epi32(imaSteps, vIndex, 4);
+
+				__m256i diff = _mm256_srai_epi32(step, 3);
+				diff = _mm256_add_epi32(diff, _mm256_and_si256(bitSetAVX2(code, 1), _mm256_srai_epi32(step, 2)));
+				diff = _mm256_add_epi32(diff, _mm256_and_si256(bitSetAVX2(code, 2), _mm256_srai_epi32(step, 1)));
+				diff = _mm256_add_epi32(diff, _mm256_and_si256(bitSetAVX2(code, 4), step));
+				__m256i negative = bitSetAVX2(code, 8);
+				diff = _mm256_sub_epi32(_mm256_xor_si256(diff, negative), negative);
+				vPred = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(vPred, diff), vMin16), vMax16);
+				_mm256_storeu_si256((__m256i*)&lanes.decoded[i * 8], vPred);
+
+				// the eight index adjustments fit one register, look them up by the code less its sign
+				__m256i adjust = _mm256_permutevar8x32_epi32(vAdjust, _mm256_and_si256(code, _mm256_set1_epi32(7)));
+				vIndex = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(vIndex, adjust), vZero), vMaxIndex);
+			}
+			lanes.store(1 + chunk * 8, 8, ch);
+		}
+	}
+	_mm256_zeroupper();
+	UINT32 done = groups * perGroup;
+	decodeImaScalar(f, pIn + (size_t)done * f->blockBytes, count - done, pOut + (size_t)done * spb * ch);
+}
+
+/**
+ * @fn	static void decodeMsAVX2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+ *
+ * @brief	Eight block channels at a time, the adaptation table read by a gather.
+ *
+ * @date	10/17/2026
+ */
+ADPCM_TARGET_AVX2 static void decodeMsAVX2(const AdpcmFormat* f, const BYTE* pIn, UINT32 count, INT16* pOut)
+{
+	UINT32 ch = f->channels;
+	UINT32 spb = f->samplesPerBlock;
+	UINT32 perGroup = (8 % ch == 0) ? 8 / ch : 0;
+	UINT32 groups = (perGroup > 0) ? count / perGroup : 0;
+	AdpcmLanes<8> lanes;
+	INT32 s1[8], s2[8], delta[8], coefs[8];
+
+	for(UINT32 g = 0; g < groups; ++g){
+		lanes.setup(f, pIn + (size_t)g * perGroup * f->blockBytes, pOut + (size_t)g * perGroup * spb * ch);
+		for(UINT32 l = 0; l < 8; ++l){
+			const BYTE* pBlock = lanes.pBlock[l];
+			UINT32 c = lanes.channel[l];
+			INT32 c1, c2;
+			getMsCoefs(f, pBlock[c], &c1, &c2);
+			coefs[l] = (INT32)((c1 & 0xFFFF) | ((UINT32)c2 << 16));
+			delta[l] = clampDelta(readS16(pBlock + ch + 2 * c));
+			s1[l] = readS16(pBlock + 3 * ch + 2 * c);
+			s2[l] = readS16(pBlock + 5 * ch + 2 * c);
+			lanes.pOut[l][0] = (INT16)s2[l];
+			lanes.pOut[l][ch] = (INT16)s1[l];
+		}
+		__m256i vS1 = _mm256_loadu_si256((const __m256i*)s1);
+		__m256i vS2 = _mm256_loadu_si256((const __m256i*)s2);
+		__m256i vDelta = _mm256_loadu_si256((const __m256i*)delta);
+		const __m256i vCoefs = _mm256_loadu_si256((const __m256i*)coefs);
+		const __m256i vMinDelta = _mm256_set1_epi32(ADPCM_MS_MIN_DELTA);
+		const __m256i vMaxDelta = _mm256_set1_epi32(ADPCM_MS_MAX_DELTA);
+		const __m256i vMin16 = _mm256_set1_epi32(-32768);
+		const __m256i vMax16 = _mm256_set1_epi32(32767);
+		const __m256i vLow16 = _mm256_set1_epi32(0xFFFF);
+
+		for(UINT32 first = 0; first + 2 < spb; first += 8){
+			UINT32 n = (spb - 2 - first < 8) ? spb - 2 - first : 8;
+			lanes.unpackMs(f, first, n);
+			for(UINT32 i = 0; i < n; ++i){
+				__m256i code = _mm256_loadu_si256((const __m256i*)&lanes.codes[i * 8]);
+				__m256i samples = _mm256_or_si256(_mm256_and_si256(vS1, vLow16), _mm256_slli_epi32(vS2, 16));
+				__m256i predicted = _mm256_srai_epi32(_mm256_madd_epi16(samples, vCoefs), 8);
+				__m256i signedCode = _mm256_srai_epi32(_mm256_slli_epi32(code, 28), 28);
+				__m256i sample = _mm256_add_epi32(predicted, _mm256_mullo_epi32(signedCode, vDelta));
+				sample = _mm256_min_epi32(_mm256_max_epi32(sample, vMin16), vMax16);
+				vS2 = vS1;
+				vS1 = sample;
+				_mm256_storeu_si256((__m256i*)&lanes.decoded[i * 8], sample);
+
+				__m256i factor = _mm256_i32gather_epi32(msAdapt, code, 4);
+				vDelta = _mm256_srai_epi32(_mm256_mullo_epi32(factor, vDelta), 8);
+				vDelta = _mm256_min_epi32(_mm256_max_epi32(vDelta, vMinDelta), vMaxDelta);
+			}
+			lanes.store(2 + first, n, ch);
+		}
+	}
+	_mm256_zeroupper();
+	UINT32 done = groups * perGroup;
+	decodeMsScalar(f, pIn + (size_t)done * f->blockBytes, count - done, pOut + (size_t)done * spb * ch);
+}
+
+#endif // ADPCM_HAS_AVX2
+
+static const AdpcmDecoders scalarDecoders = { MIX_KERNEL_SCALAR, decodeImaScalar, decodeMsScalar };
+#ifdef ADPCM_HAS_SSE2
+static const AdpcmDecoders sse2Decoders = { MIX_KERNEL_SSE2, decodeImaSSE2, decodeMsSSE2 };
+#endif
+#ifdef ADPCM_HAS_AVX2
+static const AdpcmDecoders avx2Decoders = { MIX_KERNEL_AVX2, decodeImaAVX2, decodeMsAVX2 };
+#endif
+
+/**
+ * @fn	const AdpcmDecoders* getAdpcmDecoders(MIX_KERNEL kernel)
+ *
+ * @brief	Gets the decoders for a kernel.
+ *
+ * @return	null if the kernel can't be used here.
+ *
+ * @date	10/17/2026
+ */
+const AdpcmDecoders* getAdpcmDecoders(MIX_KERNEL kernel)
+{
+	if(!isMixKernelAvailable(kernel))
+		return NULL;
+	switch(kernel){
+#ifdef ADPCM_HAS_AVX2
+		case MIX_KERNEL_AVX2:
+			return &avx2Decoders;
+#endif
+#ifdef ADPCM_HAS_SSE2
+		case MIX_KERNEL_SSE2:
+			return &sse2Decoders;
+#endif
+		default:
+			return &scalarDecoders;
+	}
+}
+
+/**
+ * @fn	ADPCM_TYPE getAdpcmType(const WAVEFORMATEX* pFormat)
+ *
+ * @brief	Tells if a format is one of the ADPCM encodings, going by the tag alone.
+ *
+ * @date	10/17/2026
+ */
+ADPCM_TYPE getAdpcmType(const WAVEFORMATEX* pFormat)
+{
+	if(pFormat == NULL)
+		return ADPCM_TYPE_NONE;
+	switch(pFormat->wFormatTag){
+		case WAVE_FORMAT_IMA_ADPCM:
+			return ADPCM_TYPE_IMA;
+		case WAVE_FORMAT_ADPCM:
+			return ADPCM_TYPE_MS;
+		default:
+			return ADPCM_TYPE_NONE;
+	}
+}
+
+/**
+ * @fn	HRESULT getAdpcmFormat(const WAVEFORMATEX* pFormat, AdpcmFormat* pAdpcm)
+ *
+ * @brief	Reads an ADPCM 'fmt ' chunk. The frames per block are worked out from the block size rather than
+ * 			taken from wSamplesPerBlock, which some writers get wrong. An MS ADPCM chunk without its own
+ * 			coefficient table gets the standard seven predictors.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pFormat		The format, with its cbSize extra bytes following it in memory as
+ * 						MappedWaveFile::getFormat() keeps them.
+ * @param [out]	pAdpcm	Receives the description.
+ *
+ * @return	S_OK, or E_FAIL if the format is not ADPCM or is inconsistent.
+ */
+HRESULT getAdpcmFormat(const WAVEFORMATEX* pFormat, AdpcmFormat* pAdpcm)
+{
+	ADPCM_TYPE type = getAdpcmType(pFormat);
+	if(type == ADPCM_TYPE_NONE || pFormat->wBitsPerSample != 4)
+		return E_FAIL;
+	UINT32 ch = pFormat->nChannels;
+	if(ch == 0 || ch > ADPCM_MAX_CHANNELS || pFormat->nSamplesPerSec == 0)
+		return E_FAIL;
+
+	memset(pAdpcm, 0, sizeof(*pAdpcm));
+	pAdpcm->type = type;
+	pAdpcm->channels = ch;
+	pAdpcm->sampleRate = pFormat->nSamplesPerSec;
+	pAdpcm->blockBytes = pFormat->nBlockAlign;
+
+	if(type == ADPCM_TYPE_IMA){
+		// a header per channel, then at least one 4 byte group of codes per channel
+		if(pAdpcm->blockBytes < 8 * ch)
+			return E_FAIL;
+		pAdpcm->samplesPerBlock = 1 + ((pAdpcm->blockBytes - 4 * ch) / (4 * ch)) * 8;
+		return S_OK;
+	}
+
+	if(pAdpcm->blockBytes < 7 * ch + 1)
+		return E_FAIL;
+	pAdpcm->samplesPerBlock = 2 + ((pAdpcm->blockBytes - 7 * ch) * 2) / ch;
+
+	const BYTE* pExtra = (const BYTE*)pFormat + sizeof(WAVEFORMATEX);
+	UINT32 coefCount = (pFormat->cbSize >= 4) ? (pExtra[2] | (pExtra[3] << 8)) : 0;
+	if(coefCount > 0 && pFormat->cbSize >= 4 + 4 * coefCount){
+		if(coefCount > ADPCM_MS_MAX_COEFS)
+			coefCount = ADPCM_MS_MAX_COEFS;
+		for(UINT32 i = 0; i < coefCount; ++i){
+			pAdpcm->coef1[i] = readS16(pExtra + 4 + 4 * i);
+			pAdpcm->coef2[i] = readS16(pExtra + 6 + 4 * i);
+		}
+		pAdpcm->coefCount = coefCount;
+	}else{
+		memcpy(pAdpcm->coef1, msCoef1, sizeof(msCoef1));
+		memcpy(pAdpcm->coef2, msCoef2, sizeof(msCoef2));
+		pAdpcm->coefCount = 7;
+	}
+	return S_OK;
+}
+
+/**
+ * @fn	UINT32 makeAdpcmFormat(ADPCM_TYPE type, UINT32 channels, UINT32 sampleRate, UINT32 blockBytes,
+ * 		BYTE* pOut)
+ *
+ * @brief	Writes the 'fmt ' chunk of an ADPCM stream, as WAVEFORMATEX and its extra bytes (the frames per
+ * 			block, and for MS ADPCM the seven standard predictors).
+ *
+ * @date	10/17/2026
+ *
+ * @param	type	  	IMA or MS.
+ * @param	channels  	Channel count.
+ * @param	sampleRate	Frames per second.
+ * @param	blockBytes	Block size, 256 * channels is usual for 22kHz and 512 * channels for 44.1kHz.
+ * @param [out]	pOut  	At least ADPCM_FORMAT_BYTES bytes.
+ *
+ * @return	The size of the format in bytes, 0 if the block size is too small.
+ */
+UINT32 makeAdpcmFormat(ADPCM_TYPE type, UINT32 channels, UINT32 sampleRate, UINT32 blockBytes, BYTE* pOut)
+{
+	WAVEFORMATEX wfx;
+	memset(&wfx, 0, sizeof(wfx));
+	wfx.wFormatTag = (type == ADPCM_TYPE_IMA) ? WAVE_FORMAT_IMA_ADPCM : WAVE_FORMAT_ADPCM;
+	wfx.nChannels = (WORD)channels;
+	wfx.nSamplesPerSec = sampleRate;
+	wfx.nBlockAlign = (WORD)blockBytes;
+	wfx.wBitsPerSample = 4;
+
+	// checked before cbSize is set, there are no extra bytes behind wfx yet
+	AdpcmFormat adpcm;
+	if(blockBytes > 0xFFFF || FAILED(getAdpcmFormat(&wfx, &adpcm)))
+		return 0;
+	wfx.cbSize = (type == ADPCM_TYPE_IMA) ? 2 : 4 + 7 * 4;
+	wfx.nAvgBytesPerSec = (DWORD)((UINT64)sampleRate * blockBytes / adpcm.samplesPerBlock);
+
+	memset(pOut, 0, sizeof(WAVEFORMATEX) + wfx.cbSize);
+	memcpy(pOut, &wfx, sizeof(WAVEFORMATEX));
+	BYTE* pExtra = pOut + sizeof(WAVEFORMATEX);
+	writeS16(pExtra, adpcm.samplesPerBlock);
+	if(type == ADPCM_TYPE_MS){
+		writeS16(pExtra + 2, 7);
+		for(UINT32 i = 0; i < 7; ++i){
+			writeS16(pExtra + 4 + 4 * i, msCoef1[i]);
+			writeS16(pExtra + 6 + 4 * i, msCoef2[i]);
+		}
+	}
+	return sizeof(WAVEFORMATEX) + wfx.cbSize;
+}
+
+/**
+ * @fn	void makeDecodedFormat(const AdpcmFormat* pAdpcm, WAVEFORMATEX* pOut)
+ *
+ * @brief	The 16 bit PCM format an ADPCM stream decodes to.
+ *
+ * @date	10/17/2026
+ */
+void makeDecodedFormat(const AdpcmFormat* pAdpcm, WAVEFORMATEX* pOut)
+{
+	memset(pOut, 0, sizeof(*pOut));
+	pOut->wFormatTag = WAVE_FORMAT_PCM;
+	pOut->nChannels = (WORD)pAdpcm->channels;
+	pOut->nSamplesPerSec = pAdpcm->sampleRate;
+	pOut->wBitsPerSample = 16;
+	pOut->nBlockAlign = (WORD)(2 * pAdpcm->channels);
+	pOut->nAvgBytesPerSec = pOut->nBlockAlign * pAdpcm->sampleRate;
+}
+
+/**
+ * @fn	UINT32 getAdpcmBlockFrames(const AdpcmFormat* pAdpcm, UINT32 bytes)
+ *
+ * @brief	Frames in a block of the given size. Only the last block of a stream may be short.
+ *
+ * @date	10/17/2026
+ */
+UINT32 getAdpcmBlockFrames(const AdpcmFormat* pAdpcm, UINT32 bytes)
+{
+	UINT32 ch = pAdpcm->channels;
+	UINT32 frames;
+	if(bytes >= pAdpcm->blockBytes)
+		return pAdpcm->samplesPerBlock;
+	if(pAdpcm->type == ADPCM_TYPE_IMA){
+		if(bytes < 4 * ch)
+			return 0;
+		frames = 1 + ((bytes - 4 * ch) / (4 * ch)) * 8;
+	}else{
+		if(bytes < 7 * ch)
+			return 0;
+		frames = 2 + ((bytes - 7 * ch) * 2) / ch;
+	}
+	return (frames < pAdpcm->samplesPerBlock) ? frames : pAdpcm->samplesPerBlock;
+}
+
+/**
+ * @fn	UINT64 getAdpcmFrames(const AdpcmFormat* pAdpcm, UINT64 bytes)
+ *
+ * @brief	Frames in a stream of the given size.
+ *
+ * @date	10/17/2026
+ */
+UINT64 getAdpcmFrames(const AdpcmFormat* pAdpcm, UINT64 bytes)
+{
+	UINT64 blocks = bytes / pAdpcm->blockBytes;
+	return blocks * pAdpcm->samplesPerBlock + getAdpcmBlockFrames(pAdpcm, (UINT32)(bytes % pAdpcm->blockBytes));
+}
+
+/**
+ * @fn	UINT64 getAdpcmEncodedBytes(const AdpcmFormat* pAdpcm, UINT64 frames)
+ *
+ * @brief	Size encodeAdpcm() needs for the given number of frames.
+ *
+ * @date	10/17/2026
+ */
+UINT64 getAdpcmEncodedBytes(const AdpcmFormat* pAdpcm, UINT64 frames)
+{
+	UINT32 ch = pAdpcm->channels;
+	UINT64 blocks = frames / pAdpcm->samplesPerBlock;
+	UINT32 rest = (UINT32)(frames % pAdpcm->samplesPerBlock);
+	UINT64 bytes = blocks * pAdpcm->blockBytes;
+	if(rest == 0)
+		return bytes;
+	if(pAdpcm->type == ADPCM_TYPE_IMA)
+		return bytes + 4 * ch + ((rest - 1 + 7) / 8) * 4 * ch;
+	UINT32 codes = (rest > 2) ? rest - 2 : 0;
+	return bytes + 7 * ch + (codes * ch + 1) / 2;
+}
+
+/**
+ * @fn	UINT32 decodeAdpcm(const AdpcmFormat* pAdpcm, const BYTE* pIn, UINT32 bytes, INT16* pOut,
+ * 		MIX_KERNEL kernel)
+ *
+ * @brief	Decodes a run of blocks, the last of which may be short, to interleaved 16 bit PCM.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pAdpcm	   	The stream's format.
+ * @param	pIn		   	The blocks.
+ * @param	bytes	   	Size of the blocks.
+ * @param [out]	pOut   	Receives getAdpcmFrames(pAdpcm, bytes) frames.
+ * @param	kernel	   	The decoders to use, scalar if that kernel is not available.
+ *
+ * @return	The number of frames decoded.
+ */
+UINT32 decodeAdpcm(const AdpcmFormat* pAdpcm, const BYTE* pIn, UINT32 bytes, INT16* pOut, MIX_KERNEL kernel)
+{
+	const AdpcmDecoders* pDecoders = getAdpcmDecoders(kernel);
+	if(pDecoders == NULL)
+		pDecoders = &scalarDecoders;
+
+	UINT32 blocks = bytes / pAdpcm->blockBytes;
+	UINT32 tail = getAdpcmBlockFrames(pAdpcm, bytes % pAdpcm->blockBytes);
+	const BYTE* pTail = pIn + (size_t)blocks * pAdpcm->blockBytes;
+	INT16* pTailOut = pOut + (size_t)blocks * pAdpcm->samplesPerBlock * pAdpcm->channels;
+	if(pAdpcm->type == ADPCM_TYPE_IMA){
+		pDecoders->decodeIma(pAdpcm, pIn, blocks, pOut);
+		if(tail > 0)
+			decodeImaBlock(pAdpcm, pTail, tail, pTailOut);
+	}else{
+		pDecoders->decodeMs(pAdpcm, pIn, blocks, pOut);
+		if(tail > 0)
+			decodeMsBlock(pAdpcm, pTail, tail, pTailOut);
+	}
+	return blocks * pAdpcm->samplesPerBlock + tail;
+}
+
+UINT32 decodeAdpcm(const AdpcmFormat* pAdpcm, const BYTE* pIn, UINT32 bytes, INT16* pOut)
+{
+	return decodeAdpcm(pAdpcm, pIn, bytes, pOut, getBestMixKernel());
+}
+
+/**
+ * @fn	static void encodeImaBlock(const AdpcmFormat* f, const INT16* pIn, UINT32 frames, INT32* pIndex,
+ * 		BYTE* pOut)
+ *
+ * @brief	Encodes one block. The step index carries on from the previous block, each channel's first
+ * 			sample goes in the header as it is. frames - 1 must be a multiple of 8.
+ *
+ * @date	10/17/2026
+ */
+static void encodeImaBlock(const AdpcmFormat* f, const INT16* pIn, UINT32 frames, INT32* pIndex, BYTE* pOut)
+{
+	UINT32 ch = f->channels;
+	for(UINT32 c = 0; c < ch; ++c){
+		INT32 pred = pIn[c];
+		INT32 index = pIndex[c];
+		writeS16(pOut + 4 * c, pred);
+		pOut[4 * c + 2] = (BYTE)index;
+		pOut[4 * c + 3] = 0;
+
+		for(UINT32 k = 0; k + 1 < frames; ++k){
+			INT32 diff = pIn[(k + 1) * ch + c] - pred;
+			INT32 step = imaSteps[index];
+			INT32 code = 0;
+			if(diff < 0){
+				code = 8;
+				diff = -diff;
+			}
+			if(diff >= step){
+				code |= 4;
+				diff -= step;
+			}
+			step >>= 1;
+			if(diff >= step){
+				code |= 2;
+				diff -= step;
+			}
+			step >>= 1;
+			if(diff >= step)
+				code |= 1;
+			imaStep(code, &pred, &index);
+
+			BYTE* p = pOut + 4 * ch + ((k >> 3) * ch + c) * 4 + ((k & 7) >> 1);
+			if(k & 1)
+				*p = (BYTE)((*p & 0x0F) | (code << 4));
+			else
+				*p = (BYTE)((*p & 0xF0) | code);
+		}
+		pIndex[c] = index;
+	}
+}
+
+/**
+ * @fn	static INT64 encodeMsChannel(const AdpcmFormat* f, const INT16* pIn, UINT32 frames, UINT32 c,
+ * 		UINT32 predictor, BYTE* pOut)
+ *
+ * @brief	Encodes one channel of an MS ADPCM block with the given predictor, or with pOut NULL just works
+ * 			out how far the result would be from the input.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The sum of the squared errors.
+ */
+static INT64 encodeMsChannel(const AdpcmFormat* f, const INT16* pIn, UINT32 frames, UINT32 c, UINT32 predictor, BYTE* pOut)
+{
+	UINT32 ch = f->channels;
+	INT32 c1 = f->coef1[predictor];
+	INT32 c2 = f->coef2[predictor];
+	INT32 s2 = pIn[c];
+	INT32 s1 = (frames > 1) ? pIn[ch + c] : s2;
+
+	// start delta at about a quarter of the first prediction error, so the first codes are mid range
+	INT32 delta = ADPCM_MS_MIN_DELTA;
+	if(frames > 2)
+		delta = clampDelta(abs(pIn[2 * ch + c] - ((s1 * c1 + s2 * c2) >> 8)) / 4);
+	if(delta > 0x7FFF)
+		delta = 0x7FFF;
+
+	if(pOut != NULL){
+		pOut[c] = (BYTE)predictor;
+		writeS16(pOut + ch + 2 * c, delta);
+		writeS16(pOut + 3 * ch + 2 * c, s1);
+		writeS16(pOut + 5 * ch + 2 * c, s2);
+	}
+
+	INT64 error = 0;
+	for(UINT32 k = 0; k + 2 < frames; ++k){
+		INT32 x = pIn[(k + 2) * ch + c];
+		INT32 predicted = (s1 * c1 + s2 * c2) >> 8;
+		INT32 diff = x - predicted;
+		INT32 code = (diff >= 0) ? (diff + delta / 2) / delta : -((-diff + delta / 2) / delta);
+		code = (code > 7) ? 7 : ((code < -8) ? -8 : code);
+		INT32 sample = msStep(code & 15, c1, c2, &s1, &s2, &delta);
+		error += (INT64)(x - sample) * (x - sample);
+
+		if(pOut != NULL){
+			UINT32 j = k * ch + c;
+			BYTE* p = pOut + 7 * ch + (j >> 1);
+			if(j & 1)
+				*p = (BYTE)((*p & 0xF0) | (code & 15));
+			else
+				*p = (BYTE)((*p & 0x0F) | ((code & 15) << 4));
+		}
+	}
+	return error;
+}
+
+/**
+ * @fn	UINT32 encodeAdpcm(const AdpcmFormat* pAdpcm, const INT16* pIn, UINT32 frames, BYTE* pOut)
+ *
+ * @brief	Encodes interleaved 16 bit PCM, for tools that build compressed assets. MS ADPCM tries every
+ * 			predictor on each block channel and keeps the closest. A short last block is padded by repeating
+ * 			the last frame, by at most 7 frames (IMA) or 1 (MS).
+ *
+ * @date	10/17/2026
+ *
+ * @param	pAdpcm	   	The format to encode to, from getAdpcmFormat().
+ * @param	pIn		   	The samples.
+ * @param	frames	   	Number of frames.
+ * @param [out]	pOut   	At least getAdpcmEncodedBytes(pAdpcm, frames) bytes.
+ *
+ * @return	The number of bytes written.
+ */
+UINT32 encodeAdpcm(const AdpcmFormat* pAdpcm, const INT16* pIn, UINT32 frames, BYTE* pOut)
+{
+	UINT32 ch = pAdpcm->channels;
+	UINT32 spb = pAdpcm->samplesPerBlock;
+	INT32 index[ADPCM_MAX_CHANNELS] = { 0 };
+	UINT32 written = 0;
+
+	for(UINT32 first = 0; first < frames; first += spb){
+		UINT32 n = (frames - first < spb) ? frames - first : spb;
+		const INT16* pBlock = pIn + (size_t)first * ch;
+		UINT32 bytes = (n == spb) ? pAdpcm->blockBytes : (UINT32)getAdpcmEncodedBytes(pAdpcm, n);
+		BYTE* pBlockOut = pOut + written;
+		memset(pBlockOut, 0, bytes);
+
+		// the encoders read whole code groups, so a short block is copied and padded first
+		UINT32 coded = n;
+		vector<INT16> tail;
+		if(n < spb){
+			coded = (UINT32)getAdpcmBlockFrames(pAdpcm, bytes);
+			tail.assign(pBlock, pBlock + (size_t)n * ch);
+			for(UINT32 i = n; i < coded; ++i){
+				tail.insert(tail.end(), pBlock + (size_t)(n - 1) * ch, pBlock + (size_t)n * ch);
+			}
+			pBlock = &tail[0];
+		}
+
+		if(pAdpcm->type == ADPCM_TYPE_IMA){
+			encodeImaBlock(pAdpcm, pBlock, coded, index, pBlockOut);
+		}else{
+			for(UINT32 c = 0; c < ch; ++c){
+				UINT32 best = 0;
+				INT64 bestError = -1;
+				for(UINT32 p = 0; p < pAdpcm->coefCount; ++p){
+					INT64 error = encodeMsChannel(pAdpcm, pBlock, coded, c, p, NULL);
+					if(bestError < 0 || error < bestError){
+						bestError = error;
+						best = p;
+					}
+				}
+				encodeMsChannel(pAdpcm, pBlock, coded, c, best, pBlockOut);
+			}
+		}
+		written += bytes;
+	}
+	return written;
+}
+
+/**
+// End of AdpcmCodec.cpp
+ */
@@ -0,0 +1,1509 @@
+/**
+ * @file	AudioBenchmarks.cpp
+ *
+ * @brief	Headless microbenchmarks of the library's hot paths. Only the portable modules are used, so this
+ * 			builds and runs on a Linux box with no audio device (see the Makefile next to it). Results are
+ * 			written as JSON, and a run can be compared against a saved one to flag regressions:
+ *
+ * 			AudioBenchmarks --out baseline.json
+ * 			AudioBenchmarks --compare baseline.json --threshold 10
+ *
+ * 			Every benchmark reports the median time per item (a sample, a frame, a lookup, a file...) over
+ * 			several repetitions, each long enough to swamp the clock's resolution. Memory footprints that go
+ * 			with a CPU trade-off (ADPCM decoded at load or as it plays) are listed separately, in bytes.
+ *
+ * 			Where to look for a module's figures (--filter takes any part of a name):
+ *
+ * 			spatializer/..., spatial/...    Spatializer kernels, per emitter (1e9 / ns is emitters/s)
+ * 			mixer/..., offline_render/...   MixKernels accumulation and int16 output, and SoftwareMixer at 8 to
+ * 			                                1024 voices, stereo and 8 channel 48kHz
+ * 			resampler/<quality>             Resampler, per output frame of one stereo voice for each tier
+ * 			convert/...                     SampleConvert to and from float, per sample for each kernel
+ * 			wav_load/...                    MappedWaveFile against a copying loader, and PcmAssetCache loading
+ * 			                                Wavs/ on 1, 2, 4 and 8 threads, per file
+ */
+
+#include "PortableTypes.h"
+#include "SoundHandles.h"
+#include "SampleConvert.h"
+#include "MixKernels.h"
+#include "MappedWaveFile.h"
+#include "PcmAssetCache.h"
+#include "AdpcmCodec.h"
+#include "WavStreamReader.h"
+#include "WaveFileWriter.h"
+#include "SoundBank.h"
+#include "WorkerPool.h"
+#include "EmitterSoA.h"
+#include "Spatializer.h"
+#include "Resampler.h"
+#include "SoftwareMixer.h"
+#include "CommandRing.h"
+#include "AudioCommand.h"
+#include "SoundEvent.h"
+#include "AudioLog.h"
+#include "EngineStats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @struct	BenchResult
+ *
+ * @brief	One benchmark's timings, in nanoseconds per item.
+ */
+struct BenchResult
+{
+	string name;
+	string per;             // what an item is
+	double medianNs;
+	double minNs;
+	double maxNs;
+	UINT64 items;           // items in one repetition
+	UINT32 reps;
+};
+
+/**
+ * @struct	MemoryResult
+ *
+ * @brief	The bytes one way of holding an asset takes.
+ */
+struct MemoryResult
+{
+	string asset;
+	UINT64 bytes;
+};
+
+/**
+ * @struct	BenchOptions
+ *
+ * @brief	Command line settings.
+ */
+struct BenchOptions
+{
+	string filter;          // run only benchmarks whose name contains this
+	string wavDir;
+	string outFile;         // JSON goes here, or to stdout
+	string compareFile;     // baseline to compare against
+	double thresholdPercent; // slower than the baseline by more than this is a regression
+	double minRepMs;        // each repetition runs the body until at least this long
+	UINT32 reps;
+	bool list;
+};
+
+typedef function<UINT64()> BENCH_BODY; // runs the code under test once, returns the items it processed
+
+static BenchOptions options;
+static vector<BenchResult> results;
+static vector<MemoryResult> memory;
+static volatile FLOAT32 sink; // keeps results the optimiser could otherwise discard
+
+static double nowNs()
+{
+	return (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool selected(const string& name)
+{
+	if(!options.filter.empty() && name.find(options.filter) == string::npos)
+		return false;
+	if(options.list){
+		printf("%s\n", name.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @fn	static void addResult(const string& name, const char* per, vector<double> samples, UINT64 items)
+ *
+ * @brief	Records a benchmark from its per-repetition samples, in nanoseconds per item.
+ *
+ * @date	10/17/2026
+ */
+static void addResult(const string& name, const char* per, vector<double> samples, UINT64 items)
+{
+	sort(samples.begin(), samples.end());
+	BenchResult br;
+	br.name = name;
+	br.per = per;
+	br.medianNs = samples[samples.size() / 2];
+	br.minNs = samples.front();
+	br.maxNs = samples.back();
+	br.items = items;
+	br.reps = (UINT32)samples.size();
+	results.push_back(br);
+	fprintf(stderr, "%-44s %12.3f ns/%s\n", name.c_str(), br.medianNs, per);
+}
+
+/**
+ * @fn	static void addMemory(const string& asset, UINT64 bytes)
+ *
+ * @brief	Records the footprint of one way of holding an asset.
+ *
+ * @date	10/17/2026
+ */
+static void addMemory(const string& asset, UINT64 bytes)
+{
+	MemoryResult m;
+	m.asset = asset;
+	m.bytes = bytes;
+	memory.push_back(m);
+}
+
+/**
+ * @fn	static bool bench(const string& name, const char* per, BENCH_BODY body)
+ *
+ * @brief	Times body and records the result. One untimed call warms caches and decides how many calls make
+ * 			up a repetition, then the repetitions are timed and the median, min and max kept.
+ *
+ * @date	10/17/2026
+ *
+ * @param	name	Name, '/' separated from the general to the particular.
+ * @param	per 	What an item is, for the report.
+ * @param	body	The code under test.
+ *
+ * @return	true if it ran, false if the filter left it out or the body reported nothing done.
+ */
+static bool bench(const string& name, const char* per, BENCH_BODY body)
+{
+	if(!selected(name))
+		return false;
+
+	double t0 = nowNs();
+	UINT64 items = body();
+	double once = nowNs() - t0;
+	if(items == 0){
+		fprintf(stderr, "%-44s skipped\n", name.c_str());
+		return false;
+	}
+	UINT32 calls = 1;
+	if(once < options.minRepMs * 1e6)
+		calls = (UINT32)min(1e6, ceil(options.minRepMs * 1e6 / max(once, 1.0)));
+
+	vector<double> perItem;
+	for(UINT32 r = 0; r < options.reps; ++r){
+		UINT64 n = 0;
+		t0 = nowNs();
+		for(UINT32 c = 0; c < calls; ++c){
+			n += body();
+		}
+		perItem.push_back((nowNs() - t0) / (double)n);
+	}
+	addResult(name, per, perItem, items * calls);
+	return true;
+}
+
+static const char* kernelName(MIX_KERNEL kernel)
+{
+	switch(kernel){
+		case MIX_KERNEL_SCALAR:
+			return "scalar";
+		case MIX_KERNEL_SSE2:
+			return "sse2";
+		default:
+			return "avx2";
+	}
+}
+
+static vector<string> listWavs(const string& dir)
+{
+	vector<string> files;
+	DIR* d = opendir(dir.c_str());
+	if(d == NULL)
+		return files;
+	struct dirent* e;
+	while((e = readdir(d)) != NULL){
+		string name = e->d_name;
+		if(name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0)
+			files.push_back(dir + "/" + name);
+	}
+	closedir(d);
+	sort(files.begin(), files.end());
+	return files;
+}
+
+static vector<BYTE> readFile(const string& path)
+{
+	vector<BYTE> data;
+	FILE* f = fopen(path.c_str(), "rb");
+	if(f == NULL)
+		return data;
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if(size > 0){
+		data.resize((size_t)size);
+		if(fread(&data[0], 1, data.size(), f) != data.size())
+			data.clear();
+	}
+	fclose(f);
+	return data;
+}
+
+static string baseName(const string& path)
+{
+	size_t slash = path.find_last_of("/\\");
+	return (slash == string::npos) ? path : path.substr(slash + 1);
+}
+
+/**
+ * @fn	static void benchConversions()
+ *
+ * @brief	The load-time integer to float converters and the float to integer ones used when writing, for each
+ * 			kernel this machine has.
+ *
+ * @date	10/17/2026
+ */
+static void benchConversions()
+{
+	const UINT32 count = 65536;
+	vector<BYTE> in(count * 4);
+	for(size_t i = 0; i < in.size(); ++i){
+		in[i] = (BYTE)(i * 7919);
+	}
+	vector<FLOAT32> f(count);
+	for(UINT32 i = 0; i < count; ++i){
+		f[i] = sinf(i * 0.01f) * 0.9f;
+	}
+	vector<BYTE> out(count * 4);
+
+	for(int k = MIX_KERNEL_SCALAR; k <= MIX_KERNEL_AVX2; ++k){
+		MIX_KERNEL kernel = (MIX_KERNEL)k;
+		if(!isMixKernelAvailable(kernel))
+			continue;
+		string kn = kernelName(kernel);
+		bench("convert/u8_to_float/" + kn, "sample", [&]{ convertToFloat(SAMPLE_FORMAT_U8, &in[0], &f[0], count, kernel); return (UINT64)count; });
+		bench("convert/s16_to_float/" + kn, "sample", [&]{ convertToFloat(SAMPLE_FORMAT_S16, &in[0], &f[0], count, kernel); return (UINT64)count; });
+		bench("convert/s24_to_float/" + kn, "sample", [&]{ convertToFloat(SAMPLE_FORMAT_S24, &in[0], &f[0], count, kernel); return (UINT64)count; });
+		for(UINT32 i = 0; i < count; ++i){
+			f[i] = sinf(i * 0.01f) * 0.9f;
+		}
+		bench("convert/float_to_u8/" + kn, "sample", [&]{ convertFromFloat(SAMPLE_FORMAT_U8, &f[0], &out[0], count, kernel); return (UINT64)count; });
+		bench("convert/float_to_s16/" + kn, "sample", [&]{ convertFromFloat(SAMPLE_FORMAT_S16, &f[0], &out[0], count, kernel); return (UINT64)count; });
+		bench("convert/float_to_s24/" + kn, "sample", [&]{ convertFromFloat(SAMPLE_FORMAT_S24, &f[0], &out[0], count, kernel); return (UINT64)count; });
+	}
+}
+
+/**
+ * @fn	static void benchWavFiles()
+ *
+ * @brief	Parsing each file in the WAV directory from memory (the header walk alone), then getting each
+ * 			file's samples in memory the old way, read into a buffer of their own, against mapping the file
+ * 			with MappedWaveFile and touching every page of it as a voice playing it would. Both are per byte
+ * 			of sample data, so 1000 / ns is MB/s, and the files are in the page cache. Then loading the
+ * 			whole set into float assets on 1, 2, 4 and 8 loader threads the way createSoundAsync() does,
+ * 			through one PcmAssetCache that they all share, new for each run so that every file is a miss.
+ *
+ * @date	10/17/2026
+ */
+static void benchWavFiles()
+{
+	vector<string> files = listWavs(options.wavDir);
+	if(files.empty()){
+		fprintf(stderr, "no WAV files in %s, skipping the file benchmarks\n", options.wavDir.c_str());
+		return;
+	}
+
+	for(size_t i = 0; i < files.size(); ++i){
+		vector<BYTE> image = readFile(files[i]);
+		if(image.empty())
+			continue;
+		bench("wav_parse/" + baseName(files[i]), "file", [&]{
+			MappedWaveFile wf;
+			if(FAILED(wf.openFromMemory(&image[0], image.size())))
+				return (UINT64)0;
+			sink = (FLOAT32)wf.getSize();
+			return (UINT64)1;
+		});
+	}
+
+	for(size_t i = 0; i < files.size(); ++i){
+		const string& path = files[i];
+		bench("wav_load/read_copy/" + baseName(path), "byte", [&]{
+			vector<BYTE> image = readFile(path);
+			MappedWaveFile wf;
+			if(image.empty() || FAILED(wf.openFromMemory(&image[0], image.size())))
+				return (UINT64)0;
+			sink = (FLOAT32)wf.getData()[wf.getSize() - 1];
+			return (UINT64)wf.getSize();
+		});
+		bench("wav_load/mapped/" + baseName(path), "byte", [&]{
+			MappedWaveFile wf;
+			if(FAILED(wf.open(path.c_str())) || wf.getSize() == 0)
+				return (UINT64)0;
+			const BYTE* p = wf.getData();
+			UINT32 sum = 0;
+			for(DWORD b = 0; b < wf.getSize(); b += 4096){
+				sum += p[b];
+			}
+			sink = (FLOAT32)sum;
+			return (UINT64)wf.getSize();
+		});
+	}
+
+	const UINT32 threadCounts[] = { 1, 2, 4, 8 };
+	for(size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); ++t){
+		WorkerPool pool;
+		pool.start(threadCounts[t]);
+		char name[64];
+		sprintf(name, "wav_load/threads:%u", threadCounts[t]);
+		bench(name, "file", [&]{
+			PcmAssetCache cache;
+			PcmAssetCache* pCache = &cache;
+			vector<PcmAsset*> assets(files.size(), (PcmAsset*)NULL);
+			for(size_t i = 0; i < files.size(); ++i){
+				PcmAsset** ppAsset = &assets[i];
+				const string* pPath = &files[i];
+				pool.submit([pCache, ppAsset, pPath]{ pCache->acquire(pPath->c_str(), ppAsset); });
+			}
+			pool.wait();
+			UINT64 loaded = 0;
+			for(size_t i = 0; i < assets.size(); ++i){
+				if(assets[i] != NULL){
+					loaded++;
+					assets[i]->Release();
+				}
+			}
+			return loaded;
+		});
+	}
+}
+
+/**
+ * @fn	static vector<INT16> loadAdpcmSource(UINT32* pChannels, UINT32* pRate)
+ *
+ * @brief	The signal the ADPCM benchmarks encode: heli.wav, a long loop of the kind compression is for, or
+ * 			ten seconds of noisy tone if it isn't there or isn't 16 bit.
+ *
+ * @date	10/17/2026
+ */
+static vector<INT16> loadAdpcmSource(UINT32* pChannels, UINT32* pRate)
+{
+	MappedWaveFile wf;
+	if(SUCCEEDED(wf.open((options.wavDir + "/heli.wav").c_str())) && getSampleFormat(wf.getFormat()) == SAMPLE_FORMAT_S16){
+		*pChannels = wf.getFormat()->nChannels;
+		*pRate = wf.getFormat()->nSamplesPerSec;
+		const INT16* p = (const INT16*)wf.getData();
+		return vector<INT16>(p, p + wf.getSize() / 2);
+	}
+	*pChannels = 1;
+	*pRate = 44100;
+	vector<INT16> pcm(*pRate * 10);
+	for(size_t i = 0; i < pcm.size(); ++i){
+		pcm[i] = (INT16)(12000.0f * sinf(i * 0.031f) + (FLOAT32)(rand() % 2001 - 1000));
+	}
+	return pcm;
+}
+
+/**
+ * @fn	static bool writeWav(const string& path, const BYTE* pFormat, UINT32 formatBytes, const BYTE* pData,
+ * 		UINT32 dataBytes)
+ *
+ * @brief	Writes a minimal RIFF WAVE file.
+ *
+ * @date	10/17/2026
+ */
+static bool writeWav(const string& path, const BYTE* pFormat, UINT32 formatBytes, const BYTE* pData, UINT32 dataBytes)
+{
+	FILE* f = fopen(path.c_str(), "wb");
+	if(f == NULL)
+		return false;
+	UINT32 riffBytes = 4 + 8 + formatBytes + 8 + dataBytes + (dataBytes & 1);
+	fwrite("RIFF", 1, 4, f);
+	fwrite(&riffBytes, 4, 1, f);
+	fwrite("WAVEfmt ", 1, 8, f);
+	fwrite(&formatBytes, 4, 1, f);
+	fwrite(pFormat, 1, formatBytes, f);
+	fwrite("data", 1, 4, f);
+	fwrite(&dataBytes, 4, 1, f);
+	fwrite(pData, 1, dataBytes, f);
+	if(dataBytes & 1)
+		fputc(0, f);
+	bool ok = (ferror(f) == 0);
+	fclose(f);
+	return ok;
+}
+
+/**
+ * @fn	static void benchAdpcm()
+ *
+ * @brief	ADPCM block decoding for each kernel, then the two ways of playing a compressed asset: decoded to
+ * 			float once when it is loaded (PcmAsset), or kept compressed and decoded a bufferful at a time as
+ * 			it streams (WavStreamReader::openMemory()). The memory each way needs is recorded alongside.
+ *
+ * @date	10/17/2026
+ */
+static void benchAdpcm()
+{
+	UINT32 channels, rate;
+	vector<INT16> pcm = loadAdpcmSource(&channels, &rate);
+	UINT32 frames = (UINT32)(pcm.size() / channels);
+	const ADPCM_TYPE types[] = { ADPCM_TYPE_IMA, ADPCM_TYPE_MS };
+	const char* typeNames[] = { "ima", "ms" };
+
+	for(int t = 0; t < 2; ++t){
+		BYTE format[ADPCM_FORMAT_BYTES];
+		UINT32 formatBytes = makeAdpcmFormat(types[t], channels, rate, 512 * channels, format);
+		AdpcmFormat adpcm;
+		if(formatBytes == 0 || FAILED(getAdpcmFormat((const WAVEFORMATEX*)format, &adpcm)))
+			continue;
+		vector<BYTE> encoded((size_t)getAdpcmEncodedBytes(&adpcm, frames));
+		UINT32 encodedBytes = encodeAdpcm(&adpcm, &pcm[0], frames, &encoded[0]);
+		UINT32 decodedFrames = (UINT32)getAdpcmFrames(&adpcm, encodedBytes);
+		vector<INT16> decoded((size_t)decodedFrames * channels);
+		string tn = typeNames[t];
+
+		for(int k = MIX_KERNEL_SCALAR; k <= MIX_KERNEL_AVX2; ++k){
+			MIX_KERNEL kernel = (MIX_KERNEL)k;
+			if(!isMixKernelAvailable(kernel))
+				continue;
+			bench("adpcm/decode_" + tn + "/" + kernelName(kernel), "frame", [&]{
+				UINT32 n = decodeAdpcm(&adpcm, &encoded[0], encodedBytes, &decoded[0], kernel);
+				sink = decoded[n / 2];
+				return (UINT64)n;
+			});
+		}
+
+		char path[] = "/tmp/AudioBenchmarksXXXXXX";
+		int fd = mkstemp(path);
+		if(fd < 0)
+			continue;
+		close(fd);
+		bool loaded = writeWav(path, format, formatBytes, &encoded[0], encodedBytes) &&
+			bench("adpcm/load_decoded/" + tn, "frame", [&]{
+				PcmAsset* pAsset;
+				if(FAILED(PcmAsset::create(path, &pAsset)))
+					return (UINT64)0;
+				sink = (FLOAT32)pAsset->getSize();
+				pAsset->Release();
+				return (UINT64)decodedFrames;
+			});
+		unlink(path);
+
+		WavStreamReader reader;
+		UINT64 ringBytes = 0;
+		bool streamed = bench("adpcm/stream_decoded/" + tn, "frame", [&]{
+			if(FAILED(reader.openMemory((const WAVEFORMATEX*)format, &encoded[0], encodedBytes,
+				WavStreamReader::getMemoryBufferBytes((const WAVEFORMATEX*)format), STREAMING_BUFFER_COUNT, 0)))
+				return (UINT64)0;
+			ringBytes = (UINT64)reader.getBufferBytes() * reader.getBufferCount();
+			reader.start();
+			UINT64 bytes = 0;
+			StreamBlock* block;
+			while((block = reader.acquire(1000)) != NULL){
+				bytes += block->bytes;
+				bool end = block->endOfStream;
+				reader.release(block);
+				if(end)
+					break;
+			}
+			reader.close();
+			return bytes / reader.getFormat()->nBlockAlign;
+		});
+
+		// only what was measured: a benchmark the filter left out has no ring to report
+		if(streamed){
+			addMemory("heli/" + tn + "/adpcm", encodedBytes);
+			addMemory("heli/" + tn + "/stream_ring", ringBytes);
+		}
+		if(loaded && t == 0){
+			addMemory("heli/pcm16", (UINT64)frames * channels * sizeof(INT16));
+			addMemory("heli/float", (UINT64)frames * channels * sizeof(FLOAT32));
+		}
+	}
+}
+
+/**
+ * @fn	static void benchStreaming()
+ *
+ * @brief	WavStreamReader's refill latency, from the consumer releasing a block to the reader thread having
+ * 			filled it again, over a whole pass of each file in the WAV directory with the default ring. The
+ * 			consumer releases each block as soon as it gets it, so this is the reader's wake up and read with
+ * 			the file in the page cache: the average over a pass and the worst refill of the pass, per refill.
+ *
+ * @date	10/17/2026
+ */
+static void benchStreaming()
+{
+	vector<string> files = listWavs(options.wavDir);
+	for(size_t i = 0; i < files.size(); ++i){
+		string averageName = "stream/refill_latency/" + baseName(files[i]);
+		string worstName = "stream/refill_latency_max/" + baseName(files[i]);
+		bool average = selected(averageName);
+		bool worst = selected(worstName);
+		if(!average && !worst)
+			continue;
+
+		vector<double> averages;
+		vector<double> worsts;
+		UINT64 refills = 0;
+		for(UINT32 r = 0; r < options.reps; ++r){
+			WavStreamReader reader;
+			if(FAILED(reader.open(files[i].c_str(), STREAMING_BUFFER_BYTES, STREAMING_BUFFER_COUNT, 0)) || FAILED(reader.start()))
+				break;
+			StreamBlock* block;
+			while((block = reader.acquire(1000)) != NULL){
+				bool end = block->endOfStream;
+				reader.release(block);
+				if(end)
+					break;
+			}
+			StreamStats stats;
+			reader.getStats(&stats);
+			reader.close();
+			if(stats.refills == 0)
+				break;
+			averages.push_back(stats.avgRefillMicros * 1000.0);
+			worsts.push_back(stats.maxRefillMicros * 1000.0);
+			refills += stats.refills;
+		}
+		if(averages.size() < options.reps){
+			fprintf(stderr, "%-44s skipped\n", averageName.c_str());
+			continue;
+		}
+		if(average)
+			addResult(averageName, "refill", averages, refills);
+		if(worst)
+			addResult(worstName, "refill", worsts, refills);
+	}
+}
+
+/**
+ * @fn	static void benchWavWriter()
+ *
+ * @brief	WaveFileWriter's throughput writing 16MB of stereo float in 10ms blocks, as the offline engine hands
+ * 			it a rendered quantum at a time, with the staging buffer flushed on the caller's thread and on the
+ * 			flush thread. Per byte, so 1000 / ns is MB/s; the file goes to the page cache, not the disk.
+ *
+ * @date	10/17/2026
+ */
+static void benchWavWriter()
+{
+	const UINT32 blockFrames = 480;
+	const UINT32 totalBytes = 16 << 20;
+	WAVEFORMATEX wfx = { WAVE_FORMAT_IEEE_FLOAT, 2, 48000, 48000 * 8, 8, 32, 0 };
+	vector<FLOAT32> block(blockFrames * 2);
+	for(size_t i = 0; i < block.size(); ++i){
+		block[i] = sinf(i * 0.02f) * 0.5f;
+	}
+	const UINT32 blockBytes = (UINT32)(block.size() * sizeof(FLOAT32));
+
+	char path[] = "/tmp/AudioBenchmarksXXXXXX";
+	int fd = mkstemp(path);
+	if(fd < 0)
+		return;
+	close(fd);
+	for(int background = 0; background < 2; ++background){
+		bench(background ? "wav_write/background_flush" : "wav_write/foreground_flush", "byte", [&]{
+			WaveFileWriter writer;
+			if(FAILED(writer.open(path, &wfx, background != 0)))
+				return (UINT64)0;
+			UINT64 written = 0;
+			while(written < totalBytes){
+				UINT32 wrote;
+				if(FAILED(writer.write((const BYTE*)&block[0], blockBytes, &wrote)))
+					return (UINT64)0;
+				written += wrote;
+			}
+			if(FAILED(writer.close()))
+				return (UINT64)0;
+			return written;
+		});
+	}
+	unlink(path);
+}
+
+/**
+ * @fn	static void benchSoundBank()
+ *
+ * @brief	Startup with many small sounds: making an asset from each of 256 loose WAV files (an open, a map
+ * 			and a RIFF walk apiece) against opening one bank holding them all and finding each by name. The
+ * 			assets are left unconverted so only the file handling is timed, and the files are in the page
+ * 			cache, so a cold start from disk only widens the gap. Then the lookup alone.
+ *
+ * @date	10/17/2026
+ */
+static void benchSoundBank()
+{
+	const UINT32 count = 256;
+	char dir[] = "/tmp/AudioBenchmarksXXXXXX";
+	if(mkdtemp(dir) == NULL)
+		return;
+	string root = dir;
+	mkdir((root + "/sfx").c_str(), 0755);
+
+	WAVEFORMATEX wfx;
+	memset(&wfx, 0, sizeof(wfx));
+	wfx.wFormatTag = WAVE_FORMAT_PCM;
+	wfx.nChannels = 1;
+	wfx.nSamplesPerSec = 22050;
+	wfx.wBitsPerSample = 16;
+	wfx.nBlockAlign = 2;
+	wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
+	vector<INT16> clip(wfx.nSamplesPerSec / 10);
+	for(size_t i = 0; i < clip.size(); ++i){
+		clip[i] = (INT16)(8000.0f * sinf(i * 0.05f));
+	}
+
+	vector<string> names;
+	vector<string> paths;
+	vector<SoundBankSource> sources;
+	for(UINT32 i = 0; i < count; ++i){
+		char name[32];
+		sprintf(name, "sfx/sound_%03u.wav", i);
+		names.push_back(name);
+		paths.push_back(root + "/" + name);
+		SoundBankSource source;
+		source.name = name;
+		source.pFormat = &wfx;
+		source.pData = (const BYTE*)&clip[0];
+		source.dataBytes = (UINT32)(clip.size() * sizeof(INT16));
+		source.factFrames = 0;
+		sources.push_back(source);
+	}
+	bool ready = true;
+	for(UINT32 i = 0; i < count && ready; ++i){
+		ready = writeWav(paths[i], (const BYTE*)&wfx, 16, (const BYTE*)&clip[0], (UINT32)(clip.size() * sizeof(INT16)));
+	}
+	string bankPath = root + "/sounds.bank";
+	ready = ready && SUCCEEDED(writeSoundBank(bankPath.c_str(), sources));
+
+	vector<PcmAsset*> assets(count, (PcmAsset*)NULL);
+	if(ready){
+		bench("startup/loose_files:256", "sound", [&]{
+			UINT64 loaded = 0;
+			for(UINT32 i = 0; i < count; ++i){
+				if(SUCCEEDED(PcmAsset::create(paths[i].c_str(), &assets[i], false)))
+					loaded++;
+			}
+			for(UINT32 i = 0; i < count; ++i){
+				SAFE_RELEASE(assets[i]);
+			}
+			return loaded;
+		});
+		bench("startup/bank:256", "sound", [&]{
+			SoundBank* pBank;
+			if(FAILED(SoundBank::open(bankPath.c_str(), &pBank)))
+				return (UINT64)0;
+			UINT64 loaded = 0;
+			for(UINT32 i = 0; i < count; ++i){
+				INT32 index = pBank->find(names[i].c_str());
+				if(index >= 0 && SUCCEEDED(PcmAsset::create(pBank, (UINT32)index, &assets[i], false)))
+					loaded++;
+			}
+			pBank->Release();
+			for(UINT32 i = 0; i < count; ++i){
+				SAFE_RELEASE(assets[i]);
+			}
+			return loaded;
+		});
+
+		SoundBank* pBank;
+		if(SUCCEEDED(SoundBank::open(bankPath.c_str(), &pBank))){
+			bench("bank/find", "lookup", [&]{
+				INT32 found = 0;
+				for(UINT32 i = 0; i < count; ++i){
+					found += pBank->find(names[i].c_str());
+				}
+				sink = (FLOAT32)found;
+				return (UINT64)count;
+			});
+			pBank->Release();
+		}
+	}
+
+	for(UINT32 i = 0; i < count; ++i){
+		unlink(paths[i].c_str());
+	}
+	unlink(bankPath.c_str());
+	rmdir((root + "/sfx").c_str());
+	rmdir(dir);
+}
+
+/**
+ * @fn	static void benchLookups()
+ *
+ * @brief	Resolving a sound name through SOUND_MAP as BasicAudio::getHandle() does, which builds a wstring
+ * 			from the name, against resolving a handle through SoundHandleTable.
+ *
+ * @date	10/17/2026
+ */
+static void benchLookups()
+{
+	const UINT32 count = 1000;
+	SOUND_MAP soundMap;
+	SoundHandleTable<UINT32> table;
+	vector<wstring> names;
+	vector<SOUND_HANDLE> handles;
+	for(UINT32 i = 0; i < count; ++i){
+		wchar_t name[32];
+		swprintf(name, 32, L"sound_%u", i * 2654435761u);
+		names.push_back(name);
+		SOUND_HANDLE h = table.add(i);
+		handles.push_back(h);
+		soundMap[name] = h;
+	}
+
+	bench("lookup/sound_map", "lookup", [&]{
+		SOUND_HANDLE sum = 0;
+		for(UINT32 i = 0; i < count; ++i){
+			const wchar_t* soundName = names[(i * 7) % count].c_str();
+			SOUND_MAP::const_iterator got = soundMap.find(soundName);
+			if(got != soundMap.end())
+				sum += got->second;
+		}
+		sink = (FLOAT32)sum;
+		return (UINT64)count;
+	});
+	bench("lookup/handle_table", "lookup", [&]{
+		UINT32 sum = 0;
+		for(UINT32 i = 0; i < count; ++i){
+			sum += table.get(handles[(i * 7) % count]);
+		}
+		sink = (FLOAT32)sum;
+		return (UINT64)count;
+	});
+}
+
+/**
+ * @fn	static void benchMatrix()
+ *
+ * @brief	setSingleMatrixVal(), the matrix setup behind playOnChannelVoice(), for stereo, 5.1 and 7.1.
+ *
+ * @date	10/17/2026
+ */
+static void benchMatrix()
+{
+	const int channelCounts[] = { 2, 6, 8 };
+	for(size_t c = 0; c < sizeof(channelCounts) / sizeof(channelCounts[0]); ++c){
+		int channels = channelCounts[c];
+		char name[64];
+		sprintf(name, "matrix/set_single/%dch", channels);
+		bench(name, "call", [channels]{
+			FLOAT32 mat[8];
+			const UINT32 calls = 4096;
+			for(UINT32 i = 0; i < calls; ++i){
+				setSingleMatrixVal(mat, channels, i % channels, 1.0f, 0.0f);
+				sink = mat[0];
+			}
+			return (UINT64)calls;
+		});
+	}
+}
+
+static void fillEmitters(EmitterSoA* e, UINT32 count)
+{
+	e->setMatrixSize(1, 2);
+	for(UINT32 i = 0; i < count; ++i){
+		UINT32 k = e->add(i + 1);
+		e->posX[k] = (FLOAT32)((i * 37) % 61) - 30.0f;
+		e->posY[k] = (FLOAT32)((i * 11) % 7) - 3.0f;
+		e->posZ[k] = (FLOAT32)((i * 53) % 59) - 29.0f;
+		e->velX[k] = (FLOAT32)(i % 9) - 4.0f;
+		e->velZ[k] = (FLOAT32)(i % 5) - 2.0f;
+		e->curveDistanceScaler[k] = 14.0f;
+		e->dopplerScaler[k] = 1.0f;
+		e->innerRadius[k] = 2.0f;
+		e->innerRadiusAngle[k] = 0.785f;
+		e->spatialized[k] = 1;
+	}
+}
+
+/**
+ * @fn	static void benchSpatial()
+ *
+ * @brief	The spatializer over 1024 moving emitters with each kernel and with 1 to 8 channel emitters on 5.1
+ * 			speakers, the compute and commit pass of BasicAudio::update3D() over 16384 emitters on 1, 2, 4...
+ * 			up to one thread per core, committing the results alone, and VoiceVirtualizer's audibility estimate
+ * 			over 5000 emitters.
+ *
+ * @date	10/17/2026
+ */
+static void benchSpatial()
+{
+	const UINT32 count = 1024;
+	const SPATIALIZER_KERNEL kernels[] = { SPATIALIZER_KERNEL_SCALAR, SPATIALIZER_KERNEL_SSE, SPATIALIZER_KERNEL_AVX };
+	const char* names[] = { "scalar", "sse", "avx" };
+	for(int k = 0; k < 3; ++k){
+		Spatializer sp;
+		if(!sp.setKernel(kernels[k]))
+			continue;
+		EmitterSoA e;
+		fillEmitters(&e, count);
+		bench(string("spatializer/process/") + names[k], "emitter", [&]{
+			e.markAllDirty(EmitterSoA::EMITTER_DIRTY_INPUT);
+			sp.process(&e);
+			sink = e.doppler[0];
+			return (UINT64)count;
+		});
+	}
+
+	// multichannel emitters panned onto 5.1: the fixed counts have their own pan<>, 8 takes the general one
+	const UINT32 channelCounts[] = { 1, 2, 6, 8 };
+	for(int c = 0; c < 4; ++c){
+		UINT32 channels = channelCounts[c];
+		FLOAT32 azimuths[EMITTER_MAX_CHANNELS];
+		for(UINT32 a = 0; a < channels; ++a){
+			azimuths[a] = (channels == 6 && a == 3) ? EMITTER_LFE_AZIMUTH : 6.2831853f * a / channels;
+		}
+		Spatializer sp;
+		sp.setSpeakers(0x3F, 6);
+		EmitterSoA e;
+		fillEmitters(&e, count);
+		for(UINT32 i = 0; i < count; ++i){
+			e.setChannels(i, channels, 1.0f, azimuths);
+		}
+		char name[64];
+		sprintf(name, "spatializer/process_5.1/channels:%u", channels);
+		bench(name, "emitter", [&]{
+			e.markAllDirty(EmitterSoA::EMITTER_DIRTY_INPUT);
+			sp.process(&e);
+			sink = e.getMatrix(0)[0];
+			return (UINT64)count;
+		});
+	}
+
+	// update3D()'s compute and commit pass split over 1 to N threads (the caller plus N - 1 workers)
+	const UINT32 bigCount = 16384;
+	vector<UINT32> threadCounts;
+	for(UINT32 threads = 1; threads < WorkerPool::getDefaultThreadCount(); threads *= 2){
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(WorkerPool::getDefaultThreadCount());
+	for(size_t t = 0; t < threadCounts.size(); ++t){
+		UINT32 threads = threadCounts[t];
+		Spatializer sp;
+		EmitterSoA e;
+		fillEmitters(&e, bigCount);
+		WorkerPool pool;
+		if(threads > 1)
+			pool.start(threads - 1);
+		UINT32 frame = 0;
+		char name[64];
+		sprintf(name, "spatial/update_parallel/threads:%u", threads);
+		bench(name, "emitter", [&]{
+			// the listener moves every frame, so every emitter is recomputed
+			frame++;
+			SpatialListener l = { { (FLOAT32)(frame & 7), 0, 0 }, { 0, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } };
+			sp.setListener(l);
+			e.markAllDirty(EmitterSoA::EMITTER_DIRTY_INPUT);
+			sp.prepare(&e);
+			pool.parallelFor(bigCount, SPATIALIZER_TASK_GRAIN, [&](UINT32 begin, UINT32 end){
+				sp.processRange(&e, begin, end);
+				for(UINT32 i = begin; i < end; ++i){
+					e.commit(i, EMITTER_MATRIX_EPSILON);
+				}
+			});
+			sink = e.doppler[0];
+			return (UINT64)bigCount;
+		});
+	}
+
+	// what BasicAudio works out every run() to choose which virtual sounds get a voice
+	const UINT32 virtualCount = 5000;
+	for(int k = 0; k < 2; ++k){
+		Spatializer sp;
+		sp.setKernel(kernels[k]);
+		EmitterSoA e;
+		fillEmitters(&e, virtualCount);
+		bench(string("spatializer/audibility/") + names[k], "emitter", [&]{
+			sp.estimateAudibility(&e);
+			sink = e.audibility[0];
+			return (UINT64)virtualCount;
+		});
+	}
+
+	Spatializer sp;
+	EmitterSoA e;
+	fillEmitters(&e, count);
+	sp.process(&e);
+	UINT32 frame = 0;
+	bench("spatializer/commit", "emitter", [&]{
+		// nudge every emitter's result so that each commit has something to copy
+		frame++;
+		for(UINT32 i = 0; i < count; ++i){
+			e.getMatrix(i)[0] += (frame & 1) ? 0.01f : -0.01f;
+		}
+		UINT32 changed = 0;
+		for(UINT32 i = 0; i < count; ++i){
+			changed += e.commit(i, EMITTER_MATRIX_EPSILON) ? 1 : 0;
+		}
+		sink = (FLOAT32)changed;
+		return (UINT64)count;
+	});
+}
+
+/**
+ * @fn	static void benchMixing()
+ *
+ * @brief	The mixing kernels: a mono source into stereo, 5.1 and 7.1 buses, and scaling and 16 bit conversion
+ * 			of the mixed bus.
+ *
+ * @date	10/17/2026
+ */
+static void benchMixing()
+{
+	const UINT32 frames = 4800;
+	vector<FLOAT32> in(frames);
+	for(UINT32 i = 0; i < frames; ++i){
+		in[i] = sinf(i * 0.05f) * 0.5f;
+	}
+	vector<FLOAT32> bus(frames * 8, 0.0f);
+	vector<INT16> pcm(frames * 8);
+	const FLOAT32 gains[8] = { 0.7f, 0.5f, 0.3f, 0.1f, 0.2f, 0.4f, 0.6f, 0.8f };
+
+	for(int k = MIX_KERNEL_SCALAR; k <= MIX_KERNEL_AVX2; ++k){
+		if(!isMixKernelAvailable((MIX_KERNEL)k))
+			continue;
+		const MixKernels* pKernels = getMixKernels((MIX_KERNEL)k);
+		string kn = kernelName((MIX_KERNEL)k);
+		const UINT32 busChannels[] = { 2, 6, 8 };
+		for(size_t c = 0; c < 3; ++c){
+			UINT32 channels = busChannels[c];
+			char name[64];
+			sprintf(name, "mixer/mix_channel/%s/%uch", kn.c_str(), channels);
+			bench(name, "frame", [&, channels]{
+				pKernels->mixChannel(&in[0], 1, &bus[0], frames, channels, gains);
+				pKernels->scale(&bus[0], frames * channels, 0.5f); // keep the bus from growing without bound
+				return (UINT64)frames;
+			});
+		}
+		bench("mixer/to_pcm16/" + kn, "sample", [&]{
+			pKernels->toPCM16(&bus[0], &pcm[0], frames * 2);
+			return (UINT64)(frames * 2);
+		});
+	}
+}
+
+/**
+ * @fn	static void benchResampler()
+ *
+ * @brief	Converting a stereo 44.1kHz stream to 48kHz at each quality, in 10ms blocks.
+ *
+ * @date	10/17/2026
+ */
+static void benchResampler()
+{
+	const RESAMPLER_QUALITY qualities[] = { RESAMPLER_QUALITY_LINEAR, RESAMPLER_QUALITY_SINC8, RESAMPLER_QUALITY_SINC32 };
+	const char* names[] = { "linear", "sinc8", "sinc32" };
+	const UINT32 block = 480;
+	const double step = 44100.0 / 48000.0;
+	vector<FLOAT32> in(2048 * 2);
+	for(size_t i = 0; i < in.size(); ++i){
+		in[i] = sinf(i * 0.01f) * 0.5f;
+	}
+	vector<FLOAT32> out(block * 2);
+
+	for(int q = 0; q < 3; ++q){
+		Resampler rs;
+		rs.init(2, qualities[q]);
+		bench(string("resampler/") + names[q], "frame", [&]{
+			UINT64 frames = 0;
+			for(int b = 0; b < 10; ++b){
+				UINT32 need = rs.getInputNeeded(block, step, step);
+				rs.push(&in[0], min(need, (UINT32)2048));
+				frames += rs.pull(&out[0], block, step, step);
+			}
+			sink = out[0];
+			return frames;
+		});
+	}
+}
+
+/**
+ * @fn	static void benchOfflineRender()
+ *
+ * @brief	The offline engine's mix: looping mono 44.1kHz voices, each with its own output matrix, rendered to
+ * 			a 48kHz bus in 10ms quanta, as renderOffline() does. 8 and 64 voices to stereo, then 64, 256 and
+ * 			1024 voices to 7.1, where the per-voice resampling and the 8 channel accumulate dominate.
+ *
+ * @date	10/17/2026
+ */
+static void benchOfflineRender()
+{
+	struct Scene { UINT32 voices, channels; };
+	const Scene scenes[] = { { 8, 2 }, { 64, 2 }, { 64, 8 }, { 256, 8 }, { 1024, 8 } };
+	vector<FLOAT32> source(44100);
+	for(size_t i = 0; i < source.size(); ++i){
+		source[i] = sinf(i * 0.03f) * 0.25f;
+	}
+	WAVEFORMATEX wfx = { WAVE_FORMAT_IEEE_FLOAT, 1, 44100, 44100 * 4, 4, 32, 0 };
+	MixerBuffer buffer = { 0, (UINT32)(source.size() * 4), (const BYTE*)&source[0], 0, 0, 0, 0, MIXER_LOOP_INFINITE, NULL };
+
+	for(size_t v = 0; v < sizeof(scenes) / sizeof(scenes[0]); ++v){
+		UINT32 channels = scenes[v].channels;
+		char name[64];
+		if(channels == 2)
+			sprintf(name, "offline_render/voices:%u", scenes[v].voices);
+		else
+			sprintf(name, "offline_render/voices:%u/%uch", scenes[v].voices, channels);
+		if(!selected(name))
+			continue;
+
+		SoftwareMixer mixer;
+		mixer.init(48000, channels);
+		vector<MixerVoice*> voices;
+		for(UINT32 i = 0; i < scenes[v].voices; ++i){
+			MixerVoice* pVoice;
+			if(FAILED(mixer.createVoice(&wfx, 2.0f, NULL, &pVoice)))
+				continue;
+			// each voice between two neighbouring speakers, as a panned sound would be
+			FLOAT32 levels[MIXER_MAX_CHANNELS] = { 0 };
+			FLOAT32 pan = (i % 4) * 0.25f;
+			levels[i % channels] = pan;
+			levels[(i + 1) % channels] = 1.0f - pan;
+			pVoice->setOutputMatrix(1, channels, levels);
+			pVoice->setFrequencyRatio(1.0f + (i % 5) * 0.01f);
+			pVoice->submitBuffer(&buffer);
+			pVoice->start();
+			voices.push_back(pVoice);
+		}
+		UINT32 quantum = mixer.getQuantumFrames();
+		vector<FLOAT32> out(quantum * channels);
+		bench(name, "frame", [&]{
+			for(int q = 0; q < 10; ++q){
+				mixer.render(&out[0], quantum);
+			}
+			sink = out[0];
+			return (UINT64)(quantum * 10);
+		});
+		for(size_t i = 0; i < voices.size(); ++i){
+			mixer.destroyVoice(voices[i]);
+		}
+	}
+}
+
+/**
+ * @fn	static void benchBuses()
+ *
+ * @brief	Submix buses: fading 500 voices one SetVolume at a time against fading the bus they play through,
+ * 			and what routing 64 voices through a bus adds to the offline mix.
+ *
+ * @date	10/17/2026
+ */
+static void benchBuses()
+{
+	const UINT32 fadeVoices = 500;
+	vector<FLOAT32> source(44100);
+	for(size_t i = 0; i < source.size(); ++i){
+		source[i] = sinf(i * 0.03f) * 0.25f;
+	}
+	WAVEFORMATEX wfx = { WAVE_FORMAT_IEEE_FLOAT, 1, 44100, 44100 * 4, 4, 32, 0 };
+	MixerBuffer buffer = { 0, (UINT32)(source.size() * 4), (const BYTE*)&source[0], 0, 0, 0, 0, MIXER_LOOP_INFINITE, NULL };
+
+	SoftwareMixer mixer;
+	mixer.init(48000, 2);
+	MixerBus* pBus;
+	mixer.createBus(2, 0, &pBus);
+	vector<MixerVoice*> voices;
+	for(UINT32 i = 0; i < fadeVoices; ++i){
+		MixerVoice* pVoice;
+		if(FAILED(mixer.createVoice(&wfx, 2.0f, NULL, &pVoice)))
+			continue;
+		pVoice->setOutput(pBus);
+		voices.push_back(pVoice);
+	}
+	FLOAT32 level = 1.0f;
+	bench("bus/fade/per_voice:500", "fade", [&]{
+		level = level > 0.01f ? level * 0.99f : 1.0f;
+		for(size_t i = 0; i < voices.size(); ++i){
+			voices[i]->setVolume(level);
+		}
+		return (UINT64)1;
+	});
+	bench("bus/fade/bus:500", "fade", [&]{
+		level = level > 0.01f ? level * 0.99f : 1.0f;
+		pBus->setVolume(level);
+		return (UINT64)1;
+	});
+
+	// the mix itself, 64 of the voices playing, straight to the output and through the bus
+	for(int routed = 0; routed < 2; ++routed){
+		for(size_t i = 0; i < 64 && i < voices.size(); ++i){
+			voices[i]->setOutput(routed ? pBus : NULL);
+			voices[i]->setVolume(1.0f);
+			voices[i]->submitBuffer(&buffer);
+			voices[i]->start();
+		}
+		pBus->setVolume(1.0f);
+		UINT32 quantum = mixer.getQuantumFrames();
+		vector<FLOAT32> out(quantum * 2);
+		bench(routed ? "bus/render/voices:64/bus" : "bus/render/voices:64/direct", "frame", [&]{
+			for(int q = 0; q < 10; ++q){
+				mixer.render(&out[0], quantum);
+			}
+			sink = out[0];
+			return (UINT64)(quantum * 10);
+		});
+	}
+	for(size_t i = 0; i < voices.size(); ++i){
+		mixer.destroyVoice(voices[i]);
+	}
+	mixer.destroyBus(pBus);
+}
+
+/**
+ * @class	BenchSound
+ *
+ * @brief	Stands in for a SampleSound in the run() benchmarks, for the virtual call BasicAudio makes on it.
+ */
+class BenchSound
+{
+public:
+	BenchSound(void) : calls(0){};
+	virtual ~BenchSound(void){};
+	virtual void run(){calls++;};
+	virtual void onEvent(const SoundEvent& e){calls += e.type + 1;};
+
+	UINT32 calls;
+};
+
+/**
+ * @fn	static void benchRunPath()
+ *
+ * @brief	What BasicAudio::run() costs against the number of sounds loaded: the old run(), which called run()
+ * 			on every sound to find the finished ones, against dispatching the 16 voice events of a busy frame
+ * 			through the event ring, for 100 to 10000 sounds. Only the loop is timed, not the GetState() each
+ * 			old SampleSound::run() made, so the real gap is wider. Then the cost per posted command and per
+ * 			timed call: the command ring round trip and a ScopedTimer.
+ *
+ * @date	10/17/2026
+ */
+static void benchRunPath()
+{
+	const UINT32 soundCounts[] = { 100, 1000, 10000 };
+	const UINT32 eventsPerRun = 16;
+	for(size_t c = 0; c < sizeof(soundCounts) / sizeof(soundCounts[0]); ++c){
+		UINT32 count = soundCounts[c];
+		vector<BenchSound> sounds(count);
+		SoundHandleTable<BenchSound*> table;
+		vector<SOUND_HANDLE> handles;
+		for(UINT32 i = 0; i < count; ++i){
+			handles.push_back(table.add(&sounds[i]));
+		}
+		CommandRing<SoundEvent> events;
+		events.init(SOUND_EVENT_QUEUE_SIZE);
+
+		char name[64];
+		sprintf(name, "run/poll_sounds/sounds:%u", count);
+		bench(name, "run", [&]{
+			for(UINT32 i = 0; i < table.getSlotCount(); ++i){
+				BenchSound* pSound = table.getSlot(i);
+				if(pSound != NULL)
+					pSound->run();
+			}
+			sink = (FLOAT32)sounds[0].calls;
+			return (UINT64)1;
+		});
+
+		UINT32 next = 0;
+		sprintf(name, "run/dispatch_events/sounds:%u", count);
+		bench(name, "run", [&]{
+			// the voices' callbacks queue the frame's events, then run() hands them out
+			for(UINT32 i = 0; i < eventsPerRun; ++i){
+				next = (next + 7919) % count;
+				SoundEvent e = { SOUND_EVENT_END, handles[next], S_OK };
+				events.push(e);
+			}
+			UINT32 depth = events.getDepth();
+			SoundEvent e;
+			for(UINT32 i = 0; i < depth && events.pop(&e); ++i){
+				BenchSound* pSound = table.get(e.handle);
+				if(pSound != NULL)
+					pSound->onEvent(e);
+			}
+			sink = (FLOAT32)sounds[next].calls;
+			return (UINT64)1;
+		});
+	}
+
+	CommandRing<AudioCommand> ring;
+	ring.init(AUDIO_COMMAND_QUEUE_SIZE);
+	bench("run/command_push_pop", "command", [&]{
+		const UINT32 count = 1024;
+		AudioCommand cmd = { AUDIO_COMMAND_SET_EMITTER_POS, 1, 0, 1.0f, 2.0f, 3.0f };
+		for(UINT32 i = 0; i < count; ++i){
+			cmd.handle = i;
+			ring.push(cmd);
+		}
+		FLOAT32 sum = 0;
+		while(ring.pop(&cmd)){
+			sum += cmd.x;
+		}
+		sink = sum;
+		return (UINT64)count;
+	});
+
+	EngineTimer timer;
+	bench("run/scoped_timer", "scope", [&]{
+		const UINT32 count = 1024;
+		for(UINT32 i = 0; i < count; ++i){
+			ScopedTimer t(&timer);
+		}
+		timer.endFrame();
+		return (UINT64)count;
+	});
+}
+
+static void discardLog(AUDIO_LOG_LEVEL /*level*/, const wchar_t* text, void* /*pContext*/)
+{
+	sink = (FLOAT32)text[0];
+}
+
+/**
+ * @fn	static void benchLogging()
+ *
+ * @brief	A log call below the runtime level, one that is kept (captured, then formatted and handed to the
+ * 			sink by flush(), as the drain thread would), and the formatting on its own.
+ *
+ * @date	10/17/2026
+ */
+static void benchLogging()
+{
+	AudioLog::setSink(discardLog, NULL);
+	AUDIO_LOG_LEVEL level = AudioLog::getLevel();
+
+	AudioLog::setLevel(AUDIO_LOG_LEVEL_ERROR);
+	bench("log/disabled", "call", []{
+		const UINT32 count = 4096;
+		for(UINT32 i = 0; i < count; ++i){
+			AUDIO_LOG_WARN(L"emitter pos = (%.2f, %.2f, %.2f)", (FLOAT32)i, 2.0f, 3.0f);
+		}
+		return (UINT64)count;
+	});
+
+	AudioLog::setLevel(AUDIO_LOG_LEVEL_WARN);
+	bench("log/enabled", "call", []{
+		const UINT32 count = 512;   // fits the ring, flush() then formats and empties it
+		for(UINT32 i = 0; i < count; ++i){
+			AUDIO_LOG_WARN(L"%s: emitter pos = (%.2f, %.2f, %.2f)", "heli", (FLOAT32)i, 2.0f, 3.0f);
+		}
+		AudioLog::flush();
+		return (UINT64)count;
+	});
+
+	AudioLogRecord record;
+	record.format = L"%s: emitter pos = (%.2f, %.2f, %.2f)";
+	record.level = AUDIO_LOG_LEVEL_WARN;
+	record.argCount = 0;
+	record.textUsed = 0;
+	record.addAll("heli", 1.0f, 2.0f, 3.0f);
+	bench("log/format", "record", [&]{
+		wchar_t line[512];
+		for(int i = 0; i < 64; ++i){
+			AudioLog::format(record, line, 512);
+		}
+		sink = (FLOAT32)line[0];
+		return (UINT64)64;
+	});
+
+	AudioLog::setLevel(level);
+	AudioLog::setSink(AudioLog::stderrSink, NULL);
+}
+
+/**
+ * @fn	static bool writeJson(FILE* f)
+ *
+ * @brief	Writes the results, one benchmark per line so that baselines diff well.
+ *
+ * @date	10/17/2026
+ */
+static bool writeJson(FILE* f)
+{
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"context\": {\"mix_kernel\": \"%s\", \"threads\": %u, \"reps\": %u, \"min_rep_ms\": %.1f},\n",
+		kernelName(getBestMixKernel()), WorkerPool::getDefaultThreadCount(), options.reps, options.minRepMs);
+	fprintf(f, "\t\"benchmarks\": [\n");
+	for(size_t i = 0; i < results.size(); ++i){
+		const BenchResult& r = results[i];
+		fprintf(f, "\t\t{\"name\": \"%s\", \"per\": \"%s\", \"median_ns\": %.4f, \"min_ns\": %.4f, \"max_ns\": %.4f, \"items\": %llu, \"reps\": %u}%s\n",
+			r.name.c_str(), r.per.c_str(), r.medianNs, r.minNs, r.maxNs, (unsigned long long)r.items, r.reps,
+			(i + 1 < results.size()) ? "," : "");
+	}
+	fprintf(f, "\t],\n");
+	fprintf(f, "\t\"memory\": [\n");
+	for(size_t i = 0; i < memory.size(); ++i){
+		fprintf(f, "\t\t{\"asset\": \"%s\", \"bytes\": %llu}%s\n", memory[i].asset.c_str(), (unsigned long long)memory[i].bytes,
+			(i + 1 < memory.size()) ? "," : "");
+	}
+	fprintf(f, "\t]\n}\n");
+	return ferror(f) == 0;
+}
+
+/**
+ * @fn	static bool readBaseline(const string& path, vector<BenchResult>* pBaseline)
+ *
+ * @brief	Reads the name and median of each benchmark back from a file written by writeJson(). This is not a
+ * 			general JSON parser, it only has to understand what this program writes.
+ *
+ * @date	10/17/2026
+ */
+static bool readBaseline(const string& path, vector<BenchResult>* pBaseline)
+{
+	vector<BYTE> data = readFile(path);
+	if(data.empty())
+		return false;
+	string text(data.begin(), data.end());
+
+	size_t pos = 0;
+	for(;;){
+		size_t nameKey = text.find("\"name\"", pos);
+		if(nameKey == string::npos)
+			break;
+		size_t open = text.find('"', text.find(':', nameKey) + 1);
+		size_t close = text.find('"', open + 1);
+		size_t medianKey = text.find("\"median_ns\"", close);
+		if(open == string::npos || close == string::npos || medianKey == string::npos)
+			break;
+		BenchResult br;
+		br.name = text.substr(open + 1, close - open - 1);
+		br.medianNs = atof(text.c_str() + text.find(':', medianKey) + 1);
+		pBaseline->push_back(br);
+		pos = medianKey;
+	}
+	return true;
+}
+
+/**
+ * @fn	static int compare(const vector<BenchResult>& baseline)
+ *
+ * @brief	Lists each benchmark's change against the baseline and flags the ones that got slower by more than
+ * 			the threshold.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The number of regressions.
+ */
+static int compare(const vector<BenchResult>& baseline)
+{
+	int regressions = 0;
+	fprintf(stderr, "\n%-44s %12s %12s %9s\n", "benchmark", "baseline", "now", "change");
+	for(size_t i = 0; i < results.size(); ++i){
+		const BenchResult& r = results[i];
+		const BenchResult* pBase = NULL;
+		for(size_t b = 0; b < baseline.size(); ++b){
+			if(baseline[b].name == r.name){
+				pBase = &baseline[b];
+				break;
+			}
+		}
+		if(pBase == NULL || pBase->medianNs <= 0){
+			fprintf(stderr, "%-44s %12s %12.3f %9s  new\n", r.name.c_str(), "-", r.medianNs, "-");
+			continue;
+		}
+		double change = (r.medianNs - pBase->medianNs) / pBase->medianNs * 100.0;
+		const char* verdict = "";
+		if(change > options.thresholdPercent){
+			verdict = "  REGRESSION";
+			regressions++;
+		}else if(change < -options.thresholdPercent){
+			verdict = "  improved";
+		}
+		fprintf(stderr, "%-44s %12.3f %12.3f %+8.1f%%%s\n", r.name.c_str(), pBase->medianNs, r.medianNs, change, verdict);
+	}
+	fprintf(stderr, "%d regression%s beyond %.1f%%\n", regressions, (regressions == 1) ? "" : "s", options.thresholdPercent);
+	return regressions;
+}
+
+static void usage()
+{
+	fprintf(stderr,
+		"usage: AudioBenchmarks [options]\n"
+		"  --filter TEXT     run only benchmarks whose name contains TEXT\n"
+		"  --list            list the benchmarks without running them\n"
+		"  --wavs DIR        WAV files for the file benchmarks (default Wavs)\n"
+		"  --out FILE        write the JSON results to FILE instead of stdout\n"
+		"  --compare FILE    compare against a saved run, exit 1 on a regression\n"
+		"  --threshold PCT   slowdown that counts as a regression (default 10)\n"
+		"  --reps N          timed repetitions per benchmark (default 7)\n"
+		"  --min-time MS     shortest repetition (default 20)\n");
+}
+
+int main(int argc, char* argv[])
+{
+	options.wavDir = "Wavs";
+	options.thresholdPercent = 10.0;
+	options.minRepMs = 20.0;
+	options.reps = 7;
+	options.list = false;
+
+	for(int i = 1; i < argc; ++i){
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if(arg == "--list"){
+			options.list = true;
+		}else if(arg == "--filter" && hasValue){
+			options.filter = argv[++i];
+		}else if(arg == "--wavs" && hasValue){
+			options.wavDir = argv[++i];
+		}else if(arg == "--out" && hasValue){
+			options.outFile = argv[++i];
+		}else if(arg == "--compare" && hasValue){
+			options.compareFile = argv[++i];
+		}else if(arg == "--threshold" && hasValue){
+			options.thresholdPercent = atof(argv[++i]);
+		}else if(arg == "--reps" && hasValue){
+			options.reps = max(1, atoi(argv[++i]));
+		}else if(arg == "--min-time" && hasValue){
+			options.minRepMs = max(0.1, atof(argv[++i]));
+		}else{
+			usage();
+			return 2;
+		}
+	}
+
+	vector<BenchResult> baseline;
+	if(!options.compareFile.empty() && !readBaseline(options.compareFile, &baseline)){
+		fprintf(stderr, "can't read baseline %s\n", options.compareFile.c_str());
+		return 2;
+	}
+
+	benchConversions();
+	benchWavFiles();
+	benchAdpcm();
+	benchStreaming();
+	benchWavWriter();
+	benchSoundBank();
+	benchLookups();
+	benchMatrix();
+	benchSpatial();
+	benchMixing();
+	benchResampler();
+	benchOfflineRender();
+	benchBuses();
+	benchRunPath();
+	benchLogging();
+	if(options.list)
+		return 0;
+
+	FILE* f = stdout;
+	if(!options.outFile.empty() && (f = fopen(options.outFile.c_str(), "w")) == NULL){
+		fprintf(stderr, "can't write %s\n", options.outFile.c_str());
+		return 2;
+	}
+	bool written = writeJson(f);
+	if(f != stdout)
+		fclose(f);
+	if(!written)
+		return 2;
+
+	if(!options.compareFile.empty())
+		return (compare(baseline) > 0) ? 1 : 0;
+	return 0;
+}
+
+/**
+// End of AudioBenchmarks.cpp
+ */
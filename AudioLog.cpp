@@ -0,0 +1,346 @@
+#include "AudioLog.h"
+#include <stdio.h>
+#include <math.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/**
+ * @struct	AudioLogState
+ *
+ * @brief	Everything behind AudioLog's static interface. The ring takes records from any thread, the rest is
+ * 			used by the drain thread and by start(), stop() and flush() under the lock.
+ */
+struct AudioLogState
+{
+	CommandRing<AudioLogRecord> ring;
+	mutex lock;             // start(), stop(), flush() and the drain thread's pass over the ring
+	condition_variable wake;
+	thread drain;
+	UINT32 users;           // start() calls without a matching stop()
+	bool quit;
+	AUDIO_LOG_SINK sink;
+	void* pSinkContext;
+
+	AudioLogState(){
+		ring.init(AUDIO_LOG_QUEUE_SIZE);
+		users = 0;
+		quit = false;
+		sink = AudioLog::stderrSink;
+		pSinkContext = NULL;
+	};
+
+	// Records still queued at exit are written out rather than lost
+	~AudioLogState(){
+		{
+			lock_guard<mutex> l(lock);
+			quit = true;
+		}
+		wake.notify_all();
+		if(drain.joinable())
+			drain.join();
+		lock_guard<mutex> l(lock);
+		drainRing();
+	};
+
+	void drainRing();
+	void drainLoop();
+};
+
+static AudioLogState& state()
+{
+	static AudioLogState s;
+	return s;
+}
+
+atomic<INT32> AudioLog::runtimeLevel(AUDIO_LOG_LEVEL_INFO);
+
+/**
+ * @fn	void AudioLogState::drainRing()
+ *
+ * @brief	Formats and sinks every queued record. Called with the lock held.
+ *
+ * @date	10/17/2026
+ */
+void AudioLogState::drainRing()
+{
+	AudioLogRecord r;
+	wchar_t line[512];
+	while(ring.pop(&r)){
+		AudioLog::format(r, line, sizeof(line) / sizeof(line[0]));
+		if(sink != NULL)
+			sink((AUDIO_LOG_LEVEL)r.level, line, pSinkContext);
+	}
+}
+
+/**
+ * @fn	void AudioLogState::drainLoop()
+ *
+ * @brief	Thread body. Producers never signal, so that logging stays lock-free; the thread looks at the ring
+ * 			every few milliseconds instead, or straight away when flush() or stop() asks.
+ *
+ * @date	10/17/2026
+ */
+void AudioLogState::drainLoop()
+{
+	unique_lock<mutex> l(lock);
+	while(!quit){
+		drainRing();
+		wake.wait_for(l, chrono::milliseconds(10));
+	}
+	drainRing();
+}
+
+/**
+ * @fn	void AudioLog::start()
+ *
+ * @brief	Starts the drain thread, or counts one more user of it if it is already running.
+ *
+ * @date	10/17/2026
+ */
+void AudioLog::start()
+{
+	AudioLogState& s = state();
+	lock_guard<mutex> l(s.lock);
+	if(s.users++ > 0)
+		return;
+	s.quit = false;
+	try{
+		s.drain = thread(&AudioLogState::drainLoop, &s);
+	}catch(...){
+		// no thread: records wait in the ring for flush() or exit
+	}
+}
+
+/**
+ * @fn	void AudioLog::stop()
+ *
+ * @brief	Undoes one start(). The last one writes out whatever is queued and joins the thread.
+ *
+ * @date	10/17/2026
+ */
+void AudioLog::stop()
+{
+	AudioLogState& s = state();
+	{
+		lock_guard<mutex> l(s.lock);
+		if(s.users == 0 || --s.users > 0)
+			return;
+		s.quit = true;
+	}
+	s.wake.notify_all();
+	if(s.drain.joinable())
+		s.drain.join();
+}
+
+/**
+ * @fn	void AudioLog::flush()
+ *
+ * @brief	Writes out every record queued so far, on the calling thread.
+ *
+ * @date	10/17/2026
+ */
+void AudioLog::flush()
+{
+	AudioLogState& s = state();
+	lock_guard<mutex> l(s.lock);
+	s.drainRing();
+}
+
+/**
+ * @fn	void AudioLog::setSink(AUDIO_LOG_SINK sink, void* pContext)
+ *
+ * @brief	Sends formatted records somewhere other than stderr. NULL discards them.
+ *
+ * @date	10/17/2026
+ */
+void AudioLog::setSink(AUDIO_LOG_SINK sink, void* pContext)
+{
+	AudioLogState& s = state();
+	lock_guard<mutex> l(s.lock);
+	s.sink = sink;
+	s.pSinkContext = pContext;
+}
+
+/**
+ * @fn	void AudioLog::getStats(CommandRingStats* stats)
+ *
+ * @brief	Gets the ring's counters. A non-zero dropped count means records came faster than the drain thread
+ * 			could write them, or no thread was running.
+ *
+ * @date	10/17/2026
+ */
+void AudioLog::getStats(CommandRingStats* stats)
+{
+	AudioLogState& s = state();
+	lock_guard<mutex> l(s.lock);
+	s.ring.getStats(stats);
+}
+
+void AudioLog::push(const AudioLogRecord& r)
+{
+	state().ring.push(r);
+}
+
+void AudioLog::stderrSink(AUDIO_LOG_LEVEL /*level*/, const wchar_t* text, void* /*pContext*/)
+{
+	fwprintf(stderr, L"%ls\n", text);
+}
+
+/**
+ * @fn	void AudioLogRecord::addText(const wchar_t* s)
+ *
+ * @brief	Captures a string argument by copying it into the record, truncated to fit. Once text is full,
+ * 			further strings come out empty.
+ *
+ * @date	10/17/2026
+ */
+void AudioLogRecord::addText(const wchar_t* s)
+{
+	Arg& a = next();
+	a.type = ARG_TEXT;
+	a.text = textUsed;
+	if(s == NULL)
+		s = L"(null)";
+	while(*s != 0 && textUsed < AUDIO_LOG_TEXT_CHARS - 1)
+		text[textUsed++] = *s++;
+	text[textUsed] = 0;
+	if(textUsed < AUDIO_LOG_TEXT_CHARS - 1)
+		textUsed++;
+}
+
+void AudioLogRecord::addText(const char* s)
+{
+	Arg& a = next();
+	a.type = ARG_TEXT;
+	a.text = textUsed;
+	if(s == NULL)
+		s = "(null)";
+	while(*s != 0 && textUsed < AUDIO_LOG_TEXT_CHARS - 1)
+		text[textUsed++] = (wchar_t)(unsigned char)*s++;
+	text[textUsed] = 0;
+	if(textUsed < AUDIO_LOG_TEXT_CHARS - 1)
+		textUsed++;
+}
+
+/**
+ * @fn	void AudioLog::format(const AudioLogRecord& r, wchar_t* pOut, size_t outChars)
+ *
+ * @brief	Turns a record into text, printf style. Each conversion is formatted on its own with the
+ * 			argument cast to the type the conversion expects, so an int passed for %.2f or a float for %d
+ * 			can't misread the stack as it would with a real printf. %s and %S print the captured string
+ * 			whether it came in wide or narrow. Conversions with no argument left print "?".
+ *
+ * @date	10/17/2026
+ *
+ * @param	r			The record.
+ * @param [out]	pOut	Receives the text, always terminated.
+ * @param	outChars	Size of pOut in characters.
+ */
+void AudioLog::format(const AudioLogRecord& r, wchar_t* pOut, size_t outChars)
+{
+	size_t used = 0;
+	UINT32 arg = 0;
+	const wchar_t* f = (r.format != NULL) ? r.format : L"";
+	wchar_t spec[32];
+	wchar_t piece[128];
+
+	if(outChars == 0)
+		return;
+	while(*f != 0 && used < outChars - 1){
+		if(*f != L'%'){
+			pOut[used++] = *f++;
+			continue;
+		}
+		if(f[1] == L'%'){
+			pOut[used++] = L'%';
+			f += 2;
+			continue;
+		}
+
+		// %[flags][width][.precision][length]conversion
+		size_t specLen = 0;
+		spec[specLen++] = *f++;
+		bool longLong = false;
+		while(*f != 0 && wcschr(L"-+ #0123456789.hlLjzt", *f) != NULL && specLen < 28){
+			if(*f == L'l' && f[1] == L'l')
+				longLong = true;
+			if(*f != L'h' && *f != L'l' && *f != L'L' && *f != L'j' && *f != L'z' && *f != L't')
+				spec[specLen++] = *f; // length is decided from the conversion below
+			f++;
+		}
+		wchar_t conversion = *f;
+		if(conversion == 0)
+			break;
+		f++;
+
+		const wchar_t* text = piece;
+		piece[0] = 0;
+		if(arg >= r.argCount){
+			text = L"?";
+		}else{
+			const AudioLogRecord::Arg& a = r.args[arg++];
+			INT64 i = 0;
+			double d = 0;
+			if(a.type == AudioLogRecord::ARG_FLOAT){
+				d = a.f;
+				i = (fabs(a.f) < 9.0e18) ? (INT64)a.f : 0; // NaN and out of range print as 0
+			}else if(a.type == AudioLogRecord::ARG_POINTER){
+				i = (INT64)(size_t)a.p;
+			}else if(a.type == AudioLogRecord::ARG_INT){
+				i = a.i;
+				d = (double)a.i;
+			}
+			switch(conversion){
+				case L'd': case L'i':
+					if(longLong){
+						spec[specLen++] = L'l'; spec[specLen++] = L'l';
+					}
+					spec[specLen++] = conversion;
+					spec[specLen] = 0;
+					if(longLong)
+						swprintf(piece, 128, spec, (long long)i);
+					else
+						swprintf(piece, 128, spec, (int)i);
+					break;
+				case L'u': case L'x': case L'X': case L'o':
+					if(longLong){
+						spec[specLen++] = L'l'; spec[specLen++] = L'l';
+					}
+					spec[specLen++] = conversion;
+					spec[specLen] = 0;
+					if(longLong)
+						swprintf(piece, 128, spec, (unsigned long long)i);
+					else
+						swprintf(piece, 128, spec, (unsigned int)i);
+					break;
+				case L'f': case L'F': case L'e': case L'E': case L'g': case L'G': case L'a': case L'A':
+					spec[specLen++] = conversion;
+					spec[specLen] = 0;
+					swprintf(piece, 128, spec, d);
+					break;
+				case L'c':
+					piece[0] = (wchar_t)i;
+					piece[1] = 0;
+					break;
+				case L'p':
+					swprintf(piece, 128, L"0x%llx", (unsigned long long)i);
+					break;
+				case L's': case L'S':
+					text = (a.type == AudioLogRecord::ARG_TEXT) ? &r.text[a.text] : L"?";
+					break;
+				default:
+					text = L"?";
+					break;
+			}
+		}
+		while(*text != 0 && used < outChars - 1)
+			pOut[used++] = *text++;
+	}
+	pOut[used] = 0;
+}
+
+/**
+// End of AudioLog.cpp
+ */
@@ -0,0 +1,236 @@
+/**
+ * @file	AdpcmTests.cpp
+ *
+ * @brief	ADPCM files whose length isn't a whole number of blocks: the encoder pads the last block, and the
+ * 			'fact' chunk gives the true length. Loading, streaming and sound banks must all deliver exactly
+ * 			that many frames, and the frames they do deliver must be the ones decoded without the trim.
+ * 			Streaming one from memory has to cost less than holding it as 16 bit PCM.
+ */
+
+#include "AudioTests.h"
+#include "AdpcmCodec.h"
+#include "PcmAssetCache.h"
+#include "WavStreamReader.h"
+#include "SoundBank.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+static const UINT32 FRAMES = 10007;     // 9 blocks and most of a tenth, at 512 bytes a block per channel
+
+/**
+ * @struct	AdpcmFixture
+ *
+ * @brief	FRAMES frames of a tone, encoded.
+ */
+struct AdpcmFixture
+{
+	BYTE format[ADPCM_FORMAT_BYTES];
+	UINT32 formatBytes;
+	AdpcmFormat adpcm;
+	vector<BYTE> encoded;
+};
+
+/**
+ * @fn	static bool makeFixture(ADPCM_TYPE type, UINT32 channels, AdpcmFixture* pFixture)
+ *
+ * @brief	Encodes FRAMES frames of a tone, a different pitch on each channel, in 512 byte blocks per channel.
+ *
+ * @date	10/17/2026
+ */
+static bool makeFixture(ADPCM_TYPE type, UINT32 channels, AdpcmFixture* pFixture)
+{
+	pFixture->formatBytes = makeAdpcmFormat(type, channels, 22050, 512 * channels, pFixture->format);
+	if(pFixture->formatBytes == 0 || FAILED(getAdpcmFormat((const WAVEFORMATEX*)pFixture->format, &pFixture->adpcm)))
+		return false;
+	vector<INT16> pcm((size_t)FRAMES * channels);
+	for(UINT32 i = 0; i < FRAMES; ++i){
+		for(UINT32 c = 0; c < channels; ++c){
+			pcm[(size_t)i * channels + c] = (INT16)(12000.0f * sinf(i * 0.02f * (c + 1)));
+		}
+	}
+	pFixture->encoded.resize((size_t)getAdpcmEncodedBytes(&pFixture->adpcm, FRAMES));
+	UINT32 bytes = encodeAdpcm(&pFixture->adpcm, &pcm[0], FRAMES, &pFixture->encoded[0]);
+	pFixture->encoded.resize(bytes);
+	return true;
+}
+
+/**
+ * @fn	static string writeFixture(const AdpcmFixture& fixture, bool withFact)
+ *
+ * @brief	Writes the fixture as a WAV file in the temporary directory, with or without its 'fact' chunk.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The file's path, empty if it couldn't be written.
+ */
+static string writeFixture(const AdpcmFixture& fixture, bool withFact)
+{
+	return writeTestWav((const WAVEFORMATEX*)fixture.format, fixture.formatBytes, &fixture.encoded[0],
+		(UINT32)fixture.encoded.size(), withFact ? FRAMES : 0);
+}
+
+/**
+ * @fn	static UINT64 streamFrames(WavStreamReader* pReader)
+ *
+ * @brief	Drains an opened reader.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The number of frames it delivered.
+ */
+static UINT64 streamFrames(WavStreamReader* pReader)
+{
+	UINT64 bytes = 0;
+	if(FAILED(pReader->start()))
+		return 0;
+	StreamBlock* block;
+	while((block = pReader->acquire(1000)) != NULL){
+		bytes += block->bytes;
+		bool end = block->endOfStream;
+		pReader->release(block);
+		if(end)
+			break;
+	}
+	return bytes / pReader->getFormat()->nBlockAlign;
+}
+
+/**
+ * @fn	static void checkFactLength(ADPCM_TYPE type, UINT32 channels)
+ *
+ * @brief	Loads and streams the fixture with and without its 'fact' chunk, from a file and from a bank.
+ *
+ * @date	10/17/2026
+ */
+static void checkFactLength(ADPCM_TYPE type, UINT32 channels)
+{
+	AdpcmFixture fixture;
+	TEST_CHECK(makeFixture(type, channels, &fixture));
+	if(fixture.encoded.empty())
+		return;
+	UINT64 padded = getAdpcmFrames(&fixture.adpcm, fixture.encoded.size());
+	TEST_CHECK_MSG(padded > FRAMES, "the fixture's last block has no padding: %llu frames", (unsigned long long)padded);
+
+	string withFact = writeFixture(fixture, true);
+	string withoutFact = writeFixture(fixture, false);
+	TEST_CHECK(!withFact.empty() && !withoutFact.empty());
+
+	// decoded at load: a file without 'fact' keeps the padding, so it shows what was trimmed
+	PcmAsset* pTrimmed = NULL;
+	PcmAsset* pWhole = NULL;
+	TEST_CHECK(SUCCEEDED(PcmAsset::create(toTestPath(withFact).c_str(), &pTrimmed)));
+	TEST_CHECK(SUCCEEDED(PcmAsset::create(toTestPath(withoutFact).c_str(), &pWhole)));
+	if(pTrimmed != NULL && pWhole != NULL){
+		UINT32 frameBytes = pTrimmed->getFormat()->nBlockAlign;
+		TEST_CHECK_MSG(pTrimmed->getSize() == FRAMES * frameBytes, "%u frames", pTrimmed->getSize() / frameBytes);
+		TEST_CHECK_MSG(pWhole->getSize() == padded * frameBytes, "%u frames", pWhole->getSize() / frameBytes);
+		TEST_CHECK(memcmp(pTrimmed->getData(), pWhole->getData(), FRAMES * frameBytes) == 0);
+	}
+	SAFE_RELEASE(pTrimmed);
+	SAFE_RELEASE(pWhole);
+
+	// streamed from the file, once and then looping, and from a compressed asset
+	WavStreamReader reader;
+	if(SUCCEEDED(reader.open(withFact.c_str(), STREAMING_BUFFER_BYTES, STREAMING_BUFFER_COUNT, 0))){
+		UINT64 frames = streamFrames(&reader);
+		TEST_CHECK_MSG(frames == FRAMES, "streamed %llu frames", (unsigned long long)frames);
+	}else{
+		TEST_CHECK(!"open failed");
+	}
+	if(SUCCEEDED(reader.open(withFact.c_str(), 4096, STREAMING_BUFFER_COUNT, 2))){
+		UINT64 frames = streamFrames(&reader);
+		TEST_CHECK_MSG(frames == 3 * FRAMES, "streamed %llu frames over 3 passes", (unsigned long long)frames);
+	}else{
+		TEST_CHECK(!"open failed");
+	}
+	PcmAsset* pCompressed = NULL;
+	if(SUCCEEDED(PcmAsset::create(toTestPath(withFact).c_str(), &pCompressed, false))){
+		TEST_CHECK(pCompressed->getFactFrames() == FRAMES);
+		if(SUCCEEDED(reader.openMemory(pCompressed->getFormat(), pCompressed->getData(), pCompressed->getSize(),
+			STREAMING_BUFFER_BYTES, STREAMING_BUFFER_COUNT, 0, pCompressed->getFactFrames()))){
+			UINT64 frames = streamFrames(&reader);
+			TEST_CHECK_MSG(frames == FRAMES, "streamed %llu frames from memory", (unsigned long long)frames);
+		}
+		reader.close();
+		pCompressed->Release();
+	}else{
+		TEST_CHECK(!"no compressed asset");
+	}
+	reader.close();
+
+	// a bank keeps the count
+	string bankPath = withFact + ".bank";
+	vector<SoundBankSource> sources(1);
+	sources[0].name = "fixture.wav";
+	sources[0].pFormat = (const WAVEFORMATEX*)fixture.format;
+	sources[0].pData = &fixture.encoded[0];
+	sources[0].dataBytes = (UINT32)fixture.encoded.size();
+	sources[0].factFrames = FRAMES;
+	SoundBank* pBank = NULL;
+	TEST_CHECK(SUCCEEDED(writeSoundBank(bankPath.c_str(), sources)));
+	TEST_CHECK(SUCCEEDED(SoundBank::open(toTestPath(bankPath).c_str(), &pBank)));
+	if(pBank != NULL){
+		PcmAsset* pAsset = NULL;
+		TEST_CHECK(SUCCEEDED(PcmAsset::create(pBank, 0, &pAsset)));
+		if(pAsset != NULL){
+			UINT32 frameBytes = pAsset->getFormat()->nBlockAlign;
+			TEST_CHECK_MSG(pAsset->getSize() == FRAMES * frameBytes, "%u frames from the bank", pAsset->getSize() / frameBytes);
+			pAsset->Release();
+		}
+		pBank->Release();
+	}
+
+	remove(bankPath.c_str());
+	remove(withFact.c_str());
+	remove(withoutFact.c_str());
+}
+
+AUDIO_TEST(adpcm_factLengthIma)
+{
+	checkFactLength(ADPCM_TYPE_IMA, 1);
+	checkFactLength(ADPCM_TYPE_IMA, 2);
+}
+
+AUDIO_TEST(adpcm_factLengthMs)
+{
+	// mono: a stereo MS byte is a whole frame, so stereo blocks need no padding
+	checkFactLength(ADPCM_TYPE_MS, 1);
+}
+
+AUDIO_TEST(adpcm_memoryFootprint)
+{
+	// a compressed sound keeps its ADPCM in memory and streams it through a ring: together they must
+	// still be smaller than the same sound held as 16 bit PCM, or compressing it saved nothing
+	PcmAsset* pPcm = NULL;
+	TEST_CHECK(SUCCEEDED(PcmAsset::create(toTestPath(getTestWavDir() + "/heli.wav").c_str(), &pPcm, false)));
+	if(pPcm == NULL)
+		return;
+	const WAVEFORMATEX* pPcmFormat = pPcm->getFormat();
+	TEST_CHECK(pPcmFormat->wFormatTag == WAVE_FORMAT_PCM && pPcmFormat->wBitsPerSample == 16);
+	UINT32 channels = pPcmFormat->nChannels;
+	UINT32 frames = pPcm->getSize() / pPcmFormat->nBlockAlign;
+
+	BYTE format[ADPCM_FORMAT_BYTES];
+	AdpcmFormat adpcm;
+	TEST_CHECK(makeAdpcmFormat(ADPCM_TYPE_IMA, channels, pPcmFormat->nSamplesPerSec, 512 * channels, format) != 0);
+	TEST_CHECK(SUCCEEDED(getAdpcmFormat((const WAVEFORMATEX*)format, &adpcm)));
+	vector<BYTE> encoded((size_t)getAdpcmEncodedBytes(&adpcm, frames));
+	UINT32 encodedBytes = encodeAdpcm(&adpcm, (const INT16*)pPcm->getData(), frames, &encoded[0]);
+
+	WavStreamReader reader;
+	TEST_CHECK(SUCCEEDED(reader.openMemory((const WAVEFORMATEX*)format, &encoded[0], encodedBytes,
+		WavStreamReader::getMemoryBufferBytes((const WAVEFORMATEX*)format), STREAMING_BUFFER_COUNT, 0, frames)));
+	UINT64 ringBytes = (UINT64)reader.getBufferBytes() * reader.getBufferCount();
+	TEST_CHECK_MSG(encodedBytes + ringBytes < pPcm->getSize(), "%u bytes of ADPCM and a %llu byte ring, %u bytes as PCM",
+		encodedBytes, (unsigned long long)ringBytes, pPcm->getSize());
+
+	// and the small ring still delivers all of it
+	UINT64 streamed = streamFrames(&reader);
+	TEST_CHECK_MSG(streamed == frames, "streamed %llu of %u frames", (unsigned long long)streamed, frames);
+	reader.close();
+	pPcm->Release();
+}
+
+/**
+// End of AdpcmTests.cpp
+ */
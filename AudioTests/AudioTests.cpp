@@ -0,0 +1,211 @@
+/**
+ * @file	AudioTests.cpp
+ *
+ * @brief	Headless tests of the library's portable modules: sample conversion, the mixing kernels, the
+ * 			spatializer and the rest of what can run without an audio device (see the Makefile next to
+ * 			this). Each test is a function registered with AUDIO_TEST(), in a file named after the module it
+ * 			covers. On Windows AudioTests.vcxproj builds them too, along with the tests that need XAudio2's
+ * 			interfaces. The program runs them all, or those whose name contains --filter, and exits with 1
+ * 			if any check failed:
+ *
+ * 			AudioTests
+ * 			AudioTests --filter convert_
+ */
+
+#include "AudioTests.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// A test that goes wrong in a loop would otherwise print every iteration
+#define MAX_REPORTED_FAILURES 10
+
+static UINT32 failures;     // in the running test
+static string wavDir = "Wavs";
+
+vector<AudioTest>& getAudioTests()
+{
+	static vector<AudioTest> tests;
+	return tests;
+}
+
+const string& getTestWavDir()
+{
+	return wavDir;
+}
+
+/**
+ * @fn	void testFailed(const char* file, int line, const char* expression, const string& detail)
+ *
+ * @brief	Records a failed check in the running test and prints it, up to MAX_REPORTED_FAILURES of them.
+ *
+ * @date	10/17/2026
+ */
+void testFailed(const char* file, int line, const char* expression, const string& detail)
+{
+	if(++failures > MAX_REPORTED_FAILURES)
+		return;
+	const char* name = strrchr(file, '/');
+	const char* windowsName = strrchr(file, '\\');
+	if(windowsName > name)
+		name = windowsName;
+	fprintf(stderr, "  %s:%d: %s%s%s\n", name ? name + 1 : file, line, expression, detail.empty() ? "" : ": ", detail.c_str());
+}
+
+string testFormat(const char* format, ...)
+{
+	char text[512];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+	return text;
+}
+
+TEST_PATH toTestPath(const string& path)
+{
+	return TEST_PATH(path.begin(), path.end());
+}
+
+/**
+ * @fn	string makeTestTempPath()
+ *
+ * @brief	Makes an empty file in the temporary directory, for a test to write and then remove().
+ *
+ * @date	10/17/2026
+ *
+ * @return	Its path, empty if it couldn't be made.
+ */
+string makeTestTempPath()
+{
+#ifdef _WIN32
+	char dir[MAX_PATH];
+	char path[MAX_PATH];
+	if(GetTempPathA(MAX_PATH, dir) == 0 || GetTempFileNameA(dir, "AT", 0, path) == 0)
+		return string();
+	return path;
+#else
+	char path[] = "/tmp/AudioTestsXXXXXX";
+	int fd = mkstemp(path);
+	if(fd < 0)
+		return string();
+	close(fd);
+	return path;
+#endif
+}
+
+static void putLE32(FILE* f, UINT32 value)
+{
+	BYTE bytes[4] = { (BYTE)value, (BYTE)(value >> 8), (BYTE)(value >> 16), (BYTE)(value >> 24) };
+	fwrite(bytes, 1, 4, f);
+}
+
+/**
+ * @fn	string writeTestWav(const WAVEFORMATEX* pFormat, UINT32 formatBytes, const void* pData,
+ * 		UINT32 dataBytes, UINT32 factFrames)
+ *
+ * @brief	Writes a WAV file in the temporary directory: 'fmt ', a 'fact' chunk if factFrames isn't 0, and
+ * 			'data'.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pFormat	   	The format, formatBytes long (16 for plain PCM).
+ * @param	pData	   	dataBytes of sample data.
+ * @param	factFrames 	The 'fact' chunk's frame count, 0 for none.
+ *
+ * @return	The file's path, empty if it couldn't be written.
+ */
+string writeTestWav(const WAVEFORMATEX* pFormat, UINT32 formatBytes, const void* pData, UINT32 dataBytes, UINT32 factFrames)
+{
+	string path = makeTestTempPath();
+	if(path.empty())
+		return path;
+	FILE* f = fopen(path.c_str(), "wb");
+	if(f == NULL){
+		remove(path.c_str());
+		return string();
+	}
+	fwrite("RIFF", 1, 4, f);
+	putLE32(f, 4 + 8 + formatBytes + (factFrames != 0 ? 12 : 0) + 8 + dataBytes + (dataBytes & 1));
+	fwrite("WAVEfmt ", 1, 8, f);
+	putLE32(f, formatBytes);
+	fwrite(pFormat, 1, formatBytes, f);
+	if(factFrames != 0){
+		fwrite("fact", 1, 4, f);
+		putLE32(f, 4);
+		putLE32(f, factFrames);
+	}
+	fwrite("data", 1, 4, f);
+	putLE32(f, dataBytes);
+	fwrite(pData, 1, dataBytes, f);
+	if(dataBytes & 1)
+		fputc(0, f);
+	bool ok = (ferror(f) == 0);
+	fclose(f);
+	if(!ok){
+		remove(path.c_str());
+		return string();
+	}
+	return path;
+}
+
+static void usage()
+{
+	fprintf(stderr,
+		"usage: AudioTests [options]\n"
+		"  --filter TEXT     run only tests whose name contains TEXT\n"
+		"  --list            list the tests without running them\n"
+		"  --wavs DIR        WAV files the file tests read (default Wavs)\n");
+}
+
+int main(int argc, char* argv[])
+{
+	string filter;
+	bool list = false;
+	for(int i = 1; i < argc; ++i){
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if(arg == "--list"){
+			list = true;
+		}else if(arg == "--filter" && hasValue){
+			filter = argv[++i];
+		}else if(arg == "--wavs" && hasValue){
+			wavDir = argv[++i];
+		}else{
+			usage();
+			return 2;
+		}
+	}
+
+	UINT32 run = 0;
+	UINT32 failed = 0;
+	vector<AudioTest>& tests = getAudioTests();
+	for(size_t t = 0; t < tests.size(); ++t){
+		if(!filter.empty() && string(tests[t].name).find(filter) == string::npos)
+			continue;
+		if(list){
+			printf("%s\n", tests[t].name);
+			continue;
+		}
+		failures = 0;
+		tests[t].body();
+		run++;
+		if(failures > 0){
+			failed++;
+			printf("FAIL %s (%u failed checks)\n", tests[t].name, failures);
+		}else{
+			printf("ok   %s\n", tests[t].name);
+		}
+	}
+	if(!list)
+		printf("%u of %u tests passed\n", run - failed, run);
+	return failed > 0 ? 1 : 0;
+}
+
+/**
+// End of AudioTests.cpp
+ */
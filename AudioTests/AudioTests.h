@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @struct	AudioTest
+ *
+ * @brief	One registered test. Tests are plain functions that report failures with the TEST_ macros below;
+ * 			a test passes if it reports none.
+ */
+struct AudioTest
+{
+	const char* name;
+	void (*body)();
+};
+
+vector<AudioTest>& getAudioTests();
+void testFailed(const char* file, int line, const char* expression, const string& detail);
+string testFormat(const char* format, ...);
+const string& getTestWavDir();
+
+// Paths as the library's file functions take them, wide on Windows
+#ifdef _WIN32
+typedef wstring TEST_PATH;
+#else
+typedef string TEST_PATH;
+#endif
+TEST_PATH toTestPath(const string& path);
+
+string makeTestTempPath();
+string writeTestWav(const WAVEFORMATEX* pFormat, UINT32 formatBytes, const void* pData, UINT32 dataBytes, UINT32 factFrames = 0);
+
+/**
+ * @class	AudioTestRegistrar
+ *
+ * @brief	Adds a test to getAudioTests() when the program starts. Made by AUDIO_TEST().
+ */
+class AudioTestRegistrar
+{
+public:
+	AudioTestRegistrar(const char* name, void (*body)()){
+		AudioTest test = { name, body };
+		getAudioTests().push_back(test);
+	};
+};
+
+// Defines and registers a test: AUDIO_TEST(convert_roundTripU8){ ... }
+#define AUDIO_TEST(name) \
+	static void name(); \
+	static AudioTestRegistrar name##Registrar(#name, name); \
+	static void name()
+
+#define TEST_CHECK(condition) \
+	do{ if(!(condition)) testFailed(__FILE__, __LINE__, #condition, string()); }while(0)
+
+// Checks a condition, with printf-style details of the values involved when it fails
+#define TEST_CHECK_MSG(condition, ...) \
+	do{ if(!(condition)) testFailed(__FILE__, __LINE__, #condition, testFormat(__VA_ARGS__)); }while(0)
+
+/**
+// End of AudioTests.h
+ */
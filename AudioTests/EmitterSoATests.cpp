@@ -0,0 +1,95 @@
+/**
+ * @file	EmitterSoATests.cpp
+ *
+ * @brief	The emitter store's bookkeeping: what its matrix slots keep when they change shape, and what
+ * 			moves when an emitter is removed.
+ */
+
+#include "AudioTests.h"
+#include "EmitterSoA.h"
+
+/**
+ * @fn	static UINT32 addRouted(EmitterSoA* pStore, FLOAT32 left, FLOAT32 right)
+ *
+ * @brief	Adds a mono emitter that isn't spatialized, routed to the two outputs directly and committed, as a
+ * 			sound played on set channels would be.
+ *
+ * @date	10/17/2026
+ */
+static UINT32 addRouted(EmitterSoA* pStore, FLOAT32 left, FLOAT32 right)
+{
+	UINT32 i = pStore->add((SOUND_HANDLE)(pStore->getCount() + 1));
+	pStore->getMatrix(i)[0] = left;
+	pStore->getMatrix(i)[1] = right;
+	pStore->commit(i, 0);
+	return i;
+}
+
+AUDIO_TEST(emitter_widenKeepsRouting)
+{
+	EmitterSoA store;
+	store.setMatrixSize(1, 2);
+	UINT32 first = addRouted(&store, 0.25f, 0.75f);
+	UINT32 second = addRouted(&store, 1.0f, 0.5f);
+
+	// a six channel emitter makes every slot wider
+	UINT32 wide = store.add((SOUND_HANDLE)100);
+	store.setChannels(wide, 6, 1.0f, NULL);
+	TEST_CHECK(store.getSrcChannels() == 6);
+
+	const FLOAT32 expected[2][2] = { { 0.25f, 0.75f }, { 1.0f, 0.5f } };
+	UINT32 routed[2] = { first, second };
+	for(UINT32 r = 0; r < 2; ++r){
+		const FLOAT32* m = store.getMatrix(routed[r]);
+		const FLOAT32* a = store.getAppliedMatrix(routed[r]);
+		for(UINT32 c = 0; c < 2; ++c){
+			TEST_CHECK_MSG(m[c] == expected[r][c], "emitter %u, output %u: matrix %g", r, c, m[c]);
+			TEST_CHECK_MSG(a[c] == expected[r][c], "emitter %u, output %u: applied %g", r, c, a[c]);
+		}
+		// nothing about the routed emitters changed, so their voices need nothing sent
+		TEST_CHECK_MSG(!store.commit(routed[r], 0), "emitter %u recommitted", r);
+	}
+	TEST_CHECK(store.commit(wide, 0));
+}
+
+AUDIO_TEST(emitter_newOutputDiscardsRouting)
+{
+	EmitterSoA store;
+	store.setMatrixSize(1, 2);
+	UINT32 i = addRouted(&store, 0.25f, 0.75f);
+
+	// stereo weights mean nothing to a 5.1 output, so they go and the emitter has to be set again
+	store.setMatrixSize(1, 6);
+	for(UINT32 c = 0; c < 6; ++c)
+		TEST_CHECK_MSG(store.getMatrix(i)[c] == 0, "output %u: %g", c, store.getMatrix(i)[c]);
+	TEST_CHECK(store.commit(i, 0));
+}
+
+AUDIO_TEST(emitter_removeMovesLast)
+{
+	EmitterSoA store;
+	store.setMatrixSize(1, 2);
+	addRouted(&store, 0.25f, 0.75f);
+	addRouted(&store, 1.0f, 0.5f);
+	UINT32 last = addRouted(&store, 0.5f, 0.125f);
+	store.posX[last] = 7;
+	store.spatialized[last] = 1;
+
+	// the last emitter fills the gap, and its owner is returned so that the sound can be told
+	TEST_CHECK(store.remove(0) == (SOUND_HANDLE)3);
+	TEST_CHECK(store.getCount() == 2);
+	TEST_CHECK(store.owner[0] == (SOUND_HANDLE)3);
+	TEST_CHECK(store.posX[0] == 7 && store.spatialized[0] == 1);
+	TEST_CHECK(store.getMatrix(0)[0] == 0.5f && store.getMatrix(0)[1] == 0.125f);
+	TEST_CHECK(store.getAppliedMatrix(0)[0] == 0.5f && store.getAppliedMatrix(0)[1] == 0.125f);
+	TEST_CHECK(store.owner[1] == (SOUND_HANDLE)2);
+
+	// removing the last one moves nothing
+	TEST_CHECK(store.remove(1) == SOUND_HANDLE_INVALID);
+	TEST_CHECK(store.remove(5) == SOUND_HANDLE_INVALID);
+	TEST_CHECK(store.getCount() == 1);
+}
+
+/**
+// End of EmitterSoATests.cpp
+ */
@@ -0,0 +1,72 @@
+/**
+ * @file	OfflineRenderTests.cpp
+ *
+ * @brief	BasicAudio::renderOffline(): the file holds exactly the frames asked for, and a voice at unity gain
+ * 			comes out in it bit for bit. This uses XAudio2's interfaces, so it is only built by
+ * 			AudioTests.vcxproj.
+ */
+
+#include "AudioTests.h"
+#include "BasicAudio.h"
+#include "MappedWaveFile.h"
+#include <stdio.h>
+
+AUDIO_TEST(offline_renderFrameCount)
+{
+	const UINT32 FRAMES = 4801;
+	const UINT32 STEPS = 61;    // 61 60ths of a second, 48800 frames, none of them a whole number of quanta
+	const UINT32 RENDERED = 48800;
+
+	BasicAudio ba;
+	ba.initOffline(48000, 2);
+	TEST_CHECK(ba.isOffline());
+	if(!ba.isOffline())
+		return;
+
+	vector<FLOAT32> source(FRAMES * 2);
+	UINT32 state = 12345;
+	for(UINT32 i = 0; i < FRAMES * 2; ++i){
+		state = state * 1664525u + 1013904223u;
+		source[i] = (FLOAT32)(state >> 8) / (FLOAT32)(1 << 23) - 1.0f;
+	}
+	WAVEFORMATEX format = { WAVE_FORMAT_IEEE_FLOAT, 2, 48000, 384000, 8, 32, 0 };
+	IXAudio2SourceVoice* pVoice = NULL;
+	TEST_CHECK(SUCCEEDED(ba.getXaudioPtr()->CreateSourceVoice(&pVoice, &format)));
+	if(pVoice == NULL)
+		return;
+	XAUDIO2_BUFFER buffer = { XAUDIO2_END_OF_STREAM, FRAMES * 8, (const BYTE*)&source[0], 0, 0, 0, 0, 0, NULL };
+	TEST_CHECK(SUCCEEDED(pVoice->SubmitSourceBuffer(&buffer)));
+	TEST_CHECK(SUCCEEDED(pVoice->Start(0)));
+
+	string path = makeTestTempPath();
+	TEST_CHECK(!path.empty());
+	TEST_CHECK(SUCCEEDED(ba.beginOfflineRender(toTestPath(path).c_str(), true)));
+	for(UINT32 s = 0; s < STEPS; ++s)
+		TEST_CHECK(SUCCEEDED(ba.renderOffline(1.0 / 60.0)));
+	OfflineRenderStats stats;
+	TEST_CHECK(SUCCEEDED(ba.endOfflineRender(&stats)));
+	TEST_CHECK_MSG(stats.frames == RENDERED, "%llu frames rendered", (unsigned long long)stats.frames);
+	pVoice->DestroyVoice();
+
+	MappedWaveFile wav;
+	TEST_CHECK(SUCCEEDED(wav.open(toTestPath(path).c_str())));
+	if(wav.isOpen()){
+		TEST_CHECK(wav.getFormat()->wFormatTag == WAVE_FORMAT_IEEE_FLOAT && wav.getFormat()->nChannels == 2);
+		TEST_CHECK_MSG(wav.getSize() == RENDERED * 8, "%u frames in the file", (UINT32)(wav.getSize() / 8));
+		const FLOAT32* pOut = (const FLOAT32*)wav.getData();
+		UINT32 samples = wav.getSize() / sizeof(FLOAT32);
+		UINT32 wrong = 0;
+		for(UINT32 i = 0; i < samples; ++i){
+			if(pOut[i] != ((i < FRAMES * 2) ? source[i] : 0.0f))
+				wrong++;
+		}
+		TEST_CHECK_MSG(wrong == 0, "%u samples differ from the source", wrong);
+		wav.close();
+	}
+	ba.destroy();
+	remove(path.c_str());
+}
+
+/**
+// End of OfflineRenderTests.cpp
+ */
@@ -0,0 +1,131 @@
+/**
+ * @file	PcmAssetCacheTests.cpp
+ *
+ * @brief	PcmAssetCache: one asset per file however it is asked for, even by threads asking at once, and
+ * 			nothing left behind, or freed twice, when threads acquire and release the same file at once.
+ */
+
+#include "AudioTests.h"
+#include "PcmAssetCache.h"
+#include <stdio.h>
+#include <thread>
+
+/**
+ * @fn	static string writeToneWav(UINT32 frames)
+ *
+ * @brief	Writes a mono 16 bit file of a ramp, frames long.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The file's path, empty if it couldn't be written.
+ */
+static string writeToneWav(UINT32 frames)
+{
+	WAVEFORMATEX format = { WAVE_FORMAT_PCM, 1, 22050, 44100, 2, 16, 0 };
+	vector<INT16> pcm(frames);
+	for(UINT32 i = 0; i < frames; ++i)
+		pcm[i] = (INT16)(i * 7);
+	return writeTestWav(&format, 16, &pcm[0], frames * 2);
+}
+
+AUDIO_TEST(assets_sharedAndFreed)
+{
+	string path = writeToneWav(1000);
+	TEST_CHECK(!path.empty());
+	PcmAssetCache cache;
+	PcmAsset* pFirst = NULL;
+	PcmAsset* pSecond = NULL;
+	TEST_CHECK(SUCCEEDED(cache.acquire(toTestPath(path).c_str(), &pFirst)));
+	TEST_CHECK(SUCCEEDED(cache.acquire(toTestPath(path).c_str(), &pSecond)));
+	TEST_CHECK(pFirst != NULL && pFirst == pSecond);
+
+	PcmAssetCacheStats stats;
+	cache.getStats(&stats);
+	TEST_CHECK(stats.misses == 1 && stats.hits == 1 && stats.liveAssets == 1);
+	SAFE_RELEASE(pFirst);
+	cache.getStats(&stats);
+	TEST_CHECK(stats.liveAssets == 1);
+	SAFE_RELEASE(pSecond);
+	cache.getStats(&stats);
+	TEST_CHECK_MSG(stats.liveAssets == 0 && stats.residentBytes == 0, "%u assets, %llu bytes left",
+		stats.liveAssets, (unsigned long long)stats.residentBytes);
+	remove(path.c_str());
+}
+
+AUDIO_TEST(assets_concurrentAcquireRelease)
+{
+	// the count keeps falling to zero while other threads acquire, the case where an asset could be
+	// handed out as it was being deleted
+	const UINT32 THREADS = 8;
+	const UINT32 ROUNDS = 20000;
+	string path = writeToneWav(64);
+	TEST_CHECK(!path.empty());
+	TEST_PATH testPath = toTestPath(path);
+	PcmAssetCache cache;
+	vector<UINT32> failures(THREADS, 0);
+	vector<thread> threads;
+	for(UINT32 t = 0; t < THREADS; ++t){
+		threads.push_back(thread([&, t]{
+			for(UINT32 r = 0; r < ROUNDS; ++r){
+				PcmAsset* pAsset = NULL;
+				if(FAILED(cache.acquire(testPath.c_str(), &pAsset)) || pAsset->getSize() == 0)
+					failures[t]++;
+				SAFE_RELEASE(pAsset);
+			}
+		}));
+	}
+	for(UINT32 t = 0; t < THREADS; ++t){
+		threads[t].join();
+		TEST_CHECK_MSG(failures[t] == 0, "thread %u: %u failed acquires", t, failures[t]);
+	}
+
+	PcmAssetCacheStats stats;
+	cache.getStats(&stats);
+	TEST_CHECK(stats.hits + stats.misses == THREADS * ROUNDS);
+	TEST_CHECK_MSG(stats.liveAssets == 0 && stats.residentBytes == 0, "%u assets, %llu bytes left",
+		stats.liveAssets, (unsigned long long)stats.residentBytes);
+	remove(path.c_str());
+}
+
+AUDIO_TEST(assets_concurrentMissLoadsOnce)
+{
+	// the file is loaded without the cache's lock held, so the threads that ask for it while it loads
+	// have to wait for that load rather than start their own
+	const UINT32 THREADS = 8;
+	string path = writeToneWav(220500);
+	TEST_CHECK(!path.empty());
+	TEST_PATH testPath = toTestPath(path);
+	TEST_PATH missing = toTestPath(path + ".missing");
+	PcmAssetCache cache;
+	vector<PcmAsset*> got(THREADS, (PcmAsset*)NULL);
+	vector<HRESULT> missingHr(THREADS, S_OK);
+	vector<thread> threads;
+	for(UINT32 t = 0; t < THREADS; ++t){
+		threads.push_back(thread([&, t]{
+			cache.acquire(testPath.c_str(), &got[t]);
+			PcmAsset* pNone = NULL;
+			missingHr[t] = cache.acquire(missing.c_str(), &pNone);
+		}));
+	}
+	for(UINT32 t = 0; t < THREADS; ++t)
+		threads[t].join();
+
+	PcmAssetCacheStats stats;
+	cache.getStats(&stats);
+	TEST_CHECK_MSG(stats.misses == 1 && stats.hits == THREADS - 1, "%llu misses, %llu hits",
+		(unsigned long long)stats.misses, (unsigned long long)stats.hits);
+	PcmAsset* pFirst = got[0];
+	for(UINT32 t = 0; t < THREADS; ++t){
+		TEST_CHECK_MSG(got[t] != NULL && got[t] == pFirst, "thread %u got another asset", t);
+		// a failed load leaves nothing behind for the others to wait on
+		TEST_CHECK_MSG(FAILED(missingHr[t]), "thread %u acquired a missing file", t);
+		SAFE_RELEASE(got[t]);
+	}
+	cache.getStats(&stats);
+	TEST_CHECK(stats.liveAssets == 0 && stats.residentBytes == 0);
+	remove(path.c_str());
+}
+
+/**
+// End of PcmAssetCacheTests.cpp
+ */
@@ -0,0 +1,266 @@
+/**
+ * @file	ResamplerTests.cpp
+ *
+ * @brief	Resampler: a step of 1 is an exact copy, every filter passes DC at unity gain, the sinc32 filter
+ * 			stops what would alias when downsampling, and the output doesn't depend on how it is split into
+ * 			blocks, at a fixed step or along a ramp, with only getInputNeeded() frames pushed before each.
+ */
+
+#include "AudioTests.h"
+#include "Resampler.h"
+#include <math.h>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const RESAMPLER_QUALITY qualities[] = { RESAMPLER_QUALITY_LINEAR, RESAMPLER_QUALITY_SINC8, RESAMPLER_QUALITY_SINC32 };
+static const char* qualityNames[] = { "linear", "sinc8", "sinc32" };
+static const UINT32 QUALITY_COUNT = 3;
+
+static const MIX_KERNEL kernels[] = { MIX_KERNEL_SCALAR, MIX_KERNEL_SSE2, MIX_KERNEL_AVX2 };
+static const UINT32 KERNEL_COUNT = 3;
+
+/**
+ * @fn	static vector<FLOAT32> makeNoise(UINT32 samples)
+ *
+ * @brief	Samples of noise in [-1, 1), the same every run.
+ *
+ * @date	10/17/2026
+ */
+static vector<FLOAT32> makeNoise(UINT32 samples)
+{
+	vector<FLOAT32> noise(samples);
+	UINT32 state = 12345;
+	for(UINT32 i = 0; i < samples; ++i){
+		state = state * 1664525u + 1013904223u;
+		noise[i] = (FLOAT32)(state >> 8) / (FLOAT32)(1 << 23) - 1.0f;
+	}
+	return noise;
+}
+
+/**
+ * @fn	static vector<FLOAT32> makeTone(UINT32 frames, UINT32 channels, double cycles)
+ *
+ * @brief	A sine of amplitude 0.5, cycles per frame, the same on every channel.
+ *
+ * @date	10/17/2026
+ */
+static vector<FLOAT32> makeTone(UINT32 frames, UINT32 channels, double cycles)
+{
+	vector<FLOAT32> tone((size_t)frames * channels);
+	for(UINT32 i = 0; i < frames; ++i){
+		for(UINT32 c = 0; c < channels; ++c)
+			tone[(size_t)i * channels + c] = (FLOAT32)(0.5 * sin(2.0 * M_PI * cycles * i));
+	}
+	return tone;
+}
+
+/**
+ * @fn	static vector<FLOAT32> resample(Resampler* pRs, const vector<FLOAT32>& in, const UINT32* pBlocks,
+ * 		UINT32 blockCount, double fromStep, double toStep, UINT32* pShortPulls, bool upFront = false)
+ *
+ * @brief	Pulls blocks of the given sizes, in turn and over and over, as a voice would: pushing just the
+ * 			input getInputNeeded() asks for before each, with the step ramped from fromStep to toStep over
+ * 			the first half of the run, block by block. Stops when the input runs out.
+ *
+ * @date	10/17/2026
+ *
+ * @param [out]	pShortPulls	Blocks that came back short although getInputNeeded() had been met.
+ * @param	upFront		   	Push all of the input before the first pull instead, for a reference that
+ * 							doesn't depend on getInputNeeded().
+ *
+ * @return	The output, interleaved like the input.
+ */
+static vector<FLOAT32> resample(Resampler* pRs, const vector<FLOAT32>& in, const UINT32* pBlocks, UINT32 blockCount,
+	double fromStep, double toStep, UINT32* pShortPulls, bool upFront = false)
+{
+	const UINT32 channels = pRs->getChannels();
+	const UINT32 inFrames = (UINT32)(in.size() / channels);
+	// the ramp's length in output frames, roughly; the step holds at toStep after it
+	const UINT32 rampFrames = (UINT32)(inFrames / ((fromStep + toStep) / 2.0)) / 2;
+	vector<FLOAT32> out;
+	UINT32 pushed = 0, pulled = 0;
+	*pShortPulls = 0;
+	if(upFront){
+		pRs->push(&in[0], inFrames);
+		pushed = inFrames;
+	}
+	for(UINT32 b = 0; ; b = (b + 1) % blockCount){
+		UINT32 frames = pBlocks[b];
+		double startStep = fromStep + (toStep - fromStep) * min(1.0, (double)pulled / rampFrames);
+		double endStep = fromStep + (toStep - fromStep) * min(1.0, (double)(pulled + frames) / rampFrames);
+		if(!upFront){
+			UINT32 needed = pRs->getInputNeeded(frames, startStep, endStep);
+			if(pushed + needed > inFrames)
+				break;
+			pRs->push(&in[(size_t)pushed * channels], needed);
+			pushed += needed;
+		}
+		out.resize((size_t)(pulled + frames) * channels);
+		UINT32 got = pRs->pull(&out[(size_t)pulled * channels], frames, startStep, endStep);
+		pulled += got;
+		out.resize((size_t)pulled * channels);
+		if(got != frames){
+			if(upFront)
+				break;
+			(*pShortPulls)++;
+		}
+	}
+	return out;
+}
+
+/**
+ * @fn	static UINT32 countChanged(const vector<FLOAT32>& out, const vector<FLOAT32>& in)
+ *
+ * @brief	Samples of out that aren't exactly the same sample of in.
+ *
+ * @date	10/17/2026
+ */
+static UINT32 countChanged(const vector<FLOAT32>& out, const vector<FLOAT32>& in)
+{
+	UINT32 changed = 0;
+	for(size_t i = 0; i < out.size() && i < in.size(); ++i)
+		changed += (out[i] == in[i]) ? 0 : 1;
+	return changed;
+}
+
+AUDIO_TEST(resampler_passthrough)
+{
+	// a step of 1 from a whole frame copies, with any filter, whether the input is streamed in as it is
+	// needed or pushed all at once and drained
+	const UINT32 channels = 2;
+	const UINT32 frames = 4099;
+	vector<FLOAT32> in = makeNoise(frames * channels);
+	const UINT32 blocks[] = { 1, 64, 333, 17 };
+	for(UINT32 q = 0; q < QUALITY_COUNT; ++q){
+		Resampler rs;
+		TEST_CHECK(SUCCEEDED(rs.init(channels, qualities[q])));
+		UINT32 shortPulls;
+		vector<FLOAT32> out = resample(&rs, in, blocks, 4, 1.0, 1.0, &shortPulls);
+		TEST_CHECK_MSG(shortPulls == 0, "%s: %u short pulls", qualityNames[q], shortPulls);
+		TEST_CHECK_MSG(countChanged(out, in) == 0, "%s streamed: %u samples changed", qualityNames[q], countChanged(out, in));
+
+		rs.reset();
+		rs.push(&in[0], frames);
+		rs.endOfStream();
+		vector<FLOAT32> drained((size_t)(frames + 333) * channels);
+		UINT32 got = 0;
+		for(UINT32 b = 0; ; b = (b + 1) % 4){
+			UINT32 n = rs.pull(&drained[(size_t)got * channels], blocks[b], 1.0, 1.0);
+			got += n;
+			if(n < blocks[b])
+				break;
+		}
+		drained.resize((size_t)got * channels);
+		TEST_CHECK_MSG(got == frames, "%s drained: %u of %u frames", qualityNames[q], got, frames);
+		TEST_CHECK_MSG(countChanged(drained, in) == 0, "%s drained: %u samples changed", qualityNames[q], countChanged(drained, in));
+		TEST_CHECK(!rs.isDraining());
+	}
+}
+
+/**
+ * @fn	static double rms(const vector<FLOAT32>& samples, size_t from)
+ *
+ * @brief	Root mean square of the samples from an index on.
+ *
+ * @date	10/17/2026
+ */
+static double rms(const vector<FLOAT32>& samples, size_t from)
+{
+	double sum = 0;
+	for(size_t i = from; i < samples.size(); ++i)
+		sum += (double)samples[i] * samples[i];
+	return (samples.size() > from) ? sqrt(sum / (samples.size() - from)) : 0.0;
+}
+
+AUDIO_TEST(resampler_unityDC)
+{
+	// every row of every table sums to 1, and so do rows interpolated between them, so a constant comes
+	// through unchanged once the filter is past the silence before the first frame
+	const UINT32 frames = 3000;
+	vector<FLOAT32> in(frames, 0.5f);
+	const double steps[] = { 0.61, 1.0, 1.37, 2.5, 3.7 };
+	const UINT32 blocks[] = { 480 };
+	for(UINT32 k = 0; k < KERNEL_COUNT; ++k){
+		if(!isMixKernelAvailable(kernels[k]))
+			continue;
+		for(UINT32 q = 0; q < QUALITY_COUNT; ++q){
+			for(UINT32 s = 0; s < sizeof(steps) / sizeof(steps[0]); ++s){
+				Resampler rs;
+				rs.init(1, qualities[q]);
+				rs.setKernel(kernels[k]);
+				UINT32 shortPulls;
+				vector<FLOAT32> out = resample(&rs, in, blocks, 1, steps[s], steps[s], &shortPulls);
+				double worst = 0;
+				for(size_t i = rs.getTaps(); i < out.size(); ++i)
+					worst = max(worst, fabs((double)out[i] - 0.5));
+				TEST_CHECK_MSG(worst < 1e-5 && out.size() > frames / steps[s] / 2, "kernel %u, %s, step %g: off by %g over %u frames",
+					k, qualityNames[q], steps[s], worst, (UINT32)out.size());
+			}
+		}
+	}
+}
+
+AUDIO_TEST(resampler_sinc32Stopband)
+{
+	// halving the rate: a tone at 0.4 of the input rate would fold back to 0.1, so it has to go, while one
+	// at 0.05 must come through
+	const UINT32 frames = 20000;
+	const UINT32 blocks[] = { 512 };
+	const double cycles[] = { 0.4, 0.05 };
+	double gain[2];
+	for(UINT32 t = 0; t < 2; ++t){
+		Resampler rs;
+		rs.init(1, RESAMPLER_QUALITY_SINC32);
+		vector<FLOAT32> in = makeTone(frames, 1, cycles[t]);
+		UINT32 shortPulls;
+		vector<FLOAT32> out = resample(&rs, in, blocks, 1, 2.0, 2.0, &shortPulls);
+		gain[t] = rms(out, 64) / rms(in, 0);
+	}
+	TEST_CHECK_MSG(gain[0] < 1e-3, "0.4 of the input rate came through at %.1f dB", 20 * log10(gain[0]));
+	TEST_CHECK_MSG(fabs(gain[1] - 1) < 1e-3, "0.05 of the input rate came through at %.4f", gain[1]);
+}
+
+AUDIO_TEST(resampler_blockSplits)
+{
+	// at a fixed step the blocks are just bookkeeping, so tiny ones give exactly what one big one does;
+	// along a ramp the step and filter follow the blocks, so the reference has the same blocks but all of
+	// the input from the start, which shows whether getInputNeeded() covers the history and lookahead
+	const UINT32 frames = 30000;
+	const UINT32 fine[] = { 1, 64, 333, 17 };
+	const UINT32 whole[] = { 8192 };
+	vector<FLOAT32> in = makeTone(frames, 2, 0.01);
+	for(UINT32 q = 0; q < QUALITY_COUNT; ++q){
+		for(int ramp = 0; ramp < 2; ++ramp){
+			double from = ramp ? 0.8 : 1.37;
+			double to = ramp ? 2.6 : 1.37;
+			Resampler streamed, reference;
+			streamed.init(2, qualities[q]);
+			reference.init(2, qualities[q]);
+			UINT32 shortPulls, unused;
+			vector<FLOAT32> out = resample(&streamed, in, fine, 4, from, to, &shortPulls);
+			vector<FLOAT32> expected = ramp ? resample(&reference, in, fine, 4, from, to, &unused, true)
+				: resample(&reference, in, whole, 1, from, to, &unused);
+			TEST_CHECK_MSG(shortPulls == 0, "%s, ramp %d: %u short pulls", qualityNames[q], ramp, shortPulls);
+			size_t compared = min(out.size(), expected.size());
+			UINT32 changed = 0;
+			for(size_t i = 0; i < compared; ++i)
+				changed += (out[i] == expected[i]) ? 0 : 1;
+			TEST_CHECK_MSG(changed == 0 && compared / 2 > frames / 3, "%s, ramp %d: %u of %u samples differ", qualityNames[q], ramp,
+				changed, (UINT32)compared);
+
+			// and no frame is lost or repeated: the tone never moves further in one frame than its slope allows
+			double slope = 0.5 * 2 * M_PI * 0.01 * max(from, to);
+			double jump = 0;
+			for(size_t i = 2 * 2 * streamed.getTaps(); i + 2 < out.size(); ++i)
+				jump = max(jump, fabs((double)out[i + 2] - out[i]));
+			TEST_CHECK_MSG(jump < slope * 1.05, "%s, ramp %d: a jump of %g where the tone moves %g", qualityNames[q], ramp, jump, slope);
+		}
+	}
+}
+
+/**
+// End of ResamplerTests.cpp
+ */
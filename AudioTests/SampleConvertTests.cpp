@@ -0,0 +1,284 @@
+/**
+ * @file	SampleConvertTests.cpp
+ *
+ * @brief	The load-time converters and the mixer's toPCM16(): every integer sample comes back from float
+ * 			unchanged, with every kernel, and the SSE2 and AVX2 kernels give exactly the scalar kernel's bytes
+ * 			for any input, NaNs and infinities included, at lengths that leave every size of tail and at
+ * 			unaligned addresses.
+ */
+
+#include "AudioTests.h"
+#include "SampleConvert.h"
+#include "MixKernels.h"
+#include <string.h>
+#include <math.h>
+#include <limits>
+#include <algorithm>
+
+static const MIX_KERNEL kernels[] = { MIX_KERNEL_SCALAR, MIX_KERNEL_SSE2, MIX_KERNEL_AVX2 };
+static const char* kernelNames[] = { "scalar", "sse2", "avx2" };
+static const UINT32 KERNEL_COUNT = 3;
+
+// Written past the end of every output buffer; a kernel that overruns changes it
+static const BYTE GUARD = 0xA5;
+static const UINT32 GUARD_BYTES = 64;
+
+/**
+ * @fn	static UINT32 nextRandom(UINT32* pState)
+ *
+ * @brief	A small LCG, so that every run checks the same samples.
+ *
+ * @date	10/17/2026
+ */
+static UINT32 nextRandom(UINT32* pState)
+{
+	*pState = *pState * 1664525u + 1013904223u;
+	return *pState >> 8;
+}
+
+/**
+ * @fn	static bool guardIntact(const vector<BYTE>& buffer, size_t end)
+ *
+ * @brief	Checks that nothing was written from end to the end of the buffer.
+ *
+ * @date	10/17/2026
+ */
+static bool guardIntact(const vector<BYTE>& buffer, size_t end)
+{
+	for(size_t i = end; i < buffer.size(); ++i){
+		if(buffer[i] != GUARD)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * @fn	static void checkRoundTrip(SAMPLE_FORMAT format, const BYTE* pSamples, UINT32 count, UINT32 offset)
+ *
+ * @brief	Converts count samples to float and back with every available kernel, and checks the bytes come
+ * 			back unchanged. The buffers start offset samples past an allocation, so that the vector loops
+ * 			see every misalignment their types allow.
+ *
+ * @date	10/17/2026
+ */
+static void checkRoundTrip(SAMPLE_FORMAT format, const BYTE* pSamples, UINT32 count, UINT32 offset)
+{
+	UINT32 bytes = count * getSampleBytes(format);
+	offset *= (format == SAMPLE_FORMAT_S16) ? 2 : 1; // 16 bit samples are written as INT16
+	vector<BYTE> in(offset + bytes);
+	vector<FLOAT32> floats(offset + count);
+	vector<BYTE> out(offset + bytes + GUARD_BYTES);
+	memcpy(&in[offset], pSamples, bytes);
+	for(UINT32 k = 0; k < KERNEL_COUNT; ++k){
+		if(!isMixKernelAvailable(kernels[k]))
+			continue;
+		memset(&out[0], GUARD, out.size());
+		convertToFloat(format, &in[offset], &floats[offset], count, kernels[k]);
+		convertFromFloat(format, &floats[offset], &out[offset], count, kernels[k]);
+		for(UINT32 i = 0; i < bytes; ++i){
+			if(out[offset + i] != in[offset + i]){
+				testFailed(__FILE__, __LINE__, "round trip", testFormat("%s, format %d, byte %u of %u: %02x became %02x",
+					kernelNames[k], (int)format, i, bytes, in[offset + i], out[offset + i]));
+				break;
+			}
+		}
+		TEST_CHECK_MSG(guardIntact(out, offset + bytes), "%s wrote past %u samples", kernelNames[k], count);
+	}
+}
+
+AUDIO_TEST(convert_roundTripU8)
+{
+	BYTE samples[256];
+	for(UINT32 i = 0; i < 256; ++i){
+		samples[i] = (BYTE)i;
+	}
+	for(UINT32 offset = 0; offset < 4; ++offset){
+		checkRoundTrip(SAMPLE_FORMAT_U8, samples, 256, offset);
+	}
+}
+
+AUDIO_TEST(convert_roundTripS16)
+{
+	vector<BYTE> samples(65536 * 2);
+	for(UINT32 i = 0; i < 65536; ++i){
+		samples[2 * i] = (BYTE)i;
+		samples[2 * i + 1] = (BYTE)(i >> 8);
+	}
+	for(UINT32 offset = 0; offset < 4; ++offset){
+		checkRoundTrip(SAMPLE_FORMAT_S16, &samples[0], 65536, offset);
+	}
+}
+
+AUDIO_TEST(convert_roundTripS24)
+{
+	// every 24 bit value, a block at a time
+	const UINT32 block = 1 << 16;
+	vector<BYTE> samples(block * 3);
+	for(UINT32 start = 0; start < (1u << 24); start += block){
+		for(UINT32 i = 0; i < block; ++i){
+			UINT32 v = start + i;
+			samples[3 * i] = (BYTE)v;
+			samples[3 * i + 1] = (BYTE)(v >> 8);
+			samples[3 * i + 2] = (BYTE)(v >> 16);
+		}
+		checkRoundTrip(SAMPLE_FORMAT_S24, &samples[0], block, start % 4);
+	}
+}
+
+AUDIO_TEST(convert_toFloatIsExact)
+{
+	// the scale is a power of two, so each sample is exactly its value over full scale
+	BYTE in[3] = { 0x00, 0x00, 0x80 };
+	FLOAT32 out;
+	for(UINT32 k = 0; k < KERNEL_COUNT; ++k){
+		convertToFloat(SAMPLE_FORMAT_S24, in, &out, 1, kernels[k]);
+		TEST_CHECK_MSG(out == -1.0f, "%s: %.9g", kernelNames[k], out);
+		convertToFloat(SAMPLE_FORMAT_S16, in + 1, &out, 1, kernels[k]);
+		TEST_CHECK_MSG(out == -1.0f, "%s: %.9g", kernelNames[k], out);
+		convertToFloat(SAMPLE_FORMAT_U8, in + 2, &out, 1, kernels[k]);
+		TEST_CHECK_MSG(out == 0.0f, "%s: %.9g", kernelNames[k], out);
+	}
+}
+
+/**
+ * @fn	static void makeTestFloats(vector<FLOAT32>* pFloats, UINT32 count, UINT32 seed)
+ *
+ * @brief	Samples that exercise the clamping and rounding: mostly random values a little beyond full scale,
+ * 			with exact halfway points for each format, full scale itself, zeros of both signs, infinities and
+ * 			NaNs mixed in.
+ *
+ * @date	10/17/2026
+ */
+static void makeTestFloats(vector<FLOAT32>* pFloats, UINT32 count, UINT32 seed)
+{
+	const FLOAT32 specials[] = {
+		0.0f, -0.0f, 1.0f, -1.0f, 1.5f, -1.5f,
+		0.5f / 128.0f, -0.5f / 128.0f, 1.5f / 128.0f, 127.5f / 128.0f,
+		0.5f / 32768.0f, -0.5f / 32768.0f, 2.5f / 32768.0f, 32767.5f / 32768.0f, -32768.5f / 32768.0f,
+		0.5f / 8388608.0f, -1.5f / 8388608.0f, 8388607.5f / 8388608.0f,
+		numeric_limits<FLOAT32>::infinity(), -numeric_limits<FLOAT32>::infinity(),
+		numeric_limits<FLOAT32>::quiet_NaN(), -numeric_limits<FLOAT32>::quiet_NaN(),
+		numeric_limits<FLOAT32>::max(), -numeric_limits<FLOAT32>::max(), numeric_limits<FLOAT32>::denorm_min()
+	};
+	const UINT32 specialCount = sizeof(specials) / sizeof(specials[0]);
+	UINT32 state = seed;
+	pFloats->resize(count);
+	for(UINT32 i = 0; i < count; ++i){
+		UINT32 r = nextRandom(&state);
+		if(r % 4 == 0)
+			(*pFloats)[i] = specials[(r / 4) % specialCount];
+		else
+			(*pFloats)[i] = ((FLOAT32)(r & 0xFFFF) / 32768.0f - 1.0f) * 1.1f;
+	}
+}
+
+AUDIO_TEST(convert_kernelsMatchScalar)
+{
+	const MixKernels* pScalarMix = getMixKernels(MIX_KERNEL_SCALAR);
+	const SampleConverters* pScalar = getSampleConverters(MIX_KERNEL_SCALAR);
+	vector<UINT32> lengths;
+	for(UINT32 n = 0; n <= 70; ++n){
+		lengths.push_back(n);
+	}
+	lengths.push_back(1021);
+	lengths.push_back(4099);
+
+	vector<FLOAT32> floats;
+	for(size_t l = 0; l < lengths.size(); ++l){
+		UINT32 count = lengths[l];
+		UINT32 offset = (UINT32)l % 4;
+		makeTestFloats(&floats, count + 1, (UINT32)l + 1);
+
+		// misaligned for the vector loads, by whole samples
+		floats.insert(floats.begin(), offset, 0.0f);
+		const FLOAT32* pIn = &floats[offset];
+
+		vector<BYTE> want(2 * offset + count * 3 + GUARD_BYTES);
+		vector<BYTE> got(want.size());
+		for(UINT32 k = 1; k < KERNEL_COUNT; ++k){
+			if(!isMixKernelAvailable(kernels[k]))
+				continue;
+			const SampleConverters* pConverters = getSampleConverters(kernels[k]);
+			const MixKernels* pMix = getMixKernels(kernels[k]);
+
+			memset(&want[0], GUARD, want.size());
+			memset(&got[0], GUARD, got.size());
+			pScalar->toU8(pIn, &want[offset], count);
+			pConverters->toU8(pIn, &got[offset], count);
+			TEST_CHECK_MSG(want == got, "%s toU8, %u samples", kernelNames[k], count);
+
+			memset(&want[0], GUARD, want.size());
+			memset(&got[0], GUARD, got.size());
+			pScalarMix->toPCM16(pIn, (INT16*)&want[2 * offset], count);
+			pMix->toPCM16(pIn, (INT16*)&got[2 * offset], count);
+			TEST_CHECK_MSG(want == got, "%s toPCM16, %u samples", kernelNames[k], count);
+
+			memset(&want[0], GUARD, want.size());
+			memset(&got[0], GUARD, got.size());
+			pScalar->toS24(pIn, &want[offset], count);
+			pConverters->toS24(pIn, &got[offset], count);
+			TEST_CHECK_MSG(want == got, "%s toS24, %u samples", kernelNames[k], count);
+			TEST_CHECK_MSG(guardIntact(got, offset + count * 3), "%s toS24 wrote past %u samples", kernelNames[k], count);
+		}
+	}
+}
+
+AUDIO_TEST(convert_fromKernelsMatchScalar)
+{
+	const SampleConverters* pScalar = getSampleConverters(MIX_KERNEL_SCALAR);
+	UINT32 state = 7;
+	for(UINT32 count = 0; count <= 70; ++count){
+		UINT32 offset = count % 4;
+		vector<BYTE> in(2 * offset + count * 3 + 1);
+		for(size_t i = 0; i < in.size(); ++i){
+			in[i] = (BYTE)nextRandom(&state);
+		}
+		vector<FLOAT32> want(count + GUARD_BYTES / sizeof(FLOAT32), -2.0f);
+		vector<FLOAT32> got(want.size());
+		for(UINT32 k = 1; k < KERNEL_COUNT; ++k){
+			if(!isMixKernelAvailable(kernels[k]))
+				continue;
+			const SampleConverters* pConverters = getSampleConverters(kernels[k]);
+			void (*scalarFrom[3])(const BYTE*, FLOAT32*, UINT32) = { pScalar->fromU8, pScalar->fromS16, pScalar->fromS24 };
+			void (*kernelFrom[3])(const BYTE*, FLOAT32*, UINT32) = { pConverters->fromU8, pConverters->fromS16, pConverters->fromS24 };
+			for(UINT32 f = 0; f < 3; ++f){
+				fill(want.begin(), want.end(), -2.0f);
+				fill(got.begin(), got.end(), -2.0f);
+				// 16 bit samples are read as bytes, but a WAV's data chunk starts on an even offset
+				UINT32 start = (f == 1) ? 2 * offset : offset;
+				scalarFrom[f](&in[start], &want[0], count);
+				kernelFrom[f](&in[start], &got[0], count);
+				TEST_CHECK_MSG(memcmp(&want[0], &got[0], want.size() * sizeof(FLOAT32)) == 0,
+					"%s, %u byte samples, %u samples", kernelNames[k], f + 1, count);
+			}
+		}
+	}
+}
+
+AUDIO_TEST(convert_nanIsSilence)
+{
+	const UINT32 count = 37;
+	FLOAT32 in[count];
+	for(UINT32 i = 0; i < count; ++i){
+		in[i] = (i % 2) ? numeric_limits<FLOAT32>::quiet_NaN() : -numeric_limits<FLOAT32>::quiet_NaN();
+	}
+	for(UINT32 k = 0; k < KERNEL_COUNT; ++k){
+		if(!isMixKernelAvailable(kernels[k]))
+			continue;
+		BYTE u8[count];
+		INT16 s16[count];
+		BYTE s24[count * 3];
+		convertFromFloat(SAMPLE_FORMAT_U8, in, u8, count, kernels[k]);
+		convertFromFloat(SAMPLE_FORMAT_S16, in, (BYTE*)s16, count, kernels[k]);
+		convertFromFloat(SAMPLE_FORMAT_S24, in, s24, count, kernels[k]);
+		for(UINT32 i = 0; i < count; ++i){
+			TEST_CHECK_MSG(u8[i] == 128, "%s, sample %u: %u", kernelNames[k], i, u8[i]);
+			TEST_CHECK_MSG(s16[i] == 0, "%s, sample %u: %d", kernelNames[k], i, s16[i]);
+			TEST_CHECK_MSG(s24[3 * i] == 0 && s24[3 * i + 1] == 0 && s24[3 * i + 2] == 0, "%s, sample %u", kernelNames[k], i);
+		}
+	}
+}
+
+/**
+// End of SampleConvertTests.cpp
+ */
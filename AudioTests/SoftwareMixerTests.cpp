@@ -0,0 +1,110 @@
+/**
+ * @file	SoftwareMixerTests.cpp
+ *
+ * @brief	SoftwareMixer: one voice at unity gain, the output's rate and channel count renders its source bit
+ * 			for bit, however the render is split into blocks, and for exactly as many frames as it has.
+ */
+
+#include "AudioTests.h"
+#include "SoftwareMixer.h"
+
+static const RESAMPLER_QUALITY qualities[] = { RESAMPLER_QUALITY_LINEAR, RESAMPLER_QUALITY_SINC8, RESAMPLER_QUALITY_SINC32 };
+static const UINT32 QUALITY_COUNT = 3;
+
+static const MIX_KERNEL kernels[] = { MIX_KERNEL_SCALAR, MIX_KERNEL_SSE2, MIX_KERNEL_AVX2 };
+static const UINT32 KERNEL_COUNT = 3;
+
+/**
+ * @class	StreamEndCounter
+ *
+ * @brief	Counts a voice's onStreamEnd() calls.
+ */
+class StreamEndCounter : public MixerVoiceCallback
+{
+public:
+	StreamEndCounter() : streamEnds(0){};
+	void onStreamEnd(){streamEnds++;};
+	UINT32 streamEnds;
+};
+
+/**
+ * @fn	static vector<INT16> makeNoise16(UINT32 samples)
+ *
+ * @brief	16 bit noise, the same every run, that is never 0 so that the end of the sound can be seen.
+ *
+ * @date	10/17/2026
+ */
+static vector<INT16> makeNoise16(UINT32 samples)
+{
+	vector<INT16> noise(samples);
+	UINT32 state = 12345;
+	for(UINT32 i = 0; i < samples; ++i){
+		state = state * 1664525u + 1013904223u;
+		noise[i] = (INT16)(state >> 16);
+		if(noise[i] == 0)
+			noise[i] = 1;
+	}
+	return noise;
+}
+
+AUDIO_TEST(mixer_unityBitExact)
+{
+	// not a whole number of quanta, and rendered in blocks that don't line up with them either, as
+	// BasicAudio::renderOffline() does with the last block of each step
+	const UINT32 FRAMES = 4801;
+	const UINT32 RENDERED = 6000;
+	const UINT32 blocks[] = { 480, 7, 333, 1 };
+	WAVEFORMATEX format = { WAVE_FORMAT_PCM, 2, 48000, 192000, 4, 16, 0 };
+	vector<INT16> source = makeNoise16(FRAMES * 2);
+
+	for(UINT32 k = 0; k < KERNEL_COUNT; ++k){
+		if(!isMixKernelAvailable(kernels[k]))
+			continue;
+		for(UINT32 q = 0; q < QUALITY_COUNT; ++q){
+			SoftwareMixer mixer;
+			TEST_CHECK(SUCCEEDED(mixer.init(48000, 2)));
+			TEST_CHECK(mixer.setKernel(kernels[k]));
+			mixer.setResamplerQuality(qualities[q]);
+
+			StreamEndCounter counter;
+			MixerVoice* pVoice = NULL;
+			TEST_CHECK(SUCCEEDED(mixer.createVoice(&format, 2.0f, &counter, &pVoice)));
+			MixerBuffer buffer = { MIXER_END_OF_STREAM, FRAMES * 4, (const BYTE*)&source[0], 0, 0, 0, 0, 0, NULL };
+			TEST_CHECK(SUCCEEDED(pVoice->submitBuffer(&buffer)));
+			TEST_CHECK(SUCCEEDED(pVoice->start()));
+
+			vector<FLOAT32> out(RENDERED * 2);
+			UINT32 rendered = 0;
+			for(UINT32 b = 0; rendered < RENDERED; ++b){
+				UINT32 frames = blocks[b % 4];
+				if(frames > RENDERED - rendered)
+					frames = RENDERED - rendered;
+				mixer.render(&out[rendered * 2], frames);
+				rendered += frames;
+			}
+
+			// every sample is the source's, converted exactly, and then nothing
+			UINT32 wrong = 0;
+			UINT32 firstWrong = 0;
+			for(UINT32 i = 0; i < RENDERED * 2; ++i){
+				FLOAT32 expected = (i < FRAMES * 2) ? source[i] * (1.0f / 32768.0f) : 0.0f;
+				if(out[i] != expected && wrong++ == 0)
+					firstWrong = i;
+			}
+			TEST_CHECK_MSG(wrong == 0, "kernel %u, quality %u: %u samples differ, the first at frame %u", k, q,
+				wrong, firstWrong / 2);
+			TEST_CHECK_MSG(counter.streamEnds == 1, "kernel %u, quality %u: %u stream ends", k, q, counter.streamEnds);
+			TEST_CHECK(mixer.getActiveVoiceCount() == 0);
+
+			// and written back out at 16 bits, as an offline render is, it is the source again
+			vector<INT16> pcm(FRAMES * 2);
+			SoftwareMixer::toPCM16(&out[0], &pcm[0], FRAMES * 2);
+			TEST_CHECK_MSG(pcm == source, "kernel %u, quality %u: the 16 bit output differs", k, q);
+			mixer.destroyVoice(pVoice);
+		}
+	}
+}
+
+/**
+// End of SoftwareMixerTests.cpp
+ */
@@ -0,0 +1,93 @@
+/**
+ * @file	SoundHandlesTests.cpp
+ *
+ * @brief	SoundHandleTable: handles to removed or cleared items stop resolving, even once their slot is reused,
+ * 			and a full table refuses more.
+ */
+
+#include "AudioTests.h"
+#include "SoundHandles.h"
+
+AUDIO_TEST(handles_staleAfterRemove)
+{
+	SoundHandleTable<int*> table;
+	int a = 1, b = 2, c = 3;
+	SOUND_HANDLE ha = table.add(&a);
+	SOUND_HANDLE hb = table.add(&b);
+	TEST_CHECK(ha != SOUND_HANDLE_INVALID && hb != SOUND_HANDLE_INVALID && ha != hb);
+	TEST_CHECK(table.get(ha) == &a && table.get(hb) == &b);
+
+	TEST_CHECK(table.remove(ha));
+	TEST_CHECK(table.get(ha) == NULL);
+	TEST_CHECK(!table.isValid(ha));
+	TEST_CHECK(!table.remove(ha));
+	TEST_CHECK(table.get(hb) == &b);
+	TEST_CHECK(table.getCount() == 1);
+
+	// c gets a's slot under a new generation, so a's handle still misses
+	SOUND_HANDLE hc = table.add(&c);
+	TEST_CHECK_MSG((hc & 0xFFFF) == (ha & 0xFFFF), "handle %#x after %#x", hc, ha);
+	TEST_CHECK(hc != ha);
+	TEST_CHECK(table.get(ha) == NULL);
+	TEST_CHECK(table.get(hc) == &c);
+	TEST_CHECK(table.getSlot(ha & 0xFFFF) == &c);
+	TEST_CHECK(table.get(SOUND_HANDLE_INVALID) == NULL);
+}
+
+AUDIO_TEST(handles_generationSkipsZero)
+{
+	// a slot reused 0xFFFF times wraps its generation past 0, which would make a handle of 0 possible
+	SoundHandleTable<int*> table;
+	int a = 1;
+	SOUND_HANDLE first = table.add(&a);
+	SOUND_HANDLE h = first;
+	for(UINT32 i = 0; i < 0x10000; ++i){
+		TEST_CHECK(table.remove(h));
+		h = table.add(&a);
+		TEST_CHECK(h != SOUND_HANDLE_INVALID && (h >> 16) != 0);
+	}
+	TEST_CHECK(table.get(h) == &a);
+}
+
+AUDIO_TEST(handles_staleAfterClear)
+{
+	// the slots are reused after a clear, but under new generations, so old handles don't reach new items
+	SoundHandleTable<int*> table;
+	int a = 1, b = 2, c = 3, d = 4;
+	SOUND_HANDLE ha = table.add(&a);
+	SOUND_HANDLE hb = table.add(&b);
+	table.clear();
+	TEST_CHECK(table.getCount() == 0);
+	TEST_CHECK(table.get(ha) == NULL && table.get(hb) == NULL);
+	TEST_CHECK(!table.remove(ha));
+
+	SOUND_HANDLE hc = table.add(&c);
+	SOUND_HANDLE hd = table.add(&d);
+	TEST_CHECK_MSG((hc & 0xFFFF) == (ha & 0xFFFF) && (hd & 0xFFFF) == (hb & 0xFFFF), "handles %#x, %#x after %#x, %#x",
+		hc, hd, ha, hb);
+	TEST_CHECK(hc != ha && hd != hb);
+	TEST_CHECK(table.get(ha) == NULL && table.get(hb) == NULL);
+	TEST_CHECK(table.get(hc) == &c && table.get(hd) == &d);
+	TEST_CHECK(table.getSlotCount() == 2 && table.getCount() == 2);
+}
+
+AUDIO_TEST(handles_full)
+{
+	SoundHandleTable<int*> table;
+	int a = 1;
+	SOUND_HANDLE first = table.add(&a);
+	for(UINT32 i = 1; i < SOUND_HANDLE_MAX_SLOTS; ++i)
+		table.add(&a);
+	TEST_CHECK(table.getCount() == SOUND_HANDLE_MAX_SLOTS);
+	TEST_CHECK(table.add(&a) == SOUND_HANDLE_INVALID);
+	TEST_CHECK(table.getCount() == SOUND_HANDLE_MAX_SLOTS);
+
+	// a freed slot can be had again
+	TEST_CHECK(table.remove(first));
+	SOUND_HANDLE again = table.add(&a);
+	TEST_CHECK(again != SOUND_HANDLE_INVALID && again != first);
+}
+
+/**
+// End of SoundHandlesTests.cpp
+ */
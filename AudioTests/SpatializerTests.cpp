@@ -0,0 +1,294 @@
+/**
+ * @file	SpatializerTests.cpp
+ *
+ * @brief	The spatializer against reference values worked out by hand from X3DAudio's documented behaviour:
+ * 			distances, the volume, reverb and LPF direct curves scaled by CurveDistanceScaler, the Doppler
+ * 			formula and its limit, constant power panning between speakers, inner radius spread, the 5.1
+ * 			centre and LFE speakers and listener orientation. Then the SSE and AVX kernels against the
+ * 			scalar one over many random emitters.
+ */
+
+#include "AudioTests.h"
+#include "Spatializer.h"
+#include "EmitterSoA.h"
+#include <math.h>
+
+static const FLOAT32 TOLERANCE = 1.0e-5f;
+static const FLOAT32 HALF_POWER = 0.70710678f; // cos(pi / 4), each speaker's share of a sound half way between two
+
+// Stereo output channels, and 5.1 ones in mask order
+enum { LEFT, RIGHT };
+enum { FL, FR, FC, LFE, BL, BR };
+
+static bool nearlyEqual(FLOAT32 a, FLOAT32 b)
+{
+	return fabsf(a - b) <= TOLERANCE;
+}
+
+/**
+ * @fn	static UINT32 addEmitter(EmitterSoA* pStore, FLOAT32 x, FLOAT32 y, FLOAT32 z)
+ *
+ * @brief	Adds a spatialized mono emitter at a position, otherwise as EmitterSoA::add() makes it.
+ *
+ * @date	10/17/2026
+ */
+static UINT32 addEmitter(EmitterSoA* pStore, FLOAT32 x, FLOAT32 y, FLOAT32 z)
+{
+	UINT32 i = pStore->add((SOUND_HANDLE)(pStore->getCount() + 1));
+	pStore->posX[i] = x;
+	pStore->posY[i] = y;
+	pStore->posZ[i] = z;
+	pStore->spatialized[i] = 1;
+	return i;
+}
+
+/**
+ * @fn	static FLOAT32 matrixPower(EmitterSoA* pStore, UINT32 i)
+ *
+ * @brief	The emitter's level over all speakers: with constant power panning, its volume curve setting.
+ *
+ * @date	10/17/2026
+ */
+static FLOAT32 matrixPower(EmitterSoA* pStore, UINT32 i)
+{
+	const FLOAT32* m = pStore->getMatrix(i);
+	FLOAT32 sum = 0;
+	for(UINT32 c = 0; c < pStore->getMatrixSize(i); ++c){
+		sum += m[c] * m[c];
+	}
+	return sqrtf(sum);
+}
+
+AUDIO_TEST(spatial_distanceAndCurves)
+{
+	// default curves: volume 1 to 0 linearly, reverb 0.5 up to 1 at 0.75 then down to 0, LPF 1 down to 0.75
+	struct Case { FLOAT32 z, scaler, distance, volume, reverb, lpf; };
+	const Case cases[] = {
+		{ 0.0f, 1.0f, 0.0f, 1.0f, 0.5f, 1.0f },
+		{ 0.25f, 1.0f, 0.25f, 0.75f, 0.5f + 0.5f / 3.0f, 0.9375f },
+		{ 5.0f, 10.0f, 5.0f, 0.5f, 0.5f + 0.5f * 0.5f / 0.75f, 0.875f },
+		{ 8.75f, 10.0f, 8.75f, 0.125f, 0.5f, 0.78125f },
+		{ 30.0f, 10.0f, 30.0f, 0.0f, 0.0f, 0.75f },    // past the last point the last setting holds
+	};
+	for(UINT32 k = 0; k < 3; ++k){
+		Spatializer sp;
+		if(!sp.setKernel((SPATIALIZER_KERNEL)k))
+			continue;
+		EmitterSoA store;
+		for(UINT32 c = 0; c < 5; ++c){
+			UINT32 i = addEmitter(&store, 0, 0, cases[c].z);
+			store.curveDistanceScaler[i] = cases[c].scaler;
+		}
+		sp.process(&store);
+		for(UINT32 c = 0; c < 5; ++c){
+			TEST_CHECK_MSG(nearlyEqual(store.distance[c], cases[c].distance), "kernel %u, case %u: distance %g", k, c, store.distance[c]);
+			TEST_CHECK_MSG(nearlyEqual(matrixPower(&store, c), cases[c].volume), "kernel %u, case %u: volume %g", k, c, matrixPower(&store, c));
+			TEST_CHECK_MSG(nearlyEqual(store.reverbLevel[c], cases[c].reverb), "kernel %u, case %u: reverb %g", k, c, store.reverbLevel[c]);
+			TEST_CHECK_MSG(nearlyEqual(store.lpfDirect[c], cases[c].lpf), "kernel %u, case %u: LPF %g", k, c, store.lpfDirect[c]);
+		}
+	}
+}
+
+AUDIO_TEST(spatial_customCurve)
+{
+	// three points, with a flat start, as a game might set for a sound that carries
+	const SpatialCurvePoint points[] = { {0.0f, 1.0f}, {0.5f, 1.0f}, {1.0f, 0.2f} };
+	Spatializer sp;
+	TEST_CHECK(sp.setVolumeCurve(points, 3));
+	EmitterSoA store;
+	addEmitter(&store, 0, 0, 0.25f);
+	addEmitter(&store, 0, 0, 0.75f);
+	sp.process(&store);
+	TEST_CHECK_MSG(nearlyEqual(matrixPower(&store, 0), 1.0f), "%g", matrixPower(&store, 0));
+	TEST_CHECK_MSG(nearlyEqual(matrixPower(&store, 1), 0.6f), "%g", matrixPower(&store, 1));
+}
+
+AUDIO_TEST(spatial_doppler)
+{
+	// X3DAudio: (c - ds * listener velocity toward the emitter) / (c - ds * emitter velocity toward the
+	// listener), with the velocities taken along the line between them, and no more than the voice allows
+	const FLOAT32 c = SPATIALIZER_SPEED_OF_SOUND;
+	Spatializer sp;
+	SpatialListener moving = { {0, 0, 0}, {0, 0, c / 4}, {0, 0, 1}, {0, 1, 0} };
+	EmitterSoA store;
+	UINT32 approaching = addEmitter(&store, 0, 0, 10);
+	store.velZ[approaching] = -c / 10;
+	UINT32 receding = addEmitter(&store, 0, 0, 10);
+	store.velZ[receding] = c / 10;
+	UINT32 sideways = addEmitter(&store, 0, 0, 10);
+	store.velX[sideways] = c / 2;
+	UINT32 unscaled = addEmitter(&store, 0, 0, 10);
+	store.velZ[unscaled] = -c / 10;
+	store.dopplerScaler[unscaled] = 0;
+	UINT32 fast = addEmitter(&store, 0, 0, 10);
+	store.velZ[fast] = -0.9f * c;
+	sp.process(&store);
+	TEST_CHECK_MSG(nearlyEqual(store.doppler[approaching], 1.0f / 0.9f), "%.7f", store.doppler[approaching]);
+	TEST_CHECK_MSG(nearlyEqual(store.doppler[receding], 1.0f / 1.1f), "%.7f", store.doppler[receding]);
+	TEST_CHECK_MSG(nearlyEqual(store.doppler[sideways], 1.0f), "%.7f", store.doppler[sideways]);
+	TEST_CHECK_MSG(nearlyEqual(store.doppler[unscaled], 1.0f), "%.7f", store.doppler[unscaled]);
+	TEST_CHECK_MSG(nearlyEqual(store.doppler[fast], SPATIALIZER_MAX_DOPPLER), "%.7f", store.doppler[fast]);
+
+	// the listener moving toward a still emitter
+	sp.setListener(moving);
+	EmitterSoA still;
+	addEmitter(&still, 0, 0, 10);
+	sp.process(&still);
+	TEST_CHECK_MSG(nearlyEqual(still.doppler[0], 1.25f), "%.7f", still.doppler[0]);
+}
+
+AUDIO_TEST(spatial_stereoPanning)
+{
+	// the speakers are 45 degrees either side of front: a sound on one is only heard there, half way between
+	// two it is heard equally from both at half power, and straight behind is half way round the back
+	Spatializer sp;
+	EmitterSoA store;
+	UINT32 ahead = addEmitter(&store, 0, 0, 0.5f);
+	UINT32 onRight = addEmitter(&store, 0.25f, 0, 0.25f);
+	UINT32 onLeft = addEmitter(&store, -0.25f, 0, 0.25f);
+	UINT32 behind = addEmitter(&store, 0, 0, -0.5f);
+	sp.process(&store);
+	const FLOAT32 gain = 0.5f;
+	const FLOAT32 cornerGain = 1.0f - sqrtf(0.125f);
+	TEST_CHECK(nearlyEqual(store.getMatrix(ahead)[LEFT], gain * HALF_POWER) && nearlyEqual(store.getMatrix(ahead)[RIGHT], gain * HALF_POWER));
+	TEST_CHECK_MSG(nearlyEqual(store.getMatrix(onRight)[LEFT], 0) && nearlyEqual(store.getMatrix(onRight)[RIGHT], cornerGain),
+		"%g %g", store.getMatrix(onRight)[LEFT], store.getMatrix(onRight)[RIGHT]);
+	TEST_CHECK_MSG(nearlyEqual(store.getMatrix(onLeft)[LEFT], cornerGain) && nearlyEqual(store.getMatrix(onLeft)[RIGHT], 0),
+		"%g %g", store.getMatrix(onLeft)[LEFT], store.getMatrix(onLeft)[RIGHT]);
+	TEST_CHECK(nearlyEqual(store.getMatrix(behind)[LEFT], gain * HALF_POWER) && nearlyEqual(store.getMatrix(behind)[RIGHT], gain * HALF_POWER));
+}
+
+AUDIO_TEST(spatial_listenerOrientation)
+{
+	// facing +X with +Y up, the listener's right is -Z
+	Spatializer sp;
+	SpatialListener turned = { {10, 0, 10}, {0, 0, 0}, {1, 0, 0}, {0, 1, 0} };
+	sp.setListener(turned);
+	EmitterSoA store;
+	UINT32 diagonal = addEmitter(&store, 11, 0, 9);
+	UINT32 ahead = addEmitter(&store, 11, 0, 10);
+	store.curveDistanceScaler[diagonal] = 100;
+	store.curveDistanceScaler[ahead] = 100;
+	sp.process(&store);
+	FLOAT32 gain = 1.0f - sqrtf(2.0f) / 100;
+	TEST_CHECK_MSG(nearlyEqual(store.getMatrix(diagonal)[LEFT], 0) && nearlyEqual(store.getMatrix(diagonal)[RIGHT], gain),
+		"%g %g", store.getMatrix(diagonal)[LEFT], store.getMatrix(diagonal)[RIGHT]);
+	gain = 1.0f - 1.0f / 100;
+	TEST_CHECK(nearlyEqual(store.getMatrix(ahead)[LEFT], gain * HALF_POWER) && nearlyEqual(store.getMatrix(ahead)[RIGHT], gain * HALF_POWER));
+}
+
+AUDIO_TEST(spatial_innerRadius)
+{
+	// inside the inner radius a sound spreads towards every speaker evenly, entirely so at the centre
+	Spatializer sp;
+	EmitterSoA store;
+	UINT32 centre = addEmitter(&store, 0, 0, 0);
+	UINT32 half = addEmitter(&store, 0.25f, 0, 0.25f);
+	store.innerRadius[centre] = 1.0f;
+	store.innerRadius[half] = 2.0f * sqrtf(0.125f);
+	sp.process(&store);
+	TEST_CHECK(nearlyEqual(store.getMatrix(centre)[LEFT], HALF_POWER) && nearlyEqual(store.getMatrix(centre)[RIGHT], HALF_POWER));
+
+	// half way to the edge: half the level on the right speaker, the other half spread
+	FLOAT32 gain = 1.0f - sqrtf(0.125f);
+	FLOAT32 spread = 0.5f * gain * HALF_POWER;
+	TEST_CHECK_MSG(nearlyEqual(store.getMatrix(half)[LEFT], spread) && nearlyEqual(store.getMatrix(half)[RIGHT], 0.5f * gain + spread),
+		"%g %g", store.getMatrix(half)[LEFT], store.getMatrix(half)[RIGHT]);
+}
+
+AUDIO_TEST(spatial_centreAndLFE)
+{
+	// on 5.1 a sound straight ahead is only on the centre speaker, and nothing but LFE channels reach the LFE
+	Spatializer sp;
+	sp.setSpeakers(0x3F, 6);
+	EmitterSoA store;
+	store.setMatrixSize(6, 6);
+	UINT32 mono = addEmitter(&store, 0, 0, 0.5f);
+	UINT32 surround = addEmitter(&store, 0, 0, 0.5f);
+	const FLOAT32 azimuths[6] = { 7 * 6.2831853f / 8, 6.2831853f / 8, 0, EMITTER_LFE_AZIMUTH, 5 * 6.2831853f / 8, 3 * 6.2831853f / 8 };
+	store.setChannels(surround, 6, 0.0f, azimuths);
+	sp.process(&store);
+
+	const FLOAT32* m = store.getMatrix(mono);
+	for(UINT32 d = 0; d < 6; ++d){
+		TEST_CHECK_MSG(nearlyEqual(m[d], (d == FC) ? 0.5f : 0.0f), "speaker %u: %g", d, m[d]);
+	}
+
+	// with no channel radius every channel is heard from the emitter, so all but the LFE land on the centre
+	m = store.getMatrix(surround);
+	for(UINT32 s = 0; s < 6; ++s){
+		for(UINT32 d = 0; d < 6; ++d){
+			FLOAT32 want = ((s == LFE) == (d == LFE) && (d == FC || d == LFE)) ? 0.5f : 0.0f;
+			TEST_CHECK_MSG(nearlyEqual(m[6 * d + s], want), "channel %u to speaker %u: %g", s, d, m[6 * d + s]);
+		}
+	}
+}
+
+/**
+ * @fn	static void checkKernelsAgree(DWORD channelMask, UINT32 channelCount)
+ *
+ * @brief	Runs 10000 random emitters through every kernel onto the given speakers and compares each result
+ * 			with the scalar kernel's.
+ *
+ * @date	10/17/2026
+ */
+static void checkKernelsAgree(DWORD channelMask, UINT32 channelCount)
+{
+	const UINT32 count = 10000;
+	SpatialListener listener = { {1, 2, 3}, {3, 0, -2}, {0.6f, 0, 0.8f}, {0, 1, 0} };
+	EmitterSoA stores[3];
+	UINT32 state = 12345;
+	for(UINT32 k = 0; k < 3; ++k){
+		state = 12345;
+		for(UINT32 n = 0; n < count; ++n){
+			FLOAT32 v[8];
+			for(UINT32 r = 0; r < 8; ++r){
+				state = state * 1664525u + 1013904223u;
+				v[r] = (FLOAT32)(state >> 8) / (FLOAT32)(1 << 24) * 2.0f - 1.0f;
+			}
+			UINT32 i = addEmitter(&stores[k], v[0] * 50, v[1] * 5, v[2] * 50);
+			stores[k].velX[i] = v[3] * 100;
+			stores[k].velZ[i] = v[4] * 100;
+			stores[k].curveDistanceScaler[i] = 20 + v[5] * 15;
+			stores[k].innerRadius[i] = (v[6] > 0) ? v[6] * 10 : 0;
+			stores[k].spatialized[i] = (v[7] > -0.9f) ? 1 : 0;
+		}
+	}
+
+	Spatializer reference;
+	reference.setKernel(SPATIALIZER_KERNEL_SCALAR);
+	reference.setSpeakers(channelMask, channelCount);
+	reference.setListener(listener);
+	reference.process(&stores[0]);
+	for(UINT32 k = 1; k < 3; ++k){
+		Spatializer sp;
+		if(!sp.setKernel((SPATIALIZER_KERNEL)k))
+			continue;
+		sp.setSpeakers(channelMask, channelCount);
+		sp.setListener(listener);
+		sp.process(&stores[k]);
+		UINT32 mismatches = 0;
+		for(UINT32 i = 0; i < count; ++i){
+			bool same = nearlyEqual(stores[k].doppler[i], stores[0].doppler[i]) && nearlyEqual(stores[k].distance[i], stores[0].distance[i])
+				&& nearlyEqual(stores[k].reverbLevel[i], stores[0].reverbLevel[i]) && nearlyEqual(stores[k].lpfDirect[i], stores[0].lpfDirect[i]);
+			for(UINT32 c = 0; c < stores[0].getMatrixSize(i); ++c){
+				same = same && nearlyEqual(stores[k].getMatrix(i)[c], stores[0].getMatrix(i)[c]);
+			}
+			mismatches += same ? 0 : 1;
+		}
+		TEST_CHECK_MSG(mismatches == 0, "%u channels: kernel %u differs from scalar for %u of %u emitters",
+			channelCount, k, mismatches, count);
+	}
+}
+
+AUDIO_TEST(spatial_kernelsAgree)
+{
+	// the vector kernels find each emitter's speaker pair themselves, so more speakers is more to get wrong
+	checkKernelsAgree(SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT, 2);
+	checkKernelsAgree(0x3F, 6);
+	checkKernelsAgree(0x63F, 8);
+}
+
+/**
+// End of SpatializerTests.cpp
+ */
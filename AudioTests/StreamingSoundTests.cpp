@@ -0,0 +1,73 @@
+/**
+ * @file	StreamingSoundTests.cpp
+ *
+ * @brief	StreamingWavSampleSound, through a BasicAudio on the offline engine so that no audio device is
+ * 			needed. This uses XAudio2's interfaces, so it is only built by AudioTests.vcxproj.
+ */
+
+#include "AudioTests.h"
+#include "BasicAudio.h"
+#include "AdpcmCodec.h"
+#include <stdio.h>
+#include <math.h>
+
+/**
+ * @fn	static string writeAdpcmFixture()
+ *
+ * @brief	Writes a second of an IMA ADPCM tone, with its 'fact' chunk.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The file's path, empty if it couldn't be written.
+ */
+static string writeAdpcmFixture()
+{
+	const UINT32 frames = 22050;
+	BYTE format[ADPCM_FORMAT_BYTES];
+	AdpcmFormat adpcm;
+	UINT32 formatBytes = makeAdpcmFormat(ADPCM_TYPE_IMA, 1, 22050, 512, format);
+	if(formatBytes == 0 || FAILED(getAdpcmFormat((const WAVEFORMATEX*)format, &adpcm)))
+		return string();
+	vector<INT16> pcm(frames);
+	for(UINT32 i = 0; i < frames; ++i)
+		pcm[i] = (INT16)(12000.0f * sinf(i * 0.05f));
+	vector<BYTE> encoded((size_t)getAdpcmEncodedBytes(&adpcm, frames));
+	UINT32 bytes = encodeAdpcm(&adpcm, &pcm[0], frames, &encoded[0]);
+	return writeTestWav((const WAVEFORMATEX*)format, formatBytes, &encoded[0], bytes, frames);
+}
+
+AUDIO_TEST(streaming_loadState)
+{
+	BasicAudio ba;
+	ba.initOffline(48000, 2);
+	TEST_CHECK(ba.isOffline());
+	if(!ba.isOffline())
+		return;
+
+	// streamed and compressed sounds load on the caller's thread, so they are ready or failed at once
+	TEST_PATH heli = toTestPath(getTestWavDir() + "/heli.wav");
+	SampleSound* streamed = ba.createStreamingSound(L"streamed", heli.c_str(), 0);
+	TEST_CHECK_MSG(streamed->getLoadState() == SOUND_LOAD_READY, "streamed: state %d", streamed->getLoadState());
+	TEST_CHECK(SUCCEEDED(streamed->start()));
+
+	string adpcmPath = writeAdpcmFixture();
+	TEST_CHECK(!adpcmPath.empty());
+	SampleSound* compressed = ba.createCompressedSound(L"compressed", toTestPath(adpcmPath).c_str(), 0);
+	TEST_CHECK_MSG(compressed->getLoadState() == SOUND_LOAD_READY, "compressed: state %d", compressed->getLoadState());
+
+	TEST_PATH missing = toTestPath(getTestWavDir() + "/missing.wav");
+	SampleSound* failed = ba.createStreamingSound(L"missing", missing.c_str(), 0);
+	TEST_CHECK_MSG(failed->getLoadState() == SOUND_LOAD_FAILED, "missing: state %d", failed->getLoadState());
+	TEST_CHECK(FAILED(failed->start()));
+
+	// a destroyed sound can't be played any more
+	streamed->destroy();
+	TEST_CHECK(streamed->getLoadState() == SOUND_LOAD_FAILED);
+
+	ba.destroy();
+	remove(adpcmPath.c_str());
+}
+
+/**
+// End of StreamingSoundTests.cpp
+ */
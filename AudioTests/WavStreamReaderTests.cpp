@@ -0,0 +1,200 @@
+/**
+ * @file	WavStreamReaderTests.cpp
+ *
+ * @brief	WavStreamReader: a ring smaller than the file is refilled until the whole of the data has come
+ * 			through in order, loops follow on without a gap, the last block is short and is the only one marked
+ * 			as the end of the stream, and rewind() starts it all again.
+ */
+
+#include "AudioTests.h"
+#include "WavStreamReader.h"
+#include <stdio.h>
+#include <string.h>
+
+static const UINT32 BUFFER_BYTES = 400;
+static const UINT32 BUFFER_COUNT = 3;
+
+/**
+ * @fn	static vector<INT16> makeRamp(UINT32 samples)
+ *
+ * @brief	A ramp that doesn't repeat within 32768 samples, so that anything out of order shows.
+ *
+ * @date	10/17/2026
+ */
+static vector<INT16> makeRamp(UINT32 samples)
+{
+	vector<INT16> ramp(samples);
+	for(UINT32 i = 0; i < samples; ++i)
+		ramp[i] = (INT16)(i * 3 + 1);
+	return ramp;
+}
+
+/**
+ * @fn	static string writeStereoWav(const vector<INT16>& pcm)
+ *
+ * @brief	Writes 16 bit stereo samples to a file.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The file's path, empty if it couldn't be written.
+ */
+static string writeStereoWav(const vector<INT16>& pcm)
+{
+	WAVEFORMATEX format = { WAVE_FORMAT_PCM, 2, 22050, 88200, 4, 16, 0 };
+	return writeTestWav(&format, 16, &pcm[0], (UINT32)pcm.size() * 2);
+}
+
+/**
+ * @fn	static vector<BYTE> drain(WavStreamReader* pReader, vector<UINT32>* pSizes, UINT32* pEnds)
+ *
+ * @brief	Acquires and releases blocks until the reader has no more, as a voice would.
+ *
+ * @date	10/17/2026
+ *
+ * @param [out]	pSizes	The size of each block.
+ * @param [out]	pEnds 	The number of blocks marked as the end of the stream.
+ *
+ * @return	Everything the blocks held, in order.
+ */
+static vector<BYTE> drain(WavStreamReader* pReader, vector<UINT32>* pSizes, UINT32* pEnds)
+{
+	vector<BYTE> data;
+	pSizes->clear();
+	*pEnds = 0;
+	StreamBlock* block;
+	while((block = pReader->acquire(1000)) != NULL){
+		data.insert(data.end(), block->pData, block->pData + block->bytes);
+		pSizes->push_back(block->bytes);
+		if(block->endOfStream)
+			(*pEnds)++;
+		pReader->release(block);
+	}
+	return data;
+}
+
+/**
+ * @fn	static void checkBlocks(const vector<UINT32>& sizes, UINT32 ends, UINT32 totalBytes)
+ *
+ * @brief	Checks that every block but the last is full, that the last holds the rest, and that only it was
+ * 			marked as the end.
+ *
+ * @date	10/17/2026
+ */
+static void checkBlocks(const vector<UINT32>& sizes, UINT32 ends, UINT32 totalBytes)
+{
+	UINT32 expected = (totalBytes + BUFFER_BYTES - 1) / BUFFER_BYTES;
+	TEST_CHECK_MSG(sizes.size() == expected, "%u blocks, not %u", (UINT32)sizes.size(), expected);
+	if(sizes.size() != expected)
+		return;
+	for(UINT32 i = 0; i + 1 < expected; ++i)
+		TEST_CHECK_MSG(sizes[i] == BUFFER_BYTES, "block %u: %u bytes", i, sizes[i]);
+	UINT32 tail = totalBytes - (expected - 1) * BUFFER_BYTES;
+	TEST_CHECK_MSG(sizes[expected - 1] == tail, "last block: %u bytes, not %u", sizes[expected - 1], tail);
+	TEST_CHECK_MSG(ends == 1, "%u blocks marked as the end", ends);
+}
+
+AUDIO_TEST(stream_playsOnce)
+{
+	// 1001 frames is 10 full blocks and a 4 byte tail, through a ring of 3
+	vector<INT16> pcm = makeRamp(1001 * 2);
+	string path = writeStereoWav(pcm);
+	TEST_CHECK(!path.empty());
+	WavStreamReader reader;
+	TEST_CHECK(SUCCEEDED(reader.open(toTestPath(path).c_str(), BUFFER_BYTES, BUFFER_COUNT, 0)));
+	TEST_CHECK(reader.getDataSize() == 4004);
+	TEST_CHECK(SUCCEEDED(reader.start()));
+
+	vector<UINT32> sizes;
+	UINT32 ends;
+	vector<BYTE> data = drain(&reader, &sizes, &ends);
+	TEST_CHECK(data.size() == 4004 && memcmp(&data[0], &pcm[0], 4004) == 0);
+	checkBlocks(sizes, ends, 4004);
+	TEST_CHECK(reader.isFinished());
+	TEST_CHECK(reader.acquire(0) == NULL);
+
+	StreamStats stats;
+	reader.getStats(&stats);
+	TEST_CHECK_MSG(stats.refills == sizes.size() - BUFFER_COUNT, "%llu refills", (unsigned long long)stats.refills);
+	TEST_CHECK(stats.bytesRead == 4004);
+	reader.close();
+	remove(path.c_str());
+}
+
+AUDIO_TEST(stream_wholeBlocks)
+{
+	// data that ends exactly on a block: the last full block is the end, with no empty one after it
+	vector<INT16> pcm = makeRamp(1000 * 2);
+	string path = writeStereoWav(pcm);
+	TEST_CHECK(!path.empty());
+	WavStreamReader reader;
+	TEST_CHECK(SUCCEEDED(reader.open(toTestPath(path).c_str(), BUFFER_BYTES, BUFFER_COUNT, 0)));
+	TEST_CHECK(SUCCEEDED(reader.start()));
+
+	vector<UINT32> sizes;
+	UINT32 ends;
+	vector<BYTE> data = drain(&reader, &sizes, &ends);
+	TEST_CHECK(data.size() == 4000 && memcmp(&data[0], &pcm[0], 4000) == 0);
+	checkBlocks(sizes, ends, 4000);
+	reader.close();
+	remove(path.c_str());
+}
+
+AUDIO_TEST(stream_loops)
+{
+	// two more times round, each pass running on into the block the last one ended in
+	vector<INT16> pcm = makeRamp(1001 * 2);
+	string path = writeStereoWav(pcm);
+	TEST_CHECK(!path.empty());
+	WavStreamReader reader;
+	TEST_CHECK(SUCCEEDED(reader.open(toTestPath(path).c_str(), BUFFER_BYTES, BUFFER_COUNT, 2)));
+	TEST_CHECK(SUCCEEDED(reader.start()));
+
+	vector<UINT32> sizes;
+	UINT32 ends;
+	vector<BYTE> data = drain(&reader, &sizes, &ends);
+	TEST_CHECK(data.size() == 3 * 4004);
+	if(data.size() == 3 * 4004){
+		for(UINT32 pass = 0; pass < 3; ++pass)
+			TEST_CHECK_MSG(memcmp(&data[pass * 4004], &pcm[0], 4004) == 0, "pass %u differs", pass);
+	}
+	checkBlocks(sizes, ends, 3 * 4004);
+	TEST_CHECK(reader.isFinished());
+	reader.close();
+	remove(path.c_str());
+}
+
+AUDIO_TEST(stream_rewind)
+{
+	vector<INT16> pcm = makeRamp(1001 * 2);
+	string path = writeStereoWav(pcm);
+	TEST_CHECK(!path.empty());
+	WavStreamReader reader;
+	TEST_CHECK(SUCCEEDED(reader.open(toTestPath(path).c_str(), BUFFER_BYTES, BUFFER_COUNT, 0)));
+	TEST_CHECK(SUCCEEDED(reader.start()));
+
+	// part way through, and not while a block is still held
+	for(UINT32 i = 0; i < 4; ++i)
+		reader.release(reader.acquire(1000));
+	StreamBlock* block = reader.acquire(1000);
+	TEST_CHECK(block != NULL);
+	TEST_CHECK(reader.rewind() == E_FAIL);
+	reader.release(block);
+	TEST_CHECK(SUCCEEDED(reader.rewind()));
+
+	vector<UINT32> sizes;
+	UINT32 ends;
+	vector<BYTE> data = drain(&reader, &sizes, &ends);
+	TEST_CHECK(data.size() == 4004 && memcmp(&data[0], &pcm[0], 4004) == 0);
+	checkBlocks(sizes, ends, 4004);
+
+	// and again from the end
+	TEST_CHECK(SUCCEEDED(reader.rewind()));
+	data = drain(&reader, &sizes, &ends);
+	TEST_CHECK(data.size() == 4004 && memcmp(&data[0], &pcm[0], 4004) == 0);
+	reader.close();
+	remove(path.c_str());
+}
+
+/**
+// End of WavStreamReaderTests.cpp
+ */
@@ -0,0 +1,93 @@
+/**
+ * @file	WaveFileWriterTests.cpp
+ *
+ * @brief	WaveFileWriter: what is written, in pieces of any size and over several staging buffers, reads back
+ * 			with the same format and samples and with the RIFF, 'fact' and 'data' sizes filled in.
+ */
+
+#include "AudioTests.h"
+#include "WaveFileWriter.h"
+#include "MappedWaveFile.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @fn	static void checkRoundTrip(const WAVEFORMATEX* pFormat, bool backgroundFlush)
+ *
+ * @brief	Writes two and a half staging buffers of a ramp in odd-sized pieces, then reads the file back.
+ *
+ * @date	10/17/2026
+ */
+static void checkRoundTrip(const WAVEFORMATEX* pFormat, bool backgroundFlush)
+{
+	const UINT32 BYTES = (WAVE_WRITER_STAGING_BYTES * 5 / 2) / pFormat->nBlockAlign * pFormat->nBlockAlign;
+	vector<BYTE> data(BYTES);
+	for(UINT32 i = 0; i < BYTES; ++i)
+		data[i] = (BYTE)(i * 7 + (i >> 11));
+
+	string path = makeTestTempPath();
+	TEST_CHECK(!path.empty());
+	WaveFileWriter writer;
+	TEST_CHECK(SUCCEEDED(writer.open(path.c_str(), pFormat, backgroundFlush)));
+	UINT32 written = 0;
+	for(UINT32 piece = 1; written < BYTES; piece = piece * 3 + 1){
+		UINT32 bytes = piece % 100003;
+		if(bytes > BYTES - written)
+			bytes = BYTES - written;
+		UINT32 wrote = 0;
+		TEST_CHECK(SUCCEEDED(writer.write(&data[written], bytes, &wrote)) && wrote == bytes);
+		written += bytes;
+	}
+	TEST_CHECK(SUCCEEDED(writer.close()));
+
+	WaveWriterStats stats;
+	writer.getStats(&stats);
+	TEST_CHECK(stats.bytesWritten == BYTES);
+	TEST_CHECK_MSG(stats.flushes >= 3, "%llu flushes", (unsigned long long)stats.flushes);
+
+	MappedWaveFile wav;
+	TEST_CHECK(SUCCEEDED(wav.open(path.c_str())));
+	if(wav.isOpen()){
+		const WAVEFORMATEX* pRead = wav.getFormat();
+		TEST_CHECK(pRead->wFormatTag == pFormat->wFormatTag && pRead->nChannels == pFormat->nChannels);
+		TEST_CHECK(pRead->nSamplesPerSec == pFormat->nSamplesPerSec && pRead->nAvgBytesPerSec == pFormat->nAvgBytesPerSec);
+		TEST_CHECK(pRead->nBlockAlign == pFormat->nBlockAlign && pRead->wBitsPerSample == pFormat->wBitsPerSample);
+		TEST_CHECK_MSG(wav.getSize() == BYTES, "%u bytes of data, not %u", (UINT32)wav.getSize(), BYTES);
+		TEST_CHECK(wav.getSize() == BYTES && memcmp(wav.getData(), &data[0], BYTES) == 0);
+		TEST_CHECK_MSG(wav.getFactFrames() == BYTES / pFormat->nBlockAlign, "fact: %u frames", (UINT32)wav.getFactFrames());
+		wav.close();
+	}
+
+	// the RIFF size is the file's, less the 8 bytes of the RIFF chunk header
+	FILE* pFile = fopen(path.c_str(), "rb");
+	TEST_CHECK(pFile != NULL);
+	if(pFile != NULL){
+		BYTE header[8];
+		TEST_CHECK(fread(header, 1, 8, pFile) == 8);
+		fseek(pFile, 0, SEEK_END);
+		long fileSize = ftell(pFile);
+		fclose(pFile);
+		DWORD riffSize = header[4] | (header[5] << 8) | (header[6] << 16) | ((DWORD)header[7] << 24);
+		TEST_CHECK_MSG(riffSize == (DWORD)(fileSize - 8), "RIFF size %u in a %ld byte file", riffSize, fileSize);
+	}
+	remove(path.c_str());
+}
+
+AUDIO_TEST(writer_roundTripPCM)
+{
+	WAVEFORMATEX format = { WAVE_FORMAT_PCM, 2, 44100, 176400, 4, 16, 0 };
+	checkRoundTrip(&format, false);
+	checkRoundTrip(&format, true);
+}
+
+AUDIO_TEST(writer_roundTripFloat)
+{
+	// written with the whole WAVEFORMATEX, unlike PCM
+	WAVEFORMATEX format = { WAVE_FORMAT_IEEE_FLOAT, 6, 48000, 1152000, 24, 32, 0 };
+	checkRoundTrip(&format, false);
+	checkRoundTrip(&format, true);
+}
+
+/**
+// End of WaveFileWriterTests.cpp
+ */
@@ -1,26 +1,50 @@
 #include "StdAfx.h"
 #include "BasicAudio.h"
 #include "WavSampleSound.h"
+#include "StreamingWavSampleSound.h"
+#include "SDKwavefile.h"
+#include "AudioLog.h"
+#include "MixKernels.h"
 
 using namespace std;
 
 /**
  * @fn	BasicAudio::BasicAudio(void)
  *
- * @brief	Default constructor. Makes sure that the initialized flag is set to false
+ * @brief	Default constructor. Makes sure that the initialized flag is set to false, and starts the thread
+ * 			that writes out the library's log (see AudioLog).
  *
  * @author	Phil
  * @date	6/7/2013
  */
-BasicAudio::BasicAudio(void)
+BasicAudio::BasicAudio(void) : eventCallback(&soundEvents)
 {
 	initialized = false;
+	useX3DAudio = false;
+	pXAudio2 = NULL;
+	pOfflineEngine = NULL;
+	pOfflineFile = NULL;
+	offlineFloat = false;
+	offlineFrames = 0;
+	offlineSecondsRequested = 0;
+	offlineRenderSeconds = 0;
+	virtualFrames = 0;
+	commands.init(AUDIO_COMMAND_QUEUE_SIZE);
+	soundEvents.init(SOUND_EVENT_QUEUE_SIZE);
+	lostEvents = 0;
+	listenerDirty = false;
+	memset(&frameSpatialStats, 0, sizeof(frameSpatialStats));
+	memset(&lastSpatialStats, 0, sizeof(lastSpatialStats));
+	frameCount = 0;
+	AudioLog::start();
+	logRunning = true;
 }
 
 /**
  * @fn	BasicAudio::~BasicAudio(void)
  *
- * @brief	Destructor. If the class is initialized, it will destroy the assets.
+ * @brief	Destructor. If the class is initialized, it will destroy the assets. Lets go of the log's drain thread
+ * 			if destroy() hasn't already.
  *
  * @author	Phil
  * @date	6/7/2013
@@ -29,6 +53,8 @@ BasicAudio::~BasicAudio(void)
 {
 	if(initialized)
 		destroy();
+	if(logRunning)
+		AudioLog::stop();
 }
 
 /**
@@ -74,8 +100,8 @@ void BasicAudio::initListener(X3DAUDIO_LISTENER *listener){
  *					} XAUDIO2_DEVICE_DETAILS;
  */
 void BasicAudio::initDspSettings(X3DAUDIO_DSP_SETTINGS *ds, XAUDIO2_DEVICE_DETAILS *dd){
-	FLOAT32 * matrix = new FLOAT32[dd->OutputFormat.Format.nChannels];
-	ds->SrcChannelCount = 1; // [in] number of source channels, must equal number of channels in respective emitter
+	FLOAT32 * matrix = new FLOAT32[EMITTER_MAX_CHANNELS * dd->OutputFormat.Format.nChannels]; // room for the widest emitter
+	ds->SrcChannelCount = 1; // [in] number of source channels, must equal number of channels in respective emitter, set per call
 	ds->DstChannelCount = dd->OutputFormat.Format.nChannels; // [in] number of destination channels, must equal number of channels of the final mix
 	ds->pMatrixCoefficients = matrix; // matrix coefficient table, receives an array representing the volume level used to send from source channel S to destination channel D, stored as pMatrixCoefficients[SrcChannelCount * D + S], must have at least SrcChannelCount*DstChannelCount elements
 
@@ -108,6 +134,7 @@ void BasicAudio::init()
 	CoInitializeEx( NULL, COINIT_MULTITHREADED );
 
 	pXAudio2 = NULL;
+	pOfflineEngine = NULL;
 
 	flags = 0;
 
@@ -117,10 +144,60 @@ void BasicAudio::init()
 
 	if( FAILED( hr = XAudio2Create( &pXAudio2, flags ) ) )
 	{
-		wprintf( L"Failed to init XAudio2 engine: %#X\n", hr );
+		AUDIO_LOG_ERROR(L"Failed to init XAudio2 engine: %#X", hr);
+		CoUninitialize();
+		return;
+	}
+
+	if( !finishInit() )
 		CoUninitialize();
+}
+
+/**
+ * @fn	void BasicAudio::initOffline(UINT32 sampleRate, UINT32 channels)
+ *
+ * @brief	Initialises the library on an OfflineAudioEngine instead of the sound card. Everything else is used
+ * 			the same way as after init(), but nothing plays until renderOffline() is called, and then it mixes
+ * 			as fast as the CPU allows. See beginOfflineRender().
+ *
+ * @date	10/17/2026
+ *
+ * @param	sampleRate	Output sample rate, e.g. 48000.
+ * @param	channels  	Output channels. The speaker layout is the usual one for that count (2 = stereo, 6 = 5.1).
+ */
+void BasicAudio::initOffline(UINT32 sampleRate, UINT32 channels)
+{
+	pXAudio2 = NULL;
+	pOfflineEngine = NULL;
+
+	if( FAILED( hr = OfflineAudioEngine::create( sampleRate, channels, &pOfflineEngine ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Failed to init offline engine: %#X", hr);
 		return;
 	}
+	pXAudio2 = pOfflineEngine;
+
+	if( !finishInit() )
+		pOfflineEngine = NULL;
+}
+
+/**
+ * @fn	bool BasicAudio::finishInit()
+ *
+ * @brief	The part of initialisation shared by init() and initOffline(): the mastering voice, 3D state and
+ * 			voice pool, all set up from pXAudio2, whichever engine that is.
+ *
+ * @date	10/17/2026
+ *
+ * @return	false if the mastering voice could not be made, in which case pXAudio2 has been released.
+ */
+bool BasicAudio::finishInit()
+{
+	// destroy() let the log's thread go, and this object may be initialised again after it
+	if(!logRunning){
+		AudioLog::start();
+		logRunning = true;
+	}
 
 	//
 	// Create a mastering voice
@@ -129,10 +206,9 @@ void BasicAudio::init()
 
 	if( FAILED( hr = pXAudio2->CreateMasteringVoice( &pMasteringVoice ) ) )
 	{
-		wprintf( L"Failed creating mastering voice: %#X\n", hr );
+		AUDIO_LOG_ERROR(L"Failed creating mastering voice: %#X", hr);
 		SAFE_RELEASE( pXAudio2 );
-		CoUninitialize();
-		return;
+		return false;
 	}
 
 	pXAudio2->GetDeviceDetails(0, &deviceDetails);
@@ -142,8 +218,148 @@ void BasicAudio::init()
 
 	initDspSettings(&dspSettings, &deviceDetails);
 	initListener(&listener);
+	listenerDirty = true;
+	emitters.setMatrixSize(emitters.getSrcChannels(), deviceDetails.OutputFormat.Format.nChannels);
+	spatializer.setSpeakers(channelMask, deviceDetails.OutputFormat.Format.nChannels);
+	spatializer.setSpeedOfSound(X3DAUDIO_SPEED_OF_SOUND);
+
+	voicePool.init(pXAudio2, VOICE_POOL_VOICES_PER_FORMAT, VOICE_STEAL_LOWEST_PRIORITY);
+	virtualizer.init(pXAudio2, virtualizer.getBudget());
+	virtualClock = chrono::steady_clock::now();
 
 	initialized = true;
+	return true;
+}
+
+/**
+ * @fn	HRESULT BasicAudio::beginOfflineRender(LPCWSTR strFilename, bool floatOutput)
+ *
+ * @brief	Opens the WAV file that renderOffline() writes the master output to and starts the clock used for
+ * 			the speed multiple. Only valid after initOffline().
+ *
+ * 			Streamed sounds are read from disk by a background thread that expects real-time pacing, so when
+ * 			rendering much faster than that they may underrun. Use createSound() for anything that must be
+ * 			sample accurate in an offline render.
+ *
+ * @date	10/17/2026
+ *
+ * @param	strFilename	Filename of the output.
+ * @param	floatOutput	true for WAVE_FORMAT_IEEE_FLOAT, false for 16 bit WAVE_FORMAT_PCM (clipped).
+ *
+ * @return	S_OK, XAUDIO2_E_INVALID_CALL if not offline or already rendering, or the CWaveFile error.
+ */
+HRESULT BasicAudio::beginOfflineRender(LPCWSTR strFilename, bool floatOutput){
+	if(pOfflineEngine == NULL || pOfflineFile != NULL){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+
+	WAVEFORMATEX wfx;
+	wfx.wFormatTag = floatOutput ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM;
+	wfx.nChannels = (WORD)pOfflineEngine->getChannels();
+	wfx.nSamplesPerSec = pOfflineEngine->getSampleRate();
+	wfx.wBitsPerSample = floatOutput ? 32 : 16;
+	wfx.nBlockAlign = wfx.nChannels * wfx.wBitsPerSample / 8;
+	wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
+	wfx.cbSize = 0;
+
+	pOfflineFile = new CWaveFile();
+	if( FAILED( hr = pOfflineFile->Open( (LPWSTR)strFilename, &wfx, WAVEFILE_WRITE | WAVEFILE_BACKGROUND_FLUSH ) ) )
+	{
+		AUDIO_LOG_ERROR(L"BasicAudio::beginOfflineRender(): can't open %s: %#X", strFilename, hr);
+		SAFE_DELETE( pOfflineFile );
+		return hr;
+	}
+
+	offlineFloat = floatOutput;
+	offlineFrames = 0;
+	virtualFrames = 0;
+	offlineSecondsRequested = 0;
+	offlineRenderSeconds = 0;
+	offlineStart = chrono::steady_clock::now();
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT BasicAudio::renderOffline(double seconds)
+ *
+ * @brief	Mixes the next stretch of the scene and appends it to the file, in 10ms blocks so that voice
+ * 			callbacks come at the same granularity they would with XAudio2. Fractions of a frame carry over
+ * 			to the next call, so any number of 1/60s steps add up to exactly the right length.
+ *
+ * @date	10/17/2026
+ *
+ * @param	seconds	Audio time to render.
+ *
+ * @return	S_OK, XAUDIO2_E_INVALID_CALL if beginOfflineRender() has not been called, or the write error.
+ */
+HRESULT BasicAudio::renderOffline(double seconds){
+	if(pOfflineFile == NULL){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+
+	UINT32 channels = pOfflineEngine->getChannels();
+	UINT32 quantum = pOfflineEngine->getQuantumFrames();
+	offlineSecondsRequested += seconds;
+	UINT64 target = (UINT64)(offlineSecondsRequested * pOfflineEngine->getSampleRate() + 0.5);
+
+	offlineMix.resize(quantum * channels);
+	if(!offlineFloat)
+		offlinePCM.resize(quantum * channels);
+
+	hr = S_OK;
+	while(offlineFrames < target){
+		UINT32 frames = (target - offlineFrames < quantum) ? (UINT32)(target - offlineFrames) : quantum;
+		pOfflineEngine->render(&offlineMix[0], frames);
+
+		BYTE* pData = (BYTE*)&offlineMix[0];
+		UINT bytes = frames * channels * sizeof(FLOAT32);
+		if(!offlineFloat){
+			SoftwareMixer::toPCM16(&offlineMix[0], &offlinePCM[0], frames * channels);
+			pData = (BYTE*)&offlinePCM[0];
+			bytes = frames * channels * sizeof(INT16);
+		}
+		UINT wrote = 0;
+		if( FAILED( hr = pOfflineFile->Write( bytes, pData, &wrote ) ) )
+		{
+			AUDIO_LOG_ERROR(L"BasicAudio::renderOffline(): write failed: %#X", hr);
+			break;
+		}
+		offlineFrames += frames;
+	}
+
+	offlineRenderSeconds += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+	return hr;
+}
+
+/**
+ * @fn	HRESULT BasicAudio::endOfflineRender(OfflineRenderStats* stats)
+ *
+ * @brief	Finishes the WAV file and reports how fast the render went. The engine stays usable, so another
+ * 			render can be started straight away.
+ *
+ * @date	10/17/2026
+ *
+ * @param [out]	stats	If non-null, the timings.
+ *
+ * @return	S_OK, XAUDIO2_E_INVALID_CALL if not rendering, or the error from closing the file.
+ */
+HRESULT BasicAudio::endOfflineRender(OfflineRenderStats* stats){
+	if(pOfflineFile == NULL){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - offlineStart).count();
+	hr = pOfflineFile->Close();
+	SAFE_DELETE( pOfflineFile );
+
+	if(stats != NULL){
+		stats->frames = offlineFrames;
+		stats->audioSeconds = (double)offlineFrames / pOfflineEngine->getSampleRate();
+		stats->renderSeconds = offlineRenderSeconds;
+		stats->wallSeconds = wallSeconds;
+		stats->speedMultiple = wallSeconds > 0 ? stats->audioSeconds / wallSeconds : 0;
+	}
+	return hr;
 }
 
 /**
@@ -156,8 +372,12 @@ void BasicAudio::init()
  */
 void BasicAudio::printMatrixCoefficients(){
 	char* labels[] = {"Left", "Right", "Center", "Subwoofer", "Left Back", "Right Back", "Left Side", "Right Side"};
+	UINT32 src = dspSettings.SrcChannelCount;
 	for(int i = 0; i < deviceDetails.OutputFormat.Format.nChannels; ++i){
-		printf(" %s: %.3f\n", labels[i], dspSettings.pMatrixCoefficients[i] );
+		printf(" %s:", labels[i]);
+		for(UINT32 s = 0; s < src; ++s)
+			printf(" %.3f", dspSettings.pMatrixCoefficients[src * i + s] );
+		printf("\n");
 	}
 }
 
@@ -176,21 +396,349 @@ void BasicAudio::printMatrixCoefficients(){
  * @param	clearVal    The value the rest of the matrix is set to.
  */
 void BasicAudio::setSingleMatrixVal(FLOAT32 * mat, int size, int index, FLOAT32 val, FLOAT32 clearVal){
-	for(int i = 0; i < size; ++i){
-		mat[i] = clearVal;
-	}
-	mat[index] = val;
+	::setSingleMatrixVal(mat, size, index, val, clearVal);
 }
 
 void BasicAudio::updateSingleMatrixVal(FLOAT32 * mat, int size, int index, FLOAT32 val){
+	::updateSingleMatrixVal(mat, size, index, val);
+}
+
+/**
+ * @fn	void BasicAudio::setListenerPosition(FLOAT32 x, FLOAT32 y, FLOAT32 z)
+ *
+ * @brief	Moves the listener. update3D() recomputes every emitter the next time it runs, but only if the
+ * 			position actually changed.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::setListenerPosition(FLOAT32 x, FLOAT32 y, FLOAT32 z){
+	if(setListenerVector(&listener.Position, x, y, z))
+		listenerDirty = true;
+}
+
+/**
+ * @fn	void BasicAudio::setListenerVelocity(FLOAT32 x, FLOAT32 y, FLOAT32 z)
+ *
+ * @brief	Sets the listener's velocity, for Doppler.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::setListenerVelocity(FLOAT32 x, FLOAT32 y, FLOAT32 z){
+	if(setListenerVector(&listener.Velocity, x, y, z))
+		listenerDirty = true;
+}
+
+/**
+ * @fn	void BasicAudio::setListenerOrientation(FLOAT32 frontX, FLOAT32 frontY, FLOAT32 frontZ,
+ * 		FLOAT32 topX, FLOAT32 topY, FLOAT32 topZ)
+ *
+ * @brief	Turns the listener. The two vectors must be orthonormal.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::setListenerOrientation(FLOAT32 frontX, FLOAT32 frontY, FLOAT32 frontZ, FLOAT32 topX, FLOAT32 topY, FLOAT32 topZ){
+	bool changed = setListenerVector(&listener.OrientFront, frontX, frontY, frontZ);
+	if(setListenerVector(&listener.OrientTop, topX, topY, topZ) || changed)
+		listenerDirty = true;
+}
+
+/**
+ * @fn	bool BasicAudio::setListenerVector(X3DAUDIO_VECTOR* v, FLOAT32 x, FLOAT32 y, FLOAT32 z)
+ *
+ * @brief	Sets one of the listener's vectors.
+ *
+ * @date	10/17/2026
+ *
+ * @return	true if it changed.
+ */
+bool BasicAudio::setListenerVector(X3DAUDIO_VECTOR* v, FLOAT32 x, FLOAT32 y, FLOAT32 z){
+	if(v->x == x && v->y == y && v->z == z)
+		return false;
+	v->x = x;
+	v->y = y;
+	v->z = z;
+	return true;
+}
+
+/**
+ * @fn	void BasicAudio::flushListener()
+ *
+ * @brief	If the listener has changed, marks every emitter for recomputing. Done once, when the emitters are
+ * 			next used, however many times the listener was set in between.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::flushListener(){
+	if(listenerDirty){
+		emitters.markAllDirty(EmitterSoA::EMITTER_DIRTY_INPUT);
+		listenerDirty = false;
+	}
+}
+
+/**
+ * @fn	SpatialListener BasicAudio::getSpatialListener()
+ *
+ * @brief	The listener as the Spatializer takes it.
+ *
+ * @date	10/17/2026
+ */
+SpatialListener BasicAudio::getSpatialListener(){
+	SpatialListener sl = {
+		{ listener.Position.x, listener.Position.y, listener.Position.z },
+		{ listener.Velocity.x, listener.Velocity.y, listener.Velocity.z },
+		{ listener.OrientFront.x, listener.OrientFront.y, listener.OrientFront.z },
+		{ listener.OrientTop.x, listener.OrientTop.y, listener.OrientTop.z } };
+	return sl;
+}
+
+/**
+ * @fn	void BasicAudio::applyEmitter(UINT32 index, IXAudio2SourceVoice* voice)
+ *
+ * @brief	Sends an emitter's freshly computed Doppler factor and output matrix to its voice, unless they are
+ * 			within EMITTER_MATRIX_EPSILON of what the voice already has.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::applyEmitter(UINT32 index, IXAudio2SourceVoice* voice){
+	if(!emitters.commit(index, EMITTER_MATRIX_EPSILON)){
+		frameSpatialStats.skippedUnchanged++;
+		return;
+	}
+	voice->SetFrequencyRatio( emitters.doppler[index] );
+	setOutputMatrix( voice, emitters.getChannelCount(index), emitters.getMatrix(index) );
+	frameSpatialStats.applied++;
+}
+
+/**
+ * @fn	void BasicAudio::setOutputMatrix(IXAudio2SourceVoice* voice, UINT32 srcChannels, const FLOAT32* matrix)
+ *
+ * @brief	Sends a voice's output matrix to the voice it sends to, the mastering voice or its bus, which have
+ * 			the same channel count, timing the call.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	voice	The voice.
+ * @param	srcChannels  	The voice's channel count.
+ * @param	matrix		 	srcChannels * output channels levels, [srcChannels * D + S].
+ */
+void BasicAudio::setOutputMatrix(IXAudio2SourceVoice* voice, UINT32 srcChannels, const FLOAT32* matrix){
+	ScopedTimer t(&timers[ENGINE_TIMER_SET_OUTPUT_MATRIX]);
+	voice->SetOutputMatrix( NULL, srcChannels, deviceDetails.OutputFormat.Format.nChannels, matrix );
+}
+
+/**
+ * @fn	void BasicAudio::routeMatrix(FLOAT32* matrix, UINT32 srcChannels, int channel, FLOAT32 volume,
+ * 		bool exclusive)
+ *
+ * @brief	Sets every source channel's level on one output channel of a matrix, clearing the other output
+ * 			channels if exclusive. Mono matrices go through setSingleMatrixVal() and updateSingleMatrixVal().
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::routeMatrix(FLOAT32* matrix, UINT32 srcChannels, int channel, FLOAT32 volume, bool exclusive){
+	UINT32 channels = deviceDetails.OutputFormat.Format.nChannels;
+	channel = abs(channel)%channels; // make sure that we can't go outside the range of channels.
+	if(srcChannels == 1){
+		if(exclusive)
+			setSingleMatrixVal(matrix, channels, channel, volume, 0.0);
+		else
+			updateSingleMatrixVal(matrix, channels, channel, volume);
+		return;
+	}
+	if(exclusive)
+		memset(matrix, 0, srcChannels * channels * sizeof(FLOAT32));
+	for(UINT32 s = 0; s < srcChannels; ++s)
+		matrix[srcChannels * channel + s] = volume;
+}
 
-	mat[index] = val;
+/**
+ * @fn	UINT32 BasicAudio::getVoiceChannels(IXAudio2SourceVoice* voice)
+ *
+ * @brief	Gets how many channels a voice was made with, as far as a matrix can be built for.
+ *
+ * @date	10/17/2026
+ */
+UINT32 BasicAudio::getVoiceChannels(IXAudio2SourceVoice* voice){
+	XAUDIO2_VOICE_DETAILS details;
+	voice->GetVoiceDetails(&details);
+	if(details.InputChannels < 1)
+		return 1;
+	return details.InputChannels < EMITTER_MAX_CHANNELS ? details.InputChannels : EMITTER_MAX_CHANNELS;
+}
+
+/**
+ * @fn	void BasicAudio::update3D()
+ *
+ * @brief	Positions every spatialized sound (see SampleSound::setSpatialized()) in one call. The first pass
+ * 			computes each sound's output matrix and Doppler factor into the emitter store, the second hands the
+ * 			results to the voices. This replaces calling play3DVoice() per sound.
+ *
+ * 			The first pass is done by the SIMD Spatializer over the whole store, or, after setUseX3DAudio(true),
+ * 			by X3DAudioCalculate() one emitter at a time. The spatializer uses the curves every SampleSound is
+ * 			set up with, so only X3DAudio honours curves or cones changed on an individual emitter.
+ *
+ * 			Emitters that have not moved since they were last computed, while the listener stayed put too, are
+ * 			not recomputed, and voices whose results have not changed are not touched. See getSpatialStats().
+ *
+ * 			After setSpatialThreads(), computing and committing are split over that many worker threads and
+ * 			the caller, in contiguous ranges of the store; each emitter's results live in its own slot of the
+ * 			store, so the ranges share nothing. The voices are then updated from the caller's thread.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::update3D(){
+	ScopedTimer t(&timers[ENGINE_TIMER_UPDATE_3D]);
+	UINT32 count = emitters.getCount();
+	UINT32 dirtyCount = 0;
+	updateVoices.assign(count, (IXAudio2SourceVoice*)NULL);
+	updateChanged.assign(count, 0);
+	flushListener();
+
+	for(UINT32 i = 0; i < count; ++i){
+		if(!emitters.spatialized[i])
+			continue;
+		SampleSound* ss = getSound(emitters.owner[i]);
+		if(ss == NULL || (updateVoices[i] = ss->getSourceVoice()) == NULL)
+			continue;
+		if(emitters.dirty[i] & EmitterSoA::EMITTER_DIRTY_INPUT)
+			dirtyCount++;
+		else
+			frameSpatialStats.skippedClean++;
+	}
+	frameSpatialStats.computed += dirtyCount;
+
+	// With nothing to compute, new voices may still need the results of an earlier pass
+	if(dirtyCount > 0 && !useX3DAudio){
+		spatializer.setListener(getSpatialListener());
+		spatializer.prepare(&emitters);
+	}
+
+	// Each range computes and commits its own emitters, touching nothing outside them
+	spatialWorkers.parallelFor(count, SPATIALIZER_TASK_GRAIN, [this, dirtyCount](UINT32 begin, UINT32 end){
+		if(dirtyCount > 0 && useX3DAudio)
+			calculateX3DAudio(begin, end);
+		else if(dirtyCount > 0)
+			spatializer.processRange(&emitters, begin, end);
+		for(UINT32 i = begin; i < end; ++i){
+			if(updateVoices[i] != NULL)
+				updateChanged[i] = emitters.commit(i, EMITTER_MATRIX_EPSILON) ? 1 : 0;
+		}
+	});
+
+	// XAudio2 takes its engine lock for every voice call, so they are made from this thread
+	for(UINT32 i = 0; i < count; ++i){
+		if(updateVoices[i] == NULL)
+			continue;
+		if(updateChanged[i]){
+			updateVoices[i]->SetFrequencyRatio( emitters.doppler[i] );
+			setOutputMatrix( updateVoices[i], emitters.getChannelCount(i), emitters.getMatrix(i) );
+			frameSpatialStats.applied++;
+		}else{
+			frameSpatialStats.skippedUnchanged++;
+		}
+	}
+}
+
+/**
+ * @fn	void BasicAudio::calculateX3DAudio(UINT32 begin, UINT32 end)
+ *
+ * @brief	The X3DAudio version of the compute pass of update3D(), for the emitters [begin, end) that have a
+ * 			voice and changed inputs. Each call has its own DSP settings, pointed at the emitter's own matrix
+ * 			in the store, so ranges can run on different threads at once.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::calculateX3DAudio(UINT32 begin, UINT32 end){
+	X3DAUDIO_DSP_SETTINGS ds = dspSettings;
+	X3DAUDIO_EMITTER e;
+	for(UINT32 i = begin; i < end; ++i){
+		if(updateVoices[i] == NULL || !(emitters.dirty[i] & EmitterSoA::EMITTER_DIRTY_INPUT))
+			continue;
+
+		// The curves, cone and channel layout come from the sound, the vectors from the arrays
+		e = *getSound(emitters.owner[i])->getEmitterTemplate();
+		e.Position = D3DXVECTOR3( emitters.posX[i], emitters.posY[i], emitters.posZ[i] );
+		e.Velocity = D3DXVECTOR3( emitters.velX[i], emitters.velY[i], emitters.velZ[i] );
+		e.OrientFront = D3DXVECTOR3( emitters.frontX[i], emitters.frontY[i], emitters.frontZ[i] );
+		e.OrientTop = D3DXVECTOR3( emitters.topX[i], emitters.topY[i], emitters.topZ[i] );
+		e.CurveDistanceScaler = emitters.curveDistanceScaler[i];
+		e.DopplerScaler = emitters.dopplerScaler[i];
+		e.InnerRadius = emitters.innerRadius[i];
+		e.InnerRadiusAngle = emitters.innerRadiusAngle[i];
+		e.ChannelCount = emitters.getChannelCount(i);
+		e.ChannelRadius = emitters.channelRadius[i];
+		e.pChannelAzimuths = (FLOAT32*)emitters.getAzimuths(i);
+
+		ds.SrcChannelCount = e.ChannelCount;
+		ds.pMatrixCoefficients = emitters.getMatrix(i);
+		X3DAudioCalculate(x3dAudioHandle, &listener, &e,
+			X3DAUDIO_CALCULATE_MATRIX | X3DAUDIO_CALCULATE_DOPPLER | X3DAUDIO_CALCULATE_LPF_DIRECT | X3DAUDIO_CALCULATE_REVERB,
+			&ds );
+		emitters.doppler[i] = ds.DopplerFactor;
+		emitters.distance[i] = ds.EmitterToListenerDistance;
+		emitters.reverbLevel[i] = ds.ReverbLevel;
+		emitters.lpfDirect[i] = ds.LPFDirectCoefficient;
+	}
+}
+
+/**
+ * @fn	void BasicAudio::play3DVoice(SampleSound* sound)
+ *
+ * @brief	Sets the output matrix of a sound's voice to reflect its emitter's 3D position. The result is kept
+ * 			in the emitter store, so calling this again when neither the sound nor the listener has moved
+ * 			costs nothing, and the voice is only updated if the result has changed. The last result is also
+ * 			left in getMatrixCoefficients().
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	sound	The sound. Sounds that are not registered with this BasicAudio are always
+ * 							recomputed.
+ */
+void BasicAudio::play3DVoice(SampleSound* sound){
+	if(sound == NULL)
+		return;
+	if(sound->getEmitterStore() != &emitters){
+		play3DVoice(sound->getEmitter(), sound->getSourceVoice());
+		return;
+	}
+
+	ScopedTimer t(&timers[ENGINE_TIMER_PLAY_3D]);
+	flushListener();
+	UINT32 i = sound->getEmitterIndex();
+	if(emitters.dirty[i] & EmitterSoA::EMITTER_DIRTY_INPUT){
+		X3DAUDIO_EMITTER* emitter = sound->getEmitter();
+		AUDIO_LOG_DEBUG(L"emitter pos = (%.2f, %.2f, %.2f)", emitter->Position.x, emitter->Position.y, emitter->Position.z);
+		X3DAUDIO_DSP_SETTINGS ds = dspSettings;
+		ds.SrcChannelCount = emitters.getChannelCount(i);
+		ds.pMatrixCoefficients = emitters.getMatrix(i);
+		X3DAudioCalculate(x3dAudioHandle, &listener, emitter,
+			X3DAUDIO_CALCULATE_MATRIX | X3DAUDIO_CALCULATE_DOPPLER | X3DAUDIO_CALCULATE_LPF_DIRECT | X3DAUDIO_CALCULATE_REVERB,
+			&ds );
+		emitters.doppler[i] = ds.DopplerFactor;
+		emitters.distance[i] = ds.EmitterToListenerDistance;
+		emitters.reverbLevel[i] = ds.ReverbLevel;
+		emitters.lpfDirect[i] = ds.LPFDirectCoefficient;
+		emitters.dirty[i] &= ~EmitterSoA::EMITTER_DIRTY_INPUT;
+		frameSpatialStats.computed++;
+	}else{
+		frameSpatialStats.skippedClean++;
+	}
+
+	// keep getMatrixCoefficients() and printMatrixCoefficients() showing the last result, as before
+	dspSettings.DopplerFactor = emitters.doppler[i];
+	dspSettings.SrcChannelCount = emitters.getChannelCount(i);
+	memcpy(dspSettings.pMatrixCoefficients, emitters.getMatrix(i), emitters.getMatrixSize(i) * sizeof(FLOAT32));
+
+	IXAudio2SourceVoice* voice = sound->getSourceVoice();
+	if(voice != NULL)
+		applyEmitter(i, voice);
 }
 
 /**
  * @fn	void BasicAudio::play3DVoice(X3DAUDIO_EMITTER *emitter, IXAudio2SourceVoice* voice)
  *
- * @brief	Sets the output matrix to reflect the emitter's 3D position
+ * @brief	Sets the output matrix to reflect the emitter's 3D position. This always recomputes and always
+ * 			updates the voice; prefer play3DVoice(SampleSound*), which skips both when nothing has changed.
  *
  * @author	Phil
  * @date	6/7/2013
@@ -202,7 +750,13 @@ void BasicAudio::updateSingleMatrixVal(FLOAT32 * mat, int size, int index, FLOAT
  * 					
  */
 void BasicAudio::play3DVoice(X3DAUDIO_EMITTER *emitter, IXAudio2SourceVoice* voice){
-	fwprintf(stderr, L"emitter pos = (%.2f, %.2f, %.2f)\n", emitter->Position.x, emitter->Position.y, emitter->Position.z);
+	ScopedTimer t(&timers[ENGINE_TIMER_PLAY_3D]);
+	AUDIO_LOG_DEBUG(L"emitter pos = (%.2f, %.2f, %.2f)", emitter->Position.x, emitter->Position.y, emitter->Position.z);
+	if(emitter->ChannelCount < 1 || emitter->ChannelCount > EMITTER_MAX_CHANNELS){
+		AUDIO_LOG_ERROR(L"BasicAudio::play3DVoice(): emitters can have 1 to %d channels, not %u", EMITTER_MAX_CHANNELS, emitter->ChannelCount);
+		return;
+	}
+	dspSettings.SrcChannelCount = emitter->ChannelCount;
 	X3DAudioCalculate(x3dAudioHandle, &listener, emitter,
 		X3DAUDIO_CALCULATE_MATRIX | X3DAUDIO_CALCULATE_DOPPLER | X3DAUDIO_CALCULATE_LPF_DIRECT | X3DAUDIO_CALCULATE_REVERB,
 		&dspSettings );
@@ -210,7 +764,8 @@ void BasicAudio::play3DVoice(X3DAUDIO_EMITTER *emitter, IXAudio2SourceVoice* voi
 	if (voice){
 		// Apply X3DAudio generated DSP settings to XAudio2
 		voice->SetFrequencyRatio( dspSettings.DopplerFactor );
-		voice->SetOutputMatrix( getMasterVoice(), 1, deviceDetails.OutputFormat.Format.nChannels, dspSettings.pMatrixCoefficients );
+		setOutputMatrix( voice, emitter->ChannelCount, dspSettings.pMatrixCoefficients );
+		invalidateVoice(voice);
 	}
 }
 
@@ -228,47 +783,259 @@ void BasicAudio::play3DVoice(X3DAUDIO_EMITTER *emitter, IXAudio2SourceVoice* voi
  */
 
 void BasicAudio::playOnChannelVoice(IXAudio2SourceVoice* voice, int channel){
-
-	if (voice){
-		channel = abs(channel)%deviceDetails.OutputFormat.Format.nChannels; // make sure that we can't go outside the range of channels.
-		setSingleMatrixVal(dspSettings.pMatrixCoefficients, deviceDetails.OutputFormat.Format.nChannels, channel, 1.0, 0.0);
-		voice->SetOutputMatrix( getMasterVoice(), 1, deviceDetails.OutputFormat.Format.nChannels, dspSettings.pMatrixCoefficients );
-	}
+	playOnChannelVoice(voice, channel, 1.0f);
 }
 
 void BasicAudio::playOnChannelVoice(IXAudio2SourceVoice* voice, int channel, float volume){
 
 	if (voice){
-		channel = abs(channel)%deviceDetails.OutputFormat.Format.nChannels; // make sure that we can't go outside the range of channels.
-		setSingleMatrixVal(dspSettings.pMatrixCoefficients, deviceDetails.OutputFormat.Format.nChannels, channel, volume, 0.0);
-		voice->SetOutputMatrix( getMasterVoice(), 1, deviceDetails.OutputFormat.Format.nChannels, dspSettings.pMatrixCoefficients );
+		FLOAT32 matrix[XAUDIO2_MAX_AUDIO_CHANNELS * EMITTER_MAX_CHANNELS];
+		UINT32 src = getVoiceChannels(voice);
+		routeMatrix(matrix, src, channel, volume, true);
+		setOutputMatrix( voice, src, matrix );
+		invalidateVoice(voice);
 	}
 }
 
+/**
+ * @fn	void BasicAudio::addToChannelVoice(IXAudio2SourceVoice* voice, int channel, float volume)
+ *
+ * @brief	Sets the level of one output channel of a voice, leaving the others as the voice has them.
+ *
+ * @date	10/17/2026
+ */
 void BasicAudio::addToChannelVoice(IXAudio2SourceVoice* voice, int channel, float volume){
 
 	if (voice){
-		channel = abs(channel)%deviceDetails.OutputFormat.Format.nChannels; // make sure that we can't go outside the range of channels.
-		updateSingleMatrixVal(dspSettings.pMatrixCoefficients, deviceDetails.OutputFormat.Format.nChannels, channel, volume);
-		voice->SetOutputMatrix( getMasterVoice(), 1, deviceDetails.OutputFormat.Format.nChannels, dspSettings.pMatrixCoefficients );
+		FLOAT32 matrix[XAUDIO2_MAX_AUDIO_CHANNELS * EMITTER_MAX_CHANNELS];
+		UINT32 src = getVoiceChannels(voice);
+		voice->GetOutputMatrix( NULL, src, deviceDetails.OutputFormat.Format.nChannels, matrix );
+		routeMatrix(matrix, src, channel, volume, false);
+		setOutputMatrix( voice, src, matrix );
+		invalidateVoice(voice);
+	}
+}
+
+/**
+ * @fn	void BasicAudio::invalidateVoice(IXAudio2SourceVoice* voice)
+ *
+ * @brief	Called after a voice's matrix has been set without going through the emitter store: finds the
+ * 			sound the voice belongs to, if any, and makes its next update3D() or play3DVoice() recompute and
+ * 			resend its output, since what the store holds as applied is no longer what the voice has. This
+ * 			looks through every emitter, which is fine for the voice-level calls that need it.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::invalidateVoice(IXAudio2SourceVoice* voice){
+	for(UINT32 i = 0; i < emitters.getCount(); ++i){
+		SampleSound* ss = getSound(emitters.owner[i]);
+		if(ss != NULL && ss->getSourceVoice() == voice){
+			ss->invalidate3D();
+			return;
+		}
 	}
 }
 
 void BasicAudio::clearChannelVoice(IXAudio2SourceVoice* voice, int channel){
+	playOnChannelVoice(voice, channel, 0.0f);
+}
 
-	if (voice){
-		channel = abs(channel)%deviceDetails.OutputFormat.Format.nChannels; // make sure that we can't go outside the range of channels.
-		setSingleMatrixVal(dspSettings.pMatrixCoefficients, deviceDetails.OutputFormat.Format.nChannels, channel, 0.0, 0.0);
-		voice->SetOutputMatrix( getMasterVoice(), 1, deviceDetails.OutputFormat.Format.nChannels, dspSettings.pMatrixCoefficients );
+/**
+ * @fn	void BasicAudio::playOnChannel(SampleSound* sound, int channel, float volume)
+ *
+ * @brief	playOnChannelVoice() for a sound: plays it on one output channel only. The routing is kept with
+ * 			the sound's other output state in the emitter store, so addToChannel() builds on this sound's own
+ * 			routing without asking the voice for it. The next update3D() or play3DVoice() of a spatialized
+ * 			sound puts it back where its emitter is.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	sound	The sound.
+ * @param	channel		 	The output channel, taken modulo the channel count.
+ * @param	volume		 	Level on that channel.
+ */
+void BasicAudio::playOnChannel(SampleSound* sound, int channel, float volume){
+	routeChannel(sound, channel, volume, true);
+}
+
+/**
+ * @fn	void BasicAudio::addToChannel(SampleSound* sound, int channel, float volume)
+ *
+ * @brief	addToChannelVoice() for a sound: sets its level on one output channel, leaving the rest of its
+ * 			routing alone.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::addToChannel(SampleSound* sound, int channel, float volume){
+	routeChannel(sound, channel, volume, false);
+}
+
+/**
+ * @fn	void BasicAudio::clearChannel(SampleSound* sound, int channel)
+ *
+ * @brief	clearChannelVoice() for a sound: silences it on every channel.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::clearChannel(SampleSound* sound, int channel){
+	routeChannel(sound, channel, 0.0f, true);
+}
+
+/**
+ * @fn	void BasicAudio::routeChannel(SampleSound* sound, int channel, FLOAT32 volume, bool exclusive)
+ *
+ * @brief	Sets one output channel's level, for each of the sound's channels, in the matrix its voice was last
+ * 			given, clearing the others if exclusive, and sends it. Sounds that don't belong to this BasicAudio go through the voice
+ * 			versions.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::routeChannel(SampleSound* sound, int channel, FLOAT32 volume, bool exclusive){
+	IXAudio2SourceVoice* voice = (sound != NULL) ? sound->getSourceVoice() : NULL;
+	if(voice == NULL)
+		return;
+	if(sound->getEmitterStore() != &emitters){
+		if(exclusive)
+			playOnChannelVoice(voice, channel, volume);
+		else
+			addToChannelVoice(voice, channel, volume);
+		return;
+	}
+
+	UINT32 i = sound->getEmitterIndex();
+	FLOAT32* matrix = emitters.getAppliedMatrix(i);
+	routeMatrix(matrix, emitters.getChannelCount(i), channel, volume, exclusive);
+	setOutputMatrix( voice, emitters.getChannelCount(i), matrix );
+	sound->invalidate3D();
+}
+
+/**
+ * @fn	bool BasicAudio::addSound(SampleSound* sound, LPCWSTR soundName)
+ *
+ * @brief	Names a new sound, gives it a handle and makes the name resolve to that handle. A sound created with
+ * 			a name that is already in use takes the name over, the earlier sound keeps its handle.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	sound	The new sound. Destroyed and deleted if it can't be added.
+ * @param	soundName	 	Name of the sound.
+ *
+ * @return	false if every handle is in use, in which case the sound is gone and any earlier sound of the same
+ * 			name keeps it.
+ */
+bool BasicAudio::addSound(SampleSound* sound, LPCWSTR soundName){
+	SOUND_HANDLE handle = sounds.add(sound);
+	if(handle == SOUND_HANDLE_INVALID){
+		AUDIO_LOG_ERROR(L"BasicAudio::addSound(): no handles left for %s", soundName);
+		sound->destroy();
+		delete sound;
+		return false;
+	}
+	sound->setName(soundName);
+	sound->setHandle(handle);
+	soundMap[sound->getName()] = handle;
+	sound->attachEmitterStore(&emitters, emitters.add(handle));
+	return true;
+}
+
+/**
+ * @fn	bool BasicAudio::destroySound(SOUND_HANDLE handle)
+ *
+ * @brief	Destroys one sound and frees its handle, its name and its emitter. Copies of the handle stop
+ * 			resolving, so commands and voice events still queued for it are ignored, and a sound made later in
+ * 			the same slot is not reached through them. Copies the voice pool is playing from the sound carry
+ * 			on. A sound from createSoundAsync() that is still loading is waited for.
+ *
+ * @date	10/17/2026
+ *
+ * @param	handle	The sound.
+ *
+ * @return	false if the handle is stale or invalid.
+ */
+bool BasicAudio::destroySound(SOUND_HANDLE handle){
+	SampleSound* ss = getSound(handle);
+	if(ss == NULL)
+		return false;
+
+	// the loader may still be writing to it
+	for(size_t i = 0; i < pendingLoads.size(); ++i){
+		if(pendingLoads[i] != ss)
+			continue;
+		loaders.wait();
+		pendingLoads.erase(pendingLoads.begin() + i);
+		break;
+	}
+	if(ss->isVirtual())
+		virtualizer.remove(ss);
+	ss->destroy();
+
+	// the last emitter fills the gap, so its sound has to be told where it now is
+	if(ss->getEmitterStore() == &emitters){
+		SOUND_HANDLE moved = emitters.remove(ss->getEmitterIndex());
+		if(moved != SOUND_HANDLE_INVALID)
+			getSound(moved)->setEmitterIndex(ss->getEmitterIndex());
+	}
+	SOUND_MAP::iterator named = soundMap.find(ss->getName());
+	if(named != soundMap.end() && named->second == handle)
+		soundMap.erase(named);
+	sounds.remove(handle);
+	delete ss;
+	return true;
+}
+
+/**
+ * @fn	HRESULT BasicAudio::loadSoundBank(LPCWSTR strFilename)
+ *
+ * @brief	Opens a sound bank made by SoundBankBuilder. From then on createSound() and createSoundAsync() look
+ * 			file names up in the loaded banks, latest first, before going to the file system, so a game can
+ * 			swap hundreds of loose WAVs for one bank without changing its createSound() calls. Opening a bank
+ * 			maps it and reads its index; no sample data is read until a sound is made from it.
+ *
+ * @date	10/17/2026
+ *
+ * @param	strFilename	Path of the bank.
+ *
+ * @return	S_OK, or the error from SoundBank::open().
+ */
+HRESULT BasicAudio::loadSoundBank(LPCWSTR strFilename){
+	ScopedTimer t(&timers[ENGINE_TIMER_CREATE_SOUND]);
+	SoundBank* pBank;
+	HRESULT hr = SoundBank::open(strFilename, &pBank);
+	if(FAILED(hr)){
+		AUDIO_LOG_ERROR(L"BasicAudio::loadSoundBank(): could not open %s: %#X", strFilename, hr);
+		return hr;
+	}
+	AUDIO_LOG_INFO(L"Loaded sound bank %s, %u sounds", strFilename, pBank->getCount());
+	soundBanks.push_back(pBank);
+	return S_OK;
+}
+
+/**
+ * @fn	void BasicAudio::useSoundBank(WavSampleSound* sound, LPCWSTR strFilename)
+ *
+ * @brief	Points a sound at the most recently loaded bank that has the file, if any does.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::useSoundBank(WavSampleSound* sound, LPCWSTR strFilename){
+	for(size_t i = soundBanks.size(); i-- > 0; ){
+		INT32 index = soundBanks[i]->find(strFilename);
+		if(index >= 0){
+			sound->setSoundBank(soundBanks[i], (UINT32)index);
+			return;
+		}
 	}
 }
 
 /**
  * @fn	SampleSound* BasicAudio::createSound(LPCWSTR soundName, LPCWSTR strFilename,
- * 		UINT loopCount)
+ * 		UINT loopCount, LPCWSTR busName)
  *
  * @brief	Creates a sound from a WAV file. The sound may have zero or more loops (0 = one play thorough - no loops) up to 
  * 			XAUDIO2_LOOP_INFINITE (XAudio2.h). The sound is associated in an unordered map with a name.
+ * 			The sample data comes from the asset cache, so any number of sounds can be made from the same
+ * 			file for the cost of one load, and from a sound bank rather than the file if one loaded with
+ * 			loadSoundBank() has it.
  *
  * @author	Phil
  * @date	6/7/2013
@@ -276,41 +1043,678 @@ void BasicAudio::clearChannelVoice(IXAudio2SourceVoice* voice, int channel){
  * @param	soundName  	Name of the sound.
  * @param	strFilename	Filename for the sound
  * @param	loopCount  	Number of loops.
+ * @param	busName	   	Bus made by createBus() to play through, NULL for the mastering voice.
  *
- * @return	pointer to the new sound
+ * @return	pointer to the new sound, or NULL if there are no handles left. Its handle is newSound->getHandle()
  */
-SampleSound* BasicAudio::createSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount){
+SampleSound* BasicAudio::createSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName){
+	ScopedTimer t(&timers[ENGINE_TIMER_CREATE_SOUND]);
 	WavSampleSound *newSound = new WavSampleSound();
 	
+	newSound->setAssetCache(&assetCache);
+	newSound->setEventCallback(&eventCallback);
+	useSoundBank(newSound, strFilename);
+	routeToBus(newSound, busName);
+	newSound->initPCM(pXAudio2, strFilename, loopCount );
+	if(!addSound(newSound, soundName))
+		return NULL;
+
+	// Make the pooled voices for this format now rather than on the first playInstance()
+	if(newSound->getAsset() != NULL)
+		voicePool.reserve(newSound->getAsset()->getFormat());
+
+	return newSound;
+}
+
+/**
+ * @fn	SampleSound* BasicAudio::createStreamingSound(LPCWSTR soundName, LPCWSTR strFilename,
+ * 		UINT loopCount, LPCWSTR busName)
+ *
+ * @brief	Creates a sound that streams from a WAV file through a small ring of buffers rather than loading the
+ * 			whole file. Use this for long music beds. The sound is otherwise used exactly like the ones made by
+ * 			createSound(). ADPCM files are decoded as they stream.
+ *
+ * @date	10/17/2026
+ *
+ * @param	soundName  	Name of the sound.
+ * @param	strFilename	Filename for the sound
+ * @param	loopCount  	Number of loops.
+ * @param	busName	   	Bus made by createBus() to play through, NULL for the mastering voice.
+ *
+ * @return	pointer to the new sound, or NULL if there are no handles left
+ */
+SampleSound* BasicAudio::createStreamingSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName){
+	ScopedTimer t(&timers[ENGINE_TIMER_CREATE_SOUND]);
+	StreamingWavSampleSound *newSound = new StreamingWavSampleSound();
+
+	newSound->setEventCallback(&eventCallback);
+	routeToBus(newSound, busName);
+	newSound->initPCM(pXAudio2, strFilename, loopCount );
+	if(!addSound(newSound, soundName))
+		return NULL;
+
+	return newSound;
+}
+
+/**
+ * @fn	SampleSound* BasicAudio::createCompressedSound(LPCWSTR soundName, LPCWSTR strFilename,
+ * 		UINT loopCount, LPCWSTR busName)
+ *
+ * @brief	Creates a sound from an IMA or MS ADPCM file that is held in memory compressed and decoded as it
+ * 			plays, through the same ring of buffers as createStreamingSound(). A long loop costs a quarter of
+ * 			the memory createSound() would give it, as 16 bit PCM, or an eighth of its float copy, for the
+ * 			CPU time of decoding it on every pass. createSound() decodes ADPCM once, at load.
+ *
+ * @date	10/17/2026
+ *
+ * @param	soundName  	Name of the sound.
+ * @param	strFilename	Filename for the sound
+ * @param	loopCount  	Number of loops.
+ * @param	busName	   	Bus made by createBus() to play through, NULL for the mastering voice.
+ *
+ * @return	pointer to the new sound, or NULL if there are no handles left
+ */
+SampleSound* BasicAudio::createCompressedSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName){
+	ScopedTimer t(&timers[ENGINE_TIMER_CREATE_SOUND]);
+	StreamingWavSampleSound *newSound = new StreamingWavSampleSound();
+
+	newSound->setEventCallback(&eventCallback);
+	routeToBus(newSound, busName);
+	newSound->initCompressed(pXAudio2, strFilename, loopCount );
+	if(!addSound(newSound, soundName))
+		return NULL;
+
+	return newSound;
+}
+
+/**
+ * @fn	SampleSound* BasicAudio::createVirtualSound(LPCWSTR soundName, LPCWSTR strFilename,
+ * 		UINT loopCount, LPCWSTR busName)
+ *
+ * @brief	Creates a sound like createSound() that has no voice of its own. While it plays, run() keeps its
+ * 			position and lends it one of the virtualizer's voices only while it is among the setVoiceBudget()
+ * 			most audible virtual sounds, going by its volume and its distance along the volume curve. So
+ * 			thousands of these can be playing for the price of the budget's worth of voices. The sound is
+ * 			spatialized, and is otherwise used like any other: start(), stop(), setVolume(), the emitter
+ * 			setters and callbacks all work whether or not it has a voice at the moment. run() must be called
+ * 			every frame for virtual sounds to be heard.
+ *
+ * @date	10/17/2026
+ *
+ * @param	soundName  	Name of the sound.
+ * @param	strFilename	Filename for the sound
+ * @param	loopCount  	Number of loops.
+ * @param	busName	   	Bus made by createBus() to play through, NULL for the mastering voice.
+ *
+ * @return	pointer to the new sound, or NULL if there are no handles left
+ */
+SampleSound* BasicAudio::createVirtualSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName){
+	ScopedTimer t(&timers[ENGINE_TIMER_CREATE_SOUND]);
+	WavSampleSound *newSound = new WavSampleSound();
+
+	newSound->setVirtual(true);
+	newSound->setAssetCache(&assetCache);
+	useSoundBank(newSound, strFilename);
+	routeToBus(newSound, busName);
 	newSound->initPCM(pXAudio2, strFilename, loopCount );
-	newSound->setName(soundName);
-	soundMap[newSound->getName()] = newSound;
+	if(!addSound(newSound, soundName))
+		return NULL;
+	newSound->setSpatialized(true);
+	virtualizer.add(newSound);
 
 	return newSound;
 }
 
+/**
+ * @fn	SampleSound* BasicAudio::createSoundAsync(LPCWSTR soundName, LPCWSTR strFilename,
+ * 		UINT loopCount, LPCWSTR busName)
+ *
+ * @brief	Same as createSound(), but the file is found and read on a loader thread and this returns at once.
+ * 			The sound is named and has its handle straight away. It becomes playable on the first run() or
+ * 			waitAll() after its data is in, which is where its voice is made, so XAudio2 and the voice pool are
+ * 			only ever used from the caller's thread. Until then getLoadState() says how far it has got, and
+ * 			start() is remembered and carried out when it is ready.
+ *
+ * 			The loader threads are started on first use, one per core, or explicitly with setLoaderThreads().
+ *
+ * @date	10/17/2026
+ *
+ * @param	soundName  	Name of the sound.
+ * @param	strFilename	Filename for the sound
+ * @param	loopCount  	Number of loops.
+ * @param	busName	   	Bus made by createBus() to play through, NULL for the mastering voice.
+ *
+ * @return	pointer to the new sound, or NULL if there are no handles left. Its handle is newSound->getHandle()
+ */
+SampleSound* BasicAudio::createSoundAsync(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName){
+	ScopedTimer t(&timers[ENGINE_TIMER_CREATE_SOUND]);
+	WavSampleSound *newSound = new WavSampleSound();
+
+	newSound->setAssetCache(&assetCache);
+	newSound->setEventCallback(&eventCallback);
+	useSoundBank(newSound, strFilename);
+	routeToBus(newSound, busName);
+	newSound->beginLoad(strFilename, loopCount);
+	if(!addSound(newSound, soundName))
+		return NULL;
+	pendingLoads.push_back(newSound);
+	loaders.submit([newSound]{ newSound->loadAsset(); });
+
+	return newSound;
+}
+
+/**
+ * @fn	void BasicAudio::finishLoads()
+ *
+ * @brief	Makes the voices of the async sounds whose data has come in since the last call, and starts the
+ * 			ones that were asked to start while loading.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::finishLoads(){
+	size_t kept = 0;
+	for(size_t i = 0; i < pendingLoads.size(); ++i){
+		WavSampleSound* ws = pendingLoads[i];
+		SOUND_LOAD_STATE state = ws->getLoadState();
+		if(state == SOUND_LOAD_PENDING){
+			pendingLoads[kept++] = ws;
+			continue;
+		}
+		if(state == SOUND_LOAD_LOADED && SUCCEEDED(ws->finishLoad(pXAudio2)) && ws->getAsset() != NULL)
+			voicePool.reserve(ws->getAsset()->getFormat());
+		if(ws->getLoadState() == SOUND_LOAD_FAILED)
+			AUDIO_LOG_ERROR(L"BasicAudio::finishLoads(): could not load %s", ws->getName());
+	}
+	pendingLoads.resize(kept);
+}
+
+/**
+ * @fn	void BasicAudio::waitAll()
+ *
+ * @brief	Blocks until every createSoundAsync() so far has finished loading and is playable (or has failed).
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::waitAll(){
+	loaders.wait();
+	finishLoads();
+}
+
+/**
+ * @fn	VOICE_INSTANCE BasicAudio::playInstance(LPCWSTR soundName, UINT32 priority, FLOAT32 volume)
+ *
+ * @brief	Plays a fire-and-forget copy of a sound on a voice from the pool. Unlike start() on the sound itself,
+ * 			this can be called again while earlier copies are still playing, e.g. for gunshots or footsteps.
+ * 			If all the voices for the sound's format are busy, one is stolen according to the pool's policy.
+ *
+ * @date	10/17/2026
+ *
+ * @param	soundName	Name of the sound.
+ * @param	priority 	Priority of this copy. Higher priority copies are stolen last.
+ * @param	volume   	Volume of this copy.
+ *
+ * @return	The instance, which can be used with getInstanceVoice() and stopInstance(), or 0 if the sound does
+ * 			not exist, is streamed, or no voice could be had.
+ */
+VOICE_INSTANCE BasicAudio::playInstance(LPCWSTR soundName, UINT32 priority, FLOAT32 volume){
+	return playInstance(getHandle(soundName), priority, volume);
+}
+
+VOICE_INSTANCE BasicAudio::playInstance(SOUND_HANDLE handle, UINT32 priority, FLOAT32 volume){
+	SampleSound* ss = getSound(handle);
+	if(ss == NULL || ss->getAsset() == NULL){
+		return 0;
+	}
+	return voicePool.play(ss->getAsset(), priority, volume, ss->getOutputVoice());
+}
+
+/**
+ * @fn	IXAudio2SubmixVoice* BasicAudio::createBus(LPCWSTR busName, LPCWSTR parentName)
+ *
+ * @brief	Makes a named submix bus. Sounds put on it (see createSound() and setSoundBus()) are mixed into it,
+ * 			and its volume and output matrix are applied once to the sum rather than to every voice, so fading
+ * 			or ducking a whole group of sounds is one call however many of them are playing. Buses can send
+ * 			to other buses, up to AUDIO_BUS_MAX_DEPTH deep; processing stages are given out by depth so that
+ * 			every bus is mixed before the one it sends to. Buses have the mastering voice's channels and rate,
+ * 			so 3D and channel routing work on them unchanged.
+ *
+ * @date	10/17/2026
+ *
+ * @param	busName   	Name of the new bus.
+ * @param	parentName	The bus to send to, NULL for the mastering voice. It must already exist.
+ *
+ * @return	The bus's submix voice, or null if the name is taken, the parent doesn't exist or is too deep, or
+ * 			the voice can't be made.
+ */
+IXAudio2SubmixVoice* BasicAudio::createBus(LPCWSTR busName, LPCWSTR parentName){
+	if(busName == NULL || pMasteringVoice == NULL || getBusIndex(busName) >= 0){
+		AUDIO_LOG_ERROR(L"BasicAudio::createBus(): can't make bus %s", busName != NULL ? busName : L"(null)");
+		return NULL;
+	}
+	AudioBus bus;
+	bus.name = busName;
+	bus.pVoice = NULL;
+	bus.parent = -1;
+	bus.depth = 0;
+	if(parentName != NULL){
+		bus.parent = getBusIndex(parentName);
+		if(bus.parent < 0 || buses[bus.parent].depth + 1 >= AUDIO_BUS_MAX_DEPTH){
+			AUDIO_LOG_ERROR(L"BasicAudio::createBus(): can't send %s to %s", busName, parentName);
+			return NULL;
+		}
+		bus.depth = buses[bus.parent].depth + 1;
+	}
+
+	XAUDIO2_VOICE_DETAILS details;
+	pMasteringVoice->GetVoiceDetails(&details);
+	XAUDIO2_SEND_DESCRIPTOR send = { 0, NULL };
+	XAUDIO2_VOICE_SENDS sends = { 1, &send };
+	if(bus.parent >= 0)
+		send.pOutputVoice = buses[bus.parent].pVoice;
+	if( FAILED( hr = pXAudio2->CreateSubmixVoice( &bus.pVoice, details.InputChannels, details.InputSampleRate, 0,
+		AUDIO_BUS_MAX_DEPTH - 1 - bus.depth, bus.parent >= 0 ? &sends : NULL ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Error %#X creating bus %s", hr, busName);
+		return NULL;
+	}
+	buses.push_back(bus);
+	return bus.pVoice;
+}
+
+/**
+ * @fn	INT32 BasicAudio::getBusIndex(LPCWSTR busName)
+ *
+ * @brief	Finds a bus by name. There are seldom more than a handful, so this is a linear search; keep the
+ * 			index to use with setBusVolume() every frame.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The index, or -1 if there is no bus with that name.
+ */
+INT32 BasicAudio::getBusIndex(LPCWSTR busName){
+	if(busName == NULL)
+		return -1;
+	for(size_t i = 0; i < buses.size(); ++i){
+		if(buses[i].name == busName)
+			return (INT32)i;
+	}
+	return -1;
+}
+
+IXAudio2SubmixVoice* BasicAudio::getBusVoice(LPCWSTR busName){
+	INT32 index = getBusIndex(busName);
+	return index >= 0 ? buses[index].pVoice : NULL;
+}
+
+/**
+ * @fn	bool BasicAudio::setBusVolume(INT32 busIndex, FLOAT32 volume)
+ *
+ * @brief	Sets the volume of a bus, and so of everything mixed through it. Call every frame to fade.
+ *
+ * @date	10/17/2026
+ *
+ * @return	false if there is no such bus.
+ */
+bool BasicAudio::setBusVolume(INT32 busIndex, FLOAT32 volume){
+	if(busIndex < 0 || busIndex >= (INT32)buses.size())
+		return false;
+	return SUCCEEDED(buses[busIndex].pVoice->SetVolume(volume));
+}
+
+FLOAT32 BasicAudio::getBusVolume(LPCWSTR busName){
+	FLOAT32 volume = 0.0f;
+	IXAudio2SubmixVoice* pVoice = getBusVoice(busName);
+	if(pVoice != NULL)
+		pVoice->GetVolume(&volume);
+	return volume;
+}
+
+/**
+ * @fn	bool BasicAudio::setBusOutputMatrix(LPCWSTR busName, const FLOAT32* matrix)
+ *
+ * @brief	Sets how a bus's channels are mixed into the voice it sends to, e.g. to pull a whole group of
+ * 			sounds to one side.
+ *
+ * @date	10/17/2026
+ *
+ * @param	busName	Name of the bus.
+ * @param	matrix 	getNumChannels() * getNumChannels() levels, laid out as for SetOutputMatrix().
+ *
+ * @return	false if there is no such bus or the matrix was refused.
+ */
+bool BasicAudio::setBusOutputMatrix(LPCWSTR busName, const FLOAT32* matrix){
+	IXAudio2SubmixVoice* pVoice = getBusVoice(busName);
+	if(pVoice == NULL || matrix == NULL)
+		return false;
+	UINT32 channels = deviceDetails.OutputFormat.Format.nChannels;
+	ScopedTimer t(&timers[ENGINE_TIMER_SET_OUTPUT_MATRIX]);
+	return SUCCEEDED(pVoice->SetOutputMatrix( NULL, channels, channels, matrix ));
+}
+
+/**
+ * @fn	bool BasicAudio::setSoundBus(SOUND_HANDLE handle, LPCWSTR busName)
+ *
+ * @brief	Moves a sound to another bus, or to the mastering voice if busName is NULL. A playing sound carries
+ * 			on through the new bus; spatialized sounds get their 3D output back on the next update3D().
+ * 			Instances already started by playInstance() stay where they are, later ones follow.
+ *
+ * @date	10/17/2026
+ *
+ * @return	false if the sound or the bus doesn't exist, or the voice couldn't be rerouted.
+ */
+bool BasicAudio::setSoundBus(SOUND_HANDLE handle, LPCWSTR busName){
+	SampleSound* ss = getSound(handle);
+	if(ss == NULL)
+		return false;
+	return routeToBus(ss, busName);
+}
+
+/**
+ * @fn	bool BasicAudio::routeToBus(SampleSound* sound, LPCWSTR busName)
+ *
+ * @brief	Sets the bus a sound plays through, logging a bus that doesn't exist.
+ *
+ * @date	10/17/2026
+ */
+bool BasicAudio::routeToBus(SampleSound* sound, LPCWSTR busName){
+	IXAudio2Voice* pBus = NULL;
+	if(busName != NULL && (pBus = getBusVoice(busName)) == NULL){
+		AUDIO_LOG_ERROR(L"BasicAudio: no bus named %s", busName);
+		return false;
+	}
+	return SUCCEEDED(sound->setOutputVoice(pBus));
+}
+
+/**
+ * @fn	UINT32 BasicAudio::applyCommands()
+ *
+ * @brief	Carries out the commands that were posted before the call, in the order they were posted. Commands
+ * 			posted while this runs wait for the next call, so a producer that never stops can't hold it up.
+ * 			run() calls this; call it directly to apply commands at some other point in the tick.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The number of commands applied.
+ */
+UINT32 BasicAudio::applyCommands(){
+	UINT32 count = commands.getDepth();
+	UINT32 applied = 0;
+	AudioCommand command;
+	while(applied < count && commands.pop(&command)){
+		applyCommand(command);
+		applied++;
+	}
+	return applied;
+}
+
+/**
+ * @fn	void BasicAudio::applyCommand(const AudioCommand& command)
+ *
+ * @brief	Makes the call a command stands for. Commands for stale handles are ignored.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::applyCommand(const AudioCommand& command){
+	switch(command.type){
+	case AUDIO_COMMAND_UPDATE_3D:
+		update3D();
+		return;
+	case AUDIO_COMMAND_SET_LISTENER_POS:
+		setListenerPosition(command.x, command.y, command.z);
+		return;
+	case AUDIO_COMMAND_SET_LISTENER_VELOCITY:
+		setListenerVelocity(command.x, command.y, command.z);
+		return;
+	case AUDIO_COMMAND_SET_BUS_VOLUME:
+		setBusVolume(command.channel, command.x);
+		return;
+	default:
+		break;
+	}
+	SampleSound* ss = getSound(command.handle);
+	if(ss == NULL)
+		return;
+
+	switch(command.type){
+	case AUDIO_COMMAND_START:
+		ss->start();
+		break;
+	case AUDIO_COMMAND_STOP:
+		ss->stop();
+		break;
+	case AUDIO_COMMAND_SET_EMITTER_X:
+		ss->setEmitterX(command.x);
+		break;
+	case AUDIO_COMMAND_SET_EMITTER_Y:
+		ss->setEmitterY(command.x);
+		break;
+	case AUDIO_COMMAND_SET_EMITTER_Z:
+		ss->setEmitterZ(command.x);
+		break;
+	case AUDIO_COMMAND_SET_EMITTER_POS:
+		ss->setEmitterPos(command.x, command.y, command.z);
+		break;
+	case AUDIO_COMMAND_SET_EMITTER_VELOCITY:
+		ss->setEmitterVelocity(command.x, command.y, command.z);
+		break;
+	case AUDIO_COMMAND_SET_SPATIALIZED:
+		ss->setSpatialized(command.channel != 0);
+		break;
+	case AUDIO_COMMAND_SET_VOLUME:
+		ss->setVolume(command.x);
+		break;
+	case AUDIO_COMMAND_PLAY_3D:
+		play3DVoice(ss);
+		break;
+	case AUDIO_COMMAND_PLAY_ON_CHANNEL:
+		playOnChannel(ss, command.channel, command.x);
+		break;
+	case AUDIO_COMMAND_ADD_TO_CHANNEL:
+		addToChannel(ss, command.channel, command.x);
+		break;
+	case AUDIO_COMMAND_CLEAR_CHANNEL:
+		clearChannel(ss, command.channel);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @fn	UINT32 BasicAudio::dispatchEvents()
+ *
+ * @brief	Hands the events the voices have queued since the last call to their sounds, which update
+ * 			themselves and call their setSoundCallback() callbacks. Only sounds that have something to report
+ * 			are touched. As with applyCommands(), events queued while this runs wait for the next call.
+ * 			run() calls this.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The number of events dispatched.
+ */
+UINT32 BasicAudio::dispatchEvents(){
+	UINT32 count = soundEvents.getDepth();
+	UINT32 dispatched = 0;
+	SoundEvent e;
+	while(dispatched < count && soundEvents.pop(&e)){
+		SampleSound* ss = getSound(e.handle);
+		if(ss != NULL)
+			ss->onEvent(e);
+		dispatched++;
+	}
+
+	CommandRingStats stats;
+	soundEvents.getStats(&stats);
+	if(stats.dropped != lostEvents){
+		lostEvents = stats.dropped;
+		AUDIO_LOG_WARN(L"BasicAudio::dispatchEvents(): event queue overflowed, polling every sound");
+		pollSounds();
+	}
+	return dispatched;
+}
+
+/**
+ * @fn	bool BasicAudio::setSoundCallback(SOUND_HANDLE handle, SOUND_CALLBACK callback, void* pContext)
+ *
+ * @brief	Has callback told when the sound ends, loops or fails. It is called from run().
+ *
+ * @date	10/17/2026
+ *
+ * @return	false if the handle is stale or invalid.
+ */
+bool BasicAudio::setSoundCallback(SOUND_HANDLE handle, SOUND_CALLBACK callback, void* pContext){
+	SampleSound* ss = getSound(handle);
+	if(ss == NULL)
+		return false;
+	ss->setCallback(callback, pContext);
+	return true;
+}
+
+/**
+ * @fn	void BasicAudio::pollSounds()
+ *
+ * @brief	The old way of finding finished sounds, by asking every voice. Only used when the event queue has
+ * 			overflowed and some ends may have been lost; the sounds found to have stopped are sent the end
+ * 			event they missed.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::pollSounds(){
+	SampleSound *ss;
+	for(UINT32 i = 0; i < sounds.getSlotCount(); ++i){
+		ss = sounds.getSlot(i);
+		if(ss == NULL || !ss->isPlaying())
+			continue;
+		ss->run();
+		if(!ss->isPlaying()){
+			SoundEvent e = { SOUND_EVENT_END, ss->getHandle(), S_OK };
+			ss->onEvent(e);
+		}
+	}
+}
+
 /**
  * @fn	void BasicAudio::run()
  *
- * @brief	Calls run() on all the sound objects.
+ * @brief	Makes the voices of any async sounds that have finished loading, applies the commands posted since
+ * 			the last call, then dispatches the events the voices have queued. The cost depends on how much has
+ * 			happened since the last call, not on how many sounds there are. Each call ends a frame for
+ * 			getSpatialStats() and getStats().
  *
  * @author	Phil
  * @date	6/7/2013
  */
 void BasicAudio::run(){
-	SampleSound *ss;
-	SOUND_MAP::iterator it = soundMap.begin();
-	while(it != soundMap.end()){
-		ss = it->second;
-		ss->run();
-		it++;
+	{
+		ScopedTimer t(&timers[ENGINE_TIMER_RUN]);
+		if(!pendingLoads.empty())
+			finishLoads();
+		applyCommands();
+		dispatchEvents();
+		voicePool.run();
+		if(virtualizer.getSoundCount() > 0)
+			updateVirtualVoices();
+	}
+	endFrame();
+}
+
+/**
+ * @fn	void BasicAudio::updateVirtualVoices()
+ *
+ * @brief	The virtual sounds' part of run(): estimates how loud every emitter is, moves the virtual sounds on
+ * 			by the time since the last run() (the time mixed, offline) and lets the virtualizer move voices to
+ * 			the most audible. Newly promoted sounds are positioned at once, so they are in place before the
+ * 			next run() turns them up.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::updateVirtualVoices(){
+	double seconds;
+	if(pOfflineEngine != NULL){
+		seconds = (double)(offlineFrames - virtualFrames) / pOfflineEngine->getSampleRate();
+		virtualFrames = offlineFrames;
+	}else{
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		seconds = chrono::duration<double>(now - virtualClock).count();
+		virtualClock = now;
+	}
+
+	spatializer.setListener(getSpatialListener());
+	spatializer.estimateAudibility(&emitters);
+	promotedSounds.clear();
+	virtualizer.update(&emitters, seconds, &promotedSounds);
+	for(size_t i = 0; i < promotedSounds.size(); ++i){
+		play3DVoice(promotedSounds[i]);
+	}
+}
+
+/**
+ * @fn	void BasicAudio::endFrame()
+ *
+ * @brief	Closes the frame for getSpatialStats() and the timers.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::endFrame(){
+	lastSpatialStats = frameSpatialStats;
+	memset(&frameSpatialStats, 0, sizeof(frameSpatialStats));
+	for(UINT32 i = 0; i < ENGINE_TIMER_COUNT; ++i){
+		timers[i].endFrame();
+	}
+	frameCount++;
+}
+
+/**
+ * @fn	void BasicAudio::getStats(BasicAudioStats* stats)
+ *
+ * @brief	Gets the engine's timings and counters, see BasicAudioStats. Counting the playing sounds looks at
+ * 			every sound, so this is for a stats overlay or a periodic log line rather than for every frame.
+ *
+ * @date	10/17/2026
+ *
+ * @param [out]	stats	Receives the stats.
+ */
+void BasicAudio::getStats(BasicAudioStats* stats){
+	stats->frames = frameCount;
+	stats->sounds = 0;
+	stats->playingSounds = 0;
+	for(UINT32 i = 0; i < sounds.getSlotCount(); ++i){
+		SampleSound* ss = sounds.getSlot(i);
+		if(ss == NULL)
+			continue;
+		stats->sounds++;
+		if(ss->isPlaying())
+			stats->playingSounds++;
+	}
+	stats->pendingLoads = (UINT32)pendingLoads.size();
+	voicePool.getStats(&stats->instances);
+	virtualizer.getStats(&stats->virtualVoices);
+	commands.getStats(&stats->commands);
+	soundEvents.getStats(&stats->events);
+	stats->spatial = lastSpatialStats;
+	for(UINT32 i = 0; i < ENGINE_TIMER_COUNT; ++i){
+		timers[i].getStats(&stats->timers[i]);
+	}
+}
+
+/**
+ * @fn	void BasicAudio::resetStats()
+ *
+ * @brief	Empties the timing histograms, e.g. once loading is over so that it doesn't count towards the
+ * 			percentiles of play. The queue and voice pool counters carry on.
+ *
+ * @date	10/17/2026
+ */
+void BasicAudio::resetStats(){
+	for(UINT32 i = 0; i < ENGINE_TIMER_COUNT; ++i){
+		timers[i].reset();
 	}
 }
 
 /**
  * @fn	void BasicAudio::destroy()
  *
- * @brief	Destroys this object and all the sounds that belong to it.
+ * @brief	Destroys this object and all the sounds that belong to it, and lets go of the log's drain thread.
  *
  * @author	Phil
  * @date	6/7/2013
@@ -318,17 +1722,41 @@ void BasicAudio::run(){
 void BasicAudio::destroy(){
 	// All XAudio2 interfaces are released when the engine is destroyed, but being tidy
 
+	// No loader may still be writing to a sound
+	loaders.stop();
+	pendingLoads.clear();
+	// the virtual sounds' voices go before the sounds
+	virtualizer.destroy();
+
 	SampleSound *ss;
-	SOUND_MAP::iterator it = soundMap.begin();
-	while(it != soundMap.end()){
-		wprintf(L"Destroying %s\n", it->first);
-		ss = it->second;
+	for(UINT32 i = 0; i < sounds.getSlotCount(); ++i){
+		ss = sounds.getSlot(i);
+		if(ss == NULL)
+			continue;
+		AUDIO_LOG_INFO(L"Destroying %s", ss->getName());
 		ss->destroy();
-		it++;
+	}
+	for(size_t i = 0; i < soundBanks.size(); ++i){
+		soundBanks[i]->Release();
+	}
+	soundBanks.clear();
+	if(pOfflineFile != NULL)
+		endOfflineRender(NULL);
+	voicePool.destroy();
+	// children were made after their parents, so go backwards
+	while(!buses.empty()){
+		buses.back().pVoice->DestroyVoice();
+		buses.pop_back();
 	}
 	pMasteringVoice->DestroyVoice();
 
 	SAFE_RELEASE( pXAudio2 );
-	CoUninitialize();
+	if(pOfflineEngine == NULL)
+		CoUninitialize();
+	pOfflineEngine = NULL;
 	initialized = false;
+	// Join the log's thread here rather than in the destructor, which DLL users may never call, leaving
+	// it to static destruction under the loader lock. The last stop() writes out what is queued.
+	AudioLog::stop();
+	logRunning = false;
 }
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "EmitterSoA.h"
+#include "AlignedAlloc.h"
+#include <string.h>
+#include <math.h>
+
+/**
+ * @fn	EmitterSoA::EmitterSoA(void)
+ *
+ * @brief	Default constructor. Starts empty with a one by two matrix (mono source, stereo output).
+ *
+ * @date	10/17/2026
+ */
+EmitterSoA::EmitterSoA(void)
+{
+	FLOAT32** fields[FLOAT_FIELDS];
+	fieldPtrs(fields);
+	for(int f = 0; f < FLOAT_FIELDS; ++f)
+		*fields[f] = NULL;
+	channels = NULL;
+	spatialized = NULL;
+	dirty = NULL;
+	owner = NULL;
+	matrix = NULL;
+	appliedMatrix = NULL;
+	azimuths = NULL;
+	count = 0;
+	capacity = 0;
+	srcChannels = 1;
+	dstChannels = 2;
+}
+
+EmitterSoA::~EmitterSoA(void)
+{
+	clear();
+}
+
+void EmitterSoA::fieldPtrs(FLOAT32** fields[FLOAT_FIELDS])
+{
+	FLOAT32** all[FLOAT_FIELDS] = {
+		&posX, &posY, &posZ, &velX, &velY, &velZ,
+		&frontX, &frontY, &frontZ, &topX, &topY, &topZ,
+		&curveDistanceScaler, &dopplerScaler, &innerRadius, &innerRadiusAngle, &channelRadius, &gain,
+		&doppler, &distance, &reverbLevel, &lpfDirect, &audibility, &appliedDoppler };
+	memcpy(fields, all, sizeof(all));
+}
+
+/**
+ * @fn	FLOAT32* EmitterSoA::reallocStrided(FLOAT32* pOld, UINT32 newCapacity, UINT32 oldStride,
+ * 		UINT32 newStride, UINT32 keep)
+ *
+ * @brief	Makes a zeroed array of newCapacity slots of newStride floats, copies the start of the first keep
+ * 			slots of pOld into it and frees pOld.
+ *
+ * @date	10/17/2026
+ */
+FLOAT32* EmitterSoA::reallocStrided(FLOAT32* pOld, UINT32 newCapacity, UINT32 oldStride, UINT32 newStride, UINT32 keep)
+{
+	FLOAT32* p = (FLOAT32*)alignedAlloc(newCapacity * newStride * sizeof(FLOAT32), SIMD_ALIGNMENT);
+	memset(p, 0, newCapacity * newStride * sizeof(FLOAT32));
+	if(pOld != NULL){
+		UINT32 n = (oldStride < newStride) ? oldStride : newStride;
+		for(UINT32 i = 0; i < keep; ++i)
+			memcpy(p + i * newStride, pOld + i * oldStride, n * sizeof(FLOAT32));
+		alignedFree(pOld);
+	}
+	return p;
+}
+
+/**
+ * @fn	void EmitterSoA::setMatrixSize(UINT32 srcChannels, UINT32 dstChannels)
+ *
+ * @brief	Sets the shape of the per-emitter output matrix slots. Emitters keep their channel layouts, so
+ * 			srcChannels must be at least the most channels any of them has. Each emitter's matrix sits at the
+ * 			start of its slot, so with the same dstChannels the matrices and what the voices were last sent
+ * 			are kept, routing set directly included. A new dstChannels discards them and marks every emitter
+ * 			dirty.
+ *
+ * @date	10/17/2026
+ *
+ * @param	srcChannels	Most source channels of any emitter.
+ * @param	dstChannels	Output channels of the mastering voice.
+ */
+void EmitterSoA::setMatrixSize(UINT32 srcChannels, UINT32 dstChannels)
+{
+	UINT32 oldSrcChannels = this->srcChannels;
+	UINT32 oldStride = getMatrixStride();
+	if(dstChannels < 1)
+		dstChannels = 1;
+	bool sameOutput = (dstChannels == this->dstChannels);
+	this->srcChannels = (srcChannels > 0) ? srcChannels : 1;
+	this->dstChannels = dstChannels;
+	if(matrix != NULL){
+		UINT32 keep = sameOutput ? count : 0;
+		matrix = reallocStrided(matrix, capacity, oldStride, getMatrixStride(), keep);
+		appliedMatrix = reallocStrided(appliedMatrix, capacity, oldStride, getMatrixStride(), keep);
+		azimuths = reallocStrided(azimuths, capacity, oldSrcChannels, this->srcChannels, count);
+	}
+	if(!sameOutput)
+		markAllDirty(EMITTER_DIRTY_INPUT | EMITTER_DIRTY_OUTPUT);
+}
+
+/**
+ * @fn	void EmitterSoA::setChannels(UINT32 index, UINT32 count, FLOAT32 radius, const FLOAT32* pAzimuths)
+ *
+ * @brief	Sets how many source channels an emitter has and where they are, as X3DAUDIO_EMITTER's
+ * 			ChannelCount, ChannelRadius and pChannelAzimuths. If the emitter has more channels than any before
+ * 			it, every matrix slot in the store grows to match.
+ *
+ * @date	10/17/2026
+ *
+ * @param	index	 	The emitter.
+ * @param	count	 	Source channels, 1 to EMITTER_MAX_CHANNELS.
+ * @param	radius   	Distance of the channels from the emitter's position.
+ * @param	pAzimuths	count azimuths in radians, clockwise from the emitter's front, with EMITTER_LFE_AZIMUTH
+ * 						for an LFE channel. May be NULL for a mono emitter.
+ */
+void EmitterSoA::setChannels(UINT32 index, UINT32 count, FLOAT32 radius, const FLOAT32* pAzimuths)
+{
+	if(count < 1)
+		count = 1;
+	if(count > EMITTER_MAX_CHANNELS)
+		count = EMITTER_MAX_CHANNELS;
+	if(count > srcChannels)
+		setMatrixSize(count, dstChannels);
+
+	FLOAT32* a = azimuths + index * srcChannels;
+	bool changed = channels[index] != count || channelRadius[index] != radius;
+	for(UINT32 c = 0; c < count; ++c){
+		FLOAT32 azimuth = (pAzimuths != NULL) ? pAzimuths[c] : 0.0f;
+		changed = changed || a[c] != azimuth;
+		a[c] = azimuth;
+	}
+	if(!changed)
+		return;
+	channels[index] = (BYTE)count;
+	channelRadius[index] = radius;
+	memset(getMatrix(index), 0, getMatrixStride() * sizeof(FLOAT32));
+	markDirty(index, EMITTER_DIRTY_INPUT | EMITTER_DIRTY_OUTPUT);
+}
+
+/**
+ * @fn	void EmitterSoA::grow(UINT32 newCapacity)
+ *
+ * @brief	Reallocates every array, keeping the first count entries.
+ *
+ * @date	10/17/2026
+ */
+void EmitterSoA::grow(UINT32 newCapacity)
+{
+	newCapacity = (newCapacity + EMITTER_SOA_GRANULE - 1) & ~(UINT32)(EMITTER_SOA_GRANULE - 1);
+
+	FLOAT32** fields[FLOAT_FIELDS];
+	fieldPtrs(fields);
+	for(int f = 0; f < FLOAT_FIELDS; ++f){
+		FLOAT32* p = (FLOAT32*)alignedAlloc(newCapacity * sizeof(FLOAT32), SIMD_ALIGNMENT);
+		memset(p, 0, newCapacity * sizeof(FLOAT32));
+		if(*fields[f] != NULL){
+			memcpy(p, *fields[f], count * sizeof(FLOAT32));
+			alignedFree(*fields[f]);
+		}
+		*fields[f] = p;
+	}
+
+	UINT32 stride = getMatrixStride();
+	matrix = reallocStrided(matrix, newCapacity, stride, stride, count);
+	appliedMatrix = reallocStrided(appliedMatrix, newCapacity, stride, stride, count);
+	azimuths = reallocStrided(azimuths, newCapacity, srcChannels, srcChannels, count);
+
+	BYTE* c = new BYTE[newCapacity];
+	memset(c, 0, newCapacity);
+	BYTE* s = new BYTE[newCapacity];
+	memset(s, 0, newCapacity);
+	BYTE* d = new BYTE[newCapacity];
+	memset(d, 0, newCapacity);
+	SOUND_HANDLE* o = new SOUND_HANDLE[newCapacity];
+	memset(o, 0, newCapacity * sizeof(SOUND_HANDLE));
+	if(spatialized != NULL){
+		memcpy(c, channels, count);
+		memcpy(s, spatialized, count);
+		memcpy(d, dirty, count);
+		memcpy(o, owner, count * sizeof(SOUND_HANDLE));
+	}
+	SAFE_DELETE_ARRAY(channels);
+	SAFE_DELETE_ARRAY(spatialized);
+	SAFE_DELETE_ARRAY(dirty);
+	SAFE_DELETE_ARRAY(owner);
+	channels = c;
+	spatialized = s;
+	dirty = d;
+	owner = o;
+
+	capacity = newCapacity;
+}
+
+/**
+ * @fn	UINT32 EmitterSoA::add(SOUND_HANDLE owner)
+ *
+ * @brief	Adds an emitter for a sound. The new emitter is mono, at the origin, facing +Z with +Y up, not
+ * 			spatialized, with unit scalers, and fully dirty. The owner fills in the real values.
+ *
+ * @date	10/17/2026
+ *
+ * @param	owner	Handle of the sound the emitter belongs to.
+ *
+ * @return	Index of the new emitter.
+ */
+UINT32 EmitterSoA::add(SOUND_HANDLE owner)
+{
+	if(count == capacity)
+		grow(capacity > 0 ? capacity * 2 : (UINT32)EMITTER_SOA_GRANULE);
+
+	UINT32 i = count++;
+	posX[i] = posY[i] = posZ[i] = 0;
+	velX[i] = velY[i] = velZ[i] = 0;
+	frontX[i] = frontY[i] = 0; frontZ[i] = 1;
+	topX[i] = topZ[i] = 0; topY[i] = 1;
+	curveDistanceScaler[i] = 1;
+	dopplerScaler[i] = 1;
+	innerRadius[i] = 0;
+	innerRadiusAngle[i] = 0;
+	channelRadius[i] = 1;
+	gain[i] = 1;
+	channels[i] = 1;
+	memset(azimuths + i * srcChannels, 0, srcChannels * sizeof(FLOAT32));
+	doppler[i] = 1;
+	distance[i] = 0;
+	reverbLevel[i] = 0;
+	lpfDirect[i] = 1;
+	audibility[i] = 0;
+	memset(getMatrix(i), 0, getMatrixStride() * sizeof(FLOAT32));
+	appliedDoppler[i] = 1;
+	memset(getAppliedMatrix(i), 0, getMatrixStride() * sizeof(FLOAT32));
+	spatialized[i] = 0;
+	dirty[i] = EMITTER_DIRTY_INPUT | EMITTER_DIRTY_OUTPUT;
+	this->owner[i] = owner;
+	return i;
+}
+
+/**
+ * @fn	SOUND_HANDLE EmitterSoA::remove(UINT32 index)
+ *
+ * @brief	Removes an emitter by moving the last one into its place, keeping the arrays dense.
+ *
+ * @date	10/17/2026
+ *
+ * @param	index	Index of the emitter to remove.
+ *
+ * @return	The owner of the emitter that now lives at index, whose stored index must be updated, or
+ * 			SOUND_HANDLE_INVALID if nothing moved.
+ */
+SOUND_HANDLE EmitterSoA::remove(UINT32 index)
+{
+	if(index >= count)
+		return SOUND_HANDLE_INVALID;
+
+	UINT32 last = --count;
+	if(index == last)
+		return SOUND_HANDLE_INVALID;
+
+	FLOAT32** fields[FLOAT_FIELDS];
+	fieldPtrs(fields);
+	for(int f = 0; f < FLOAT_FIELDS; ++f)
+		(*fields[f])[index] = (*fields[f])[last];
+	memcpy(getMatrix(index), getMatrix(last), getMatrixStride() * sizeof(FLOAT32));
+	memcpy(getAppliedMatrix(index), getAppliedMatrix(last), getMatrixStride() * sizeof(FLOAT32));
+	memcpy(azimuths + index * srcChannels, azimuths + last * srcChannels, srcChannels * sizeof(FLOAT32));
+	channels[index] = channels[last];
+	spatialized[index] = spatialized[last];
+	dirty[index] = dirty[last];
+	owner[index] = owner[last];
+	return owner[index];
+}
+
+/**
+ * @fn	void EmitterSoA::clear()
+ *
+ * @brief	Removes every emitter and frees the arrays.
+ *
+ * @date	10/17/2026
+ */
+void EmitterSoA::clear()
+{
+	FLOAT32** fields[FLOAT_FIELDS];
+	fieldPtrs(fields);
+	for(int f = 0; f < FLOAT_FIELDS; ++f){
+		if(*fields[f] != NULL)
+			alignedFree(*fields[f]);
+		*fields[f] = NULL;
+	}
+	if(matrix != NULL)
+		alignedFree(matrix);
+	matrix = NULL;
+	if(appliedMatrix != NULL)
+		alignedFree(appliedMatrix);
+	appliedMatrix = NULL;
+	if(azimuths != NULL)
+		alignedFree(azimuths);
+	azimuths = NULL;
+	SAFE_DELETE_ARRAY(channels);
+	SAFE_DELETE_ARRAY(spatialized);
+	SAFE_DELETE_ARRAY(dirty);
+	SAFE_DELETE_ARRAY(owner);
+	count = 0;
+	capacity = 0;
+}
+
+/**
+ * @fn	void EmitterSoA::markAllDirty(BYTE flags)
+ *
+ * @brief	Sets flags on every emitter, e.g. EMITTER_DIRTY_INPUT when the listener moves.
+ *
+ * @date	10/17/2026
+ */
+void EmitterSoA::markAllDirty(BYTE flags)
+{
+	for(UINT32 i = 0; i < count; ++i)
+		dirty[i] |= flags;
+}
+
+/**
+ * @fn	bool EmitterSoA::commit(UINT32 index, FLOAT32 epsilon)
+ *
+ * @brief	Decides whether an emitter's voice needs the results just computed, and clears its dirty flags.
+ * 			If it does, the results become the applied ones.
+ *
+ * @date	10/17/2026
+ *
+ * @param	index  	The emitter.
+ * @param	epsilon	Largest difference from the applied results that counts as unchanged.
+ *
+ * @return	true if the caller must send doppler[index] and getMatrix(index), getMatrixSize(index) floats, to
+ * 			the voice.
+ */
+bool EmitterSoA::commit(UINT32 index, FLOAT32 epsilon)
+{
+	bool changed = (dirty[index] & EMITTER_DIRTY_OUTPUT) != 0 || fabsf(doppler[index] - appliedDoppler[index]) > epsilon;
+	const FLOAT32* m = getMatrix(index);
+	FLOAT32* a = getAppliedMatrix(index);
+	UINT32 size = getMatrixSize(index);
+	for(UINT32 c = 0; c < size && !changed; ++c){
+		changed = fabsf(m[c] - a[c]) > epsilon;
+	}
+	dirty[index] = 0;
+	if(!changed)
+		return false;
+
+	appliedDoppler[index] = doppler[index];
+	memcpy(a, m, size * sizeof(FLOAT32));
+	return true;
+}
@@ -0,0 +1,127 @@
+#include "EngineStats.h"
+#include <string.h>
+#include <math.h>
+
+void LatencyHistogram::clear()
+{
+	memset(buckets, 0, sizeof(buckets));
+	count = 0;
+	maxNs = 0;
+}
+
+/**
+ * @fn	UINT32 LatencyHistogram::getBucket(UINT64 ns)
+ *
+ * @brief	Finds the bucket for a duration: the duration itself below LATENCY_HISTOGRAM_LINEAR, above that
+ * 			the power of two it falls in and the three bits below the top one.
+ *
+ * @date	10/17/2026
+ */
+UINT32 LatencyHistogram::getBucket(UINT64 ns)
+{
+	if(ns < LATENCY_HISTOGRAM_LINEAR)
+		return (UINT32)ns;
+	UINT32 msb = 4;
+	while(msb < 63 && (ns >> (msb + 1)) != 0){
+		msb++;
+	}
+	UINT32 sub = (UINT32)(ns >> (msb - 3)) & (LATENCY_HISTOGRAM_SUB_BUCKETS - 1);
+	return LATENCY_HISTOGRAM_LINEAR + (msb - 4) * LATENCY_HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+/**
+ * @fn	UINT64 LatencyHistogram::getBucketTop(UINT32 bucket)
+ *
+ * @brief	Gets the longest duration that falls in a bucket.
+ *
+ * @date	10/17/2026
+ */
+UINT64 LatencyHistogram::getBucketTop(UINT32 bucket)
+{
+	if(bucket < LATENCY_HISTOGRAM_LINEAR)
+		return bucket;
+	UINT32 k = bucket - LATENCY_HISTOGRAM_LINEAR;
+	UINT32 shift = k / LATENCY_HISTOGRAM_SUB_BUCKETS + 1;
+	UINT64 sub = k % LATENCY_HISTOGRAM_SUB_BUCKETS;
+	UINT64 bottom = (LATENCY_HISTOGRAM_SUB_BUCKETS + sub) << shift;
+	return bottom + ((UINT64)1 << shift) - 1;
+}
+
+/**
+ * @fn	UINT64 LatencyHistogram::getPercentile(double percent)
+ *
+ * @brief	Gets the duration that percent of the recorded durations are at or below. The answer is the top of
+ * 			the bucket it falls in, so it may overstate by up to a bucket's width, but never past the maximum.
+ *
+ * @date	10/17/2026
+ *
+ * @param	percent	0 to 100.
+ *
+ * @return	The duration in nanoseconds, 0 if nothing has been recorded.
+ */
+UINT64 LatencyHistogram::getPercentile(double percent)
+{
+	if(count == 0)
+		return 0;
+	UINT64 rank = (UINT64)ceil(percent / 100.0 * (double)count);
+	if(rank < 1)
+		rank = 1;
+	if(rank > count)
+		rank = count;
+
+	UINT64 seen = 0;
+	for(UINT32 i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i){
+		seen += buckets[i];
+		if(seen >= rank){
+			UINT64 top = getBucketTop(i);
+			return (top < maxNs) ? top : maxNs;
+		}
+	}
+	return maxNs;
+}
+
+/**
+ * @fn	void EngineTimer::endFrame()
+ *
+ * @brief	Closes the frame in progress: its total goes into the per-frame histogram if there were any calls,
+ * 			and it becomes the last frame.
+ *
+ * @date	10/17/2026
+ */
+void EngineTimer::endFrame()
+{
+	if(frameCalls > 0)
+		perFrame.record(frameNs);
+	lastFrameNs = frameNs;
+	lastFrameCalls = frameCalls;
+	frameNs = 0;
+	frameCalls = 0;
+}
+
+void EngineTimer::reset()
+{
+	perCall.clear();
+	perFrame.clear();
+	frameNs = 0;
+	frameCalls = 0;
+	lastFrameNs = 0;
+	lastFrameCalls = 0;
+}
+
+void EngineTimer::getStats(TimerStats* stats)
+{
+	stats->calls = perCall.getCount();
+	stats->frames = perFrame.getCount();
+	stats->lastFrameCalls = lastFrameCalls;
+	stats->lastFrameMicros = lastFrameNs / 1000.0;
+	stats->callP50Micros = perCall.getPercentile(50) / 1000.0;
+	stats->callP99Micros = perCall.getPercentile(99) / 1000.0;
+	stats->callMaxMicros = perCall.getMax() / 1000.0;
+	stats->frameP50Micros = perFrame.getPercentile(50) / 1000.0;
+	stats->frameP99Micros = perFrame.getPercentile(99) / 1000.0;
+	stats->frameMaxMicros = perFrame.getMax() / 1000.0;
+}
+
+/**
+// End of EngineStats.cpp
+ */
@@ -0,0 +1,171 @@
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @fn	MappedFile::MappedFile(void)
+ *
+ * @brief	Default constructor.
+ *
+ * @date	10/17/2026
+ */
+MappedFile::MappedFile(void)
+{
+	pData = NULL;
+	size = 0;
+#ifdef _WIN32
+	hFile = INVALID_HANDLE_VALUE;
+	hMapping = NULL;
+#else
+	fd = -1;
+#endif
+}
+
+/**
+ * @fn	MappedFile::~MappedFile(void)
+ *
+ * @brief	Destructor. Unmaps the file.
+ *
+ * @date	10/17/2026
+ */
+MappedFile::~MappedFile(void)
+{
+	close();
+}
+
+/**
+ * @fn	HRESULT MappedFile::open(const char* szFilename, bool sequential)
+ *
+ * @brief	Maps a file read-only.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szFilename	Name of the file.
+ * @param	sequential	The file will be read front to back, so the system should read ahead. Leave this
+ * 						false for a file that is read here and there, like a SoundBank.
+ *
+ * @return	S_OK, E_FILE_NOT_FOUND if the file can't be opened, or E_FAIL if it is empty or can't be mapped.
+ */
+HRESULT MappedFile::open(const char* szFilename, bool sequential)
+{
+	close();
+	if(szFilename == NULL)
+		return E_INVALIDARG;
+
+#ifdef _WIN32
+	hFile = CreateFileA(szFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | (sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS), NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+		return E_FILE_NOT_FOUND;
+	return map();
+#else
+	fd = ::open(szFilename, O_RDONLY);
+	if(fd < 0)
+		return E_FILE_NOT_FOUND;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size == 0){
+		close();
+		return E_FAIL;
+	}
+	size = (size_t)st.st_size;
+
+	void* pMap = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(pMap == MAP_FAILED){
+		size = 0;
+		close();
+		return E_FAIL;
+	}
+	if(sequential)
+		madvise(pMap, size, MADV_SEQUENTIAL | MADV_WILLNEED);
+	pData = (const BYTE*)pMap;
+	return S_OK;
+#endif
+}
+
+#ifdef _WIN32
+HRESULT MappedFile::open(const wchar_t* szFilename, bool sequential)
+{
+	close();
+	if(szFilename == NULL)
+		return E_INVALIDARG;
+
+	hFile = CreateFileW(szFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | (sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS), NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+		return E_FILE_NOT_FOUND;
+	return map();
+}
+
+/**
+ * @fn	HRESULT MappedFile::map()
+ *
+ * @brief	Maps the whole of the open hFile.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_FAIL if the file is empty or can't be mapped.
+ */
+HRESULT MappedFile::map()
+{
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0){
+		close();
+		return E_FAIL;
+	}
+
+	hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(hMapping == NULL){
+		close();
+		return E_FAIL;
+	}
+	pData = (const BYTE*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if(pData == NULL){
+		close();
+		return E_FAIL;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return S_OK;
+}
+#endif
+
+/**
+ * @fn	void MappedFile::close()
+ *
+ * @brief	Unmaps the file. Pointers into it are invalid after this.
+ *
+ * @date	10/17/2026
+ */
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if(pData != NULL)
+		UnmapViewOfFile(pData);
+	if(hMapping != NULL){
+		CloseHandle(hMapping);
+		hMapping = NULL;
+	}
+	if(hFile != INVALID_HANDLE_VALUE){
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+	}
+#else
+	if(pData != NULL)
+		munmap((void*)pData, size);
+	if(fd >= 0){
+		::close(fd);
+		fd = -1;
+	}
+#endif
+	pData = NULL;
+	size = 0;
+}
+
+/**
+// End of MappedFile.cpp
+ */
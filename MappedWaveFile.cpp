@@ -0,0 +1,230 @@
+#include "MappedWaveFile.h"
+#include "AdpcmCodec.h"
+#include <string.h>
+
+/**
+ * @fn	static DWORD readLE32(const BYTE* p)
+ *
+ * @brief	Reads a little-endian 32 bit value that may not be aligned.
+ */
+static DWORD readLE32(const BYTE* p)
+{
+	return (DWORD)p[0] | ((DWORD)p[1] << 8) | ((DWORD)p[2] << 16) | ((DWORD)p[3] << 24);
+}
+
+/**
+ * @fn	MappedWaveFile::MappedWaveFile(void)
+ *
+ * @brief	Default constructor.
+ *
+ * @date	10/17/2026
+ */
+MappedWaveFile::MappedWaveFile(void)
+{
+	pFileData = NULL;
+	fileSize = 0;
+	pData = NULL;
+	dataSize = 0;
+	factFrames = 0;
+	pFormat = NULL;
+}
+
+/**
+ * @fn	MappedWaveFile::~MappedWaveFile(void)
+ *
+ * @brief	Destructor. Unmaps the file.
+ *
+ * @date	10/17/2026
+ */
+MappedWaveFile::~MappedWaveFile(void)
+{
+	close();
+}
+
+/**
+ * @fn	HRESULT MappedWaveFile::open(const char* szFilename)
+ *
+ * @brief	Maps a WAV file read-only and parses its chunks.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szFilename	Name of the file.
+ *
+ * @return	S_OK, E_FILE_NOT_FOUND if the file can't be opened, or E_FAIL if the file can't be mapped or is not
+ * 			a WAV file.
+ */
+HRESULT MappedWaveFile::open(const char* szFilename)
+{
+	close();
+	HRESULT hr = mapping.open(szFilename);
+	if(FAILED(hr))
+		return hr;
+	pFileData = mapping.getData();
+	fileSize = mapping.getSize();
+
+	if(FAILED(hr = parse()))
+		close();
+	return hr;
+}
+
+#ifdef _WIN32
+HRESULT MappedWaveFile::open(const wchar_t* szFilename)
+{
+	close();
+	HRESULT hr = mapping.open(szFilename);
+	if(FAILED(hr))
+		return hr;
+	pFileData = mapping.getData();
+	fileSize = mapping.getSize();
+
+	if(FAILED(hr = parse()))
+		close();
+	return hr;
+}
+#endif
+
+/**
+ * @fn	HRESULT MappedWaveFile::openFromMemory(const BYTE* pFileData, size_t fileSize)
+ *
+ * @brief	Parses a complete WAV file image that is already in memory (a resource, or a file that has been
+ * 			read some other way). The memory is not copied and must stay valid while this object is open.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pFileData	The file image.
+ * @param	fileSize 	Size of the file image in bytes.
+ *
+ * @return	S_OK or E_FAIL if the image is not a WAV file.
+ */
+HRESULT MappedWaveFile::openFromMemory(const BYTE* pFileData, size_t fileSize)
+{
+	close();
+	if(pFileData == NULL)
+		return E_INVALIDARG;
+
+	this->pFileData = pFileData;
+	this->fileSize = fileSize;
+
+	HRESULT hr = parse();
+	if(FAILED(hr))
+		close();
+	return hr;
+}
+
+/**
+ * @fn	HRESULT MappedWaveFile::openData(const WAVEFORMATEX* pFormat, const BYTE* pData, DWORD dataSize,
+ * 		DWORD factFrames)
+ *
+ * @brief	Takes a format and sample data that have already been located, such as a sound in a SoundBank,
+ * 			so there is nothing to parse. The format is copied, the data is not and must stay valid while
+ * 			this object is open.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pFormat 	The format, followed by its cbSize extra bytes.
+ * @param	pData   	The sample data.
+ * @param	dataSize	Size of the sample data in bytes.
+ * @param	factFrames	The frame count from the sound's 'fact' chunk, 0 if it had none.
+ *
+ * @return	S_OK or E_INVALIDARG.
+ */
+HRESULT MappedWaveFile::openData(const WAVEFORMATEX* pFormat, const BYTE* pData, DWORD dataSize, DWORD factFrames)
+{
+	close();
+	if(pFormat == NULL || pData == NULL)
+		return E_INVALIDARG;
+
+	size_t formatBytes = sizeof(WAVEFORMATEX) + pFormat->cbSize;
+	this->pFormat = new BYTE[formatBytes];
+	memcpy(this->pFormat, pFormat, formatBytes);
+	this->pData = pData;
+	this->dataSize = dataSize;
+	this->factFrames = factFrames;
+	pFileData = pData;
+	fileSize = dataSize;
+	return S_OK;
+}
+
+/**
+ * @fn	void MappedWaveFile::close()
+ *
+ * @brief	Unmaps the file. Pointers returned by getData() are invalid after this.
+ *
+ * @date	10/17/2026
+ */
+void MappedWaveFile::close()
+{
+	mapping.close();
+	SAFE_DELETE_ARRAY(pFormat);
+	pFileData = NULL;
+	fileSize = 0;
+	pData = NULL;
+	dataSize = 0;
+	factFrames = 0;
+}
+
+/**
+ * @fn	HRESULT MappedWaveFile::parse()
+ *
+ * @brief	Walks the RIFF chunks of the mapped image, copies out the 'fmt ' chunk, notes the frame count in
+ * 			any 'fact' chunk before the data and points pData at the payload of the 'data' chunk. A data chunk
+ * 			that claims to run past the end of the file (as some writers leave behind) is clipped to the file.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_FAIL if the image is not a WAV file.
+ */
+HRESULT MappedWaveFile::parse()
+{
+	if(fileSize < 12 || memcmp(pFileData, "RIFF", 4) != 0 || memcmp(pFileData + 8, "WAVE", 4) != 0)
+		return E_FAIL;
+
+	const BYTE* pEnd = pFileData + fileSize;
+	const BYTE* pChunk = pFileData + 12;
+
+	while(pChunk + 8 <= pEnd){
+		DWORD chunkSize = readLE32(pChunk + 4);
+		const BYTE* pPayload = pChunk + 8;
+		size_t available = (size_t)(pEnd - pPayload);
+
+		if(memcmp(pChunk, "fmt ", 4) == 0){
+			// Expect the 'fmt' chunk to be at least as large as PCMWAVEFORMAT;
+			// non-PCM formats carry cbSize and that many extra bytes
+			if(chunkSize < 16 || chunkSize > available)
+				return E_FAIL;
+			WORD cbExtra = 0;
+			WORD formatTag = (WORD)(pPayload[0] | (pPayload[1] << 8));
+			if(formatTag != WAVE_FORMAT_PCM && chunkSize >= 18){
+				cbExtra = (WORD)(pPayload[16] | (pPayload[17] << 8));
+				if((size_t)cbExtra + 18 > chunkSize)
+					cbExtra = (WORD)(chunkSize - 18);
+			}
+			SAFE_DELETE_ARRAY(pFormat);
+			pFormat = new BYTE[sizeof(WAVEFORMATEX) + cbExtra];
+			memset(pFormat, 0, sizeof(WAVEFORMATEX) + cbExtra);
+			memcpy(pFormat, pPayload, 16);
+			if(cbExtra > 0)
+				memcpy(pFormat + sizeof(WAVEFORMATEX), pPayload + 18, cbExtra);
+			((WAVEFORMATEX*)pFormat)->cbSize = cbExtra;
+		}else if(memcmp(pChunk, "fact", 4) == 0){
+			if(chunkSize >= 4 && available >= 4)
+				factFrames = readLE32(pPayload);
+		}else if(memcmp(pChunk, "data", 4) == 0){
+			if(pFormat == NULL)
+				return E_FAIL;
+			pData = pPayload;
+			dataSize = (chunkSize > available) ? (DWORD)available : chunkSize;
+			// whole frames only, except that an ADPCM stream keeps its short last block
+			WORD blockAlign = ((WAVEFORMATEX*)pFormat)->nBlockAlign;
+			if(blockAlign > 0 && getAdpcmType((WAVEFORMATEX*)pFormat) == ADPCM_TYPE_NONE)
+				dataSize -= dataSize % blockAlign;
+			return S_OK;
+		}
+
+		// chunks are word aligned
+		if((size_t)chunkSize + (chunkSize & 1) > available)
+			break;
+		pChunk = pPayload + chunkSize + (chunkSize & 1);
+	}
+	return E_FAIL;
+}
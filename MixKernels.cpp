@@ -0,0 +1,466 @@
+#include "MixKernels.h"
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIX_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 code is compiled whatever the build target and only run after checking the CPU. MSVC allows the
+// intrinsics anywhere from VS2013, GCC and Clang need them marked per function.
+#if defined(MIX_HAS_SSE2) && defined(_MSC_VER) && _MSC_VER >= 1800
+#define MIX_HAS_AVX2 1
+#define MIX_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#elif defined(MIX_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MIX_HAS_AVX2 1
+#define MIX_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
+/**
+ * @fn	static void mixChannelScalar(const FLOAT32* pIn, UINT32 inStride, FLOAT32* pBus, UINT32 frames,
+ * 		UINT32 busChannels, const FLOAT32* pGains)
+ *
+ * @brief	Reference implementations. The vector versions do exactly the same multiply then add for every
+ * 			sample, just several at a time.
+ *
+ * @date	10/17/2026
+ */
+static void mixChannelScalar(const FLOAT32* pIn, UINT32 inStride, FLOAT32* pBus, UINT32 frames, UINT32 busChannels, const FLOAT32* pGains)
+{
+	for(UINT32 i = 0; i < frames; ++i){
+		FLOAT32 x = pIn[i * inStride];
+		FLOAT32* pFrame = pBus + i * busChannels;
+		for(UINT32 d = 0; d < busChannels; ++d){
+			pFrame[d] += x * pGains[d];
+		}
+	}
+}
+
+static void scaleScalar(FLOAT32* pData, UINT32 count, FLOAT32 gain)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		pData[i] *= gain;
+	}
+}
+
+static void toPCM16Scalar(const FLOAT32* pIn, INT16* pOut, UINT32 count)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		FLOAT32 s = pIn[i] * 32768.0f;
+		if(s != s){
+			s = 0.0f;   // NaN: silence, as the vector versions give
+		}else if(s > 32767.0f){
+			s = 32767.0f;
+		}else if(s < -32768.0f){
+			s = -32768.0f;
+		}
+		pOut[i] = (INT16)lrintf(s);
+	}
+}
+
+static FLOAT32 dotScalar(const FLOAT32* pA, const FLOAT32* pB, UINT32 count)
+{
+	FLOAT32 sums[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	for(UINT32 i = 0; i < count; i += 8){
+		for(UINT32 j = 0; j < 8; ++j){
+			sums[j] += pA[i + j] * pB[i + j];
+		}
+	}
+	// the same reduction the vector versions do: halves, then pairs
+	FLOAT32 t0 = sums[0] + sums[4], t1 = sums[1] + sums[5], t2 = sums[2] + sums[6], t3 = sums[3] + sums[7];
+	return (t0 + t2) + (t1 + t3);
+}
+
+static void lerpScalar(const FLOAT32* pA, const FLOAT32* pB, FLOAT32 t, FLOAT32* pOut, UINT32 count)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		pOut[i] = pA[i] + (pB[i] - pA[i]) * t;
+	}
+}
+
+#ifdef MIX_HAS_SSE2
+
+/**
+ * @fn	static void mixChannelSSE2(const FLOAT32* pIn, UINT32 inStride, FLOAT32* pBus, UINT32 frames,
+ * 		UINT32 busChannels, const FLOAT32* pGains)
+ *
+ * @brief	SSE2 versions. For 2 and 6 channel buses the vectors straddle frames, so the gains are laid out to
+ * 			repeat with the same period and each source sample is spread across the lanes of its frame.
+ *
+ * @date	10/17/2026
+ */
+static void mixChannelSSE2(const FLOAT32* pIn, UINT32 inStride, FLOAT32* pBus, UINT32 frames, UINT32 busChannels, const FLOAT32* pGains)
+{
+	UINT32 i = 0;
+	switch(busChannels){
+	case 8:{
+		__m128 g0 = _mm_loadu_ps(pGains);
+		__m128 g1 = _mm_loadu_ps(pGains + 4);
+		for(; i < frames; ++i){
+			__m128 x = _mm_set1_ps(pIn[i * inStride]);
+			FLOAT32* p = pBus + i * 8;
+			_mm_storeu_ps(p, _mm_add_ps(_mm_loadu_ps(p), _mm_mul_ps(x, g0)));
+			_mm_storeu_ps(p + 4, _mm_add_ps(_mm_loadu_ps(p + 4), _mm_mul_ps(x, g1)));
+		}
+		break;
+	}
+	case 6:{
+		// two frames are three vectors: a a a a | a a b b | b b b b
+		__m128 g0 = _mm_loadu_ps(pGains);
+		__m128 g1 = _mm_setr_ps(pGains[4], pGains[5], pGains[0], pGains[1]);
+		__m128 g2 = _mm_loadu_ps(pGains + 2);
+		for(; i + 2 <= frames; i += 2){
+			FLOAT32 a = pIn[i * inStride];
+			FLOAT32 b = pIn[(i + 1) * inStride];
+			FLOAT32* p = pBus + i * 6;
+			_mm_storeu_ps(p, _mm_add_ps(_mm_loadu_ps(p), _mm_mul_ps(_mm_set1_ps(a), g0)));
+			_mm_storeu_ps(p + 4, _mm_add_ps(_mm_loadu_ps(p + 4), _mm_mul_ps(_mm_setr_ps(a, a, b, b), g1)));
+			_mm_storeu_ps(p + 8, _mm_add_ps(_mm_loadu_ps(p + 8), _mm_mul_ps(_mm_set1_ps(b), g2)));
+		}
+		break;
+	}
+	case 4:{
+		__m128 g = _mm_loadu_ps(pGains);
+		for(; i < frames; ++i){
+			FLOAT32* p = pBus + i * 4;
+			_mm_storeu_ps(p, _mm_add_ps(_mm_loadu_ps(p), _mm_mul_ps(_mm_set1_ps(pIn[i * inStride]), g)));
+		}
+		break;
+	}
+	case 2:{
+		__m128 g = _mm_setr_ps(pGains[0], pGains[1], pGains[0], pGains[1]);
+		for(; i + 2 <= frames; i += 2){
+			FLOAT32 a = pIn[i * inStride];
+			FLOAT32 b = pIn[(i + 1) * inStride];
+			FLOAT32* p = pBus + i * 2;
+			_mm_storeu_ps(p, _mm_add_ps(_mm_loadu_ps(p), _mm_mul_ps(_mm_setr_ps(a, a, b, b), g)));
+		}
+		break;
+	}
+	}
+	if(i < frames){
+		mixChannelScalar(pIn + i * inStride, inStride, pBus + i * busChannels, frames - i, busChannels, pGains);
+	}
+}
+
+static void scaleSSE2(FLOAT32* pData, UINT32 count, FLOAT32 gain)
+{
+	__m128 g = _mm_set1_ps(gain);
+	UINT32 i = 0;
+	for(; i + 4 <= count; i += 4){
+		_mm_storeu_ps(pData + i, _mm_mul_ps(_mm_loadu_ps(pData + i), g));
+	}
+	scaleScalar(pData + i, count - i, gain);
+}
+
+static void toPCM16SSE2(const FLOAT32* pIn, INT16* pOut, UINT32 count)
+{
+	// clamp before converting: out of range floats convert to 0x80000000, which would saturate the wrong way.
+	// NaNs are zeroed first, since maxps would turn them into -32768
+	__m128 scale = _mm_set1_ps(32768.0f);
+	__m128 lo = _mm_set1_ps(-32768.0f);
+	__m128 hi = _mm_set1_ps(32767.0f);
+	UINT32 i = 0;
+	for(; i + 8 <= count; i += 8){
+		__m128 a = _mm_loadu_ps(pIn + i);
+		__m128 b = _mm_loadu_ps(pIn + i + 4);
+		a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_and_ps(a, _mm_cmpord_ps(a, a)), scale), lo), hi);
+		b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_and_ps(b, _mm_cmpord_ps(b, b)), scale), lo), hi);
+		_mm_storeu_si128((__m128i*)(pOut + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+	}
+	toPCM16Scalar(pIn + i, pOut + i, count - i);
+}
+
+static inline FLOAT32 reduceSSE2(__m128 lo, __m128 hi)
+{
+	__m128 t = _mm_add_ps(lo, hi);                      // t0 t1 t2 t3
+	t = _mm_add_ps(t, _mm_movehl_ps(t, t));             // t0+t2 t1+t3
+	t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));         // (t0+t2)+(t1+t3)
+	return _mm_cvtss_f32(t);
+}
+
+static FLOAT32 dotSSE2(const FLOAT32* pA, const FLOAT32* pB, UINT32 count)
+{
+	__m128 lo = _mm_setzero_ps();
+	__m128 hi = _mm_setzero_ps();
+	for(UINT32 i = 0; i < count; i += 8){
+		lo = _mm_add_ps(lo, _mm_mul_ps(_mm_loadu_ps(pA + i), _mm_loadu_ps(pB + i)));
+		hi = _mm_add_ps(hi, _mm_mul_ps(_mm_loadu_ps(pA + i + 4), _mm_loadu_ps(pB + i + 4)));
+	}
+	return reduceSSE2(lo, hi);
+}
+
+static void lerpSSE2(const FLOAT32* pA, const FLOAT32* pB, FLOAT32 t, FLOAT32* pOut, UINT32 count)
+{
+	__m128 vt = _mm_set1_ps(t);
+	UINT32 i = 0;
+	for(; i + 4 <= count; i += 4){
+		__m128 a = _mm_loadu_ps(pA + i);
+		_mm_storeu_ps(pOut + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pB + i), a), vt)));
+	}
+	lerpScalar(pA + i, pB + i, t, pOut + i, count - i);
+}
+
+#endif // MIX_HAS_SSE2
+
+#ifdef MIX_HAS_AVX2
+
+MIX_TARGET_AVX2 static inline __m256 spread4(const FLOAT32* pIn, UINT32 inStride, __m256i pattern)
+{
+	// four source samples into one register, then duplicated across lanes by the pattern
+	__m128 v = (inStride == 1) ? _mm_loadu_ps(pIn) : _mm_setr_ps(pIn[0], pIn[inStride], pIn[2 * inStride], pIn[3 * inStride]);
+	return _mm256_permutevar8x32_ps(_mm256_castps128_ps256(v), pattern);
+}
+
+MIX_TARGET_AVX2 static inline void accumulate(FLOAT32* p, __m256 x, __m256 g)
+{
+	_mm256_storeu_ps(p, _mm256_add_ps(_mm256_loadu_ps(p), _mm256_mul_ps(x, g)));
+}
+
+/**
+ * @fn	static void mixChannelAVX2(const FLOAT32* pIn, UINT32 inStride, FLOAT32* pBus, UINT32 frames,
+ * 		UINT32 busChannels, const FLOAT32* pGains)
+ *
+ * @brief	AVX2 versions. Buses narrower than 8 channels take four frames at a time, loading four source
+ * 			samples together and permuting them out to the lanes of their frames.
+ *
+ * @date	10/17/2026
+ */
+MIX_TARGET_AVX2 static void mixChannelAVX2(const FLOAT32* pIn, UINT32 inStride, FLOAT32* pBus, UINT32 frames, UINT32 busChannels, const FLOAT32* pGains)
+{
+	UINT32 i = 0;
+	switch(busChannels){
+	case 8:{
+		__m256 g = _mm256_loadu_ps(pGains);
+		for(; i < frames; ++i){
+			accumulate(pBus + i * 8, _mm256_set1_ps(pIn[i * inStride]), g);
+		}
+		break;
+	}
+	case 6:{
+		// four frames are three vectors: a a a a a a b b | b b b b c c c c | c c d d d d d d
+		__m256 g0 = _mm256_setr_ps(pGains[0], pGains[1], pGains[2], pGains[3], pGains[4], pGains[5], pGains[0], pGains[1]);
+		__m256 g1 = _mm256_setr_ps(pGains[2], pGains[3], pGains[4], pGains[5], pGains[0], pGains[1], pGains[2], pGains[3]);
+		__m256 g2 = _mm256_setr_ps(pGains[4], pGains[5], pGains[0], pGains[1], pGains[2], pGains[3], pGains[4], pGains[5]);
+		__m256i p0 = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 1, 1);
+		__m256i p1 = _mm256_setr_epi32(1, 1, 1, 1, 2, 2, 2, 2);
+		__m256i p2 = _mm256_setr_epi32(2, 2, 3, 3, 3, 3, 3, 3);
+		for(; i + 4 <= frames; i += 4){
+			const FLOAT32* pSrc = pIn + i * inStride;
+			FLOAT32* p = pBus + i * 6;
+			accumulate(p, spread4(pSrc, inStride, p0), g0);
+			accumulate(p + 8, spread4(pSrc, inStride, p1), g1);
+			accumulate(p + 16, spread4(pSrc, inStride, p2), g2);
+		}
+		break;
+	}
+	case 4:{
+		__m256 g = _mm256_setr_ps(pGains[0], pGains[1], pGains[2], pGains[3], pGains[0], pGains[1], pGains[2], pGains[3]);
+		__m256i p0 = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+		__m256i p1 = _mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3);
+		for(; i + 4 <= frames; i += 4){
+			const FLOAT32* pSrc = pIn + i * inStride;
+			FLOAT32* p = pBus + i * 4;
+			accumulate(p, spread4(pSrc, inStride, p0), g);
+			accumulate(p + 8, spread4(pSrc, inStride, p1), g);
+		}
+		break;
+	}
+	case 2:{
+		__m256 g = _mm256_setr_ps(pGains[0], pGains[1], pGains[0], pGains[1], pGains[0], pGains[1], pGains[0], pGains[1]);
+		__m256i p0 = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+		for(; i + 4 <= frames; i += 4){
+			accumulate(pBus + i * 2, spread4(pIn + i * inStride, inStride, p0), g);
+		}
+		break;
+	}
+	}
+	_mm256_zeroupper(); // avoid the AVX to SSE transition penalty in the tail and the caller
+	if(i < frames){
+		mixChannelSSE2(pIn + i * inStride, inStride, pBus + i * busChannels, frames - i, busChannels, pGains);
+	}
+}
+
+MIX_TARGET_AVX2 static void scaleAVX2(FLOAT32* pData, UINT32 count, FLOAT32 gain)
+{
+	__m256 g = _mm256_set1_ps(gain);
+	UINT32 i = 0;
+	for(; i + 8 <= count; i += 8){
+		_mm256_storeu_ps(pData + i, _mm256_mul_ps(_mm256_loadu_ps(pData + i), g));
+	}
+	_mm256_zeroupper();
+	scaleScalar(pData + i, count - i, gain);
+}
+
+MIX_TARGET_AVX2 static void toPCM16AVX2(const FLOAT32* pIn, INT16* pOut, UINT32 count)
+{
+	__m256 scale = _mm256_set1_ps(32768.0f);
+	__m256 lo = _mm256_set1_ps(-32768.0f);
+	__m256 hi = _mm256_set1_ps(32767.0f);
+	UINT32 i = 0;
+	for(; i + 16 <= count; i += 16){
+		__m256 a = _mm256_loadu_ps(pIn + i);
+		__m256 b = _mm256_loadu_ps(pIn + i + 8);
+		a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_and_ps(a, _mm256_cmp_ps(a, a, _CMP_ORD_Q)), scale), lo), hi);
+		b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_and_ps(b, _mm256_cmp_ps(b, b, _CMP_ORD_Q)), scale), lo), hi);
+		// packs works within 128 bit lanes, the permute puts the four quarters back in order
+		__m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+		_mm256_storeu_si256((__m256i*)(pOut + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	_mm256_zeroupper();
+	toPCM16SSE2(pIn + i, pOut + i, count - i);
+}
+
+MIX_TARGET_AVX2 static FLOAT32 dotAVX2(const FLOAT32* pA, const FLOAT32* pB, UINT32 count)
+{
+	__m256 acc = _mm256_setzero_ps();
+	for(UINT32 i = 0; i < count; i += 8){
+		acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(pA + i), _mm256_loadu_ps(pB + i)));
+	}
+	__m128 lo = _mm256_castps256_ps128(acc);
+	__m128 hi = _mm256_extractf128_ps(acc, 1);
+	_mm256_zeroupper();
+	return reduceSSE2(lo, hi);
+}
+
+MIX_TARGET_AVX2 static void lerpAVX2(const FLOAT32* pA, const FLOAT32* pB, FLOAT32 t, FLOAT32* pOut, UINT32 count)
+{
+	__m256 vt = _mm256_set1_ps(t);
+	UINT32 i = 0;
+	for(; i + 8 <= count; i += 8){
+		__m256 a = _mm256_loadu_ps(pA + i);
+		_mm256_storeu_ps(pOut + i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(pB + i), a), vt)));
+	}
+	_mm256_zeroupper();
+	lerpSSE2(pA + i, pB + i, t, pOut + i, count - i);
+}
+
+/**
+ * @fn	static bool cpuHasAVX2()
+ *
+ * @brief	Checks that both the CPU and the operating system (which has to save the YMM registers) support AVX2.
+ *
+ * @date	10/17/2026
+ */
+static bool cpuHasAVX2()
+{
+	unsigned int leaf1[4], leaf7[4];
+#ifdef _MSC_VER
+	int regs[4];
+	__cpuid(regs, 0);
+	if(regs[0] < 7)
+		return false;
+	__cpuid(regs, 1);
+	for(int r = 0; r < 4; ++r) leaf1[r] = (unsigned int)regs[r];
+	__cpuidex(regs, 7, 0);
+	for(int r = 0; r < 4; ++r) leaf7[r] = (unsigned int)regs[r];
+#else
+	if(__get_cpuid_max(0, NULL) < 7)
+		return false;
+	__cpuid(1, leaf1[0], leaf1[1], leaf1[2], leaf1[3]);
+	__cpuid_count(7, 0, leaf7[0], leaf7[1], leaf7[2], leaf7[3]);
+#endif
+	bool osxsave = (leaf1[2] & (1u << 27)) != 0;
+	bool avx = (leaf1[2] & (1u << 28)) != 0;
+	bool avx2 = (leaf7[1] & (1u << 5)) != 0;
+	if(!osxsave || !avx || !avx2)
+		return false;
+
+	// XCR0 bits 1 and 2: the OS saves SSE and AVX state
+#ifdef _MSC_VER
+	unsigned long long xcr0 = _xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	unsigned long long xcr0 = ((unsigned long long)edx << 32) | eax;
+#endif
+	return (xcr0 & 6) == 6;
+}
+
+#endif // MIX_HAS_AVX2
+
+static const MixKernels scalarKernels = { MIX_KERNEL_SCALAR, mixChannelScalar, scaleScalar, toPCM16Scalar, dotScalar, lerpScalar };
+#ifdef MIX_HAS_SSE2
+static const MixKernels sse2Kernels = { MIX_KERNEL_SSE2, mixChannelSSE2, scaleSSE2, toPCM16SSE2, dotSSE2, lerpSSE2 };
+#endif
+#ifdef MIX_HAS_AVX2
+static const MixKernels avx2Kernels = { MIX_KERNEL_AVX2, mixChannelAVX2, scaleAVX2, toPCM16AVX2, dotAVX2, lerpAVX2 };
+#endif
+
+/**
+ * @fn	bool isMixKernelAvailable(MIX_KERNEL kernel)
+ *
+ * @brief	Tells if a kernel can be used: it was compiled in and, for AVX2, this machine supports it.
+ *
+ * @date	10/17/2026
+ */
+bool isMixKernelAvailable(MIX_KERNEL kernel)
+{
+	switch(kernel){
+		case MIX_KERNEL_SCALAR:
+			return true;
+#ifdef MIX_HAS_SSE2
+		case MIX_KERNEL_SSE2:
+			return true;
+#endif
+#ifdef MIX_HAS_AVX2
+		case MIX_KERNEL_AVX2:{
+			static const bool hasAVX2 = cpuHasAVX2();
+			return hasAVX2;
+		}
+#endif
+		default:
+			return false;
+	}
+}
+
+/**
+ * @fn	MIX_KERNEL getBestMixKernel()
+ *
+ * @brief	The widest kernel that can be used on this machine.
+ *
+ * @date	10/17/2026
+ */
+MIX_KERNEL getBestMixKernel()
+{
+	if(isMixKernelAvailable(MIX_KERNEL_AVX2))
+		return MIX_KERNEL_AVX2;
+	if(isMixKernelAvailable(MIX_KERNEL_SSE2))
+		return MIX_KERNEL_SSE2;
+	return MIX_KERNEL_SCALAR;
+}
+
+/**
+ * @fn	const MixKernels* getMixKernels(MIX_KERNEL kernel)
+ *
+ * @brief	Gets the functions of a kernel.
+ *
+ * @return	null if the kernel can't be used here.
+ *
+ * @date	10/17/2026
+ */
+const MixKernels* getMixKernels(MIX_KERNEL kernel)
+{
+	if(!isMixKernelAvailable(kernel))
+		return NULL;
+	switch(kernel){
+#ifdef MIX_HAS_AVX2
+		case MIX_KERNEL_AVX2:
+			return &avx2Kernels;
+#endif
+#ifdef MIX_HAS_SSE2
+		case MIX_KERNEL_SSE2:
+			return &sse2Kernels;
+#endif
+		default:
+			return &scalarKernels;
+	}
+}
+
+/**
+// End of MixKernels.cpp
+ */
@@ -0,0 +1,821 @@
+#include "StdAfx.h"
+#include "OfflineAudioEngine.h"
+
+/**
+ * @fn	OfflineSourceVoice::OfflineSourceVoice(OfflineAudioEngine* pEngine, UINT32 flags,
+ * 		IXAudio2VoiceCallback* pCallback)
+ *
+ * @brief	Constructor, only called from OfflineAudioEngine::CreateSourceVoice(), which makes the MixerVoice.
+ *
+ * @date	10/17/2026
+ */
+OfflineSourceVoice::OfflineSourceVoice(OfflineAudioEngine* pEngine, UINT32 flags, IXAudio2VoiceCallback* pCallback)
+{
+	this->pEngine = pEngine;
+	this->flags = flags;
+	this->pCallback = pCallback;
+	pVoice = NULL;
+}
+
+OfflineSourceVoice::~OfflineSourceVoice(void)
+{
+	if(pVoice != NULL){
+		pEngine->mixer.destroyVoice(pVoice);
+		pVoice = NULL;
+	}
+}
+
+void OfflineSourceVoice::GetVoiceDetails(XAUDIO2_VOICE_DETAILS* pVoiceDetails)
+{
+	pVoiceDetails->CreationFlags = flags;
+	pVoiceDetails->InputChannels = pVoice->getChannels();
+	pVoiceDetails->InputSampleRate = pVoice->getSourceSampleRate();
+}
+
+/**
+ * @fn	HRESULT OfflineSourceVoice::SetOutputVoices(const XAUDIO2_VOICE_SENDS* pSendList)
+ *
+ * @brief	Sends the voice to the mastering voice (a NULL or empty list) or to one submix voice, with the
+ * 			default output matrix for it.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineSourceVoice::SetOutputVoices(const XAUDIO2_VOICE_SENDS* pSendList)
+{
+	HRESULT hr;
+	MixerBus* pBus;
+	if(FAILED(hr = pEngine->resolveSends(pSendList, &pBus))){
+		return hr;
+	}
+	return pVoice->setOutput(pBus);
+}
+
+HRESULT OfflineSourceVoice::SetEffectChain(const XAUDIO2_EFFECT_CHAIN* pEffectChain)
+{
+	return pEffectChain == NULL ? S_OK : E_NOTIMPL;
+}
+
+HRESULT OfflineSourceVoice::EnableEffect(UINT32 EffectIndex, UINT32 OperationSet)
+{
+	return E_NOTIMPL;
+}
+
+HRESULT OfflineSourceVoice::DisableEffect(UINT32 EffectIndex, UINT32 OperationSet)
+{
+	return E_NOTIMPL;
+}
+
+void OfflineSourceVoice::GetEffectState(UINT32 EffectIndex, BOOL* pEnabled)
+{
+	*pEnabled = FALSE;
+}
+
+HRESULT OfflineSourceVoice::SetEffectParameters(UINT32 EffectIndex, const void* pParameters, UINT32 ParametersByteSize, UINT32 OperationSet)
+{
+	return E_NOTIMPL;
+}
+
+HRESULT OfflineSourceVoice::GetEffectParameters(UINT32 EffectIndex, void* pParameters, UINT32 ParametersByteSize)
+{
+	return E_NOTIMPL;
+}
+
+HRESULT OfflineSourceVoice::SetFilterParameters(const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet)
+{
+	return E_NOTIMPL;
+}
+
+void OfflineSourceVoice::GetFilterParameters(XAUDIO2_FILTER_PARAMETERS* pParameters)
+{
+}
+
+HRESULT OfflineSourceVoice::SetOutputFilterParameters(IXAudio2Voice* pDestinationVoice, const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet)
+{
+	return E_NOTIMPL;
+}
+
+void OfflineSourceVoice::GetOutputFilterParameters(IXAudio2Voice* pDestinationVoice, XAUDIO2_FILTER_PARAMETERS* pParameters)
+{
+}
+
+HRESULT OfflineSourceVoice::SetVolume(float Volume, UINT32 OperationSet)
+{
+	pVoice->setVolume(Volume);
+	return S_OK;
+}
+
+void OfflineSourceVoice::GetVolume(float* pVolume)
+{
+	*pVolume = pVoice->getVolume();
+}
+
+HRESULT OfflineSourceVoice::SetChannelVolumes(UINT32 Channels, const float* pVolumes, UINT32 OperationSet)
+{
+	return pVoice->setChannelVolumes(Channels, pVolumes);
+}
+
+void OfflineSourceVoice::GetChannelVolumes(UINT32 Channels, float* pVolumes)
+{
+	pVoice->getChannelVolumes(Channels, pVolumes);
+}
+
+/**
+ * @fn	HRESULT OfflineSourceVoice::SetOutputMatrix(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels,
+ * 		UINT32 DestinationChannels, const float* pLevelMatrix, UINT32 OperationSet)
+ *
+ * @brief	Sets the levels to the voice's one destination, which pDestinationVoice must be, or be NULL for.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineSourceVoice::SetOutputMatrix(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, const float* pLevelMatrix, UINT32 OperationSet)
+{
+	if(pDestinationVoice != NULL && !pEngine->isDestination(pDestinationVoice, pVoice->getOutput())){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	return pVoice->setOutputMatrix(SourceChannels, DestinationChannels, pLevelMatrix);
+}
+
+void OfflineSourceVoice::GetOutputMatrix(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, float* pLevelMatrix)
+{
+	pVoice->getOutputMatrix(SourceChannels, DestinationChannels, pLevelMatrix);
+}
+
+/**
+ * @fn	void OfflineSourceVoice::DestroyVoice()
+ *
+ * @brief	Removes the voice from the mix and deletes it. As in XAudio2 this must not be called from one of the
+ * 			voice's own callbacks.
+ *
+ * @date	10/17/2026
+ */
+void OfflineSourceVoice::DestroyVoice()
+{
+	pEngine->removeSourceVoice(this);
+	delete this;
+}
+
+HRESULT OfflineSourceVoice::Start(UINT32 Flags, UINT32 OperationSet)
+{
+	return pVoice->start();
+}
+
+HRESULT OfflineSourceVoice::Stop(UINT32 Flags, UINT32 OperationSet)
+{
+	pVoice->stop();
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT OfflineSourceVoice::SubmitSourceBuffer(const XAUDIO2_BUFFER* pBuffer,
+ * 		const XAUDIO2_BUFFER_WMA* pBufferWMA)
+ *
+ * @brief	Queues a buffer. The fields map one to one onto a MixerBuffer. WMA buffers are not supported.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineSourceVoice::SubmitSourceBuffer(const XAUDIO2_BUFFER* pBuffer, const XAUDIO2_BUFFER_WMA* pBufferWMA)
+{
+	if(pBuffer == NULL){
+		return E_INVALIDARG;
+	}
+	if(pBufferWMA != NULL){
+		return E_NOTIMPL;
+	}
+	MixerBuffer mb;
+	mb.flags = pBuffer->Flags;
+	mb.audioBytes = pBuffer->AudioBytes;
+	mb.pAudioData = pBuffer->pAudioData;
+	mb.playBegin = pBuffer->PlayBegin;
+	mb.playLength = pBuffer->PlayLength;
+	mb.loopBegin = pBuffer->LoopBegin;
+	mb.loopLength = pBuffer->LoopLength;
+	mb.loopCount = pBuffer->LoopCount;
+	mb.pContext = pBuffer->pContext;
+	return pVoice->submitBuffer(&mb);
+}
+
+HRESULT OfflineSourceVoice::FlushSourceBuffers()
+{
+	pVoice->flushBuffers();
+	return S_OK;
+}
+
+HRESULT OfflineSourceVoice::Discontinuity()
+{
+	pVoice->discontinuity();
+	return S_OK;
+}
+
+HRESULT OfflineSourceVoice::ExitLoop(UINT32 OperationSet)
+{
+	pVoice->exitLoop();
+	return S_OK;
+}
+
+void OfflineSourceVoice::GetState(XAUDIO2_VOICE_STATE* pVoiceState)
+{
+	pVoice->getState(&pVoiceState->pCurrentBufferContext, &pVoiceState->BuffersQueued, &pVoiceState->SamplesPlayed);
+}
+
+HRESULT OfflineSourceVoice::SetFrequencyRatio(float Ratio, UINT32 OperationSet)
+{
+	if(flags & XAUDIO2_VOICE_NOPITCH){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	return pVoice->setFrequencyRatio(Ratio);
+}
+
+void OfflineSourceVoice::GetFrequencyRatio(float* pRatio)
+{
+	*pRatio = pVoice->getFrequencyRatio();
+}
+
+HRESULT OfflineSourceVoice::SetSourceSampleRate(UINT32 NewSourceSampleRate)
+{
+	HRESULT hr = pVoice->setSourceSampleRate(NewSourceSampleRate);
+	return hr == E_FAIL ? XAUDIO2_E_INVALID_CALL : hr;
+}
+
+void OfflineSourceVoice::onProcessingPassStart(UINT32 bytesRequired)
+{
+	if(pCallback != NULL)
+		pCallback->OnVoiceProcessingPassStart(bytesRequired);
+}
+
+void OfflineSourceVoice::onProcessingPassEnd()
+{
+	if(pCallback != NULL)
+		pCallback->OnVoiceProcessingPassEnd();
+}
+
+void OfflineSourceVoice::onBufferStart(void* pContext)
+{
+	if(pCallback != NULL)
+		pCallback->OnBufferStart(pContext);
+}
+
+void OfflineSourceVoice::onBufferEnd(void* pContext)
+{
+	if(pCallback != NULL)
+		pCallback->OnBufferEnd(pContext);
+}
+
+void OfflineSourceVoice::onLoopEnd(void* pContext)
+{
+	if(pCallback != NULL)
+		pCallback->OnLoopEnd(pContext);
+}
+
+void OfflineSourceVoice::onStreamEnd()
+{
+	if(pCallback != NULL)
+		pCallback->OnStreamEnd();
+}
+
+void OfflineSourceVoice::onVoiceError(void* pContext, HRESULT error)
+{
+	if(pCallback != NULL)
+		pCallback->OnVoiceError(pContext, error);
+}
+
+void OfflineMasteringVoice::GetVoiceDetails(XAUDIO2_VOICE_DETAILS* pVoiceDetails)
+{
+	pVoiceDetails->CreationFlags = 0;
+	pVoiceDetails->InputChannels = pEngine->getChannels();
+	pVoiceDetails->InputSampleRate = pEngine->getSampleRate();
+}
+
+HRESULT OfflineMasteringVoice::SetVolume(float Volume, UINT32 OperationSet)
+{
+	pEngine->mixer.setMasterVolume(Volume);
+	return S_OK;
+}
+
+void OfflineMasteringVoice::GetVolume(float* pVolume)
+{
+	*pVolume = pEngine->mixer.getMasterVolume();
+}
+
+void OfflineMasteringVoice::GetChannelVolumes(UINT32 Channels, float* pVolumes)
+{
+	for(UINT32 i = 0; i < Channels; ++i){
+		pVolumes[i] = 1.0f;
+	}
+}
+
+/**
+ * @fn	void OfflineMasteringVoice::DestroyVoice()
+ *
+ * @brief	Destroys the mastering voice. As in XAudio2 the source voices should be destroyed first.
+ *
+ * @date	10/17/2026
+ */
+void OfflineMasteringVoice::DestroyVoice()
+{
+	if(pEngine->pMasteringVoice == this){
+		pEngine->pMasteringVoice = NULL;
+	}
+	delete this;
+}
+
+/**
+ * @fn	OfflineSubmixVoice::OfflineSubmixVoice(OfflineAudioEngine* pEngine, UINT32 flags, MixerBus* pBus)
+ *
+ * @brief	Constructor, only called from OfflineAudioEngine::CreateSubmixVoice(), which makes the MixerBus.
+ *
+ * @date	10/17/2026
+ */
+OfflineSubmixVoice::OfflineSubmixVoice(OfflineAudioEngine* pEngine, UINT32 flags, MixerBus* pBus)
+{
+	this->pEngine = pEngine;
+	this->flags = flags;
+	this->pBus = pBus;
+}
+
+OfflineSubmixVoice::~OfflineSubmixVoice(void)
+{
+	pEngine->mixer.destroyBus(pBus);
+}
+
+void OfflineSubmixVoice::GetVoiceDetails(XAUDIO2_VOICE_DETAILS* pVoiceDetails)
+{
+	pVoiceDetails->CreationFlags = flags;
+	pVoiceDetails->InputChannels = pBus->getChannels();
+	pVoiceDetails->InputSampleRate = pEngine->getSampleRate();
+}
+
+/**
+ * @fn	HRESULT OfflineSubmixVoice::SetOutputVoices(const XAUDIO2_VOICE_SENDS* pSendList)
+ *
+ * @brief	Sends the submix to the mastering voice (a NULL or empty list) or to one submix voice of a higher
+ * 			processing stage.
+ *
+ * @return	S_OK, the error from checking the list, or XAUDIO2_E_INVALID_CALL if the stage is not higher.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineSubmixVoice::SetOutputVoices(const XAUDIO2_VOICE_SENDS* pSendList)
+{
+	HRESULT hr;
+	MixerBus* pOutput;
+	if(FAILED(hr = pEngine->resolveSends(pSendList, &pOutput))){
+		return hr;
+	}
+	return SUCCEEDED(pBus->setOutput(pOutput)) ? S_OK : XAUDIO2_E_INVALID_CALL;
+}
+
+HRESULT OfflineSubmixVoice::SetVolume(float Volume, UINT32 OperationSet)
+{
+	pBus->setVolume(Volume);
+	return S_OK;
+}
+
+void OfflineSubmixVoice::GetVolume(float* pVolume)
+{
+	*pVolume = pBus->getVolume();
+}
+
+void OfflineSubmixVoice::GetChannelVolumes(UINT32 Channels, float* pVolumes)
+{
+	for(UINT32 i = 0; i < Channels; ++i){
+		pVolumes[i] = 1.0f;
+	}
+}
+
+HRESULT OfflineSubmixVoice::SetOutputMatrix(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, const float* pLevelMatrix, UINT32 OperationSet)
+{
+	if(pDestinationVoice != NULL && !pEngine->isDestination(pDestinationVoice, pBus->getOutput())){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	return pBus->setOutputMatrix(SourceChannels, DestinationChannels, pLevelMatrix);
+}
+
+void OfflineSubmixVoice::GetOutputMatrix(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, float* pLevelMatrix)
+{
+	pBus->getOutputMatrix(SourceChannels, DestinationChannels, pLevelMatrix);
+}
+
+/**
+ * @fn	void OfflineSubmixVoice::DestroyVoice()
+ *
+ * @brief	Removes the submix and deletes it. XAudio2 refuses while other voices still send to it; here they
+ * 			are sent on to the mastering voice instead.
+ *
+ * @date	10/17/2026
+ */
+void OfflineSubmixVoice::DestroyVoice()
+{
+	pEngine->removeSubmixVoice(this);
+	delete this;
+}
+
+/**
+ * @fn	OfflineAudioEngine::OfflineAudioEngine(void)
+ *
+ * @brief	Constructor. Use create().
+ *
+ * @date	10/17/2026
+ */
+OfflineAudioEngine::OfflineAudioEngine(void)
+{
+	refCount = 1;
+	pMasteringVoice = NULL;
+	engineRunning = true;
+}
+
+/**
+ * @fn	OfflineAudioEngine::~OfflineAudioEngine(void)
+ *
+ * @brief	Destructor. Like the real engine, releasing it destroys any voices that are left.
+ *
+ * @date	10/17/2026
+ */
+OfflineAudioEngine::~OfflineAudioEngine(void)
+{
+	while(!sourceVoices.empty()){
+		sourceVoices.back()->DestroyVoice();
+	}
+	while(!submixVoices.empty()){
+		submixVoices.back()->DestroyVoice();
+	}
+	if(pMasteringVoice != NULL){
+		pMasteringVoice->DestroyVoice();
+	}
+}
+
+/**
+ * @fn	HRESULT OfflineAudioEngine::create(UINT32 sampleRate, UINT32 channels, OfflineAudioEngine** ppEngine)
+ *
+ * @brief	Makes an engine that renders at the given rate and channel count. These are what the mastering
+ * 			voice gets when it is created with the defaults, and what GetDeviceDetails() reports.
+ *
+ * @param	sampleRate	   	Output sample rate.
+ * @param	channels	   	Output channels, 1 to MIXER_MAX_CHANNELS.
+ * @param [out]	ppEngine	The engine, with a reference count of one.
+ *
+ * @return	S_OK or E_INVALIDARG.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineAudioEngine::create(UINT32 sampleRate, UINT32 channels, OfflineAudioEngine** ppEngine)
+{
+	HRESULT hr;
+	*ppEngine = NULL;
+	OfflineAudioEngine* pEngine = new OfflineAudioEngine();
+	if(FAILED(hr = pEngine->mixer.init(sampleRate, channels))){
+		pEngine->Release();
+		return hr;
+	}
+	*ppEngine = pEngine;
+	return S_OK;
+}
+
+HRESULT OfflineAudioEngine::QueryInterface(REFIID riid, void** ppvInterface)
+{
+	if(riid == __uuidof(IUnknown)){
+		AddRef();
+		*ppvInterface = (IUnknown*)this;
+		return S_OK;
+	}
+	*ppvInterface = NULL;
+	return E_NOINTERFACE;
+}
+
+ULONG OfflineAudioEngine::AddRef()
+{
+	return ++refCount;
+}
+
+ULONG OfflineAudioEngine::Release()
+{
+	LONG count = --refCount;
+	if(count == 0){
+		delete this;
+	}
+	return count;
+}
+
+HRESULT OfflineAudioEngine::GetDeviceCount(UINT32* pCount)
+{
+	*pCount = 1;
+	return S_OK;
+}
+
+/**
+ * @fn	DWORD OfflineAudioEngine::getChannelMask(UINT32 channels)
+ *
+ * @brief	The speaker layout Windows would report for a device with this many channels.
+ *
+ * @date	10/17/2026
+ */
+DWORD OfflineAudioEngine::getChannelMask(UINT32 channels)
+{
+	switch(channels){
+	case 1: return SPEAKER_FRONT_CENTER;
+	case 2: return SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT;
+	case 4: return SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT | SPEAKER_BACK_LEFT | SPEAKER_BACK_RIGHT;
+	case 6: return SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT | SPEAKER_FRONT_CENTER | SPEAKER_LOW_FREQUENCY | SPEAKER_BACK_LEFT | SPEAKER_BACK_RIGHT;
+	case 8: return SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT | SPEAKER_FRONT_CENTER | SPEAKER_LOW_FREQUENCY | SPEAKER_BACK_LEFT | SPEAKER_BACK_RIGHT | SPEAKER_SIDE_LEFT | SPEAKER_SIDE_RIGHT;
+	}
+	return (1 << channels) - 1;
+}
+
+/**
+ * @fn	HRESULT OfflineAudioEngine::GetDeviceDetails(UINT32 Index, XAUDIO2_DEVICE_DETAILS* pDeviceDetails)
+ *
+ * @brief	Describes the single, virtual output: 32 bit float at the engine's rate and channel count.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineAudioEngine::GetDeviceDetails(UINT32 Index, XAUDIO2_DEVICE_DETAILS* pDeviceDetails)
+{
+	// KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, spelled out to avoid needing ksmedia.h
+	static const GUID floatSubFormat = {0x00000003, 0x0000, 0x0010, {0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71}};
+
+	if(Index != 0){
+		return E_INVALIDARG;
+	}
+	memset(pDeviceDetails, 0, sizeof(XAUDIO2_DEVICE_DETAILS));
+	wcscpy_s(pDeviceDetails->DeviceID, 256, L"Offline");
+	wcscpy_s(pDeviceDetails->DisplayName, 256, L"Offline renderer");
+	pDeviceDetails->Role = GlobalDefaultDevice;
+
+	WAVEFORMATEXTENSIBLE* pFormat = &pDeviceDetails->OutputFormat;
+	pFormat->Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+	pFormat->Format.nChannels = (WORD)getChannels();
+	pFormat->Format.nSamplesPerSec = getSampleRate();
+	pFormat->Format.wBitsPerSample = 32;
+	pFormat->Format.nBlockAlign = (WORD)(getChannels() * sizeof(FLOAT32));
+	pFormat->Format.nAvgBytesPerSec = getSampleRate() * pFormat->Format.nBlockAlign;
+	pFormat->Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+	pFormat->Samples.wValidBitsPerSample = 32;
+	pFormat->dwChannelMask = getChannelMask(getChannels());
+	pFormat->SubFormat = floatSubFormat;
+	return S_OK;
+}
+
+HRESULT OfflineAudioEngine::RegisterForCallbacks(IXAudio2EngineCallback* pCallback)
+{
+	if(pCallback == NULL){
+		return E_INVALIDARG;
+	}
+	engineCallbacks.push_back(pCallback);
+	return S_OK;
+}
+
+void OfflineAudioEngine::UnregisterForCallbacks(IXAudio2EngineCallback* pCallback)
+{
+	for(size_t i = 0; i < engineCallbacks.size(); ++i){
+		if(engineCallbacks[i] == pCallback){
+			engineCallbacks.erase(engineCallbacks.begin() + i);
+			return;
+		}
+	}
+}
+
+/**
+ * @fn	bool OfflineAudioEngine::isDestination(IXAudio2Voice* pVoice, MixerBus* pBus)
+ *
+ * @brief	Whether pVoice is the voice that mixes to pBus: the mastering voice for NULL, else the submix voice
+ * 			that owns it.
+ *
+ * @date	10/17/2026
+ */
+bool OfflineAudioEngine::isDestination(IXAudio2Voice* pVoice, MixerBus* pBus)
+{
+	if(pBus == NULL){
+		return pVoice == pMasteringVoice;
+	}
+	for(size_t i = 0; i < submixVoices.size(); ++i){
+		if(submixVoices[i]->pBus == pBus){
+			return pVoice == submixVoices[i];
+		}
+	}
+	return false;
+}
+
+/**
+ * @fn	HRESULT OfflineAudioEngine::resolveSends(const XAUDIO2_VOICE_SENDS* pSendList, MixerBus** ppBus)
+ *
+ * @brief	Finds the bus a send list names. Only one send is supported, to the mastering voice or to a submix
+ * 			voice; a NULL or empty list means the mastering voice.
+ *
+ * @param	pSendList	 	The list.
+ * @param [out]	ppBus	The submix's bus, or NULL for the mastering voice.
+ *
+ * @return	S_OK, E_NOTIMPL for more than one send, or E_INVALIDARG for a voice not of this engine.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineAudioEngine::resolveSends(const XAUDIO2_VOICE_SENDS* pSendList, MixerBus** ppBus)
+{
+	*ppBus = NULL;
+	if(pSendList == NULL || pSendList->SendCount == 0){
+		return S_OK;
+	}
+	if(pSendList->SendCount > 1){
+		return E_NOTIMPL;
+	}
+	IXAudio2Voice* pOutput = pSendList->pSends[0].pOutputVoice;
+	if(pOutput == pMasteringVoice){
+		return S_OK;
+	}
+	for(size_t i = 0; i < submixVoices.size(); ++i){
+		if(submixVoices[i] == pOutput){
+			*ppBus = submixVoices[i]->pBus;
+			return S_OK;
+		}
+	}
+	return E_INVALIDARG;
+}
+
+/**
+ * @fn	HRESULT OfflineAudioEngine::CreateSourceVoice(IXAudio2SourceVoice** ppSourceVoice,
+ * 		const WAVEFORMATEX* pSourceFormat, UINT32 Flags, float MaxFrequencyRatio,
+ * 		IXAudio2VoiceCallback* pCallback, const XAUDIO2_VOICE_SENDS* pSendList,
+ * 		const XAUDIO2_EFFECT_CHAIN* pEffectChain)
+ *
+ * @brief	Makes a source voice that mixes into the mastering voice, which must already exist, or into the one
+ * 			submix voice the send list names. PCM and float formats are supported, effect chains are not.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineAudioEngine::CreateSourceVoice(IXAudio2SourceVoice** ppSourceVoice, const WAVEFORMATEX* pSourceFormat, UINT32 Flags, float MaxFrequencyRatio, IXAudio2VoiceCallback* pCallback, const XAUDIO2_VOICE_SENDS* pSendList, const XAUDIO2_EFFECT_CHAIN* pEffectChain)
+{
+	HRESULT hr;
+	if(ppSourceVoice == NULL){
+		return E_INVALIDARG;
+	}
+	*ppSourceVoice = NULL;
+	if(pMasteringVoice == NULL){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	if(pEffectChain != NULL){
+		return E_NOTIMPL;
+	}
+	MixerBus* pBus;
+	if(FAILED(hr = resolveSends(pSendList, &pBus))){
+		return hr;
+	}
+
+	OfflineSourceVoice* pVoice = new OfflineSourceVoice(this, Flags, pCallback);
+	if(FAILED(hr = mixer.createVoice(pSourceFormat, MaxFrequencyRatio, pVoice, &pVoice->pVoice))){
+		delete pVoice;
+		return hr;
+	}
+	if(pBus != NULL){
+		pVoice->pVoice->setOutput(pBus);
+	}
+	sourceVoices.push_back(pVoice);
+	*ppSourceVoice = pVoice;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT OfflineAudioEngine::CreateSubmixVoice(IXAudio2SubmixVoice** ppSubmixVoice,
+ * 		UINT32 InputChannels, UINT32 InputSampleRate, UINT32 Flags, UINT32 ProcessingStage,
+ * 		const XAUDIO2_VOICE_SENDS* pSendList, const XAUDIO2_EFFECT_CHAIN* pEffectChain)
+ *
+ * @brief	Makes a submix voice, mixed as a MixerBus in the order of its processing stage. The mastering voice
+ * 			must already exist. Submixes run at the engine's rate, so InputSampleRate must be that rate or the
+ * 			default; effect chains are not supported.
+ *
+ * @return	S_OK, E_INVALIDARG for a bad channel count or send, E_NOTIMPL for another rate, more than one send
+ * 			or an effect chain, or XAUDIO2_E_INVALID_CALL with no mastering voice or a send to a submix whose
+ * 			stage is not higher.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineAudioEngine::CreateSubmixVoice(IXAudio2SubmixVoice** ppSubmixVoice, UINT32 InputChannels, UINT32 InputSampleRate, UINT32 Flags, UINT32 ProcessingStage, const XAUDIO2_VOICE_SENDS* pSendList, const XAUDIO2_EFFECT_CHAIN* pEffectChain)
+{
+	HRESULT hr;
+	if(ppSubmixVoice == NULL){
+		return E_INVALIDARG;
+	}
+	*ppSubmixVoice = NULL;
+	if(pMasteringVoice == NULL){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	if(pEffectChain != NULL || (InputSampleRate != XAUDIO2_DEFAULT_SAMPLERATE && InputSampleRate != getSampleRate())){
+		return E_NOTIMPL;
+	}
+	MixerBus* pOutput;
+	if(FAILED(hr = resolveSends(pSendList, &pOutput))){
+		return hr;
+	}
+
+	MixerBus* pBus;
+	if(FAILED(hr = mixer.createBus(InputChannels, ProcessingStage, &pBus))){
+		return hr;
+	}
+	if(FAILED(pBus->setOutput(pOutput))){
+		mixer.destroyBus(pBus);
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	OfflineSubmixVoice* pVoice = new OfflineSubmixVoice(this, Flags, pBus);
+	submixVoices.push_back(pVoice);
+	*ppSubmixVoice = pVoice;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT OfflineAudioEngine::CreateMasteringVoice(IXAudio2MasteringVoice** ppMasteringVoice,
+ * 		UINT32 InputChannels, UINT32 InputSampleRate, UINT32 Flags, UINT32 DeviceIndex,
+ * 		const XAUDIO2_EFFECT_CHAIN* pEffectChain)
+ *
+ * @brief	Makes the one mastering voice. Leaving the channels and rate at their defaults keeps the ones the
+ * 			engine was created with, anything else changes the output format.
+ *
+ * @date	10/17/2026
+ */
+HRESULT OfflineAudioEngine::CreateMasteringVoice(IXAudio2MasteringVoice** ppMasteringVoice, UINT32 InputChannels, UINT32 InputSampleRate, UINT32 Flags, UINT32 DeviceIndex, const XAUDIO2_EFFECT_CHAIN* pEffectChain)
+{
+	HRESULT hr;
+	if(ppMasteringVoice == NULL){
+		return E_INVALIDARG;
+	}
+	*ppMasteringVoice = NULL;
+	if(pMasteringVoice != NULL || DeviceIndex != 0){
+		return XAUDIO2_E_INVALID_CALL;
+	}
+	if(pEffectChain != NULL){
+		return E_NOTIMPL;
+	}
+	UINT32 channels = InputChannels == XAUDIO2_DEFAULT_CHANNELS ? getChannels() : InputChannels;
+	UINT32 sampleRate = InputSampleRate == XAUDIO2_DEFAULT_SAMPLERATE ? getSampleRate() : InputSampleRate;
+	if(FAILED(hr = mixer.init(sampleRate, channels))){
+		return hr;
+	}
+	pMasteringVoice = new OfflineMasteringVoice(this);
+	*ppMasteringVoice = pMasteringVoice;
+	return S_OK;
+}
+
+HRESULT OfflineAudioEngine::StartEngine()
+{
+	engineRunning = true;
+	return S_OK;
+}
+
+void OfflineAudioEngine::StopEngine()
+{
+	engineRunning = false;
+}
+
+void OfflineAudioEngine::GetPerformanceData(XAUDIO2_PERFORMANCE_DATA* pPerfData)
+{
+	memset(pPerfData, 0, sizeof(XAUDIO2_PERFORMANCE_DATA));
+	pPerfData->ActiveSourceVoiceCount = mixer.getActiveVoiceCount();
+	pPerfData->TotalSourceVoiceCount = mixer.getVoiceCount();
+	pPerfData->ActiveSubmixVoiceCount = (UINT32)submixVoices.size();
+}
+
+/**
+ * @fn	void OfflineAudioEngine::render(FLOAT32* pOut, UINT32 frames)
+ *
+ * @brief	Mixes the next frames of output. Engine and voice callbacks are made on the calling thread. While
+ * 			the engine is stopped the output is silence and no voice advances.
+ *
+ * @param [out]	pOut	frames * getChannels() interleaved floats.
+ * @param	frames  	Number of frames. Use getQuantumFrames() to get XAudio2's callback granularity.
+ *
+ * @date	10/17/2026
+ */
+void OfflineAudioEngine::render(FLOAT32* pOut, UINT32 frames)
+{
+	if(!engineRunning || pMasteringVoice == NULL){
+		memset(pOut, 0, frames * getChannels() * sizeof(FLOAT32));
+		return;
+	}
+	for(size_t i = 0; i < engineCallbacks.size(); ++i){
+		engineCallbacks[i]->OnProcessingPassStart();
+	}
+	mixer.render(pOut, frames);
+	for(size_t i = 0; i < engineCallbacks.size(); ++i){
+		engineCallbacks[i]->OnProcessingPassEnd();
+	}
+}
+
+void OfflineAudioEngine::removeSourceVoice(OfflineSourceVoice* pVoice)
+{
+	for(size_t i = 0; i < sourceVoices.size(); ++i){
+		if(sourceVoices[i] == pVoice){
+			sourceVoices.erase(sourceVoices.begin() + i);
+			return;
+		}
+	}
+}
+
+void OfflineAudioEngine::removeSubmixVoice(OfflineSubmixVoice* pVoice)
+{
+	for(size_t i = 0; i < submixVoices.size(); ++i){
+		if(submixVoices[i] == pVoice){
+			submixVoices.erase(submixVoices.begin() + i);
+			return;
+		}
+	}
+}
+
+/**
+// End of OfflineAudioEngine.cpp
+ */
@@ -0,0 +1,446 @@
+#include "PcmAssetCache.h"
+#include "AlignedAlloc.h"
+#include "AdpcmCodec.h"
+#include "SoundBank.h"
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <wctype.h>
+#include <vector>
+
+/**
+ * @fn	PcmAsset::PcmAsset(void)
+ *
+ * @brief	Constructor. Assets are made by create() or by PcmAssetCache::acquire(), never directly.
+ *
+ * @date	10/17/2026
+ */
+PcmAsset::PcmAsset(void) : refCount(1)
+{
+	pSamples = NULL;
+	convertedSize = 0;
+	memset(floatFormat, 0, sizeof(floatFormat));
+	sourceFormat = SAMPLE_FORMAT_UNSUPPORTED;
+	pBank = NULL;
+	pCache = NULL;
+}
+
+PcmAsset::~PcmAsset(void)
+{
+	if(pSamples != NULL)
+		alignedFree(pSamples);
+	closeFile();
+}
+
+/**
+ * @fn	void PcmAsset::closeFile()
+ *
+ * @brief	Drops the mapping, and the reference on the bank it came from if any.
+ *
+ * @date	10/17/2026
+ */
+void PcmAsset::closeFile()
+{
+	file.close();
+	if(pBank != NULL){
+		pBank->Release();
+		pBank = NULL;
+	}
+}
+
+/**
+ * @fn	HRESULT PcmAsset::create(const PATH_CHAR* szPath, PcmAsset** ppAsset)
+ *
+ * @brief	Loads an asset that is not shared through a cache.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szPath				 	Full path of the WAV file.
+ * @param [out]	ppAsset			 	Receives the asset with a reference count of one.
+ * @param	convertToEngineFormat	Convert integer PCM, and decode ADPCM, to 32 bit float now rather than play
+ * 									it as it is.
+ *
+ * @return	S_OK, the error from MappedWaveFile::open() or E_OUTOFMEMORY.
+ */
+HRESULT PcmAsset::create(const PATH_CHAR* szPath, PcmAsset** ppAsset, bool convertToEngineFormat)
+{
+	if(szPath == NULL || ppAsset == NULL)
+		return E_INVALIDARG;
+	*ppAsset = NULL;
+
+	PcmAsset* pAsset = new PcmAsset();
+	HRESULT hr = pAsset->file.open(szPath);
+	if(FAILED(hr)){
+		delete pAsset;
+		return hr;
+	}
+	pAsset->path = szPath;
+	hr = pAsset->prepare(convertToEngineFormat);
+	if(FAILED(hr)){
+		delete pAsset;
+		return hr;
+	}
+	*ppAsset = pAsset;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT PcmAsset::create(SoundBank* pBank, UINT32 index, PcmAsset** ppAsset, bool convertToEngineFormat)
+ *
+ * @brief	Makes an asset that is not shared through a cache from a sound in a bank. Nothing is opened or
+ * 			parsed: the format and data come straight from the bank's index and mapping.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pBank		 	The bank. The asset holds a reference on it while it uses the mapping.
+ * @param	index				 	Index of the sound, from SoundBank::find().
+ * @param [out]	ppAsset			 	Receives the asset with a reference count of one.
+ * @param	convertToEngineFormat	As for the file version.
+ *
+ * @return	S_OK, E_INVALIDARG for a bad index, or the error from converting the data.
+ */
+HRESULT PcmAsset::create(SoundBank* pBank, UINT32 index, PcmAsset** ppAsset, bool convertToEngineFormat)
+{
+	if(pBank == NULL || ppAsset == NULL || index >= pBank->getCount())
+		return E_INVALIDARG;
+	*ppAsset = NULL;
+
+	PcmAsset* pAsset = new PcmAsset();
+	HRESULT hr = pAsset->file.openData(pBank->getFormat(index), pBank->getData(index), pBank->getSize(index), pBank->getFactFrames(index));
+	if(FAILED(hr)){
+		delete pAsset;
+		return hr;
+	}
+	pAsset->pBank = pBank;
+	pBank->AddRef();
+	pAsset->path = PcmAssetCache::bankPath(pBank, index);
+	hr = pAsset->prepare(convertToEngineFormat);
+	if(FAILED(hr)){
+		delete pAsset;
+		return hr;
+	}
+	*ppAsset = pAsset;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT PcmAsset::prepare(bool convertToEngineFormat)
+ *
+ * @brief	Converts or decodes the open file to float if asked to and if it can, and closes it if so.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_OUTOFMEMORY.
+ */
+HRESULT PcmAsset::prepare(bool convertToEngineFormat)
+{
+	sourceFormat = getSampleFormat(file.getFormat());
+
+	SAMPLE_FORMAT format = sourceFormat;
+	AdpcmFormat adpcm;
+	if(convertToEngineFormat && SUCCEEDED(getAdpcmFormat(file.getFormat(), &adpcm))){
+		return decodeAdpcm(&adpcm);
+	}else if(convertToEngineFormat && format != SAMPLE_FORMAT_UNSUPPORTED && format != SAMPLE_FORMAT_F32){
+		const WAVEFORMATEX* pwfx = file.getFormat();
+		// whole frames only, a truncated last frame is dropped
+		UINT32 frames = file.getSize() / pwfx->nBlockAlign;
+		UINT32 count = frames * pwfx->nChannels;
+		pSamples = (FLOAT32*)alignedAlloc((count > 0 ? count : 1) * sizeof(FLOAT32), SIMD_ALIGNMENT);
+		if(pSamples == NULL)
+			return E_OUTOFMEMORY;
+		convertToFloat(format, file.getData(), pSamples, count);
+		convertedSize = count * sizeof(FLOAT32);
+		makeFloatFormat(pwfx, floatFormat);
+		closeFile();
+	}
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT PcmAsset::decodeAdpcm(const AdpcmFormat* pAdpcm)
+ *
+ * @brief	Decodes the mapped ADPCM data to 16 bit PCM and on to float, a run of blocks at a time through a
+ * 			small scratch buffer so the whole file never exists as 16 bit PCM. The padding that fills out the
+ * 			last block is dropped if the file's 'fact' chunk gives the true length. Closes the file afterwards.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_OUTOFMEMORY.
+ */
+HRESULT PcmAsset::decodeAdpcm(const AdpcmFormat* pAdpcm)
+{
+	const BYTE* pData = file.getData();
+	DWORD size = file.getSize();
+	UINT64 frames = getAdpcmFrames(pAdpcm, size);
+	if(file.getFactFrames() > 0 && file.getFactFrames() < frames)
+		frames = file.getFactFrames();
+	UINT32 count = (UINT32)(frames * pAdpcm->channels);
+	pSamples = (FLOAT32*)alignedAlloc((count > 0 ? count : 1) * sizeof(FLOAT32), SIMD_ALIGNMENT);
+	if(pSamples == NULL)
+		return E_OUTOFMEMORY;
+
+	const UINT32 blocksPerRun = 16;
+	vector<INT16> scratch((size_t)blocksPerRun * pAdpcm->samplesPerBlock * pAdpcm->channels);
+	MIX_KERNEL kernel = getBestMixKernel();
+	FLOAT32* pOut = pSamples;
+	UINT64 remaining = frames;
+	for(DWORD offset = 0; offset < size && remaining > 0; offset += blocksPerRun * pAdpcm->blockBytes){
+		UINT32 bytes = size - offset;
+		if(bytes > blocksPerRun * pAdpcm->blockBytes)
+			bytes = blocksPerRun * pAdpcm->blockBytes;
+		UINT32 decoded = ::decodeAdpcm(pAdpcm, pData + offset, bytes, &scratch[0], kernel);
+		if(decoded > remaining)
+			decoded = (UINT32)remaining;
+		convertToFloat(SAMPLE_FORMAT_S16, (const BYTE*)&scratch[0], pOut, decoded * pAdpcm->channels);
+		pOut += decoded * pAdpcm->channels;
+		remaining -= decoded;
+	}
+	convertedSize = count * sizeof(FLOAT32);
+
+	WAVEFORMATEX decodedFormat;
+	makeDecodedFormat(pAdpcm, &decodedFormat);
+	makeFloatFormat(&decodedFormat, floatFormat);
+	closeFile();
+	return S_OK;
+}
+
+ULONG PcmAsset::AddRef()
+{
+	return (ULONG)++refCount;
+}
+
+/**
+ * @fn	ULONG PcmAsset::Release()
+ *
+ * @brief	Drops a reference. The last release removes the asset from its cache and deletes it. A cached
+ * 			asset is counted down under the cache's lock (see PcmAssetCache::release()), so acquire() can't
+ * 			hand it out between the count reaching zero and the asset leaving the cache.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The new reference count.
+ */
+ULONG PcmAsset::Release()
+{
+	if(pCache != NULL)
+		return pCache->release(this);
+	LONG count = --refCount;
+	if(count == 0)
+		delete this;
+	return (ULONG)count;
+}
+
+/**
+ * @fn	PcmAssetCache::PcmAssetCache(void)
+ *
+ * @brief	Default constructor.
+ *
+ * @date	10/17/2026
+ */
+PcmAssetCache::PcmAssetCache(void)
+{
+	memset(&stats, 0, sizeof(stats));
+	convertToEngineFormat = true;
+}
+
+/**
+ * @fn	PcmAssetCache::~PcmAssetCache(void)
+ *
+ * @brief	Destructor. Any assets still referenced are detached and will delete themselves on their last
+ * 			release.
+ *
+ * @date	10/17/2026
+ */
+PcmAssetCache::~PcmAssetCache(void)
+{
+	lock_guard<mutex> l(lock);
+	for(ASSET_MAP::iterator it = assets.begin(); it != assets.end(); ++it){
+		if(it->second != NULL)
+			it->second->pCache = NULL;
+	}
+	assets.clear();
+}
+
+/**
+ * @fn	PATH_STRING PcmAssetCache::canonicalPath(const PATH_CHAR* szPath)
+ *
+ * @brief	Turns a path into the form used as the cache key, so that different spellings of the same file
+ * 			share an entry. On Windows this is the full path, lower case. Elsewhere symbolic links and
+ * 			relative components are resolved.
+ *
+ * @date	10/17/2026
+ */
+PATH_STRING PcmAssetCache::canonicalPath(const PATH_CHAR* szPath)
+{
+#ifdef _WIN32
+	WCHAR strFullPath[MAX_PATH];
+	if(GetFullPathNameW(szPath, MAX_PATH, strFullPath, NULL) == 0)
+		wcscpy_s(strFullPath, MAX_PATH, szPath);
+	PATH_STRING key(strFullPath);
+	for(size_t i = 0; i < key.length(); ++i){
+		key[i] = (key[i] == L'/') ? L'\\' : (wchar_t)towlower(key[i]);
+	}
+	return key;
+#else
+	char strFullPath[PATH_MAX];
+	if(realpath(szPath, strFullPath) == NULL)
+		return PATH_STRING(szPath);
+	return PATH_STRING(strFullPath);
+#endif
+}
+
+/**
+ * @fn	PATH_STRING PcmAssetCache::bankPath(SoundBank* pBank, UINT32 index)
+ *
+ * @brief	The path and cache key of a sound in a bank: the bank's path, '#' and the index.
+ *
+ * @date	10/17/2026
+ */
+PATH_STRING PcmAssetCache::bankPath(SoundBank* pBank, UINT32 index)
+{
+	PATH_STRING key = pBank->getPath();
+	string number = to_string(index);
+	key += (PATH_CHAR)'#';
+	key.append(number.begin(), number.end());
+	return key;
+}
+
+/**
+ * @fn	HRESULT PcmAssetCache::acquire(const PATH_CHAR* szPath, PcmAsset** ppAsset)
+ *
+ * @brief	Gets the shared asset for a file, loading it if this is the first request.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szPath		   	Path of the WAV file.
+ * @param [out]	ppAsset	Receives the asset. The caller owns one reference and must Release() it.
+ *
+ * @return	S_OK or the error from loading the file.
+ */
+HRESULT PcmAssetCache::acquire(const PATH_CHAR* szPath, PcmAsset** ppAsset)
+{
+	if(szPath == NULL || ppAsset == NULL)
+		return E_INVALIDARG;
+	*ppAsset = NULL;
+
+	return acquire(canonicalPath(szPath), NULL, 0, ppAsset);
+}
+
+/**
+ * @fn	HRESULT PcmAssetCache::acquire(SoundBank* pBank, UINT32 index, PcmAsset** ppAsset)
+ *
+ * @brief	Gets the shared asset for a sound in a bank, making it if this is the first request. Keyed by
+ * 			bankPath(), so it is never confused with a loose file of the same name.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pBank  	The bank.
+ * @param	index		   	Index of the sound, from SoundBank::find().
+ * @param [out]	ppAsset	Receives the asset. The caller owns one reference and must Release() it.
+ *
+ * @return	S_OK, E_INVALIDARG for a bad index, or the error from converting the data.
+ */
+HRESULT PcmAssetCache::acquire(SoundBank* pBank, UINT32 index, PcmAsset** ppAsset)
+{
+	if(pBank == NULL || ppAsset == NULL || index >= pBank->getCount())
+		return E_INVALIDARG;
+	*ppAsset = NULL;
+
+	return acquire(bankPath(pBank, index), pBank, index, ppAsset);
+}
+
+/**
+ * @fn	HRESULT PcmAssetCache::acquire(const PATH_STRING& key, SoundBank* pBank, UINT32 index, PcmAsset** ppAsset)
+ *
+ * @brief	Looks the key up, and on a miss makes the asset from the bank if there is one, else from the file
+ * 			the key names. The load runs without the lock, so loader threads read and convert different
+ * 			files at the same time; while it runs the key maps to NULL, and other requests for the same key
+ * 			wait for it rather than loading the file again. If it fails they try for themselves.
+ *
+ * @date	10/17/2026
+ */
+HRESULT PcmAssetCache::acquire(const PATH_STRING& key, SoundBank* pBank, UINT32 index, PcmAsset** ppAsset)
+{
+	unique_lock<mutex> l(lock);
+	for(;;){
+		ASSET_MAP::iterator got = assets.find(key);
+		if(got == assets.end())
+			break;
+		PcmAsset* pAsset = got->second;
+		if(pAsset != NULL){
+			pAsset->AddRef();
+			stats.hits++;
+			stats.bytesSaved += pAsset->getSize();
+			*ppAsset = pAsset;
+			return S_OK;
+		}
+		loaded.wait(l);
+	}
+	assets[key] = NULL;
+	bool convert = convertToEngineFormat;
+	l.unlock();
+
+	PcmAsset* pAsset;
+	HRESULT hr;
+	if(pBank != NULL)
+		hr = PcmAsset::create(pBank, index, &pAsset, convert);
+	else
+		hr = PcmAsset::create(key.c_str(), &pAsset, convert);
+
+	l.lock();
+	if(FAILED(hr)){
+		assets.erase(key);
+		loaded.notify_all();
+		return hr;
+	}
+	pAsset->pCache = this;
+	assets[key] = pAsset;
+	loaded.notify_all();
+	stats.misses++;
+	stats.bytesLoaded += pAsset->getSize();
+	stats.liveAssets++;
+	stats.residentBytes += pAsset->getSize();
+	*ppAsset = pAsset;
+	return S_OK;
+}
+
+/**
+ * @fn	ULONG PcmAssetCache::release(PcmAsset* pAsset)
+ *
+ * @brief	PcmAsset::Release() for an asset in this cache. The count is dropped under the lock that acquire()
+ * 			holds while it adds a reference, so once it reaches zero nothing can pick the asset up again, and
+ * 			the asset leaves the cache before the lock is let go. It is deleted after that: closing the
+ * 			mapping needn't hold up other threads.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The new reference count.
+ */
+ULONG PcmAssetCache::release(PcmAsset* pAsset)
+{
+	unique_lock<mutex> l(lock);
+	LONG count = --pAsset->refCount;
+	if(count != 0)
+		return (ULONG)count;
+
+	assets.erase(pAsset->path);
+	pAsset->pCache = NULL;
+	stats.liveAssets--;
+	stats.residentBytes -= pAsset->getSize();
+	l.unlock();
+	delete pAsset;
+	return 0;
+}
+
+/**
+ * @fn	void PcmAssetCache::getStats(PcmAssetCacheStats* stats)
+ *
+ * @brief	Copies out the hit, miss and memory counters.
+ *
+ * @date	10/17/2026
+ */
+void PcmAssetCache::getStats(PcmAssetCacheStats* stats)
+{
+	lock_guard<mutex> l(lock);
+	*stats = this->stats;
+}
@@ -0,0 +1,396 @@
+#include "Resampler.h"
+#include <math.h>
+#include <string.h>
+#include <mutex>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define RESAMPLER_PHASES		(1 << RESAMPLER_PHASE_BITS)
+#define RESAMPLER_FRACTION_ONE	4294967296.0 // 1.0 in 32.32 fixed point
+#define RESAMPLER_TABLE_COUNT	8
+
+// The step each table is designed for: its cutoff is 1 / step of the input Nyquist frequency
+static const double tableSteps[RESAMPLER_TABLE_COUNT] = {1.0, 1.125, 1.25, 1.5, 1.75, 2.0, 3.0, RESAMPLER_MAX_STEP};
+
+/**
+ * @fn	static double besselI0(double x)
+ *
+ * @brief	Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+ *
+ * @date	10/17/2026
+ */
+static double besselI0(double x)
+{
+	double sum = 1.0, term = 1.0, q = x * x / 4.0;
+	for(int k = 1; k < 50 && term > sum * 1e-12; ++k){
+		term *= q / ((double)k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+/**
+ * @fn	static void buildTable(FLOAT32* pTable, UINT32 taps, double cutoff, double beta)
+ *
+ * @brief	Fills one filter table: RESAMPLER_PHASES + 1 rows of taps coefficients, row p being the filter for
+ * 			an output time p / RESAMPLER_PHASES of the way from one input frame to the next. Each row is
+ * 			normalised to unity gain at DC.
+ *
+ * @date	10/17/2026
+ */
+static void buildTable(FLOAT32* pTable, UINT32 taps, double cutoff, double beta)
+{
+	double half = taps / 2.0;
+	double center = taps / 2 - 1;
+	double i0Beta = besselI0(beta);
+	for(UINT32 p = 0; p <= RESAMPLER_PHASES; ++p){
+		double frac = (double)p / RESAMPLER_PHASES;
+		double row[64];
+		double sum = 0.0;
+		for(UINT32 k = 0; k < taps; ++k){
+			double x = (double)k - center - frac; // distance of the tap from the output time, in input frames
+			double sinc;
+			if(x == 0.0){
+				sinc = 1.0;
+			}else if(cutoff == 1.0 && x == floor(x)){
+				sinc = 0.0; // exact zeros, so that phase 0 of the full band table is a pure delay
+			}else{
+				sinc = sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+			}
+			double r = x / half;
+			double window = (r * r < 1.0) ? besselI0(beta * sqrt(1.0 - r * r)) / i0Beta : 0.0;
+			row[k] = cutoff * sinc * window;
+			sum += row[k];
+		}
+		for(UINT32 k = 0; k < taps; ++k){
+			pTable[p * taps + k] = (FLOAT32)(row[k] / sum);
+		}
+	}
+}
+
+/**
+ * @fn	const FLOAT32* Resampler::getTable(RESAMPLER_QUALITY quality, UINT32 tableIndex)
+ *
+ * @brief	Gets one of the shared filter tables, building all the tables for the quality on first use.
+ *
+ * @date	10/17/2026
+ */
+const FLOAT32* Resampler::getTable(RESAMPLER_QUALITY quality, UINT32 tableIndex)
+{
+	static mutex buildLock;
+	static vector<FLOAT32> tables[RESAMPLER_QUALITY_SINC32 + 1];
+
+	lock_guard<mutex> guard(buildLock);
+	vector<FLOAT32>& t = tables[quality];
+	if(t.empty()){
+		UINT32 taps = (quality == RESAMPLER_QUALITY_SINC32) ? 32 : 8;
+		double beta = (quality == RESAMPLER_QUALITY_SINC32) ? 9.0 : 6.0;
+		UINT32 tableSize = (RESAMPLER_PHASES + 1) * taps;
+		t.resize(tableSize * RESAMPLER_TABLE_COUNT);
+		for(UINT32 i = 0; i < RESAMPLER_TABLE_COUNT; ++i){
+			buildTable(&t[i * tableSize], taps, 1.0 / tableSteps[i], beta);
+		}
+	}
+	return &t[tableIndex * (RESAMPLER_PHASES + 1) * ((quality == RESAMPLER_QUALITY_SINC32) ? 32 : 8)];
+}
+
+/**
+ * @fn	UINT32 Resampler::getTableIndex(double step)
+ *
+ * @brief	The table with the widest band that still keeps aliasing out at this step.
+ *
+ * @date	10/17/2026
+ */
+UINT32 Resampler::getTableIndex(double step)
+{
+	for(UINT32 i = 0; i < RESAMPLER_TABLE_COUNT; ++i){
+		if(step <= tableSteps[i] + 1e-9){
+			return i;
+		}
+	}
+	return RESAMPLER_TABLE_COUNT - 1;
+}
+
+/**
+ * @fn	Resampler::Resampler(void)
+ *
+ * @brief	Default constructor. The resampler is unusable until init() has been called.
+ *
+ * @date	10/17/2026
+ */
+Resampler::Resampler(void)
+{
+	channels = 0;
+	quality = RESAMPLER_QUALITY_LINEAR;
+	taps = 2;
+	history = 0;
+	pKernels = getMixKernels(getBestMixKernel());
+	pTables = NULL;
+	capacity = 0;
+	filled = 0;
+	position = 0;
+	draining = false;
+	drainEnd = 0;
+}
+
+Resampler::~Resampler(void)
+{
+}
+
+/**
+ * @fn	HRESULT Resampler::init(UINT32 channels, RESAMPLER_QUALITY quality)
+ *
+ * @brief	Sets the channel count and filter length, and resets.
+ *
+ * @param	channels	Interleaved channels pushed and pulled.
+ * @param	quality 	Filter length.
+ *
+ * @return	S_OK or E_INVALIDARG.
+ *
+ * @date	10/17/2026
+ */
+HRESULT Resampler::init(UINT32 channels, RESAMPLER_QUALITY quality)
+{
+	if(channels == 0 || quality > RESAMPLER_QUALITY_SINC32){
+		return E_INVALIDARG;
+	}
+	this->channels = channels;
+	this->quality = quality;
+	taps = (quality == RESAMPLER_QUALITY_SINC32) ? 32 : (quality == RESAMPLER_QUALITY_SINC8) ? 8 : 2;
+	history = taps / 2 - 1;
+	coefs.resize(taps);
+	// built now rather than on the audio thread
+	pTables = (quality == RESAMPLER_QUALITY_LINEAR) ? NULL : getTable(quality, 0);
+	capacity = 0;
+	buffer.clear();
+	reserve(1024);
+	reset();
+	return S_OK;
+}
+
+/**
+ * @fn	void Resampler::reset()
+ *
+ * @brief	Forgets all input. The next frame pushed is played at the next frame pulled.
+ *
+ * @date	10/17/2026
+ */
+void Resampler::reset()
+{
+	// the filter reaches back history frames from the first frame, which are silence
+	for(UINT32 c = 0; c < channels; ++c){
+		memset(&buffer[c * capacity], 0, history * sizeof(FLOAT32));
+	}
+	filled = history;
+	position = (UINT64)history << 32;
+	draining = false;
+	drainEnd = 0;
+}
+
+bool Resampler::setKernel(MIX_KERNEL kernel)
+{
+	const MixKernels* pNew = getMixKernels(kernel);
+	if(pNew == NULL){
+		return false;
+	}
+	pKernels = pNew;
+	return true;
+}
+
+/**
+ * @fn	void Resampler::compact()
+ *
+ * @brief	Moves the frames still needed to the front of the buffer.
+ *
+ * @date	10/17/2026
+ */
+void Resampler::compact()
+{
+	UINT32 first = (UINT32)(position >> 32);
+	first = (first > history) ? first - history : 0;
+	if(first > filled){
+		first = filled;
+	}
+	if(first == 0){
+		return;
+	}
+	for(UINT32 c = 0; c < channels; ++c){
+		FLOAT32* p = &buffer[c * capacity];
+		memmove(p, p + first, (filled - first) * sizeof(FLOAT32));
+	}
+	filled -= first;
+	position -= (UINT64)first << 32;
+	if(draining){
+		drainEnd -= first;
+	}
+}
+
+void Resampler::reserve(UINT32 frames)
+{
+	if(frames <= capacity){
+		return;
+	}
+	UINT32 newCapacity = capacity ? capacity : 1024;
+	while(newCapacity < frames){
+		newCapacity *= 2;
+	}
+	vector<FLOAT32> grown(newCapacity * channels, 0.0f);
+	for(UINT32 c = 0; c < channels; ++c){
+		if(filled > 0){
+			memcpy(&grown[c * newCapacity], &buffer[c * capacity], filled * sizeof(FLOAT32));
+		}
+	}
+	buffer.swap(grown);
+	capacity = newCapacity;
+}
+
+/**
+ * @fn	UINT32 Resampler::getInputNeeded(UINT32 outFrames, double startStep, double endStep)
+ *
+ * @brief	How many more input frames pull() needs to produce outFrames with this step ramp.
+ *
+ * @date	10/17/2026
+ */
+UINT32 Resampler::getInputNeeded(UINT32 outFrames, double startStep, double endStep)
+{
+	if(outFrames == 0){
+		return 0;
+	}
+	// position of the last output frame: the steps before it ramp linearly from startStep
+	double advance = (outFrames - 1) * startStep + (endStep - startStep) * (outFrames - 1) * (outFrames - 2) / (2.0 * outFrames);
+	double last = position / RESAMPLER_FRACTION_ONE + advance;
+	INT64 needed = (INT64)last + taps / 2 + 2 - filled; // one spare frame for rounding in the ramp
+	return needed > 0 ? (UINT32)needed : 0;
+}
+
+/**
+ * @fn	void Resampler::push(const FLOAT32* pIn, UINT32 frames)
+ *
+ * @brief	Appends interleaved input. If the previous stream is still draining, the new input follows on from
+ * 			it without a gap.
+ *
+ * @date	10/17/2026
+ */
+void Resampler::push(const FLOAT32* pIn, UINT32 frames)
+{
+	if(frames == 0){
+		return;
+	}
+	if(draining){
+		filled = drainEnd; // drop the silence endOfStream() added
+		draining = false;
+	}
+	if(filled + frames > capacity){
+		compact();
+		reserve(filled + frames);
+	}
+	for(UINT32 c = 0; c < channels; ++c){
+		FLOAT32* p = &buffer[c * capacity + filled];
+		for(UINT32 i = 0; i < frames; ++i){
+			p[i] = pIn[i * channels + c];
+		}
+	}
+	filled += frames;
+}
+
+/**
+ * @fn	void Resampler::endOfStream()
+ *
+ * @brief	Says that no more input is coming for now, so the last frames can be played out without waiting for
+ * 			the frames after them. Once they have been pulled the resampler resets itself.
+ *
+ * @date	10/17/2026
+ */
+void Resampler::endOfStream()
+{
+	if(draining){
+		return;
+	}
+	UINT32 pad = taps / 2;
+	if(filled + pad > capacity){
+		compact();
+		reserve(filled + pad);
+	}
+	for(UINT32 c = 0; c < channels; ++c){
+		memset(&buffer[c * capacity + filled], 0, pad * sizeof(FLOAT32));
+	}
+	drainEnd = filled;
+	filled += pad;
+	draining = true;
+}
+
+/**
+ * @fn	UINT32 Resampler::pull(FLOAT32* pOut, UINT32 outFrames, double startStep, double endStep)
+ *
+ * @brief	Produces up to outFrames interleaved frames. The step goes linearly from startStep for the first
+ * 			frame towards endStep, so passing the previous block's endStep as the next block's startStep gives
+ * 			a continuous ramp.
+ *
+ * @param [out]	pOut	outFrames * channels floats.
+ * @param	outFrames	Frames wanted.
+ * @param	startStep	Input frames per output frame at the start of the block.
+ * @param	endStep  	Input frames per output frame at the end of the block.
+ *
+ * @return	Frames produced: fewer than outFrames if the input ran out, or the end of the stream was reached.
+ *
+ * @date	10/17/2026
+ */
+UINT32 Resampler::pull(FLOAT32* pOut, UINT32 outFrames, double startStep, double endStep)
+{
+	if(outFrames == 0){
+		return 0;
+	}
+	INT64 step = (INT64)(startStep * RESAMPLER_FRACTION_ONE + 0.5);
+	INT64 stepDelta = (INT64)((endStep - startStep) * RESAMPLER_FRACTION_ONE / outFrames);
+	UINT32 tableIndex = getTableIndex(startStep > endStep ? startStep : endStep);
+	const FLOAT32* pTable = (pTables == NULL) ? NULL : pTables + tableIndex * (RESAMPLER_PHASES + 1) * taps;
+	UINT32 lookahead = taps / 2;
+	UINT32 produced = 0;
+
+	while(produced < outFrames){
+		UINT32 i = (UINT32)(position >> 32);
+		if(draining && i >= drainEnd){
+			reset();
+			break;
+		}
+		if(i + lookahead >= filled){
+			break;
+		}
+		UINT32 frac = (UINT32)position;
+		FLOAT32* pFrame = pOut + produced * channels;
+
+		if(frac == 0 && tableIndex == 0){
+			for(UINT32 c = 0; c < channels; ++c){
+				pFrame[c] = buffer[c * capacity + i];
+			}
+		}else if(pTable == NULL){
+			FLOAT32 t = (FLOAT32)(frac * (1.0 / RESAMPLER_FRACTION_ONE));
+			for(UINT32 c = 0; c < channels; ++c){
+				const FLOAT32* p = &buffer[c * capacity + i];
+				pFrame[c] = p[0] + (p[1] - p[0]) * t;
+			}
+		}else{
+			UINT32 phase = frac >> (32 - RESAMPLER_PHASE_BITS);
+			FLOAT32 t = (FLOAT32)((frac & ((1u << (32 - RESAMPLER_PHASE_BITS)) - 1)) * (1.0 / (1u << (32 - RESAMPLER_PHASE_BITS))));
+			const FLOAT32* pRow = pTable + phase * taps;
+			pKernels->lerp(pRow, pRow + taps, t, &coefs[0], taps);
+			for(UINT32 c = 0; c < channels; ++c){
+				pFrame[c] = pKernels->dot(&buffer[c * capacity + i - history], &coefs[0], taps);
+			}
+		}
+
+		++produced;
+		position += (UINT64)step;
+		step += stepDelta;
+		if(step < 0){
+			step = 0;
+		}
+	}
+	return produced;
+}
+
+/**
+// End of Resampler.cpp
+ */
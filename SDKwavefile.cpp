@@ -37,6 +37,7 @@ CWaveFile::CWaveFile()
     m_hmmio = NULL;
     m_pResourceBuffer = NULL;
     m_dwSize = 0;
+    m_dwFlags = 0;
     m_bIsReadingFromMemory = FALSE;
 }
 
@@ -125,20 +126,10 @@ HRESULT CWaveFile::Open( LPWSTR strFileName, WAVEFORMATEX* pwfx, DWORD dwFlags )
     }
     else
     {
-        m_hmmio = mmioOpen( strFileName, NULL, MMIO_ALLOCBUF |
-                            MMIO_READWRITE |
-                            MMIO_CREATE );
-        if( NULL == m_hmmio )
-            return DXTRACE_ERR( L"mmioOpen", E_FAIL );
-
-        if( FAILED( hr = WriteMMIO( pwfx ) ) )
-        {
-            mmioClose( m_hmmio, 0 );
-            return DXTRACE_ERR( L"WriteMMIO", hr );
-        }
-
-        if( FAILED( hr = ResetFile() ) )
-            return DXTRACE_ERR( L"ResetFile", hr );
+        // The header is written with placeholder sizes that Close() fills in
+        if( FAILED( hr = m_writer.open( strFileName, pwfx,
+                                        ( m_dwFlags & WAVEFILE_BACKGROUND_FLUSH ) != 0 ) ) )
+            return DXTRACE_ERR( L"WaveFileWriter::open", hr );
     }
 
     return hr;
@@ -273,33 +264,22 @@ HRESULT CWaveFile::ResetFile()
     }
     else
     {
+        // Written files are append only
+        if( m_dwFlags != WAVEFILE_READ )
+            return E_NOTIMPL;
+
         if( m_hmmio == NULL )
             return CO_E_NOTINITIALIZED;
 
-        if( m_dwFlags == WAVEFILE_READ )
-        {
-            // Seek to the data
-            if( -1 == mmioSeek( m_hmmio, m_ckRiff.dwDataOffset + sizeof( FOURCC ),
-                                SEEK_SET ) )
-                return DXTRACE_ERR( L"mmioSeek", E_FAIL );
-
-            // Search the input file for the 'data' chunk.
-            m_ck.ckid = mmioFOURCC( 'd', 'a', 't', 'a' );
-            if( 0 != mmioDescend( m_hmmio, &m_ck, &m_ckRiff, MMIO_FINDCHUNK ) )
-                return DXTRACE_ERR( L"mmioDescend", E_FAIL );
-        }
-        else
-        {
-            // Create the 'data' chunk that holds the waveform samples.
-            m_ck.ckid = mmioFOURCC( 'd', 'a', 't', 'a' );
-            m_ck.cksize = 0;
+        // Seek to the data
+        if( -1 == mmioSeek( m_hmmio, m_ckRiff.dwDataOffset + sizeof( FOURCC ),
+                            SEEK_SET ) )
+            return DXTRACE_ERR( L"mmioSeek", E_FAIL );
 
-            if( 0 != mmioCreateChunk( m_hmmio, &m_ck, 0 ) )
-                return DXTRACE_ERR( L"mmioCreateChunk", E_FAIL );
-
-            if( 0 != mmioGetInfo( m_hmmio, &m_mmioinfoOut, 0 ) )
-                return DXTRACE_ERR( L"mmioGetInfo", E_FAIL );
-        }
+        // Search the input file for the 'data' chunk.
+        m_ck.ckid = mmioFOURCC( 'd', 'a', 't', 'a' );
+        if( 0 != mmioDescend( m_hmmio, &m_ck, &m_ckRiff, MMIO_FINDCHUNK ) )
+            return DXTRACE_ERR( L"mmioDescend", E_FAIL );
     }
 
     return S_OK;
@@ -360,9 +340,10 @@ HRESULT CWaveFile::Read( BYTE* pBuffer, DWORD dwSizeToRead, DWORD* pdwSizeRead )
 
         m_ck.cksize -= cbDataIn;
 
-        for( DWORD cT = 0; cT < cbDataIn; cT++ )
+        DWORD cbCopied = 0;
+        while( cbCopied < cbDataIn )
         {
-            // Copy the bytes from the io to the buffer.
+            // Refill the io buffer when it runs dry.
             if( mmioinfoIn.pchNext == mmioinfoIn.pchEndRead )
             {
                 if( 0 != mmioAdvance( m_hmmio, &mmioinfoIn, MMIO_READ ) )
@@ -372,9 +353,12 @@ HRESULT CWaveFile::Read( BYTE* pBuffer, DWORD dwSizeToRead, DWORD* pdwSizeRead )
                     return DXTRACE_ERR( L"mmioinfoIn.pchNext", E_FAIL );
             }
 
-            // Actual copy.
-            *( ( BYTE* )pBuffer + cT ) = *( ( BYTE* )mmioinfoIn.pchNext );
-            mmioinfoIn.pchNext++;
+            // Copy as much as the io buffer holds in one go.
+            DWORD cbChunk = ( DWORD )( mmioinfoIn.pchEndRead - mmioinfoIn.pchNext );
+            cbChunk = __min( cbChunk, cbDataIn - cbCopied );
+            memcpy( pBuffer + cbCopied, mmioinfoIn.pchNext, cbChunk );
+            mmioinfoIn.pchNext += cbChunk;
+            cbCopied += cbChunk;
         }
 
         if( 0 != mmioSetInfo( m_hmmio, &mmioinfoIn, 0 ) )
@@ -393,6 +377,8 @@ HRESULT CWaveFile::Read( BYTE* pBuffer, DWORD dwSizeToRead, DWORD* pdwSizeRead )
 //-----------------------------------------------------------------------------
 HRESULT CWaveFile::Close()
 {
+    HRESULT hr;
+
     if( m_dwFlags == WAVEFILE_READ )
     {
         if ( m_hmmio != NULL )
@@ -404,154 +390,32 @@ HRESULT CWaveFile::Close()
     }
     else
     {
-        m_mmioinfoOut.dwFlags |= MMIO_DIRTY;
-
-        if( m_hmmio == NULL )
-            return CO_E_NOTINITIALIZED;
-
-        if( 0 != mmioSetInfo( m_hmmio, &m_mmioinfoOut, 0 ) )
-            return DXTRACE_ERR( L"mmioSetInfo", E_FAIL );
-
-        // Ascend the output file out of the 'data' chunk -- this will cause
-        // the chunk size of the 'data' chunk to be written.
-        if( 0 != mmioAscend( m_hmmio, &m_ck, 0 ) )
-            return DXTRACE_ERR( L"mmioAscend", E_FAIL );
-
-        // Do this here instead...
-        if( 0 != mmioAscend( m_hmmio, &m_ckRiff, 0 ) )
-            return DXTRACE_ERR( L"mmioAscend", E_FAIL );
-
-        mmioSeek( m_hmmio, 0, SEEK_SET );
-
-        if( 0 != ( INT )mmioDescend( m_hmmio, &m_ckRiff, NULL, 0 ) )
-            return DXTRACE_ERR( L"mmioDescend", E_FAIL );
-
-        m_ck.ckid = mmioFOURCC( 'f', 'a', 'c', 't' );
-
-        if( 0 == mmioDescend( m_hmmio, &m_ck, &m_ckRiff, MMIO_FINDCHUNK ) )
-        {
-            DWORD dwSamples = 0;
-            mmioWrite( m_hmmio, ( HPSTR )&dwSamples, sizeof( DWORD ) );
-            mmioAscend( m_hmmio, &m_ck, 0 );
-        }
-
-        // Ascend the output file out of the 'RIFF' chunk -- this will cause
-        // the chunk size of the 'RIFF' chunk to be written.
-        if( 0 != mmioAscend( m_hmmio, &m_ckRiff, 0 ) )
-            return DXTRACE_ERR( L"mmioAscend", E_FAIL );
-
-        mmioClose( m_hmmio, 0 );
-        m_hmmio = NULL;
+        // Flushes what is staged and fixes up the RIFF, 'fact' and 'data' sizes
+        if( FAILED( hr = m_writer.close() ) )
+            return DXTRACE_ERR( L"WaveFileWriter::close", hr );
     }
 
     return S_OK;
 }
 
 
-//-----------------------------------------------------------------------------
-// Name: CWaveFile::WriteMMIO()
-// Desc: Support function for reading from a multimedia I/O stream
-//       pwfxDest is the WAVEFORMATEX for this new wave file.
-//       m_hmmio must be valid before calling.  This function uses it to
-//       update m_ckRiff, and m_ck.
-//-----------------------------------------------------------------------------
-HRESULT CWaveFile::WriteMMIO( WAVEFORMATEX* pwfxDest )
-{
-    DWORD dwFactChunk; // Contains the actual fact chunk. Garbage until WaveCloseWriteFile.
-    MMCKINFO ckOut1;
-
-    memset( &ckOut1, 0, sizeof(ckOut1) );
-
-    dwFactChunk = ( DWORD )-1;
-
-    // Create the output file RIFF chunk of form type 'WAVE'.
-    m_ckRiff.fccType = mmioFOURCC( 'W', 'A', 'V', 'E' );
-    m_ckRiff.cksize = 0;
-
-    if( 0 != mmioCreateChunk( m_hmmio, &m_ckRiff, MMIO_CREATERIFF ) )
-        return DXTRACE_ERR( L"mmioCreateChunk", E_FAIL );
-
-    // We are now descended into the 'RIFF' chunk we just created.
-    // Now create the 'fmt ' chunk. Since we know the size of this chunk,
-    // specify it in the MMCKINFO structure so MMIO doesn't have to seek
-    // back and set the chunk size after ascending from the chunk.
-    m_ck.ckid = mmioFOURCC( 'f', 'm', 't', ' ' );
-    m_ck.cksize = sizeof( PCMWAVEFORMAT );
-
-    if( 0 != mmioCreateChunk( m_hmmio, &m_ck, 0 ) )
-        return DXTRACE_ERR( L"mmioCreateChunk", E_FAIL );
-
-    // Write the PCMWAVEFORMAT structure to the 'fmt ' chunk if its that type.
-    if( pwfxDest->wFormatTag == WAVE_FORMAT_PCM )
-    {
-        if( mmioWrite( m_hmmio, ( HPSTR )pwfxDest,
-                       sizeof( PCMWAVEFORMAT ) ) != sizeof( PCMWAVEFORMAT ) )
-            return DXTRACE_ERR( L"mmioWrite", E_FAIL );
-    }
-    else
-    {
-        // Write the variable length size.
-        if( ( UINT )mmioWrite( m_hmmio, ( HPSTR )pwfxDest,
-                               sizeof( *pwfxDest ) + pwfxDest->cbSize ) !=
-            ( sizeof( *pwfxDest ) + pwfxDest->cbSize ) )
-            return DXTRACE_ERR( L"mmioWrite", E_FAIL );
-    }
-
-    // Ascend out of the 'fmt ' chunk, back into the 'RIFF' chunk.
-    if( 0 != mmioAscend( m_hmmio, &m_ck, 0 ) )
-        return DXTRACE_ERR( L"mmioAscend", E_FAIL );
-
-    // Now create the fact chunk, not required for PCM but nice to have.  This is filled
-    // in when the close routine is called.
-    ckOut1.ckid = mmioFOURCC( 'f', 'a', 'c', 't' );
-    ckOut1.cksize = 0;
-
-    if( 0 != mmioCreateChunk( m_hmmio, &ckOut1, 0 ) )
-        return DXTRACE_ERR( L"mmioCreateChunk", E_FAIL );
-
-    if( mmioWrite( m_hmmio, ( HPSTR )&dwFactChunk, sizeof( dwFactChunk ) ) !=
-        sizeof( dwFactChunk ) )
-        return DXTRACE_ERR( L"mmioWrite", E_FAIL );
-
-    // Now ascend out of the fact chunk...
-    if( 0 != mmioAscend( m_hmmio, &ckOut1, 0 ) )
-        return DXTRACE_ERR( L"mmioAscend", E_FAIL );
-
-    return S_OK;
-}
-
-
 //-----------------------------------------------------------------------------
 // Name: CWaveFile::Write()
-// Desc: Writes data to the open wave file
+// Desc: Writes data to the open wave file. The data is copied in blocks into
+//       the writer's staging buffer, which goes to disk when it fills.
 //-----------------------------------------------------------------------------
 HRESULT CWaveFile::Write( UINT nSizeToWrite, BYTE* pbSrcData, UINT* pnSizeWrote )
 {
-    UINT cT;
-
     if( m_bIsReadingFromMemory )
         return E_NOTIMPL;
-    if( m_hmmio == NULL )
+    if( !m_writer.isOpen() )
         return CO_E_NOTINITIALIZED;
     if( pnSizeWrote == NULL || pbSrcData == NULL )
         return E_INVALIDARG;
 
-    *pnSizeWrote = 0;
+    UINT32 cbWrote = 0;
+    HRESULT hr = m_writer.write( pbSrcData, nSizeToWrite, &cbWrote );
+    *pnSizeWrote = cbWrote;
 
-    for( cT = 0; cT < nSizeToWrite; cT++ )
-    {
-        if( m_mmioinfoOut.pchNext == m_mmioinfoOut.pchEndWrite )
-        {
-            m_mmioinfoOut.dwFlags |= MMIO_DIRTY;
-            if( 0 != mmioAdvance( m_hmmio, &m_mmioinfoOut, MMIO_WRITE ) )
-                return DXTRACE_ERR( L"mmioAdvance", E_FAIL );
-        }
-
-        *( ( BYTE* )m_mmioinfoOut.pchNext ) = *( ( BYTE* )pbSrcData + cT );
-        ( BYTE* )m_mmioinfoOut.pchNext++;
-
-        ( *pnSizeWrote )++;
-    }
-
-    return S_OK;
+    return hr;
 }
@@ -0,0 +1,514 @@
+#include "SampleConvert.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONVERT_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// As in MixKernels.cpp: AVX2 code is compiled whatever the build target and only used once
+// isMixKernelAvailable() has checked the CPU
+#if defined(CONVERT_HAS_SSE2) && defined(_MSC_VER) && _MSC_VER >= 1800
+#define CONVERT_HAS_AVX2 1
+#define CONVERT_TARGET_AVX2
+#include <immintrin.h>
+#elif defined(CONVERT_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CONVERT_HAS_AVX2 1
+#define CONVERT_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+// Full scale of each integer format. Powers of two, so the scaling is exact both ways
+static const FLOAT32 U8_SCALE = 128.0f;
+static const FLOAT32 S16_SCALE = 32768.0f;
+static const FLOAT32 S24_SCALE = 8388608.0f;
+
+/**
+ * @fn	static void fromU8Scalar(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+ *
+ * @brief	Reference implementations. Multi-byte samples are read and written a byte at a time (little
+ * 			endian), since a 'data' chunk only has to start on an even offset.
+ *
+ * @date	10/17/2026
+ */
+static void fromU8Scalar(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		pOut[i] = (FLOAT32)((INT32)pIn[i] - 128) * (1.0f / U8_SCALE);
+	}
+}
+
+static void fromS16Scalar(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		INT16 s = (INT16)(pIn[2 * i] | (pIn[2 * i + 1] << 8));
+		pOut[i] = (FLOAT32)s * (1.0f / S16_SCALE);
+	}
+}
+
+static void fromS24Scalar(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		const BYTE* p = pIn + 3 * i;
+		// build the sample in the top three bytes and shift down to sign extend it
+		INT32 s = (INT32)(((UINT32)p[0] << 8) | ((UINT32)p[1] << 16) | ((UINT32)p[2] << 24)) >> 8;
+		pOut[i] = (FLOAT32)s * (1.0f / S24_SCALE);
+	}
+}
+
+static void toU8Scalar(const FLOAT32* pIn, BYTE* pOut, UINT32 count)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		FLOAT32 s = pIn[i] * U8_SCALE;
+		if(s != s){
+			s = 0.0f;   // NaN: silence, as the vector versions give
+		}else if(s > 127.0f){
+			s = 127.0f;
+		}else if(s < -128.0f){
+			s = -128.0f;
+		}
+		pOut[i] = (BYTE)(lrintf(s) + 128);
+	}
+}
+
+static void toS24Scalar(const FLOAT32* pIn, BYTE* pOut, UINT32 count)
+{
+	for(UINT32 i = 0; i < count; ++i){
+		FLOAT32 s = pIn[i] * S24_SCALE;
+		if(s != s){
+			s = 0.0f;
+		}else if(s > 8388607.0f){
+			s = 8388607.0f;
+		}else if(s < -8388608.0f){
+			s = -8388608.0f;
+		}
+		INT32 v = (INT32)lrintf(s);
+		BYTE* p = pOut + 3 * i;
+		p[0] = (BYTE)v;
+		p[1] = (BYTE)(v >> 8);
+		p[2] = (BYTE)(v >> 16);
+	}
+}
+
+#ifdef CONVERT_HAS_SSE2
+
+/**
+ * @fn	static void fromU8SSE2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+ *
+ * @brief	SSE2 versions. Integers are widened to 32 bits, converted (exactly) and scaled by the same power of
+ * 			two as the scalar code. SSE2 has no byte shuffle, so 24 bit samples are gathered with four 32 bit
+ * 			loads, one per sample, then shifted into place.
+ *
+ * @date	10/17/2026
+ */
+static void fromU8SSE2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	__m128 scale = _mm_set1_ps(1.0f / U8_SCALE);
+	__m128i bias = _mm_set1_epi32(128);
+	__m128i zero = _mm_setzero_si128();
+	UINT32 i = 0;
+	for(; i + 16 <= count; i += 16){
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(pIn + i));
+		__m128i lo = _mm_unpacklo_epi8(bytes, zero);
+		__m128i hi = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_ps(pOut + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpacklo_epi16(lo, zero), bias)), scale));
+		_mm_storeu_ps(pOut + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpackhi_epi16(lo, zero), bias)), scale));
+		_mm_storeu_ps(pOut + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpacklo_epi16(hi, zero), bias)), scale));
+		_mm_storeu_ps(pOut + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpackhi_epi16(hi, zero), bias)), scale));
+	}
+	fromU8Scalar(pIn + i, pOut + i, count - i);
+}
+
+static void fromS16SSE2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	__m128 scale = _mm_set1_ps(1.0f / S16_SCALE);
+	UINT32 i = 0;
+	for(; i + 8 <= count; i += 8){
+		__m128i s = _mm_loadu_si128((const __m128i*)(pIn + 2 * i));
+		// put each sample in the top half of a 32 bit lane and shift down to sign extend
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+		_mm_storeu_ps(pOut + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(pOut + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+	fromS16Scalar(pIn + 2 * i, pOut + i, count - i);
+}
+
+static inline INT32 load32(const BYTE* p)
+{
+	INT32 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static void fromS24SSE2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	__m128 scale = _mm_set1_ps(1.0f / S24_SCALE);
+	UINT32 i = 0;
+	// each load takes one byte past its sample, so stop while the last one is still inside the buffer
+	for(; i + 5 <= count; i += 4){
+		const BYTE* p = pIn + 3 * i;
+		__m128i v = _mm_set_epi32(load32(p + 9), load32(p + 6), load32(p + 3), load32(p));
+		v = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+		_mm_storeu_ps(pOut + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+	}
+	fromS24Scalar(pIn + 3 * i, pOut + i, count - i);
+}
+
+/**
+ * @fn	static inline __m128 scaleAndClamp(__m128 x, __m128 scale, __m128 lo, __m128 hi)
+ *
+ * @brief	Scales four samples and clamps them to [lo, hi], ready for _mm_cvtps_epi32(). NaNs are zeroed
+ * 			first: maxps would turn them into lo, a full scale click, where the scalar code gives silence.
+ *
+ * @date	10/17/2026
+ */
+static inline __m128 scaleAndClamp(__m128 x, __m128 scale, __m128 lo, __m128 hi)
+{
+	x = _mm_and_ps(x, _mm_cmpord_ps(x, x));
+	return _mm_min_ps(_mm_max_ps(_mm_mul_ps(x, scale), lo), hi);
+}
+
+static void toU8SSE2(const FLOAT32* pIn, BYTE* pOut, UINT32 count)
+{
+	__m128 scale = _mm_set1_ps(U8_SCALE);
+	__m128 lo = _mm_set1_ps(-128.0f);
+	__m128 hi = _mm_set1_ps(127.0f);
+	__m128i bias = _mm_set1_epi16(128);
+	UINT32 i = 0;
+	for(; i + 16 <= count; i += 16){
+		__m128i a = _mm_cvtps_epi32(scaleAndClamp(_mm_loadu_ps(pIn + i), scale, lo, hi));
+		__m128i b = _mm_cvtps_epi32(scaleAndClamp(_mm_loadu_ps(pIn + i + 4), scale, lo, hi));
+		__m128i c = _mm_cvtps_epi32(scaleAndClamp(_mm_loadu_ps(pIn + i + 8), scale, lo, hi));
+		__m128i d = _mm_cvtps_epi32(scaleAndClamp(_mm_loadu_ps(pIn + i + 12), scale, lo, hi));
+		__m128i ab = _mm_add_epi16(_mm_packs_epi32(a, b), bias);
+		__m128i cd = _mm_add_epi16(_mm_packs_epi32(c, d), bias);
+		_mm_storeu_si128((__m128i*)(pOut + i), _mm_packus_epi16(ab, cd));
+	}
+	toU8Scalar(pIn + i, pOut + i, count - i);
+}
+
+static void toS24SSE2(const FLOAT32* pIn, BYTE* pOut, UINT32 count)
+{
+	__m128 scale = _mm_set1_ps(S24_SCALE);
+	__m128 lo = _mm_set1_ps(-8388608.0f);
+	__m128 hi = _mm_set1_ps(8388607.0f);
+	UINT32 i = 0;
+	for(; i + 4 <= count; i += 4){
+		INT32 v[4];
+		_mm_storeu_si128((__m128i*)v, _mm_cvtps_epi32(scaleAndClamp(_mm_loadu_ps(pIn + i), scale, lo, hi)));
+		BYTE* p = pOut + 3 * i;
+		for(UINT32 j = 0; j < 4; ++j){
+			p[3 * j] = (BYTE)v[j];
+			p[3 * j + 1] = (BYTE)(v[j] >> 8);
+			p[3 * j + 2] = (BYTE)(v[j] >> 16);
+		}
+	}
+	toS24Scalar(pIn + i, pOut + 3 * i, count - i);
+}
+
+#endif // CONVERT_HAS_SSE2
+
+#ifdef CONVERT_HAS_AVX2
+
+/**
+ * @fn	static void fromU8AVX2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+ *
+ * @brief	AVX2 versions. Widening uses the sign and zero extending moves, and 24 bit samples are spread out
+ * 			to 32 bits with a byte shuffle on each 128 bit lane. Tails go to the SSE2 versions.
+ *
+ * @date	10/17/2026
+ */
+CONVERT_TARGET_AVX2 static void fromU8AVX2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	__m256 scale = _mm256_set1_ps(1.0f / U8_SCALE);
+	__m256i bias = _mm256_set1_epi32(128);
+	UINT32 i = 0;
+	for(; i + 16 <= count; i += 16){
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(pIn + i));
+		__m256i a = _mm256_sub_epi32(_mm256_cvtepu8_epi32(bytes), bias);
+		__m256i b = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)), bias);
+		_mm256_storeu_ps(pOut + i, _mm256_mul_ps(_mm256_cvtepi32_ps(a), scale));
+		_mm256_storeu_ps(pOut + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(b), scale));
+	}
+	_mm256_zeroupper();
+	fromU8SSE2(pIn + i, pOut + i, count - i);
+}
+
+CONVERT_TARGET_AVX2 static void fromS16AVX2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	__m256 scale = _mm256_set1_ps(1.0f / S16_SCALE);
+	UINT32 i = 0;
+	for(; i + 16 <= count; i += 16){
+		__m128i a = _mm_loadu_si128((const __m128i*)(pIn + 2 * i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(pIn + 2 * i + 16));
+		_mm256_storeu_ps(pOut + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a)), scale));
+		_mm256_storeu_ps(pOut + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(b)), scale));
+	}
+	_mm256_zeroupper();
+	fromS16SSE2(pIn + 2 * i, pOut + i, count - i);
+}
+
+CONVERT_TARGET_AVX2 static void fromS24AVX2(const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	__m256 scale = _mm256_set1_ps(1.0f / S24_SCALE);
+	// in each lane, sample k goes to the top three bytes of dword k (-1 zeroes the low byte)
+	__m256i spread = _mm256_setr_epi8(
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	UINT32 i = 0;
+	// the second 16 byte load reads 4 bytes past the 8 samples
+	for(; i + 10 <= count; i += 8){
+		const BYTE* p = pIn + 3 * i;
+		__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+			_mm_loadu_si128((const __m128i*)(p + 12)), 1);
+		v = _mm256_srai_epi32(_mm256_shuffle_epi8(v, spread), 8);
+		_mm256_storeu_ps(pOut + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+	}
+	_mm256_zeroupper();
+	fromS24SSE2(pIn + 3 * i, pOut + i, count - i);
+}
+
+CONVERT_TARGET_AVX2 static inline __m256 scaleAndClamp(__m256 x, __m256 scale, __m256 lo, __m256 hi)
+{
+	x = _mm256_and_ps(x, _mm256_cmp_ps(x, x, _CMP_ORD_Q));
+	return _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(x, scale), lo), hi);
+}
+
+CONVERT_TARGET_AVX2 static void toU8AVX2(const FLOAT32* pIn, BYTE* pOut, UINT32 count)
+{
+	__m256 scale = _mm256_set1_ps(U8_SCALE);
+	__m256 lo = _mm256_set1_ps(-128.0f);
+	__m256 hi = _mm256_set1_ps(127.0f);
+	__m256i bias = _mm256_set1_epi16(128);
+	UINT32 i = 0;
+	for(; i + 32 <= count; i += 32){
+		__m256i a = _mm256_cvtps_epi32(scaleAndClamp(_mm256_loadu_ps(pIn + i), scale, lo, hi));
+		__m256i b = _mm256_cvtps_epi32(scaleAndClamp(_mm256_loadu_ps(pIn + i + 8), scale, lo, hi));
+		__m256i c = _mm256_cvtps_epi32(scaleAndClamp(_mm256_loadu_ps(pIn + i + 16), scale, lo, hi));
+		__m256i d = _mm256_cvtps_epi32(scaleAndClamp(_mm256_loadu_ps(pIn + i + 24), scale, lo, hi));
+		__m256i ab = _mm256_add_epi16(_mm256_packs_epi32(a, b), bias);
+		__m256i cd = _mm256_add_epi16(_mm256_packs_epi32(c, d), bias);
+		// both packs work within 128 bit lanes, so the groups of four samples come out as a0 b0 c0 d0 a1 b1 c1 d1
+		__m256i packed = _mm256_packus_epi16(ab, cd);
+		_mm256_storeu_si256((__m256i*)(pOut + i), _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+	}
+	_mm256_zeroupper();
+	toU8SSE2(pIn + i, pOut + i, count - i);
+}
+
+CONVERT_TARGET_AVX2 static void toS24AVX2(const FLOAT32* pIn, BYTE* pOut, UINT32 count)
+{
+	__m256 scale = _mm256_set1_ps(S24_SCALE);
+	__m256 lo = _mm256_set1_ps(-8388608.0f);
+	__m256 hi = _mm256_set1_ps(8388607.0f);
+	// in each lane, the low three bytes of the four dwords packed into the first 12 bytes
+	__m256i pack = _mm256_setr_epi8(
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	UINT32 i = 0;
+	// each 16 byte store writes 4 bytes past its samples, which the next store (or the tail) overwrites
+	for(; i + 10 <= count; i += 8){
+		__m256i v = _mm256_cvtps_epi32(scaleAndClamp(_mm256_loadu_ps(pIn + i), scale, lo, hi));
+		v = _mm256_shuffle_epi8(v, pack);
+		BYTE* p = pOut + 3 * i;
+		_mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+		_mm_storeu_si128((__m128i*)(p + 12), _mm256_extracti128_si256(v, 1));
+	}
+	_mm256_zeroupper();
+	toS24SSE2(pIn + i, pOut + 3 * i, count - i);
+}
+
+#endif // CONVERT_HAS_AVX2
+
+static const SampleConverters scalarConverters = { MIX_KERNEL_SCALAR, fromU8Scalar, fromS16Scalar, fromS24Scalar, toU8Scalar, toS24Scalar };
+#ifdef CONVERT_HAS_SSE2
+static const SampleConverters sse2Converters = { MIX_KERNEL_SSE2, fromU8SSE2, fromS16SSE2, fromS24SSE2, toU8SSE2, toS24SSE2 };
+#endif
+#ifdef CONVERT_HAS_AVX2
+static const SampleConverters avx2Converters = { MIX_KERNEL_AVX2, fromU8AVX2, fromS16AVX2, fromS24AVX2, toU8AVX2, toS24AVX2 };
+#endif
+
+/**
+ * @fn	const SampleConverters* getSampleConverters(MIX_KERNEL kernel)
+ *
+ * @brief	Gets the converters for a kernel.
+ *
+ * @return	null if the kernel can't be used here.
+ *
+ * @date	10/17/2026
+ */
+const SampleConverters* getSampleConverters(MIX_KERNEL kernel)
+{
+	if(!isMixKernelAvailable(kernel))
+		return NULL;
+	switch(kernel){
+#ifdef CONVERT_HAS_AVX2
+		case MIX_KERNEL_AVX2:
+			return &avx2Converters;
+#endif
+#ifdef CONVERT_HAS_SSE2
+		case MIX_KERNEL_SSE2:
+			return &sse2Converters;
+#endif
+		default:
+			return &scalarConverters;
+	}
+}
+
+/**
+ * @fn	SAMPLE_FORMAT getSampleFormat(const WAVEFORMATEX* pFormat)
+ *
+ * @brief	Classifies a format, looking through WAVE_FORMAT_EXTENSIBLE to the sub format. Extensible formats
+ * 			whose valid bits are fewer than the container (20 bits in 24, say) are still exact, the unused low
+ * 			bits are simply zero.
+ *
+ * @date	10/17/2026
+ */
+SAMPLE_FORMAT getSampleFormat(const WAVEFORMATEX* pFormat)
+{
+	if(pFormat == NULL)
+		return SAMPLE_FORMAT_UNSUPPORTED;
+	WORD tag = pFormat->wFormatTag;
+	if(tag == WAVE_FORMAT_EXTENSIBLE && pFormat->cbSize >= 22){
+		// the first DWORD of the sub format GUID is the format tag it stands for
+		DWORD subFormat;
+		memcpy(&subFormat, (const BYTE*)pFormat + sizeof(WAVEFORMATEX) + 6, sizeof(subFormat));
+		tag = (WORD)subFormat;
+	}
+	if(pFormat->nChannels == 0 || pFormat->nBlockAlign != pFormat->nChannels * pFormat->wBitsPerSample / 8)
+		return SAMPLE_FORMAT_UNSUPPORTED;
+
+	if(tag == WAVE_FORMAT_PCM){
+		switch(pFormat->wBitsPerSample){
+		case 8: return SAMPLE_FORMAT_U8;
+		case 16: return SAMPLE_FORMAT_S16;
+		case 24: return SAMPLE_FORMAT_S24;
+		}
+	}else if(tag == WAVE_FORMAT_IEEE_FLOAT && pFormat->wBitsPerSample == 32){
+		return SAMPLE_FORMAT_F32;
+	}
+	return SAMPLE_FORMAT_UNSUPPORTED;
+}
+
+/**
+ * @fn	UINT32 getSampleBytes(SAMPLE_FORMAT format)
+ *
+ * @brief	Bytes per sample of one channel, 0 for an unsupported format.
+ *
+ * @date	10/17/2026
+ */
+UINT32 getSampleBytes(SAMPLE_FORMAT format)
+{
+	switch(format){
+	case SAMPLE_FORMAT_U8: return 1;
+	case SAMPLE_FORMAT_S16: return 2;
+	case SAMPLE_FORMAT_S24: return 3;
+	case SAMPLE_FORMAT_F32: return 4;
+	default: return 0;
+	}
+}
+
+/**
+ * @fn	UINT32 makeFloatFormat(const WAVEFORMATEX* pSource, BYTE* pFormat)
+ *
+ * @brief	Writes the engine (32 bit float) version of a format: same rate and channels, and for extensible
+ * 			formats the same channel mask, with the sub format changed to IEEE float.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pSource		   	The format of the file.
+ * @param [out]	pFormat	At least SAMPLE_FLOAT_FORMAT_BYTES bytes, receives the new format.
+ *
+ * @return	The size of the new format in bytes.
+ */
+UINT32 makeFloatFormat(const WAVEFORMATEX* pSource, BYTE* pFormat)
+{
+	memset(pFormat, 0, SAMPLE_FLOAT_FORMAT_BYTES);
+	bool extensible = pSource->wFormatTag == WAVE_FORMAT_EXTENSIBLE && pSource->cbSize >= 22;
+	UINT32 size = extensible ? SAMPLE_FLOAT_FORMAT_BYTES : sizeof(WAVEFORMATEX);
+	memcpy(pFormat, pSource, size);
+
+	WAVEFORMATEX* pwfx = (WAVEFORMATEX*)pFormat;
+	pwfx->wBitsPerSample = 32;
+	pwfx->nBlockAlign = (WORD)(pwfx->nChannels * 4);
+	pwfx->nAvgBytesPerSec = pwfx->nSamplesPerSec * pwfx->nBlockAlign;
+	if(extensible){
+		WORD validBits = 32;
+		DWORD subFormat = WAVE_FORMAT_IEEE_FLOAT; // KSDATAFORMAT_SUBTYPE_IEEE_FLOAT differs from PCM only here
+		pwfx->cbSize = 22;
+		memcpy(pFormat + sizeof(WAVEFORMATEX), &validBits, sizeof(validBits));
+		memcpy(pFormat + sizeof(WAVEFORMATEX) + 6, &subFormat, sizeof(subFormat));
+	}else{
+		pwfx->wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+		pwfx->cbSize = 0;
+	}
+	return size;
+}
+
+/**
+ * @fn	void convertToFloat(SAMPLE_FORMAT format, const BYTE* pIn, FLOAT32* pOut, UINT32 count, MIX_KERNEL kernel)
+ *
+ * @brief	Converts samples to the engine format.
+ *
+ * @date	10/17/2026
+ *
+ * @param	format		The format of pIn, which must not be SAMPLE_FORMAT_UNSUPPORTED.
+ * @param	pIn			The samples.
+ * @param [out]	pOut	Receives count floats.
+ * @param	count		Number of samples (frames times channels).
+ * @param	kernel		The instruction set to use, the best available if omitted. Falls back to scalar if
+ * 						the one asked for is not available.
+ */
+void convertToFloat(SAMPLE_FORMAT format, const BYTE* pIn, FLOAT32* pOut, UINT32 count, MIX_KERNEL kernel)
+{
+	const SampleConverters* pConverters = getSampleConverters(kernel);
+	if(pConverters == NULL)
+		pConverters = &scalarConverters;
+	switch(format){
+	case SAMPLE_FORMAT_U8: pConverters->fromU8(pIn, pOut, count); break;
+	case SAMPLE_FORMAT_S16: pConverters->fromS16(pIn, pOut, count); break;
+	case SAMPLE_FORMAT_S24: pConverters->fromS24(pIn, pOut, count); break;
+	case SAMPLE_FORMAT_F32: memcpy(pOut, pIn, count * sizeof(FLOAT32)); break;
+	default: break;
+	}
+}
+
+void convertToFloat(SAMPLE_FORMAT format, const BYTE* pIn, FLOAT32* pOut, UINT32 count)
+{
+	convertToFloat(format, pIn, pOut, count, getBestMixKernel());
+}
+
+/**
+ * @fn	void convertFromFloat(SAMPLE_FORMAT format, const FLOAT32* pIn, BYTE* pOut, UINT32 count, MIX_KERNEL kernel)
+ *
+ * @brief	Converts engine samples back to a file format, the inverse of convertToFloat().
+ *
+ * @date	10/17/2026
+ */
+void convertFromFloat(SAMPLE_FORMAT format, const FLOAT32* pIn, BYTE* pOut, UINT32 count, MIX_KERNEL kernel)
+{
+	const SampleConverters* pConverters = getSampleConverters(kernel);
+	const MixKernels* pKernels = getMixKernels(kernel);
+	if(pConverters == NULL){
+		pConverters = &scalarConverters;
+		pKernels = getMixKernels(MIX_KERNEL_SCALAR);
+	}
+	switch(format){
+	case SAMPLE_FORMAT_U8: pConverters->toU8(pIn, pOut, count); break;
+	case SAMPLE_FORMAT_S16: pKernels->toPCM16(pIn, (INT16*)pOut, count); break;
+	case SAMPLE_FORMAT_S24: pConverters->toS24(pIn, pOut, count); break;
+	case SAMPLE_FORMAT_F32: memcpy(pOut, pIn, count * sizeof(FLOAT32)); break;
+	default: break;
+	}
+}
+
+void convertFromFloat(SAMPLE_FORMAT format, const FLOAT32* pIn, BYTE* pOut, UINT32 count)
+{
+	convertFromFloat(format, pIn, pOut, count, getBestMixKernel());
+}
+
+/**
+// End of SampleConvert.cpp
+ */
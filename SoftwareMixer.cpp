@@ -0,0 +1,1036 @@
+#include "SoftwareMixer.h"
+#include <string.h>
+#include <algorithm>
+
+#define MIXER_DEFAULT_FREQ_RATIO 2.0f // same as XAUDIO2_DEFAULT_FREQ_RATIO
+
+/**
+ * @fn	static void readPCM8(const BYTE* pFrame, UINT32 channels, FLOAT32* pOut)
+ *
+ * @brief	Frame readers, one per supported sample format. Each converts one interleaved frame to floats in
+ * 			the range [-1, 1).
+ *
+ * @date	10/17/2026
+ */
+static void readPCM8(const BYTE* pFrame, UINT32 channels, FLOAT32* pOut)
+{
+	for(UINT32 c = 0; c < channels; ++c){
+		pOut[c] = ((INT32)pFrame[c] - 128) * (1.0f / 128.0f);
+	}
+}
+
+static void readPCM16(const BYTE* pFrame, UINT32 channels, FLOAT32* pOut)
+{
+	for(UINT32 c = 0; c < channels; ++c){
+		INT16 s;
+		memcpy(&s, pFrame + c * 2, sizeof(s));
+		pOut[c] = s * (1.0f / 32768.0f);
+	}
+}
+
+static void readPCM24(const BYTE* pFrame, UINT32 channels, FLOAT32* pOut)
+{
+	for(UINT32 c = 0; c < channels; ++c){
+		const BYTE* p = pFrame + c * 3;
+		INT32 s = (INT32)(((UINT32)p[0] << 8) | ((UINT32)p[1] << 16) | ((UINT32)p[2] << 24)) >> 8;
+		pOut[c] = s * (1.0f / 8388608.0f);
+	}
+}
+
+static void readPCM32(const BYTE* pFrame, UINT32 channels, FLOAT32* pOut)
+{
+	for(UINT32 c = 0; c < channels; ++c){
+		INT32 s;
+		memcpy(&s, pFrame + c * 4, sizeof(s));
+		pOut[c] = (FLOAT32)(s * (1.0 / 2147483648.0));
+	}
+}
+
+static void readFloat32(const BYTE* pFrame, UINT32 channels, FLOAT32* pOut)
+{
+	memcpy(pOut, pFrame, channels * sizeof(FLOAT32));
+}
+
+/**
+ * @fn	static void setDefaultMatrix(FLOAT32* pMatrix, UINT32 srcChannels, UINT32 dstChannels)
+ *
+ * @brief	Sets the matrix XAudio2 would use by default: straight through when the channel counts match,
+ * 			mono to the first two outputs, and otherwise each source channel to the output of the same index.
+ *
+ * @date	10/17/2026
+ */
+static void setDefaultMatrix(FLOAT32* pMatrix, UINT32 srcChannels, UINT32 dstChannels)
+{
+	memset(pMatrix, 0, MIXER_MAX_CHANNELS * MIXER_MAX_CHANNELS * sizeof(FLOAT32));
+	if(srcChannels == 1){
+		pMatrix[0] = 1.0f;
+		if(dstChannels > 1){
+			pMatrix[1] = 1.0f;
+		}
+		return;
+	}
+	for(UINT32 s = 0; s < srcChannels && s < dstChannels; ++s){
+		pMatrix[srcChannels * s + s] = 1.0f;
+	}
+}
+
+/**
+ * @fn	MixerVoice::MixerVoice(SoftwareMixer* pMixer, const WAVEFORMATEX* pFormat, READ_FRAME readFrame,
+ * 		FLOAT32 maxFrequencyRatio, MixerVoiceCallback* pCallback)
+ *
+ * @brief	Constructor, only called from SoftwareMixer::createVoice(), which has already checked the format.
+ *
+ * @date	10/17/2026
+ */
+MixerVoice::MixerVoice(SoftwareMixer* pMixer, const WAVEFORMATEX* pFormat, READ_FRAME readFrame, FLOAT32 maxFrequencyRatio, MixerVoiceCallback* pCallback)
+{
+	this->pMixer = pMixer;
+	this->format = *pFormat;
+	this->format.cbSize = 0;
+	this->readFrame = readFrame;
+	this->pCallback = pCallback;
+	this->maxFrequencyRatio = maxFrequencyRatio;
+	frequencyRatio = 1.0f;
+	sourceSampleRate = pFormat->nSamplesPerSec;
+	pOutput = NULL;
+
+	running = false;
+	bufferStarted = false;
+	position = 0;
+	loopsDone = 0;
+	loopExited = false;
+	samplesPlayed = 0;
+	lastStep = 0;
+	lastVolume = -1.0f;
+	resampler.init(format.nChannels, pMixer->getResamplerQuality());
+
+	volume = 1.0f;
+	for(UINT32 i = 0; i < MIXER_MAX_CHANNELS; ++i){
+		channelVolumes[i] = 1.0f;
+	}
+	setDefaultMatrix(pMixer->getChannels());
+}
+
+MixerVoice::~MixerVoice(void)
+{
+}
+
+void MixerVoice::setDefaultMatrix(UINT32 dstChannels)
+{
+	::setDefaultMatrix(matrix, format.nChannels, dstChannels);
+}
+
+/**
+ * @fn	HRESULT MixerVoice::start()
+ *
+ * @brief	Starts or resumes playback from wherever the voice was stopped.
+ *
+ * @return	S_OK.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerVoice::start()
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	running = true;
+	return S_OK;
+}
+
+/**
+ * @fn	void MixerVoice::stop()
+ *
+ * @brief	Stops playback. The queue and the position are kept, so start() carries on from the same place.
+ *
+ * @date	10/17/2026
+ */
+void MixerVoice::stop()
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	running = false;
+}
+
+/**
+ * @fn	HRESULT MixerVoice::submitBuffer(const MixerBuffer* pBuffer)
+ *
+ * @brief	Queues a buffer for playback. The data is not copied.
+ *
+ * @param	pBuffer	The buffer. The play and loop regions are checked the same way XAudio2 checks them.
+ *
+ * @return	S_OK, or E_INVALIDARG if the buffer is malformed or the queue is full.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerVoice::submitBuffer(const MixerBuffer* pBuffer)
+{
+	if(pBuffer == NULL || pBuffer->pAudioData == NULL || pBuffer->audioBytes == 0 || pBuffer->audioBytes % format.nBlockAlign != 0){
+		return E_INVALIDARG;
+	}
+	UINT32 totalFrames = pBuffer->audioBytes / format.nBlockAlign;
+	UINT32 playEnd = pBuffer->playLength ? pBuffer->playBegin + pBuffer->playLength : totalFrames;
+	if(pBuffer->playBegin >= totalFrames || playEnd > totalFrames){
+		return E_INVALIDARG;
+	}
+	if(pBuffer->loopCount > 0){
+		UINT32 loopEnd = pBuffer->loopLength ? pBuffer->loopBegin + pBuffer->loopLength : playEnd;
+		if(pBuffer->loopBegin >= playEnd || loopEnd > playEnd || loopEnd <= pBuffer->playBegin || pBuffer->loopBegin >= loopEnd){
+			return E_INVALIDARG;
+		}
+	}
+
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	if(queue.size() >= MIXER_MAX_QUEUED_BUFFERS){
+		return E_INVALIDARG;
+	}
+	queue.push_back(*pBuffer);
+	return S_OK;
+}
+
+/**
+ * @fn	void MixerVoice::flushBuffers()
+ *
+ * @brief	Removes the queued buffers, calling onBufferEnd() for each. As in XAudio2 the buffer that is
+ * 			playing is kept if the voice is running.
+ *
+ * @date	10/17/2026
+ */
+void MixerVoice::flushBuffers()
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	size_t keep = (running && bufferStarted && !queue.empty()) ? 1 : 0;
+	while(queue.size() > keep){
+		MixerBuffer removed = queue.back();
+		queue.pop_back();
+		if(pCallback != NULL){
+			pCallback->onBufferEnd(removed.pContext);
+		}
+	}
+	if(keep == 0){
+		bufferStarted = false;
+		position = 0;
+		resampler.reset();
+		lastVolume = -1.0f;
+	}
+}
+
+/**
+ * @fn	void MixerVoice::discontinuity()
+ *
+ * @brief	Marks the last queued buffer as the end of the stream, so that onStreamEnd() follows it.
+ *
+ * @date	10/17/2026
+ */
+void MixerVoice::discontinuity()
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	if(!queue.empty()){
+		queue.back().flags |= MIXER_END_OF_STREAM;
+	}
+}
+
+/**
+ * @fn	void MixerVoice::exitLoop()
+ *
+ * @brief	Lets the current buffer play past its loop region the next time it gets there.
+ *
+ * @date	10/17/2026
+ */
+void MixerVoice::exitLoop()
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	loopExited = true;
+}
+
+/**
+ * @fn	void MixerVoice::getState(void** ppCurrentContext, UINT32* pBuffersQueued, UINT64* pSamplesPlayed)
+ *
+ * @brief	The equivalent of IXAudio2SourceVoice::GetState(). Any of the pointers may be NULL.
+ *
+ * @date	10/17/2026
+ */
+void MixerVoice::getState(void** ppCurrentContext, UINT32* pBuffersQueued, UINT64* pSamplesPlayed)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	if(ppCurrentContext != NULL){
+		*ppCurrentContext = queue.empty() ? NULL : queue.front().pContext;
+	}
+	if(pBuffersQueued != NULL){
+		*pBuffersQueued = (UINT32)queue.size();
+	}
+	if(pSamplesPlayed != NULL){
+		*pSamplesPlayed = samplesPlayed;
+	}
+}
+
+/**
+ * @fn	HRESULT MixerVoice::setFrequencyRatio(FLOAT32 ratio)
+ *
+ * @brief	Sets the pitch. The ratio is clamped to the range the voice was made with.
+ *
+ * @return	S_OK.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerVoice::setFrequencyRatio(FLOAT32 ratio)
+{
+	if(ratio < MIXER_MIN_FREQ_RATIO){
+		ratio = MIXER_MIN_FREQ_RATIO;
+	}
+	if(ratio > maxFrequencyRatio){
+		ratio = maxFrequencyRatio;
+	}
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	frequencyRatio = ratio;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT MixerVoice::setSourceSampleRate(UINT32 sampleRate)
+ *
+ * @brief	Changes the rate the queued data is played at. As in XAudio2 this is only allowed while nothing is
+ * 			queued.
+ *
+ * @return	S_OK, E_INVALIDARG for a zero rate or E_FAIL if buffers are queued.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerVoice::setSourceSampleRate(UINT32 sampleRate)
+{
+	if(sampleRate == 0){
+		return E_INVALIDARG;
+	}
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	if(!queue.empty()){
+		return E_FAIL;
+	}
+	sourceSampleRate = sampleRate;
+	return S_OK;
+}
+
+void MixerVoice::setVolume(FLOAT32 volume)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	this->volume = volume;
+}
+
+HRESULT MixerVoice::setChannelVolumes(UINT32 channels, const FLOAT32* pVolumes)
+{
+	if(channels != format.nChannels || pVolumes == NULL){
+		return E_INVALIDARG;
+	}
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	memcpy(channelVolumes, pVolumes, channels * sizeof(FLOAT32));
+	return S_OK;
+}
+
+void MixerVoice::getChannelVolumes(UINT32 channels, FLOAT32* pVolumes)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	for(UINT32 i = 0; i < channels; ++i){
+		pVolumes[i] = i < format.nChannels ? channelVolumes[i] : 0.0f;
+	}
+}
+
+/**
+ * @fn	HRESULT MixerVoice::setOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, const FLOAT32* pLevels)
+ *
+ * @brief	Sets the mix levels, laid out as in XAudio2: the level of source channel s in output channel d is
+ * 			pLevels[srcChannels * d + s].
+ *
+ * @return	S_OK, or E_INVALIDARG if the channel counts are not those of the voice and its output.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerVoice::setOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, const FLOAT32* pLevels)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	if(srcChannels != format.nChannels || dstChannels != getOutputChannels() || pLevels == NULL){
+		return E_INVALIDARG;
+	}
+	memcpy(matrix, pLevels, srcChannels * dstChannels * sizeof(FLOAT32));
+	return S_OK;
+}
+
+void MixerVoice::getOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, FLOAT32* pLevels)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	for(UINT32 i = 0; i < srcChannels * dstChannels; ++i){
+		pLevels[i] = i < (UINT32)format.nChannels * getOutputChannels() ? matrix[i] : 0.0f;
+	}
+}
+
+/**
+ * @fn	HRESULT MixerVoice::setOutput(MixerBus* pBus)
+ *
+ * @brief	Sends the voice to a bus, or to the mixer's output if pBus is NULL. As SetOutputVoices() does in
+ * 			XAudio2, this puts the output matrix back to the default for the new destination.
+ *
+ * @return	S_OK, or E_INVALIDARG if the bus belongs to another mixer.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerVoice::setOutput(MixerBus* pBus)
+{
+	if(pBus != NULL && pBus->pMixer != pMixer){
+		return E_INVALIDARG;
+	}
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	pOutput = pBus;
+	setDefaultMatrix(getOutputChannels());
+	return S_OK;
+}
+
+UINT32 MixerVoice::getOutputChannels()
+{
+	return pOutput != NULL ? pOutput->channels : pMixer->getChannels();
+}
+
+/**
+ * @fn	UINT32 MixerVoice::readSource(FLOAT32* pDst, UINT32 frames, bool* pEndOfStream)
+ *
+ * @brief	Reads source frames at the source rate, walking the queue: play and loop regions, buffer, loop and
+ * 			stream callbacks. Stops early when the queue runs dry or straight after the end of a stream.
+ *
+ * @param [out]	pDst		 	frames * channels floats.
+ * @param	frames			 	Frames wanted.
+ * @param [out]	pEndOfStream	Set to true if the read stopped at the end of a stream.
+ *
+ * @return	Frames read.
+ *
+ * @date	10/17/2026
+ */
+UINT32 MixerVoice::readSource(FLOAT32* pDst, UINT32 frames, bool* pEndOfStream)
+{
+	UINT32 channels = format.nChannels;
+	UINT32 blockAlign = format.nBlockAlign;
+	UINT32 read = 0;
+	*pEndOfStream = false;
+
+	while(read < frames && !queue.empty()){
+		MixerBuffer& buffer = queue.front();
+		if(!bufferStarted){
+			bufferStarted = true;
+			position = buffer.playBegin;
+			loopsDone = 0;
+			loopExited = false;
+			if(pCallback != NULL){
+				pCallback->onBufferStart(buffer.pContext);
+			}
+		}
+
+		UINT32 playEnd = buffer.playLength ? buffer.playBegin + buffer.playLength : buffer.audioBytes / blockAlign;
+		UINT32 loopEnd = buffer.loopLength ? buffer.loopBegin + buffer.loopLength : playEnd;
+		bool looping = buffer.loopCount > 0 && !loopExited && (buffer.loopCount == MIXER_LOOP_INFINITE || loopsDone < buffer.loopCount);
+		UINT32 regionEnd = looping ? loopEnd : playEnd;
+
+		if(position >= regionEnd){
+			if(looping){
+				position = buffer.loopBegin;
+				++loopsDone;
+				if(pCallback != NULL){
+					pCallback->onLoopEnd(buffer.pContext);
+				}
+				continue;
+			}
+			MixerBuffer done = buffer;
+			queue.pop_front();
+			bufferStarted = false;
+			position = 0;
+			if(pCallback != NULL){
+				pCallback->onBufferEnd(done.pContext);
+			}
+			if(done.flags & MIXER_END_OF_STREAM){
+				samplesPlayed = 0;
+				if(pCallback != NULL){
+					pCallback->onStreamEnd();
+				}
+				*pEndOfStream = true;
+				break;
+			}
+			continue;
+		}
+
+		UINT32 count = frames - read;
+		if(count > regionEnd - position){
+			count = regionEnd - position;
+		}
+		const BYTE* pData = buffer.pAudioData + position * blockAlign;
+		for(UINT32 i = 0; i < count; ++i){
+			readFrame(pData + i * blockAlign, channels, pDst + (read + i) * channels);
+		}
+		position += count;
+		read += count;
+		samplesPlayed += count;
+	}
+	return read;
+}
+
+/**
+ * @fn	void MixerVoice::render(FLOAT32* pOut, UINT32 frames, UINT32 engineSampleRate)
+ *
+ * @brief	Produces up to frames output frames and adds them into pOut. Source frames are read from the queue as
+ * 			the resampler asks for them. The step (frequency ratio * source rate / output rate) is ramped from
+ * 			the previous block's value to this block's, so pitch and Doppler changes are smooth. At the end of a
+ * 			stream the resampler is drained, so the last frames play without waiting for more. Called with the
+ * 			mixer locked.
+ *
+ * @param	pOut				The interleaved output of the mixer or of the voice's bus.
+ * @param	frames				Frames to produce.
+ * @param	engineSampleRate	The output rate.
+ *
+ * @date	10/17/2026
+ */
+void MixerVoice::render(FLOAT32* pOut, UINT32 frames, UINT32 engineSampleRate)
+{
+	UINT32 channels = format.nChannels;
+	FLOAT32* pIn = &pMixer->scratch[0];
+	double step = (double)frequencyRatio * sourceSampleRate / engineSampleRate;
+	double startStep = (lastStep > 0) ? lastStep : step;
+	lastStep = step;
+	UINT32 produced = 0;
+
+	if(pCallback != NULL){
+		UINT32 bytesRequired = 0;
+		if(queue.empty()){
+			bytesRequired = resampler.getInputNeeded(frames, startStep, step) * format.nBlockAlign;
+		}
+		pCallback->onProcessingPassStart(bytesRequired);
+	}
+
+	while(produced < frames){
+		UINT32 remaining = frames - produced;
+		double from = startStep + (step - startStep) * produced / frames;
+		UINT32 needed = resampler.getInputNeeded(remaining, from, step);
+		UINT32 read = 0;
+		if(needed > 0){
+			vector<FLOAT32>& source = pMixer->sourceScratch;
+			if(source.size() < needed * channels){
+				source.resize(needed * channels);
+			}
+			bool endOfStream;
+			read = readSource(&source[0], needed, &endOfStream);
+			resampler.push(&source[0], read);
+			if(endOfStream){
+				resampler.endOfStream();
+			}
+		}
+		UINT32 got = resampler.pull(pIn + produced * channels, remaining, from, step);
+		produced += got;
+		if(got == 0 && read == 0){
+			break;
+		}
+	}
+
+	// As in XAudio2 a volume change is ramped over the block, so that turning a voice up from or down to
+	// silence doesn't click
+	FLOAT32 startVolume = (lastVolume >= 0) ? lastVolume : volume;
+	lastVolume = volume;
+	if(startVolume != volume && produced > 0){
+		FLOAT32 delta = (volume - startVolume) / produced;
+		for(UINT32 f = 0; f < produced; ++f){
+			FLOAT32 g = startVolume + delta * f;
+			for(UINT32 c = 0; c < channels; ++c){
+				pIn[f * channels + c] *= g;
+			}
+		}
+		mixInto(pIn, pOut, produced, getOutputChannels(), 1.0f);
+	}else{
+		mixInto(pIn, pOut, produced, getOutputChannels(), volume);
+	}
+
+	if(pCallback != NULL){
+		pCallback->onProcessingPassEnd();
+	}
+}
+
+/**
+ * @fn	void MixerVoice::mixInto(const FLOAT32* pIn, FLOAT32* pOut, UINT32 frames, UINT32 dstChannels,
+ * 		FLOAT32 gain)
+ *
+ * @brief	Applies the channel volumes, output matrix and gain (the voice volume, unless render() has already
+ * 			ramped it into the data) to frames of source data and adds the result to the output, one source
+ * 			channel (one row of gains) at a time. Silent rows are skipped.
+ *
+ * @date	10/17/2026
+ */
+void MixerVoice::mixInto(const FLOAT32* pIn, FLOAT32* pOut, UINT32 frames, UINT32 dstChannels, FLOAT32 gain)
+{
+	UINT32 srcChannels = format.nChannels;
+	FLOAT32 gains[MIXER_MAX_CHANNELS];
+	for(UINT32 s = 0; s < srcChannels; ++s){
+		bool silent = true;
+		for(UINT32 d = 0; d < dstChannels; ++d){
+			gains[d] = matrix[srcChannels * d + s] * channelVolumes[s] * gain;
+			silent = silent && gains[d] == 0.0f;
+		}
+		if(!silent){
+			pMixer->pKernels->mixChannel(pIn + s, srcChannels, pOut, frames, dstChannels, gains);
+		}
+	}
+}
+
+/**
+ * @fn	MixerBus::MixerBus(SoftwareMixer* pMixer, UINT32 channels, UINT32 stage)
+ *
+ * @brief	Constructor, only called from SoftwareMixer::createBus(). The bus starts out sending to the mixer's
+ * 			output at full volume.
+ *
+ * @date	10/17/2026
+ */
+MixerBus::MixerBus(SoftwareMixer* pMixer, UINT32 channels, UINT32 stage)
+{
+	this->pMixer = pMixer;
+	this->channels = channels;
+	this->stage = stage;
+	pOutput = NULL;
+	volume = 1.0f;
+	active = false;
+	setDefaultMatrix(matrix, channels, pMixer->getChannels());
+}
+
+/**
+ * @fn	HRESULT MixerBus::setOutput(MixerBus* pBus)
+ *
+ * @brief	Sends the bus to another bus, or to the mixer's output if pBus is NULL, and puts the output matrix
+ * 			back to the default for the new destination.
+ *
+ * @return	S_OK, or E_INVALIDARG if pBus is of another mixer or its stage is not higher than this one's, which
+ * 			would mix it before its input.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerBus::setOutput(MixerBus* pBus)
+{
+	if(pBus != NULL && (pBus->pMixer != pMixer || pBus->stage <= stage)){
+		return E_INVALIDARG;
+	}
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	pOutput = pBus;
+	setDefaultMatrix(matrix, channels, getOutputChannels());
+	return S_OK;
+}
+
+UINT32 MixerBus::getOutputChannels()
+{
+	return pOutput != NULL ? pOutput->channels : pMixer->getChannels();
+}
+
+/**
+ * @fn	void MixerBus::setVolume(FLOAT32 volume)
+ *
+ * @brief	Scales everything mixed into the bus. At zero the bus is not mixed on at all.
+ *
+ * @date	10/17/2026
+ */
+void MixerBus::setVolume(FLOAT32 volume)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	this->volume = volume;
+}
+
+/**
+ * @fn	HRESULT MixerBus::setOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, const FLOAT32* pLevels)
+ *
+ * @brief	Sets the levels the bus is mixed on with, laid out as for MixerVoice::setOutputMatrix().
+ *
+ * @return	S_OK, or E_INVALIDARG if the channel counts are not those of the bus and its output.
+ *
+ * @date	10/17/2026
+ */
+HRESULT MixerBus::setOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, const FLOAT32* pLevels)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	if(srcChannels != channels || dstChannels != getOutputChannels() || pLevels == NULL){
+		return E_INVALIDARG;
+	}
+	memcpy(matrix, pLevels, srcChannels * dstChannels * sizeof(FLOAT32));
+	return S_OK;
+}
+
+void MixerBus::getOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, FLOAT32* pLevels)
+{
+	lock_guard<recursive_mutex> guard(pMixer->lock);
+	for(UINT32 i = 0; i < srcChannels * dstChannels; ++i){
+		pLevels[i] = i < channels * getOutputChannels() ? matrix[i] : 0.0f;
+	}
+}
+
+/**
+ * @fn	void MixerBus::mixInto(FLOAT32* pOut, UINT32 frames)
+ *
+ * @brief	Adds this block's mix, through the volume and output matrix, to the output. Called with the mixer
+ * 			locked.
+ *
+ * @date	10/17/2026
+ */
+void MixerBus::mixInto(FLOAT32* pOut, UINT32 frames)
+{
+	UINT32 dstChannels = getOutputChannels();
+	FLOAT32 gains[MIXER_MAX_CHANNELS];
+	for(UINT32 s = 0; s < channels; ++s){
+		bool silent = true;
+		for(UINT32 d = 0; d < dstChannels; ++d){
+			gains[d] = matrix[channels * d + s] * volume;
+			silent = silent && gains[d] == 0.0f;
+		}
+		if(!silent){
+			pMixer->pKernels->mixChannel(&buffer[s], channels, pOut, frames, dstChannels, gains);
+		}
+	}
+}
+
+/**
+ * @fn	SoftwareMixer::SoftwareMixer(void)
+ *
+ * @brief	Default constructor. The mixer is unusable until init() has been called.
+ *
+ * @date	10/17/2026
+ */
+SoftwareMixer::SoftwareMixer(void)
+{
+	sampleRate = 0;
+	channels = 0;
+	masterVolume = 1.0f;
+	resamplerQuality = RESAMPLER_QUALITY_SINC8;
+	pKernels = getMixKernels(getBestMixKernel());
+}
+
+/**
+ * @fn	SoftwareMixer::~SoftwareMixer(void)
+ *
+ * @brief	Destructor. Any voices and buses that were not destroyed are deleted without callbacks.
+ *
+ * @date	10/17/2026
+ */
+SoftwareMixer::~SoftwareMixer(void)
+{
+	for(size_t i = 0; i < voices.size(); ++i){
+		delete voices[i];
+	}
+	voices.clear();
+	for(size_t i = 0; i < buses.size(); ++i){
+		delete buses[i];
+	}
+	buses.clear();
+}
+
+/**
+ * @fn	HRESULT SoftwareMixer::init(UINT32 sampleRate, UINT32 channels)
+ *
+ * @brief	Sets the output format.
+ *
+ * @param	sampleRate	Output frames per second.
+ * @param	channels  	Output channels, 1 to MIXER_MAX_CHANNELS.
+ *
+ * @return	S_OK or E_INVALIDARG.
+ *
+ * @date	10/17/2026
+ */
+HRESULT SoftwareMixer::init(UINT32 sampleRate, UINT32 channels)
+{
+	if(sampleRate == 0 || channels == 0 || channels > MIXER_MAX_CHANNELS){
+		return E_INVALIDARG;
+	}
+	lock_guard<recursive_mutex> guard(lock);
+	if(!voices.empty() || !buses.empty()){
+		return E_FAIL;
+	}
+	this->sampleRate = sampleRate;
+	this->channels = channels;
+	return S_OK;
+}
+
+/**
+ * @fn	WORD SoftwareMixer::getFormatTag(const WAVEFORMATEX* pFormat)
+ *
+ * @brief	Returns the format tag, looking through WAVE_FORMAT_EXTENSIBLE to the sub format.
+ *
+ * @date	10/17/2026
+ */
+WORD SoftwareMixer::getFormatTag(const WAVEFORMATEX* pFormat)
+{
+	if(pFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE && pFormat->cbSize >= 22){
+		// the first DWORD of the sub format GUID is the format tag it stands for
+		DWORD subFormat;
+		memcpy(&subFormat, (const BYTE*)pFormat + sizeof(WAVEFORMATEX) + 6, sizeof(subFormat));
+		return (WORD)subFormat;
+	}
+	return pFormat->wFormatTag;
+}
+
+/**
+ * @fn	HRESULT SoftwareMixer::createVoice(const WAVEFORMATEX* pFormat, FLOAT32 maxFrequencyRatio,
+ * 		MixerVoiceCallback* pCallback, MixerVoice** ppVoice)
+ *
+ * @brief	Makes a new voice, stopped and with an empty queue.
+ *
+ * @param	pFormat			 	The source format: PCM of 8, 16, 24 or 32 bits or 32 bit float, plain or
+ * 								extensible.
+ * @param	maxFrequencyRatio	The highest frequency ratio that will be asked for, 0 for the default of 2.
+ * @param	pCallback		 	Notification sink, may be NULL.
+ * @param [out]	ppVoice		 	The new voice.
+ *
+ * @return	S_OK, E_INVALIDARG for an unsupported format or E_FAIL if init() has not been called.
+ *
+ * @date	10/17/2026
+ */
+HRESULT SoftwareMixer::createVoice(const WAVEFORMATEX* pFormat, FLOAT32 maxFrequencyRatio, MixerVoiceCallback* pCallback, MixerVoice** ppVoice)
+{
+	if(ppVoice == NULL || pFormat == NULL){
+		return E_INVALIDARG;
+	}
+	*ppVoice = NULL;
+	if(sampleRate == 0){
+		return E_FAIL;
+	}
+	if(pFormat->nChannels == 0 || pFormat->nChannels > MIXER_MAX_CHANNELS || pFormat->nSamplesPerSec == 0
+		|| pFormat->nBlockAlign != pFormat->nChannels * pFormat->wBitsPerSample / 8){
+		return E_INVALIDARG;
+	}
+
+	MixerVoice::READ_FRAME readFrame = NULL;
+	WORD tag = getFormatTag(pFormat);
+	if(tag == WAVE_FORMAT_PCM){
+		switch(pFormat->wBitsPerSample){
+		case 8: readFrame = readPCM8; break;
+		case 16: readFrame = readPCM16; break;
+		case 24: readFrame = readPCM24; break;
+		case 32: readFrame = readPCM32; break;
+		}
+	}else if(tag == WAVE_FORMAT_IEEE_FLOAT && pFormat->wBitsPerSample == 32){
+		readFrame = readFloat32;
+	}
+	if(readFrame == NULL){
+		return E_INVALIDARG;
+	}
+
+	if(maxFrequencyRatio <= 0.0f){
+		maxFrequencyRatio = MIXER_DEFAULT_FREQ_RATIO;
+	}
+
+	lock_guard<recursive_mutex> guard(lock);
+	MixerVoice* pVoice = new MixerVoice(this, pFormat, readFrame, maxFrequencyRatio, pCallback);
+	voices.push_back(pVoice);
+	*ppVoice = pVoice;
+	return S_OK;
+}
+
+/**
+ * @fn	void SoftwareMixer::destroyVoice(MixerVoice* pVoice)
+ *
+ * @brief	Removes a voice from the mix and deletes it. Queued buffers are dropped without callbacks, as
+ * 			DestroyVoice() does in XAudio2. Must not be called from a voice callback.
+ *
+ * @date	10/17/2026
+ */
+void SoftwareMixer::destroyVoice(MixerVoice* pVoice)
+{
+	lock_guard<recursive_mutex> guard(lock);
+	for(size_t i = 0; i < voices.size(); ++i){
+		if(voices[i] == pVoice){
+			voices.erase(voices.begin() + i);
+			delete pVoice;
+			return;
+		}
+	}
+}
+
+/**
+ * @fn	HRESULT SoftwareMixer::createBus(UINT32 channels, UINT32 stage, MixerBus** ppBus)
+ *
+ * @brief	Makes a new bus, sending to the mixer's output.
+ *
+ * @param	channels	 	Channels of the bus, 1 to MIXER_MAX_CHANNELS.
+ * @param	stage		 	When the bus is mixed: after every bus of a lower stage. A bus can only send to a
+ * 							bus of a higher stage than its own.
+ * @param [out]	ppBus	The new bus.
+ *
+ * @return	S_OK, E_INVALIDARG for a bad channel count or E_FAIL if init() has not been called.
+ *
+ * @date	10/17/2026
+ */
+HRESULT SoftwareMixer::createBus(UINT32 channels, UINT32 stage, MixerBus** ppBus)
+{
+	if(ppBus == NULL){
+		return E_INVALIDARG;
+	}
+	*ppBus = NULL;
+	if(sampleRate == 0){
+		return E_FAIL;
+	}
+	if(channels == 0 || channels > MIXER_MAX_CHANNELS){
+		return E_INVALIDARG;
+	}
+
+	lock_guard<recursive_mutex> guard(lock);
+	MixerBus* pBus = new MixerBus(this, channels, stage);
+	size_t i = buses.size();
+	while(i > 0 && buses[i - 1]->stage > stage){
+		--i;
+	}
+	buses.insert(buses.begin() + i, pBus);
+	*ppBus = pBus;
+	return S_OK;
+}
+
+/**
+ * @fn	void SoftwareMixer::destroyBus(MixerBus* pBus)
+ *
+ * @brief	Removes a bus and deletes it. Voices and buses still sending to it are sent to the mixer's output
+ * 			instead, with default matrices. Must not be called from a voice callback.
+ *
+ * @date	10/17/2026
+ */
+void SoftwareMixer::destroyBus(MixerBus* pBus)
+{
+	lock_guard<recursive_mutex> guard(lock);
+	vector<MixerBus*>::iterator it = find(buses.begin(), buses.end(), pBus);
+	if(it == buses.end()){
+		return;
+	}
+	buses.erase(it);
+	for(size_t i = 0; i < voices.size(); ++i){
+		if(voices[i]->pOutput == pBus){
+			voices[i]->setOutput(NULL);
+		}
+	}
+	for(size_t i = 0; i < buses.size(); ++i){
+		if(buses[i]->pOutput == pBus){
+			buses[i]->setOutput(NULL);
+		}
+	}
+	delete pBus;
+}
+
+/**
+ * @fn	FLOAT32* SoftwareMixer::getTarget(MixerBus* pBus, FLOAT32* pOut, UINT32 frames)
+ *
+ * @brief	Where something sending to pBus mixes to: the mixer output for NULL, else the bus's buffer, which
+ * 			is cleared the first time in a block that it is asked for. Called with the mixer locked.
+ *
+ * @date	10/17/2026
+ */
+FLOAT32* SoftwareMixer::getTarget(MixerBus* pBus, FLOAT32* pOut, UINT32 frames)
+{
+	if(pBus == NULL){
+		return pOut;
+	}
+	size_t samples = (size_t)frames * pBus->channels;
+	if(!pBus->active){
+		if(pBus->buffer.size() < samples){
+			pBus->buffer.resize(samples);
+		}
+		memset(&pBus->buffer[0], 0, samples * sizeof(FLOAT32));
+		pBus->active = true;
+	}
+	return &pBus->buffer[0];
+}
+
+/**
+ * @fn	void SoftwareMixer::render(FLOAT32* pOut, UINT32 frames)
+ *
+ * @brief	Mixes the next frames of output from all the running voices: each voice into its bus or the
+ * 			output, then each bus that had anything mixed into it on to its own destination, in stage order.
+ * 			There is no clock: every call advances the mix by exactly frames, however fast it is called.
+ *
+ * @param [out]	pOut	Interleaved output, frames * getChannels() floats.
+ * @param	frames  	Number of frames to mix. Callers wanting XAudio2 callback timing should use
+ * 						getQuantumFrames().
+ *
+ * @date	10/17/2026
+ */
+void SoftwareMixer::render(FLOAT32* pOut, UINT32 frames)
+{
+	lock_guard<recursive_mutex> guard(lock);
+	memset(pOut, 0, frames * channels * sizeof(FLOAT32));
+	if(scratch.size() < frames * MIXER_MAX_CHANNELS){
+		scratch.resize(frames * MIXER_MAX_CHANNELS);
+	}
+	// by index, as callbacks may create voices
+	for(size_t i = 0; i < voices.size(); ++i){
+		if(voices[i]->running){
+			voices[i]->render(getTarget(voices[i]->pOutput, pOut, frames), frames, sampleRate);
+		}
+	}
+	for(size_t i = 0; i < buses.size(); ++i){
+		MixerBus* pBus = buses[i];
+		if(pBus->active){
+			pBus->active = false;
+			if(pBus->volume != 0.0f){
+				pBus->mixInto(getTarget(pBus->pOutput, pOut, frames), frames);
+			}
+		}
+	}
+	if(masterVolume != 1.0f){
+		pKernels->scale(pOut, frames * channels, masterVolume);
+	}
+}
+
+/**
+ * @fn	UINT32 SoftwareMixer::getVoiceCount()
+ *
+ * @brief	The number of voices that exist, and the number of those that are running and have data queued.
+ *
+ * @date	10/17/2026
+ */
+UINT32 SoftwareMixer::getVoiceCount()
+{
+	lock_guard<recursive_mutex> guard(lock);
+	return (UINT32)voices.size();
+}
+
+UINT32 SoftwareMixer::getActiveVoiceCount()
+{
+	lock_guard<recursive_mutex> guard(lock);
+	UINT32 count = 0;
+	for(size_t i = 0; i < voices.size(); ++i){
+		if(voices[i]->running && !voices[i]->queue.empty()){
+			++count;
+		}
+	}
+	return count;
+}
+
+UINT32 SoftwareMixer::getBusCount()
+{
+	lock_guard<recursive_mutex> guard(lock);
+	return (UINT32)buses.size();
+}
+
+/**
+ * @fn	bool SoftwareMixer::setKernel(MIX_KERNEL kernel)
+ *
+ * @brief	Chooses the mixing kernel. The constructor picks the best one for the machine, this is for
+ * 			comparing them.
+ *
+ * @return	false if the kernel can't be used here, in which case the current one is kept.
+ *
+ * @date	10/17/2026
+ */
+bool SoftwareMixer::setKernel(MIX_KERNEL kernel)
+{
+	const MixKernels* pNew = getMixKernels(kernel);
+	if(pNew == NULL){
+		return false;
+	}
+	lock_guard<recursive_mutex> guard(lock);
+	pKernels = pNew;
+	return true;
+}
+
+/**
+ * @fn	void SoftwareMixer::toPCM16(const FLOAT32* pIn, INT16* pOut, UINT32 samples)
+ *
+ * @brief	Converts float samples to 16 bit PCM, saturating anything outside [-1, 1), with the best kernel for
+ * 			the machine.
+ *
+ * @date	10/17/2026
+ */
+void SoftwareMixer::toPCM16(const FLOAT32* pIn, INT16* pOut, UINT32 samples)
+{
+	static const MixKernels* pBest = getMixKernels(getBestMixKernel());
+	pBest->toPCM16(pIn, pOut, samples);
+}
+
+/**
+// End of SoftwareMixer.cpp
+ */
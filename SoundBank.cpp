@@ -0,0 +1,321 @@
+#include "SoundBank.h"
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+
+/**
+ * @fn	SoundBank::SoundBank(void)
+ *
+ * @brief	Constructor. Banks are made by open(), never directly.
+ *
+ * @date	10/17/2026
+ */
+SoundBank::SoundBank(void) : refCount(1)
+{
+	pBase = NULL;
+	pHeader = NULL;
+	pEntries = NULL;
+}
+
+SoundBank::~SoundBank(void)
+{
+	file.close();
+}
+
+/**
+ * @fn	HRESULT SoundBank::open(const PATH_CHAR* szPath, SoundBank** ppBank)
+ *
+ * @brief	Maps a bank file and checks that its index is sound. Nothing else is read.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szPath		   	Path of the bank.
+ * @param [out]	ppBank	Receives the bank with a reference count of one.
+ *
+ * @return	S_OK, the error from mapping the file, or E_FAIL if it is not a bank this version can read.
+ */
+HRESULT SoundBank::open(const PATH_CHAR* szPath, SoundBank** ppBank)
+{
+	if(szPath == NULL || ppBank == NULL)
+		return E_INVALIDARG;
+	*ppBank = NULL;
+
+	SoundBank* pBank = new SoundBank();
+	HRESULT hr = pBank->file.open(szPath, false);
+	if(SUCCEEDED(hr))
+		hr = pBank->validate();
+	if(FAILED(hr)){
+		delete pBank;
+		return hr;
+	}
+	pBank->path = PcmAssetCache::canonicalPath(szPath);
+	*ppBank = pBank;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT SoundBank::validate()
+ *
+ * @brief	Checks the header, and that every entry's name, format and data lie inside the file, so that the
+ * 			accessors need no checks of their own.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_FAIL.
+ */
+HRESULT SoundBank::validate()
+{
+	pBase = file.getData();
+	size_t size = file.getSize();
+	if(size < sizeof(SoundBankHeader))
+		return E_FAIL;
+	pHeader = (const SoundBankHeader*)pBase;
+	if(memcmp(pHeader->magic, SOUND_BANK_MAGIC, 4) != 0 || pHeader->version != SOUND_BANK_VERSION)
+		return E_FAIL;
+	if(pHeader->fileBytes != size || pHeader->indexBytes > size)
+		return E_FAIL;
+	if(sizeof(SoundBankHeader) + (UINT64)pHeader->entryCount * sizeof(SoundBankEntry) > pHeader->indexBytes)
+		return E_FAIL;
+	pEntries = (const SoundBankEntry*)(pBase + sizeof(SoundBankHeader));
+
+	for(UINT32 i = 0; i < pHeader->entryCount; ++i){
+		const SoundBankEntry& e = pEntries[i];
+		if((UINT64)e.nameOffset + e.nameBytes + 1 > pHeader->indexBytes || pBase[e.nameOffset + e.nameBytes] != 0)
+			return E_FAIL;
+		if(e.formatBytes < sizeof(WAVEFORMATEX) || (UINT64)e.formatOffset + e.formatBytes > pHeader->indexBytes)
+			return E_FAIL;
+		if(sizeof(WAVEFORMATEX) + getFormat(i)->cbSize > e.formatBytes)
+			return E_FAIL;
+		if(e.dataOffset < pHeader->indexBytes || e.dataOffset + e.dataBytes > size)
+			return E_FAIL;
+	}
+	return S_OK;
+}
+
+ULONG SoundBank::AddRef()
+{
+	return (ULONG)++refCount;
+}
+
+/**
+ * @fn	ULONG SoundBank::Release()
+ *
+ * @brief	Drops a reference, and unmaps and deletes the bank with the last one.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The new reference count.
+ */
+ULONG SoundBank::Release()
+{
+	LONG count = --refCount;
+	if(count == 0)
+		delete this;
+	return (ULONG)count;
+}
+
+/**
+ * @fn	string SoundBank::normalizeName(const char* szName)
+ *
+ * @brief	The form names are stored and looked up in: ASCII letters in lower case, backslashes turned into
+ * 			slashes, and any leading "./" dropped.
+ *
+ * @date	10/17/2026
+ */
+string SoundBank::normalizeName(const char* szName)
+{
+	string name;
+	for(const char* p = szName; *p != 0; ++p){
+		char c = *p;
+		if(c == '\\')
+			c = '/';
+		else if(c >= 'A' && c <= 'Z')
+			c = (char)(c - 'A' + 'a');
+		name += c;
+	}
+	while(name.compare(0, 2, "./") == 0){
+		name.erase(0, 2);
+	}
+	return name;
+}
+
+/**
+ * @fn	UINT64 SoundBank::hashName(const string& normalized)
+ *
+ * @brief	64 bit FNV-1a of a normalized name.
+ *
+ * @date	10/17/2026
+ */
+UINT64 SoundBank::hashName(const string& normalized)
+{
+	UINT64 hash = 14695981039346656037ULL;
+	for(size_t i = 0; i < normalized.size(); ++i){
+		hash ^= (BYTE)normalized[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * @fn	INT32 SoundBank::find(const char* szName)
+ *
+ * @brief	Finds a sound by name.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szName	The name, in any case and with either kind of slash.
+ *
+ * @return	The index of the sound, or -1 if the bank doesn't have it.
+ */
+INT32 SoundBank::find(const char* szName)
+{
+	if(szName == NULL)
+		return -1;
+	string name = normalizeName(szName);
+	UINT64 hash = hashName(name);
+
+	// the first entry with this hash, then any others that share it
+	UINT32 lo = 0;
+	UINT32 hi = pHeader->entryCount;
+	while(lo < hi){
+		UINT32 mid = lo + (hi - lo) / 2;
+		if(pEntries[mid].nameHash < hash)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for(UINT32 i = lo; i < pHeader->entryCount && pEntries[i].nameHash == hash; ++i){
+		if(pEntries[i].nameBytes == name.size() && memcmp(getName(i), name.c_str(), name.size()) == 0)
+			return (INT32)i;
+	}
+	return -1;
+}
+
+#ifdef _WIN32
+INT32 SoundBank::find(const wchar_t* szName)
+{
+	if(szName == NULL)
+		return -1;
+	// names are written by the builder as they appear in the file system, UTF-8
+	char utf8[MAX_PATH * 3];
+	if(WideCharToMultiByte(CP_UTF8, 0, szName, -1, utf8, sizeof(utf8), NULL, NULL) == 0)
+		return -1;
+	return find(utf8);
+}
+#endif
+
+/**
+ * @fn	HRESULT writeSoundBank(const char* szPath, const vector<SoundBankSource>& sounds)
+ *
+ * @brief	Writes a bank: the header, the index sorted by name hash, the names and formats, then each sound's
+ * 			data on a SOUND_BANK_ALIGNMENT boundary.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szPath	Path of the bank to write.
+ * @param	sounds	The sounds. Names are normalized, and must be unique once they are.
+ *
+ * @return	S_OK, E_INVALIDARG for a duplicate name or a missing format, or E_FAIL if the file can't be
+ * 			written.
+ */
+HRESULT writeSoundBank(const char* szPath, const vector<SoundBankSource>& sounds)
+{
+	struct Item
+	{
+		string name;
+		const SoundBankSource* pSource;
+		SoundBankEntry entry;
+
+		bool operator<(const Item& other) const {
+			return (entry.nameHash != other.entry.nameHash) ? entry.nameHash < other.entry.nameHash : name < other.name;
+		};
+	};
+
+	vector<Item> items(sounds.size());
+	for(size_t i = 0; i < sounds.size(); ++i){
+		if(sounds[i].pFormat == NULL || (sounds[i].pData == NULL && sounds[i].dataBytes > 0))
+			return E_INVALIDARG;
+		items[i].name = SoundBank::normalizeName(sounds[i].name.c_str());
+		if(items[i].name.empty() || items[i].name.size() > 0xFFFF)
+			return E_INVALIDARG;
+		items[i].pSource = &sounds[i];
+		memset(&items[i].entry, 0, sizeof(SoundBankEntry));
+		items[i].entry.nameHash = SoundBank::hashName(items[i].name);
+	}
+	sort(items.begin(), items.end());
+	for(size_t i = 1; i < items.size(); ++i){
+		if(items[i].name == items[i - 1].name)
+			return E_INVALIDARG;
+	}
+
+	// lay out the index, then the data
+	UINT64 offset = sizeof(SoundBankHeader) + items.size() * sizeof(SoundBankEntry);
+	for(size_t i = 0; i < items.size(); ++i){
+		items[i].entry.nameOffset = (UINT32)offset;
+		items[i].entry.nameBytes = (WORD)items[i].name.size();
+		offset += items[i].name.size() + 1;
+	}
+	for(size_t i = 0; i < items.size(); ++i){
+		offset = (offset + 3) & ~(UINT64)3;
+		items[i].entry.formatOffset = (UINT32)offset;
+		items[i].entry.formatBytes = (WORD)(sizeof(WAVEFORMATEX) + items[i].pSource->pFormat->cbSize);
+		offset += items[i].entry.formatBytes;
+	}
+	if(offset > 0xFFFFFFFF)
+		return E_INVALIDARG;
+	UINT32 indexBytes = (UINT32)offset;
+	for(size_t i = 0; i < items.size(); ++i){
+		offset = (offset + SOUND_BANK_ALIGNMENT - 1) & ~(UINT64)(SOUND_BANK_ALIGNMENT - 1);
+		items[i].entry.dataOffset = offset;
+		items[i].entry.dataBytes = items[i].pSource->dataBytes;
+		items[i].entry.factFrames = items[i].pSource->factFrames;
+		offset += items[i].pSource->dataBytes;
+	}
+
+	SoundBankHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SOUND_BANK_MAGIC, 4);
+	header.version = SOUND_BANK_VERSION;
+	header.entryCount = (UINT32)items.size();
+	header.indexBytes = indexBytes;
+	header.fileBytes = offset;
+
+	FILE* f = fopen(szPath, "wb");
+	if(f == NULL)
+		return E_FAIL;
+	static const BYTE zeros[SOUND_BANK_ALIGNMENT] = { 0 };
+	UINT64 written = 0;
+	fwrite(&header, sizeof(header), 1, f);
+	written += sizeof(header);
+	for(size_t i = 0; i < items.size(); ++i){
+		fwrite(&items[i].entry, sizeof(SoundBankEntry), 1, f);
+		written += sizeof(SoundBankEntry);
+	}
+	for(size_t i = 0; i < items.size(); ++i){
+		fwrite(items[i].name.c_str(), 1, items[i].name.size() + 1, f);
+		written += items[i].name.size() + 1;
+	}
+	for(size_t i = 0; i < items.size(); ++i){
+		fwrite(zeros, 1, (size_t)(items[i].entry.formatOffset - written), f);
+		fwrite(items[i].pSource->pFormat, 1, items[i].entry.formatBytes, f);
+		written = items[i].entry.formatOffset + items[i].entry.formatBytes;
+	}
+	for(size_t i = 0; i < items.size(); ++i){
+		fwrite(zeros, 1, (size_t)(items[i].entry.dataOffset - written), f);
+		if(items[i].entry.dataBytes > 0)
+			fwrite(items[i].pSource->pData, 1, items[i].entry.dataBytes, f);
+		written = items[i].entry.dataOffset + items[i].entry.dataBytes;
+	}
+	bool ok = (ferror(f) == 0);
+	if(fclose(f) != 0)
+		ok = false;
+	if(!ok){
+		remove(szPath);
+		return E_FAIL;
+	}
+	return S_OK;
+}
+
+/**
+// End of SoundBank.cpp
+ */
@@ -0,0 +1,170 @@
+/**
+ * @file	SoundBankBuilder.cpp
+ *
+ * @brief	Packs WAV files into a sound bank for SoundBank / BasicAudio::loadSoundBank(). Each file is parsed
+ * 			once, here, and its format and sample data are copied into the bank as they are: nothing is
+ * 			converted, so ADPCM stays compressed and integer PCM is still converted at load.
+ *
+ * 			SoundBankBuilder -o Wavs/sounds.bank Wavs
+ * 			SoundBankBuilder -o level1.bank --root assets assets/level1 assets/common/click.wav
+ *
+ * 			A sound's name is its path relative to the root (the current directory unless --root is given),
+ * 			which is what the game passes to createSound(): the first example stores "wavs/heli.wav", found
+ * 			by createSound(L"heli", L"Wavs\\heli.wav", 0).
+ */
+
+#include "PortableTypes.h"
+#include "MappedWaveFile.h"
+#include "SoundBank.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <strings.h>
+
+using namespace std;
+
+static bool isDirectory(const string& path)
+{
+	struct stat st;
+	return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+/**
+ * @fn	static void addPath(const string& path, vector<string>* pFiles)
+ *
+ * @brief	Adds a WAV file, or every WAV file under a directory.
+ */
+static void addPath(const string& path, vector<string>* pFiles)
+{
+	if(!isDirectory(path)){
+		pFiles->push_back(path);
+		return;
+	}
+	DIR* d = opendir(path.c_str());
+	if(d == NULL)
+		return;
+	vector<string> entries;
+	struct dirent* e;
+	while((e = readdir(d)) != NULL){
+		string name = e->d_name;
+		if(name == "." || name == "..")
+			continue;
+		string child = path + "/" + name;
+		if(isDirectory(child))
+			entries.push_back(child);
+		else if(name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0)
+			entries.push_back(child);
+	}
+	closedir(d);
+	sort(entries.begin(), entries.end());
+	for(size_t i = 0; i < entries.size(); ++i){
+		addPath(entries[i], pFiles);
+	}
+}
+
+/**
+ * @fn	static string relativeName(const string& path, const string& root)
+ *
+ * @brief	The path with the root taken off the front, if it is there.
+ */
+static string relativeName(const string& path, const string& root)
+{
+	string r = root;
+	while(r.size() > 1 && r[r.size() - 1] == '/'){
+		r.erase(r.size() - 1);
+	}
+	if(r.empty() || r == ".")
+		return path;
+	if(path.compare(0, r.size(), r) == 0 && path.size() > r.size() && path[r.size()] == '/')
+		return path.substr(r.size() + 1);
+	return path;
+}
+
+static void usage()
+{
+	fprintf(stderr,
+		"usage: SoundBankBuilder -o BANK [--root DIR] FILE|DIR...\n"
+		"  -o BANK       the bank to write\n"
+		"  --root DIR    sound names are paths relative to DIR (default the current directory)\n"
+		"  FILE|DIR      WAV files, or directories to search for them\n");
+}
+
+int main(int argc, char* argv[])
+{
+	string outFile;
+	string root;
+	vector<string> inputs;
+	for(int i = 1; i < argc; ++i){
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if(arg == "-o" && hasValue){
+			outFile = argv[++i];
+		}else if(arg == "--root" && hasValue){
+			root = argv[++i];
+		}else if(!arg.empty() && arg[0] == '-'){
+			usage();
+			return 2;
+		}else{
+			inputs.push_back(arg);
+		}
+	}
+	if(outFile.empty() || inputs.empty()){
+		usage();
+		return 2;
+	}
+
+	vector<string> files;
+	for(size_t i = 0; i < inputs.size(); ++i){
+		addPath(inputs[i], &files);
+	}
+
+	// every file stays mapped until the bank is written
+	vector<MappedWaveFile*> waves;
+	vector<SoundBankSource> sources;
+	UINT64 dataBytes = 0;
+	int failed = 0;
+	for(size_t i = 0; i < files.size(); ++i){
+		MappedWaveFile* pWave = new MappedWaveFile();
+		HRESULT hr = pWave->open(files[i].c_str());
+		if(FAILED(hr)){
+			fprintf(stderr, "can't read %s: %#X\n", files[i].c_str(), (unsigned)hr);
+			delete pWave;
+			failed++;
+			continue;
+		}
+		waves.push_back(pWave);
+		SoundBankSource source;
+		source.name = relativeName(files[i], root);
+		source.pFormat = pWave->getFormat();
+		source.pData = pWave->getData();
+		source.dataBytes = pWave->getSize();
+		source.factFrames = pWave->getFactFrames();
+		sources.push_back(source);
+		dataBytes += source.dataBytes;
+	}
+
+	HRESULT hr = (failed == 0) ? writeSoundBank(outFile.c_str(), sources) : E_FAIL;
+	for(size_t i = 0; i < waves.size(); ++i){
+		delete waves[i];
+	}
+	if(failed > 0){
+		fprintf(stderr, "%d file%s could not be read, no bank written\n", failed, (failed == 1) ? "" : "s");
+		return 1;
+	}
+	if(FAILED(hr)){
+		fprintf(stderr, "can't write %s: %#X%s\n", outFile.c_str(), (unsigned)hr,
+			(hr == E_INVALIDARG) ? " (two files with the same name?)" : "");
+		return 1;
+	}
+	fprintf(stderr, "%s: %u sounds, %llu bytes of sample data\n", outFile.c_str(), (unsigned)sources.size(),
+		(unsigned long long)dataBytes);
+	return 0;
+}
+
+/**
+// End of SoundBankBuilder.cpp
+ */
@@ -0,0 +1,933 @@
+#include "Spatializer.h"
+#include "AlignedAlloc.h"
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPATIALIZER_HAS_SSE 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#define SPATIALIZER_HAS_AVX 1
+#include <immintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+#define TWO_PI ((FLOAT32)(2.0 * M_PI))
+
+// atan on [0, tan(pi / 8)] and sin on [0, pi / 2] for the vector kernels: Cephes' atanf polynomial and the
+// Taylor series of sin to the 11th power, both within a few float ulps there
+#define ATAN_C3 -3.33329491539e-1f
+#define ATAN_C5 1.99777106478e-1f
+#define ATAN_C7 -1.38776856032e-1f
+#define ATAN_C9 8.05374449538e-2f
+#define TAN_PI_8 0.414213562f
+
+// Defaults, matching SampleSound::initEmitter() (X3DAudioDefault_LinearCurve and Emitter_Reverb_Curve) and the
+// LPF direct curve X3DAudio uses when pLPFDirectCurve is NULL
+static const SpatialCurvePoint defaultVolumeCurve[] = { {0.0f, 1.0f}, {1.0f, 0.0f} };
+static const SpatialCurvePoint defaultReverbCurve[] = { {0.0f, 0.5f}, {0.75f, 1.0f}, {1.0f, 0.0f} };
+static const SpatialCurvePoint defaultLPFDirectCurve[] = { {0.0f, 1.0f}, {1.0f, 0.75f} };
+
+/**
+ * @fn	Spatializer::Spatializer(void)
+ *
+ * @brief	Default constructor. Stereo output, listener at the origin facing +Z with +Y up, default curves and
+ * 			the widest kernel that was compiled in.
+ *
+ * @date	10/17/2026
+ */
+Spatializer::Spatializer(void)
+{
+	localX = localZ = volume = spread = NULL;
+	pairIndex = nearWeight = farWeight = NULL;
+	scratchCapacity = 0;
+	speedOfSound = SPATIALIZER_SPEED_OF_SOUND;
+
+	setCurve(&volumeCurve, defaultVolumeCurve, 2);
+	setCurve(&reverbCurve, defaultReverbCurve, 3);
+	setCurve(&lpfDirectCurve, defaultLPFDirectCurve, 2);
+
+	SpatialListener l = { {0, 0, 0}, {0, 0, 0}, {0, 0, 1}, {0, 1, 0} };
+	setListener(l);
+	setSpeakers(SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT, 2);
+
+	kernel = SPATIALIZER_KERNEL_SCALAR;
+	if(!setKernel(SPATIALIZER_KERNEL_AVX))
+		setKernel(SPATIALIZER_KERNEL_SSE);
+}
+
+Spatializer::~Spatializer(void)
+{
+	reserveScratch(0);
+}
+
+/**
+ * @fn	bool Spatializer::isKernelAvailable(SPATIALIZER_KERNEL kernel)
+ *
+ * @brief	Tells if a kernel was compiled in. The SSE kernel needs SSE2 (always there on x64), the AVX kernel
+ * 			needs the build to target AVX (/arch:AVX or -mavx).
+ *
+ * @date	10/17/2026
+ */
+bool Spatializer::isKernelAvailable(SPATIALIZER_KERNEL kernel)
+{
+	switch(kernel){
+		case SPATIALIZER_KERNEL_SCALAR:
+			return true;
+#ifdef SPATIALIZER_HAS_SSE
+		case SPATIALIZER_KERNEL_SSE:
+			return true;
+#endif
+#ifdef SPATIALIZER_HAS_AVX
+		case SPATIALIZER_KERNEL_AVX:
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+bool Spatializer::setKernel(SPATIALIZER_KERNEL kernel)
+{
+	if(!isKernelAvailable(kernel))
+		return false;
+	this->kernel = kernel;
+	return true;
+}
+
+/**
+ * @fn	bool Spatializer::setCurve(Curve* pCurve, const SpatialCurvePoint* pPoints, UINT32 count)
+ *
+ * @brief	Prepares a distance curve. As with X3DAudio, the points must be in increasing distance, the first at
+ * 			0 and the last at 1. Beyond the last point the last setting holds.
+ *
+ * @date	10/17/2026
+ *
+ * @return	false, leaving the curve unchanged, if there are too few or too many points.
+ */
+bool Spatializer::setCurve(Curve* pCurve, const SpatialCurvePoint* pPoints, UINT32 count)
+{
+	if(pPoints == NULL || count < 1 || count > SPATIALIZER_MAX_CURVE_POINTS)
+		return false;
+
+	pCurve->segments = count - 1;
+	pCurve->firstSetting = pPoints[0].setting;
+	for(UINT32 k = 0; k + 1 < count; ++k){
+		FLOAT32 length = pPoints[k + 1].distance - pPoints[k].distance;
+		pCurve->start[k] = pPoints[k].distance;
+		pCurve->invLength[k] = (length > 0) ? 1.0f / length : 0.0f;
+		pCurve->base[k] = pPoints[k].setting;
+		pCurve->rise[k] = pPoints[k + 1].setting - pPoints[k].setting;
+	}
+	return true;
+}
+
+/**
+ * @fn	FLOAT32 Spatializer::evaluate(const Curve& curve, FLOAT32 x)
+ *
+ * @brief	Evaluates a curve at a normalized distance. Written the same way as the vector versions: every
+ * 			segment whose start has been passed overrides the result.
+ *
+ * @date	10/17/2026
+ */
+FLOAT32 Spatializer::evaluate(const Curve& curve, FLOAT32 x)
+{
+	FLOAT32 v = curve.firstSetting;
+	for(UINT32 k = 0; k < curve.segments; ++k){
+		if(x >= curve.start[k]){
+			FLOAT32 t = (x - curve.start[k]) * curve.invLength[k];
+			t = (t < 0) ? 0 : ((t > 1) ? 1 : t);
+			v = curve.base[k] + t * curve.rise[k];
+		}
+	}
+	return v;
+}
+
+/**
+ * @fn	void Spatializer::setListener(const SpatialListener& listener)
+ *
+ * @brief	Sets the listener and works out its right vector.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::setListener(const SpatialListener& listener)
+{
+	this->listener = listener;
+	const FLOAT32* t = listener.top;
+	const FLOAT32* f = listener.front;
+	right[0] = t[1] * f[2] - t[2] * f[1];
+	right[1] = t[2] * f[0] - t[0] * f[2];
+	right[2] = t[0] * f[1] - t[1] * f[0];
+}
+
+/**
+ * @fn	void Spatializer::setSpeakers(DWORD channelMask, UINT32 channelCount)
+ *
+ * @brief	Sets up the output speakers from a channel mask, with the same azimuths X3DAudio uses. If the mask
+ * 			is 0 a usual layout for the channel count is assumed.
+ *
+ * @date	10/17/2026
+ *
+ * @param	channelMask 	The SPEAKER_ bits, one per channel in bit order.
+ * @param	channelCount	Number of output channels.
+ */
+void Spatializer::setSpeakers(DWORD channelMask, UINT32 channelCount)
+{
+	static const FLOAT32 azimuths[11] = {
+		7 * TWO_PI / 8,     // FRONT_LEFT
+		TWO_PI / 8,         // FRONT_RIGHT
+		0,                  // FRONT_CENTER
+		-1,                 // LOW_FREQUENCY, not panned
+		5 * TWO_PI / 8,     // BACK_LEFT
+		3 * TWO_PI / 8,     // BACK_RIGHT
+		15 * TWO_PI / 16,   // FRONT_LEFT_OF_CENTER
+		TWO_PI / 16,        // FRONT_RIGHT_OF_CENTER
+		TWO_PI / 2,         // BACK_CENTER
+		3 * TWO_PI / 4,     // SIDE_LEFT
+		TWO_PI / 4          // SIDE_RIGHT
+	};
+
+	if(channelCount > 32)
+		channelCount = 32;
+	if(channelMask == 0){
+		switch(channelCount){
+			case 1: channelMask = SPEAKER_FRONT_CENTER; break;
+			case 2: channelMask = SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT; break;
+			case 4: channelMask = SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT | SPEAKER_BACK_LEFT | SPEAKER_BACK_RIGHT; break;
+			case 6: channelMask = 0x3F; break;  // 5.1
+			case 8: channelMask = 0x63F; break; // 7.1
+		}
+	}
+	this->channelCount = channelCount;
+
+	// Channels are assigned to mask bits in order. Anything not on the horizontal ring is left out of panning
+	ringCount = 0;
+	lfeChannel = -1;
+	UINT32 channel = 0;
+	for(UINT32 bit = 0; bit < 32 && channel < channelCount; ++bit){
+		if((channelMask & (1u << bit)) == 0)
+			continue;
+		if((1u << bit) == SPEAKER_LOW_FREQUENCY)
+			lfeChannel = (INT32)channel;
+		if(bit < 11 && azimuths[bit] >= 0){
+			UINT32 j = ringCount++;
+			while(j > 0 && ringAzimuth[j - 1] > azimuths[bit]){
+				ringAzimuth[j] = ringAzimuth[j - 1];
+				ringChannel[j] = ringChannel[j - 1];
+				--j;
+			}
+			ringAzimuth[j] = azimuths[bit];
+			ringChannel[j] = channel;
+		}
+		channel++;
+	}
+}
+
+void Spatializer::reserveScratch(UINT32 capacity)
+{
+	if(capacity != 0 && capacity <= scratchCapacity)
+		return;
+	FLOAT32** scratch[7] = { &localX, &localZ, &volume, &spread, &pairIndex, &nearWeight, &farWeight };
+	for(int s = 0; s < 7; ++s){
+		if(*scratch[s] != NULL)
+			alignedFree(*scratch[s]);
+		*scratch[s] = (capacity > 0) ? (FLOAT32*)alignedAlloc(capacity * sizeof(FLOAT32), SIMD_ALIGNMENT) : NULL;
+	}
+	scratchCapacity = capacity;
+}
+
+/**
+ * @fn	void Spatializer::process(EmitterSoA* pEmitters, WorkerPool* pWorkers)
+ *
+ * @brief	Computes Doppler, distance, reverb level, LPF direct coefficient and the output matrix of every
+ * 			emitter in the store. The store's matrices are reshaped for this channel count if needed.
+ * 			Panning, the per-emitter part, is skipped for emitters without EMITTER_DIRTY_INPUT, whose
+ * 			matrices are still those of their unchanged inputs. The dirty flags themselves are left alone.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pEmitters	The emitters.
+ * @param [in,out]	pWorkers 	If not NULL, the store is split over these threads and the caller's.
+ */
+void Spatializer::process(EmitterSoA* pEmitters, WorkerPool* pWorkers)
+{
+	prepare(pEmitters);
+	if(pWorkers == NULL){
+		processRange(pEmitters, 0, pEmitters->getCount());
+		return;
+	}
+	pWorkers->parallelFor(pEmitters->getCount(), SPATIALIZER_TASK_GRAIN, [this, pEmitters](UINT32 begin, UINT32 end){
+		processRange(pEmitters, begin, end);
+	});
+}
+
+/**
+ * @fn	void Spatializer::prepare(EmitterSoA* pEmitters)
+ *
+ * @brief	The part of process() that must come before any processRange(): shapes the store's matrices and
+ * 			sizes the scratch arrays for it.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::prepare(EmitterSoA* pEmitters)
+{
+	if(pEmitters->getDstChannels() != channelCount)
+		pEmitters->setMatrixSize(pEmitters->getSrcChannels(), channelCount);
+	reserveScratch(pEmitters->getCapacity());
+}
+
+/**
+ * @fn	void Spatializer::processRange(EmitterSoA* pEmitters, UINT32 begin, UINT32 end)
+ *
+ * @brief	process() for the emitters [begin, end) only. Ranges that don't overlap may be processed on
+ * 			different threads at the same time. begin must be a multiple of EmitterSoA::EMITTER_SOA_GRANULE,
+ * 			and so must end unless it is the emitter count, because the vector kernels run on to the next
+ * 			whole vector.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::processRange(EmitterSoA* pEmitters, UINT32 begin, UINT32 end)
+{
+	UINT32 count = pEmitters->getCount();
+	if(end > count)
+		end = count;
+	if(begin >= end)
+		return;
+
+	// The vector kernels run whole iterations into the padding at the end of the arrays, which the store
+	// guarantees is there (its capacity is a multiple of 16)
+	switch(kernel){
+		case SPATIALIZER_KERNEL_AVX:
+			processAVX(pEmitters, begin, (end + 15) & ~15u);
+			break;
+		case SPATIALIZER_KERNEL_SSE:
+			processSSE(pEmitters, begin, (end + 7) & ~7u);
+			break;
+		default:
+			processScalar(pEmitters, begin, end);
+			break;
+	}
+
+	for(UINT32 i = begin; i < end; ++i){
+		if(!pEmitters->spatialized[i] || !(pEmitters->dirty[i] & EmitterSoA::EMITTER_DIRTY_INPUT))
+			continue;
+		switch(pEmitters->getChannelCount(i)){
+			case 1: pan<1>(pEmitters, i); break;
+			case 2: pan<2>(pEmitters, i); break;
+			case 6: pan<6>(pEmitters, i); break;
+			default: pan<0>(pEmitters, i); break;
+		}
+	}
+}
+
+/**
+ * @fn	void Spatializer::processScalar(EmitterSoA* e, UINT32 begin, UINT32 end)
+ *
+ * @brief	The reference version of the per-emitter math, one emitter at a time.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::processScalar(EmitterSoA* e, UINT32 begin, UINT32 end)
+{
+	const FLOAT32* lp = listener.position;
+	const FLOAT32* lv = listener.velocity;
+	const FLOAT32* f = listener.front;
+	const FLOAT32* r = right;
+
+	for(UINT32 i = begin; i < end; ++i){
+		FLOAT32 dx = e->posX[i] - lp[0];
+		FLOAT32 dy = e->posY[i] - lp[1];
+		FLOAT32 dz = e->posZ[i] - lp[2];
+
+		localX[i] = dx * r[0] + dy * r[1] + dz * r[2];
+		localZ[i] = dx * f[0] + dy * f[1] + dz * f[2];
+
+		FLOAT32 dist = sqrtf(dx * dx + dy * dy + dz * dz);
+		FLOAT32 scaler = e->curveDistanceScaler[i];
+		FLOAT32 nd = dist / ((scaler > FLT_MIN) ? scaler : FLT_MIN);
+
+		volume[i] = evaluate(volumeCurve, nd);
+		e->reverbLevel[i] = evaluate(reverbCurve, nd);
+		e->lpfDirect[i] = evaluate(lpfDirectCurve, nd);
+		e->distance[i] = dist;
+
+		// Velocities projected onto the emitter to listener direction, which is -d
+		FLOAT32 invDist = (dist > 0) ? 1.0f / dist : 0.0f;
+		FLOAT32 emitterComponent = -(dx * e->velX[i] + dy * e->velY[i] + dz * e->velZ[i]) * invDist;
+		FLOAT32 listenerComponent = -(dx * lv[0] + dy * lv[1] + dz * lv[2]) * invDist;
+		FLOAT32 ds = e->dopplerScaler[i];
+		FLOAT32 num = speedOfSound - listenerComponent * ds;
+		FLOAT32 den = speedOfSound - emitterComponent * ds;
+		num = (num > 0) ? num : 0;
+		den = (den > speedOfSound * FLT_EPSILON) ? den : speedOfSound * FLT_EPSILON;
+		FLOAT32 dop = num / den;
+		e->doppler[i] = (dop < SPATIALIZER_MAX_DOPPLER) ? dop : SPATIALIZER_MAX_DOPPLER;
+
+		FLOAT32 ir = e->innerRadius[i];
+		FLOAT32 s = (ir > 0) ? 1.0f - dist / ir : 0.0f;
+		spread[i] = (s > 0) ? s : 0;
+
+		// the vector kernels work out every lane's direction as it costs them nothing extra; one at a time,
+		// only the emitters pan() will look at are worth the atan2
+		if(ringCount > 1 && e->spatialized[i] && (e->dirty[i] & EmitterSoA::EMITTER_DIRTY_INPUT)){
+			UINT32 pair;
+			direction(localX[i], localZ[i], &pair, nearWeight + i, farWeight + i);
+			pairIndex[i] = (FLOAT32)pair;
+		}
+	}
+}
+
+#ifdef SPATIALIZER_HAS_SSE
+
+static inline __m128 curveSSE(const Spatializer::Curve& c, __m128 x)
+{
+	__m128 v = _mm_set1_ps(c.firstSetting);
+	for(UINT32 k = 0; k < c.segments; ++k){
+		__m128 start = _mm_set1_ps(c.start[k]);
+		__m128 t = _mm_mul_ps(_mm_sub_ps(x, start), _mm_set1_ps(c.invLength[k]));
+		t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		__m128 seg = _mm_add_ps(_mm_set1_ps(c.base[k]), _mm_mul_ps(t, _mm_set1_ps(c.rise[k])));
+		__m128 mask = _mm_cmpge_ps(x, start);
+		v = _mm_or_ps(_mm_and_ps(mask, seg), _mm_andnot_ps(mask, v));
+	}
+	return v;
+}
+
+static inline __m128 selectSSE(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/**
+ * @fn	static inline __m128 azimuthSSE(__m128 x, __m128 z)
+ *
+ * @brief	atan2f(x, z) moved into [0, 2 pi), as Spatializer::direction() has it. The angle is folded into
+ * 			the first eighth of a turn for the polynomial, then unfolded by the signs and sizes of x and z.
+ *
+ * @date	10/17/2026
+ */
+static inline __m128 azimuthSSE(__m128 x, __m128 z)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	__m128 ax = _mm_andnot_ps(signBit, x);
+	__m128 az = _mm_andnot_ps(signBit, z);
+	__m128 r = _mm_div_ps(_mm_min_ps(ax, az), _mm_max_ps(_mm_max_ps(ax, az), _mm_set1_ps(FLT_MIN)));
+
+	// past tan(pi / 8), atan(r) = pi / 4 + atan((r - 1) / (r + 1))
+	__m128 big = _mm_cmpgt_ps(r, _mm_set1_ps(TAN_PI_8));
+	r = selectSSE(big, _mm_div_ps(_mm_sub_ps(r, one), _mm_add_ps(r, one)), r);
+	__m128 r2 = _mm_mul_ps(r, r);
+	__m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_C9), r2), _mm_set1_ps(ATAN_C7));
+	p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(ATAN_C5));
+	p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(ATAN_C3));
+	__m128 a = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r2), r), r);
+	a = _mm_add_ps(a, _mm_and_ps(big, _mm_set1_ps((FLOAT32)(M_PI / 4))));
+
+	a = selectSSE(_mm_cmpgt_ps(ax, az), _mm_sub_ps(_mm_set1_ps((FLOAT32)(M_PI / 2)), a), a);
+	a = selectSSE(_mm_cmplt_ps(z, zero), _mm_sub_ps(_mm_set1_ps((FLOAT32)M_PI), a), a);
+	return selectSSE(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(TWO_PI), a), a);
+}
+
+/**
+ * @fn	static inline __m128 sinQuarterSSE(__m128 t)
+ *
+ * @brief	sinf(t * pi / 2) for t in [0, 1].
+ *
+ * @date	10/17/2026
+ */
+static inline __m128 sinQuarterSSE(__m128 t)
+{
+	__m128 u = _mm_mul_ps(t, _mm_set1_ps((FLOAT32)(M_PI / 2)));
+	__m128 u2 = _mm_mul_ps(u, u);
+	__m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.0f / 39916800.0f), u2), _mm_set1_ps(1.0f / 362880.0f));
+	p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(-1.0f / 5040.0f));
+	p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(1.0f / 120.0f));
+	p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(-1.0f / 6.0f));
+	p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(1.0f));
+	return _mm_mul_ps(p, u);
+}
+
+/**
+ * @fn	static inline void directionSSE(__m128 x, __m128 z, const FLOAT32* ringAzimuth, UINT32 ringCount,
+ * 		FLOAT32* pPair, FLOAT32* pNear, FLOAT32* pFar)
+ *
+ * @brief	Spatializer::direction() for four sounds. Each lane counts the speakers at or before its azimuth
+ * 			to find its pair, then picks the pair's azimuths out of the ring by comparing its index with
+ * 			every speaker's, so the ring is never indexed per lane.
+ *
+ * @date	10/17/2026
+ */
+static inline void directionSSE(__m128 x, __m128 z, const FLOAT32* ringAzimuth, UINT32 ringCount, FLOAT32* pPair, FLOAT32* pNear, FLOAT32* pFar)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 twoPi = _mm_set1_ps(TWO_PI);
+	__m128 azimuth = azimuthSSE(x, z);
+
+	// the last speaker at or before the sound, or the last of all if there is none, as for the scalar search
+	__m128 passed = zero;
+	for(UINT32 j = 0; j < ringCount; ++j)
+		passed = _mm_add_ps(passed, _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(ringAzimuth[j]), azimuth), one));
+	__m128 pair = selectSSE(_mm_cmpeq_ps(passed, zero), _mm_set1_ps((FLOAT32)(ringCount - 1)), _mm_sub_ps(passed, one));
+
+	__m128 from = zero, to = zero;
+	for(UINT32 j = 0; j < ringCount; ++j){
+		__m128 mask = _mm_cmpeq_ps(pair, _mm_set1_ps((FLOAT32)j));
+		from = _mm_or_ps(from, _mm_and_ps(mask, _mm_set1_ps(ringAzimuth[j])));
+		to = _mm_or_ps(to, _mm_and_ps(mask, _mm_set1_ps(ringAzimuth[(j + 1) % ringCount])));
+	}
+	__m128 span = _mm_sub_ps(to, from);
+	span = _mm_add_ps(span, _mm_and_ps(_mm_cmple_ps(span, zero), twoPi));
+	__m128 offset = _mm_sub_ps(azimuth, from);
+	offset = _mm_add_ps(offset, _mm_and_ps(_mm_cmplt_ps(offset, zero), twoPi));
+	__m128 t = _mm_div_ps(offset, span);
+
+	_mm_store_ps(pPair, pair);
+	_mm_store_ps(pNear, sinQuarterSSE(_mm_sub_ps(one, t)));
+	_mm_store_ps(pFar, sinQuarterSSE(t));
+}
+
+/**
+ * @fn	void Spatializer::processSSE(EmitterSoA* e, UINT32 begin, UINT32 end)
+ *
+ * @brief	processScalar() four emitters to a vector, two vectors per iteration. end - begin must be a
+ * 			multiple of 8 and begin aligned to 4.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::processSSE(EmitterSoA* e, UINT32 begin, UINT32 end)
+{
+	const __m128 lpx = _mm_set1_ps(listener.position[0]), lpy = _mm_set1_ps(listener.position[1]), lpz = _mm_set1_ps(listener.position[2]);
+	const __m128 lvx = _mm_set1_ps(listener.velocity[0]), lvy = _mm_set1_ps(listener.velocity[1]), lvz = _mm_set1_ps(listener.velocity[2]);
+	const __m128 fx = _mm_set1_ps(listener.front[0]), fy = _mm_set1_ps(listener.front[1]), fz = _mm_set1_ps(listener.front[2]);
+	const __m128 rx = _mm_set1_ps(right[0]), ry = _mm_set1_ps(right[1]), rz = _mm_set1_ps(right[2]);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 fltMin = _mm_set1_ps(FLT_MIN);
+	const __m128 c = _mm_set1_ps(speedOfSound);
+	const __m128 minDen = _mm_set1_ps(speedOfSound * FLT_EPSILON);
+	const __m128 maxDoppler = _mm_set1_ps(SPATIALIZER_MAX_DOPPLER);
+
+	for(UINT32 base = begin; base < end; base += 8){
+		for(UINT32 i = base; i < base + 8; i += 4){
+			__m128 dx = _mm_sub_ps(_mm_load_ps(e->posX + i), lpx);
+			__m128 dy = _mm_sub_ps(_mm_load_ps(e->posY + i), lpy);
+			__m128 dz = _mm_sub_ps(_mm_load_ps(e->posZ + i), lpz);
+
+			__m128 lx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, rx), _mm_mul_ps(dy, ry)), _mm_mul_ps(dz, rz));
+			__m128 lz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, fx), _mm_mul_ps(dy, fy)), _mm_mul_ps(dz, fz));
+			_mm_store_ps(localX + i, lx);
+			_mm_store_ps(localZ + i, lz);
+
+			__m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+			__m128 nd = _mm_div_ps(dist, _mm_max_ps(_mm_load_ps(e->curveDistanceScaler + i), fltMin));
+
+			_mm_store_ps(volume + i, curveSSE(volumeCurve, nd));
+			_mm_store_ps(e->reverbLevel + i, curveSSE(reverbCurve, nd));
+			_mm_store_ps(e->lpfDirect + i, curveSSE(lpfDirectCurve, nd));
+			_mm_store_ps(e->distance + i, dist);
+
+			__m128 hasDist = _mm_cmpgt_ps(dist, zero);
+			__m128 invDist = _mm_and_ps(hasDist, _mm_div_ps(one, _mm_max_ps(dist, fltMin)));
+			__m128 emitterDot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_load_ps(e->velX + i)), _mm_mul_ps(dy, _mm_load_ps(e->velY + i))), _mm_mul_ps(dz, _mm_load_ps(e->velZ + i)));
+			__m128 listenerDot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, lvx), _mm_mul_ps(dy, lvy)), _mm_mul_ps(dz, lvz));
+			__m128 ds = _mm_mul_ps(_mm_load_ps(e->dopplerScaler + i), invDist);
+			// c - (-dot / dist) * scaler = c + dot * scaler / dist
+			__m128 num = _mm_max_ps(_mm_add_ps(c, _mm_mul_ps(listenerDot, ds)), zero);
+			__m128 den = _mm_max_ps(_mm_add_ps(c, _mm_mul_ps(emitterDot, ds)), minDen);
+			_mm_store_ps(e->doppler + i, _mm_min_ps(_mm_div_ps(num, den), maxDoppler));
+
+			__m128 ir = _mm_load_ps(e->innerRadius + i);
+			__m128 s = _mm_sub_ps(one, _mm_div_ps(dist, _mm_max_ps(ir, fltMin)));
+			_mm_store_ps(spread + i, _mm_and_ps(_mm_cmpgt_ps(ir, zero), _mm_max_ps(s, zero)));
+
+			if(ringCount > 1)
+				directionSSE(lx, lz, ringAzimuth, ringCount, pairIndex + i, nearWeight + i, farWeight + i);
+		}
+	}
+}
+
+#else
+
+void Spatializer::processSSE(EmitterSoA* e, UINT32 begin, UINT32 end)
+{
+	processScalar(e, begin, end);
+}
+
+#endif // SPATIALIZER_HAS_SSE
+
+#ifdef SPATIALIZER_HAS_AVX
+
+static inline __m256 curveAVX(const Spatializer::Curve& c, __m256 x)
+{
+	__m256 v = _mm256_set1_ps(c.firstSetting);
+	for(UINT32 k = 0; k < c.segments; ++k){
+		__m256 start = _mm256_set1_ps(c.start[k]);
+		__m256 t = _mm256_mul_ps(_mm256_sub_ps(x, start), _mm256_set1_ps(c.invLength[k]));
+		t = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+		__m256 seg = _mm256_add_ps(_mm256_set1_ps(c.base[k]), _mm256_mul_ps(t, _mm256_set1_ps(c.rise[k])));
+		v = _mm256_blendv_ps(v, seg, _mm256_cmp_ps(x, start, _CMP_GE_OQ));
+	}
+	return v;
+}
+
+/**
+ * @fn	static inline __m256 azimuthAVX(__m256 x, __m256 z)
+ *
+ * @brief	azimuthSSE() eight wide.
+ *
+ * @date	10/17/2026
+ */
+static inline __m256 azimuthAVX(__m256 x, __m256 z)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+	__m256 ax = _mm256_andnot_ps(signBit, x);
+	__m256 az = _mm256_andnot_ps(signBit, z);
+	__m256 r = _mm256_div_ps(_mm256_min_ps(ax, az), _mm256_max_ps(_mm256_max_ps(ax, az), _mm256_set1_ps(FLT_MIN)));
+
+	__m256 big = _mm256_cmp_ps(r, _mm256_set1_ps(TAN_PI_8), _CMP_GT_OQ);
+	r = _mm256_blendv_ps(r, _mm256_div_ps(_mm256_sub_ps(r, one), _mm256_add_ps(r, one)), big);
+	__m256 r2 = _mm256_mul_ps(r, r);
+	__m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(ATAN_C9), r2), _mm256_set1_ps(ATAN_C7));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r2), _mm256_set1_ps(ATAN_C5));
+	p = _mm256_add_ps(_mm256_mul_ps(p, r2), _mm256_set1_ps(ATAN_C3));
+	__m256 a = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, r2), r), r);
+	a = _mm256_add_ps(a, _mm256_and_ps(big, _mm256_set1_ps((FLOAT32)(M_PI / 4))));
+
+	a = _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps((FLOAT32)(M_PI / 2)), a), _mm256_cmp_ps(ax, az, _CMP_GT_OQ));
+	a = _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps((FLOAT32)M_PI), a), _mm256_cmp_ps(z, zero, _CMP_LT_OQ));
+	return _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps(TWO_PI), a), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+}
+
+static inline __m256 sinQuarterAVX(__m256 t)
+{
+	__m256 u = _mm256_mul_ps(t, _mm256_set1_ps((FLOAT32)(M_PI / 2)));
+	__m256 u2 = _mm256_mul_ps(u, u);
+	__m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.0f / 39916800.0f), u2), _mm256_set1_ps(1.0f / 362880.0f));
+	p = _mm256_add_ps(_mm256_mul_ps(p, u2), _mm256_set1_ps(-1.0f / 5040.0f));
+	p = _mm256_add_ps(_mm256_mul_ps(p, u2), _mm256_set1_ps(1.0f / 120.0f));
+	p = _mm256_add_ps(_mm256_mul_ps(p, u2), _mm256_set1_ps(-1.0f / 6.0f));
+	p = _mm256_add_ps(_mm256_mul_ps(p, u2), _mm256_set1_ps(1.0f));
+	return _mm256_mul_ps(p, u);
+}
+
+/**
+ * @fn	static inline void directionAVX(__m256 x, __m256 z, const FLOAT32* ringAzimuth, UINT32 ringCount,
+ * 		FLOAT32* pPair, FLOAT32* pNear, FLOAT32* pFar)
+ *
+ * @brief	directionSSE() eight wide.
+ *
+ * @date	10/17/2026
+ */
+static inline void directionAVX(__m256 x, __m256 z, const FLOAT32* ringAzimuth, UINT32 ringCount, FLOAT32* pPair, FLOAT32* pNear, FLOAT32* pFar)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 twoPi = _mm256_set1_ps(TWO_PI);
+	__m256 azimuth = azimuthAVX(x, z);
+
+	__m256 passed = zero;
+	for(UINT32 j = 0; j < ringCount; ++j)
+		passed = _mm256_add_ps(passed, _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(ringAzimuth[j]), azimuth, _CMP_LE_OQ), one));
+	__m256 pair = _mm256_blendv_ps(_mm256_sub_ps(passed, one), _mm256_set1_ps((FLOAT32)(ringCount - 1)), _mm256_cmp_ps(passed, zero, _CMP_EQ_OQ));
+
+	__m256 from = zero, to = zero;
+	for(UINT32 j = 0; j < ringCount; ++j){
+		__m256 mask = _mm256_cmp_ps(pair, _mm256_set1_ps((FLOAT32)j), _CMP_EQ_OQ);
+		from = _mm256_or_ps(from, _mm256_and_ps(mask, _mm256_set1_ps(ringAzimuth[j])));
+		to = _mm256_or_ps(to, _mm256_and_ps(mask, _mm256_set1_ps(ringAzimuth[(j + 1) % ringCount])));
+	}
+	__m256 span = _mm256_sub_ps(to, from);
+	span = _mm256_add_ps(span, _mm256_and_ps(_mm256_cmp_ps(span, zero, _CMP_LE_OQ), twoPi));
+	__m256 offset = _mm256_sub_ps(azimuth, from);
+	offset = _mm256_add_ps(offset, _mm256_and_ps(_mm256_cmp_ps(offset, zero, _CMP_LT_OQ), twoPi));
+	__m256 t = _mm256_div_ps(offset, span);
+
+	_mm256_store_ps(pPair, pair);
+	_mm256_store_ps(pNear, sinQuarterAVX(_mm256_sub_ps(one, t)));
+	_mm256_store_ps(pFar, sinQuarterAVX(t));
+}
+
+/**
+ * @fn	void Spatializer::processAVX(EmitterSoA* e, UINT32 begin, UINT32 end)
+ *
+ * @brief	processScalar() eight emitters to a vector, two vectors per iteration. end - begin must be a
+ * 			multiple of 16 and begin aligned to 8.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::processAVX(EmitterSoA* e, UINT32 begin, UINT32 end)
+{
+	const __m256 lpx = _mm256_set1_ps(listener.position[0]), lpy = _mm256_set1_ps(listener.position[1]), lpz = _mm256_set1_ps(listener.position[2]);
+	const __m256 lvx = _mm256_set1_ps(listener.velocity[0]), lvy = _mm256_set1_ps(listener.velocity[1]), lvz = _mm256_set1_ps(listener.velocity[2]);
+	const __m256 fx = _mm256_set1_ps(listener.front[0]), fy = _mm256_set1_ps(listener.front[1]), fz = _mm256_set1_ps(listener.front[2]);
+	const __m256 rx = _mm256_set1_ps(right[0]), ry = _mm256_set1_ps(right[1]), rz = _mm256_set1_ps(right[2]);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 fltMin = _mm256_set1_ps(FLT_MIN);
+	const __m256 c = _mm256_set1_ps(speedOfSound);
+	const __m256 minDen = _mm256_set1_ps(speedOfSound * FLT_EPSILON);
+	const __m256 maxDoppler = _mm256_set1_ps(SPATIALIZER_MAX_DOPPLER);
+
+	for(UINT32 base = begin; base < end; base += 16){
+		for(UINT32 i = base; i < base + 16; i += 8){
+			__m256 dx = _mm256_sub_ps(_mm256_load_ps(e->posX + i), lpx);
+			__m256 dy = _mm256_sub_ps(_mm256_load_ps(e->posY + i), lpy);
+			__m256 dz = _mm256_sub_ps(_mm256_load_ps(e->posZ + i), lpz);
+
+			__m256 lx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, rx), _mm256_mul_ps(dy, ry)), _mm256_mul_ps(dz, rz));
+			__m256 lz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, fx), _mm256_mul_ps(dy, fy)), _mm256_mul_ps(dz, fz));
+			_mm256_store_ps(localX + i, lx);
+			_mm256_store_ps(localZ + i, lz);
+
+			__m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+			__m256 nd = _mm256_div_ps(dist, _mm256_max_ps(_mm256_load_ps(e->curveDistanceScaler + i), fltMin));
+
+			_mm256_store_ps(volume + i, curveAVX(volumeCurve, nd));
+			_mm256_store_ps(e->reverbLevel + i, curveAVX(reverbCurve, nd));
+			_mm256_store_ps(e->lpfDirect + i, curveAVX(lpfDirectCurve, nd));
+			_mm256_store_ps(e->distance + i, dist);
+
+			__m256 hasDist = _mm256_cmp_ps(dist, zero, _CMP_GT_OQ);
+			__m256 invDist = _mm256_and_ps(hasDist, _mm256_div_ps(one, _mm256_max_ps(dist, fltMin)));
+			__m256 emitterDot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, _mm256_load_ps(e->velX + i)), _mm256_mul_ps(dy, _mm256_load_ps(e->velY + i))), _mm256_mul_ps(dz, _mm256_load_ps(e->velZ + i)));
+			__m256 listenerDot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, lvx), _mm256_mul_ps(dy, lvy)), _mm256_mul_ps(dz, lvz));
+			__m256 ds = _mm256_mul_ps(_mm256_load_ps(e->dopplerScaler + i), invDist);
+			__m256 num = _mm256_max_ps(_mm256_add_ps(c, _mm256_mul_ps(listenerDot, ds)), zero);
+			__m256 den = _mm256_max_ps(_mm256_add_ps(c, _mm256_mul_ps(emitterDot, ds)), minDen);
+			_mm256_store_ps(e->doppler + i, _mm256_min_ps(_mm256_div_ps(num, den), maxDoppler));
+
+			__m256 ir = _mm256_load_ps(e->innerRadius + i);
+			__m256 s = _mm256_sub_ps(one, _mm256_div_ps(dist, _mm256_max_ps(ir, fltMin)));
+			_mm256_store_ps(spread + i, _mm256_and_ps(_mm256_cmp_ps(ir, zero, _CMP_GT_OQ), _mm256_max_ps(s, zero)));
+
+			if(ringCount > 1)
+				directionAVX(lx, lz, ringAzimuth, ringCount, pairIndex + i, nearWeight + i, farWeight + i);
+		}
+	}
+}
+
+#else
+
+void Spatializer::processAVX(EmitterSoA* e, UINT32 begin, UINT32 end)
+{
+	processSSE(e, begin, end);
+}
+
+#endif // SPATIALIZER_HAS_AVX
+
+/**
+ * @fn	void Spatializer::estimateAudibility(EmitterSoA* pEmitters)
+ *
+ * @brief	A cheap guess at how loud each emitter will be heard, for choosing which sounds deserve a voice: its
+ * 			gain times the volume curve at its distance, or just its gain if it is not spatialized. Panning,
+ * 			spread and Doppler are left out and nothing but the audibility array is written, so this can run
+ * 			every frame over every emitter in the store, playing or not, dirty or not.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::estimateAudibility(EmitterSoA* pEmitters)
+{
+	UINT32 count = pEmitters->getCount();
+	const FLOAT32* lp = listener.position;
+	UINT32 i = 0;
+
+#ifdef SPATIALIZER_HAS_SSE
+	if(kernel != SPATIALIZER_KERNEL_SCALAR){
+		const __m128 lpx = _mm_set1_ps(lp[0]), lpy = _mm_set1_ps(lp[1]), lpz = _mm_set1_ps(lp[2]);
+		const __m128 fltMin = _mm_set1_ps(FLT_MIN);
+		// whole vectors, running into the padding at the end of the store
+		UINT32 end = (count + 3) & ~3u;
+		for(; i < end; i += 4){
+			__m128 dx = _mm_sub_ps(_mm_load_ps(pEmitters->posX + i), lpx);
+			__m128 dy = _mm_sub_ps(_mm_load_ps(pEmitters->posY + i), lpy);
+			__m128 dz = _mm_sub_ps(_mm_load_ps(pEmitters->posZ + i), lpz);
+			__m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+			__m128 nd = _mm_div_ps(dist, _mm_max_ps(_mm_load_ps(pEmitters->curveDistanceScaler + i), fltMin));
+			_mm_store_ps(pEmitters->audibility + i, _mm_mul_ps(_mm_load_ps(pEmitters->gain + i), curveSSE(volumeCurve, nd)));
+		}
+	}
+#endif
+
+	for(; i < count; ++i){
+		FLOAT32 dx = pEmitters->posX[i] - lp[0];
+		FLOAT32 dy = pEmitters->posY[i] - lp[1];
+		FLOAT32 dz = pEmitters->posZ[i] - lp[2];
+		FLOAT32 dist = sqrtf(dx * dx + dy * dy + dz * dz);
+		FLOAT32 scaler = pEmitters->curveDistanceScaler[i];
+		pEmitters->audibility[i] = pEmitters->gain[i] * evaluate(volumeCurve, dist / ((scaler > FLT_MIN) ? scaler : FLT_MIN));
+	}
+
+	for(i = 0; i < count; ++i){
+		if(!pEmitters->spatialized[i])
+			pEmitters->audibility[i] = pEmitters->gain[i];
+	}
+}
+
+/**
+ * @fn	void Spatializer::direction(FLOAT32 x, FLOAT32 z, UINT32* pPair, FLOAT32* pNear, FLOAT32* pFar)
+ *
+ * @brief	Finds the pair of neighbouring speakers either side of a sound heard from (x, z) in listener
+ * 			space, wrapping from the last to the first, and its constant power weights between them. Needs
+ * 			at least two speakers in the ring.
+ *
+ * @date	10/17/2026
+ *
+ * @param	x			 	Distance to the listener's right.
+ * @param	z			 	Distance in front of the listener.
+ * @param [out]	pPair	The ring index of the first speaker of the pair, the second is the next one round.
+ * @param [out]	pNear	The first speaker's weight.
+ * @param [out]	pFar 	The second speaker's weight.
+ */
+void Spatializer::direction(FLOAT32 x, FLOAT32 z, UINT32* pPair, FLOAT32* pNear, FLOAT32* pFar)
+{
+	FLOAT32 azimuth = atan2f(x, z);
+	if(azimuth < 0)
+		azimuth += TWO_PI;
+
+	UINT32 a = ringCount - 1;
+	for(UINT32 j = 0; j < ringCount; ++j){
+		if(ringAzimuth[j] <= azimuth)
+			a = j;
+	}
+	UINT32 b = (a + 1) % ringCount;
+	FLOAT32 span = ringAzimuth[b] - ringAzimuth[a];
+	FLOAT32 offset = azimuth - ringAzimuth[a];
+	if(span <= 0)
+		span += TWO_PI;
+	if(offset < 0)
+		offset += TWO_PI;
+	FLOAT32 t = offset / span;
+
+	*pPair = a;
+	*pNear = cosf(t * (FLOAT32)(M_PI / 2));
+	*pFar = sinf(t * (FLOAT32)(M_PI / 2));
+}
+
+/**
+ * @fn	void Spatializer::panPair(FLOAT32* m, UINT32 stride, UINT32 pair, FLOAT32 nearWeight,
+ * 		FLOAT32 farWeight, FLOAT32 gain, FLOAT32 s)
+ *
+ * @brief	Adds one source channel, with the direction() found for it, to its column of an output matrix,
+ * 			m[stride * D], which must be cleared first.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	m	The source channel's first coefficient.
+ * @param	stride   	Source channels in the matrix.
+ * @param	pair	 	From direction(), unused if s is 1.
+ * @param	nearWeight	From direction().
+ * @param	farWeight 	From direction().
+ * @param	gain	 	Level from the volume curve.
+ * @param	s		 	Spread from the inner radius, 0 to 1.
+ */
+void Spatializer::panPair(FLOAT32* m, UINT32 stride, UINT32 pair, FLOAT32 nearWeight, FLOAT32 farWeight, FLOAT32 gain, FLOAT32 s)
+{
+	if(s < 1.0f){
+		FLOAT32 directional = (1.0f - s) * gain;
+		m[stride * ringChannel[pair]] += directional * nearWeight;
+		m[stride * ringChannel[(pair + 1) % ringCount]] += directional * farWeight;
+	}
+
+	if(s > 0){
+		FLOAT32 even = s * gain / sqrtf((FLOAT32)ringCount);
+		for(UINT32 j = 0; j < ringCount; ++j)
+			m[stride * ringChannel[j]] += even;
+	}
+}
+
+/**
+ * @fn	void Spatializer::panSource(FLOAT32* m, UINT32 stride, FLOAT32 x, FLOAT32 z, FLOAT32 gain,
+ * 		FLOAT32 s)
+ *
+ * @brief	Pans one source channel heard from (x, z) in listener space into its column of an output matrix,
+ * 			working out its direction on the spot. Mono emitters have theirs from the vector pass instead.
+ *
+ * @date	10/17/2026
+ */
+void Spatializer::panSource(FLOAT32* m, UINT32 stride, FLOAT32 x, FLOAT32 z, FLOAT32 gain, FLOAT32 s)
+{
+	if(ringCount == 1){
+		m[stride * ringChannel[0]] = gain;
+		return;
+	}
+
+	// A sound right on top of the listener has no direction, so it is spread over everything
+	UINT32 pair = 0;
+	FLOAT32 nearWeight = 0, farWeight = 0;
+	if(x == 0 && z == 0)
+		s = 1.0f;
+	else if(s < 1.0f)
+		direction(x, z, &pair, &nearWeight, &farWeight);
+	panPair(m, stride, pair, nearWeight, farWeight, gain, s);
+}
+
+/**
+ * @fn	template<UINT32 SRC> void Spatializer::pan(EmitterSoA* e, UINT32 index)
+ *
+ * @brief	Builds the output matrix of one emitter from the results of the vector pass. SRC is the emitter's
+ * 			channel count, fixed for the common layouts so the channel loop unrolls, or 0 to read it from the
+ * 			store.
+ *
+ * 			A mono emitter is heard from its position. The channels of any other are placed like X3DAudio
+ * 			places them: on a circle of the emitter's channel radius around its position, at their azimuths
+ * 			clockwise from the emitter's front in the plane of its front and right. Each is then panned on its
+ * 			own, with the volume and spread of the emitter as a whole, so a stereo loop keeps its width as it
+ * 			turns. LFE channels go to the LFE speaker at the emitter's volume, or nowhere if there isn't one.
+ *
+ * @date	10/17/2026
+ */
+template<UINT32 SRC>
+void Spatializer::pan(EmitterSoA* e, UINT32 index)
+{
+	const UINT32 src = (SRC > 0) ? SRC : e->getChannelCount(index);
+	FLOAT32* m = e->getMatrix(index);
+	memset(m, 0, src * channelCount * sizeof(FLOAT32));
+	if(ringCount == 0)
+		return;
+
+	FLOAT32 gain = volume[index];
+	FLOAT32 x = localX[index];
+	FLOAT32 z = localZ[index];
+	if(src == 1){
+		if(ringCount == 1){
+			m[ringChannel[0]] = gain;
+			return;
+		}
+		FLOAT32 s = (x == 0 && z == 0) ? 1.0f : spread[index];
+		panPair(m, 1, (UINT32)pairIndex[index], nearWeight[index], farWeight[index], gain, s);
+		return;
+	}
+
+	// The emitter's front and right, in listener space, scaled by the channel radius
+	const FLOAT32 ef[3] = { e->frontX[index], e->frontY[index], e->frontZ[index] };
+	const FLOAT32 et[3] = { e->topX[index], e->topY[index], e->topZ[index] };
+	const FLOAT32 er[3] = { et[1] * ef[2] - et[2] * ef[1], et[2] * ef[0] - et[0] * ef[2], et[0] * ef[1] - et[1] * ef[0] };
+	const FLOAT32* lf = listener.front;
+	FLOAT32 radius = e->channelRadius[index];
+	FLOAT32 frontX = radius * (ef[0] * right[0] + ef[1] * right[1] + ef[2] * right[2]);
+	FLOAT32 frontZ = radius * (ef[0] * lf[0] + ef[1] * lf[1] + ef[2] * lf[2]);
+	FLOAT32 rightX = radius * (er[0] * right[0] + er[1] * right[1] + er[2] * right[2]);
+	FLOAT32 rightZ = radius * (er[0] * lf[0] + er[1] * lf[1] + er[2] * lf[2]);
+
+	const FLOAT32* azimuths = e->getAzimuths(index);
+	for(UINT32 c = 0; c < src; ++c){
+		FLOAT32 azimuth = azimuths[c];
+		if(azimuth >= EMITTER_LFE_AZIMUTH){
+			if(lfeChannel >= 0)
+				m[src * lfeChannel + c] = gain;
+			continue;
+		}
+		FLOAT32 sa = sinf(azimuth);
+		FLOAT32 ca = cosf(azimuth);
+		panSource(m + c, src, x + sa * rightX + ca * frontX, z + sa * rightZ + ca * frontZ, gain, spread[index]);
+	}
+}
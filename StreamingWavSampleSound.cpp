@@ -0,0 +1,355 @@
+#include "StdAfx.h"
+#include "StreamingWavSampleSound.h"
+#include "AudioLog.h"
+#include <stdio.h>
+
+/**
+ * @fn	StreamingWavSampleSound::StreamingWavSampleSound(void)
+ *
+ * @brief	Default constructor. Hooks the voice callback up to this sound and its reader.
+ *
+ * @date	10/17/2026
+ */
+#pragma warning( disable: 4355 )    // 'this' used in base member initializer list, the callback only stores it
+StreamingWavSampleSound::StreamingWavSampleSound(void) : voiceCallback(this)
+{
+	pSourceVoice = NULL;
+}
+#pragma warning( default: 4355 )
+
+/**
+ * @fn	StreamingWavSampleSound::~StreamingWavSampleSound(void)
+ *
+ * @brief	Destructor. Stops the voice before the reader thread is shut down.
+ *
+ * @date	10/17/2026
+ */
+StreamingWavSampleSound::~StreamingWavSampleSound(void)
+{
+	destroy();
+}
+
+/**
+ * @fn	HRESULT StreamingWavSampleSound::initPCM( IXAudio2* pXaudio2, LPCWSTR szFilename,
+ * 		UINT loopCount )
+ *
+ * @brief	Opens the sound file for streaming and creates the source voice. Only the header is parsed here,
+ * 			the reader thread starts prefilling the ring straight away so that start() has data to play.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pXaudio2	The pointer to the IXAudio2.
+ * @param	szFilename			Name of the file.
+ * @param	loopCount			Number of times to loop through the file. This value can be between 0 and
+ * 								XAUDIO2_MAX_LOOP_COUNT. To loop forever, set LoopCount to XAUDIO2_LOOP_INFINITE.
+ *
+ * @return	S_OK or an error.
+ */
+HRESULT StreamingWavSampleSound::initPCM( IXAudio2* pXaudio2, LPCWSTR szFilename, UINT loopCount )
+{
+	HRESULT hr = S_OK;
+	setFileName(szFilename);
+	this->pXaudio2 = pXaudio2;
+
+	//
+	// Locate the wave file
+	//
+	WCHAR strFilePath[MAX_PATH];
+	if( FAILED( hr = FindMediaFileCch( strFilePath, MAX_PATH, szFilename ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Failed to find media file: %s", szFilename);
+		return setLoadResult(hr);
+	}
+
+	//
+	// Open the wave file for streaming
+	//
+	if( FAILED( hr = reader.open( strFilePath, STREAMING_BUFFER_BYTES, STREAMING_BUFFER_COUNT,
+		(loopCount == XAUDIO2_LOOP_INFINITE) ? STREAM_LOOP_INFINITE : loopCount ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Failed opening WAV file for streaming: %#X (%s)", hr, strFilePath);
+		return setLoadResult(hr);
+	}
+	cbWaveSize = reader.getDataSize();
+	return setLoadResult(createVoice());
+}
+
+/**
+ * @fn	HRESULT StreamingWavSampleSound::initCompressed( IXAudio2* pXaudio2, LPCWSTR szFilename,
+ * 		UINT loopCount )
+ *
+ * @brief	Loads an IMA or MS ADPCM file into memory as it is, and streams it from there, decoding a
+ * 			bufferful at a time as the ring is refilled. For long loops this keeps a quarter of the memory a
+ * 			decoded asset would need, in exchange for decoding every time round. Other formats are streamed
+ * 			from memory too, but gain nothing by it.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pXaudio2	The pointer to the IXAudio2.
+ * @param	szFilename			Name of the file.
+ * @param	loopCount			Number of times to loop through the file, as for initPCM().
+ *
+ * @return	S_OK or an error.
+ */
+HRESULT StreamingWavSampleSound::initCompressed( IXAudio2* pXaudio2, LPCWSTR szFilename, UINT loopCount )
+{
+	HRESULT hr = S_OK;
+	setFileName(szFilename);
+	this->pXaudio2 = pXaudio2;
+
+	WCHAR strFilePath[MAX_PATH];
+	if( FAILED( hr = FindMediaFileCch( strFilePath, MAX_PATH, szFilename ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Failed to find media file: %s", szFilename);
+		return setLoadResult(hr);
+	}
+
+	// not through the cache: a shared asset would be decoded to float
+	if( FAILED( hr = PcmAsset::create( strFilePath, &pAsset, false ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Failed reading WAV file: %#X (%s)", hr, strFilePath);
+		return setLoadResult(hr);
+	}
+
+	if( FAILED( hr = reader.openMemory( pAsset->getFormat(), pAsset->getData(), pAsset->getSize(),
+		WavStreamReader::getMemoryBufferBytes( pAsset->getFormat() ), STREAMING_BUFFER_COUNT,
+		(loopCount == XAUDIO2_LOOP_INFINITE) ? STREAM_LOOP_INFINITE : loopCount, pAsset->getFactFrames() ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Failed opening WAV data for streaming: %#X (%s)", hr, strFilePath);
+		SAFE_RELEASE( pAsset );
+		return setLoadResult(hr);
+	}
+	cbWaveSize = reader.getDataSize();
+	if( FAILED( hr = createVoice() ) )
+		SAFE_RELEASE( pAsset );
+	return setLoadResult(hr);
+}
+
+/**
+ * @fn	HRESULT StreamingWavSampleSound::setLoadResult(HRESULT hr)
+ *
+ * @brief	Records how initPCM() or initCompressed() went, for getLoadState(): ready to play, or failed
+ * 			with hr kept as the reason. There is no pending state, these load on the caller's thread.
+ *
+ * @date	10/17/2026
+ *
+ * @return	hr.
+ */
+HRESULT StreamingWavSampleSound::setLoadResult(HRESULT hr)
+{
+	loadResult = hr;
+	loadState.store(SUCCEEDED(hr) ? SOUND_LOAD_READY : SOUND_LOAD_FAILED, memory_order_release);
+	return hr;
+}
+
+/**
+ * @fn	HRESULT StreamingWavSampleSound::createVoice()
+ *
+ * @brief	Creates the source voice for the open reader and starts the reader thread, which immediately
+ * 			begins to prefill the ring.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or an error, with the reader closed.
+ */
+HRESULT StreamingWavSampleSound::createVoice()
+{
+	HRESULT hr = S_OK;
+
+	// Create the source voice, the callback gives the buffers back to the reader
+	XAUDIO2_SEND_DESCRIPTOR send = { 0, pOutputVoice };
+	XAUDIO2_VOICE_SENDS sends = { 1, &send };
+	if( FAILED( hr = pXaudio2->CreateSourceVoice( &pSourceVoice, reader.getFormat(), 0,
+		XAUDIO2_DEFAULT_FREQ_RATIO, &voiceCallback, pOutputVoice != NULL ? &sends : NULL ) ) )
+	{
+		AUDIO_LOG_ERROR(L"Error %#X creating source voice", hr);
+		reader.close();
+		return hr;
+	}
+	if( reader.getFormat()->nChannels != getEmitterChannels() )
+		setEmitterChannels( reader.getFormat()->nChannels );
+
+	// Submit buffers as the reader fills them
+	reader.setReadyCallback(onBlockReady, this);
+	if( FAILED( hr = reader.start() ) )
+	{
+		AUDIO_LOG_ERROR(L"Error %#X starting stream reader", hr);
+		pSourceVoice->DestroyVoice();
+		reader.close();
+		return hr;
+	}
+
+	creationComplete = true;
+	isRunning = false;
+	return hr;
+}
+
+/**
+ * @fn	void StreamingWavSampleSound::onBlockReady(void* pContext)
+ *
+ * @brief	Called on the reader thread whenever a block has been filled.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pContext	The StreamingWavSampleSound that owns the reader.
+ */
+void StreamingWavSampleSound::onBlockReady(void* pContext)
+{
+	((StreamingWavSampleSound*)pContext)->submitReady();
+}
+
+/**
+ * @fn	HRESULT StreamingWavSampleSound::submitReady()
+ *
+ * @brief	Submits every filled block to the source voice, in stream order. The last block of the stream
+ * 			carries XAUDIO2_END_OF_STREAM.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or the error from SubmitSourceBuffer.
+ */
+HRESULT StreamingWavSampleSound::submitReady()
+{
+	HRESULT hr = S_OK;
+	lock_guard<mutex> l(submitLock);
+	if(pSourceVoice == NULL)
+		return CO_E_NOTINITIALIZED;
+
+	StreamBlock* block;
+	while((block = reader.acquire(0)) != NULL){
+		if(block->bytes == 0){
+			reader.release(block);
+			continue;
+		}
+
+		XAUDIO2_BUFFER streamBuffer = {0};
+		streamBuffer.AudioBytes = block->bytes;
+		streamBuffer.pAudioData = block->pData;
+		streamBuffer.Flags = block->endOfStream ? XAUDIO2_END_OF_STREAM : 0;
+		streamBuffer.pContext = block;
+
+		if( FAILED( hr = pSourceVoice->SubmitSourceBuffer( &streamBuffer ) ) )
+		{
+			AUDIO_LOG_ERROR(L"Error %#X submitting stream buffer", hr);
+			reader.release(block);
+			return hr;
+		}
+	}
+	return hr;
+}
+
+/**
+ * @fn	HRESULT StreamingWavSampleSound::start()
+ *
+ * @brief	Start playing the sound if it's not already playing. If the previous play through has finished
+ * 			the stream is rewound to the beginning, otherwise playback resumes where stop() left it.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK (0) or S_FAILED (-1), depending on success.
+ */
+HRESULT StreamingWavSampleSound::start(){
+	if(!creationComplete){
+		return S_FAILED;
+	}
+	HRESULT hr = S_OK;
+
+	if(!isRunning){
+		if(reader.isFinished()){
+			if( FAILED( hr = reader.rewind() ) )
+			{
+				AUDIO_LOG_ERROR(L"Error %#X rewinding stream", hr);
+				return hr;
+			}
+		}
+		submitReady();
+		hr = pSourceVoice->Start( 0 );
+		isRunning = true;
+		AUDIO_LOG_INFO(L"StreamingWavSampleSound::start(): starting playing %s", getFileName());
+	}
+
+	return hr;
+}
+
+/**
+ * @fn	void StreamingWavSampleSound::stop()
+ *
+ * @brief	Stops the sound playing. Queued buffers are kept so that start() carries on from here.
+ *
+ * @date	10/17/2026
+ */
+void StreamingWavSampleSound::stop(){
+	if(creationComplete && isRunning){
+		pSourceVoice->Stop( 0 );
+		isRunning = false;
+		AUDIO_LOG_INFO(L"StreamingWavSampleSound::stop(): stopped playing %s", getFileName());
+	}
+}
+
+/**
+ * @fn	HRESULT StreamingWavSampleSound::run()
+ *
+ * @brief	Do periodic checks on the playing sound. The sound has finished once the voice has nothing queued
+ * 			and the reader has handed out the end of the stream.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK.
+ */
+HRESULT StreamingWavSampleSound::run(){
+	if(isRunning && creationComplete)
+	{
+		XAUDIO2_VOICE_STATE state;
+		pSourceVoice->GetState( &state );
+		if(state.BuffersQueued == 0 && reader.isFinished()){
+			isRunning = false;
+			AUDIO_LOG_INFO(L"finished playing %s", getName());
+		}
+	}
+
+	return S_OK;
+}
+
+/**
+ * @fn	void StreamingWavSampleSound::onEvent(const SoundEvent& e)
+ *
+ * @brief	Handles the end of stream or an error queued by the voice callback. An end that was overtaken by
+ * 			a restart finds the reader rewound and is ignored.
+ *
+ * @date	10/17/2026
+ */
+void StreamingWavSampleSound::onEvent(const SoundEvent& e){
+	if(!creationComplete)
+		return;
+	if(e.type == SOUND_EVENT_END && !reader.isFinished())
+		return;
+	if(isRunning){
+		isRunning = false;
+		AUDIO_LOG_INFO(L"finished playing %s", getName());
+	}
+	notify((SOUND_EVENT)e.type);
+}
+
+/**
+ * @fn	void StreamingWavSampleSound::destroy()
+ *
+ * @brief	Destroys the voice (which guarantees no more callbacks) and then shuts down the reader, and
+ * 			lets go of the data if it was streamed from memory.
+ *
+ * @date	10/17/2026
+ */
+void StreamingWavSampleSound::destroy(){
+	if(creationComplete){
+		reader.setReadyCallback(NULL, NULL);
+		{
+			// the reader thread may be part way through a submit
+			lock_guard<mutex> l(submitLock);
+			pSourceVoice->DestroyVoice();
+			pSourceVoice = NULL;
+		}
+		reader.close();
+	}
+	SAFE_RELEASE( pAsset );
+	creationComplete = false;
+	loadState.store(SOUND_LOAD_FAILED, memory_order_release);
+}
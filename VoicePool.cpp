@@ -0,0 +1,439 @@
+#include "StdAfx.h"
+#include "VoicePool.h"
+#include "AudioLog.h"
+#include <stdio.h>
+
+/**
+ * @fn	VoicePool::VoicePool(void)
+ *
+ * @brief	Default constructor. The pool is not usable until init() has been called.
+ *
+ * @date	10/17/2026
+ */
+VoicePool::VoicePool(void)
+{
+	pXaudio2 = NULL;
+	voicesPerFormat = VOICE_POOL_VOICES_PER_FORMAT;
+	stealPolicy = VOICE_STEAL_LOWEST_PRIORITY;
+	nextInstance = 1;
+	memset(&stats, 0, sizeof(stats));
+	ended.init(VOICE_POOL_EVENT_QUEUE_SIZE);
+	lostEnds = 0;
+}
+
+/**
+ * @fn	VoicePool::~VoicePool(void)
+ *
+ * @brief	Destructor. Destroys all the voices.
+ *
+ * @date	10/17/2026
+ */
+VoicePool::~VoicePool(void)
+{
+	destroy();
+}
+
+/**
+ * @fn	void VoicePool::init(IXAudio2* pXaudio2, UINT32 voicesPerFormat, VOICE_STEAL_POLICY policy)
+ *
+ * @brief	Sets up the pool. No voices are made until a format is reserved or played.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pXaudio2	The engine the voices are created on.
+ * @param	voicesPerFormat		Number of voices to allocate for each wave format.
+ * @param	policy				How to choose a voice to steal when a format has none free.
+ */
+void VoicePool::init(IXAudio2* pXaudio2, UINT32 voicesPerFormat, VOICE_STEAL_POLICY policy)
+{
+	this->pXaudio2 = pXaudio2;
+	this->voicesPerFormat = (voicesPerFormat > 0) ? voicesPerFormat : 1;
+	stealPolicy = policy;
+}
+
+/**
+ * @fn	string VoicePool::formatKey(const WAVEFORMATEX* pwfx)
+ *
+ * @brief	Voices can only be shared between sounds with identical formats, so the format bytes themselves
+ * 			are the key. cbSize is ignored for plain PCM, where it is often left uninitialised.
+ *
+ * @date	10/17/2026
+ */
+string VoicePool::formatKey(const WAVEFORMATEX* pwfx)
+{
+	WAVEFORMATEX wfx = *pwfx;
+	size_t extra = 0;
+	if(wfx.wFormatTag == WAVE_FORMAT_PCM)
+		wfx.cbSize = 0;
+	else
+		extra = wfx.cbSize;
+
+	string key((const char*)&wfx, sizeof(WAVEFORMATEX));
+	key.append((const char*)(pwfx + 1), extra);
+	return key;
+}
+
+/**
+ * @fn	HRESULT VoicePool::reserve(const WAVEFORMATEX* pwfx)
+ *
+ * @brief	Allocates the voices for a wave format if that has not been done yet. BasicAudio calls this when a
+ * 			sound is loaded, so that no voices are created while the game is triggering sounds.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pwfx	The wave format.
+ *
+ * @return	S_OK if there is at least one voice for the format, else the error from CreateSourceVoice().
+ */
+HRESULT VoicePool::reserve(const WAVEFORMATEX* pwfx)
+{
+	if(pXaudio2 == NULL || pwfx == NULL)
+		return CO_E_NOTINITIALIZED;
+
+	string key = formatKey(pwfx);
+	if(formats.find(key) != formats.end())
+		return S_OK;
+
+	HRESULT hr = S_OK;
+	VOICE_LIST voices;
+	for(UINT32 i = 0; i < voicesPerFormat; ++i){
+		PooledVoice* pv = new PooledVoice(&ended);
+		if( FAILED( hr = pXaudio2->CreateSourceVoice( &pv->pVoice, pwfx, 0, XAUDIO2_DEFAULT_FREQ_RATIO, pv ) ) )
+		{
+			AUDIO_LOG_ERROR(L"VoicePool::reserve(): error %#X creating source voice %d", hr, i);
+			delete pv;
+			break;
+		}
+		voices.push_back(pv);
+	}
+	if(voices.empty())
+		return hr;
+
+	formats[key] = voices;
+	stats.formats++;
+	stats.capacity += (UINT32)voices.size();
+	return S_OK;
+}
+
+/**
+ * @fn	void VoicePool::retire(PooledVoice* pv)
+ *
+ * @brief	Cuts the instance on a voice short. The buffer is flushed, but XAudio2 may read it until OnBufferEnd,
+ * 			so the asset is kept until then.
+ *
+ * @date	10/17/2026
+ */
+void VoicePool::retire(PooledVoice* pv)
+{
+	pv->pVoice->Stop( 0 );
+	pv->pVoice->FlushSourceBuffers();
+	instances.erase(pv->instance);
+	pv->retired.push_back(make_pair(pv->pAsset, pv->buffersSubmitted));
+	pv->pAsset = NULL;
+	pv->instance = 0;
+	stats.active--;
+}
+
+/**
+ * @fn	void VoicePool::releaseRetired(PooledVoice* pv, bool force)
+ *
+ * @brief	Lets go of the assets of stopped or stolen instances once XAudio2 has finished with their buffers.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pv	The voice.
+ * @param	force	  	Release everything, for when the voice has been destroyed.
+ */
+void VoicePool::releaseRetired(PooledVoice* pv, bool force)
+{
+	UINT32 ended = pv->buffersEnded.load();
+	size_t kept = 0;
+	for(size_t i = 0; i < pv->retired.size(); ++i){
+		if(force || (INT32)(ended - pv->retired[i].second) >= 0)
+			pv->retired[i].first->Release();
+		else
+			pv->retired[kept++] = pv->retired[i];
+	}
+	pv->retired.resize(kept);
+}
+
+/**
+ * @fn	void VoicePool::reclaim(PooledVoice* pv)
+ *
+ * @brief	Returns a voice whose instance has finished to the free list.
+ *
+ * @date	10/17/2026
+ */
+void VoicePool::reclaim(PooledVoice* pv)
+{
+	pv->pVoice->Stop( 0 );
+	instances.erase(pv->instance);
+	pv->instance = 0;
+	SAFE_RELEASE(pv->pAsset);
+	stats.active--;
+}
+
+/**
+ * @fn	void VoicePool::update(PooledVoice* pv)
+ *
+ * @brief	Reclaims the voice if its instance has finished and lets go of any retired assets it is done with.
+ *
+ * @date	10/17/2026
+ */
+void VoicePool::update(PooledVoice* pv)
+{
+	if(pv->instance != 0 && !pv->isPlaying())
+		reclaim(pv);
+	releaseRetired(pv, false);
+}
+
+/**
+ * @fn	VoicePool::PooledVoice* VoicePool::findFree(VOICE_LIST& voices)
+ *
+ * @brief	Finds a voice that is not playing anything, reclaiming finished ones along the way.
+ *
+ * @date	10/17/2026
+ *
+ * @return	null if every voice is busy.
+ */
+VoicePool::PooledVoice* VoicePool::findFree(VOICE_LIST& voices)
+{
+	PooledVoice* pFree = NULL;
+	for(size_t i = 0; i < voices.size(); ++i){
+		PooledVoice* pv = voices[i];
+		update(pv);
+		if(pFree == NULL && pv->instance == 0)
+			pFree = pv;
+	}
+	return pFree;
+}
+
+/**
+ * @fn	VoicePool::PooledVoice* VoicePool::findVictim(VOICE_LIST& voices, UINT32 priority)
+ *
+ * @brief	Picks a busy voice to take over according to the steal policy. Ties go to the oldest instance.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	voices	The voices of one format, all busy.
+ * @param	priority	  	Priority of the instance that wants a voice.
+ *
+ * @return	null if nothing may be stolen.
+ */
+VoicePool::PooledVoice* VoicePool::findVictim(VOICE_LIST& voices, UINT32 priority)
+{
+	if(stealPolicy == VOICE_STEAL_NONE)
+		return NULL;
+
+	PooledVoice* pVictim = NULL;
+	for(size_t i = 0; i < voices.size(); ++i){
+		PooledVoice* pv = voices[i];
+		if(pv->instance == 0)
+			continue;
+		if(pVictim == NULL){
+			pVictim = pv;
+			continue;
+		}
+		bool older = pv->instance < pVictim->instance;
+		switch(stealPolicy){
+			case VOICE_STEAL_OLDEST:
+				if(older)
+					pVictim = pv;
+				break;
+			case VOICE_STEAL_QUIETEST:
+				if(pv->volume < pVictim->volume || (pv->volume == pVictim->volume && older))
+					pVictim = pv;
+				break;
+			case VOICE_STEAL_LOWEST_PRIORITY:
+				if(pv->priority < pVictim->priority || (pv->priority == pVictim->priority && older))
+					pVictim = pv;
+				break;
+		}
+	}
+	if(pVictim != NULL && stealPolicy == VOICE_STEAL_LOWEST_PRIORITY && pVictim->priority > priority)
+		return NULL;
+	return pVictim;
+}
+
+/**
+ * @fn	VOICE_INSTANCE VoicePool::play(PcmAsset* pAsset, UINT32 priority, FLOAT32 volume,
+ * 		IXAudio2Voice* pOutput)
+ *
+ * @brief	Starts a fire-and-forget instance of an asset on a free voice of its format, stealing a busy one
+ * 			if the format has none free.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pAsset	The sample data to play. The pool holds a reference while it plays.
+ * @param	priority	  	Priority of the instance, used by VOICE_STEAL_LOWEST_PRIORITY. Higher wins.
+ * @param	volume		  	Volume of the instance, also used by VOICE_STEAL_QUIETEST.
+ * @param [in,out]	pOutput	The submix (bus) to play through, NULL for the mastering voice. The voice is
+ * 							only rerouted if it last played through a different one.
+ *
+ * @return	The new instance, or 0 if no voice could be had.
+ */
+VOICE_INSTANCE VoicePool::play(PcmAsset* pAsset, UINT32 priority, FLOAT32 volume, IXAudio2Voice* pOutput)
+{
+	if(pAsset == NULL || FAILED( reserve( pAsset->getFormat() ) ))
+	{
+		stats.rejected++;
+		return 0;
+	}
+
+	VOICE_LIST& voices = formats[formatKey(pAsset->getFormat())];
+	PooledVoice* pv = findFree(voices);
+	if(pv == NULL){
+		if((pv = findVictim(voices, priority)) == NULL){
+			stats.rejected++;
+			return 0;
+		}
+		retire(pv);
+		stats.steals++;
+	}
+
+	XAUDIO2_BUFFER buffer = {0};
+	buffer.Flags = XAUDIO2_END_OF_STREAM;
+	buffer.AudioBytes = pAsset->getSize();
+	buffer.pAudioData = pAsset->getData();
+
+	HRESULT hr;
+	if( pv->pOutput != pOutput )
+	{
+		XAUDIO2_SEND_DESCRIPTOR send = { 0, pOutput };
+		XAUDIO2_VOICE_SENDS sends = { 1, &send };
+		if( FAILED( hr = pv->pVoice->SetOutputVoices( pOutput != NULL ? &sends : NULL ) ) )
+		{
+			AUDIO_LOG_ERROR(L"VoicePool::play(): error %#X routing voice", hr);
+			stats.rejected++;
+			return 0;
+		}
+		pv->pOutput = pOutput;
+	}
+	pv->pVoice->SetVolume( volume );
+	pv->pVoice->SetFrequencyRatio( 1.0f );
+	if( FAILED( hr = pv->pVoice->SubmitSourceBuffer( &buffer ) ) )
+	{
+		AUDIO_LOG_ERROR(L"VoicePool::play(): error %#X submitting source buffer", hr);
+		stats.rejected++;
+		return 0;
+	}
+	pv->buffersSubmitted++;
+	pv->pVoice->Start( 0 );
+
+	pAsset->AddRef();
+	pv->pAsset = pAsset;
+	pv->priority = priority;
+	pv->volume = volume;
+	pv->instance = nextInstance++;
+	instances[pv->instance] = pv;
+
+	stats.plays++;
+	stats.active++;
+	if(stats.active > stats.peakActive)
+		stats.peakActive = stats.active;
+	return pv->instance;
+}
+
+/**
+ * @fn	IXAudio2SourceVoice* VoicePool::getVoice(VOICE_INSTANCE instance)
+ *
+ * @brief	Gets the voice an instance is playing on, e.g. to position it with BasicAudio::play3DVoice().
+ *
+ * @date	10/17/2026
+ *
+ * @return	null if the instance has finished or been stolen.
+ */
+IXAudio2SourceVoice* VoicePool::getVoice(VOICE_INSTANCE instance)
+{
+	INSTANCE_MAP::iterator got = instances.find(instance);
+	if(got == instances.end() || !got->second->isPlaying())
+		return NULL;
+	return got->second->pVoice;
+}
+
+/**
+ * @fn	void VoicePool::stop(VOICE_INSTANCE instance)
+ *
+ * @brief	Stops an instance early and frees its voice.
+ *
+ * @date	10/17/2026
+ */
+void VoicePool::stop(VOICE_INSTANCE instance)
+{
+	INSTANCE_MAP::iterator got = instances.find(instance);
+	if(got == instances.end())
+		return;
+
+	retire(got->second);
+}
+
+/**
+ * @fn	void VoicePool::run()
+ *
+ * @brief	Returns voices whose instances have finished to the pool. Called from BasicAudio::run(). Only the
+ * 			voices that have had a buffer end since the last call are looked at, unless the ring overflowed, in
+ * 			which case every voice is.
+ *
+ * @date	10/17/2026
+ */
+void VoicePool::run()
+{
+	UINT32 count = ended.getDepth();
+	PooledVoice* pv;
+	for(UINT32 i = 0; i < count && ended.pop(&pv); ++i){
+		update(pv);
+	}
+
+	CommandRingStats ringStats;
+	ended.getStats(&ringStats);
+	if(ringStats.dropped == lostEnds)
+		return;
+	lostEnds = ringStats.dropped;
+	for(FORMAT_MAP::iterator it = formats.begin(); it != formats.end(); ++it){
+		VOICE_LIST& voices = it->second;
+		for(size_t i = 0; i < voices.size(); ++i){
+			update(voices[i]);
+		}
+	}
+}
+
+/**
+ * @fn	void VoicePool::destroy()
+ *
+ * @brief	Destroys all the voices and releases the assets they were playing. Must be called before the
+ * 			engine is released.
+ *
+ * @date	10/17/2026
+ */
+void VoicePool::destroy()
+{
+	for(FORMAT_MAP::iterator it = formats.begin(); it != formats.end(); ++it){
+		VOICE_LIST& voices = it->second;
+		for(size_t i = 0; i < voices.size(); ++i){
+			PooledVoice* pv = voices[i];
+			pv->pVoice->DestroyVoice(); // blocks until XAudio2 is done with the voice
+			SAFE_RELEASE(pv->pAsset);
+			releaseRetired(pv, true);
+			delete pv;
+		}
+	}
+	formats.clear();
+	instances.clear();
+	memset(&stats, 0, sizeof(stats));
+
+	// the voices are gone, so are the ends they queued
+	PooledVoice* pv;
+	while(ended.pop(&pv)){}
+}
+
+/**
+ * @fn	void VoicePool::getStats(VoicePoolStats* stats)
+ *
+ * @brief	Copies out the occupancy counters.
+ *
+ * @date	10/17/2026
+ */
+void VoicePool::getStats(VoicePoolStats* stats)
+{
+	*stats = this->stats;
+}
@@ -0,0 +1,433 @@
+#include "StdAfx.h"
+#include "VoiceVirtualizer.h"
+#include "VoicePool.h"
+#include "AudioLog.h"
+#include <algorithm>
+#include <functional>
+
+/**
+ * @fn	VoiceVirtualizer::VoiceVirtualizer(void)
+ *
+ * @brief	Default constructor. Nothing can be promoted until init() has been called.
+ *
+ * @date	10/17/2026
+ */
+VoiceVirtualizer::VoiceVirtualizer(void)
+{
+	pXaudio2 = NULL;
+	budget = VIRTUAL_VOICE_BUDGET;
+	promotions = 0;
+	demotions = 0;
+}
+
+/**
+ * @fn	VoiceVirtualizer::~VoiceVirtualizer(void)
+ *
+ * @brief	Destructor. Destroys the voices.
+ *
+ * @date	10/17/2026
+ */
+VoiceVirtualizer::~VoiceVirtualizer(void)
+{
+	destroy();
+}
+
+/**
+ * @fn	void VoiceVirtualizer::init(IXAudio2* pXaudio2, UINT32 budget)
+ *
+ * @brief	Sets the engine the voices are made on and how many sounds may have one.
+ *
+ * @date	10/17/2026
+ */
+void VoiceVirtualizer::init(IXAudio2* pXaudio2, UINT32 budget)
+{
+	this->pXaudio2 = pXaudio2;
+	this->budget = budget;
+}
+
+/**
+ * @fn	void VoiceVirtualizer::add(WavSampleSound* pSound)
+ *
+ * @brief	Takes charge of a sound made with setVirtual(true). It need not have finished loading; it is looked
+ * 			at from the first update() after it has.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pSound	The sound, which must stay alive until remove() or destroy().
+ */
+void VoiceVirtualizer::add(WavSampleSound* pSound)
+{
+	VirtualSound vs;
+	memset(&vs, 0, sizeof(vs));
+	vs.pSound = pSound;
+	vs.voice = -1;
+	vs.format = NO_FORMAT;
+	vs.state = VIRTUAL_STOPPED;
+	sounds.push_back(vs);
+}
+
+/**
+ * @fn	bool VoiceVirtualizer::remove(SampleSound* pSound)
+ *
+ * @brief	Lets go of a sound before it is destroyed, taking back its voice if it has one.
+ *
+ * @date	10/17/2026
+ *
+ * @return	false if the sound wasn't added.
+ */
+bool VoiceVirtualizer::remove(SampleSound* pSound)
+{
+	for(size_t i = 0; i < sounds.size(); ++i){
+		if(sounds[i].pSound != pSound)
+			continue;
+		release(sounds[i]);
+		sounds[i] = sounds.back();
+		sounds.pop_back();
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @fn	bool VoiceVirtualizer::prepare(VirtualSound& vs)
+ *
+ * @brief	Fills in the length, rate and format of a sound once it has loaded.
+ *
+ * @date	10/17/2026
+ *
+ * @return	false while the sound can't play yet.
+ */
+bool VoiceVirtualizer::prepare(VirtualSound& vs)
+{
+	PcmAsset* pAsset = vs.pSound->getAsset();
+	if(pAsset == NULL)
+		return false;
+	const WAVEFORMATEX* pwfx = pAsset->getFormat();
+	vs.frames = pAsset->getSize() / pwfx->nBlockAlign;
+	vs.frameRate = (FLOAT32)pwfx->nSamplesPerSec;
+
+	string key = VoicePool::formatKey(pwfx);
+	unordered_map<string, UINT32>::iterator got = formats.find(key);
+	if(got == formats.end()){
+		got = formats.insert(make_pair(key, (UINT32)freeVoices.size())).first;
+		freeVoices.push_back(vector<UINT32>());
+	}
+	vs.format = got->second;
+	return true;
+}
+
+/**
+ * @fn	bool VoiceVirtualizer::advance(VirtualSound& vs, FLOAT32 rate, double seconds)
+ *
+ * @brief	Moves a playing sound's position on, wrapping it as the sound loops and queueing the loop events.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	vs	The sound.
+ * @param	rate	  	Its frequency ratio: the Doppler its voice was given, or 1 without a voice.
+ * @param	seconds   	Time since the last update().
+ *
+ * @return	false if the sound has played to the end of its last loop.
+ */
+bool VoiceVirtualizer::advance(VirtualSound& vs, FLOAT32 rate, double seconds)
+{
+	vs.position += seconds * vs.frameRate * rate;
+	UINT loopCount = vs.pSound->getLoopCount();
+	while(vs.position >= vs.frames){
+		if(vs.frames == 0 || (loopCount != XAUDIO2_LOOP_INFINITE && vs.loopsPlayed >= loopCount))
+			return false;
+		vs.position -= vs.frames;
+		vs.loopsPlayed++;
+		events.push_back(make_pair(vs.pSound, SOUND_EVENT_LOOP_END));
+	}
+	return true;
+}
+
+/**
+ * @fn	INT32 VoiceVirtualizer::acquire(VirtualSound& vs)
+ *
+ * @brief	Finds an idle voice of the sound's format, or makes one. A voice that was taken back may still be
+ * 			finishing its flush, so only one with nothing queued is reused.
+ *
+ * @date	10/17/2026
+ *
+ * @return	Index of the voice, now off the free list, or -1 if none could be made.
+ */
+INT32 VoiceVirtualizer::acquire(VirtualSound& vs)
+{
+	vector<UINT32>& idle = freeVoices[vs.format];
+	for(size_t i = 0; i < idle.size(); ++i){
+		XAUDIO2_VOICE_STATE state;
+		voices[idle[i]].pVoice->GetState( &state );
+		if(state.BuffersQueued == 0){
+			INT32 index = (INT32)idle[i];
+			idle[i] = idle.back();
+			idle.pop_back();
+			return index;
+		}
+		// the voice has stopped by now, so this flush takes the buffer that was playing when it was released
+		voices[idle[i]].pVoice->FlushSourceBuffers();
+	}
+
+	Voice v;
+	v.pOutput = vs.pSound->getOutputVoice();
+	v.format = vs.format;
+	XAUDIO2_SEND_DESCRIPTOR send = { 0, v.pOutput };
+	XAUDIO2_VOICE_SENDS sends = { 1, &send };
+	HRESULT hr = pXaudio2->CreateSourceVoice( &v.pVoice, vs.pSound->getAsset()->getFormat(), 0,
+		XAUDIO2_DEFAULT_FREQ_RATIO, NULL, v.pOutput != NULL ? &sends : NULL );
+	if( FAILED( hr ) )
+	{
+		AUDIO_LOG_ERROR(L"VoiceVirtualizer::acquire(): error %#X creating source voice", hr);
+		return -1;
+	}
+	voices.push_back(v);
+	return (INT32)voices.size() - 1;
+}
+
+/**
+ * @fn	bool VoiceVirtualizer::promote(VirtualSound& vs)
+ *
+ * @brief	Lends a silent sound a voice, playing from where the sound has got to with the loops it has left,
+ * 			at zero volume for now.
+ *
+ * @date	10/17/2026
+ *
+ * @return	false if there was no voice to be had or the buffer was refused; the sound stays silent.
+ */
+bool VoiceVirtualizer::promote(VirtualSound& vs)
+{
+	if(pXaudio2 == NULL)
+		return false;
+	INT32 index = acquire(vs);
+	if(index < 0)
+		return false;
+	Voice& v = voices[index];
+	WavSampleSound* pSound = vs.pSound;
+	PcmAsset* pAsset = pSound->getAsset();
+
+	HRESULT hr = S_OK;
+	if( v.pOutput != pSound->getOutputVoice() )
+	{
+		XAUDIO2_SEND_DESCRIPTOR send = { 0, pSound->getOutputVoice() };
+		XAUDIO2_VOICE_SENDS sends = { 1, &send };
+		if( SUCCEEDED( hr = v.pVoice->SetOutputVoices( send.pOutputVoice != NULL ? &sends : NULL ) ) )
+			v.pOutput = send.pOutputVoice;
+	}
+
+	UINT loopCount = pSound->getLoopCount();
+	XAUDIO2_BUFFER buffer = {0};
+	buffer.Flags = XAUDIO2_END_OF_STREAM;
+	buffer.AudioBytes = pAsset->getSize();
+	buffer.pAudioData = pAsset->getData();
+	buffer.PlayBegin = (UINT32)vs.position;
+	buffer.LoopCount = (loopCount == XAUDIO2_LOOP_INFINITE) ? XAUDIO2_LOOP_INFINITE : loopCount - vs.loopsPlayed;
+	buffer.pContext = (void*)(UINT_PTR)pSound->getHandle();
+
+	v.pVoice->SetVolume( 0.0f );
+	v.pVoice->SetFrequencyRatio( 1.0f );
+	if( SUCCEEDED( hr ) )
+		hr = v.pVoice->SubmitSourceBuffer( &buffer );
+	if( FAILED( hr ) )
+	{
+		AUDIO_LOG_ERROR(L"VoiceVirtualizer::promote(): error %#X starting %s", hr, pSound->getName());
+		freeVoices[vs.format].push_back((UINT32)index);
+		return false;
+	}
+	v.pVoice->Start( 0 );
+
+	vs.voice = index;
+	vs.appliedVolume = 0.0f;
+	vs.state = VIRTUAL_FADING_IN;
+	pSound->attachVoice(v.pVoice);
+	promotions++;
+	return true;
+}
+
+/**
+ * @fn	void VoiceVirtualizer::release(VirtualSound& vs)
+ *
+ * @brief	Stops a sound's voice, if it has one, and puts it back on the free list. The sound may have been
+ * 			routed to another bus while it held the voice, which rerouted the voice too.
+ *
+ * @date	10/17/2026
+ */
+void VoiceVirtualizer::release(VirtualSound& vs)
+{
+	if(vs.voice < 0)
+		return;
+	Voice& v = voices[vs.voice];
+	v.pVoice->Stop( 0 );
+	v.pVoice->FlushSourceBuffers();
+	v.pOutput = vs.pSound->getOutputVoice();
+	freeVoices[v.format].push_back((UINT32)vs.voice);
+	vs.voice = -1;
+	vs.pSound->attachVoice(NULL);
+}
+
+/**
+ * @fn	void VoiceVirtualizer::setVolume(VirtualSound& vs, FLOAT32 volume)
+ *
+ * @brief	Gives the sound's voice a volume if it doesn't already have it.
+ *
+ * @date	10/17/2026
+ */
+void VoiceVirtualizer::setVolume(VirtualSound& vs, FLOAT32 volume)
+{
+	if(vs.appliedVolume == volume)
+		return;
+	voices[vs.voice].pVoice->SetVolume( volume );
+	vs.appliedVolume = volume;
+}
+
+/**
+ * @fn	void VoiceVirtualizer::update(EmitterSoA* pEmitters, double seconds,
+ * 		vector<SampleSound*>* pPromoted)
+ *
+ * @brief	Moves every playing virtual sound on by seconds, then gives voices to the budget's worth of the most
+ * 			audible ones and takes them from the rest. Called from BasicAudio::run(), after
+ * 			Spatializer::estimateAudibility() has filled in pEmitters->audibility.
+ *
+ * 			The work is a pass over the virtual sounds and a partial sort of the audible ones, whatever they
+ * 			are doing; only the sounds whose voices change cost engine calls.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pEmitters	The store the sounds' emitters are in.
+ * @param	seconds			 	Time since the last update().
+ * @param [out]	pPromoted	 	Sounds given a voice by this update are appended here, so the caller can
+ * 								position them before they are turned up.
+ */
+void VoiceVirtualizer::update(EmitterSoA* pEmitters, double seconds, vector<SampleSound*>* pPromoted)
+{
+	candidates.clear();
+	chosen.assign(sounds.size(), 0);
+
+	for(UINT32 i = 0; i < sounds.size(); ++i){
+		VirtualSound& vs = sounds[i];
+		WavSampleSound* pSound = vs.pSound;
+		if(vs.format == NO_FORMAT && !prepare(vs))
+			continue;
+
+		// started again since the last update: from the top, on a fresh voice if it is heard
+		if(pSound->getStartCount() != vs.starts){
+			vs.starts = pSound->getStartCount();
+			release(vs);
+			vs.position = 0;
+			vs.loopsPlayed = 0;
+			vs.state = VIRTUAL_SILENT;
+		}
+		if(!pSound->isPlaying()){
+			release(vs);
+			vs.state = VIRTUAL_STOPPED;
+			continue;
+		}
+
+		UINT32 emitter = pSound->getEmitterIndex();
+		FLOAT32 rate = (vs.voice >= 0 && pEmitters->spatialized[emitter]) ? pEmitters->appliedDoppler[emitter] : 1.0f;
+		if(!advance(vs, rate, seconds)){
+			release(vs);
+			vs.state = VIRTUAL_STOPPED;
+			events.push_back(make_pair(pSound, SOUND_EVENT_END));
+			continue;
+		}
+
+		FLOAT32 audibility = pEmitters->audibility[emitter];
+		if(audibility < VIRTUAL_VOICE_MIN_AUDIBILITY)
+			continue;
+		if(vs.voice >= 0 && vs.state != VIRTUAL_FADING_OUT)
+			audibility *= VIRTUAL_VOICE_HYSTERESIS;
+		candidates.push_back(make_pair(audibility, i));
+	}
+
+	// the most audible, in no particular order
+	size_t keep = min((size_t)budget, candidates.size());
+	if(keep < candidates.size())
+		nth_element(candidates.begin(), candidates.begin() + keep, candidates.end(), greater<pair<FLOAT32, UINT32> >());
+	for(size_t k = 0; k < keep; ++k){
+		chosen[candidates[k].second] = 1;
+	}
+
+	// turn up the ones that keep their voices, turn down or let go of the rest
+	for(UINT32 i = 0; i < sounds.size(); ++i){
+		VirtualSound& vs = sounds[i];
+		if(vs.voice < 0)
+			continue;
+		if(chosen[i]){
+			setVolume(vs, vs.pSound->getVolume());
+			vs.state = VIRTUAL_REAL;
+		}else if(vs.state == VIRTUAL_FADING_OUT){
+			release(vs);
+			vs.state = VIRTUAL_SILENT;
+			demotions++;
+		}else{
+			setVolume(vs, 0.0f);
+			vs.state = VIRTUAL_FADING_OUT;
+		}
+	}
+
+	for(size_t k = 0; k < keep; ++k){
+		VirtualSound& vs = sounds[candidates[k].second];
+		if(vs.voice < 0 && promote(vs) && pPromoted != NULL)
+			pPromoted->push_back(vs.pSound);
+	}
+
+	// last, as a callback may start or make sounds
+	for(size_t i = 0; i < events.size(); ++i){
+		SoundEvent e = { (UINT32)events[i].second, events[i].first->getHandle(), S_OK };
+		events[i].first->onEvent(e);
+	}
+	events.clear();
+}
+
+/**
+ * @fn	void VoiceVirtualizer::destroy()
+ *
+ * @brief	Takes the voices back from the sounds, destroys them and forgets the sounds.
+ *
+ * @date	10/17/2026
+ */
+void VoiceVirtualizer::destroy()
+{
+	for(size_t i = 0; i < sounds.size(); ++i){
+		if(sounds[i].voice >= 0)
+			sounds[i].pSound->attachVoice(NULL);
+	}
+	for(size_t i = 0; i < voices.size(); ++i){
+		voices[i].pVoice->DestroyVoice();
+	}
+	sounds.clear();
+	voices.clear();
+	freeVoices.clear();
+	formats.clear();
+	candidates.clear();
+	chosen.clear();
+	events.clear();
+}
+
+/**
+ * @fn	void VoiceVirtualizer::getStats(VirtualVoiceStats* stats)
+ *
+ * @brief	Counts the sounds that are playing and have voices; this walks them all.
+ *
+ * @date	10/17/2026
+ */
+void VoiceVirtualizer::getStats(VirtualVoiceStats* stats)
+{
+	memset(stats, 0, sizeof(VirtualVoiceStats));
+	stats->sounds = (UINT32)sounds.size();
+	for(size_t i = 0; i < sounds.size(); ++i){
+		if(sounds[i].state != VIRTUAL_STOPPED)
+			stats->playing++;
+		if(sounds[i].voice >= 0)
+			stats->real++;
+	}
+	stats->budget = budget;
+	stats->voices = (UINT32)voices.size();
+	stats->promotions = promotions;
+	stats->demotions = demotions;
+}
+
+/**
+// End of VoiceVirtualizer.cpp
+ */
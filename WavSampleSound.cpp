@@ -1,5 +1,6 @@
 #include "StdAfx.h"
 #include "WavSampleSound.h"
+#include "AudioLog.h"
 #include <stdio.h>
 
 /**
@@ -12,10 +13,21 @@
  * @date	6/7/2013
  */
 
-WavSampleSound::WavSampleSound(void)
+WavSampleSound::WavSampleSound(void) : loadState(SOUND_LOAD_FAILED)
 {
 	creationComplete = false;
 	isRunning = false;
+	pAssetCache = NULL;
+	pAsset = NULL;
+	pBank = NULL;
+	bankIndex = 0;
+	pbWaveData = NULL;
+	cbWaveSize = 0;
+	loopCount = 0;
+	loadResult = S_OK;
+	startPending = false;
+	virtualVoice = false;
+	starts = 0;
 
 	buffer.Flags = 0;                       // Either 0 or XAUDIO2_END_OF_STREAM.
 	buffer.AudioBytes = 0;                  // Size of the audio data buffer in bytes.
@@ -65,54 +77,164 @@ WavSampleSound::~WavSampleSound(void)
  */
 HRESULT WavSampleSound::initPCM( IXAudio2* pXaudio2, LPCWSTR szFilename, UINT loopCount )
 {
-	HRESULT hr = S_OK;
+	HRESULT hr;
+	beginLoad( szFilename, loopCount );
+	if( FAILED( hr = loadAsset() ) )
+		return hr;
+	return finishLoad( pXaudio2 );
+}
+
+/**
+ * @fn	void WavSampleSound::beginLoad( LPCWSTR szFilename, UINT loopCount )
+ *
+ * @brief	First step of initPCM(): records what is to be loaded and marks the sound PENDING. Called on the
+ * 			thread that owns the sound.
+ *
+ * @date	10/17/2026
+ */
+void WavSampleSound::beginLoad( LPCWSTR szFilename, UINT loopCount )
+{
 	setFileName(szFilename);
+	this->loopCount = loopCount;
+	startPending = false;
+	loadResult = S_OK;
+	loadState.store(SOUND_LOAD_PENDING, memory_order_release);
+}
+
+/**
+ * @fn	void WavSampleSound::setSoundBank(SoundBank* pBank, UINT32 index)
+ *
+ * @brief	Takes the sound from a bank rather than a file. Call before beginLoad(); the file name is then only
+ * 			the sound's name.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pBank	The bank, or NULL to go back to loading files. A reference is held.
+ * @param	index		 	Index of the sound in the bank, from SoundBank::find().
+ */
+void WavSampleSound::setSoundBank(SoundBank* pBank, UINT32 index)
+{
+	if(pBank != NULL)
+		pBank->AddRef();
+	SAFE_RELEASE( this->pBank );
+	this->pBank = pBank;
+	bankIndex = index;
+}
+
+/**
+ * @fn	HRESULT WavSampleSound::loadAsset()
+ *
+ * @brief	Second step of initPCM(): finds the file and gets its sample data, which is the slow part (unless
+ * 			the sound is in a bank, when there is no file to find or parse). This
+ * 			touches nothing but the asset members and the (thread safe) asset cache, so it may run on a loader
+ * 			thread while the owner carries on. The state moves to LOADED or FAILED when it is done.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or the error from finding or reading the file.
+ */
+HRESULT WavSampleSound::loadAsset()
+{
+	HRESULT hr = S_OK;
+	LPCWSTR szFilename = getFileName();
+	if( pBank != NULL )
+	{
+		if( pAssetCache != NULL )
+			hr = pAssetCache->acquire( pBank, bankIndex, &pAsset );
+		else
+			hr = PcmAsset::create( pBank, bankIndex, &pAsset );
+		if( FAILED( hr ) )
+		{
+			AUDIO_LOG_ERROR(L"Failed reading %s from sound bank: %#X", szFilename, hr);
+			loadResult = hr;
+			loadState.store(SOUND_LOAD_FAILED, memory_order_release);
+			return hr;
+		}
+		cbWaveSize = pAsset->getSize();
+		pbWaveData = pAsset->getData();
+		loadState.store(SOUND_LOAD_LOADED, memory_order_release);
+		return hr;
+	}
+
 	//
 	// Locate the wave file
 	//
 	WCHAR strFilePath[MAX_PATH];
 	if( FAILED( hr = FindMediaFileCch( strFilePath, MAX_PATH, szFilename ) ) )
 	{
-		fwprintf(stderr, L"Failed to find media file: %s\n", szFilename );
+		AUDIO_LOG_ERROR(L"Failed to find media file: %s", szFilename);
+		loadResult = hr;
+		loadState.store(SOUND_LOAD_FAILED, memory_order_release);
 		return hr;
 	}
 
 	//
-	// Read in the wave file
+	// Get the wave file, shared with any other sound that uses the same file if there is a cache.
+	// Integer PCM comes back already converted to the engine's float format, so the voice format
+	// depends only on the rate and channel count of the file
 	//
-	if( FAILED( hr = wav.Open( strFilePath, NULL, WAVEFILE_READ ) ) )
+	if( pAssetCache != NULL )
+		hr = pAssetCache->acquire( strFilePath, &pAsset );
+	else
+		hr = PcmAsset::create( strFilePath, &pAsset );
+	if( FAILED( hr ) )
 	{
-		fwprintf(stderr, L"Failed reading WAV file: %#X (%s)\n", hr, strFilePath );
+		AUDIO_LOG_ERROR(L"Failed reading WAV file: %#X (%s)", hr, strFilePath);
+		loadResult = hr;
+		loadState.store(SOUND_LOAD_FAILED, memory_order_release);
 		return hr;
 	}
 
-	// Get format of wave file
-	WAVEFORMATEX* pwfx = wav.GetFormat();
+	// The sample data is owned by the asset
+	cbWaveSize = pAsset->getSize();
+	pbWaveData = pAsset->getData();
 
-	// Calculate how many bytes and samples are in the wave
-	cbWaveSize = wav.GetSize();
+	loadState.store(SOUND_LOAD_LOADED, memory_order_release);
+	return hr;
+}
 
-	// Read the sample data into memory
-	pbWaveData = new BYTE[ cbWaveSize ];
+/**
+ * @fn	HRESULT WavSampleSound::finishLoad( IXAudio2* pXaudio2 )
+ *
+ * @brief	Last step of initPCM(): makes the source voice for the loaded data. Called on the thread that owns
+ * 			the sound once getLoadState() is LOADED. If start() was called in the meantime the sound starts now.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pXaudio2	The engine to make the voice on.
+ *
+ * @return	S_OK, the error from loading or the error from making the voice.
+ */
+HRESULT WavSampleSound::finishLoad( IXAudio2* pXaudio2 )
+{
+	HRESULT hr = S_OK;
+	if( getLoadState() != SOUND_LOAD_LOADED )
+		return FAILED( loadResult ) ? loadResult : S_FAILED;
 
-	if( FAILED( hr = wav.Read( pbWaveData, cbWaveSize, &cbWaveSize ) ) )
-	{
-		fwprintf(stderr, L"Failed to read WAV data: %#X\n", hr );
-		SAFE_DELETE_ARRAY( pbWaveData );
-		return hr;
-	}
+	// Get format of the sample data
+	const WAVEFORMATEX* pwfx = pAsset->getFormat();
 
 	//
 	// Play the wave using a XAudio2SourceVoice
 	//
 
-	// Create the source voice
-	if( FAILED( hr = pXaudio2->CreateSourceVoice( &pSourceVoice, pwfx ) ) )
+	// Create the source voice, reporting buffer ends through the event callback if there is one,
+	// and sending to the sound's bus if it has one. A virtual sound gets its voices from the virtualizer
+	XAUDIO2_SEND_DESCRIPTOR send = { 0, pOutputVoice };
+	XAUDIO2_VOICE_SENDS sends = { 1, &send };
+	if( !virtualVoice && FAILED( hr = pXaudio2->CreateSourceVoice( &pSourceVoice, pwfx, 0, XAUDIO2_DEFAULT_FREQ_RATIO, pEventCallback,
+		pOutputVoice != NULL ? &sends : NULL ) ) )
 	{
-		fwprintf(stderr, L"Error %#X creating source voice\n", hr );
-		SAFE_DELETE_ARRAY( pbWaveData );
+		AUDIO_LOG_ERROR(L"Error %#X creating source voice", hr);
+		SAFE_RELEASE( pAsset );
+		pbWaveData = NULL;
+		loadResult = hr;
+		loadState.store(SOUND_LOAD_FAILED, memory_order_release);
 		return hr;
 	}
+	this->pXaudio2 = pXaudio2;
+	if( pwfx->nChannels != getEmitterChannels() )
+		setEmitterChannels( pwfx->nChannels );
 
 	// Submit the wave sample data using an XAUDIO2_BUFFER structure
 	buffer.pAudioData = pbWaveData;
@@ -122,39 +244,66 @@ HRESULT WavSampleSound::initPCM( IXAudio2* pXaudio2, LPCWSTR szFilename, UINT lo
 
 	creationComplete = true;
 	isRunning = false;
+	invalidate3D(); // the new voice has not been positioned yet
+	loadState.store(SOUND_LOAD_READY, memory_order_release);
+
+	if( startPending )
+	{
+		startPending = false;
+		hr = start();
+	}
 	return hr;
 }
 
 /**
  * @fn	HRESULT WavSampleSound::start()
  *
- * @brief	Start playing the sound if it's not already playing
+ * @brief	Start playing the sound if it's not already playing. A sound from BasicAudio::createSoundAsync()
+ * 			that is still loading remembers the request and starts once it is ready, unless stop() is called
+ * 			first.
  *
  * @author	Phil
  * @date	6/7/2013
  *
- * @return	S_OK (0) or S_FAILED (-1), depending on success.
+ * @return	S_OK (0) or S_FAILED (-1), depending on success, or S_FALSE (1) if the start was queued.
  */
 
 HRESULT WavSampleSound::start(){
 	if(!creationComplete){
+		// Still loading: play as soon as the voice is made
+		SOUND_LOAD_STATE state = getLoadState();
+		if(state == SOUND_LOAD_PENDING || state == SOUND_LOAD_LOADED){
+			startPending = true;
+			return S_FALSE;
+		}
 		return S_FAILED;
 	}
 	HRESULT hr = S_OK;
 
+	// A virtual sound just starts counting its position, the virtualizer decides if it is heard
+	if(virtualVoice){
+		if(!isRunning){
+			isRunning = true;
+			starts++;
+		}
+		return hr;
+	}
+
 	// Let the sound play
 	if(!isRunning){
+		buffer.pContext = (void*)(UINT_PTR)getHandle(); // tells the event callback which sound ended
 		if( FAILED( hr = pSourceVoice->SubmitSourceBuffer( &buffer ) ) )
 		{
-			fwprintf(stderr, L"Error %#X submitting source buffer\n", hr );
+			AUDIO_LOG_ERROR(L"Error %#X submitting source buffer", hr);
 			pSourceVoice->DestroyVoice();
-			SAFE_DELETE_ARRAY( pbWaveData );
+			SAFE_RELEASE( pAsset );
+			pbWaveData = NULL;
 			creationComplete = false;
 			return hr;
 		}
 		hr = pSourceVoice->Start( 0 );
 		isRunning = true;
-		fwprintf(stderr, L"WavSampleSound::stop(): starting playing %s\n", getFileName());
+		AUDIO_LOG_INFO(L"WavSampleSound::start(): starting playing %s", getFileName());
 	}
 
 	return hr;
@@ -170,10 +319,13 @@ HRESULT WavSampleSound::start(){
  */
 
 void WavSampleSound::stop(){
+	startPending = false;
 	if(creationComplete && isRunning){
-		pSourceVoice->Stop( 0 );
+		// a virtual sound's voice, if it has one, goes back to the virtualizer on its next update
+		if(pSourceVoice != NULL)
+			pSourceVoice->Stop( 0 );
 		isRunning = false;
-		fwprintf(stderr, L"WavSampleSound::stop(): stopped playing %s\n", getFileName());
+		AUDIO_LOG_INFO(L"WavSampleSound::stop(): stopped playing %s", getFileName());
 	}
 }
 
@@ -182,7 +334,7 @@ void WavSampleSound::stop(){
  *
  * @brief	Do periodic checks on the playing sound. Currently all this does is to check if the sound has stopped playing.
  * 			This means that if you want to not sample the state at all, simply call run once before you want to play the 
- * 			sound again.
+ * 			sound again. BasicAudio only calls this when it has lost events; normally onEvent() does the job.
  *
  * @author	Phil
  * @date	6/7/2013
@@ -190,13 +342,13 @@ void WavSampleSound::stop(){
  * @return	.
  */
 HRESULT WavSampleSound::run(){
-	if(isRunning && creationComplete)
+	if(isRunning && creationComplete && !virtualVoice)
 	{
 		XAUDIO2_VOICE_STATE state;
 		pSourceVoice->GetState( &state );
 		isRunning = ( state.BuffersQueued > 0 ) != 0;
 		if(!isRunning){
-			fwprintf(stderr, L"finished playing %s\n", getName());
+			AUDIO_LOG_INFO(L"finished playing %s", getName());
 			 //pSourceVoice->SubmitSourceBuffer( &buffer );
 		}
 	}
@@ -204,6 +356,51 @@ HRESULT WavSampleSound::run(){
 	return S_OK;
 }
 
+/**
+ * @fn	void WavSampleSound::onEvent(const SoundEvent& e)
+ *
+ * @brief	Handles an event queued by the voice callback. Only this sound's voice is looked at, so the cost
+ * 			doesn't depend on how many sounds there are. A buffer end that arrives after the sound was
+ * 			stopped and started again still has the new buffer queued behind it, and is ignored. A virtual
+ * 			sound's events come from the virtualizer, which has already checked them.
+ *
+ * @date	10/17/2026
+ */
+void WavSampleSound::onEvent(const SoundEvent& e){
+	if(!creationComplete)
+		return;
+	if(virtualVoice){
+		if(e.type != SOUND_EVENT_LOOP_END)
+			isRunning = false;
+	}else if(e.type == SOUND_EVENT_END || e.type == SOUND_EVENT_ERROR){
+		XAUDIO2_VOICE_STATE state;
+		pSourceVoice->GetState( &state );
+		if(e.type == SOUND_EVENT_END && state.BuffersQueued > 0)
+			return;
+		if(isRunning){
+			isRunning = false;
+			AUDIO_LOG_INFO(L"finished playing %s", getName());
+		}
+	}
+	notify((SOUND_EVENT)e.type);
+}
+
+/**
+ * @fn	void WavSampleSound::attachVoice(IXAudio2SourceVoice* pVoice)
+ *
+ * @brief	Called by the VoiceVirtualizer as it lends a virtual sound a voice, already playing from the right
+ * 			place, or takes it back. The new voice still needs its 3D output, hence the invalidate3D().
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	pVoice	The voice, or NULL when the sound goes back to being virtual.
+ */
+void WavSampleSound::attachVoice(IXAudio2SourceVoice* pVoice){
+	pSourceVoice = pVoice;
+	if(pVoice != NULL)
+		invalidate3D();
+}
+
 /**
  * @fn	void WavSampleSound::destroy()
  *
@@ -215,11 +412,16 @@ HRESULT WavSampleSound::run(){
  */
 
 void WavSampleSound::destroy(){
-	if(creationComplete){
+	if(creationComplete && !virtualVoice)
 		pSourceVoice->DestroyVoice();
-		SAFE_DELETE_ARRAY( pbWaveData );
-	}
+	pSourceVoice = NULL;
+	// a sound that was loaded but never got its voice still holds the asset
+	SAFE_RELEASE( pAsset );
+	SAFE_RELEASE( pBank );
+	pbWaveData = NULL;
 	creationComplete = false;
+	startPending = false;
+	loadState.store(SOUND_LOAD_FAILED, memory_order_release);
 }
 
 
@@ -0,0 +1,698 @@
+#include "WavStreamReader.h"
+#include <string.h>
+
+/**
+ * @fn	WavStreamReader::WavStreamReader(void)
+ *
+ * @brief	Default constructor. The reader does nothing until open() is called.
+ *
+ * @date	10/17/2026
+ */
+WavStreamReader::WavStreamReader(void)
+{
+	pFile = NULL;
+	pMemory = NULL;
+	memoryPos = 0;
+	memset(&wfx, 0, sizeof(wfx));
+	memset(&adpcm, 0, sizeof(adpcm));
+	pCompressed = NULL;
+	decodedBlockBytes = 0;
+	dataOffset = 0;
+	dataSize = 0;
+	dataRemaining = 0;
+	dataFrames = 0;
+	framesRemaining = 0;
+	loopCount = 0;
+	loopsRemaining = 0;
+	readComplete = false;
+
+	pRingData = NULL;
+	blocks = NULL;
+	bufferBytes = 0;
+	bufferCount = 0;
+	fillIndex = 0;
+	acquireIndex = 0;
+	emptyCount = 0;
+	filledCount = 0;
+	inUseCount = 0;
+
+	readyCallback = NULL;
+	pReadyContext = NULL;
+
+	threadRunning = false;
+	quit = false;
+
+	memset(&stats, 0, sizeof(stats));
+	totalRefillMicros = 0;
+}
+
+/**
+ * @fn	WavStreamReader::~WavStreamReader(void)
+ *
+ * @brief	Destructor. Stops the reader thread and closes the file.
+ *
+ * @date	10/17/2026
+ */
+WavStreamReader::~WavStreamReader(void)
+{
+	close();
+}
+
+/**
+ * @fn	HRESULT WavStreamReader::open(const char* szFilename, UINT32 bufferBytes, UINT32 bufferCount,
+ * 		UINT32 loopCount)
+ *
+ * @brief	Opens a WAV file, parses the RIFF header and allocates the ring. No sample data is read until
+ * 			start() is called.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szFilename 	Name of the file.
+ * @param	bufferBytes	Size of each ring buffer. Rounded down to a whole number of sample frames, or of
+ * 						decoded blocks for ADPCM.
+ * @param	bufferCount	Number of buffers in the ring (at least 2).
+ * @param	loopCount  	Number of times to repeat the file. STREAM_LOOP_INFINITE loops forever.
+ *
+ * @return	S_OK, E_FILE_NOT_FOUND if the file can't be opened or E_FAIL if it is not a WAV file.
+ */
+HRESULT WavStreamReader::open(const char* szFilename, UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount)
+{
+	close();
+
+	if(szFilename == NULL)
+		return E_INVALIDARG;
+
+	pFile = fopen(szFilename, "rb");
+	if(pFile == NULL)
+		return E_FILE_NOT_FOUND;
+
+	HRESULT hr;
+	if(FAILED(hr = parseHeader()) || FAILED(hr = allocateRing(bufferBytes, bufferCount, loopCount))){
+		close();
+	}
+	return hr;
+}
+
+#ifdef _WIN32
+HRESULT WavStreamReader::open(const wchar_t* szFilename, UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount)
+{
+	close();
+
+	if(szFilename == NULL)
+		return E_INVALIDARG;
+
+	pFile = _wfopen(szFilename, L"rb");
+	if(pFile == NULL)
+		return E_FILE_NOT_FOUND;
+
+	HRESULT hr;
+	if(FAILED(hr = parseHeader()) || FAILED(hr = allocateRing(bufferBytes, bufferCount, loopCount))){
+		close();
+	}
+	return hr;
+}
+#endif
+
+/**
+ * @fn	HRESULT WavStreamReader::openMemory(const WAVEFORMATEX* pFormat, const BYTE* pData, UINT32 dataBytes,
+ * 		UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount, UINT32 factFrames)
+ *
+ * @brief	Streams sample data that is already in memory, such as a PcmAsset loaded without conversion. This
+ * 			is only worth doing for ADPCM, which is decoded as the ring is filled: the data stays compressed
+ * 			and the decode cost is spread over playback.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pFormat	   	Format of the data, with its extra bytes following it as in a 'fmt ' chunk.
+ * @param	pData	   	The data. Must stay valid until close().
+ * @param	dataBytes  	Size of the data.
+ * @param	bufferBytes	Size of each ring buffer, as for open().
+ * @param	bufferCount	Number of buffers in the ring (at least 2).
+ * @param	loopCount  	Number of times to repeat the data. STREAM_LOOP_INFINITE loops forever.
+ * @param	factFrames 	The frame count from the data's 'fact' chunk, 0 if it had none.
+ *
+ * @return	S_OK, E_INVALIDARG or E_FAIL if the format can't be streamed.
+ */
+HRESULT WavStreamReader::openMemory(const WAVEFORMATEX* pFormat, const BYTE* pData, UINT32 dataBytes, UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount, UINT32 factFrames)
+{
+	close();
+
+	if(pFormat == NULL || pData == NULL)
+		return E_INVALIDARG;
+
+	HRESULT hr;
+	if(FAILED(hr = setFormat(pFormat)))
+		return hr;
+	pMemory = pData;
+	dataOffset = 0;
+	dataSize = isCompressed() ? dataBytes : dataBytes - (dataBytes % wfx.nBlockAlign);
+	dataRemaining = dataSize;
+	setFactFrames(factFrames);
+	if(FAILED(hr = allocateRing(bufferBytes, bufferCount, loopCount))){
+		close();
+	}
+	return hr;
+}
+
+/**
+ * @fn	UINT32 WavStreamReader::getMemoryBufferBytes(const WAVEFORMATEX* pFormat)
+ *
+ * @brief	The buffer size to pass to openMemory() for data in this format: STREAMING_MEMORY_BLOCKS decoded
+ * 			blocks for ADPCM, STREAMING_BUFFER_BYTES for anything else. Reading from memory doesn't stall
+ * 			like reading from disk, so the ring only needs to stay ahead of the voice by a block or two; a
+ * 			disk-sized ring would take more memory than decoding the whole asset to 16 bit PCM.
+ *
+ * @date	10/17/2026
+ */
+UINT32 WavStreamReader::getMemoryBufferBytes(const WAVEFORMATEX* pFormat)
+{
+	AdpcmFormat adpcm;
+	if(pFormat == NULL || FAILED(getAdpcmFormat(pFormat, &adpcm)))
+		return STREAMING_BUFFER_BYTES;
+	return adpcm.samplesPerBlock * adpcm.channels * (UINT32)sizeof(INT16) * STREAMING_MEMORY_BLOCKS;
+}
+
+/**
+ * @fn	void WavStreamReader::close()
+ *
+ * @brief	Stops the reader thread, closes the file and frees the ring.
+ *
+ * @date	10/17/2026
+ */
+void WavStreamReader::close()
+{
+	if(threadRunning){
+		{
+			lock_guard<mutex> l(lock);
+			quit = true;
+		}
+		readerWake.notify_all();
+		readerThread.join();
+		threadRunning = false;
+	}
+	quit = false;
+
+	if(pFile != NULL){
+		fclose(pFile);
+		pFile = NULL;
+	}
+	pMemory = NULL;
+	memoryPos = 0;
+	memset(&adpcm, 0, sizeof(adpcm));
+	SAFE_DELETE_ARRAY(pCompressed);
+	SAFE_DELETE_ARRAY(blocks);
+	SAFE_DELETE_ARRAY(pRingData);
+	bufferBytes = 0;
+	bufferCount = 0;
+}
+
+/**
+ * @fn	HRESULT WavStreamReader::parseHeader()
+ *
+ * @brief	Walks the RIFF chunks until the 'data' chunk is found, picking up the 'fmt ' and 'fact' chunks on
+ * 			the way.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_FAIL if the file is not a WAV file.
+ */
+HRESULT WavStreamReader::parseHeader()
+{
+	BYTE riff[12];
+	if(fread(riff, 1, sizeof(riff), pFile) != sizeof(riff))
+		return E_FAIL;
+	if(memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0)
+		return E_FAIL;
+
+	bool haveFormat = false;
+	UINT32 factFrames = 0;
+	BYTE chunkHeader[8];
+	while(fread(chunkHeader, 1, sizeof(chunkHeader), pFile) == sizeof(chunkHeader)){
+		DWORD chunkSize = chunkHeader[4] | (chunkHeader[5] << 8) | (chunkHeader[6] << 16) | ((DWORD)chunkHeader[7] << 24);
+
+		if(memcmp(chunkHeader, "fmt ", 4) == 0){
+			// the 16 byte PCMWAVEFORMAT is the minimum, extra bytes are kept as far as ADPCM needs them
+			if(chunkSize < 16)
+				return E_FAIL;
+			BYTE format[ADPCM_FORMAT_BYTES];
+			memset(format, 0, sizeof(format));
+			DWORD toRead = chunkSize < sizeof(format) ? chunkSize : (DWORD)sizeof(format);
+			if(fread(format, 1, toRead, pFile) != toRead)
+				return E_FAIL;
+			WAVEFORMATEX* pFormat = (WAVEFORMATEX*)format;
+			if(toRead < sizeof(WAVEFORMATEX) || pFormat->cbSize > toRead - sizeof(WAVEFORMATEX))
+				pFormat->cbSize = (toRead > sizeof(WAVEFORMATEX)) ? (WORD)(toRead - sizeof(WAVEFORMATEX)) : 0;
+			if(fseek(pFile, (long)(((chunkSize + 1) & ~1) - toRead), SEEK_CUR) != 0)
+				return E_FAIL;
+			if(FAILED(setFormat(pFormat)))
+				return E_FAIL;
+			haveFormat = true;
+		}else if(memcmp(chunkHeader, "fact", 4) == 0 && chunkSize >= 4){
+			BYTE fact[4];
+			if(fread(fact, 1, sizeof(fact), pFile) != sizeof(fact))
+				return E_FAIL;
+			factFrames = fact[0] | (fact[1] << 8) | (fact[2] << 16) | ((UINT32)fact[3] << 24);
+			if(fseek(pFile, (long)(((chunkSize + 1) & ~1) - sizeof(fact)), SEEK_CUR) != 0)
+				return E_FAIL;
+		}else if(memcmp(chunkHeader, "data", 4) == 0){
+			if(!haveFormat)
+				return E_FAIL;
+			dataOffset = ftell(pFile);
+			// ADPCM keeps its short last block, it still decodes to whole frames
+			dataSize = isCompressed() ? chunkSize : chunkSize - (chunkSize % wfx.nBlockAlign);
+			dataRemaining = dataSize;
+			setFactFrames(factFrames);
+			return S_OK;
+		}else{
+			// chunks are word aligned
+			if(fseek(pFile, (long)((chunkSize + 1) & ~1), SEEK_CUR) != 0)
+				return E_FAIL;
+		}
+	}
+	return E_FAIL;
+}
+
+/**
+ * @fn	HRESULT WavStreamReader::setFormat(const WAVEFORMATEX* pFormat)
+ *
+ * @brief	Sets the format the stream is delivered in: the source format itself, or for ADPCM the 16 bit PCM
+ * 			it decodes to.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_FAIL if the format has no frame size, or is ADPCM this codec can't decode.
+ */
+HRESULT WavStreamReader::setFormat(const WAVEFORMATEX* pFormat)
+{
+	memset(&adpcm, 0, sizeof(adpcm));
+	if(getAdpcmType(pFormat) != ADPCM_TYPE_NONE){
+		if(FAILED(getAdpcmFormat(pFormat, &adpcm))){
+			memset(&adpcm, 0, sizeof(adpcm));
+			return E_FAIL;
+		}
+		makeDecodedFormat(&adpcm, &wfx);
+		return S_OK;
+	}
+	memcpy(&wfx, pFormat, sizeof(wfx));
+	wfx.cbSize = 0;
+	return (wfx.nBlockAlign == 0) ? E_FAIL : S_OK;
+}
+
+/**
+ * @fn	void WavStreamReader::setFactFrames(UINT32 factFrames)
+ *
+ * @brief	Sets how many decoded frames a pass of ADPCM data delivers, from its 'fact' chunk, so that the
+ * 			padding that fills out the last block isn't played. Ignored for PCM, whose length is its size.
+ *
+ * @date	10/17/2026
+ */
+void WavStreamReader::setFactFrames(UINT32 factFrames)
+{
+	dataFrames = 0;
+	if(isCompressed() && factFrames > 0 && factFrames < getAdpcmFrames(&adpcm, dataSize))
+		dataFrames = factFrames;
+	framesRemaining = dataFrames;
+}
+
+/**
+ * @fn	HRESULT WavStreamReader::allocateRing(UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount)
+ *
+ * @brief	Allocates the ring of buffers and marks them all as waiting to be filled.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_INVALIDARG if the buffers can't hold a single sample frame.
+ */
+HRESULT WavStreamReader::allocateRing(UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount)
+{
+	if(isCompressed()){
+		// ADPCM decodes a block at a time, so buffers hold whole decoded blocks, at least one
+		decodedBlockBytes = adpcm.samplesPerBlock * wfx.nBlockAlign;
+		bufferBytes -= bufferBytes % decodedBlockBytes;
+		if(bufferBytes == 0)
+			bufferBytes = decodedBlockBytes;
+		if(pFile != NULL)
+			pCompressed = new BYTE[(size_t)(bufferBytes / decodedBlockBytes) * adpcm.blockBytes];
+	}
+	bufferBytes -= bufferBytes % wfx.nBlockAlign;
+	if(bufferBytes == 0)
+		return E_INVALIDARG;
+	if(bufferCount < 2)
+		bufferCount = 2;
+
+	this->bufferBytes = bufferBytes;
+	this->bufferCount = bufferCount;
+	this->loopCount = loopCount;
+
+	pRingData = new BYTE[(size_t)bufferBytes * bufferCount];
+	blocks = new StreamBlock[bufferCount];
+	for(UINT32 i = 0; i < bufferCount; ++i){
+		blocks[i].pData = pRingData + (size_t)i * bufferBytes;
+		blocks[i].index = i;
+	}
+	resetRing();
+	return S_OK;
+}
+
+/**
+ * @fn	void WavStreamReader::resetRing()
+ *
+ * @brief	Puts every block back in the empty state and seeks to the start of the sample data. Must be called
+ * 			with the lock held (or before the reader thread exists).
+ *
+ * @date	10/17/2026
+ */
+void WavStreamReader::resetRing()
+{
+	for(UINT32 i = 0; i < bufferCount; ++i){
+		blocks[i].bytes = 0;
+		blocks[i].endOfStream = false;
+		blocks[i].released = chrono::steady_clock::time_point();
+	}
+	fillIndex = 0;
+	acquireIndex = 0;
+	emptyCount = bufferCount;
+	filledCount = 0;
+	inUseCount = 0;
+
+	seekToData();
+	dataRemaining = dataSize;
+	framesRemaining = dataFrames;
+	loopsRemaining = (dataSize == 0) ? 0 : loopCount;
+	readComplete = false;
+}
+
+/**
+ * @fn	HRESULT WavStreamReader::start()
+ *
+ * @brief	Starts the background reader thread, which immediately begins to fill the ring.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or CO_E_NOTINITIALIZED if nothing is open.
+ */
+HRESULT WavStreamReader::start()
+{
+	if(pFile == NULL && pMemory == NULL)
+		return CO_E_NOTINITIALIZED;
+	if(!threadRunning){
+		quit = false;
+		readerThread = thread(&WavStreamReader::readerLoop, this);
+		threadRunning = true;
+	}
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT WavStreamReader::rewind()
+ *
+ * @brief	Restarts the stream from the beginning of the file with the original loop count. All blocks must
+ * 			have been released by the consumer.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK, CO_E_NOTINITIALIZED if nothing is open or E_FAIL if the consumer still holds blocks.
+ */
+HRESULT WavStreamReader::rewind()
+{
+	if(pFile == NULL && pMemory == NULL)
+		return CO_E_NOTINITIALIZED;
+
+	unique_lock<mutex> l(lock);
+	if(inUseCount > 0)
+		return E_FAIL;
+	// wait for any fill in progress to land before moving the file pointer
+	consumerWake.wait(l, [this]{return filledCount + inUseCount + emptyCount == bufferCount;});
+	resetRing();
+	l.unlock();
+	readerWake.notify_all();
+	return S_OK;
+}
+
+/**
+ * @fn	StreamBlock* WavStreamReader::acquire(UINT32 timeoutMs)
+ *
+ * @brief	Gets the next filled block, in stream order.
+ *
+ * @date	10/17/2026
+ *
+ * @param	timeoutMs	How long to wait for the reader thread if no block is ready. 0 doesn't wait.
+ *
+ * @return	The block, or NULL if none is ready or the stream has ended.
+ */
+StreamBlock* WavStreamReader::acquire(UINT32 timeoutMs)
+{
+	unique_lock<mutex> l(lock);
+	if(blocks == NULL)
+		return NULL;
+
+	if(filledCount == 0){
+		if(readComplete)
+			return NULL;
+		// the consumer has nothing left to play and nothing is ready
+		if(inUseCount == 0)
+			stats.underruns++;
+		if(timeoutMs == 0 ||
+			!consumerWake.wait_for(l, chrono::milliseconds(timeoutMs), [this]{return filledCount > 0 || readComplete;}) ||
+			filledCount == 0){
+			return NULL;
+		}
+	}
+
+	StreamBlock* block = &blocks[acquireIndex];
+	acquireIndex = (acquireIndex + 1) % bufferCount;
+	filledCount--;
+	inUseCount++;
+	return block;
+}
+
+/**
+ * @fn	void WavStreamReader::release(StreamBlock* block)
+ *
+ * @brief	Hands a block back to the reader thread to be refilled. Blocks must be released in the order they
+ * 			were acquired, which is always the case for buffers queued on a single voice.
+ *
+ * @date	10/17/2026
+ *
+ * @param [in,out]	block	The block returned by acquire().
+ */
+void WavStreamReader::release(StreamBlock* block)
+{
+	if(block == NULL)
+		return;
+	{
+		lock_guard<mutex> l(lock);
+		if(inUseCount == 0)
+			return;
+		block->released = chrono::steady_clock::now();
+		inUseCount--;
+		emptyCount++;
+	}
+	readerWake.notify_one();
+}
+
+/**
+ * @fn	void WavStreamReader::setReadyCallback(READY_CALLBACK callback, void* pContext)
+ *
+ * @brief	Sets a function that the reader thread calls every time it has filled a block. XAudio2 sounds
+ * 			use this to submit the block to their source voice without polling.
+ *
+ * @date	10/17/2026
+ */
+void WavStreamReader::setReadyCallback(READY_CALLBACK callback, void* pContext)
+{
+	lock_guard<mutex> l(lock);
+	readyCallback = callback;
+	pReadyContext = pContext;
+}
+
+/**
+ * @fn	bool WavStreamReader::isFinished()
+ *
+ * @brief	Query if the whole stream (including loops) has been read and handed back by the consumer.
+ *
+ * @date	10/17/2026
+ *
+ * @return	true if finished, false if not.
+ */
+bool WavStreamReader::isFinished()
+{
+	lock_guard<mutex> l(lock);
+	return readComplete && filledCount == 0 && inUseCount == 0;
+}
+
+/**
+ * @fn	void WavStreamReader::getStats(StreamStats* stats)
+ *
+ * @brief	Copies out the refill statistics.
+ *
+ * @date	10/17/2026
+ */
+void WavStreamReader::getStats(StreamStats* stats)
+{
+	lock_guard<mutex> l(lock);
+	*stats = this->stats;
+	stats->avgRefillMicros = (this->stats.refills > 0) ? totalRefillMicros / this->stats.refills : 0;
+}
+
+/**
+ * @fn	void WavStreamReader::seekToData()
+ *
+ * @brief	Moves the source, file or memory, back to the start of the sample data.
+ *
+ * @date	10/17/2026
+ */
+void WavStreamReader::seekToData()
+{
+	if(pFile != NULL)
+		fseek(pFile, dataOffset, SEEK_SET);
+	memoryPos = 0;
+}
+
+/**
+ * @fn	UINT32 WavStreamReader::readSource(BYTE* pDest, UINT32 bytes, const BYTE** ppData)
+ *
+ * @brief	Reads the next bytes of sample data from the file or from memory.
+ *
+ * @date	10/17/2026
+ *
+ * @param [out]	pDest 	Where to put the data.
+ * @param	bytes	  	How many bytes to read.
+ * @param [out]	ppData	If not null, receives where the data can be read from: pDest, or the source
+ * 						itself for a memory stream, which then isn't copied.
+ *
+ * @return	The number of bytes read, fewer than asked for only if a file is truncated.
+ */
+UINT32 WavStreamReader::readSource(BYTE* pDest, UINT32 bytes, const BYTE** ppData)
+{
+	if(pMemory == NULL){
+		if(ppData != NULL)
+			*ppData = pDest;
+		return (UINT32)fread(pDest, 1, bytes, pFile);
+	}
+	if(ppData != NULL)
+		*ppData = pMemory + memoryPos;
+	else
+		memcpy(pDest, pMemory + memoryPos, bytes);
+	memoryPos += bytes;
+	return bytes;
+}
+
+/**
+ * @fn	UINT32 WavStreamReader::fillBlock(StreamBlock* block)
+ *
+ * @brief	Reads the next bufferBytes of the stream into a block, wrapping back to the start of the data
+ * 			chunk as many times as the loop count allows. ADPCM is read a run of blocks at a time and decoded
+ * 			straight into the buffer, for as long as another whole decoded block fits, and cut short at the
+ * 			length the 'fact' chunk gives. Only called on the reader thread.
+ *
+ * @date	10/17/2026
+ *
+ * @return	The number of source bytes read.
+ */
+UINT32 WavStreamReader::fillBlock(StreamBlock* block)
+{
+	UINT32 filled = 0;
+	UINT32 bytesRead = 0;
+	block->endOfStream = false;
+
+	while(filled < bufferBytes && (!isCompressed() || bufferBytes - filled >= decodedBlockBytes)){
+		if(dataRemaining == 0){
+			if(loopsRemaining == 0){
+				block->endOfStream = true;
+				break;
+			}
+			if(loopsRemaining != STREAM_LOOP_INFINITE)
+				loopsRemaining--;
+			seekToData();
+			dataRemaining = dataSize;
+			framesRemaining = dataFrames;
+		}
+
+		UINT32 toRead;
+		size_t got;
+		if(isCompressed()){
+			toRead = ((bufferBytes - filled) / decodedBlockBytes) * adpcm.blockBytes;
+			if(toRead > dataRemaining)
+				toRead = dataRemaining;
+			const BYTE* pData;
+			got = readSource(pCompressed, toRead, &pData);
+			UINT32 frames = decodeAdpcm(&adpcm, pData, (UINT32)got, (INT16*)(block->pData + filled));
+			if(dataFrames > 0){
+				// the rest of the last block is padding
+				if(frames > framesRemaining)
+					frames = framesRemaining;
+				framesRemaining -= frames;
+			}
+			filled += frames * wfx.nBlockAlign;
+		}else{
+			toRead = bufferBytes - filled;
+			if(toRead > dataRemaining)
+				toRead = dataRemaining;
+			got = readSource(block->pData + filled, toRead, NULL);
+			filled += (UINT32)got;
+		}
+		bytesRead += (UINT32)got;
+		dataRemaining -= (UINT32)got;
+		if(got < toRead){
+			// truncated file, treat what we have as the end of the data
+			dataRemaining = 0;
+			loopsRemaining = 0;
+		}
+	}
+
+	// a block that exactly reaches the end of the last loop is also the end of the stream
+	if(dataRemaining == 0 && loopsRemaining == 0)
+		block->endOfStream = true;
+
+	block->bytes = filled;
+	return bytesRead;
+}
+
+/**
+ * @fn	void WavStreamReader::readerLoop()
+ *
+ * @brief	Body of the background reader thread. Sleeps until a block has been released, fills it from disk
+ * 			and notifies the consumer. File I/O is done without holding the lock.
+ *
+ * @date	10/17/2026
+ */
+void WavStreamReader::readerLoop()
+{
+	unique_lock<mutex> l(lock);
+	while(!quit){
+		if(emptyCount == 0 || readComplete){
+			readerWake.wait(l);
+			continue;
+		}
+
+		StreamBlock* block = &blocks[fillIndex];
+		emptyCount--;
+		l.unlock();
+
+		UINT32 bytes = fillBlock(block);
+
+		l.lock();
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if(block->released != chrono::steady_clock::time_point()){
+			double micros = (double)chrono::duration_cast<chrono::microseconds>(now - block->released).count();
+			stats.refills++;
+			totalRefillMicros += micros;
+			if(micros > stats.maxRefillMicros)
+				stats.maxRefillMicros = micros;
+		}
+		stats.bytesRead += bytes;
+		if(block->endOfStream)
+			readComplete = true;
+		fillIndex = (fillIndex + 1) % bufferCount;
+		filledCount++;
+
+		READY_CALLBACK callback = readyCallback;
+		void* pContext = pReadyContext;
+		l.unlock();
+		consumerWake.notify_all();
+		if(callback != NULL)
+			callback(pContext);
+		l.lock();
+	}
+}
@@ -0,0 +1,426 @@
+#include "WaveFileWriter.h"
+#include "AlignedAlloc.h"
+#include <string.h>
+#include <stdlib.h>
+
+static void putLE32(BYTE* p, DWORD v)
+{
+	p[0] = (BYTE)v;
+	p[1] = (BYTE)(v >> 8);
+	p[2] = (BYTE)(v >> 16);
+	p[3] = (BYTE)(v >> 24);
+}
+
+/**
+ * @fn	WaveFileWriter::WaveFileWriter(void)
+ *
+ * @brief	Default constructor.
+ *
+ * @date	10/17/2026
+ */
+WaveFileWriter::WaveFileWriter(void)
+{
+	pFile = NULL;
+	memset(&wfx, 0, sizeof(wfx));
+	riffSizeOffset = 0;
+	factOffset = 0;
+	dataSizeOffset = 0;
+	dataBytes = 0;
+	writeError = S_OK;
+
+	pStaging[0] = NULL;
+	pStaging[1] = NULL;
+	stagingUsed = 0;
+	fillBuffer = 0;
+
+	background = false;
+	pPending = NULL;
+	pendingBytes = 0;
+	quit = false;
+
+	flushes = 0;
+	stallMicros = 0;
+}
+
+/**
+ * @fn	WaveFileWriter::~WaveFileWriter(void)
+ *
+ * @brief	Destructor. Closes the file (fixing up the header) if it is still open.
+ *
+ * @date	10/17/2026
+ */
+WaveFileWriter::~WaveFileWriter(void)
+{
+	close();
+}
+
+/**
+ * @fn	HRESULT WaveFileWriter::open(const char* szFilename, const WAVEFORMATEX* pwfx,
+ * 		bool backgroundFlush)
+ *
+ * @brief	Creates the file and writes a header with placeholder sizes.
+ *
+ * @date	10/17/2026
+ *
+ * @param	szFilename	   	Name of the file.
+ * @param	pwfx		   	The format of the data that will be written. cbSize extra bytes are written too
+ * 							for non-PCM formats.
+ * @param	backgroundFlush	true to write to disk on a background thread.
+ *
+ * @return	S_OK, E_FAIL if the file can't be created or E_OUTOFMEMORY.
+ */
+HRESULT WaveFileWriter::open(const char* szFilename, const WAVEFORMATEX* pwfx, bool backgroundFlush)
+{
+	close();
+	if(szFilename == NULL || pwfx == NULL)
+		return E_INVALIDARG;
+
+	FILE* pNewFile = fopen(szFilename, "wb");
+	if(pNewFile == NULL)
+		return E_FAIL;
+	return begin(pNewFile, pwfx, backgroundFlush);
+}
+
+#ifdef _WIN32
+HRESULT WaveFileWriter::open(const wchar_t* szFilename, const WAVEFORMATEX* pwfx, bool backgroundFlush)
+{
+	close();
+	if(szFilename == NULL || pwfx == NULL)
+		return E_INVALIDARG;
+
+	FILE* pNewFile = _wfopen(szFilename, L"wb");
+	if(pNewFile == NULL)
+		return E_FAIL;
+	return begin(pNewFile, pwfx, backgroundFlush);
+}
+#endif
+
+/**
+ * @fn	HRESULT WaveFileWriter::begin(FILE* pFile, const WAVEFORMATEX* pwfx, bool backgroundFlush)
+ *
+ * @brief	Common part of open(): allocates the staging buffers, writes the header and starts the flush
+ * 			thread if one was asked for.
+ *
+ * @date	10/17/2026
+ */
+HRESULT WaveFileWriter::begin(FILE* pFile, const WAVEFORMATEX* pwfx, bool backgroundFlush)
+{
+	this->pFile = pFile;
+	// we do our own buffering
+	setvbuf(pFile, NULL, _IONBF, 0);
+
+	memcpy(&wfx, pwfx, sizeof(WAVEFORMATEX));
+	if(wfx.wFormatTag == WAVE_FORMAT_PCM)
+		wfx.cbSize = 0;
+	dataBytes = 0;
+	writeError = S_OK;
+	stagingUsed = 0;
+	fillBuffer = 0;
+	flushes = 0;
+	stallMicros = 0;
+	background = backgroundFlush;
+
+	pStaging[0] = (BYTE*)alignedAlloc(WAVE_WRITER_STAGING_BYTES, WAVE_WRITER_ALIGNMENT);
+	pStaging[1] = background ? (BYTE*)alignedAlloc(WAVE_WRITER_STAGING_BYTES, WAVE_WRITER_ALIGNMENT) : NULL;
+	if(pStaging[0] == NULL || (background && pStaging[1] == NULL)){
+		freeStaging();
+		fclose(pFile);
+		this->pFile = NULL;
+		return E_OUTOFMEMORY;
+	}
+
+	HRESULT hr = writeHeader(pwfx);
+	if(FAILED(hr)){
+		freeStaging();
+		fclose(pFile);
+		this->pFile = NULL;
+		return hr;
+	}
+
+	openTime = chrono::steady_clock::now();
+	lastFlushTime = openTime;
+
+	if(background){
+		quit = false;
+		pPending = NULL;
+		pendingBytes = 0;
+		flushThread = thread(&WaveFileWriter::flushLoop, this);
+	}
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT WaveFileWriter::writeHeader(const WAVEFORMATEX* pwfx)
+ *
+ * @brief	Writes the RIFF header, 'fmt ', 'fact' and the 'data' chunk header, remembering where the sizes
+ * 			that are only known at close() go.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pwfx	The caller's format, which is followed by cbSize extra bytes for non-PCM formats.
+ *
+ * @return	S_OK or E_FAIL.
+ */
+HRESULT WaveFileWriter::writeHeader(const WAVEFORMATEX* pwfx)
+{
+	// PCM writes the 16 byte PCMWAVEFORMAT, everything else the full WAVEFORMATEX plus its extra bytes
+	DWORD fmtSize = (wfx.wFormatTag == WAVE_FORMAT_PCM) ? 16 : (DWORD)(sizeof(WAVEFORMATEX) + wfx.cbSize);
+
+	BYTE header[12 + 8];
+	memcpy(header, "RIFF", 4); putLE32(header + 4, 0); memcpy(header + 8, "WAVE", 4);
+	memcpy(header + 12, "fmt ", 4); putLE32(header + 16, fmtSize);
+	riffSizeOffset = 4;
+	if(fwrite(header, 1, sizeof(header), pFile) != sizeof(header))
+		return E_FAIL;
+
+	if(fmtSize <= sizeof(WAVEFORMATEX)){
+		if(fwrite(&wfx, 1, fmtSize, pFile) != fmtSize)
+			return E_FAIL;
+	}else{
+		if(fwrite(&wfx, 1, sizeof(WAVEFORMATEX), pFile) != sizeof(WAVEFORMATEX) ||
+			fwrite((const BYTE*)pwfx + sizeof(WAVEFORMATEX), 1, wfx.cbSize, pFile) != wfx.cbSize)
+			return E_FAIL;
+	}
+	if(fmtSize & 1)
+		fputc(0, pFile);
+
+	BYTE chunks[12 + 8];
+	memcpy(chunks, "fact", 4); putLE32(chunks + 4, 4); putLE32(chunks + 8, 0);
+	memcpy(chunks + 12, "data", 4); putLE32(chunks + 16, 0);
+	factOffset = ftell(pFile) + 8;
+	dataSizeOffset = ftell(pFile) + 16;
+	if(fwrite(chunks, 1, sizeof(chunks), pFile) != sizeof(chunks))
+		return E_FAIL;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT WaveFileWriter::write(const BYTE* pbData, UINT32 nSizeToWrite, UINT32* pnSizeWrote)
+ *
+ * @brief	Appends sample data. The data is copied into the staging buffer in as few memcpy calls as possible
+ * 			and the buffer goes to disk (or to the flush thread) whenever it fills.
+ *
+ * @date	10/17/2026
+ *
+ * @param	pbData			   	The data.
+ * @param	nSizeToWrite	   	Number of bytes to write.
+ * @param [out]	pnSizeWrote	If non-null, receives the number of bytes accepted.
+ *
+ * @return	S_OK, CO_E_NOTINITIALIZED if the file isn't open, or the error from an earlier failed flush.
+ */
+HRESULT WaveFileWriter::write(const BYTE* pbData, UINT32 nSizeToWrite, UINT32* pnSizeWrote)
+{
+	if(pnSizeWrote != NULL)
+		*pnSizeWrote = 0;
+	if(pFile == NULL)
+		return CO_E_NOTINITIALIZED;
+	if(pbData == NULL && nSizeToWrite > 0)
+		return E_INVALIDARG;
+	HRESULT hr = writeError;
+	if(FAILED(hr))
+		return hr;
+
+	UINT32 written = 0;
+	while(written < nSizeToWrite){
+		UINT32 chunk = WAVE_WRITER_STAGING_BYTES - stagingUsed;
+		if(chunk > nSizeToWrite - written)
+			chunk = nSizeToWrite - written;
+		memcpy(pStaging[fillBuffer] + stagingUsed, pbData + written, chunk);
+		stagingUsed += chunk;
+		written += chunk;
+
+		if(stagingUsed == WAVE_WRITER_STAGING_BYTES){
+			hr = flushStaging();
+			if(FAILED(hr)){
+				dataBytes += written;
+				if(pnSizeWrote != NULL)
+					*pnSizeWrote = written;
+				return hr;
+			}
+		}
+	}
+
+	dataBytes += written;
+	if(pnSizeWrote != NULL)
+		*pnSizeWrote = written;
+	return S_OK;
+}
+
+/**
+ * @fn	HRESULT WaveFileWriter::flushStaging()
+ *
+ * @brief	Sends the staging buffer to disk. In background mode the buffer is handed to the flush thread and
+ * 			the producer switches to the other buffer, waiting only if the previous flush hasn't finished.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or the write error.
+ */
+HRESULT WaveFileWriter::flushStaging()
+{
+	if(stagingUsed == 0)
+		return writeError;
+
+	if(!background){
+		HRESULT hr = writeBlock(pStaging[fillBuffer], stagingUsed);
+		stagingUsed = 0;
+		lock_guard<mutex> l(lock);
+		flushes++;
+		lastFlushTime = chrono::steady_clock::now();
+		return hr;
+	}
+
+	unique_lock<mutex> l(lock);
+	if(pPending != NULL){
+		chrono::steady_clock::time_point waitStart = chrono::steady_clock::now();
+		producerWake.wait(l, [this]{return pPending == NULL;});
+		stallMicros += (double)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - waitStart).count();
+	}
+	pPending = pStaging[fillBuffer];
+	pendingBytes = stagingUsed;
+	l.unlock();
+	flushWake.notify_one();
+
+	fillBuffer ^= 1;
+	stagingUsed = 0;
+	return writeError;
+}
+
+/**
+ * @fn	HRESULT WaveFileWriter::writeBlock(const BYTE* pBlock, UINT32 bytes)
+ *
+ * @brief	Writes one staging buffer to disk.
+ *
+ * @date	10/17/2026
+ */
+HRESULT WaveFileWriter::writeBlock(const BYTE* pBlock, UINT32 bytes)
+{
+	if(fwrite(pBlock, 1, bytes, pFile) != bytes){
+		writeError = E_FAIL;
+		return E_FAIL;
+	}
+	return writeError;
+}
+
+/**
+ * @fn	void WaveFileWriter::flushLoop()
+ *
+ * @brief	Body of the background flush thread.
+ *
+ * @date	10/17/2026
+ */
+void WaveFileWriter::flushLoop()
+{
+	unique_lock<mutex> l(lock);
+	for(;;){
+		flushWake.wait(l, [this]{return pPending != NULL || quit;});
+		if(pPending == NULL && quit)
+			break;
+
+		BYTE* pBlock = pPending;
+		UINT32 bytes = pendingBytes;
+		l.unlock();
+		writeBlock(pBlock, bytes);
+		l.lock();
+		flushes++;
+		lastFlushTime = chrono::steady_clock::now();
+		pPending = NULL;
+		producerWake.notify_all();
+	}
+}
+
+/**
+ * @fn	HRESULT WaveFileWriter::close()
+ *
+ * @brief	Writes out whatever is staged, stops the flush thread and patches the RIFF, 'fact' and 'data'
+ * 			sizes in one pass.
+ *
+ * @date	10/17/2026
+ *
+ * @return	S_OK or E_FAIL if any write failed.
+ */
+HRESULT WaveFileWriter::close()
+{
+	if(pFile == NULL)
+		return S_OK;
+
+	flushStaging();
+	if(background){
+		{
+			lock_guard<mutex> l(lock);
+			quit = true;
+		}
+		flushWake.notify_one();
+		flushThread.join();
+	}
+
+	// the data chunk is word aligned
+	if(dataBytes & 1)
+		fputc(0, pFile);
+
+	HRESULT hr = writeError;
+	if(SUCCEEDED(hr))
+		hr = patchSizes();
+
+	fclose(pFile);
+	pFile = NULL;
+	freeStaging();
+	return hr;
+}
+
+/**
+ * @fn	HRESULT WaveFileWriter::patchSizes()
+ *
+ * @brief	Seeks back and fills in the sizes that were written as zero by writeHeader().
+ *
+ * @date	10/17/2026
+ */
+HRESULT WaveFileWriter::patchSizes()
+{
+	long fileEnd = ftell(pFile);
+	BYTE value[4];
+
+	putLE32(value, (DWORD)(fileEnd - 8));
+	if(fseek(pFile, riffSizeOffset, SEEK_SET) != 0 || fwrite(value, 1, 4, pFile) != 4)
+		return E_FAIL;
+
+	// the sample count is only meaningful for uncompressed formats
+	DWORD samples = 0;
+	if((wfx.wFormatTag == WAVE_FORMAT_PCM || wfx.wFormatTag == WAVE_FORMAT_IEEE_FLOAT) && wfx.nBlockAlign > 0)
+		samples = (DWORD)(dataBytes / wfx.nBlockAlign);
+	putLE32(value, samples);
+	if(fseek(pFile, factOffset, SEEK_SET) != 0 || fwrite(value, 1, 4, pFile) != 4)
+		return E_FAIL;
+
+	putLE32(value, (DWORD)dataBytes);
+	if(fseek(pFile, dataSizeOffset, SEEK_SET) != 0 || fwrite(value, 1, 4, pFile) != 4)
+		return E_FAIL;
+	return S_OK;
+}
+
+/**
+ * @fn	void WaveFileWriter::getStats(WaveWriterStats* stats)
+ *
+ * @brief	Reports how much has been written and how fast.
+ *
+ * @date	10/17/2026
+ */
+void WaveFileWriter::getStats(WaveWriterStats* stats)
+{
+	lock_guard<mutex> l(lock);
+	stats->bytesWritten = dataBytes;
+	stats->flushes = flushes;
+	stats->seconds = chrono::duration<double>(lastFlushTime - openTime).count();
+	stats->megabytesPerSecond = (stats->seconds > 0) ? (double)dataBytes / (1024.0 * 1024.0) / stats->seconds : 0;
+	stats->producerStallMicros = stallMicros;
+}
+
+void WaveFileWriter::freeStaging()
+{
+	for(int i = 0; i < 2; ++i){
+		if(pStaging[i] != NULL){
+			alignedFree(pStaging[i]);
+			pStaging[i] = NULL;
+		}
+	}
+}
@@ -0,0 +1,195 @@
+#include "WorkerPool.h"
+
+/**
+ * @fn	WorkerPool::WorkerPool(void)
+ *
+ * @brief	Default constructor. No threads are made until start() or the first submit().
+ *
+ * @date	10/17/2026
+ */
+WorkerPool::WorkerPool(void)
+{
+	busyCount = 0;
+	quit = false;
+}
+
+WorkerPool::~WorkerPool(void)
+{
+	stop();
+}
+
+/**
+ * @fn	UINT32 WorkerPool::getDefaultThreadCount()
+ *
+ * @brief	One thread per hardware thread, at least one.
+ *
+ * @date	10/17/2026
+ */
+UINT32 WorkerPool::getDefaultThreadCount()
+{
+	UINT32 count = thread::hardware_concurrency();
+	return count > 0 ? count : 1;
+}
+
+/**
+ * @fn	HRESULT WorkerPool::start(UINT32 threadCount)
+ *
+ * @brief	Starts the threads. If the pool is already running it finishes the queued tasks first and then
+ * 			restarts with the new count.
+ *
+ * @date	10/17/2026
+ *
+ * @param	threadCount	Number of threads, 0 for getDefaultThreadCount().
+ *
+ * @return	S_OK or E_FAIL if a thread could not be made.
+ */
+HRESULT WorkerPool::start(UINT32 threadCount)
+{
+	stop();
+	if(threadCount == 0)
+		threadCount = getDefaultThreadCount();
+
+	quit = false;
+	for(UINT32 i = 0; i < threadCount; ++i){
+		try{
+			threads.push_back(thread(&WorkerPool::workerLoop, this));
+		}catch(...){
+			stop();
+			return E_FAIL;
+		}
+	}
+	return S_OK;
+}
+
+/**
+ * @fn	void WorkerPool::stop()
+ *
+ * @brief	Runs whatever is still queued, then joins the threads.
+ *
+ * @date	10/17/2026
+ */
+void WorkerPool::stop()
+{
+	{
+		lock_guard<mutex> l(lock);
+		quit = true;
+	}
+	workerWake.notify_all();
+	for(size_t i = 0; i < threads.size(); ++i){
+		threads[i].join();
+	}
+	threads.clear();
+}
+
+/**
+ * @fn	void WorkerPool::submit(const TASK& task)
+ *
+ * @brief	Queues a task. Starts the default number of threads if the pool is not running, or runs the task on
+ * 			the calling thread if threads can't be had at all.
+ *
+ * @date	10/17/2026
+ */
+void WorkerPool::submit(const TASK& task)
+{
+	if(threads.empty() && FAILED(start(0))){
+		task();
+		return;
+	}
+	{
+		lock_guard<mutex> l(lock);
+		tasks.push_back(task);
+	}
+	workerWake.notify_one();
+}
+
+/**
+ * @fn	void WorkerPool::wait()
+ *
+ * @brief	Blocks until the queue is empty and no task is running.
+ *
+ * @date	10/17/2026
+ */
+void WorkerPool::wait()
+{
+	unique_lock<mutex> l(lock);
+	while(!tasks.empty() || busyCount > 0){
+		idleWake.wait(l);
+	}
+}
+
+/**
+ * @fn	void WorkerPool::parallelFor(UINT32 count, UINT32 grain, const RANGE_TASK& body)
+ *
+ * @brief	Runs body over [0, count) in contiguous ranges, one per thread plus one on the calling thread, and
+ * 			returns when they are all done. Every range but the last starts and ends on a multiple of grain,
+ * 			and none is shorter than grain, so small loops run on the caller alone. Unlike submit() this does
+ * 			not start the pool: with no threads the whole loop runs on the caller. Nothing else should be
+ * 			queued on the pool meanwhile, since this waits for the whole queue.
+ *
+ * @date	10/17/2026
+ *
+ * @param	count	Number of items.
+ * @param	grain	Alignment and smallest size of a range, at least 1.
+ * @param	body 	Called with each range as (begin, end). Ranges never overlap.
+ */
+void WorkerPool::parallelFor(UINT32 count, UINT32 grain, const RANGE_TASK& body)
+{
+	if(count == 0)
+		return;
+	if(grain == 0)
+		grain = 1;
+	UINT32 parts = (UINT32)threads.size() + 1;
+	UINT32 chunk = (count + parts - 1) / parts;
+	chunk = ((chunk + grain - 1) / grain) * grain;
+	if(threads.empty() || chunk >= count){
+		body(0, count);
+		return;
+	}
+
+	// the caller takes the first range, so a pool of n threads splits the work n + 1 ways
+	for(UINT32 begin = chunk; begin < count; begin += chunk){
+		UINT32 end = (count - begin > chunk) ? begin + chunk : count;
+		submit([&body, begin, end]{ body(begin, end); });
+	}
+	body(0, chunk);
+	wait();
+}
+
+UINT32 WorkerPool::getPendingCount()
+{
+	lock_guard<mutex> l(lock);
+	return (UINT32)tasks.size() + busyCount;
+}
+
+/**
+ * @fn	void WorkerPool::workerLoop()
+ *
+ * @brief	Thread body. Drains the queue before honouring quit, so stop() never drops work.
+ *
+ * @date	10/17/2026
+ */
+void WorkerPool::workerLoop()
+{
+	unique_lock<mutex> l(lock);
+	for(;;){
+		while(tasks.empty() && !quit){
+			workerWake.wait(l);
+		}
+		if(tasks.empty())
+			break;
+
+		TASK task = tasks.front();
+		tasks.pop_front();
+		busyCount++;
+		l.unlock();
+		task();
+		l.lock();
+		busyCount--;
+		if(tasks.empty() && busyCount == 0)
+			idleWake.notify_all();
+	}
+}
+
+/**
+// End of WorkerPool.cpp
+ */
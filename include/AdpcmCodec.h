@@ -0,0 +1,82 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "MixKernels.h"
+
+#define ADPCM_MAX_CHANNELS		8
+#define ADPCM_MS_MAX_COEFS		32      // MS ADPCM coefficient pairs kept from the 'fmt ' chunk, 7 is the norm
+#define ADPCM_IMA_MAX_INDEX		88
+#define ADPCM_MS_MIN_DELTA		16
+#define ADPCM_MS_MAX_DELTA		0x100000 // far past where every prediction saturates, keeps the products in 32 bits
+#define ADPCM_FORMAT_BYTES		(18 + 4 + ADPCM_MS_MAX_COEFS * 4) // the largest 'fmt ' chunk makeAdpcmFormat() writes
+
+/**
+ * @enum	ADPCM_TYPE
+ *
+ * @brief	The two 4 bit ADPCM encodings found in WAV files.
+ */
+enum ADPCM_TYPE
+{
+	ADPCM_TYPE_NONE,
+	ADPCM_TYPE_IMA,     // WAVE_FORMAT_IMA_ADPCM (DVI), not playable by XAudio2 without decoding
+	ADPCM_TYPE_MS       // WAVE_FORMAT_ADPCM, Microsoft's
+};
+
+/**
+ * @struct	AdpcmFormat
+ *
+ * @brief	What the codec needs to know about an ADPCM stream, taken from its 'fmt ' chunk by
+ * 			getAdpcmFormat(). Every block is blockBytes long and decodes to samplesPerBlock frames, except
+ * 			perhaps a shorter last block.
+ */
+struct AdpcmFormat
+{
+	ADPCM_TYPE type;
+	UINT32 channels;
+	UINT32 sampleRate;
+	UINT32 blockBytes;      // nBlockAlign
+	UINT32 samplesPerBlock; // frames per block
+	UINT32 coefCount;       // MS only
+	INT16 coef1[ADPCM_MS_MAX_COEFS];
+	INT16 coef2[ADPCM_MS_MAX_COEFS];
+};
+
+/**
+ * @struct	AdpcmDecoders
+ *
+ * @brief	The block decoders for one instruction set, selected with the same MIX_KERNEL values as the mixer.
+ * 			Get one with getAdpcmDecoders().
+ *
+ * 			Decoding is a serial dependency within each channel of a block, but blocks (and the channels in
+ * 			them) are independent, since each starts from its own header. The SIMD versions therefore decode
+ * 			several block channels side by side, one per lane: four for SSE2 IMA, eight for SSE2 MS (in two
+ * 			registers) and for AVX2. They give the same output as the scalar ones, and fall back to them for
+ * 			channel counts that don't divide the lane count.
+ *
+ * 			Each decodes count whole blocks to interleaved 16 bit PCM, count * samplesPerBlock frames.
+ */
+struct AdpcmDecoders
+{
+	MIX_KERNEL kernel;
+	void (*decodeIma)(const AdpcmFormat* pFormat, const BYTE* pIn, UINT32 count, INT16* pOut);
+	void (*decodeMs)(const AdpcmFormat* pFormat, const BYTE* pIn, UINT32 count, INT16* pOut);
+};
+
+const AdpcmDecoders* getAdpcmDecoders(MIX_KERNEL kernel);
+
+ADPCM_TYPE getAdpcmType(const WAVEFORMATEX* pFormat);
+HRESULT getAdpcmFormat(const WAVEFORMATEX* pFormat, AdpcmFormat* pAdpcm);
+UINT32 makeAdpcmFormat(ADPCM_TYPE type, UINT32 channels, UINT32 sampleRate, UINT32 blockBytes, BYTE* pOut);
+void makeDecodedFormat(const AdpcmFormat* pAdpcm, WAVEFORMATEX* pOut);
+
+UINT32 getAdpcmBlockFrames(const AdpcmFormat* pAdpcm, UINT32 bytes);
+UINT64 getAdpcmFrames(const AdpcmFormat* pAdpcm, UINT64 bytes);
+UINT64 getAdpcmEncodedBytes(const AdpcmFormat* pAdpcm, UINT64 frames);
+
+UINT32 decodeAdpcm(const AdpcmFormat* pAdpcm, const BYTE* pIn, UINT32 bytes, INT16* pOut, MIX_KERNEL kernel);
+UINT32 decodeAdpcm(const AdpcmFormat* pAdpcm, const BYTE* pIn, UINT32 bytes, INT16* pOut);
+UINT32 encodeAdpcm(const AdpcmFormat* pAdpcm, const INT16* pIn, UINT32 frames, BYTE* pOut);
+
+/**
+// End of AdpcmCodec.h
+ */
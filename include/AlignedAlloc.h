@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include <stdlib.h>
+
+#ifndef SIMD_ALIGNMENT
+#define SIMD_ALIGNMENT 32 // wide enough for AVX loads and stores
+#endif
+
+/**
+ * @fn	inline void* alignedAlloc(size_t bytes, size_t alignment)
+ *
+ * @brief	Allocates memory on an alignment boundary, which must be a power of two. Free with alignedFree().
+ *
+ * @return	null if the allocation failed.
+ */
+inline void* alignedAlloc(size_t bytes, size_t alignment)
+{
+#ifdef _WIN32
+	return _aligned_malloc(bytes, alignment);
+#else
+	void* p = NULL;
+	if(posix_memalign(&p, alignment, bytes) != 0)
+		return NULL;
+	return p;
+#endif
+}
+
+inline void alignedFree(void* p)
+{
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+/**
+// End of AlignedAlloc.h
+ */
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "SoundHandles.h"
+
+#ifndef AUDIO_COMMAND_QUEUE_SIZE
+#define AUDIO_COMMAND_QUEUE_SIZE 4096 // commands that can wait between two BasicAudio::run() calls
+#endif
+
+/**
+ * @enum	AUDIO_COMMAND_TYPE
+ *
+ * @brief	What an AudioCommand does. Each one corresponds to a call on BasicAudio or SampleSound, named in the
+ * 			comment along with the AudioCommand fields it uses.
+ */
+enum AUDIO_COMMAND_TYPE
+{
+	AUDIO_COMMAND_NONE,
+	AUDIO_COMMAND_START,            // SampleSound::start()
+	AUDIO_COMMAND_STOP,             // SampleSound::stop()
+	AUDIO_COMMAND_SET_EMITTER_X,    // SampleSound::setEmitterX(x)
+	AUDIO_COMMAND_SET_EMITTER_Y,    // SampleSound::setEmitterY(x)
+	AUDIO_COMMAND_SET_EMITTER_Z,    // SampleSound::setEmitterZ(x)
+	AUDIO_COMMAND_SET_EMITTER_POS,  // SampleSound::setEmitterPos(x, y, z)
+	AUDIO_COMMAND_SET_EMITTER_VELOCITY, // SampleSound::setEmitterVelocity(x, y, z)
+	AUDIO_COMMAND_SET_SPATIALIZED,  // SampleSound::setSpatialized(channel != 0)
+	AUDIO_COMMAND_PLAY_3D,          // BasicAudio::play3DVoice(handle)
+	AUDIO_COMMAND_PLAY_ON_CHANNEL,  // BasicAudio::playOnChannelVoice(voice, channel, x)
+	AUDIO_COMMAND_ADD_TO_CHANNEL,   // BasicAudio::addToChannelVoice(voice, channel, x)
+	AUDIO_COMMAND_CLEAR_CHANNEL,    // BasicAudio::clearChannelVoice(voice, channel)
+	AUDIO_COMMAND_UPDATE_3D,        // BasicAudio::update3D(), no handle
+	AUDIO_COMMAND_SET_LISTENER_POS, // BasicAudio::setListenerPosition(x, y, z), no handle
+	AUDIO_COMMAND_SET_LISTENER_VELOCITY, // BasicAudio::setListenerVelocity(x, y, z), no handle
+	AUDIO_COMMAND_SET_BUS_VOLUME,   // BasicAudio::setBusVolume(channel, x), the bus index in channel, no handle
+	AUDIO_COMMAND_SET_VOLUME        // SampleSound::setVolume(x)
+};
+
+/**
+ * @struct	AudioCommand
+ *
+ * @brief	One deferred call, small and plain so that it can be copied through a CommandRing. Sounds are named
+ * 			by handle, never by pointer, so a command for a sound that has gone away is simply ignored.
+ */
+struct AudioCommand
+{
+	UINT32 type;            // an AUDIO_COMMAND_TYPE
+	SOUND_HANDLE handle;
+	INT32 channel;
+	FLOAT32 x, y, z;        // position, velocity or volume (x) depending on the type
+};
+
+/**
+// End of AudioCommand.h
+ */
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "CommandRing.h"
+#include <atomic>
+#include <string>
+#include <type_traits>
+#include <wchar.h>
+
+using namespace std;
+
+/**
+ * @enum	AUDIO_LOG_LEVEL
+ *
+ * @brief	Severity of a log record. A record is kept if its level is at least both the compile-time level
+ * 			(AUDIO_LOG_COMPILE_LEVEL) and the runtime level (AudioLog::setLevel()).
+ */
+enum AUDIO_LOG_LEVEL
+{
+	AUDIO_LOG_LEVEL_TRACE,  // per-voice, per-update detail
+	AUDIO_LOG_LEVEL_DEBUG,  // per-sound events: emitter positions and the like
+	AUDIO_LOG_LEVEL_INFO,   // sounds starting, stopping and finishing, shutdown
+	AUDIO_LOG_LEVEL_WARN,   // something was dropped or fell back to a slower path
+	AUDIO_LOG_LEVEL_ERROR,  // a call failed
+	AUDIO_LOG_LEVEL_OFF
+};
+
+#ifndef AUDIO_LOG_COMPILE_LEVEL
+#ifdef _DEBUG
+#define AUDIO_LOG_COMPILE_LEVEL AUDIO_LOG_LEVEL_TRACE
+#else
+#define AUDIO_LOG_COMPILE_LEVEL AUDIO_LOG_LEVEL_INFO // records below this are compiled out
+#endif
+#endif
+
+#ifndef AUDIO_LOG_QUEUE_SIZE
+#define AUDIO_LOG_QUEUE_SIZE 1024 // records that can wait for the drain thread
+#endif
+
+#ifndef AUDIO_LOG_MAX_ARGS
+#define AUDIO_LOG_MAX_ARGS 6    // format arguments kept per record, later ones print as "?"
+#endif
+
+#ifndef AUDIO_LOG_TEXT_CHARS
+#define AUDIO_LOG_TEXT_CHARS 96 // room per record for copies of string arguments
+#endif
+
+/**
+ * @def	AUDIO_LOG(level, format, ...)
+ *
+ * @brief	Logs a record. The format must be a wide string literal, it is used by the drain thread after the
+ * 			call has returned. Below the compile-time level the whole statement, arguments included, is
+ * 			compiled out; below the runtime level it costs one relaxed load and a compare.
+ *
+ * 			AUDIO_LOG_INFO(L"starting playing %s", getFileName());
+ */
+#define AUDIO_LOG(level, format, ...) \
+	do{ \
+		if((level) >= AUDIO_LOG_COMPILE_LEVEL && AudioLog::isEnabled(level)) \
+			AudioLog::write((level), format, ##__VA_ARGS__); \
+	}while(0)
+
+#define AUDIO_LOG_TRACE(format, ...) AUDIO_LOG(AUDIO_LOG_LEVEL_TRACE, format, ##__VA_ARGS__)
+#define AUDIO_LOG_DEBUG(format, ...) AUDIO_LOG(AUDIO_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#define AUDIO_LOG_INFO(format, ...) AUDIO_LOG(AUDIO_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define AUDIO_LOG_WARN(format, ...) AUDIO_LOG(AUDIO_LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#define AUDIO_LOG_ERROR(format, ...) AUDIO_LOG(AUDIO_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+
+/**
+ * @typedef	void (*AUDIO_LOG_SINK)(AUDIO_LOG_LEVEL level, const wchar_t* text, void* pContext)
+ *
+ * @brief	Receives formatted records, one line each without the newline, on the drain thread.
+ */
+typedef void (*AUDIO_LOG_SINK)(AUDIO_LOG_LEVEL level, const wchar_t* text, void* pContext);
+
+/**
+ * @struct	AudioLogRecord
+ *
+ * @brief	A log call as it is queued: the format, and the arguments captured by value. String arguments are
+ * 			copied into text, since what they point to may be gone by the time the record is formatted.
+ */
+struct AudioLogRecord
+{
+	enum { ARG_INT, ARG_FLOAT, ARG_POINTER, ARG_TEXT };
+
+	struct Arg
+	{
+		UINT32 type;
+		union
+		{
+			INT64 i;
+			double f;
+			const void* p;
+			UINT32 text;    // offset of the copy in text
+		};
+	};
+
+	const wchar_t* format;
+	UINT32 level;
+	UINT32 argCount;
+	UINT32 textUsed;
+	Arg args[AUDIO_LOG_MAX_ARGS];
+	wchar_t text[AUDIO_LOG_TEXT_CHARS];
+
+	void addText(const wchar_t* s);
+	void addText(const char* s);
+
+	template <class T> typename enable_if<is_integral<T>::value || is_enum<T>::value>::type add(T v){
+		Arg& a = next();
+		a.type = ARG_INT;
+		a.i = (INT64)v;
+	};
+	template <class T> typename enable_if<is_floating_point<T>::value>::type add(T v){
+		Arg& a = next();
+		a.type = ARG_FLOAT;
+		a.f = v;
+	};
+	template <class T> typename enable_if<is_pointer<T>::value>::type add(T v){
+		Arg& a = next();
+		a.type = ARG_POINTER;
+		a.p = (const void*)v;
+	};
+	void add(const wchar_t* s){addText(s);};
+	void add(wchar_t* s){addText(s);};
+	void add(const char* s){addText(s);};
+	void add(char* s){addText(s);};
+	void add(const wstring& s){addText(s.c_str());};
+	void add(const string& s){addText(s.c_str());};
+
+	void addAll(){};
+	template <class T, class... REST> void addAll(const T& first, const REST&... rest){
+		if(argCount < AUDIO_LOG_MAX_ARGS)
+			add(first);
+		addAll(rest...);
+	};
+
+protected:
+	Arg& next(){return args[argCount++];};
+};
+
+/**
+ * @class	AudioLog
+ *
+ * @brief	The library's logger. Log calls only capture their arguments and push a record into a lock-free
+ * 			CommandRing, so they never block and never touch the console; a background thread formats the
+ * 			records and hands them to the sink, stderr unless setSink() says otherwise. If the ring is full the
+ * 			record is dropped and counted, see getStats().
+ *
+ * 			BasicAudio starts the drain thread when it is constructed and stops it in destroy(); code that logs without a
+ * 			BasicAudio can call start() and stop() itself. Records written while no thread runs are kept until
+ * 			one does, and are flushed at exit.
+ *
+ * 			AudioLog::setLevel(AUDIO_LOG_LEVEL_DEBUG);
+ * 			AUDIO_LOG_DEBUG(L"emitter pos = (%.2f, %.2f, %.2f)", x, y, z);
+ *
+ * @date	10/17/2026
+ */
+class AudioLog
+{
+public:
+	static bool isEnabled(AUDIO_LOG_LEVEL level){return (INT32)level >= runtimeLevel.load(memory_order_relaxed);};
+	static void setLevel(AUDIO_LOG_LEVEL level){runtimeLevel.store((INT32)level, memory_order_relaxed);};
+	static AUDIO_LOG_LEVEL getLevel(){return (AUDIO_LOG_LEVEL)runtimeLevel.load(memory_order_relaxed);};
+
+	/**
+	 * @fn	template <class... ARGS> static void AudioLog::write(AUDIO_LOG_LEVEL level, const wchar_t* format,
+	 * 		const ARGS&... args)
+	 *
+	 * @brief	Queues a record without checking the level. Use the AUDIO_LOG macros instead.
+	 *
+	 * @date	10/17/2026
+	 */
+	template <class... ARGS> static void write(AUDIO_LOG_LEVEL level, const wchar_t* format, const ARGS&... args){
+		AudioLogRecord r;
+		r.format = format;
+		r.level = (UINT32)level;
+		r.argCount = 0;
+		r.textUsed = 0;
+		r.addAll(args...);
+		push(r);
+	};
+
+	static void start();
+	static void stop();
+	static void flush();
+	static void setSink(AUDIO_LOG_SINK sink, void* pContext);
+	static void getStats(CommandRingStats* stats);
+
+	static void format(const AudioLogRecord& r, wchar_t* pOut, size_t outChars);
+	static void stderrSink(AUDIO_LOG_LEVEL level, const wchar_t* text, void* pContext);
+
+protected:
+	static atomic<INT32> runtimeLevel;
+
+	static void push(const AudioLogRecord& r);
+};
+
+/**
+// End of AudioLog.h
+ */
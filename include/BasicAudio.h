@@ -1,19 +1,78 @@
 #pragma once
 
 #include "SampleSound.h"
+#include "PcmAssetCache.h"
+#include "VoicePool.h"
+#include "VoiceVirtualizer.h"
+#include "SoundHandles.h"
+#include "EmitterSoA.h"
+#include "Spatializer.h"
+#include "OfflineAudioEngine.h"
+#include "WorkerPool.h"
+#include "CommandRing.h"
+#include "AudioCommand.h"
+#include "SoundEvent.h"
+#include "EngineStats.h"
+#include <vector>
 #include <d3dx9.h>
 #include <unordered_map>
+#include <chrono>
 
 using namespace std;
 
+#define AUDIO_BUS_MAX_DEPTH		8   // levels of buses below the mastering voice
+
+class CWaveFile;
+class WavSampleSound;
+
+/**
+ * @struct	AudioBus
+ *
+ * @brief	A named submix voice made by BasicAudio::createBus(), and where it sits in the bus tree.
+ */
+struct AudioBus
+{
+	wstring name;
+	IXAudio2SubmixVoice* pVoice;
+	INT32 parent;           // index of the bus this one sends to, -1 for the mastering voice
+	UINT32 depth;           // 0 for a bus that sends to the mastering voice
+};
+
 /**
- * @typedef	unordered_map <LPCWSTR, SampleSound*> SOUND_MAP
+ * @struct	OfflineRenderStats
  *
- * @brief	Defines an alias representing the sound map. Based on the MSVC2010 projects contained with the DirectX distribution
- * 			XAudio2BasicSound - Voice definition etc
- * 			XAudio2Sound3D - 3D emitters
+ * @brief	How long an offline render took. speedMultiple is audio time over wall time, so 200 means the scene
+ * 			rendered 200 times faster than it would have played.
  */
-typedef unordered_map <LPCWSTR, SampleSound*> SOUND_MAP;
+struct OfflineRenderStats
+{
+	UINT64 frames;          // frames written
+	double audioSeconds;    // length of the audio written
+	double renderSeconds;   // time spent inside renderOffline(), mixing and writing
+	double wallSeconds;     // time from beginOfflineRender() to endOfflineRender(), scene updates included
+	double speedMultiple;   // audioSeconds / wallSeconds
+};
+
+/**
+ * @struct	BasicAudioStats
+ *
+ * @brief	Everything BasicAudio::getStats() reports: timings of the engine calls, how much is playing and how
+ * 			busy the queues are. Timings cover everything since the BasicAudio was made or resetStats() was
+ * 			last called; frames end with each run().
+ */
+struct BasicAudioStats
+{
+	UINT64 frames;          // run() calls
+	UINT32 sounds;          // sounds created
+	UINT32 playingSounds;   // of which playing now
+	UINT32 pendingLoads;    // async sounds still loading
+	VoicePoolStats instances; // fire-and-forget voices, see playInstance()
+	VirtualVoiceStats virtualVoices; // see createVirtualSound()
+	CommandRingStats commands; // see post()
+	CommandRingStats events; // see setSoundCallback()
+	SpatialUpdateStats spatial; // the last frame, see getSpatialStats()
+	TimerStats timers[ENGINE_TIMER_COUNT]; // indexed by ENGINE_TIMER
+};
 
 /**
  * @class	BasicAudio
@@ -22,16 +81,61 @@ typedef unordered_map <LPCWSTR, SampleSound*> SOUND_MAP;
  * 			
  * 			BasicAudio *ba = new BasicAudio(); // create the instance
  *			ba->init(); // initialize
+ *			ba->loadSoundBank(L"Wavs\\sounds.bank"); // optional: sounds packed by SoundBankBuilder are found here instead of on disk
  *			ba->createSound(L"music", L"Wavs\\MusicMono.wav", 0); // create a sound from a file. In this case a WAV. There can be many of these.
+ *			ba->createSound(L"music2", L"Wavs\\MusicMono.wav", 0); // sounds made from the same file share one copy of the data
+ *			ba->createStreamingSound(L"bed", L"Wavs\\Electro_1.wav", XAUDIO2_LOOP_INFINITE); // long files can be streamed from disk instead
+ *			ba->createCompressedSound(L"rotor", L"Wavs\\heli_adpcm.wav", XAUDIO2_LOOP_INFINITE); // or ADPCM kept compressed in memory and decoded as it plays
+ *			ba->createVirtualSound(L"torch17", L"Wavs\\fire.wav", XAUDIO2_LOOP_INFINITE); // or virtual: thousands can play, only the most audible get voices
+ *			ba->setVoiceBudget(48); // how many virtual sounds may have voices at once, checked by each run()
+ *			ba->createSoundAsync(L"level1", L"Wavs\\Techno_1.wav", 0); // or loaded on worker threads while the caller carries on
+ *			ba->createBus(L"sfx"); ba->createBus(L"weapons", L"sfx"); // optional: submix buses, each sending to the mastering voice or a parent bus
+ *			ba->createSound(L"shot", L"Wavs\\shot.wav", 0, L"weapons"); // sounds made on a bus are mixed through it
+ *			ba->setBusVolume(L"sfx", 0.5f); // one call fades every sound on the bus and the buses below it
+ *			ba->waitAll(); // optional: block until every async load is done and playable
  *			ba->getSoundByName(L"music")->start(); // get the instance to the sound and start(), stop(), run() etc.
+ *			SOUND_HANDLE music = ba->getHandle(L"music"); // or resolve the name once and use the handle every frame after that
+ *			ba->getSound(music)->setEmitterX(x);
+ *			ba->getSound(music)->setSpatialized(true); // have update3D() position this sound
+ *			ba->playInstance(L"shot", 10, 1.0f); // or fire off overlapping copies of it from the voice pool
  *			loop{
  *				// change some audio condition
- *				ba->playOnChannelVoice(voice, channelIndex); // play the voice on a specified channel or
+ *				ba->playOnChannel(sound, channelIndex); // play the sound on a specified channel or
  *				ba->play3DVoice(continuousSound);
- *				ba->run() // optional
+ *				ba->update3D(); // or position every spatialized sound in one call
+ *				ba->run() // optional, unless there are virtual sounds
  *			}
+ *			ba->destroySound(L"level1"); // a sound no longer needed can go early, the rest go with destroy()
  *			ba->destroy();
  *
+ * 			Apart from post(), none of this is thread safe. Other threads (gameplay, scripting...) queue
+ * 			AudioCommands with post() instead, which never blocks, and run() applies them in order on the
+ * 			thread that owns the BasicAudio, so each tick sees a consistent set of changes:
+ *
+ * 			AudioCommand cmd = { AUDIO_COMMAND_SET_EMITTER_POS, handle, 0, x, y, z };
+ * 			ba->post(cmd); // from any thread
+ *
+ * 			Sounds don't have to be polled to find out that they have finished. The voices queue their end,
+ * 			loop and error events as they happen, and run() hands them to the sounds concerned and to any
+ * 			callback set with setSoundCallback(), on the thread that calls run():
+ *
+ * 			ba->setSoundCallback(music, onMusicEvent, this); // onMusicEvent(handle, SOUND_EVENT_END, this)
+ *
+ * 			The time taken by run(), update3D(), play3DVoice(), the create functions and SetOutputMatrix() is
+ * 			recorded per call and per frame, cheaply enough to leave on in a shipping build:
+ *
+ * 			ba->getStats(&stats); // stats.timers[ENGINE_TIMER_RUN].frameP99Micros
+ *
+ * 			For offline rendering call initOffline() instead of init() and pace the same loop with renderOffline():
+ *
+ * 			ba->initOffline(48000, 2);
+ * 			ba->beginOfflineRender(L"scene.wav", false); // 16 bit PCM, or true for float
+ * 			loop{
+ * 				// change some audio condition, exactly as above
+ * 				ba->renderOffline(1.0 / 60.0); // mix the next 60th of a second to the file, as fast as possible
+ * 			}
+ * 			ba->endOfflineRender(&stats); // stats.speedMultiple
+ *
  * @author	Phil
  * @date	6/7/2013
  */
@@ -42,50 +146,227 @@ public:
 	~BasicAudio(void);
 
 	void init();
+	void initOffline(UINT32 sampleRate, UINT32 channels);
 	void run();
-	SampleSound* createSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount);
-	SampleSound* getSoundByName(LPCWSTR soundName){
+	bool post(const AudioCommand& command){return commands.push(command);};
+	bool post(AUDIO_COMMAND_TYPE type, SOUND_HANDLE handle, INT32 channel = 0, FLOAT32 x = 0, FLOAT32 y = 0, FLOAT32 z = 0){
+		AudioCommand command = { (UINT32)type, handle, channel, x, y, z };
+		return commands.push(command);
+	};
+	UINT32 applyCommands();
+	void getCommandQueueStats(CommandRingStats* stats){commands.getStats(stats);};
+	UINT32 dispatchEvents();
+	bool setSoundCallback(SOUND_HANDLE handle, SOUND_CALLBACK callback, void* pContext);
+	void getSoundEventStats(CommandRingStats* stats){soundEvents.getStats(stats);};
+	HRESULT loadSoundBank(LPCWSTR strFilename);
+	SampleSound* createSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL);
+	SampleSound* createStreamingSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL);
+	SampleSound* createCompressedSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL);
+	SampleSound* createVirtualSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL);
+	void setVoiceBudget(UINT32 budget){virtualizer.setBudget(budget);};
+	UINT32 getVoiceBudget(){return virtualizer.getBudget();};
+	SampleSound* createSoundAsync(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL);
+	void waitAll();
+	UINT32 getPendingLoadCount(){return (UINT32)pendingLoads.size();};
+	void setLoaderThreads(UINT32 threadCount){loaders.start(threadCount);};
+	SampleSound* getSoundByName(LPCWSTR soundName){return sounds.get(getHandle(soundName));};
+
+	/**
+	 * @fn	SOUND_HANDLE BasicAudio::getHandle(LPCWSTR soundName)
+	 *
+	 * @brief	Resolves a sound name to its handle. This is a hash lookup, so do it once and keep the handle.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	soundName	Name of the sound.
+	 *
+	 * @return	The handle, or SOUND_HANDLE_INVALID if there is no sound with that name.
+	 */
+	SOUND_HANDLE getHandle(LPCWSTR soundName){
 		SOUND_MAP::const_iterator got = soundMap.find(soundName);
 		if(got == soundMap.end()){
-			return NULL;
+			return SOUND_HANDLE_INVALID;
 		}
-		return soundMap[soundName];
+		return got->second;
 	};
+
+	/**
+	 * @fn	SampleSound* BasicAudio::getSound(SOUND_HANDLE handle)
+	 *
+	 * @brief	Resolves a handle to its sound with an array index.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	null if the handle is stale or invalid.
+	 */
+	SampleSound* getSound(SOUND_HANDLE handle){return sounds.get(handle);};
+	bool destroySound(SOUND_HANDLE handle);
+	bool destroySound(LPCWSTR soundName){return destroySound(getHandle(soundName));};
 	void destroy();
 
+	IXAudio2SubmixVoice* createBus(LPCWSTR busName, LPCWSTR parentName = NULL);
+	INT32 getBusIndex(LPCWSTR busName);
+	IXAudio2SubmixVoice* getBusVoice(LPCWSTR busName);
+	UINT32 getBusCount(){return (UINT32)buses.size();};
+	bool setBusVolume(LPCWSTR busName, FLOAT32 volume){return setBusVolume(getBusIndex(busName), volume);};
+	bool setBusVolume(INT32 busIndex, FLOAT32 volume);
+	FLOAT32 getBusVolume(LPCWSTR busName);
+	bool setBusOutputMatrix(LPCWSTR busName, const FLOAT32* matrix);
+	bool setSoundBus(LPCWSTR soundName, LPCWSTR busName){return setSoundBus(getHandle(soundName), busName);};
+	bool setSoundBus(SOUND_HANDLE handle, LPCWSTR busName);
+
+	VOICE_INSTANCE playInstance(LPCWSTR soundName, UINT32 priority = 0, FLOAT32 volume = 1.0f);
+	VOICE_INSTANCE playInstance(SOUND_HANDLE handle, UINT32 priority = 0, FLOAT32 volume = 1.0f);
+	IXAudio2SourceVoice* getInstanceVoice(VOICE_INSTANCE instance){return voicePool.getVoice(instance);};
+	void stopInstance(VOICE_INSTANCE instance){voicePool.stop(instance);};
+	VoicePool* getVoicePool(){return &voicePool;};
+
+	bool isOffline(){return pOfflineEngine != NULL;};
+	HRESULT beginOfflineRender(LPCWSTR strFilename, bool floatOutput);
+	HRESULT renderOffline(double seconds);
+	HRESULT endOfflineRender(OfflineRenderStats* stats);
+
 	IXAudio2 *getXaudioPtr(){return pXAudio2;}
 	IXAudio2MasteringVoice* getMasterVoice(){return pMasteringVoice;}
 	void printMatrixCoefficients();
 	const FLOAT32* getMatrixCoefficients(){return dspSettings.pMatrixCoefficients;};
 	const int getNumChannels(){return deviceDetails.OutputFormat.Format.nChannels;};
+	PcmAssetCache* getAssetCache(){return &assetCache;};
 	
 
+	void update3D();
+
+	/**
+	 * @fn	void BasicAudio::setSpatialThreads(UINT32 threadCount)
+	 *
+	 * @brief	Splits update3D() over this many worker threads as well as the caller's. 0, the default, keeps
+	 * 			it on the caller's thread. Stores of fewer than SPATIALIZER_TASK_GRAIN emitters per thread are
+	 * 			not worth splitting and use fewer threads.
+	 *
+	 * @date	10/17/2026
+	 */
+	void setSpatialThreads(UINT32 threadCount){
+		if(threadCount == 0)
+			spatialWorkers.stop();
+		else
+			spatialWorkers.start(threadCount);
+	};
+	void setUseX3DAudio(bool enable){
+		if(enable != useX3DAudio)
+			listenerDirty = true; // the results change with the method
+		useX3DAudio = enable;
+	};
+	Spatializer* getSpatializer(){return &spatializer;};
 	void play3DVoice(X3DAUDIO_EMITTER *emitter, IXAudio2SourceVoice* voice);
-	void play3DVoice(SampleSound* sound){play3DVoice(sound->getEmitter(), sound->getSourceVoice());};
+	void play3DVoice(SampleSound* sound);
 	void play3DVoice(LPCWSTR soundName){
 		SampleSound* ss = getSoundByName(soundName);
 		play3DVoice(ss);
 	};
+	void play3DVoice(SOUND_HANDLE handle){
+		SampleSound* ss = getSound(handle);
+		if(ss != NULL)
+			play3DVoice(ss);
+	};
 
 	void clearChannelVoice(IXAudio2SourceVoice* voice, int channel);
 	void playOnChannelVoice(IXAudio2SourceVoice* voice, int channel);
 	void playOnChannelVoice(IXAudio2SourceVoice* voice, int channel, float volume);
 	void addToChannelVoice(IXAudio2SourceVoice* voice, int channel, float volume);
+	void playOnChannel(SampleSound* sound, int channel, float volume = 1.0f);
+	void addToChannel(SampleSound* sound, int channel, float volume);
+	void clearChannel(SampleSound* sound, int channel);
+
+	void setListenerPosition(FLOAT32 x, FLOAT32 y, FLOAT32 z);
+	void setListenerVelocity(FLOAT32 x, FLOAT32 y, FLOAT32 z);
+	void setListenerOrientation(FLOAT32 frontX, FLOAT32 frontY, FLOAT32 frontZ, FLOAT32 topX, FLOAT32 topY, FLOAT32 topZ);
+	const X3DAUDIO_LISTENER* getListener(){return &listener;};
+
+	/**
+	 * @fn	void BasicAudio::getSpatialStats(SpatialUpdateStats* stats)
+	 *
+	 * @brief	Gets how many emitters update3D() and play3DVoice() recomputed and how many voices they updated
+	 * 			during the last frame, i.e. up to the end of the last run(), and how many of each they skipped.
+	 *
+	 * @date	10/17/2026
+	 */
+	void getSpatialStats(SpatialUpdateStats* stats){*stats = lastSpatialStats;};
+	void getStats(BasicAudioStats* stats);
+	void resetStats();
 
 protected:
 	HRESULT hr;
 	IXAudio2* pXAudio2;
 	UINT32 flags;
 	IXAudio2MasteringVoice* pMasteringVoice;
+	vector<AudioBus> buses; // parents before children, see createBus()
 	bool initialized;
+	bool logRunning;        // this object holds an AudioLog::start(), see destroy()
 	SOUND_MAP soundMap;
+	SoundHandleTable<SampleSound*> sounds;
+	EmitterSoA emitters;
+	Spatializer spatializer;
+	bool useX3DAudio;       // update3D() calls X3DAudioCalculate() per emitter instead of using the spatializer
+	vector<IXAudio2SourceVoice*> updateVoices; // voices computed in the first pass of update3D(), by emitter
+	vector<BYTE> updateChanged; // voices whose results update3D() committed as changed, by emitter
+	WorkerPool spatialWorkers; // splits update3D(), see setSpatialThreads()
+	PcmAssetCache assetCache;
+	vector<SoundBank*> soundBanks; // searched by createSound() before the file system, one reference held
+	VoicePool voicePool;
+	VoiceVirtualizer virtualizer;
+	vector<SampleSound*> promotedSounds; // virtual sounds the last run() gave voices to
+	chrono::steady_clock::time_point virtualClock; // when run() last moved the virtual sounds on
+	UINT64 virtualFrames;   // offlineFrames when run() last moved the virtual sounds on
+	WorkerPool loaders;     // runs the file reads of createSoundAsync()
+	vector<WavSampleSound*> pendingLoads; // async sounds that don't have their voice yet
+	CommandRing<AudioCommand> commands; // calls posted from other threads, applied by run()
+	CommandRing<SoundEvent> soundEvents; // voice ends, loops and errors, dispatched by run()
+	SoundEventCallback eventCallback; // the voice callback of every sound, feeds soundEvents
+	UINT64 lostEvents;      // soundEvents drops already made up for by pollSounds()
+
+	// offline rendering
+	OfflineAudioEngine* pOfflineEngine; // same object as pXAudio2 after initOffline(), otherwise NULL
+	CWaveFile* pOfflineFile;
+	bool offlineFloat;
+	vector<FLOAT32> offlineMix;
+	vector<INT16> offlinePCM;
+	UINT64 offlineFrames;
+	double offlineSecondsRequested;
+	double offlineRenderSeconds;
+	chrono::steady_clock::time_point offlineStart;
 
 	// 3D
 	X3DAUDIO_LISTENER listener;
 	XAUDIO2_DEVICE_DETAILS deviceDetails;
 	X3DAUDIO_DSP_SETTINGS dspSettings;
 	X3DAUDIO_HANDLE x3dAudioHandle;
+	bool listenerDirty;     // the listener has changed since the emitters were last marked
+	SpatialUpdateStats frameSpatialStats; // counted since the end of the last run()
+	SpatialUpdateStats lastSpatialStats; // the frame before that
+
+	// instrumentation, see getStats()
+	EngineTimer timers[ENGINE_TIMER_COUNT];
+	UINT64 frameCount;
 
+	bool finishInit();
+	bool addSound(SampleSound* sound, LPCWSTR soundName);
+	void useSoundBank(WavSampleSound* sound, LPCWSTR strFilename);
+	bool routeToBus(SampleSound* sound, LPCWSTR busName);
+	void finishLoads();
+	void applyCommand(const AudioCommand& command);
+	void pollSounds();
+	void flushListener();
+	SpatialListener getSpatialListener();
+	void updateVirtualVoices();
+	bool setListenerVector(X3DAUDIO_VECTOR* v, FLOAT32 x, FLOAT32 y, FLOAT32 z);
+	void applyEmitter(UINT32 index, IXAudio2SourceVoice* voice);
+	void calculateX3DAudio(UINT32 begin, UINT32 end);
+	void routeChannel(SampleSound* sound, int channel, FLOAT32 volume, bool exclusive);
+	void invalidateVoice(IXAudio2SourceVoice* voice);
+	void routeMatrix(FLOAT32* matrix, UINT32 srcChannels, int channel, FLOAT32 volume, bool exclusive);
+	UINT32 getVoiceChannels(IXAudio2SourceVoice* voice);
+	void setOutputMatrix(IXAudio2SourceVoice* voice, UINT32 srcChannels, const FLOAT32* matrix);
+	void endFrame();
 	void initListener(X3DAUDIO_LISTENER *listener);
 	void initDspSettings(X3DAUDIO_DSP_SETTINGS *ds, XAUDIO2_DEVICE_DETAILS *dd);
 	void setSingleMatrixVal(FLOAT32 * mat, int size, int index, FLOAT32 val, FLOAT32 clearVal);
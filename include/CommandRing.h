@@ -0,0 +1,203 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include <atomic>
+
+using namespace std;
+
+/**
+ * @struct	CommandRingStats
+ *
+ * @brief	Counters for a CommandRing.
+ */
+struct CommandRingStats
+{
+	UINT64 pushed;          // items accepted
+	UINT64 dropped;         // items refused because the ring was full
+	UINT64 popped;          // items taken by the consumer
+	UINT32 depth;           // items waiting now
+	UINT32 highWater;       // most items ever waiting at once
+	UINT32 capacity;
+};
+
+/**
+ * @class	CommandRing
+ *
+ * @brief	Bounded multi-producer, single-consumer queue of plain-old-data items. Each slot carries a sequence
+ * 			number that tells producers and the consumer whose turn it is, so there are no locks: push() never
+ * 			blocks and simply refuses (and counts) an item when the ring is full, and with a single producer it
+ * 			never even retries. Only one thread may call pop().
+ *
+ * 			CommandRing<AudioCommand> ring;
+ * 			ring.init(4096);
+ * 			ring.push(cmd);             // any thread
+ * 			while(ring.pop(&cmd)) ...   // the consumer
+ *
+ * @date	10/17/2026
+ */
+template <class T> class CommandRing
+{
+public:
+	CommandRing(void) : enqueuePos(0), pushed(0), dropped(0)
+	{
+		slots = NULL;
+		mask = 0;
+		dequeuePos = 0;
+		popped = 0;
+		highWater = 0;
+	};
+
+	~CommandRing(void){SAFE_DELETE_ARRAY(slots);};
+
+	/**
+	 * @fn	HRESULT CommandRing::init(UINT32 capacity)
+	 *
+	 * @brief	Allocates the ring and empties it. Not thread safe: call before any producer starts.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	capacity	Number of items, rounded up to a power of two.
+	 *
+	 * @return	S_OK or E_INVALIDARG for a zero capacity.
+	 */
+	HRESULT init(UINT32 capacity){
+		if(capacity == 0 || capacity > 0x80000000)
+			return E_INVALIDARG;
+		UINT32 size = 1;
+		while(size < capacity){
+			size <<= 1;
+		}
+		SAFE_DELETE_ARRAY(slots);
+		slots = new Slot[size];
+		for(UINT32 i = 0; i < size; ++i){
+			slots[i].sequence.store(i, memory_order_relaxed);
+		}
+		mask = size - 1;
+		enqueuePos.store(0, memory_order_relaxed);
+		dequeuePos = 0;
+		pushed.store(0, memory_order_relaxed);
+		dropped.store(0, memory_order_relaxed);
+		popped = 0;
+		highWater = 0;
+		return S_OK;
+	};
+
+	/**
+	 * @fn	bool CommandRing::push(const T& item)
+	 *
+	 * @brief	Adds an item. Safe from any number of threads at once.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the ring was full (or not initialised) and the item was dropped.
+	 */
+	bool push(const T& item){
+		if(slots == NULL){
+			dropped.fetch_add(1, memory_order_relaxed);
+			return false;
+		}
+		UINT32 pos = enqueuePos.load(memory_order_relaxed);
+		Slot* slot;
+		for(;;){
+			slot = &slots[pos & mask];
+			UINT32 sequence = slot->sequence.load(memory_order_acquire);
+			INT32 diff = (INT32)(sequence - pos);
+			if(diff == 0){
+				// the slot is free for this position, claim the position
+				if(enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+					break;
+			}else if(diff < 0){
+				// the consumer has not freed this slot yet: full
+				dropped.fetch_add(1, memory_order_relaxed);
+				return false;
+			}else{
+				// another producer took the position
+				pos = enqueuePos.load(memory_order_relaxed);
+			}
+		}
+		slot->item = item;
+		slot->sequence.store(pos + 1, memory_order_release);
+		pushed.fetch_add(1, memory_order_relaxed);
+		return true;
+	};
+
+	/**
+	 * @fn	bool CommandRing::pop(T* pItem)
+	 *
+	 * @brief	Takes the oldest item. Consumer thread only.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the ring is empty. An item whose producer has claimed its slot but not finished
+	 * 			writing it counts as not there yet.
+	 */
+	bool pop(T* pItem){
+		if(slots == NULL)
+			return false;
+		Slot* slot = &slots[dequeuePos & mask];
+		UINT32 sequence = slot->sequence.load(memory_order_acquire);
+		if((INT32)(sequence - (dequeuePos + 1)) < 0)
+			return false;
+
+		UINT32 depth = enqueuePos.load(memory_order_relaxed) - dequeuePos;
+		if(depth > highWater)
+			highWater = depth;
+
+		*pItem = slot->item;
+		slot->sequence.store(dequeuePos + mask + 1, memory_order_release);
+		dequeuePos++;
+		popped++;
+		return true;
+	};
+
+	UINT32 getCapacity(){return slots != NULL ? mask + 1 : 0;};
+
+	/**
+	 * @fn	UINT32 CommandRing::getDepth()
+	 *
+	 * @brief	Items waiting. Exact on the consumer thread, a snapshot anywhere else.
+	 *
+	 * @date	10/17/2026
+	 */
+	UINT32 getDepth(){return enqueuePos.load(memory_order_relaxed) - dequeuePos;};
+
+	/**
+	 * @fn	void CommandRing::getStats(CommandRingStats* stats)
+	 *
+	 * @brief	Copies out the counters. Call on the consumer thread.
+	 *
+	 * @date	10/17/2026
+	 */
+	void getStats(CommandRingStats* stats){
+		stats->pushed = pushed.load(memory_order_relaxed);
+		stats->dropped = dropped.load(memory_order_relaxed);
+		stats->popped = popped;
+		stats->depth = getDepth();
+		stats->highWater = highWater;
+		stats->capacity = getCapacity();
+	};
+
+protected:
+	struct Slot
+	{
+		atomic<UINT32> sequence;
+		T item;
+	};
+
+	Slot* slots;
+	UINT32 mask;
+
+	// producers and the consumer write different members, keep them on different cache lines
+	BYTE padProducer[64];
+	atomic<UINT32> enqueuePos;
+	atomic<UINT64> pushed;
+	atomic<UINT64> dropped;
+	BYTE padConsumer[64];
+	UINT32 dequeuePos;
+	UINT64 popped;
+	UINT32 highWater;
+};
+
+/**
+// End of CommandRing.h
+ */
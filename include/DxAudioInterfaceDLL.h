@@ -1,4 +1,5 @@
 #include "BasicAudio.h"
+#include "AudioLog.h"
 
 // The following ifdef block is the standard way of creating macros which make exporting 
 // from a DLL simpler. All files within this DLL are compiled with the DXAUDIOINTERFACEDLL_EXPORTS
@@ -21,6 +22,12 @@
  *
  * @brief	Dx audio interface dll.
  *
+ * 			The calls that change sounds (startSound(), stopSound(), setEmitterX(), play3DVoice(),
+ * 			playOnChannelVoice(), update3D()...) don't touch the sounds themselves: they queue a command that the
+ * 			next run() carries out, on whichever thread calls run(). That makes them safe and wait-free to call
+ * 			from gameplay threads, and gives every tick a consistent set of changes. The getters return the state
+ * 			as of the last run(). Creating sounds, playInstance() and run() itself belong to the owning thread.
+ *
  * @author	Phil
  * @date	6/10/2013
  */
@@ -44,13 +51,15 @@ public:
 	/**
 	 * @fn	CDxAudioInterfaceDLL::~CDxAudioInterfaceDLL(void)
 	 *
-	 * @brief	Destructor.
+	 * @brief	Destructor. Deletes the BasicAudio, which destroys it if destroy() wasn't called.
 	 *
 	 * @author	Phil
 	 * @date	6/10/2013
 	 */
 
-	~CDxAudioInterfaceDLL(void){};
+	~CDxAudioInterfaceDLL(void){
+		delete ba;
+	};
 
 	/**
 	 * @fn	void CDxAudioInterfaceDLL::init()
@@ -68,9 +77,62 @@ public:
 		//}
 	};
 
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::initOffline(UINT32 sampleRate, UINT32 channels)
+	 *
+	 * @brief	Initialises this object on the offline renderer instead of the sound card. Use
+	 * 			beginOfflineRender(), renderOffline() and endOfflineRender() to write the mix to a WAV file.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	sampleRate	Output sample rate.
+	 * @param	channels  	Output channels.
+	 */
+
+	void initOffline(UINT32 sampleRate, UINT32 channels){
+		ba = new BasicAudio();
+		ba->initOffline(sampleRate, channels);
+	};
+
+	HRESULT beginOfflineRender(LPCWSTR strFilename, bool floatOutput){
+		if(ba == NULL)
+			return E_FAIL;
+		return ba->beginOfflineRender(strFilename, floatOutput);
+	};
+
+	HRESULT renderOffline(double seconds){
+		if(ba == NULL)
+			return E_FAIL;
+		return ba->renderOffline(seconds);
+	};
+
+	HRESULT endOfflineRender(OfflineRenderStats* stats){
+		if(ba == NULL)
+			return E_FAIL;
+		return ba->endOfflineRender(stats);
+	};
+
+	/**
+	 * @fn	HRESULT CDxAudioInterfaceDLL::loadSoundBank(LPCWSTR strFilename)
+	 *
+	 * @brief	Opens a sound bank, which createSound() and createSoundAsync() search before the disk.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	strFilename	Path of the bank.
+	 *
+	 * @return	S_OK or the error from opening it.
+	 */
+
+	HRESULT loadSoundBank(LPCWSTR strFilename){
+		if(ba == NULL)
+			return E_FAIL;
+		return ba->loadSoundBank(strFilename);
+	};
+
 	/**
 	 * @fn	void CDxAudioInterfaceDLL::createSound(LPCWSTR soundName, LPCWSTR strFilename,
-	 * 		UINT loopCount)
+	 * 		UINT loopCount, LPCWSTR busName)
 	 *
 	 * @brief	Creates a sound.
 	 *
@@ -80,12 +142,302 @@ public:
 	 * @param	soundName  	Name of the sound.
 	 * @param	strFilename	Filename of the file.
 	 * @param	loopCount  	Number of loops.
+	 * @param	busName	   	Bus to play through, NULL for the mastering voice.
+	 *
+	 * @return	The handle of the new sound, for the handle versions of the calls below, or SOUND_HANDLE_INVALID
+	 * 			if there are no handles left.
+	 */
+
+	SOUND_HANDLE createSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL){
+		if(ba == NULL)
+			return SOUND_HANDLE_INVALID;
+		return handleOf(ba->createSound(soundName, strFilename, loopCount, busName));
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::createStreamingSound(LPCWSTR soundName, LPCWSTR strFilename,
+	 * 		UINT loopCount, LPCWSTR busName)
+	 *
+	 * @brief	Creates a sound that is streamed from disk instead of being loaded up front.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	soundName  	Name of the sound.
+	 * @param	strFilename	Filename of the file.
+	 * @param	loopCount  	Number of loops.
+	 * @param	busName	   	Bus to play through, NULL for the mastering voice.
+	 *
+	 * @return	The handle of the new sound, SOUND_HANDLE_INVALID if there are no handles left.
+	 */
+
+	SOUND_HANDLE createStreamingSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL){
+		if(ba == NULL)
+			return SOUND_HANDLE_INVALID;
+		return handleOf(ba->createStreamingSound(soundName, strFilename, loopCount, busName));
+	};
+
+	/**
+	 * @fn	SOUND_HANDLE CDxAudioInterfaceDLL::createCompressedSound(LPCWSTR soundName, LPCWSTR strFilename,
+	 * 		UINT loopCount, LPCWSTR busName)
+	 *
+	 * @brief	Creates a sound from an ADPCM file that stays compressed in memory and is decoded as it plays.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	soundName  	Name of the sound.
+	 * @param	strFilename	Filename of the file.
+	 * @param	loopCount  	Number of loops.
+	 * @param	busName	   	Bus to play through, NULL for the mastering voice.
+	 *
+	 * @return	The handle of the new sound, SOUND_HANDLE_INVALID if there are no handles left.
+	 */
+
+	SOUND_HANDLE createCompressedSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL){
+		if(ba == NULL)
+			return SOUND_HANDLE_INVALID;
+		return handleOf(ba->createCompressedSound(soundName, strFilename, loopCount, busName));
+	};
+
+	/**
+	 * @fn	SOUND_HANDLE CDxAudioInterfaceDLL::createVirtualSound(LPCWSTR soundName, LPCWSTR strFilename,
+	 * 		UINT loopCount, LPCWSTR busName)
+	 *
+	 * @brief	Creates a sound that only has a voice while it is among the most audible virtual sounds, so
+	 * 			thousands can play at once. See BasicAudio::createVirtualSound() and setVoiceBudget().
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	soundName  	Name of the sound.
+	 * @param	strFilename	Filename of the file.
+	 * @param	loopCount  	Number of loops.
+	 * @param	busName	   	Bus to play through, NULL for the mastering voice.
+	 *
+	 * @return	The handle of the new sound, SOUND_HANDLE_INVALID if there are no handles left.
 	 */
 
-	void createSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount){
+	SOUND_HANDLE createVirtualSound(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL){
+		if(ba == NULL)
+			return SOUND_HANDLE_INVALID;
+		return handleOf(ba->createVirtualSound(soundName, strFilename, loopCount, busName));
+	};
+
+	/**
+	 * @fn	SOUND_HANDLE CDxAudioInterfaceDLL::createSoundAsync(LPCWSTR soundName, LPCWSTR strFilename,
+	 * 		UINT loopCount, LPCWSTR busName)
+	 *
+	 * @brief	Creates a sound whose file is read on a loader thread. Returns at once; the sound can be
+	 * 			started straight away and plays when it has loaded. See BasicAudio::createSoundAsync().
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	soundName  	Name of the sound.
+	 * @param	strFilename	Filename of the file.
+	 * @param	loopCount  	Number of loops.
+	 * @param	busName	   	Bus to play through, NULL for the mastering voice.
+	 *
+	 * @return	The handle of the new sound, SOUND_HANDLE_INVALID if there are no handles left.
+	 */
+
+	SOUND_HANDLE createSoundAsync(LPCWSTR soundName, LPCWSTR strFilename, UINT loopCount, LPCWSTR busName = NULL){
+		if(ba == NULL)
+			return SOUND_HANDLE_INVALID;
+		return handleOf(ba->createSoundAsync(soundName, strFilename, loopCount, busName));
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::waitAll()
+	 *
+	 * @brief	Blocks until every sound from createSoundAsync() has loaded and is playable.
+	 *
+	 * @date	10/17/2026
+	 */
+
+	void waitAll(){
+		if(ba == NULL)
+			return;
+		ba->waitAll();
+	};
+
+	/**
+	 * @fn	bool CDxAudioInterfaceDLL::createBus(LPCWSTR busName, LPCWSTR parentName)
+	 *
+	 * @brief	Makes a named submix bus, sending to another bus or, if parentName is NULL, to the output.
+	 * 			See BasicAudio::createBus().
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the bus could not be made.
+	 */
+
+	bool createBus(LPCWSTR busName, LPCWSTR parentName = NULL){
+		if(ba == NULL)
+			return false;
+		return ba->createBus(busName, parentName) != NULL;
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::setBusVolume(LPCWSTR busName, FLOAT32 volume)
+	 *
+	 * @brief	Sets the volume of a bus and so of every sound on it. Posted, so it can be called from any
+	 * 			thread every frame of a fade.
+	 *
+	 * @date	10/17/2026
+	 */
+
+	void setBusVolume(LPCWSTR busName, FLOAT32 volume){
 		if(ba == NULL)
 			return;
-		ba->createSound(soundName, strFilename, loopCount);
+		ba->post(AUDIO_COMMAND_SET_BUS_VOLUME, SOUND_HANDLE_INVALID, ba->getBusIndex(busName), volume);
+	};
+
+	/**
+	 * @fn	bool CDxAudioInterfaceDLL::setSoundBus(LPCWSTR soundName, LPCWSTR busName)
+	 *
+	 * @brief	Moves a sound to another bus, or to the output if busName is NULL.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the sound or the bus doesn't exist.
+	 */
+
+	bool setSoundBus(LPCWSTR soundName, LPCWSTR busName){
+		if(ba == NULL)
+			return false;
+		return ba->setSoundBus(soundName, busName);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::setVoiceBudget(UINT32 budget)
+	 *
+	 * @brief	Sets how many virtual sounds may have a voice at once. Takes effect on the next run().
+	 *
+	 * @date	10/17/2026
+	 */
+
+	void setVoiceBudget(UINT32 budget){
+		if(ba == NULL)
+			return;
+		ba->setVoiceBudget(budget);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::setSoundVolume(SOUND_HANDLE handle, FLOAT32 volume)
+	 *
+	 * @brief	Sets the volume of a sound, which for a virtual sound also weighs its claim to a voice. Posted,
+	 * 			so it can be called from any thread.
+	 *
+	 * @date	10/17/2026
+	 */
+
+	void setSoundVolume(SOUND_HANDLE handle, FLOAT32 volume){
+		if(ba == NULL)
+			return;
+		ba->post(AUDIO_COMMAND_SET_VOLUME, handle, 0, volume);
+	};
+
+	/**
+	 * @fn	bool CDxAudioInterfaceDLL::destroySound(SOUND_HANDLE handle)
+	 *
+	 * @brief	Destroys a sound and frees its handle; see BasicAudio::destroySound(). Calls made with the
+	 * 			handle afterwards do nothing.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the handle is stale or invalid.
+	 */
+
+	bool destroySound(SOUND_HANDLE handle){
+		if(ba == NULL)
+			return false;
+		return ba->destroySound(handle);
+	};
+
+	/**
+	 * @fn	SOUND_LOAD_STATE CDxAudioInterfaceDLL::getLoadState(SOUND_HANDLE handle)
+	 *
+	 * @brief	Tells if a sound has loaded yet.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	The state, SOUND_LOAD_FAILED for an invalid handle.
+	 */
+
+	SOUND_LOAD_STATE getLoadState(SOUND_HANDLE handle){
+		if(ba == NULL || ba->getSound(handle) == NULL)
+			return SOUND_LOAD_FAILED;
+		return ba->getSound(handle)->getLoadState();
+	};
+
+	/**
+	 * @fn	SOUND_HANDLE CDxAudioInterfaceDLL::getHandle(LPCWSTR soundName)
+	 *
+	 * @brief	Resolves a sound name to its handle. The calls that take a handle skip the name lookup, so
+	 * 			resolve once and use those for per-frame control.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	soundName	Name of the sound.
+	 *
+	 * @return	The handle, or SOUND_HANDLE_INVALID if there is no such sound.
+	 */
+
+	SOUND_HANDLE getHandle(LPCWSTR soundName){
+		if(ba == NULL)
+			return SOUND_HANDLE_INVALID;
+		return ba->getHandle(soundName);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::getAssetCacheStats(PcmAssetCacheStats* stats)
+	 *
+	 * @brief	Gets the hit, miss and memory counters of the shared sample data cache.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	stats	Receives the counters.
+	 */
+
+	void getAssetCacheStats(PcmAssetCacheStats* stats){
+		if(ba == NULL)
+			return;
+		ba->getAssetCache()->getStats(stats);
+	};
+
+	/**
+	 * @fn	VOICE_INSTANCE CDxAudioInterfaceDLL::playInstance(LPCWSTR soundName, UINT32 priority,
+	 * 		FLOAT32 volume)
+	 *
+	 * @brief	Plays an overlapping fire-and-forget copy of a sound from the voice pool.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	soundName	Name of the sound.
+	 * @param	priority 	Priority of this copy. Higher priority copies are stolen last.
+	 * @param	volume   	Volume of this copy.
+	 *
+	 * @return	The instance, or 0 if it could not be played.
+	 */
+
+	VOICE_INSTANCE playInstance(LPCWSTR soundName, UINT32 priority, FLOAT32 volume){
+		if(ba == NULL)
+			return 0;
+		return ba->playInstance(soundName, priority, volume);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::getVoicePoolStats(VoicePoolStats* stats)
+	 *
+	 * @brief	Gets the occupancy counters of the voice pool.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	stats	Receives the counters.
+	 */
+
+	void getVoicePoolStats(VoicePoolStats* stats){
+		if(ba == NULL)
+			return;
+		ba->getVoicePool()->getStats(stats);
 	};
 
 	/**
@@ -102,7 +454,7 @@ public:
 	void startSound(LPCWSTR soundName) {
 		if(ba == NULL)
 			return;
-		ba->getSoundByName(soundName)->start();
+		ba->post(AUDIO_COMMAND_START, ba->getHandle(soundName));
 	};
 
 	/**
@@ -119,7 +471,7 @@ public:
 	void stopSound(LPCWSTR soundName) {
 		if(ba == NULL)
 			return;
-		ba->getSoundByName(soundName)->stop();
+		ba->post(AUDIO_COMMAND_STOP, ba->getHandle(soundName));
 	};
 
 	/**
@@ -136,7 +488,7 @@ public:
 	void play3DVoice(LPCWSTR soundName){
 		if(ba == NULL)
 			return;
-		ba->play3DVoice(ba->getSoundByName(soundName));
+		ba->post(AUDIO_COMMAND_PLAY_3D, ba->getHandle(soundName));
 	};
 
 	/**
@@ -154,9 +506,7 @@ public:
 	void playOnChannelVoice(LPCWSTR soundName, int channel){
 		if(ba == NULL)
 			return;
-		SampleSound* ss = ba->getSoundByName(soundName);
-		IXAudio2SourceVoice* voice = ss->getSourceVoice();
-		ba->playOnChannelVoice(voice, channel);
+		ba->post(AUDIO_COMMAND_PLAY_ON_CHANNEL, ba->getHandle(soundName), channel, 1.0f);
 	}
 
 	/**
@@ -198,21 +548,201 @@ public:
 	void setEmitterX(LPCWSTR soundName, FLOAT32 x) {
 		if(ba == NULL)
 			return;
-		SampleSound* ss = ba->getSoundByName(soundName);
-		ss->setEmitterX(x);
+		ba->post(AUDIO_COMMAND_SET_EMITTER_X, ba->getHandle(soundName), 0, x);
 	};
 
 	void setEmitterY(LPCWSTR soundName, FLOAT32 y) {
 		if(ba == NULL)
 			return;
-		SampleSound* ss = ba->getSoundByName(soundName);
-		ss->setEmitterY(y);
+		ba->post(AUDIO_COMMAND_SET_EMITTER_Y, ba->getHandle(soundName), 0, y);
 	};
 	void setEmitterZ(LPCWSTR soundName, FLOAT32 z) {
 		if(ba == NULL)
 			return;
-		SampleSound* ss = ba->getSoundByName(soundName);
-		ss->setEmitterZ(z);
+		ba->post(AUDIO_COMMAND_SET_EMITTER_Z, ba->getHandle(soundName), 0, z);
+	};
+
+	// Handle versions of the calls above. A stale or invalid handle is ignored.
+	// The calls that change a sound are queued, see the class description.
+
+	VOICE_INSTANCE playInstance(SOUND_HANDLE handle, UINT32 priority, FLOAT32 volume){
+		if(ba == NULL)
+			return 0;
+		return ba->playInstance(handle, priority, volume);
+	};
+
+	void startSound(SOUND_HANDLE handle) {
+		post(AUDIO_COMMAND_START, handle);
+	};
+
+	void stopSound(SOUND_HANDLE handle) {
+		post(AUDIO_COMMAND_STOP, handle);
+	};
+
+	void play3DVoice(SOUND_HANDLE handle){
+		post(AUDIO_COMMAND_PLAY_3D, handle);
+	};
+
+	void playOnChannelVoice(SOUND_HANDLE handle, int channel){
+		post(AUDIO_COMMAND_PLAY_ON_CHANNEL, handle, channel, 1.0f);
+	};
+
+	FLOAT32 getEmitterX(SOUND_HANDLE handle){
+		SampleSound* ss = getSound(handle);
+		return (ss != NULL) ? ss->getEmitterX() : 0;
+	};
+
+	FLOAT32 getEmitterY(SOUND_HANDLE handle){
+		SampleSound* ss = getSound(handle);
+		return (ss != NULL) ? ss->getEmitterY() : 0;
+	};
+
+	FLOAT32 getEmitterZ(SOUND_HANDLE handle){
+		SampleSound* ss = getSound(handle);
+		return (ss != NULL) ? ss->getEmitterZ() : 0;
+	};
+
+	void setEmitterX(SOUND_HANDLE handle, FLOAT32 x) {
+		post(AUDIO_COMMAND_SET_EMITTER_X, handle, 0, x);
+	};
+
+	void setEmitterY(SOUND_HANDLE handle, FLOAT32 y) {
+		post(AUDIO_COMMAND_SET_EMITTER_Y, handle, 0, y);
+	};
+
+	void setEmitterZ(SOUND_HANDLE handle, FLOAT32 z) {
+		post(AUDIO_COMMAND_SET_EMITTER_Z, handle, 0, z);
+	};
+
+	void setEmitterPos(SOUND_HANDLE handle, FLOAT32 x, FLOAT32 y, FLOAT32 z) {
+		post(AUDIO_COMMAND_SET_EMITTER_POS, handle, 0, x, y, z);
+	};
+
+	void setSpatialized(SOUND_HANDLE handle, bool enable) {
+		post(AUDIO_COMMAND_SET_SPATIALIZED, handle, enable ? 1 : 0);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::update3D()
+	 *
+	 * @brief	Positions every sound that has been marked with setSpatialized() in one call.
+	 *
+	 * @date	10/17/2026
+	 */
+
+	void update3D(){
+		post(AUDIO_COMMAND_UPDATE_3D, SOUND_HANDLE_INVALID);
+	};
+
+	void setListenerPosition(FLOAT32 x, FLOAT32 y, FLOAT32 z){
+		post(AUDIO_COMMAND_SET_LISTENER_POS, SOUND_HANDLE_INVALID, 0, x, y, z);
+	};
+
+	void setListenerVelocity(FLOAT32 x, FLOAT32 y, FLOAT32 z){
+		post(AUDIO_COMMAND_SET_LISTENER_VELOCITY, SOUND_HANDLE_INVALID, 0, x, y, z);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::getSpatialStats(SpatialUpdateStats* stats)
+	 *
+	 * @brief	Gets how many 3D updates the last frame computed and applied, and how many it skipped because
+	 * 			nothing had moved or the result was unchanged.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	stats	Receives the counters.
+	 */
+
+	void getSpatialStats(SpatialUpdateStats* stats){
+		if(ba == NULL)
+			return;
+		ba->getSpatialStats(stats);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::getStats(BasicAudioStats* stats)
+	 *
+	 * @brief	Gets the engine's per-call and per-frame timings (p50, p99 and max) and how many sounds and
+	 * 			voices are live. Call from the thread that calls run().
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	stats	Receives the stats.
+	 */
+
+	void getStats(BasicAudioStats* stats){
+		if(ba == NULL)
+			return;
+		ba->getStats(stats);
+	};
+
+	void resetStats(){
+		if(ba == NULL)
+			return;
+		ba->resetStats();
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::getCommandQueueStats(CommandRingStats* stats)
+	 *
+	 * @brief	Gets the depth, high water mark and dropped count of the command queue. A non-zero dropped
+	 * 			count means run() is not being called often enough for the rate of calls, or
+	 * 			AUDIO_COMMAND_QUEUE_SIZE is too small.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	stats	Receives the counters.
+	 */
+
+	void getCommandQueueStats(CommandRingStats* stats){
+		if(ba == NULL)
+			return;
+		ba->getCommandQueueStats(stats);
+	};
+
+	/**
+	 * @fn	bool CDxAudioInterfaceDLL::setSoundCallback(SOUND_HANDLE handle, SOUND_CALLBACK callback,
+	 * 		void* pContext)
+	 *
+	 * @brief	Has callback told when the sound ends, loops or fails, instead of polling for it. The callback
+	 * 			is called from run(), on the thread that calls run().
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the handle is stale or invalid.
+	 */
+
+	bool setSoundCallback(SOUND_HANDLE handle, SOUND_CALLBACK callback, void* pContext){
+		if(ba == NULL)
+			return false;
+		return ba->setSoundCallback(handle, callback, pContext);
+	};
+
+	void getSoundEventStats(CommandRingStats* stats){
+		if(ba == NULL)
+			return;
+		ba->getSoundEventStats(stats);
+	};
+
+	/**
+	 * @fn	void CDxAudioInterfaceDLL::setLogLevel(AUDIO_LOG_LEVEL level)
+	 *
+	 * @brief	Sets the least severe log records that are written. Records below the level the library was
+	 * 			built with (AUDIO_LOG_COMPILE_LEVEL) are never written.
+	 *
+	 * @date	10/17/2026
+	 */
+
+	void setLogLevel(AUDIO_LOG_LEVEL level){
+		AudioLog::setLevel(level);
+	};
+
+	void setLogSink(AUDIO_LOG_SINK sink, void* pContext){
+		AudioLog::setSink(sink, pContext);
+	};
+
+	void getLogStats(CommandRingStats* stats){
+		AudioLog::getStats(stats);
 	};
 
 	void printMatrixCoefficients(){
@@ -242,6 +772,15 @@ private:
 
 	BasicAudio *ba;
 
+	SampleSound* getSound(SOUND_HANDLE handle){return (ba != NULL) ? ba->getSound(handle) : NULL;};
+
+	static SOUND_HANDLE handleOf(SampleSound* sound){return (sound != NULL) ? sound->getHandle() : SOUND_HANDLE_INVALID;};
+
+	void post(AUDIO_COMMAND_TYPE type, SOUND_HANDLE handle, INT32 channel = 0, FLOAT32 x = 0, FLOAT32 y = 0, FLOAT32 z = 0){
+		if(ba != NULL)
+			ba->post(type, handle, channel, x, y, z);
+	};
+
 };
 
 /**
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "SoundHandles.h"
+#include <vector>
+
+#ifndef EMITTER_MATRIX_EPSILON
+#define EMITTER_MATRIX_EPSILON 1.0e-4f // largest change in a coefficient or Doppler factor that isn't sent to the voice
+#endif
+
+#ifndef EMITTER_MAX_CHANNELS
+#define EMITTER_MAX_CHANNELS 8  // most source channels an emitter can have, 7.1
+#endif
+
+#define EMITTER_LFE_AZIMUTH 6.283185307f // X3DAUDIO_2PI, the azimuth that marks a channel as LFE
+
+using namespace std;
+
+/**
+ * @struct	SpatialUpdateStats
+ *
+ * @brief	What BasicAudio::update3D() and play3DVoice() did, or avoided doing, during one frame.
+ */
+struct SpatialUpdateStats
+{
+	UINT32 computed;        // emitters whose output was recalculated
+	UINT32 skippedClean;    // emitters not recalculated because neither they nor the listener had moved
+	UINT32 applied;         // voices given a new output matrix and frequency ratio
+	UINT32 skippedUnchanged; // voices left alone because the result was within EMITTER_MATRIX_EPSILON of the last one
+};
+
+/**
+ * @class	EmitterSoA
+ *
+ * @brief	Structure-of-arrays storage for the 3D emitters of every sound, so that BasicAudio::update3D() can
+ * 			walk positions, velocities and orientations as contiguous float arrays instead of chasing a pointer
+ * 			into each SampleSound. Every array is SIMD_ALIGNMENT aligned and its capacity is a multiple of
+ * 			EMITTER_SOA_GRANULE, so kernels can run whole vectors past the last emitter.
+ *
+ * 			Emitter i belongs to the sound owner[i]. The results of the last update (Doppler factor, distance,
+ * 			reverb and LPF levels and the output matrix) are kept here too, so computing and applying can be
+ * 			separate passes.
+ *
+ * 			Each emitter has its own number of source channels, channels[i], placed around it at
+ * 			channelRadius[i] and the azimuths getAzimuths(i), as in X3DAUDIO_EMITTER. Its matrix is
+ * 			channels[i] * dstChannels floats laid out like X3DAUDIO_DSP_SETTINGS::pMatrixCoefficients, at the
+ * 			start of a slot sized for the most channels any emitter in the store has.
+ *
+ * 			Each emitter also has dirty flags. EMITTER_DIRTY_INPUT says its inputs (or the listener) have changed
+ * 			since the results were computed, EMITTER_DIRTY_OUTPUT that its voice must be sent the results even
+ * 			if they have not changed, e.g. because the voice is new. commit() compares the results with the
+ * 			ones last sent (appliedDoppler, appliedMatrix) so that voices are only touched when it matters.
+ * 			Code that writes the input arrays directly, rather than through SampleSound's setters, must
+ * 			markDirty() what it changes.
+ *
+ * @date	10/17/2026
+ */
+class EmitterSoA
+{
+public:
+	enum { EMITTER_SOA_GRANULE = 16 };
+	enum { EMITTER_DIRTY_INPUT = 1, EMITTER_DIRTY_OUTPUT = 2 };
+
+	EmitterSoA(void);
+	~EmitterSoA(void);
+
+	void setMatrixSize(UINT32 srcChannels, UINT32 dstChannels);
+	UINT32 add(SOUND_HANDLE owner);
+	SOUND_HANDLE remove(UINT32 index);
+	void clear();
+
+	UINT32 getCount(){return count;};
+	UINT32 getCapacity(){return capacity;};
+	UINT32 getSrcChannels(){return srcChannels;};
+	UINT32 getDstChannels(){return dstChannels;};
+	UINT32 getMatrixStride(){return srcChannels * dstChannels;};
+	UINT32 getMatrixSize(UINT32 index){return channels[index] * dstChannels;};
+	FLOAT32* getMatrix(UINT32 index){return matrix + index * getMatrixStride();};
+	FLOAT32* getAppliedMatrix(UINT32 index){return appliedMatrix + index * getMatrixStride();};
+
+	void setChannels(UINT32 index, UINT32 count, FLOAT32 radius, const FLOAT32* pAzimuths);
+	UINT32 getChannelCount(UINT32 index){return channels[index];};
+	const FLOAT32* getAzimuths(UINT32 index){return azimuths + index * srcChannels;};
+
+	void markDirty(UINT32 index, BYTE flags){dirty[index] |= flags;};
+	void markAllDirty(BYTE flags);
+	bool commit(UINT32 index, FLOAT32 epsilon);
+
+	// Inputs
+	FLOAT32 *posX, *posY, *posZ;
+	FLOAT32 *velX, *velY, *velZ;
+	FLOAT32 *frontX, *frontY, *frontZ;
+	FLOAT32 *topX, *topY, *topZ;
+	FLOAT32 *curveDistanceScaler;
+	FLOAT32 *dopplerScaler;
+	FLOAT32 *innerRadius;
+	FLOAT32 *innerRadiusAngle;
+	FLOAT32 *channelRadius;
+	FLOAT32 *gain;                 // the sound's volume, which Spatializer::estimateAudibility() scales
+	BYTE *channels;                 // source channels, set through setChannels()
+	BYTE *spatialized;              // non-zero if update3D() should process the emitter
+	BYTE *dirty;                    // EMITTER_DIRTY_ flags
+	SOUND_HANDLE *owner;
+
+	// Outputs of the last update
+	FLOAT32 *doppler;
+	FLOAT32 *distance;
+	FLOAT32 *reverbLevel;
+	FLOAT32 *lpfDirect;
+	FLOAT32 *audibility;           // from Spatializer::estimateAudibility(), not process()
+	FLOAT32 *matrix;
+
+	// What the voice was last given
+	FLOAT32 *appliedDoppler;
+	FLOAT32 *appliedMatrix;
+
+protected:
+	enum { FLOAT_FIELDS = 24 };     // posX through appliedDoppler, in the order of fieldPtrs()
+
+	UINT32 count;
+	UINT32 capacity;
+	UINT32 srcChannels;
+	UINT32 dstChannels;
+	FLOAT32* azimuths;              // srcChannels per emitter
+
+	static FLOAT32* reallocStrided(FLOAT32* pOld, UINT32 newCapacity, UINT32 oldStride, UINT32 newStride, UINT32 keep);
+	void fieldPtrs(FLOAT32** fields[FLOAT_FIELDS]);
+	void grow(UINT32 newCapacity);
+};
+
+/**
+// End of EmitterSoA.h
+ */
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include <chrono>
+
+using namespace std;
+
+#ifndef AUDIO_ENGINE_STATS
+#define AUDIO_ENGINE_STATS 1 // 0 compiles the ScopedTimers out, the timer stats then stay at zero
+#endif
+
+#define LATENCY_HISTOGRAM_LINEAR 16 // values below this many nanoseconds get a bucket each
+#define LATENCY_HISTOGRAM_SUB_BUCKETS 8 // buckets per power of two above that, about 12% wide
+#define LATENCY_HISTOGRAM_BUCKETS (LATENCY_HISTOGRAM_LINEAR + (64 - 4) * LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * @enum	ENGINE_TIMER
+ *
+ * @brief	The engine calls that BasicAudio times.
+ */
+enum ENGINE_TIMER
+{
+	ENGINE_TIMER_RUN,               // BasicAudio::run()
+	ENGINE_TIMER_UPDATE_3D,         // BasicAudio::update3D()
+	ENGINE_TIMER_PLAY_3D,           // BasicAudio::play3DVoice()
+	ENGINE_TIMER_CREATE_SOUND,      // BasicAudio::createSound(), the other create*Sound() calls and loadSoundBank()
+	ENGINE_TIMER_SET_OUTPUT_MATRIX, // IXAudio2Voice::SetOutputMatrix() calls made by BasicAudio
+	ENGINE_TIMER_COUNT
+};
+
+/**
+ * @class	LatencyHistogram
+ *
+ * @brief	Counts durations in nanoseconds into log-linear buckets: exact below 16ns, then eight buckets for
+ * 			each power of two. Recording is a few shifts and an increment, and any percentile can be read
+ * 			back to within a bucket's width. The maximum is kept exactly.
+ *
+ * @date	10/17/2026
+ */
+class LatencyHistogram
+{
+public:
+	LatencyHistogram(void){clear();};
+
+	void clear();
+	void record(UINT64 ns){
+		buckets[getBucket(ns)]++;
+		count++;
+		if(ns > maxNs)
+			maxNs = ns;
+	};
+	UINT64 getCount(){return count;};
+	UINT64 getMax(){return maxNs;};
+	UINT64 getPercentile(double percent);
+
+	static UINT32 getBucket(UINT64 ns);
+	static UINT64 getBucketTop(UINT32 bucket);
+
+protected:
+	UINT32 buckets[LATENCY_HISTOGRAM_BUCKETS];
+	UINT64 count;
+	UINT64 maxNs;
+};
+
+/**
+ * @struct	TimerStats
+ *
+ * @brief	What an EngineTimer has seen since it was last reset. The per-call figures treat every call on
+ * 			its own, the per-frame ones add up the calls made between two BasicAudio::run()s, counting only
+ * 			frames in which there was at least one.
+ */
+struct TimerStats
+{
+	UINT64 calls;           // calls timed
+	UINT64 frames;          // frames with at least one call
+	UINT32 lastFrameCalls;  // calls in the last frame
+	double lastFrameMicros; // time spent in them
+	double callP50Micros;
+	double callP99Micros;
+	double callMaxMicros;
+	double frameP50Micros;
+	double frameP99Micros;
+	double frameMaxMicros;
+};
+
+/**
+ * @class	EngineTimer
+ *
+ * @brief	Collects the durations of one kind of call, per call and per frame. Not thread safe: like the
+ * 			calls it times, it belongs to the thread that owns the BasicAudio.
+ *
+ * @date	10/17/2026
+ */
+class EngineTimer
+{
+public:
+	EngineTimer(void){reset();};
+
+	void add(UINT64 ns){
+		perCall.record(ns);
+		frameNs += ns;
+		frameCalls++;
+	};
+	void endFrame();
+	void reset();
+	void getStats(TimerStats* stats);
+
+protected:
+	LatencyHistogram perCall;
+	LatencyHistogram perFrame;
+	UINT64 frameNs;         // the frame in progress
+	UINT32 frameCalls;
+	UINT64 lastFrameNs;     // the frame before
+	UINT32 lastFrameCalls;
+};
+
+/**
+ * @class	ScopedTimer
+ *
+ * @brief	Adds the time from its construction to its destruction to an EngineTimer. Two steady_clock reads
+ * 			per scope, and nothing at all with AUDIO_ENGINE_STATS set to 0.
+ *
+ * 			{
+ * 				ScopedTimer t(&timers[ENGINE_TIMER_UPDATE_3D]);
+ * 				...
+ * 			}
+ *
+ * @date	10/17/2026
+ */
+#if AUDIO_ENGINE_STATS
+class ScopedTimer
+{
+public:
+	explicit ScopedTimer(EngineTimer* pTimer) : pTimer(pTimer), start(chrono::steady_clock::now()) {};
+	~ScopedTimer(void){
+		pTimer->add((UINT64)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+	};
+
+protected:
+	EngineTimer* pTimer;
+	chrono::steady_clock::time_point start;
+
+private:
+	ScopedTimer(const ScopedTimer&);
+	ScopedTimer& operator=(const ScopedTimer&);
+};
+#else
+class ScopedTimer
+{
+public:
+	explicit ScopedTimer(EngineTimer* pTimer){};
+};
+#endif
+
+/**
+// End of EngineStats.h
+ */
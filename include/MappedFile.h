@@ -0,0 +1,50 @@
+#pragma once
+
+#include "PortableTypes.h"
+
+/**
+ * @class	MappedFile
+ *
+ * @brief	A whole file mapped read-only into memory: CreateFileMapping on Windows, mmap elsewhere. Pages are
+ * 			read in as they are touched, so opening even a large file costs a few system calls. The data
+ * 			stays valid until close() or destruction.
+ *
+ * @date	10/17/2026
+ */
+class MappedFile
+{
+public:
+	MappedFile(void);
+	~MappedFile(void);
+
+	HRESULT open(const char* szFilename, bool sequential = true);
+#ifdef _WIN32
+	HRESULT open(const wchar_t* szFilename, bool sequential = true);
+#endif
+	void close();
+
+	bool isOpen(){return pData != NULL;};
+	const BYTE* getData(){return pData;};
+	size_t getSize(){return size;};
+
+protected:
+	const BYTE* pData;
+	size_t size;
+
+#ifdef _WIN32
+	HANDLE hFile;
+	HANDLE hMapping;
+
+	HRESULT map();
+#else
+	int fd;
+#endif
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
+
+/**
+// End of MappedFile.h
+ */
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "MappedFile.h"
+
+/**
+ * @class	MappedWaveFile
+ *
+ * @brief	Read-only WAV file that is memory mapped (CreateFileMapping on Windows, mmap elsewhere) and parsed in
+ * 			place. The RIFF 'fmt ', 'fact' and 'data' chunks are located without copying any sample data, so getData()
+ * 			can be handed straight to an XAUDIO2_BUFFER. The mapping stays valid until close() or destruction,
+ * 			so the object has to outlive any voice that is playing from it.
+ *
+ * @date	10/17/2026
+ */
+class MappedWaveFile
+{
+public:
+	MappedWaveFile(void);
+	~MappedWaveFile(void);
+
+	HRESULT open(const char* szFilename);
+#ifdef _WIN32
+	HRESULT open(const wchar_t* szFilename);
+#endif
+	HRESULT openFromMemory(const BYTE* pFileData, size_t fileSize);
+	HRESULT openData(const WAVEFORMATEX* pFormat, const BYTE* pData, DWORD dataSize, DWORD factFrames = 0);
+	void close();
+
+	bool isOpen(){return pData != NULL;};
+
+	/**
+	 * @fn	const WAVEFORMATEX* MappedWaveFile::getFormat()
+	 *
+	 * @brief	Gets the format. This is a copy of the 'fmt ' chunk (including any extra bytes), since the chunk
+	 * 			itself is not guaranteed to be aligned in the file.
+	 *
+	 * @return	null if no file is open, else the format.
+	 */
+	const WAVEFORMATEX* getFormat(){return pData != NULL ? (const WAVEFORMATEX*)pFormat : NULL;};
+
+	/**
+	 * @fn	const BYTE* MappedWaveFile::getData()
+	 *
+	 * @brief	Gets the sample data, pointing directly into the mapped file.
+	 */
+	const BYTE* getData(){return pData;};
+	DWORD getSize(){return dataSize;};
+	size_t getFileSize(){return fileSize;};
+
+	/**
+	 * @fn	DWORD MappedWaveFile::getFactFrames()
+	 *
+	 * @brief	Gets the frame count from the 'fact' chunk, which for ADPCM is the decoded length without the
+	 * 			padding of the last block.
+	 *
+	 * @return	0 if the file has no 'fact' chunk.
+	 */
+	DWORD getFactFrames(){return factFrames;};
+
+protected:
+	MappedFile mapping;     // open if the file was mapped by open()
+	const BYTE* pFileData;  // the whole file
+	size_t fileSize;
+	const BYTE* pData;      // start of the 'data' chunk payload
+	DWORD dataSize;
+	DWORD factFrames;       // 0 if there is no 'fact' chunk
+	BYTE* pFormat;          // copy of the 'fmt ' chunk as a WAVEFORMATEX
+
+	HRESULT parse();
+};
+
+/**
+// End of MappedWaveFile.h
+ */
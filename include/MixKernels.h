@@ -0,0 +1,72 @@
+#pragma once
+
+#include "PortableTypes.h"
+
+/**
+ * @enum	MIX_KERNEL
+ *
+ * @brief	Implementations of the mixing inner loops. They all give bit-identical output (there is no fused
+ * 			multiply-add), so a render does not change with the machine it was made on.
+ */
+enum MIX_KERNEL
+{
+	MIX_KERNEL_SCALAR,  // plain C++, always available
+	MIX_KERNEL_SSE2,    // 4 wide, needs an SSE2 build (always the case on x64)
+	MIX_KERNEL_AVX2     // 8 wide, picked at run time on CPUs and operating systems that support AVX2
+};
+
+/**
+ * @struct	MixKernels
+ *
+ * @brief	The inner loops of the software mixer for one instruction set. Get one with getMixKernels().
+ *
+ * 			mixChannel() adds one source channel into an interleaved bus, scaled by a gain for each bus
+ * 			channel: pBus[i * busChannels + d] += pIn[i * inStride] * pGains[d]. With inStride of 1 this is a
+ * 			mono source and a row of dspSettings.pMatrixCoefficients, larger strides pick one channel out of an
+ * 			interleaved source. Bus layouts of 2, 4, 6 and 8 channels are vectorized, others fall back to scalar.
+ *
+ * 			scale() multiplies a buffer in place, toPCM16() converts floats to 16 bit with saturation, rounding
+ * 			to nearest, and NaNs to 0.
+ *
+ * 			dot() and lerp() are the resampler's filter loops. dot() takes a count that is a multiple of 8 and
+ * 			always sums in the same order (8 running sums, then pairwise) so that it too is bit-identical
+ * 			across kernels. lerp() computes pOut[i] = pA[i] + (pB[i] - pA[i]) * t.
+ */
+struct MixKernels
+{
+	MIX_KERNEL kernel;
+	void (*mixChannel)(const FLOAT32* pIn, UINT32 inStride, FLOAT32* pBus, UINT32 frames, UINT32 busChannels, const FLOAT32* pGains);
+	void (*scale)(FLOAT32* pData, UINT32 count, FLOAT32 gain);
+	void (*toPCM16)(const FLOAT32* pIn, INT16* pOut, UINT32 count);
+	FLOAT32 (*dot)(const FLOAT32* pA, const FLOAT32* pB, UINT32 count);
+	void (*lerp)(const FLOAT32* pA, const FLOAT32* pB, FLOAT32 t, FLOAT32* pOut, UINT32 count);
+};
+
+bool isMixKernelAvailable(MIX_KERNEL kernel);
+MIX_KERNEL getBestMixKernel();
+const MixKernels* getMixKernels(MIX_KERNEL kernel);
+
+/**
+ * @fn	inline void setSingleMatrixVal(FLOAT32* mat, int size, int index, FLOAT32 val, FLOAT32 clearVal)
+ *
+ * @brief	Clears a row of output matrix coefficients to clearVal and sets the one at index to val. Used to
+ * 			play a mono voice on a single channel, see BasicAudio::playOnChannelVoice().
+ *
+ * @date	10/17/2026
+ */
+inline void setSingleMatrixVal(FLOAT32* mat, int size, int index, FLOAT32 val, FLOAT32 clearVal)
+{
+	for(int i = 0; i < size; ++i){
+		mat[i] = clearVal;
+	}
+	mat[index] = val;
+}
+
+inline void updateSingleMatrixVal(FLOAT32* mat, int /*size*/, int index, FLOAT32 val)
+{
+	mat[index] = val;
+}
+
+/**
+// End of MixKernels.h
+ */
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <windows.h>
+#include <XAudio2.h>
+#include <vector>
+#include <atomic>
+#include "SoftwareMixer.h"
+
+using namespace std;
+
+class OfflineAudioEngine;
+
+/**
+ * @class	OfflineSourceVoice
+ *
+ * @brief	IXAudio2SourceVoice on top of a MixerVoice. Buffers, looping, pitch, volume, the output matrix and
+ * 			a send to the mastering voice or one submix voice behave as they do in XAudio2, and the
+ * 			IXAudio2VoiceCallback is called the same way, only from whichever thread is rendering. Effects,
+ * 			filters and sends to more than one voice are not supported.
+ *
+ * @date	10/17/2026
+ */
+class OfflineSourceVoice : public IXAudio2SourceVoice, public MixerVoiceCallback
+{
+public:
+	// IXAudio2Voice
+	STDMETHOD_(void, GetVoiceDetails)(XAUDIO2_VOICE_DETAILS* pVoiceDetails);
+	STDMETHOD(SetOutputVoices)(const XAUDIO2_VOICE_SENDS* pSendList);
+	STDMETHOD(SetEffectChain)(const XAUDIO2_EFFECT_CHAIN* pEffectChain);
+	STDMETHOD(EnableEffect)(UINT32 EffectIndex, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD(DisableEffect)(UINT32 EffectIndex, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetEffectState)(UINT32 EffectIndex, BOOL* pEnabled);
+	STDMETHOD(SetEffectParameters)(UINT32 EffectIndex, const void* pParameters, UINT32 ParametersByteSize, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD(GetEffectParameters)(UINT32 EffectIndex, void* pParameters, UINT32 ParametersByteSize);
+	STDMETHOD(SetFilterParameters)(const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetFilterParameters)(XAUDIO2_FILTER_PARAMETERS* pParameters);
+	STDMETHOD(SetOutputFilterParameters)(IXAudio2Voice* pDestinationVoice, const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetOutputFilterParameters)(IXAudio2Voice* pDestinationVoice, XAUDIO2_FILTER_PARAMETERS* pParameters);
+	STDMETHOD(SetVolume)(float Volume, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetVolume)(float* pVolume);
+	STDMETHOD(SetChannelVolumes)(UINT32 Channels, const float* pVolumes, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetChannelVolumes)(UINT32 Channels, float* pVolumes);
+	STDMETHOD(SetOutputMatrix)(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, const float* pLevelMatrix, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetOutputMatrix)(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, float* pLevelMatrix);
+	STDMETHOD_(void, DestroyVoice)();
+
+	// IXAudio2SourceVoice
+	STDMETHOD(Start)(UINT32 Flags = 0, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD(Stop)(UINT32 Flags = 0, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD(SubmitSourceBuffer)(const XAUDIO2_BUFFER* pBuffer, const XAUDIO2_BUFFER_WMA* pBufferWMA = NULL);
+	STDMETHOD(FlushSourceBuffers)();
+	STDMETHOD(Discontinuity)();
+	STDMETHOD(ExitLoop)(UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetState)(XAUDIO2_VOICE_STATE* pVoiceState);
+	STDMETHOD(SetFrequencyRatio)(float Ratio, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetFrequencyRatio)(float* pRatio);
+	STDMETHOD(SetSourceSampleRate)(UINT32 NewSourceSampleRate);
+
+	// MixerVoiceCallback, forwarded to the IXAudio2VoiceCallback
+	void onProcessingPassStart(UINT32 bytesRequired);
+	void onProcessingPassEnd();
+	void onBufferStart(void* pContext);
+	void onBufferEnd(void* pContext);
+	void onLoopEnd(void* pContext);
+	void onStreamEnd();
+	void onVoiceError(void* pContext, HRESULT error);
+
+protected:
+	friend class OfflineAudioEngine;
+
+	OfflineSourceVoice(OfflineAudioEngine* pEngine, UINT32 flags, IXAudio2VoiceCallback* pCallback);
+	~OfflineSourceVoice(void);
+
+	OfflineAudioEngine* pEngine;
+	MixerVoice* pVoice;
+	UINT32 flags;
+	IXAudio2VoiceCallback* pCallback;
+};
+
+/**
+ * @class	OfflineMasteringVoice
+ *
+ * @brief	The mastering voice of an OfflineAudioEngine. Only its volume does anything.
+ *
+ * @date	10/17/2026
+ */
+class OfflineMasteringVoice : public IXAudio2MasteringVoice
+{
+public:
+	STDMETHOD_(void, GetVoiceDetails)(XAUDIO2_VOICE_DETAILS* pVoiceDetails);
+	STDMETHOD(SetOutputVoices)(const XAUDIO2_VOICE_SENDS* pSendList){return pSendList == NULL ? S_OK : XAUDIO2_E_INVALID_CALL;};
+	STDMETHOD(SetEffectChain)(const XAUDIO2_EFFECT_CHAIN* pEffectChain){return pEffectChain == NULL ? S_OK : E_NOTIMPL;};
+	STDMETHOD(EnableEffect)(UINT32 EffectIndex, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD(DisableEffect)(UINT32 EffectIndex, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetEffectState)(UINT32 EffectIndex, BOOL* pEnabled){*pEnabled = FALSE;};
+	STDMETHOD(SetEffectParameters)(UINT32 EffectIndex, const void* pParameters, UINT32 ParametersByteSize, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD(GetEffectParameters)(UINT32 EffectIndex, void* pParameters, UINT32 ParametersByteSize){return E_NOTIMPL;};
+	STDMETHOD(SetFilterParameters)(const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetFilterParameters)(XAUDIO2_FILTER_PARAMETERS* pParameters){};
+	STDMETHOD(SetOutputFilterParameters)(IXAudio2Voice* pDestinationVoice, const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetOutputFilterParameters)(IXAudio2Voice* pDestinationVoice, XAUDIO2_FILTER_PARAMETERS* pParameters){};
+	STDMETHOD(SetVolume)(float Volume, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetVolume)(float* pVolume);
+	STDMETHOD(SetChannelVolumes)(UINT32 Channels, const float* pVolumes, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetChannelVolumes)(UINT32 Channels, float* pVolumes);
+	STDMETHOD(SetOutputMatrix)(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, const float* pLevelMatrix, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return XAUDIO2_E_INVALID_CALL;};
+	STDMETHOD_(void, GetOutputMatrix)(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, float* pLevelMatrix){};
+	STDMETHOD_(void, DestroyVoice)();
+
+protected:
+	friend class OfflineAudioEngine;
+
+	OfflineMasteringVoice(OfflineAudioEngine* pEngine){this->pEngine = pEngine;};
+
+	OfflineAudioEngine* pEngine;
+};
+
+/**
+ * @class	OfflineSubmixVoice
+ *
+ * @brief	IXAudio2SubmixVoice on top of a MixerBus: a volume, an output matrix and a send to the mastering voice
+ * 			or to a submix voice of a higher processing stage. Effects and filters are not supported.
+ *
+ * @date	10/17/2026
+ */
+class OfflineSubmixVoice : public IXAudio2SubmixVoice
+{
+public:
+	STDMETHOD_(void, GetVoiceDetails)(XAUDIO2_VOICE_DETAILS* pVoiceDetails);
+	STDMETHOD(SetOutputVoices)(const XAUDIO2_VOICE_SENDS* pSendList);
+	STDMETHOD(SetEffectChain)(const XAUDIO2_EFFECT_CHAIN* pEffectChain){return pEffectChain == NULL ? S_OK : E_NOTIMPL;};
+	STDMETHOD(EnableEffect)(UINT32 EffectIndex, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD(DisableEffect)(UINT32 EffectIndex, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetEffectState)(UINT32 EffectIndex, BOOL* pEnabled){*pEnabled = FALSE;};
+	STDMETHOD(SetEffectParameters)(UINT32 EffectIndex, const void* pParameters, UINT32 ParametersByteSize, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD(GetEffectParameters)(UINT32 EffectIndex, void* pParameters, UINT32 ParametersByteSize){return E_NOTIMPL;};
+	STDMETHOD(SetFilterParameters)(const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetFilterParameters)(XAUDIO2_FILTER_PARAMETERS* pParameters){};
+	STDMETHOD(SetOutputFilterParameters)(IXAudio2Voice* pDestinationVoice, const XAUDIO2_FILTER_PARAMETERS* pParameters, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetOutputFilterParameters)(IXAudio2Voice* pDestinationVoice, XAUDIO2_FILTER_PARAMETERS* pParameters){};
+	STDMETHOD(SetVolume)(float Volume, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetVolume)(float* pVolume);
+	STDMETHOD(SetChannelVolumes)(UINT32 Channels, const float* pVolumes, UINT32 OperationSet = XAUDIO2_COMMIT_NOW){return E_NOTIMPL;};
+	STDMETHOD_(void, GetChannelVolumes)(UINT32 Channels, float* pVolumes);
+	STDMETHOD(SetOutputMatrix)(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, const float* pLevelMatrix, UINT32 OperationSet = XAUDIO2_COMMIT_NOW);
+	STDMETHOD_(void, GetOutputMatrix)(IXAudio2Voice* pDestinationVoice, UINT32 SourceChannels, UINT32 DestinationChannels, float* pLevelMatrix);
+	STDMETHOD_(void, DestroyVoice)();
+
+protected:
+	friend class OfflineAudioEngine;
+
+	OfflineSubmixVoice(OfflineAudioEngine* pEngine, UINT32 flags, MixerBus* pBus);
+	~OfflineSubmixVoice(void);
+
+	OfflineAudioEngine* pEngine;
+	MixerBus* pBus;
+	UINT32 flags;
+};
+
+/**
+ * @class	OfflineAudioEngine
+ *
+ * @brief	An IXAudio2 that renders into memory instead of to a device. Voices are made and driven exactly as
+ * 			with the engine from XAudio2Create(), but nothing is heard until render() is called, and each call
+ * 			mixes the next block as fast as the CPU allows. BasicAudio::initOffline() uses this to bounce a
+ * 			scene to a WAV file faster than real time, e.g. for regression renders on a build machine.
+ *
+ * 			OfflineAudioEngine* pEngine;
+ * 			OfflineAudioEngine::create(48000, 2, &pEngine);
+ * 			pEngine->CreateMasteringVoice(&pMaster);
+ * 			pEngine->CreateSourceVoice(&pVoice, &wfx);
+ * 			...
+ * 			pEngine->render(pOut, pEngine->getQuantumFrames());
+ *
+ * @date	10/17/2026
+ */
+class OfflineAudioEngine : public IXAudio2
+{
+public:
+	static HRESULT create(UINT32 sampleRate, UINT32 channels, OfflineAudioEngine** ppEngine);
+
+	// IUnknown
+	STDMETHOD(QueryInterface)(REFIID riid, void** ppvInterface);
+	STDMETHOD_(ULONG, AddRef)();
+	STDMETHOD_(ULONG, Release)();
+
+	// IXAudio2
+	STDMETHOD(GetDeviceCount)(UINT32* pCount);
+	STDMETHOD(GetDeviceDetails)(UINT32 Index, XAUDIO2_DEVICE_DETAILS* pDeviceDetails);
+	STDMETHOD(Initialize)(UINT32 Flags = 0, XAUDIO2_PROCESSOR XAudio2Processor = XAUDIO2_DEFAULT_PROCESSOR){return S_OK;};
+	STDMETHOD(RegisterForCallbacks)(IXAudio2EngineCallback* pCallback);
+	STDMETHOD_(void, UnregisterForCallbacks)(IXAudio2EngineCallback* pCallback);
+	STDMETHOD(CreateSourceVoice)(IXAudio2SourceVoice** ppSourceVoice, const WAVEFORMATEX* pSourceFormat, UINT32 Flags = 0, float MaxFrequencyRatio = XAUDIO2_DEFAULT_FREQ_RATIO, IXAudio2VoiceCallback* pCallback = NULL, const XAUDIO2_VOICE_SENDS* pSendList = NULL, const XAUDIO2_EFFECT_CHAIN* pEffectChain = NULL);
+	STDMETHOD(CreateSubmixVoice)(IXAudio2SubmixVoice** ppSubmixVoice, UINT32 InputChannels, UINT32 InputSampleRate, UINT32 Flags = 0, UINT32 ProcessingStage = 0, const XAUDIO2_VOICE_SENDS* pSendList = NULL, const XAUDIO2_EFFECT_CHAIN* pEffectChain = NULL);
+	STDMETHOD(CreateMasteringVoice)(IXAudio2MasteringVoice** ppMasteringVoice, UINT32 InputChannels = XAUDIO2_DEFAULT_CHANNELS, UINT32 InputSampleRate = XAUDIO2_DEFAULT_SAMPLERATE, UINT32 Flags = 0, UINT32 DeviceIndex = 0, const XAUDIO2_EFFECT_CHAIN* pEffectChain = NULL);
+	STDMETHOD(StartEngine)();
+	STDMETHOD_(void, StopEngine)();
+	STDMETHOD(CommitChanges)(UINT32 OperationSet){return S_OK;};
+	STDMETHOD_(void, GetPerformanceData)(XAUDIO2_PERFORMANCE_DATA* pPerfData);
+	STDMETHOD_(void, SetDebugConfiguration)(const XAUDIO2_DEBUG_CONFIGURATION* pDebugConfiguration, void* pReserved = NULL){};
+
+	void render(FLOAT32* pOut, UINT32 frames);
+	UINT32 getSampleRate(){return mixer.getSampleRate();};
+	UINT32 getChannels(){return mixer.getChannels();};
+	UINT32 getQuantumFrames(){return mixer.getQuantumFrames();};
+	SoftwareMixer* getMixer(){return &mixer;};
+
+	static DWORD getChannelMask(UINT32 channels);
+
+protected:
+	friend class OfflineSourceVoice;
+	friend class OfflineMasteringVoice;
+	friend class OfflineSubmixVoice;
+
+	OfflineAudioEngine(void);
+	virtual ~OfflineAudioEngine(void);
+
+	atomic<LONG> refCount;
+	SoftwareMixer mixer;
+	OfflineMasteringVoice* pMasteringVoice;
+	vector<OfflineSourceVoice*> sourceVoices;
+	vector<OfflineSubmixVoice*> submixVoices;
+	vector<IXAudio2EngineCallback*> engineCallbacks;
+	bool engineRunning;
+
+	bool isDestination(IXAudio2Voice* pVoice, MixerBus* pBus);
+	HRESULT resolveSends(const XAUDIO2_VOICE_SENDS* pSendList, MixerBus** ppBus);
+	void removeSourceVoice(OfflineSourceVoice* pVoice);
+	void removeSubmixVoice(OfflineSubmixVoice* pVoice);
+};
+
+/**
+// End of OfflineAudioEngine.h
+ */
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "MappedWaveFile.h"
+#include "SampleConvert.h"
+#include "AdpcmCodec.h"
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+using namespace std;
+
+#ifdef _WIN32
+typedef wchar_t PATH_CHAR;
+#else
+typedef char PATH_CHAR;
+#endif
+typedef basic_string<PATH_CHAR> PATH_STRING;
+
+class PcmAssetCache;
+class SoundBank;
+
+/**
+ * @class	PcmAsset
+ *
+ * @brief	Immutable, reference counted block of sample data and its format. Sounds that play the same file
+ * 			share one of these instead of each keeping their own copy. Reference counting follows the COM
+ * 			convention used for the XAudio2 interfaces, so SAFE_RELEASE works on it: the object deletes itself
+ * 			(and leaves its cache) when the last reference is released.
+ *
+ * 			Unless told otherwise, 8, 16 and 24 bit PCM is converted to 32 bit float once, as it is loaded,
+ * 			so that every voice made from an asset mixes in the same engine format (and VoicePool only needs
+ * 			one set of voices per rate and channel count). IMA and MS ADPCM are decoded the same way. The file
+ * 			mapping is dropped once the converted copy is made. Float files, formats the converters don't
+ * 			handle, and anything loaded without conversion are used in place: an ADPCM asset loaded that way
+ * 			stays compressed, about a quarter of the size, for WavStreamReader to decode as it plays.
+ *
+ * 			An asset can also come from a SoundBank, in which case it holds a reference on the bank for as long
+ * 			as it plays from the bank's mapping.
+ *
+ * @date	10/17/2026
+ */
+class PcmAsset
+{
+public:
+	static HRESULT create(const PATH_CHAR* szPath, PcmAsset** ppAsset, bool convertToEngineFormat = true);
+	static HRESULT create(SoundBank* pBank, UINT32 index, PcmAsset** ppAsset, bool convertToEngineFormat = true);
+
+	ULONG AddRef();
+	ULONG Release();
+
+	const WAVEFORMATEX* getFormat(){return pSamples != NULL ? (const WAVEFORMATEX*)floatFormat : file.getFormat();};
+	const BYTE* getData(){return pSamples != NULL ? (const BYTE*)pSamples : file.getData();};
+	DWORD getSize(){return pSamples != NULL ? convertedSize : file.getSize();};
+	DWORD getFactFrames(){return file.getFactFrames();}; // of data left in the file's format, 0 once converted
+	const PATH_STRING& getPath(){return path;};
+	SAMPLE_FORMAT getSourceFormat(){return sourceFormat;};
+	bool isConverted(){return pSamples != NULL;};
+	bool isCompressed(){return pSamples == NULL && getAdpcmType(file.getFormat()) != ADPCM_TYPE_NONE;};
+
+protected:
+	friend class PcmAssetCache;
+
+	PcmAsset(void);
+	~PcmAsset(void);
+
+	HRESULT prepare(bool convertToEngineFormat);
+	HRESULT decodeAdpcm(const AdpcmFormat* pAdpcm);
+	void closeFile();
+
+	MappedWaveFile file;
+	FLOAT32* pSamples;      // the data converted to float, null if the mapping is used in place
+	DWORD convertedSize;
+	BYTE floatFormat[SAMPLE_FLOAT_FORMAT_BYTES];
+	SAMPLE_FORMAT sourceFormat; // the sample format of the file
+	PATH_STRING path;       // canonical path, also the cache key
+	SoundBank* pBank;       // bank the data is mapped from, held until the file is closed
+	atomic<LONG> refCount;
+	PcmAssetCache* pCache;  // cache this asset is registered with, NULL if uncached
+};
+
+/**
+ * @struct	PcmAssetCacheStats
+ *
+ * @brief	Counters for a PcmAssetCache.
+ */
+struct PcmAssetCacheStats
+{
+	UINT64 hits;            // acquire() calls satisfied by an asset already in the cache
+	UINT64 misses;          // acquire() calls that had to load the file
+	UINT64 bytesLoaded;     // sample bytes loaded on misses
+	UINT64 bytesSaved;      // sample bytes that hits did not have to load again
+	UINT32 liveAssets;      // assets currently in the cache
+	UINT64 residentBytes;   // sample bytes of the assets currently in the cache
+};
+
+/**
+ * @class	PcmAssetCache
+ *
+ * @brief	Hands out shared PcmAssets keyed by canonical file path, so any number of named sounds registered
+ * 			against the same file cost one load and one copy of the data. Assets stay in the cache exactly as
+ * 			long as something holds a reference to them. Thread safe: files are loaded outside the lock, so
+ * 			threads loading different files don't wait for each other.
+ *
+ * @date	10/17/2026
+ */
+class PcmAssetCache
+{
+public:
+	PcmAssetCache(void);
+	~PcmAssetCache(void);
+
+	HRESULT acquire(const PATH_CHAR* szPath, PcmAsset** ppAsset);
+	HRESULT acquire(SoundBank* pBank, UINT32 index, PcmAsset** ppAsset);
+	void getStats(PcmAssetCacheStats* stats);
+
+	void setConvertToEngineFormat(bool convert){convertToEngineFormat = convert;};
+	bool getConvertToEngineFormat(){return convertToEngineFormat;};
+
+	static PATH_STRING canonicalPath(const PATH_CHAR* szPath);
+	static PATH_STRING bankPath(SoundBank* pBank, UINT32 index);
+
+protected:
+	friend class PcmAsset;
+
+	typedef unordered_map<PATH_STRING, PcmAsset*> ASSET_MAP;
+
+	ASSET_MAP assets;       // NULL while the asset is being loaded by an acquire()
+	mutex lock;
+	condition_variable loaded; // signalled when a load finishes, or fails
+	PcmAssetCacheStats stats;
+	bool convertToEngineFormat; // applies to assets loaded from now on
+
+	HRESULT acquire(const PATH_STRING& key, SoundBank* pBank, UINT32 index, PcmAsset** ppAsset);
+	ULONG release(PcmAsset* pAsset);
+};
+
+/**
+// End of PcmAssetCache.h
+ */
@@ -0,0 +1,94 @@
+/**
+ * @file	PortableTypes.h
+ *
+ * @brief	The handful of Win32 types, HRESULT codes and wave format definitions used by the parts of the
+ * 			library that have no XAudio2 dependency. On Windows this simply pulls in the platform headers,
+ * 			everywhere else it supplies compatible definitions so that those modules (streaming, file I/O,
+ * 			mixing and DSP kernels) can be built and exercised headless, e.g. on a Linux build box.
+ */
+
+#pragma once
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <MMSystem.h>
+#include <mmreg.h>
+
+#else
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t		BYTE;
+typedef uint16_t	WORD;
+typedef uint32_t	DWORD;
+typedef int32_t		BOOL;
+typedef int32_t		LONG;
+typedef uint32_t	ULONG;
+typedef unsigned int UINT;
+typedef uint32_t	UINT32;
+typedef uint64_t	UINT64;
+typedef int16_t		INT16;
+typedef int32_t		INT32;
+typedef int64_t		INT64;
+typedef float		FLOAT32;
+typedef int32_t		HRESULT;
+
+#ifndef TRUE
+#define TRUE	1
+#define FALSE	0
+#endif
+
+#define S_OK					((HRESULT)0L)
+#define S_FALSE					((HRESULT)1L)
+#define E_NOTIMPL				((HRESULT)0x80004001L)
+#define E_FAIL					((HRESULT)0x80004005L)
+#define E_OUTOFMEMORY			((HRESULT)0x8007000EL)
+#define E_INVALIDARG			((HRESULT)0x80070057L)
+#define CO_E_NOTINITIALIZED		((HRESULT)0x800401F0L)
+#define SUCCEEDED(hr)			(((HRESULT)(hr)) >= 0)
+#define FAILED(hr)				(((HRESULT)(hr)) < 0)
+
+#define WAVE_FORMAT_PCM			1
+#define WAVE_FORMAT_ADPCM		0x0002
+#define WAVE_FORMAT_IEEE_FLOAT	0x0003
+#define WAVE_FORMAT_IMA_ADPCM	0x0011
+#define WAVE_FORMAT_EXTENSIBLE	0xFFFE
+
+#pragma pack(push, 1)
+typedef struct tWAVEFORMATEX
+{
+	WORD	wFormatTag;         // format type
+	WORD	nChannels;          // number of channels (i.e. mono, stereo...)
+	DWORD	nSamplesPerSec;     // sample rate
+	DWORD	nAvgBytesPerSec;    // for buffer estimation
+	WORD	nBlockAlign;        // block size of data
+	WORD	wBitsPerSample;     // number of bits per sample of mono data
+	WORD	cbSize;             // the count in bytes of the size of extra information (after cbSize)
+} WAVEFORMATEX;
+#pragma pack(pop)
+
+#endif // _WIN32
+
+#ifndef S_FAILED
+#define S_FAILED ((HRESULT)(-1L))
+#endif
+
+#ifndef E_FILE_NOT_FOUND
+#define E_FILE_NOT_FOUND ((HRESULT)0x80070002L) // HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)
+#endif
+
+#ifndef SAFE_DELETE
+#define SAFE_DELETE(p)       { if(p) { delete (p);     (p)=NULL; } }
+#endif
+#ifndef SAFE_DELETE_ARRAY
+#define SAFE_DELETE_ARRAY(p) { if(p) { delete[] (p);   (p)=NULL; } }
+#endif
+#ifndef SAFE_RELEASE
+#define SAFE_RELEASE(p)      { if(p) { (p)->Release(); (p)=NULL; } }
+#endif
+
+/**
+// End of PortableTypes.h
+ */
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "MixKernels.h"
+#include <vector>
+
+#define RESAMPLER_PHASE_BITS	8       // the filters are tabulated at 256 phases between samples, and interpolated
+#define RESAMPLER_MAX_STEP		4.0     // input frames per output frame beyond which the output aliases
+
+using namespace std;
+
+/**
+ * @enum	RESAMPLER_QUALITY
+ *
+ * @brief	Resampler filter lengths. Cost grows with the number of taps; linear does no band limiting at all.
+ */
+enum RESAMPLER_QUALITY
+{
+	RESAMPLER_QUALITY_LINEAR,   // 2 taps, straight line between neighbouring samples
+	RESAMPLER_QUALITY_SINC8,    // 8 tap Kaiser windowed sinc
+	RESAMPLER_QUALITY_SINC32    // 32 tap Kaiser windowed sinc
+};
+
+/**
+ * @class	Resampler
+ *
+ * @brief	Band limited polyphase sample rate converter for one voice. Input is pushed in, output pulled out,
+ * 			and the step (input frames per output frame, i.e. frequency ratio * source rate / output rate) can
+ * 			change on every pull. It is ramped across the pulled block so that Doppler and pitch changes do not
+ * 			zipper.
+ *
+ * 			The windowed sinc filters are tabulated once per quality and shared by all resamplers. For steps
+ * 			above 1 a table with a lower cutoff is picked so that what would fold back is filtered out first.
+ * 			Filter coefficients for each output frame are interpolated between the two nearest phases and
+ * 			applied with the dot product from MixKernels, so the work is done with SSE2 or AVX2.
+ *
+ * 			Resampler rs;
+ * 			rs.init(2, RESAMPLER_QUALITY_SINC8);
+ * 			while(...){
+ * 				rs.push(pIn, rs.getInputNeeded(frames, lastStep, step));
+ * 				rs.pull(pOut, frames, lastStep, step);
+ * 			}
+ *
+ * 			A step of exactly 1 from a whole sample position copies the input through unchanged.
+ *
+ * @date	10/17/2026
+ */
+class Resampler
+{
+public:
+	Resampler(void);
+	~Resampler(void);
+
+	HRESULT init(UINT32 channels, RESAMPLER_QUALITY quality);
+	void reset();
+	bool setKernel(MIX_KERNEL kernel);
+
+	UINT32 getInputNeeded(UINT32 outFrames, double startStep, double endStep);
+	void push(const FLOAT32* pIn, UINT32 frames);
+	void endOfStream();
+	UINT32 pull(FLOAT32* pOut, UINT32 outFrames, double startStep, double endStep);
+
+	UINT32 getChannels(){return channels;};
+	UINT32 getTaps(){return taps;};
+	RESAMPLER_QUALITY getQuality(){return quality;};
+	bool isDraining(){return draining;};
+
+protected:
+	UINT32 channels;
+	RESAMPLER_QUALITY quality;
+	UINT32 taps;
+	UINT32 history;         // taps / 2 - 1: frames before the current one the filter reaches back to
+	const MixKernels* pKernels;
+	const FLOAT32* pTables; // the shared tables for this quality, NULL for linear
+
+	vector<FLOAT32> buffer; // planar, channel c at c * capacity
+	UINT32 capacity;
+	UINT32 filled;          // frames in each channel of the buffer
+	UINT64 position;        // 32.32 fixed point frame position in the buffer
+	bool draining;
+	UINT32 drainEnd;        // with draining, the frame after the last real one
+	vector<FLOAT32> coefs;  // scratch, the interpolated filter for one output frame
+
+	void compact();
+	void reserve(UINT32 frames);
+	static const FLOAT32* getTable(RESAMPLER_QUALITY quality, UINT32 tableIndex);
+	static UINT32 getTableIndex(double step);
+};
+
+/**
+// End of Resampler.h
+ */
@@ -11,11 +11,13 @@
 //-----------------------------------------------------------------------------
 #define WAVEFILE_READ   1
 #define WAVEFILE_WRITE  2
+#define WAVEFILE_BACKGROUND_FLUSH 4 // or with WAVEFILE_WRITE to write to disk on a background thread
 
 #include "stdafx.h"
 #include <xaudio2.h>
 #include <DxErr.h>
 #include <MMSystem.h>
+#include "WaveFileWriter.h"
 
 
 //--------------------------------------------------------------------------------------
@@ -39,7 +41,7 @@ public:
     MMCKINFO m_ck;          // Multimedia RIFF chunk
     MMCKINFO m_ckRiff;      // Use in opening a WAVE file
     DWORD m_dwSize;      // The size of the wave file
-    MMIOINFO m_mmioinfoOut;
+    WaveFileWriter m_writer; // Block writer used for WAVEFILE_WRITE
     DWORD m_dwFlags;
     BOOL m_bIsReadingFromMemory;
     BYTE* m_pbData;
@@ -49,7 +51,6 @@ public:
 
 protected:
     HRESULT ReadMMIO();
-    HRESULT WriteMMIO( WAVEFORMATEX* pwfxDest );
 
 public:
             CWaveFile();
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "MixKernels.h"
+
+// Size of the buffer makeFloatFormat() fills in: a WAVEFORMATEXTENSIBLE, the largest format it writes
+#define SAMPLE_FLOAT_FORMAT_BYTES 40
+
+/**
+ * @enum	SAMPLE_FORMAT
+ *
+ * @brief	The sample encodings the load-time converters understand. Anything else (ADPCM, 32 bit integer
+ * 			PCM...) is UNSUPPORTED and is played in its native format.
+ */
+enum SAMPLE_FORMAT
+{
+	SAMPLE_FORMAT_UNSUPPORTED,
+	SAMPLE_FORMAT_U8,       // 8 bit unsigned PCM, silence at 128
+	SAMPLE_FORMAT_S16,      // 16 bit signed PCM
+	SAMPLE_FORMAT_S24,      // 24 bit signed PCM, packed in 3 bytes
+	SAMPLE_FORMAT_F32       // 32 bit IEEE float, the engine format
+};
+
+/**
+ * @struct	SampleConverters
+ *
+ * @brief	The conversion loops for one instruction set, selected with the same MIX_KERNEL values as the
+ * 			mixer. Get one with getSampleConverters().
+ *
+ * 			The from* functions scale integer samples by a power of two into [-1, 1), so they are exact, and
+ * 			the to* functions clamp, scale and round to nearest. A sample converted to float and back is
+ * 			therefore always the sample it started as. NaNs convert to silence. Every kernel gives the same
+ * 			bytes as the scalar one. Input and output need no particular alignment. 16 bit output is the
+ * 			mixer's toPCM16().
+ */
+struct SampleConverters
+{
+	MIX_KERNEL kernel;
+	void (*fromU8)(const BYTE* pIn, FLOAT32* pOut, UINT32 count);
+	void (*fromS16)(const BYTE* pIn, FLOAT32* pOut, UINT32 count);
+	void (*fromS24)(const BYTE* pIn, FLOAT32* pOut, UINT32 count);
+	void (*toU8)(const FLOAT32* pIn, BYTE* pOut, UINT32 count);
+	void (*toS24)(const FLOAT32* pIn, BYTE* pOut, UINT32 count);
+};
+
+const SampleConverters* getSampleConverters(MIX_KERNEL kernel);
+
+SAMPLE_FORMAT getSampleFormat(const WAVEFORMATEX* pFormat);
+UINT32 getSampleBytes(SAMPLE_FORMAT format);
+UINT32 makeFloatFormat(const WAVEFORMATEX* pSource, BYTE* pFormat);
+
+void convertToFloat(SAMPLE_FORMAT format, const BYTE* pIn, FLOAT32* pOut, UINT32 count, MIX_KERNEL kernel);
+void convertToFloat(SAMPLE_FORMAT format, const BYTE* pIn, FLOAT32* pOut, UINT32 count);
+void convertFromFloat(SAMPLE_FORMAT format, const FLOAT32* pIn, BYTE* pOut, UINT32 count, MIX_KERNEL kernel);
+void convertFromFloat(SAMPLE_FORMAT format, const FLOAT32* pIn, BYTE* pOut, UINT32 count);
+
+/**
+// End of SampleConvert.h
+ */
@@ -14,17 +14,80 @@
 #include <d3dx9.h>
 #include <string>
 #include "SDKwavefile.h"
+#include "SoundHandles.h"
+#include "EmitterSoA.h"
+#include "SoundEvent.h"
+#include "CommandRing.h"
 
 #ifndef S_FAILED
 #define S_FAILED ((HRESULT)(-1L))
 #endif
 
-#ifndef INPUTCHANNELS
-#define INPUTCHANNELS 1  // number of source channels
-#endif
-
 using namespace std;
 
+class PcmAsset;
+
+/**
+ * @enum	SOUND_LOAD_STATE
+ *
+ * @brief	Where a sound is in loading. Sounds from createSound() are READY (or FAILED) when it returns, ones
+ * 			from BasicAudio::createSoundAsync() go through PENDING and LOADED first.
+ */
+enum SOUND_LOAD_STATE
+{
+	SOUND_LOAD_PENDING,     // queued for, or being loaded on, a worker thread
+	SOUND_LOAD_LOADED,      // the sample data is in, the voice is made on the next BasicAudio::run() or waitAll()
+	SOUND_LOAD_READY,       // can be played
+	SOUND_LOAD_FAILED       // the file could not be found or read, or the voice could not be made
+};
+
+/**
+ * @class	SoundEventCallback
+ *
+ * @brief	Voice callback shared by every sound of a BasicAudio. XAudio2 calls it on its own thread, where
+ * 			nothing may block, so it only pushes a SoundEvent into a lock-free ring that BasicAudio::run()
+ * 			drains. The sound is named by the handle stored in the buffer's pContext.
+ *
+ * @date	10/17/2026
+ */
+class SoundEventCallback : public IXAudio2VoiceCallback
+{
+public:
+	SoundEventCallback(CommandRing<SoundEvent>* pRing) : pEvents(pRing) {};
+
+	/**
+	 * @fn	bool SoundEventCallback::post(SOUND_EVENT type, SOUND_HANDLE handle, HRESULT error)
+	 *
+	 * @brief	Queues an event. Safe from any thread.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the ring was full and the event was dropped.
+	 */
+	bool post(SOUND_EVENT type, SOUND_HANDLE handle, HRESULT error = S_OK){
+		if(handle == SOUND_HANDLE_INVALID)
+			return false;
+		SoundEvent e;
+		e.type = type;
+		e.handle = handle;
+		e.error = error;
+		return pEvents->push(e);
+	};
+
+	STDMETHOD_( void, OnBufferEnd )( void* pBufferContext ){post(SOUND_EVENT_END, (SOUND_HANDLE)(UINT_PTR)pBufferContext);};
+	STDMETHOD_( void, OnLoopEnd )( void* pBufferContext ){post(SOUND_EVENT_LOOP_END, (SOUND_HANDLE)(UINT_PTR)pBufferContext);};
+	STDMETHOD_( void, OnVoiceError )( void* pBufferContext, HRESULT error ){
+		post(SOUND_EVENT_ERROR, (SOUND_HANDLE)(UINT_PTR)pBufferContext, error);
+	};
+	STDMETHOD_( void, OnVoiceProcessingPassStart )( UINT32 ){};
+	STDMETHOD_( void, OnVoiceProcessingPassEnd )(){};
+	STDMETHOD_( void, OnStreamEnd )(){};
+	STDMETHOD_( void, OnBufferStart )( void* ){};
+
+protected:
+	CommandRing<SoundEvent>* pEvents;
+};
+
 class SampleSound
 {
 public:
@@ -61,9 +124,20 @@ public:
 		initEmitter();
 
 		filename.clear();
+		handle = SOUND_HANDLE_INVALID;
+		pXaudio2 = NULL;
+		pSourceVoice = NULL;
+		pOutputVoice = NULL;
+		pEmitterStore = NULL;
+		emitterIndex = 0;
+		pEventCallback = NULL;
+		pCallback = NULL;
+		pCallbackContext = NULL;
+		isRunning = FALSE;
+		volume = 1.0f;
 	};
 
-	~SampleSound(){};
+	virtual ~SampleSound(){};
 
 	/**
 	 * @fn	virtual HRESULT SampleSound::initPCM( IXAudio2* pXaudio2, LPCWSTR szFilename,
@@ -128,6 +202,89 @@ public:
 	 */
 	virtual void destroy() = 0;
 
+	/**
+	 * @fn	virtual PcmAsset* SampleSound::getAsset()
+	 *
+	 * @brief	Gets the sample data of the sound, for playing extra instances of it through the voice pool.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	null if the sound does not keep its data in memory (e.g. a streaming sound).
+	 */
+	virtual PcmAsset* getAsset(){return NULL;};
+
+	/**
+	 * @fn	virtual SOUND_LOAD_STATE SampleSound::getLoadState()
+	 *
+	 * @brief	Tells if the sound can be played yet.
+	 *
+	 * @date	10/17/2026
+	 */
+	virtual SOUND_LOAD_STATE getLoadState(){return creationComplete ? SOUND_LOAD_READY : SOUND_LOAD_FAILED;};
+
+	/**
+	 * @fn	virtual void SampleSound::onEvent(const SoundEvent& e)
+	 *
+	 * @brief	Called by BasicAudio::run() for each event the voice queued through its SoundEventCallback.
+	 * 			Subclasses bring their own state up to date and then call notify().
+	 *
+	 * @date	10/17/2026
+	 */
+	virtual void onEvent(const SoundEvent& e){notify((SOUND_EVENT)e.type);};
+
+	/**
+	 * @fn	void SampleSound::setEventCallback(SoundEventCallback* pCallback)
+	 *
+	 * @brief	Sets the callback the source voice is made with. Must be called before initPCM(); without one the
+	 * 			sound reports nothing and only run() notices when it stops.
+	 *
+	 * @date	10/17/2026
+	 */
+	void setEventCallback(SoundEventCallback* pEventCb) {pEventCallback = pEventCb;};
+
+	/**
+	 * @fn	void SampleSound::setCallback(SOUND_CALLBACK callback, void* pContext)
+	 *
+	 * @brief	Sets a function to be told when this sound ends, loops or fails. NULL removes it.
+	 *
+	 * @date	10/17/2026
+	 */
+	void setCallback(SOUND_CALLBACK callback, void* pContext) {
+		pCallback = callback;
+		pCallbackContext = pContext;
+	};
+
+	bool isPlaying() {return isRunning != FALSE;};
+
+	/**
+	 * @fn	virtual bool SampleSound::isVirtual()
+	 *
+	 * @brief	Tells if the sound only borrows a voice from BasicAudio's VoiceVirtualizer while it is among the
+	 * 			most audible, rather than owning one. getSourceVoice() is NULL the rest of the time.
+	 *
+	 * @date	10/17/2026
+	 */
+	virtual bool isVirtual(){return false;};
+
+	/**
+	 * @fn	void SampleSound::setVolume(FLOAT32 volume)
+	 *
+	 * @brief	Sets the volume of the sound, which is also what the voice virtualizer weighs its distance by.
+	 * 			A virtual sound's voice is given the volume by the virtualizer on its next run().
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	volume	Amplitude multiplier, as in IXAudio2Voice::SetVolume().
+	 */
+	void setVolume(FLOAT32 volume) {
+		this->volume = volume;
+		if(pEmitterStore != NULL)
+			pEmitterStore->gain[emitterIndex] = volume;
+		if(pSourceVoice != NULL && !isVirtual())
+			pSourceVoice->SetVolume(volume);
+	};
+	FLOAT32 getVolume() {return volume;};
+
 	/**
 	 * @fn	void SampleSound::setFileName(LPCWSTR wstr)
 	 *
@@ -172,6 +329,18 @@ public:
 		return NULL;
 	}
 
+	/**
+	 * @fn	SOUND_HANDLE SampleSound::getHandle()
+	 *
+	 * @brief	Gets the handle BasicAudio registered this sound under.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @return	The handle, or SOUND_HANDLE_INVALID if the sound has not been registered.
+	 */
+	SOUND_HANDLE getHandle() {return handle;};
+	void setHandle(SOUND_HANDLE h) {handle = h;};
+
 	LPCWSTR getName() {
 		if(name.length() > 0){
 			return name.c_str();
@@ -199,6 +368,33 @@ public:
 	 */
 	IXAudio2SourceVoice* getSourceVoice() {return pSourceVoice;}
 
+	/**
+	 * @fn	HRESULT SampleSound::setOutputVoice(IXAudio2Voice* pOutput)
+	 *
+	 * @brief	Sends the sound to a submix voice (a bus, see BasicAudio::createBus()) instead of the mastering
+	 * 			voice. Set before the voice is made and it is created with the send; set afterwards and the live
+	 * 			voice is rerouted, which resets its output matrix, so the 3D output is sent again.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	pOutput	The submix voice, or NULL for the mastering voice.
+	 *
+	 * @return	S_OK, or the error from SetOutputVoices().
+	 */
+	HRESULT setOutputVoice(IXAudio2Voice* pOutput) {
+		if(pSourceVoice != NULL && pOutput != pOutputVoice){
+			XAUDIO2_SEND_DESCRIPTOR send = {0, pOutput};
+			XAUDIO2_VOICE_SENDS sends = {1, &send};
+			HRESULT hr = pSourceVoice->SetOutputVoices(pOutput != NULL ? &sends : NULL);
+			if(FAILED(hr))
+				return hr;
+			invalidate3D();
+		}
+		pOutputVoice = pOutput;
+		return S_OK;
+	};
+	IXAudio2Voice* getOutputVoice() {return pOutputVoice;};
+
 	/**
 	 * @fn	X3DAUDIO_EMITTER* SampleSound::getEmitter()
 	 *
@@ -210,9 +406,170 @@ public:
 	 * @author	Phil
 	 * @date	6/7/2013
 	 *
+	 * 			If the emitter lives in an EmitterSoA, its vectors are copied back into the structure first.
+	 *
 	 * @return	null if it fails, else the emitter.
 	 */
-	X3DAUDIO_EMITTER* getEmitter() {return &emitter;};
+	X3DAUDIO_EMITTER* getEmitter() {
+		if(pEmitterStore != NULL){
+			UINT32 i = emitterIndex;
+			emitter.Position = D3DXVECTOR3( pEmitterStore->posX[i], pEmitterStore->posY[i], pEmitterStore->posZ[i] );
+			emitter.Velocity = D3DXVECTOR3( pEmitterStore->velX[i], pEmitterStore->velY[i], pEmitterStore->velZ[i] );
+			emitter.OrientFront = D3DXVECTOR3( pEmitterStore->frontX[i], pEmitterStore->frontY[i], pEmitterStore->frontZ[i] );
+			emitter.OrientTop = D3DXVECTOR3( pEmitterStore->topX[i], pEmitterStore->topY[i], pEmitterStore->topZ[i] );
+		}
+		return &emitter;
+	};
+
+	/**
+	 * @fn	const X3DAUDIO_EMITTER* SampleSound::getEmitterTemplate()
+	 *
+	 * @brief	Gets the emitter without bringing its vectors up to date from the store. For callers that take
+	 * 			the vectors from the store themselves and only need the curves, cone and channel layout.
+	 *
+	 * @date	10/17/2026
+	 */
+	const X3DAUDIO_EMITTER* getEmitterTemplate() {return &emitter;};
+
+	/**
+	 * @fn	void SampleSound::attachEmitterStore(EmitterSoA* pStore, UINT32 index)
+	 *
+	 * @brief	Moves the emitter's position, velocity, orientation and scalers into slot index of an
+	 * 			EmitterSoA. From then on the emitter getters and setters go through the store, which is what
+	 * 			BasicAudio::update3D() reads. The curves, cone and channel layout stay in the X3DAUDIO_EMITTER.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	pStore	The store, or NULL to keep the emitter in this object.
+	 * @param	index		  	Slot of this sound's emitter in the store.
+	 */
+	void attachEmitterStore(EmitterSoA* pStore, UINT32 index) {
+		getEmitter(); // bring the structure up to date if we are moving between stores
+		pEmitterStore = pStore;
+		emitterIndex = index;
+		if(pStore == NULL)
+			return;
+		pStore->posX[index] = emitter.Position.x;
+		pStore->posY[index] = emitter.Position.y;
+		pStore->posZ[index] = emitter.Position.z;
+		pStore->velX[index] = emitter.Velocity.x;
+		pStore->velY[index] = emitter.Velocity.y;
+		pStore->velZ[index] = emitter.Velocity.z;
+		pStore->frontX[index] = emitter.OrientFront.x;
+		pStore->frontY[index] = emitter.OrientFront.y;
+		pStore->frontZ[index] = emitter.OrientFront.z;
+		pStore->topX[index] = emitter.OrientTop.x;
+		pStore->topY[index] = emitter.OrientTop.y;
+		pStore->topZ[index] = emitter.OrientTop.z;
+		pStore->curveDistanceScaler[index] = emitter.CurveDistanceScaler;
+		pStore->dopplerScaler[index] = emitter.DopplerScaler;
+		pStore->innerRadius[index] = emitter.InnerRadius;
+		pStore->innerRadiusAngle[index] = emitter.InnerRadiusAngle;
+		pStore->gain[index] = volume;
+		pStore->setChannels(index, emitter.ChannelCount, emitter.ChannelRadius, emitter.pChannelAzimuths);
+	};
+
+	/**
+	 * @fn	void SampleSound::setEmitterChannels(UINT32 count, const FLOAT32* pAzimuths, FLOAT32 radius)
+	 *
+	 * @brief	Sets the emitter's channel layout: how many source channels it has and where they sit around it,
+	 * 			as X3DAUDIO_EMITTER's ChannelCount, pChannelAzimuths and ChannelRadius. Sounds set this to the
+	 * 			channel count of their data when their voice is made, with getDefaultAzimuth()'s layout, so
+	 * 			this is only needed for a different layout; call it once the sound is loaded.
+	 *
+	 * @date	10/17/2026
+	 *
+	 * @param	count	 	Source channels, 1 to EMITTER_MAX_CHANNELS. Must match the voice.
+	 * @param	pAzimuths	count azimuths in radians, clockwise from the emitter's front, with X3DAUDIO_2PI
+	 * 						for an LFE channel, or NULL for the default layout.
+	 * @param	radius   	Distance of the channels from the emitter's position, in world units.
+	 */
+	void setEmitterChannels(UINT32 count, const FLOAT32* pAzimuths = NULL, FLOAT32 radius = 1.0f) {
+		if(count < 1)
+			count = 1;
+		if(count > EMITTER_MAX_CHANNELS)
+			count = EMITTER_MAX_CHANNELS;
+		for(UINT32 c = 0; c < count; ++c)
+			g_emitterAzimuths[c] = (pAzimuths != NULL) ? pAzimuths[c] : getDefaultAzimuth(count, c);
+		emitter.ChannelCount = count;
+		emitter.ChannelRadius = radius;
+		emitter.pChannelAzimuths = g_emitterAzimuths;
+		if(pEmitterStore != NULL)
+			pEmitterStore->setChannels(emitterIndex, count, radius, g_emitterAzimuths);
+	};
+	UINT32 getEmitterChannels() {return emitter.ChannelCount;};
+
+	/**
+	 * @fn	static FLOAT32 SampleSound::getDefaultAzimuth(UINT32 count, UINT32 channel)
+	 *
+	 * @brief	Where a channel of a sound with count channels is put by default, for the WAVE channel orders:
+	 * 			stereo and quad at the corners 45 degrees either side of the front and back, 5.1 and 7.1 as
+	 * 			their speakers are, with the LFE at X3DAUDIO_2PI. Other counts are spread evenly around the
+	 * 			emitter, starting at its front.
+	 *
+	 * @date	10/17/2026
+	 */
+	static FLOAT32 getDefaultAzimuth(UINT32 count, UINT32 channel) {
+		static const FLOAT32 surround[8] = {
+			7.0f * X3DAUDIO_PI / 4.0f,  // front left
+			X3DAUDIO_PI / 4.0f,         // front right
+			0.0f,                       // front center
+			X3DAUDIO_2PI,               // LFE
+			5.0f * X3DAUDIO_PI / 4.0f,  // back left
+			3.0f * X3DAUDIO_PI / 4.0f,  // back right
+			3.0f * X3DAUDIO_PI / 2.0f,  // side left
+			X3DAUDIO_PI / 2.0f          // side right
+		};
+		switch(count){
+			case 1:
+				return 0.0f;
+			case 2:
+			case 6:
+			case 8:
+				return surround[channel];
+			case 4:
+				return surround[channel < 2 ? channel : channel + 2];
+			default:
+				return X3DAUDIO_2PI * channel / count;
+		}
+	};
+
+	void setEmitterIndex(UINT32 index) {emitterIndex = index;};
+	UINT32 getEmitterIndex() {return emitterIndex;};
+
+	/**
+	 * @fn	void SampleSound::setSpatialized(bool enable)
+	 *
+	 * @brief	Includes or excludes this sound from BasicAudio::update3D(). Has no effect until the sound has
+	 * 			been created by a BasicAudio.
+	 *
+	 * @date	10/17/2026
+	 */
+	void setSpatialized(bool enable) {
+		if(pEmitterStore == NULL)
+			return;
+		if(enable && !pEmitterStore->spatialized[emitterIndex])
+			pEmitterStore->markDirty(emitterIndex, EmitterSoA::EMITTER_DIRTY_INPUT | EmitterSoA::EMITTER_DIRTY_OUTPUT);
+		pEmitterStore->spatialized[emitterIndex] = enable ? 1 : 0;
+	};
+	bool isSpatialized() {return pEmitterStore != NULL && pEmitterStore->spatialized[emitterIndex] != 0;};
+
+	/**
+	 * @fn	void SampleSound::invalidate3D()
+	 *
+	 * @brief	Makes the next update3D() or play3DVoice() recompute this sound's output and send it to the voice
+	 * 			even if nothing seems to have changed. Needed when the voice is new, when its matrix has been set
+	 * 			some other way (playOnChannelVoice() and friends), or when the emitter has been changed directly
+	 * 			through getEmitter() rather than the setters.
+	 *
+	 * @date	10/17/2026
+	 */
+	void invalidate3D() {
+		if(pEmitterStore != NULL)
+			pEmitterStore->markDirty(emitterIndex, EmitterSoA::EMITTER_DIRTY_INPUT | EmitterSoA::EMITTER_DIRTY_OUTPUT);
+	};
+
+	EmitterSoA* getEmitterStore() {return pEmitterStore;};
 
 	/**
 	 * @fn	FLOAT32 SampleSound::getEmitterX()
@@ -224,7 +581,7 @@ public:
 	 *
 	 * @return	The emitter x coordinate.
 	 */
-	FLOAT32 getEmitterX(){return emitter.Position.x;};
+	FLOAT32 getEmitterX(){return pEmitterStore ? pEmitterStore->posX[emitterIndex] : emitter.Position.x;};
 
 	/**
 	 * @fn	FLOAT32 SampleSound::getEmitterY()
@@ -236,7 +593,7 @@ public:
 	 *
 	 * @return	The emitter y coordinate.
 	 */
-	FLOAT32 getEmitterY(){return emitter.Position.y;};
+	FLOAT32 getEmitterY(){return pEmitterStore ? pEmitterStore->posY[emitterIndex] : emitter.Position.y;};
 
 	/**
 	 * @fn	FLOAT32 SampleSound::getEmitterZ()
@@ -248,7 +605,7 @@ public:
 	 *
 	 * @return	The emitter z coordinate.
 	 */
-	FLOAT32 getEmitterZ(){return emitter.Position.z;};
+	FLOAT32 getEmitterZ(){return pEmitterStore ? pEmitterStore->posZ[emitterIndex] : emitter.Position.z;};
 
 	/**
 	 * @fn	void SampleSound::setEmitterX(FLOAT32 x)
@@ -260,7 +617,7 @@ public:
 	 *
 	 * @param	x	The FLOAT32 to process.
 	 */
-	void setEmitterX(FLOAT32 x) {emitter.Position.x = x;};
+	void setEmitterX(FLOAT32 x) {setEmitterField(pEmitterStore ? &pEmitterStore->posX[emitterIndex] : &emitter.Position.x, x);};
 
 	/**
 	 * @fn	void SampleSound::setEmitterY(FLOAT32 y)
@@ -272,7 +629,7 @@ public:
 	 *
 	 * @param	y	The FLOAT32 to process.
 	 */
-	void setEmitterY(FLOAT32 y) {emitter.Position.y = y;};
+	void setEmitterY(FLOAT32 y) {setEmitterField(pEmitterStore ? &pEmitterStore->posY[emitterIndex] : &emitter.Position.y, y);};
 
 	/**
 	 * @fn	void SampleSound::setEmitterZ(FLOAT32 z)
@@ -284,7 +641,7 @@ public:
 	 *
 	 * @param	z	The FLOAT32 to process.
 	 */
-	void setEmitterZ(FLOAT32 z) {emitter.Position.z = z;};
+	void setEmitterZ(FLOAT32 z) {setEmitterField(pEmitterStore ? &pEmitterStore->posZ[emitterIndex] : &emitter.Position.z, z);};
 
 	/**
 	 * @fn	void SampleSound::setEmitterPos(FLOAT32 x, FLOAT32 y, FLOAT32 z)
@@ -299,9 +656,9 @@ public:
 	 * @param	z	The emitter z coordinate.
 	 */
 	void setEmitterPos(FLOAT32 x, FLOAT32 y, FLOAT32 z){
-		emitter.Position.x = x; 
-		emitter.Position.y = y;
-		emitter.Position.z = z;
+		setEmitterX(x);
+		setEmitterY(y);
+		setEmitterZ(z);
 	};
 
 	/**
@@ -314,7 +671,7 @@ public:
 	 *
 	 * @return	The emitter x velocity.
 	 */
-	FLOAT32 getEmitterVX(){return emitter.Velocity.x;};
+	FLOAT32 getEmitterVX(){return pEmitterStore ? pEmitterStore->velX[emitterIndex] : emitter.Velocity.x;};
 
 	/**
 	 * @fn	FLOAT32 SampleSound::getEmitterVY()
@@ -326,7 +683,7 @@ public:
 	 *
 	 * @return	The emitter y velocity.
 	 */
-	FLOAT32 getEmitterVY(){return emitter.Velocity.y;};
+	FLOAT32 getEmitterVY(){return pEmitterStore ? pEmitterStore->velY[emitterIndex] : emitter.Velocity.y;};
 
 	/**
 	 * @fn	FLOAT32 SampleSound::getEmitterVZ()
@@ -338,7 +695,7 @@ public:
 	 *
 	 * @return	The emitter z velocity.
 	 */
-	FLOAT32 getEmitterVZ(){return emitter.Velocity.z;};
+	FLOAT32 getEmitterVZ(){return pEmitterStore ? pEmitterStore->velZ[emitterIndex] : emitter.Velocity.z;};
 
 	/**
 	 * @fn	void SampleSound::setEmitterVX(FLOAT32 x)
@@ -350,7 +707,7 @@ public:
 	 *
 	 * @param	x	The emitter x velocity.
 	 */
-	void setEmitterVX(FLOAT32 x) {emitter.Velocity.x = x;};
+	void setEmitterVX(FLOAT32 x) {setEmitterField(pEmitterStore ? &pEmitterStore->velX[emitterIndex] : &emitter.Velocity.x, x);};
 
 	/**
 	 * @fn	void SampleSound::setEmitterVY(FLOAT32 y)
@@ -362,7 +719,7 @@ public:
 	 *
 	 * @param	y	The emitter y velocity.
 	 */
-	void setEmitterVY(FLOAT32 y) {emitter.Velocity.y = y;};
+	void setEmitterVY(FLOAT32 y) {setEmitterField(pEmitterStore ? &pEmitterStore->velY[emitterIndex] : &emitter.Velocity.y, y);};
 
 	/**
 	 * @fn	void SampleSound::setEmitterVZ(FLOAT32 z)
@@ -374,7 +731,7 @@ public:
 	 *
 	 * @param	z	The emitter z velocity.
 	 */
-	void setEmitterVZ(FLOAT32 z) {emitter.Velocity.z = z;};
+	void setEmitterVZ(FLOAT32 z) {setEmitterField(pEmitterStore ? &pEmitterStore->velZ[emitterIndex] : &emitter.Velocity.z, z);};
 
 	/**
 	 * @fn	void SampleSound::setEmitterVelocity(FLOAT32 x, FLOAT32 y, FLOAT32 z)
@@ -389,9 +746,9 @@ public:
 	 * @param	z	The emitter z velocity.
 	 */
 	void setEmitterVelocity(FLOAT32 x, FLOAT32 y, FLOAT32 z){
-		emitter.Velocity.x = x; 
-		emitter.Velocity.y = y;
-		emitter.Velocity.z = z;
+		setEmitterVX(x);
+		setEmitterVY(y);
+		setEmitterVZ(z);
 	};
 
 	
@@ -401,20 +758,57 @@ protected:
 	string cFilename;
 	wstring name;
 	string cName;
+	SOUND_HANDLE handle;
 	IXAudio2* pXaudio2;
 	IXAudio2SourceVoice* pSourceVoice;
+	IXAudio2Voice* pOutputVoice;    // the submix the voice sends to, NULL for the mastering voice
 	XAUDIO2_BUFFER buffer;
 	bool creationComplete;
 	BOOL isRunning;
+	FLOAT32 volume;                 // see setVolume()
 
 	// 3D variables
 	D3DXVECTOR3 g_vEmitterPos;
-	FLOAT32 g_emitterAzimuths[INPUTCHANNELS];
+	FLOAT32 g_emitterAzimuths[EMITTER_MAX_CHANNELS];
 	X3DAUDIO_EMITTER emitter;
+	EmitterSoA* pEmitterStore;  // if set, the emitter vectors live in here
+	UINT32 emitterIndex;
 
 	X3DAUDIO_DISTANCE_CURVE_POINT Emitter_Reverb_CurvePoints[3];
 	X3DAUDIO_DISTANCE_CURVE       Emitter_Reverb_Curve;
 
+	/**
+	 * @fn	void SampleSound::setEmitterField(FLOAT32* pField, FLOAT32 value)
+	 *
+	 * @brief	Sets one emitter value, marking the emitter dirty in its store if the value really changed.
+	 *
+	 * @date	10/17/2026
+	 */
+	void setEmitterField(FLOAT32* pField, FLOAT32 value){
+		if(*pField == value)
+			return;
+		*pField = value;
+		if(pEmitterStore != NULL)
+			pEmitterStore->markDirty(emitterIndex, EmitterSoA::EMITTER_DIRTY_INPUT);
+	};
+
+	// completion events
+	SoundEventCallback* pEventCallback;
+	SOUND_CALLBACK pCallback;
+	void* pCallbackContext;
+
+	/**
+	 * @fn	void SampleSound::notify(SOUND_EVENT event)
+	 *
+	 * @brief	Passes an event on to the callback set with setCallback(), if any.
+	 *
+	 * @date	10/17/2026
+	 */
+	void notify(SOUND_EVENT event){
+		if(pCallback != NULL)
+			pCallback(handle, event, pCallbackContext);
+	};
+
 	/**
 	 * @fn	virtual HRESULT SampleSound::FindMediaFileCch( WCHAR* strDestPath, int cchDest,
 	 * 		LPCWSTR strFilename ) = 0;
@@ -451,6 +845,7 @@ protected:
 		emitter.OrientTop = D3DXVECTOR3( 0, 1, 0 );
 		emitter.ChannelCount = 1;
 		emitter.ChannelRadius = 1.0f;
+		memset(g_emitterAzimuths, 0, sizeof(g_emitterAzimuths));
 		emitter.pChannelAzimuths = g_emitterAzimuths;
 
 		// Use of Inner radius allows for smoother transitions as
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "MixKernels.h"
+#include "Resampler.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+
+#define MIXER_MAX_CHANNELS		8
+#define MIXER_LOOP_INFINITE		255     // same as XAUDIO2_LOOP_INFINITE
+#define MIXER_END_OF_STREAM		0x0040  // same as XAUDIO2_END_OF_STREAM
+#define MIXER_MAX_QUEUED_BUFFERS 64     // same as XAUDIO2_MAX_QUEUED_BUFFERS
+#define MIXER_MIN_FREQ_RATIO	(1.0f / 1024.0f)
+
+using namespace std;
+
+/**
+ * @struct	MixerBuffer
+ *
+ * @brief	A buffer of source data, with the same fields and meaning as XAUDIO2_BUFFER.
+ */
+struct MixerBuffer
+{
+	UINT32 flags;           // 0 or MIXER_END_OF_STREAM
+	UINT32 audioBytes;
+	const BYTE* pAudioData; // not copied, must stay valid until onBufferEnd()
+	UINT32 playBegin;       // first frame to play
+	UINT32 playLength;      // frames to play, 0 for the whole buffer
+	UINT32 loopBegin;       // first frame of the loop region
+	UINT32 loopLength;      // frames in the loop region, 0 to loop to the end of the play region
+	UINT32 loopCount;       // times to repeat the loop region, MIXER_LOOP_INFINITE forever
+	void* pContext;         // handed back in the callbacks
+};
+
+/**
+ * @class	MixerVoiceCallback
+ *
+ * @brief	Notifications from a MixerVoice, the same set as IXAudio2VoiceCallback. They are made on the thread
+ * 			that calls SoftwareMixer::render(), with the mixer locked, so they may submit buffers but must not
+ * 			destroy voices.
+ */
+class MixerVoiceCallback
+{
+public:
+	virtual ~MixerVoiceCallback(){};
+	virtual void onProcessingPassStart(UINT32 /*bytesRequired*/){};
+	virtual void onProcessingPassEnd(){};
+	virtual void onBufferStart(void* /*pContext*/){};
+	virtual void onBufferEnd(void* /*pContext*/){};
+	virtual void onLoopEnd(void* /*pContext*/){};
+	virtual void onStreamEnd(){};
+	virtual void onVoiceError(void* /*pContext*/, HRESULT /*error*/){};
+};
+
+class SoftwareMixer;
+class MixerBus;
+
+/**
+ * @class	MixerVoice
+ *
+ * @brief	A source voice of the SoftwareMixer. Plays queued MixerBuffers of PCM (8, 16, 24 or 32 bit integer)
+ * 			or 32 bit float data with XAudio2 semantics for starting, stopping, looping, flushing, frequency
+ * 			ratio, volume and output matrix. Made and destroyed through the mixer.
+ *
+ * @date	10/17/2026
+ */
+class MixerVoice
+{
+public:
+	HRESULT start();
+	void stop();
+	HRESULT submitBuffer(const MixerBuffer* pBuffer);
+	void flushBuffers();
+	void discontinuity();
+	void exitLoop();
+	void getState(void** ppCurrentContext, UINT32* pBuffersQueued, UINT64* pSamplesPlayed);
+
+	HRESULT setFrequencyRatio(FLOAT32 ratio);
+	FLOAT32 getFrequencyRatio(){return frequencyRatio;};
+	HRESULT setSourceSampleRate(UINT32 sampleRate);
+	void setVolume(FLOAT32 volume);
+	FLOAT32 getVolume(){return volume;};
+	HRESULT setChannelVolumes(UINT32 channels, const FLOAT32* pVolumes);
+	void getChannelVolumes(UINT32 channels, FLOAT32* pVolumes);
+	HRESULT setOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, const FLOAT32* pLevels);
+	void getOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, FLOAT32* pLevels);
+	HRESULT setOutput(MixerBus* pBus);
+	MixerBus* getOutput(){return pOutput;};
+	UINT32 getOutputChannels();
+
+	const WAVEFORMATEX* getFormat(){return &format;};
+	UINT32 getChannels(){return format.nChannels;};
+	UINT32 getSourceSampleRate(){return sourceSampleRate;};
+	bool isRunning(){return running;};
+
+protected:
+	friend class SoftwareMixer;
+
+	typedef void (*READ_FRAME)(const BYTE* pFrame, UINT32 channels, FLOAT32* pOut);
+
+	MixerVoice(SoftwareMixer* pMixer, const WAVEFORMATEX* pFormat, READ_FRAME readFrame, FLOAT32 maxFrequencyRatio, MixerVoiceCallback* pCallback);
+	~MixerVoice(void);
+
+	SoftwareMixer* pMixer;
+	WAVEFORMATEX format;
+	READ_FRAME readFrame;
+	MixerVoiceCallback* pCallback;
+	FLOAT32 maxFrequencyRatio;
+	FLOAT32 frequencyRatio;
+	UINT32 sourceSampleRate;
+	MixerBus* pOutput;      // the bus the voice mixes into, NULL for the mixer's output
+
+	bool running;
+	deque<MixerBuffer> queue;
+	bool bufferStarted;     // the front buffer has had onBufferStart()
+	UINT32 position;        // next frame to read from the front buffer
+	UINT32 loopsDone;
+	bool loopExited;
+	UINT64 samplesPlayed;
+	Resampler resampler;
+	double lastStep;        // the step the last block ended on, 0 before the first block
+	FLOAT32 lastVolume;     // the volume the last block ended on, negative before the first block of a stream
+
+	FLOAT32 volume;
+	FLOAT32 channelVolumes[MIXER_MAX_CHANNELS];
+	FLOAT32 matrix[MIXER_MAX_CHANNELS * MIXER_MAX_CHANNELS];   // [src * D + S] as in XAudio2
+
+	UINT32 readSource(FLOAT32* pDst, UINT32 frames, bool* pEndOfStream);
+	void render(FLOAT32* pOut, UINT32 frames, UINT32 engineSampleRate);
+	void mixInto(const FLOAT32* pIn, FLOAT32* pOut, UINT32 frames, UINT32 dstChannels, FLOAT32 gain);
+	void setDefaultMatrix(UINT32 dstChannels);
+};
+
+/**
+ * @class	MixerBus
+ *
+ * @brief	A submix bus of the SoftwareMixer, as an XAudio2 submix voice is: voices and other buses mix into
+ * 			it, and the sum is passed on through its volume and output matrix to the bus it sends to, or to the
+ * 			mixer's output. A group of voices can so be faded or rerouted with one call on their bus instead
+ * 			of one per voice. Buses are mixed in order of their stage, lowest first, and can only send to a
+ * 			bus of a higher stage, so a bus has all of its inputs before it is passed on. A bus nothing was
+ * 			mixed into this block costs nothing. Made and destroyed through the mixer.
+ *
+ * @date	10/17/2026
+ */
+class MixerBus
+{
+public:
+	HRESULT setOutput(MixerBus* pBus);
+	MixerBus* getOutput(){return pOutput;};
+	UINT32 getOutputChannels();
+	void setVolume(FLOAT32 volume);
+	FLOAT32 getVolume(){return volume;};
+	HRESULT setOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, const FLOAT32* pLevels);
+	void getOutputMatrix(UINT32 srcChannels, UINT32 dstChannels, FLOAT32* pLevels);
+	UINT32 getChannels(){return channels;};
+	UINT32 getStage(){return stage;};
+
+protected:
+	friend class SoftwareMixer;
+	friend class MixerVoice;
+
+	MixerBus(SoftwareMixer* pMixer, UINT32 channels, UINT32 stage);
+
+	SoftwareMixer* pMixer;
+	UINT32 channels;
+	UINT32 stage;
+	MixerBus* pOutput;      // NULL for the mixer's output
+	FLOAT32 volume;
+	FLOAT32 matrix[MIXER_MAX_CHANNELS * MIXER_MAX_CHANNELS];   // [channels * D + S] as in XAudio2
+	vector<FLOAT32> buffer; // this block's mix, only valid while active
+	bool active;            // something has been mixed in this block
+
+	void mixInto(FLOAT32* pOut, UINT32 frames);
+};
+
+/**
+ * @class	SoftwareMixer
+ *
+ * @brief	Mixes any number of MixerVoices to an interleaved float output, as fast as it is asked to. This is
+ * 			what the offline engine runs on, and as it has no XAudio2 dependency it can also be driven headless
+ * 			for tests and benchmarks. Sample rate conversion, pitch and Doppler are done by a polyphase Resampler
+ * 			per voice, 8 taps unless setResamplerQuality() says otherwise. Voices are accumulated in float into
+ * 			the output bus with SSE2 or AVX2 kernels picked at run time (see MixKernels.h), one matrix row at a
+ * 			time. Voices can be grouped on MixerBuses. Thread safe: voices and buses may be controlled from any
+ * 			thread while another renders.
+ *
+ * 			SoftwareMixer mixer;
+ * 			mixer.init(48000, 2);
+ * 			mixer.createVoice(&wfx, 2.0f, NULL, &pVoice);
+ * 			pVoice->submitBuffer(&buffer);
+ * 			pVoice->start();
+ * 			mixer.render(pOut, mixer.getQuantumFrames());
+ *
+ * @date	10/17/2026
+ */
+class SoftwareMixer
+{
+public:
+	SoftwareMixer(void);
+	~SoftwareMixer(void);
+
+	HRESULT init(UINT32 sampleRate, UINT32 channels);
+	HRESULT createVoice(const WAVEFORMATEX* pFormat, FLOAT32 maxFrequencyRatio, MixerVoiceCallback* pCallback, MixerVoice** ppVoice);
+	void destroyVoice(MixerVoice* pVoice);
+	HRESULT createBus(UINT32 channels, UINT32 stage, MixerBus** ppBus);
+	void destroyBus(MixerBus* pBus);
+
+	void render(FLOAT32* pOut, UINT32 frames);
+
+	bool setKernel(MIX_KERNEL kernel);
+	MIX_KERNEL getKernel(){return pKernels->kernel;};
+	void setResamplerQuality(RESAMPLER_QUALITY quality){resamplerQuality = quality;};
+	RESAMPLER_QUALITY getResamplerQuality(){return resamplerQuality;};
+	void setMasterVolume(FLOAT32 volume){masterVolume = volume;};
+	FLOAT32 getMasterVolume(){return masterVolume;};
+	UINT32 getSampleRate(){return sampleRate;};
+	UINT32 getChannels(){return channels;};
+	UINT32 getQuantumFrames(){return sampleRate / 100;}; // 10ms, the XAudio2 processing quantum
+	UINT32 getVoiceCount();
+	UINT32 getActiveVoiceCount();
+	UINT32 getBusCount();
+
+	static void toPCM16(const FLOAT32* pIn, INT16* pOut, UINT32 samples);
+	static WORD getFormatTag(const WAVEFORMATEX* pFormat);
+
+protected:
+	friend class MixerVoice;
+	friend class MixerBus;
+
+	UINT32 sampleRate;
+	UINT32 channels;
+	FLOAT32 masterVolume;
+	const MixKernels* pKernels;
+	RESAMPLER_QUALITY resamplerQuality; // for voices created from now on
+	vector<MixerVoice*> voices;
+	vector<MixerBus*> buses;        // in stage order, the order they are mixed in
+	vector<FLOAT32> scratch;        // a voice's resampled output
+	vector<FLOAT32> sourceScratch;  // a voice's source frames
+	recursive_mutex lock;   // recursive so callbacks made while rendering can submit buffers
+
+	FLOAT32* getTarget(MixerBus* pBus, FLOAT32* pOut, UINT32 frames);
+};
+
+/**
+// End of SoftwareMixer.h
+ */
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "MappedFile.h"
+#include "PcmAssetCache.h"
+#include <string>
+#include <vector>
+#include <atomic>
+
+using namespace std;
+
+#define SOUND_BANK_MAGIC		"DXSB"
+#define SOUND_BANK_VERSION		2       // 2 added SoundBankEntry::factFrames
+#define SOUND_BANK_ALIGNMENT	4096    // every sound's data starts on a page boundary
+
+/**
+ * @struct	SoundBankHeader
+ *
+ * @brief	The start of a sound bank file. The entries follow it directly, then the names and the formats,
+ * 			all inside the first indexBytes of the file, then the sample data. All values are little endian.
+ */
+#pragma pack(push, 1)
+struct SoundBankHeader
+{
+	char magic[4];          // SOUND_BANK_MAGIC
+	UINT32 version;         // SOUND_BANK_VERSION
+	UINT32 entryCount;
+	UINT32 indexBytes;      // header, entries, names and formats; the data starts at or after this
+	UINT64 fileBytes;       // for spotting a truncated file
+	UINT32 reserved[2];
+};
+
+/**
+ * @struct	SoundBankEntry
+ *
+ * @brief	Where one sound is in the bank. Entries are sorted by nameHash, then by name, so find() is a
+ * 			binary search. Offsets are from the start of the file.
+ */
+struct SoundBankEntry
+{
+	UINT64 nameHash;        // SoundBank::hashName() of the name
+	UINT64 dataOffset;      // a multiple of SOUND_BANK_ALIGNMENT
+	UINT32 dataBytes;
+	UINT32 nameOffset;      // the name, normalized as by SoundBank::normalizeName() and null terminated
+	UINT32 formatOffset;    // a WAVEFORMATEX and its cbSize extra bytes, 4 byte aligned
+	WORD nameBytes;       // not counting the terminator
+	WORD formatBytes;
+	UINT32 factFrames;      // the frame count from the sound's 'fact' chunk, 0 if it had none
+	UINT32 reserved;        // keeps the entries 8 byte aligned
+};
+#pragma pack(pop)
+
+/**
+ * @struct	SoundBankSource
+ *
+ * @brief	One sound to be written by writeSoundBank().
+ */
+struct SoundBankSource
+{
+	string name;
+	const WAVEFORMATEX* pFormat; // followed by its cbSize extra bytes
+	const BYTE* pData;
+	UINT32 dataBytes;
+	UINT32 factFrames;      // from the 'fact' chunk, 0 if none (ADPCM uses it to drop the last block's padding)
+};
+
+/**
+ * @class	SoundBank
+ *
+ * @brief	Many sounds packed in one file, with the index at the front. Opening a bank maps the file and
+ * 			checks the header, and finding a sound is a binary search of the index on the hash of its name,
+ * 			so a few hundred sounds cost one open instead of a few hundred opens, directory searches and RIFF
+ * 			walks. The sample data is only read as assets are made from it.
+ *
+ * 			Names are file names as the game passes them to BasicAudio::createSound(), compared without
+ * 			regard to case or to the kind of slash, so "Wavs\\heli.wav" finds "wavs/heli.wav". Banks are
+ * 			built by the SoundBankBuilder tool, or by writeSoundBank().
+ *
+ * 			Reference counted like PcmAsset: every asset made from the bank holds a reference, so the
+ * 			mapping outlives anything playing from it.
+ *
+ * @date	10/17/2026
+ */
+class SoundBank
+{
+public:
+	static HRESULT open(const PATH_CHAR* szPath, SoundBank** ppBank);
+
+	ULONG AddRef();
+	ULONG Release();
+
+	INT32 find(const char* szName);
+#ifdef _WIN32
+	INT32 find(const wchar_t* szName);
+#endif
+	UINT32 getCount(){return pHeader->entryCount;};
+	const SoundBankEntry* getEntry(UINT32 index){return &pEntries[index];};
+	const char* getName(UINT32 index){return (const char*)(pBase + pEntries[index].nameOffset);};
+	const WAVEFORMATEX* getFormat(UINT32 index){return (const WAVEFORMATEX*)(pBase + pEntries[index].formatOffset);};
+	const BYTE* getData(UINT32 index){return pBase + pEntries[index].dataOffset;};
+	DWORD getSize(UINT32 index){return pEntries[index].dataBytes;};
+	DWORD getFactFrames(UINT32 index){return pEntries[index].factFrames;};
+	const PATH_STRING& getPath(){return path;};
+
+	static string normalizeName(const char* szName);
+	static UINT64 hashName(const string& normalized);
+
+protected:
+	SoundBank(void);
+	~SoundBank(void);
+
+	HRESULT validate();
+
+	MappedFile file;
+	const BYTE* pBase;
+	const SoundBankHeader* pHeader;
+	const SoundBankEntry* pEntries;
+	PATH_STRING path;       // canonical, as PcmAssetCache keys it
+	atomic<LONG> refCount;
+};
+
+HRESULT writeSoundBank(const char* szPath, const vector<SoundBankSource>& sounds);
+
+/**
+// End of SoundBank.h
+ */
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "SoundHandles.h"
+
+#ifndef SOUND_EVENT_QUEUE_SIZE
+#define SOUND_EVENT_QUEUE_SIZE 1024 // voice notifications that can wait between two BasicAudio::run() calls
+#endif
+
+/**
+ * @enum	SOUND_EVENT
+ *
+ * @brief	Things a playing sound reports back from the audio engine.
+ */
+enum SOUND_EVENT
+{
+	SOUND_EVENT_END,        // the sound played to the end of its data (after its last loop)
+	SOUND_EVENT_LOOP_END,   // one pass of a looping sound finished and the next has begun
+	SOUND_EVENT_ERROR       // the voice hit an error while playing, see SoundEvent::error
+};
+
+/**
+ * @struct	SoundEvent
+ *
+ * @brief	One notification, queued from the engine's callback thread and delivered by BasicAudio::run().
+ */
+struct SoundEvent
+{
+	UINT32 type;            // a SOUND_EVENT
+	SOUND_HANDLE handle;
+	HRESULT error;
+};
+
+/**
+ * @typedef	void (*SOUND_CALLBACK)(SOUND_HANDLE handle, SOUND_EVENT event, void* pContext)
+ *
+ * @brief	Per-sound notification, see SampleSound::setCallback(). Called on the thread that calls
+ * 			BasicAudio::run(), so it may use the library freely, e.g. start the next sound.
+ */
+typedef void (*SOUND_CALLBACK)(SOUND_HANDLE handle, SOUND_EVENT event, void* pContext);
+
+/**
+// End of SoundEvent.h
+ */
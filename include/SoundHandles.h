@@ -0,0 +1,154 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @typedef	UINT32 SOUND_HANDLE
+ *
+ * @brief	Stable integer handle to a sound. The low 16 bits are an index into a dense slot array and the high
+ * 			16 bits are the generation of that slot, so a handle to a sound that has been removed is detected
+ * 			rather than silently reaching whatever reused the slot. SOUND_HANDLE_INVALID (0) is never issued.
+ */
+typedef UINT32 SOUND_HANDLE;
+
+#define SOUND_HANDLE_INVALID	((SOUND_HANDLE)0)
+#define SOUND_HANDLE_MAX_SLOTS	0xFFFF
+
+/**
+ * @typedef	unordered_map <wstring, SOUND_HANDLE> SOUND_MAP
+ *
+ * @brief	Defines an alias representing the sound map, which resolves a sound name to its handle. The key is the
+ * 			string itself so that lookups hash the contents rather than the pointer. Based on the MSVC2010 projects
+ * 			contained with the DirectX distribution
+ * 			XAudio2BasicSound - Voice definition etc
+ * 			XAudio2Sound3D - 3D emitters
+ */
+typedef unordered_map <wstring, SOUND_HANDLE> SOUND_MAP;
+
+/**
+ * @class	SoundHandleTable
+ *
+ * @brief	Dense slot array behind SOUND_HANDLE. Resolving a handle is an index and a compare, so per-frame
+ * 			control of thousands of sounds never touches a hash table. Freed slots are reused through a free
+ * 			list and get a new generation each time. Not thread safe, like the rest of BasicAudio.
+ *
+ * @date	10/17/2026
+ */
+template <class T> class SoundHandleTable
+{
+public:
+	SoundHandleTable(void){};
+	~SoundHandleTable(void){};
+
+	/**
+	 * @fn	SOUND_HANDLE SoundHandleTable::add(T item)
+	 *
+	 * @brief	Stores an item and returns its handle.
+	 *
+	 * @return	The handle, or SOUND_HANDLE_INVALID if the table is full.
+	 */
+	SOUND_HANDLE add(T item){
+		UINT32 index;
+		if(!freeList.empty()){
+			index = freeList.back();
+			freeList.pop_back();
+		}else{
+			if(slots.size() >= SOUND_HANDLE_MAX_SLOTS)
+				return SOUND_HANDLE_INVALID;
+			index = (UINT32)slots.size();
+			slots.push_back(Slot());
+		}
+		Slot& s = slots[index];
+		s.item = item;
+		s.used = true;
+		return makeHandle(index, s.generation);
+	};
+
+	/**
+	 * @fn	bool SoundHandleTable::remove(SOUND_HANDLE handle)
+	 *
+	 * @brief	Frees the slot of a handle. The handle, and any copies of it, stop resolving.
+	 *
+	 * @return	false if the handle was already stale.
+	 */
+	bool remove(SOUND_HANDLE handle){
+		if(!isValid(handle))
+			return false;
+		UINT32 index = indexOf(handle);
+		retire(slots[index]);
+		freeList.push_back(index);
+		return true;
+	};
+
+	bool isValid(SOUND_HANDLE handle){
+		UINT32 index = indexOf(handle);
+		return handle != SOUND_HANDLE_INVALID && index < slots.size() && slots[index].used && slots[index].generation == generationOf(handle);
+	};
+
+	/**
+	 * @fn	T SoundHandleTable::get(SOUND_HANDLE handle)
+	 *
+	 * @brief	Resolves a handle.
+	 *
+	 * @return	The item, or a default constructed T (NULL for pointers) if the handle is stale.
+	 */
+	T get(SOUND_HANDLE handle){
+		return isValid(handle) ? slots[indexOf(handle)].item : T();
+	};
+
+	// Direct slot access for walking every item, e.g. in BasicAudio::run(). Unused slots hold T().
+	UINT32 getSlotCount(){return (UINT32)slots.size();};
+	T getSlot(UINT32 index){return slots[index].item;};
+
+	UINT32 getCount(){return (UINT32)(slots.size() - freeList.size());};
+
+	/**
+	 * @fn	void SoundHandleTable::clear()
+	 *
+	 * @brief	Frees every slot. The slots are kept, and so are their generations, which move on as in remove(),
+	 * 			so handles issued before the clear keep missing once their slots are reused.
+	 */
+	void clear(){
+		freeList.clear();
+		// backwards, so that the lowest slots are reused first
+		for(UINT32 index = (UINT32)slots.size(); index-- > 0;){
+			if(slots[index].used)
+				retire(slots[index]);
+			freeList.push_back(index);
+		}
+	};
+
+protected:
+	struct Slot
+	{
+		T item;
+		WORD generation;
+		bool used;
+
+		Slot() : item(), generation(1), used(false) {};
+	};
+
+	vector<Slot> slots;
+	vector<UINT32> freeList;
+
+	// Empties a slot and moves its generation on, skipping 0 so that no handle can be SOUND_HANDLE_INVALID
+	static void retire(Slot& s){
+		s.item = T();
+		s.used = false;
+		s.generation = (WORD)(s.generation + 1);
+		if(s.generation == 0)
+			s.generation = 1;
+	};
+	static SOUND_HANDLE makeHandle(UINT32 index, WORD generation){return ((SOUND_HANDLE)generation << 16) | index;};
+	static UINT32 indexOf(SOUND_HANDLE handle){return handle & 0xFFFF;};
+	static WORD generationOf(SOUND_HANDLE handle){return (WORD)(handle >> 16);};
+};
+
+/**
+// End of SoundHandles.h
+ */
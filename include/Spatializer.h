@@ -0,0 +1,189 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "EmitterSoA.h"
+#include "WorkerPool.h"
+
+#ifndef SPATIALIZER_SPEED_OF_SOUND
+#define SPATIALIZER_SPEED_OF_SOUND 343.5f // same as X3DAUDIO_SPEED_OF_SOUND, in world units per second
+#endif
+
+#ifndef SPATIALIZER_MAX_DOPPLER
+#define SPATIALIZER_MAX_DOPPLER 2.0f // XAUDIO2_DEFAULT_FREQ_RATIO, the most a default source voice will accept
+#endif
+
+#define SPATIALIZER_MAX_CURVE_POINTS 8
+
+#ifndef SPATIALIZER_TASK_GRAIN
+#define SPATIALIZER_TASK_GRAIN 256  // fewest emitters worth handing to another thread, a multiple of EMITTER_SOA_GRANULE
+#endif
+
+// Speaker positions for channel masks, as in mmreg.h / X3DAudio.h
+#ifndef SPEAKER_FRONT_LEFT
+#define SPEAKER_FRONT_LEFT				0x00000001
+#define SPEAKER_FRONT_RIGHT				0x00000002
+#define SPEAKER_FRONT_CENTER			0x00000004
+#define SPEAKER_LOW_FREQUENCY			0x00000008
+#define SPEAKER_BACK_LEFT				0x00000010
+#define SPEAKER_BACK_RIGHT				0x00000020
+#define SPEAKER_FRONT_LEFT_OF_CENTER	0x00000040
+#define SPEAKER_FRONT_RIGHT_OF_CENTER	0x00000080
+#define SPEAKER_BACK_CENTER				0x00000100
+#define SPEAKER_SIDE_LEFT				0x00000200
+#define SPEAKER_SIDE_RIGHT				0x00000400
+#endif
+
+/**
+ * @struct	SpatialCurvePoint
+ *
+ * @brief	One point of a piecewise linear distance curve. Same layout as X3DAUDIO_DISTANCE_CURVE_POINT, with the
+ * 			distance normalized by the emitter's curve distance scaler.
+ */
+struct SpatialCurvePoint
+{
+	FLOAT32 distance;
+	FLOAT32 setting;
+};
+
+/**
+ * @struct	SpatialListener
+ *
+ * @brief	The listener, as in X3DAUDIO_LISTENER without the cone. Front and top must be orthonormal.
+ */
+struct SpatialListener
+{
+	FLOAT32 position[3];
+	FLOAT32 velocity[3];
+	FLOAT32 front[3];
+	FLOAT32 top[3];
+};
+
+/**
+ * @enum	SPATIALIZER_KERNEL
+ *
+ * @brief	Implementations of the per-emitter math. All of them produce the same results to within float
+ * 			rounding, the vector ones' atan2 and sine included, the wider ones just do more emitters per
+ * 			instruction.
+ */
+enum SPATIALIZER_KERNEL
+{
+	SPATIALIZER_KERNEL_SCALAR,  // one emitter at a time, always available
+	SPATIALIZER_KERNEL_SSE,     // 8 emitters per iteration, as two 4 wide vectors
+	SPATIALIZER_KERNEL_AVX      // 16 emitters per iteration, as two 8 wide vectors
+};
+
+/**
+ * @class	Spatializer
+ *
+ * @brief	Portable replacement for the X3DAudioCalculate() call made for each sound, working on a whole
+ * 			EmitterSoA at once. It covers what the library uses: the volume, reverb and LPF direct distance
+ * 			curves (defaulting to the linear volume curve and three point reverb curve from SampleSound, and
+ * 			the X3DAudio default LPF direct curve), inner radius spread, Doppler, and emitters of up to
+ * 			EMITTER_MAX_CHANNELS channels. Emitter cones are not handled, and the curves are shared by all
+ * 			emitters.
+ *
+ * 			Distances, curves, Doppler and spread are computed with SSE or AVX over the arrays, and so is the
+ * 			direction of each emitter: its azimuth, the pair of speakers either side of it and its constant
+ * 			power weights between them, with polynomial atan2 and sine in place of the library calls and the
+ * 			ring searched by comparing every lane against every speaker. Only writing the matrix is left to
+ * 			the per-emitter pass, which blends the pair towards an even spread over all speakers as the sound
+ * 			comes inside its inner radius. Each channel of a multichannel emitter is panned that way from its
+ * 			own place around the emitter, but those places are only known per channel, so their directions
+ * 			are still worked out one at a time in scalar code; the LFE speaker only gets the emitter's own LFE
+ * 			channels.
+ *
+ * 			Spatializer sp;
+ * 			sp.setSpeakers(SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT, 2);
+ * 			sp.setListener(listener);
+ * 			sp.process(&emitters); // fills doppler, distance, reverbLevel, lpfDirect and the matrices
+ * 			sp.process(&emitters, &workers); // or the same split over a WorkerPool
+ * 			sp.estimateAudibility(&emitters); // just gain times the volume curve, for VoiceVirtualizer
+ *
+ * 			Every emitter is independent, and the scratch arrays are indexed by emitter, so ranges of the store
+ * 			can be processed on different threads at once once prepare() has been called: process() with a
+ * 			pool does exactly that, and BasicAudio::update3D() does it with its own per-range work folded in.
+ *
+ * @date	10/17/2026
+ */
+class Spatializer
+{
+public:
+	Spatializer(void);
+	~Spatializer(void);
+
+	void setSpeakers(DWORD channelMask, UINT32 channelCount);
+	void setSpeedOfSound(FLOAT32 speedOfSound){this->speedOfSound = speedOfSound;};
+	void setListener(const SpatialListener& listener);
+	bool setVolumeCurve(const SpatialCurvePoint* pPoints, UINT32 count){return setCurve(&volumeCurve, pPoints, count);};
+	bool setReverbCurve(const SpatialCurvePoint* pPoints, UINT32 count){return setCurve(&reverbCurve, pPoints, count);};
+	bool setLPFDirectCurve(const SpatialCurvePoint* pPoints, UINT32 count){return setCurve(&lpfDirectCurve, pPoints, count);};
+
+	bool setKernel(SPATIALIZER_KERNEL kernel);
+	SPATIALIZER_KERNEL getKernel(){return kernel;};
+	static bool isKernelAvailable(SPATIALIZER_KERNEL kernel);
+
+	void process(EmitterSoA* pEmitters, WorkerPool* pWorkers = NULL);
+	void prepare(EmitterSoA* pEmitters);
+	void processRange(EmitterSoA* pEmitters, UINT32 begin, UINT32 end);
+	void estimateAudibility(EmitterSoA* pEmitters);
+
+	UINT32 getChannelCount(){return channelCount;};
+
+	/**
+	 * @struct	Curve
+	 *
+	 * @brief	A distance curve prepared for evaluation: each segment stores its start, 1 / length, start
+	 * 			setting and rise, so a point is start setting + clamp((x - start) / length) * rise.
+	 */
+	struct Curve
+	{
+		UINT32 segments;
+		FLOAT32 firstSetting;
+		FLOAT32 start[SPATIALIZER_MAX_CURVE_POINTS];
+		FLOAT32 invLength[SPATIALIZER_MAX_CURVE_POINTS];
+		FLOAT32 base[SPATIALIZER_MAX_CURVE_POINTS];
+		FLOAT32 rise[SPATIALIZER_MAX_CURVE_POINTS];
+	};
+
+	static FLOAT32 evaluate(const Curve& curve, FLOAT32 x);
+
+protected:
+	SPATIALIZER_KERNEL kernel;
+	FLOAT32 speedOfSound;
+	SpatialListener listener;
+	FLOAT32 right[3];               // listener right vector, top x front
+
+	Curve volumeCurve;
+	Curve reverbCurve;
+	Curve lpfDirectCurve;
+
+	UINT32 channelCount;
+	INT32 lfeChannel;               // the LFE speaker's channel, or -1
+	UINT32 ringCount;               // speakers that take part in panning (not LFE)
+	UINT32 ringChannel[32];         // their channels, sorted by azimuth
+	FLOAT32 ringAzimuth[32];        // their azimuths, clockwise from front in [0, 2 pi)
+
+	// Per-emitter intermediate results handed from the vector pass to the panning pass
+	FLOAT32* localX;
+	FLOAT32* localZ;
+	FLOAT32* volume;
+	FLOAT32* spread;
+	FLOAT32* pairIndex;             // ring index of the speaker on the sound's left, a whole number
+	FLOAT32* nearWeight;            // constant power weight of that speaker
+	FLOAT32* farWeight;             // and of the next one round the ring
+	UINT32 scratchCapacity;
+
+	static bool setCurve(Curve* pCurve, const SpatialCurvePoint* pPoints, UINT32 count);
+	void reserveScratch(UINT32 capacity);
+	void processScalar(EmitterSoA* e, UINT32 begin, UINT32 end);
+	void processSSE(EmitterSoA* e, UINT32 begin, UINT32 end);
+	void processAVX(EmitterSoA* e, UINT32 begin, UINT32 end);
+	void direction(FLOAT32 x, FLOAT32 z, UINT32* pPair, FLOAT32* pNear, FLOAT32* pFar);
+	void panPair(FLOAT32* m, UINT32 stride, UINT32 pair, FLOAT32 nearWeight, FLOAT32 farWeight, FLOAT32 gain, FLOAT32 s);
+	void panSource(FLOAT32* m, UINT32 stride, FLOAT32 x, FLOAT32 z, FLOAT32 gain, FLOAT32 s);
+	template<UINT32 SRC> void pan(EmitterSoA* e, UINT32 index);
+};
+
+/**
+// End of Spatializer.h
+ */
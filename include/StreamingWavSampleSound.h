@@ -0,0 +1,86 @@
+#pragma once
+
+#include "WavSampleSound.h"
+#include "WavStreamReader.h"
+#include <mutex>
+
+/**
+ * @class	StreamingWavSampleSound
+ *
+ * @brief	WAV implementation of the SampleSound abstract class that streams from disk instead of loading the
+ * 			whole 'data' chunk. A WavStreamReader keeps a small ring of fixed-size buffers filled on a background
+ * 			thread, each filled buffer is submitted to the source voice and handed back to the reader from
+ * 			OnBufferEnd. Memory use is STREAMING_BUFFER_COUNT * STREAMING_BUFFER_BYTES no matter how long the
+ * 			file is. start(), stop() and run() behave the same way as they do for WavSampleSound, and looping is
+ * 			done by the reader.
+ *
+ * 			ADPCM files are decoded by the reader as they stream. initCompressed() instead keeps the whole
+ * 			file in memory, still compressed, and streams from there through a ring of a few decoded blocks.
+ *
+ * @date	10/17/2026
+ */
+class StreamingWavSampleSound : public WavSampleSound
+{
+public:
+	StreamingWavSampleSound(void);
+	~StreamingWavSampleSound(void);
+
+	HRESULT initPCM( IXAudio2* pXaudio2, LPCWSTR szFilename, UINT loopCount );
+	HRESULT initCompressed( IXAudio2* pXaudio2, LPCWSTR szFilename, UINT loopCount );
+
+	HRESULT start();
+	void stop();
+	HRESULT run();
+	void destroy();
+	void onEvent(const SoundEvent& e);
+
+	void getStreamStats(StreamStats* stats){reader.getStats(stats);};
+
+	// No whole asset to lend to playInstance(), even when initCompressed() holds the file: it is ADPCM
+	PcmAsset* getAsset(){return NULL;};
+
+protected:
+
+	/**
+	 * @class	VoiceCallback
+	 *
+	 * @brief	Returns played buffers to the reader as XAudio2 finishes with them, and queues the end of the
+	 * 			stream and voice errors through the owner's SoundEventCallback.
+	 */
+	class VoiceCallback : public IXAudio2VoiceCallback
+	{
+	public:
+		VoiceCallback(StreamingWavSampleSound* owner) : pOwner(owner) {};
+
+		STDMETHOD_(void, OnBufferEnd)(void* pBufferContext){pOwner->reader.release((StreamBlock*)pBufferContext);};
+		STDMETHOD_(void, OnStreamEnd)(){
+			if(pOwner->pEventCallback != NULL)
+				pOwner->pEventCallback->post(SOUND_EVENT_END, pOwner->getHandle());
+		};
+		STDMETHOD_(void, OnVoiceError)(void*, HRESULT error){
+			if(pOwner->pEventCallback != NULL)
+				pOwner->pEventCallback->post(SOUND_EVENT_ERROR, pOwner->getHandle(), error);
+		};
+
+		STDMETHOD_(void, OnVoiceProcessingPassStart)(UINT32){};
+		STDMETHOD_(void, OnVoiceProcessingPassEnd)(){};
+		STDMETHOD_(void, OnBufferStart)(void*){};
+		STDMETHOD_(void, OnLoopEnd)(void*){};
+
+	protected:
+		StreamingWavSampleSound* pOwner;
+	};
+
+	WavStreamReader reader;
+	VoiceCallback voiceCallback;
+	mutex submitLock;
+
+	HRESULT createVoice();
+	HRESULT setLoadResult(HRESULT hr);
+	static void onBlockReady(void* pContext);
+	HRESULT submitReady();
+};
+
+/**
+// End of StreamingWavSampleSound.h
+ */
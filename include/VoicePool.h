@@ -0,0 +1,156 @@
+#pragma once
+
+#include <windows.h>
+#include <XAudio2.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include "PcmAssetCache.h"
+#include "CommandRing.h"
+
+#ifndef VOICE_POOL_VOICES_PER_FORMAT
+#define VOICE_POOL_VOICES_PER_FORMAT 16 // source voices preallocated for each wave format
+#endif
+
+#ifndef VOICE_POOL_EVENT_QUEUE_SIZE
+#define VOICE_POOL_EVENT_QUEUE_SIZE 1024 // buffer ends that can wait between two VoicePool::run() calls
+#endif
+
+using namespace std;
+
+/**
+ * @typedef	UINT64 VOICE_INSTANCE
+ *
+ * @brief	Identifies one fire-and-forget play of a sound. Zero is never a valid instance. An instance stops
+ * 			being valid when it finishes playing or its voice is stolen.
+ */
+typedef UINT64 VOICE_INSTANCE;
+
+/**
+ * @enum	VOICE_STEAL_POLICY
+ *
+ * @brief	How the pool picks a voice to take over when every voice for a format is busy.
+ */
+enum VOICE_STEAL_POLICY
+{
+	VOICE_STEAL_NONE,           // never steal, the new play is rejected
+	VOICE_STEAL_OLDEST,         // take the voice that started longest ago
+	VOICE_STEAL_QUIETEST,       // take the voice with the lowest volume
+	VOICE_STEAL_LOWEST_PRIORITY // take the lowest priority voice, oldest first, if it is no higher than the new one
+};
+
+/**
+ * @struct	VoicePoolStats
+ *
+ * @brief	Occupancy and traffic counters for a VoicePool.
+ */
+struct VoicePoolStats
+{
+	UINT32 formats;         // number of distinct wave formats with voices allocated
+	UINT32 capacity;        // total source voices allocated
+	UINT32 active;          // voices currently playing an instance
+	UINT32 peakActive;      // most voices ever active at once
+	UINT64 plays;           // instances started
+	UINT64 steals;          // instances started by taking over a busy voice
+	UINT64 rejected;        // instances that could not get a voice
+};
+
+/**
+ * @class	VoicePool
+ *
+ * @brief	A set of preallocated source voices, grouped by wave format, that play overlapping fire-and-forget
+ * 			instances of sounds. Creating and destroying an XAudio2 voice for every trigger is far too slow at
+ * 			game event rates, so voices are made once per format (see reserve()) and recycled as instances finish.
+ * 			Each instance holds a reference to the PcmAsset it is playing, so the sample data outlives it.
+ *
+ * 			Voice completion is counted from OnBufferEnd, which also queues the voice in a lock-free ring. run()
+ * 			only looks at the voices in that ring, so its cost follows the number of instances that ended, not
+ * 			the size of the pool. play() also picks up any voices of its format that have finished since.
+ *
+ * @date	10/17/2026
+ */
+class VoicePool
+{
+public:
+	VoicePool(void);
+	~VoicePool(void);
+
+	void init(IXAudio2* pXaudio2, UINT32 voicesPerFormat, VOICE_STEAL_POLICY policy);
+	HRESULT reserve(const WAVEFORMATEX* pwfx);
+	VOICE_INSTANCE play(PcmAsset* pAsset, UINT32 priority, FLOAT32 volume, IXAudio2Voice* pOutput = NULL);
+	IXAudio2SourceVoice* getVoice(VOICE_INSTANCE instance);
+	void stop(VOICE_INSTANCE instance);
+	void run();
+	void destroy();
+
+	void setStealPolicy(VOICE_STEAL_POLICY policy){stealPolicy = policy;};
+	VOICE_STEAL_POLICY getStealPolicy(){return stealPolicy;};
+	void getStats(VoicePoolStats* stats);
+
+	static string formatKey(const WAVEFORMATEX* pwfx);
+
+protected:
+
+	/**
+	 * @struct	PooledVoice
+	 *
+	 * @brief	One source voice of the pool and the instance it is playing, if any. The callback only touches
+	 * 			buffersEnded and the ring of ended voices, everything else belongs to the thread that calls the pool.
+	 */
+	struct PooledVoice : public IXAudio2VoiceCallback
+	{
+		CommandRing<PooledVoice*>* pEnded; // where OnBufferEnd tells run() to look at this voice
+		IXAudio2SourceVoice* pVoice;
+		IXAudio2Voice* pOutput;     // the submix the voice sends to, NULL for the mastering voice
+		VOICE_INSTANCE instance;    // 0 when the voice is free
+		PcmAsset* pAsset;           // asset being played, one reference held
+		// assets of stopped or stolen instances, each held until buffersEnded reaches the count paired with it
+		vector<pair<PcmAsset*, UINT32> > retired;
+		UINT32 priority;
+		FLOAT32 volume;
+		UINT32 buffersSubmitted;
+		atomic<UINT32> buffersEnded;
+
+		PooledVoice(CommandRing<PooledVoice*>* ended) : pEnded(ended), pVoice(NULL), pOutput(NULL), instance(0), pAsset(NULL), priority(0), volume(0), buffersSubmitted(0), buffersEnded(0) {};
+
+		bool isPlaying(){return instance != 0 && buffersEnded.load() != buffersSubmitted;};
+
+		STDMETHOD_(void, OnBufferEnd)(void*){
+			buffersEnded++;
+			pEnded->push(this);
+		};
+
+		STDMETHOD_(void, OnVoiceProcessingPassStart)(UINT32){};
+		STDMETHOD_(void, OnVoiceProcessingPassEnd)(){};
+		STDMETHOD_(void, OnStreamEnd)(){};
+		STDMETHOD_(void, OnBufferStart)(void*){};
+		STDMETHOD_(void, OnLoopEnd)(void*){};
+		STDMETHOD_(void, OnVoiceError)(void*, HRESULT){};
+	};
+
+	typedef vector<PooledVoice*> VOICE_LIST;
+	typedef unordered_map<string, VOICE_LIST> FORMAT_MAP;
+	typedef unordered_map<VOICE_INSTANCE, PooledVoice*> INSTANCE_MAP;
+
+	IXAudio2* pXaudio2;
+	UINT32 voicesPerFormat;
+	VOICE_STEAL_POLICY stealPolicy;
+	FORMAT_MAP formats;
+	INSTANCE_MAP instances;
+	VOICE_INSTANCE nextInstance;
+	VoicePoolStats stats;
+	CommandRing<PooledVoice*> ended; // voices whose buffers have ended since the last run()
+	UINT64 lostEnds;        // ended drops already made up for by a full scan
+
+	void reclaim(PooledVoice* pv);
+	void retire(PooledVoice* pv);
+	void releaseRetired(PooledVoice* pv, bool force);
+	void update(PooledVoice* pv);
+	PooledVoice* findFree(VOICE_LIST& voices);
+	PooledVoice* findVictim(VOICE_LIST& voices, UINT32 priority);
+};
+
+/**
+// End of VoicePool.h
+ */
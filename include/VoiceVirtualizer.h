@@ -0,0 +1,149 @@
+#pragma once
+
+#include <windows.h>
+#include <XAudio2.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "WavSampleSound.h"
+#include "EmitterSoA.h"
+#include "SoundEvent.h"
+
+#ifndef VIRTUAL_VOICE_BUDGET
+#define VIRTUAL_VOICE_BUDGET 64 // virtual sounds that may have a voice at once, unless setBudget() says otherwise
+#endif
+
+#ifndef VIRTUAL_VOICE_HYSTERESIS
+#define VIRTUAL_VOICE_HYSTERESIS 1.25f // how many times more audible a sound must be to take a voice from another
+#endif
+
+#ifndef VIRTUAL_VOICE_MIN_AUDIBILITY
+#define VIRTUAL_VOICE_MIN_AUDIBILITY 1.0e-4f // sounds quieter than this (-80 dB) are never given a voice
+#endif
+
+using namespace std;
+
+/**
+ * @struct	VirtualVoiceStats
+ *
+ * @brief	What the VoiceVirtualizer is looking after, and how often it has moved voices around.
+ */
+struct VirtualVoiceStats
+{
+	UINT32 sounds;          // virtual sounds
+	UINT32 playing;         // of which playing, heard or not
+	UINT32 real;            // of which have a voice
+	UINT32 budget;          // see VoiceVirtualizer::setBudget()
+	UINT32 voices;          // source voices made so far
+	UINT64 promotions;      // voices lent to sounds
+	UINT64 demotions;       // voices taken back from sounds that were still playing
+};
+
+/**
+ * @class	VoiceVirtualizer
+ *
+ * @brief	Lets thousands of sounds play while only the few that can be heard best have a source voice. Every
+ * 			virtual sound that is playing has its position kept by the clock, which costs a few adds, and each
+ * 			update() lends voices to the budget's worth of them that are most audible, going by
+ * 			Spatializer::estimateAudibility() (the sound's volume times the volume curve at its distance).
+ * 			Sounds that fall out of that set give their voice back and carry on silently, so a sound that comes
+ * 			back into range picks up where it would have been.
+ *
+ * 			A voice is lent by submitting the sound's data from its current position, with its remaining
+ * 			loops, at zero volume; the next update() turns it up. Taking one back turns it down and stops it
+ * 			an update later. Both changes are ramped over an audio block by the engine, so neither clicks. A
+ * 			sound already holding a voice keeps it until another is VIRTUAL_VOICE_HYSTERESIS times more
+ * 			audible, so sounds of about the same loudness don't trade voices every frame.
+ *
+ * 			Voices are made per wave format as they are first needed and then reused, so once the game has
+ * 			warmed up the cost of update() depends on the number of virtual sounds and the budget, not on how
+ * 			they move. Virtual sounds are in-memory WavSampleSounds; their position does not follow Doppler
+ * 			while they have no voice, and their loop and end events are also worked out from the clock.
+ *
+ * 			BasicAudio owns one of these: see createVirtualSound() and setVoiceBudget().
+ *
+ * @date	10/17/2026
+ */
+class VoiceVirtualizer
+{
+public:
+	VoiceVirtualizer(void);
+	~VoiceVirtualizer(void);
+
+	void init(IXAudio2* pXaudio2, UINT32 budget);
+	void add(WavSampleSound* pSound);
+	bool remove(SampleSound* pSound);
+	void update(EmitterSoA* pEmitters, double seconds, vector<SampleSound*>* pPromoted);
+	void destroy();
+
+	void setBudget(UINT32 budget){this->budget = budget;};
+	UINT32 getBudget(){return budget;};
+	UINT32 getSoundCount(){return (UINT32)sounds.size();};
+	void getStats(VirtualVoiceStats* stats);
+
+protected:
+	enum VIRTUAL_STATE
+	{
+		VIRTUAL_STOPPED,    // not playing
+		VIRTUAL_SILENT,     // playing without a voice, only its position is kept
+		VIRTUAL_FADING_IN,  // lent a voice at zero volume by the last update
+		VIRTUAL_REAL,       // playing on a voice at its own volume
+		VIRTUAL_FADING_OUT  // turned down by the last update, the voice is taken back by the next
+	};
+
+	enum { NO_FORMAT = 0xFFFFFFFF };
+
+	/**
+	 * @struct	Voice
+	 *
+	 * @brief	A source voice the virtualizer has made.
+	 */
+	struct Voice
+	{
+		IXAudio2SourceVoice* pVoice;
+		IXAudio2Voice* pOutput; // the submix it sends to, NULL for the mastering voice
+		UINT32 format;          // index into freeVoices
+	};
+
+	/**
+	 * @struct	VirtualSound
+	 *
+	 * @brief	A virtual sound and where it has got to.
+	 */
+	struct VirtualSound
+	{
+		WavSampleSound* pSound;
+		INT32 voice;            // index into voices, -1 while it has none
+		UINT32 format;          // index into freeVoices, NO_FORMAT until the sound has loaded
+		double position;        // frames into the data
+		UINT32 frames;          // frames in the data
+		FLOAT32 frameRate;      // frames per second
+		UINT32 loopsPlayed;
+		UINT32 starts;          // the sound's start count when last looked at
+		FLOAT32 appliedVolume;  // what the voice was last given
+		BYTE state;             // a VIRTUAL_STATE
+	};
+
+	IXAudio2* pXaudio2;
+	UINT32 budget;
+	vector<VirtualSound> sounds;
+	vector<Voice> voices;
+	vector<vector<UINT32> > freeVoices; // voices not lent out, by format
+	unordered_map<string, UINT32> formats; // VoicePool::formatKey() to index into freeVoices
+	vector<pair<FLOAT32, UINT32> > candidates; // update()'s audible sounds, by score
+	vector<BYTE> chosen;    // update()'s verdict, by sound
+	vector<pair<WavSampleSound*, SOUND_EVENT> > events; // update()'s loop and end events, sent once it is done
+	UINT64 promotions;
+	UINT64 demotions;
+
+	bool prepare(VirtualSound& vs);
+	bool advance(VirtualSound& vs, FLOAT32 rate, double seconds);
+	INT32 acquire(VirtualSound& vs);
+	bool promote(VirtualSound& vs);
+	void release(VirtualSound& vs);
+	void setVolume(VirtualSound& vs, FLOAT32 volume);
+};
+
+/**
+// End of VoiceVirtualizer.h
+ */
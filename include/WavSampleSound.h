@@ -1,6 +1,9 @@
 #pragma once
 
 #include "SampleSound.h"
+#include "PcmAssetCache.h"
+#include "SoundBank.h"
+#include <atomic>
 
 /**
  * @class	WavSampleSound
@@ -18,17 +21,44 @@ public:
 	~WavSampleSound(void);
 
 	HRESULT initPCM( IXAudio2* pXaudio2, LPCWSTR szFilename, UINT loopCount );
+
+	// initPCM() in three steps, so that the middle one can run on a loader thread
+	void beginLoad( LPCWSTR szFilename, UINT loopCount );
+	HRESULT loadAsset();
+	HRESULT finishLoad( IXAudio2* pXaudio2 );
 	
 	HRESULT start();
 	void stop();
 	HRESULT run();
 	void destroy();
+	void onEvent(const SoundEvent& e);
+
+	void setAssetCache(PcmAssetCache* pCache){pAssetCache = pCache;};
+	void setSoundBank(SoundBank* pBank, UINT32 index);
+	PcmAsset* getAsset(){return getLoadState() == SOUND_LOAD_READY ? pAsset : NULL;};
+	SOUND_LOAD_STATE getLoadState(){return (SOUND_LOAD_STATE)loadState.load(memory_order_acquire);};
+
+	// Virtual sounds, see VoiceVirtualizer
+	void setVirtual(bool enable){virtualVoice = enable;};
+	bool isVirtual(){return virtualVoice;};
+	void attachVoice(IXAudio2SourceVoice* pVoice);
+	UINT32 getStartCount(){return starts;};
+	UINT getLoopCount(){return loopCount;};
 
 protected:
 
 	DWORD cbWaveSize;
-	CWaveFile wav;
-	BYTE* pbWaveData;
+	PcmAssetCache* pAssetCache; // if set, the sample data is shared through this cache
+	PcmAsset* pAsset;       // the sample data and format, one reference held
+	SoundBank* pBank;       // if set, loadAsset() takes the sound from here instead of a file, one reference held
+	UINT32 bankIndex;
+	const BYTE* pbWaveData; // points into the asset, not owned
+	UINT loopCount;
+	atomic<LONG> loadState; // a SOUND_LOAD_STATE, written by the loader thread while PENDING
+	HRESULT loadResult;     // why loadAsset() failed
+	bool startPending;      // start() was called before the sound was READY
+	bool virtualVoice;      // the sound has no voice of its own, VoiceVirtualizer lends it one when it is audible
+	UINT32 starts;          // start() calls on a virtual sound, so the virtualizer can tell it was restarted
 
 	HRESULT FindMediaFileCch( WCHAR* strDestPath, int cchDest, LPCWSTR strFilename );
 };
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include "AdpcmCodec.h"
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#ifndef STREAM_LOOP_INFINITE
+#define STREAM_LOOP_INFINITE 255 // same value as XAUDIO2_LOOP_INFINITE
+#endif
+
+#ifndef STREAMING_BUFFER_COUNT
+#define STREAMING_BUFFER_COUNT 3 // number of buffers in the ring
+#endif
+
+#ifndef STREAMING_BUFFER_BYTES
+#define STREAMING_BUFFER_BYTES 65536 // size of each buffer in the ring
+#endif
+
+#ifndef STREAMING_MEMORY_BLOCKS
+#define STREAMING_MEMORY_BLOCKS 2 // decoded ADPCM blocks in each buffer when streaming from memory
+#endif
+
+using namespace std;
+
+/**
+ * @struct	StreamBlock
+ *
+ * @brief	One fixed-size buffer of the streaming ring. The consumer gets a pointer to one of these from
+ * 			WavStreamReader::acquire() and hands it back with WavStreamReader::release() once the audio has
+ * 			been played (for XAudio2 this is done from OnBufferEnd, using the block as the buffer context).
+ */
+struct StreamBlock
+{
+	BYTE* pData;            // the audio data
+	UINT32 bytes;           // number of valid bytes in pData
+	bool endOfStream;       // true if this is the last block of the last loop
+	UINT32 index;           // position of this block in the ring
+	chrono::steady_clock::time_point released; // when the consumer gave the block back, used for latency stats
+};
+
+/**
+ * @struct	StreamStats
+ *
+ * @brief	Refill statistics for a WavStreamReader. Latency is measured from the time the consumer releases
+ * 			a block to the time the reader thread has filled it again.
+ */
+struct StreamStats
+{
+	UINT64 refills;         // number of blocks refilled after being released
+	UINT64 underruns;       // number of times the consumer ran dry: nothing held, nothing filled, stream not finished
+	UINT64 bytesRead;       // total bytes read from the source, before any ADPCM decoding
+	double avgRefillMicros; // average release-to-filled latency
+	double maxRefillMicros; // worst release-to-filled latency
+};
+
+/**
+ * @class	WavStreamReader
+ *
+ * @brief	Reads the 'data' chunk of a WAV file through a small ring of fixed-size buffers that is refilled
+ * 			from disk by a background thread as the consumer releases them. Memory use is bounded by
+ * 			bufferCount * bufferBytes regardless of the length of the file. Looping follows the XAudio2
+ * 			convention: 0 plays once, n repeats n more times and STREAM_LOOP_INFINITE never ends.
+ *
+ * 			This class has no XAudio2 dependency so that a headless consumer can drain it (e.g. on Linux)
+ * 			and measure refill latency:
+ *
+ * 			WavStreamReader reader;
+ * 			reader.open("Wavs/Electro_1.wav", STREAMING_BUFFER_BYTES, STREAMING_BUFFER_COUNT, 0);
+ * 			reader.start();
+ * 			while((block = reader.acquire(1000)) != NULL){
+ * 				// consume block->pData
+ * 				reader.release(block);
+ * 				if(block->endOfStream) break;
+ * 			}
+ * 			reader.getStats(&stats);
+ *
+ * 			IMA and MS ADPCM files are decoded as they are read, a bufferful of blocks at a time, and
+ * 			delivered as 16 bit PCM: getFormat() is the decoded format and the buffers hold whole decoded
+ * 			blocks. openMemory() streams data already in memory the same way, typically a compressed asset
+ * 			kept at a quarter of its decoded size instead of streaming it from disk. Its ring only has to
+ * 			cover the decode, not disk reads, so getMemoryBufferBytes() gives buffers a couple of decoded
+ * 			blocks long, keeping the asset and its ring smaller than the asset would be as 16 bit PCM.
+ */
+class WavStreamReader
+{
+public:
+	typedef void (*READY_CALLBACK)(void* pContext);
+
+	WavStreamReader(void);
+	~WavStreamReader(void);
+
+	HRESULT open(const char* szFilename, UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount);
+#ifdef _WIN32
+	HRESULT open(const wchar_t* szFilename, UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount);
+#endif
+	HRESULT openMemory(const WAVEFORMATEX* pFormat, const BYTE* pData, UINT32 dataBytes, UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount, UINT32 factFrames = 0);
+	static UINT32 getMemoryBufferBytes(const WAVEFORMATEX* pFormat);
+	void close();
+
+	HRESULT start();
+	HRESULT rewind();
+
+	StreamBlock* acquire(UINT32 timeoutMs);
+	void release(StreamBlock* block);
+
+	void setReadyCallback(READY_CALLBACK callback, void* pContext);
+
+	bool isFinished();
+	void getStats(StreamStats* stats);
+
+	const WAVEFORMATEX* getFormat(){return &wfx;};
+	UINT32 getDataSize(){return dataSize;};
+	bool isCompressed(){return adpcm.type != ADPCM_TYPE_NONE;};
+	UINT32 getBufferBytes(){return bufferBytes;};
+	UINT32 getBufferCount(){return bufferCount;};
+
+protected:
+	FILE* pFile;
+	const BYTE* pMemory;    // the data when streaming from memory, not owned
+	UINT32 memoryPos;
+	WAVEFORMATEX wfx;       // the format delivered, decoded if the source is ADPCM
+	AdpcmFormat adpcm;      // type ADPCM_TYPE_NONE if the source is not compressed
+	BYTE* pCompressed;      // a bufferful of ADPCM blocks read from the file
+	UINT32 decodedBlockBytes;
+	long dataOffset;
+	UINT32 dataSize;
+	UINT32 dataRemaining;
+	UINT32 dataFrames;      // decoded frames in one pass of ADPCM data, from the 'fact' chunk, 0 for all
+	UINT32 framesRemaining; // of dataFrames in this pass
+	UINT32 loopCount;
+	UINT32 loopsRemaining;
+	bool readComplete;
+
+	BYTE* pRingData;
+	StreamBlock* blocks;
+	UINT32 bufferBytes;
+	UINT32 bufferCount;
+	UINT32 fillIndex;       // next block the reader thread will fill
+	UINT32 acquireIndex;    // next block the consumer will get
+	UINT32 emptyCount;      // blocks waiting to be filled
+	UINT32 filledCount;     // blocks waiting to be acquired
+	UINT32 inUseCount;      // blocks currently held by the consumer
+
+	READY_CALLBACK readyCallback;
+	void* pReadyContext;
+
+	thread readerThread;
+	mutex lock;
+	condition_variable readerWake;
+	condition_variable consumerWake;
+	bool threadRunning;
+	bool quit;
+
+	StreamStats stats;
+	double totalRefillMicros;
+
+	HRESULT parseHeader();
+	HRESULT setFormat(const WAVEFORMATEX* pFormat);
+	void setFactFrames(UINT32 factFrames);
+	UINT32 readSource(BYTE* pDest, UINT32 bytes, const BYTE** ppData);
+	void seekToData();
+	HRESULT allocateRing(UINT32 bufferBytes, UINT32 bufferCount, UINT32 loopCount);
+	void resetRing();
+	UINT32 fillBlock(StreamBlock* block);
+	void readerLoop();
+};
+
+/**
+// End of WavStreamReader.h
+ */
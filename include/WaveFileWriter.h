@@ -0,0 +1,100 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+#ifndef WAVE_WRITER_STAGING_BYTES
+#define WAVE_WRITER_STAGING_BYTES (1 << 20) // size of each staging buffer
+#endif
+
+#ifndef WAVE_WRITER_ALIGNMENT
+#define WAVE_WRITER_ALIGNMENT 4096 // staging buffers are page aligned
+#endif
+
+using namespace std;
+
+/**
+ * @struct	WaveWriterStats
+ *
+ * @brief	Throughput numbers for a WaveFileWriter, measured from open() to the last flush.
+ */
+struct WaveWriterStats
+{
+	UINT64 bytesWritten;       // sample bytes handed to write()
+	UINT64 flushes;            // number of staging buffers written to disk
+	double seconds;            // wall clock time from open to the last completed flush
+	double megabytesPerSecond; // sustained throughput
+	double producerStallMicros;// time write() spent waiting for the flush thread
+};
+
+/**
+ * @class	WaveFileWriter
+ *
+ * @brief	Writes a WAV file in large blocks. Sample data is memcpy'd into a page-aligned staging buffer
+ * 			that goes to disk in one call when it fills, and the RIFF, 'fact' and 'data' sizes are patched
+ * 			once in close(). With a background flush thread there are two staging buffers: the producer
+ * 			fills one while the other is written, so disk I/O stays off the caller's thread unless the disk
+ * 			falls behind. Used by CWaveFile for WAVEFILE_WRITE and usable directly on any platform.
+ *
+ * @date	10/17/2026
+ */
+class WaveFileWriter
+{
+public:
+	WaveFileWriter(void);
+	~WaveFileWriter(void);
+
+	HRESULT open(const char* szFilename, const WAVEFORMATEX* pwfx, bool backgroundFlush);
+#ifdef _WIN32
+	HRESULT open(const wchar_t* szFilename, const WAVEFORMATEX* pwfx, bool backgroundFlush);
+#endif
+	HRESULT write(const BYTE* pbData, UINT32 nSizeToWrite, UINT32* pnSizeWrote);
+	HRESULT close();
+
+	bool isOpen(){return pFile != NULL;};
+	void getStats(WaveWriterStats* stats);
+
+protected:
+	FILE* pFile;
+	WAVEFORMATEX wfx;
+	long riffSizeOffset;
+	long factOffset;
+	long dataSizeOffset;
+	UINT64 dataBytes;
+	atomic<HRESULT> writeError; // set by the flush thread, read by the producer
+
+	BYTE* pStaging[2];
+	UINT32 stagingUsed;         // bytes in the buffer being filled
+	int fillBuffer;             // which of pStaging the producer is filling
+
+	bool background;
+	thread flushThread;
+	mutex lock;
+	condition_variable flushWake;
+	condition_variable producerWake;
+	BYTE* pPending;             // buffer waiting for the flush thread, NULL if none
+	UINT32 pendingBytes;
+	bool quit;
+
+	chrono::steady_clock::time_point openTime;
+	chrono::steady_clock::time_point lastFlushTime;
+	UINT64 flushes;
+	double stallMicros;
+
+	HRESULT begin(FILE* pFile, const WAVEFORMATEX* pwfx, bool backgroundFlush);
+	HRESULT writeHeader(const WAVEFORMATEX* pwfx);
+	HRESULT flushStaging();
+	HRESULT writeBlock(const BYTE* pBlock, UINT32 bytes);
+	HRESULT patchSizes();
+	void flushLoop();
+	void freeStaging();
+};
+
+/**
+// End of WaveFileWriter.h
+ */
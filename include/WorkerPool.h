@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PortableTypes.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class	WorkerPool
+ *
+ * @brief	A fixed set of threads that run queued tasks in the order they were submitted. Used to load sample
+ * 			data off the caller's thread:
+ *
+ * 			WorkerPool pool;
+ * 			pool.start(4); // or let the first submit() start one thread per core
+ * 			pool.submit([=]{ sound->loadAsset(); });
+ * 			pool.wait(); // every task submitted so far has finished
+ *
+ * 			parallelFor() splits a loop over the threads and the caller, for work that has to be finished
+ * 			before the caller goes on, such as the 3D update of a frame.
+ *
+ * 			Tasks must not throw. The pool has no XAudio2 dependency, so it builds headless for benchmarks.
+ *
+ * @date	10/17/2026
+ */
+class WorkerPool
+{
+public:
+	typedef function<void()> TASK;
+	typedef function<void(UINT32 begin, UINT32 end)> RANGE_TASK;
+
+	WorkerPool(void);
+	~WorkerPool(void);
+
+	HRESULT start(UINT32 threadCount);
+	void stop();
+
+	void submit(const TASK& task);
+	void wait();
+	void parallelFor(UINT32 count, UINT32 grain, const RANGE_TASK& body);
+
+	UINT32 getThreadCount(){return (UINT32)threads.size();};
+	UINT32 getPendingCount();
+
+	static UINT32 getDefaultThreadCount();
+
+protected:
+	vector<thread> threads;
+	deque<TASK> tasks;
+	mutex lock;
+	condition_variable workerWake;
+	condition_variable idleWake;
+	UINT32 busyCount;       // tasks taken off the queue and still running
+	bool quit;
+
+	void workerLoop();
+};
+
+/**
+// End of WorkerPool.h
+ */